@@ -0,0 +1,134 @@
+// Sampling of skeletal animation - of few instances with the matrices staying in the cache, and of many sampled in a range and on threads.
+// Built as described in HbBench.h:
+// cl /O2 /I.. HbAnim_Bench.c Hardbytes.lib
+// gcc -std=gnu11 -O2 -msse3 -I.. HbAnim_Bench.c libHardbytes.a -lm -lpthread
+
+#include "HbBench.h"
+#include "HbAnim.h"
+#include "HbCore.h"
+
+#define HbAnim_Bench_JointCount 64
+#define HbAnim_Bench_FrameCount 120
+#define HbAnim_Bench_InstanceCount 4096
+#define HbAnim_Bench_CachedInstanceCount 64
+
+// A generated model with a humanoid-like hierarchy (chains of 8 joints from the root) and all channels of all joints animated.
+typedef struct HbAnim_Bench_IQM {
+	HbFile_IQM_Header header;
+	HbFile_IQM_Joint joints[HbAnim_Bench_JointCount];
+	HbFile_IQM_Pose poses[HbAnim_Bench_JointCount];
+	HbFile_IQM_Animation animation;
+	HbFile_IQM_Frame frames[HbAnim_Bench_FrameCount][HbAnim_Bench_JointCount * HbAnim_Channel_Count];
+} HbAnim_Bench_IQM;
+
+static void HbAnim_Bench_IQM_Init(HbAnim_Bench_IQM * iqm) {
+	memset(iqm, 0, sizeof(*iqm));
+	memcpy(iqm->header.magic, HbFile_IQM_Magic, sizeof(iqm->header.magic));
+	iqm->header.version = HbFile_IQM_Version;
+	iqm->header.fileSize = sizeof(*iqm);
+	iqm->header.jointCount = iqm->header.poseCount = HbAnim_Bench_JointCount;
+	iqm->header.jointOffset = (uint32_t) HbOffsetOf(HbAnim_Bench_IQM, joints);
+	iqm->header.poseOffset = (uint32_t) HbOffsetOf(HbAnim_Bench_IQM, poses);
+	iqm->header.animationCount = 1;
+	iqm->header.animationOffset = (uint32_t) HbOffsetOf(HbAnim_Bench_IQM, animation);
+	iqm->header.frameCount = HbAnim_Bench_FrameCount;
+	iqm->header.frameChannelCount = HbAnim_Bench_JointCount * HbAnim_Channel_Count;
+	iqm->header.frameOffset = (uint32_t) HbOffsetOf(HbAnim_Bench_IQM, frames);
+	for (uint32_t jointIndex = 0; jointIndex < HbAnim_Bench_JointCount; ++jointIndex) {
+		HbFile_IQM_Joint * joint = &iqm->joints[jointIndex];
+		joint->parent = (jointIndex & 7) != 0 ? (int32_t) jointIndex - 1 : (jointIndex != 0 ? 0 : -1);
+		joint->translate[1] = 0.25f;
+		joint->rotate[3] = 1.0f;
+		joint->scale[0] = joint->scale[1] = joint->scale[2] = 1.0f;
+		HbFile_IQM_Pose * pose = &iqm->poses[jointIndex];
+		pose->parent = joint->parent;
+		pose->channelMask = (1u << HbAnim_Channel_Count) - 1;
+		for (uint32_t channelIndex = 0; channelIndex < HbAnim_Channel_Count; ++channelIndex) {
+			// Scale around 1, the rest around 0.
+			pose->channelOffset[channelIndex] = channelIndex >= 7 ? 0.9f : -0.5f;
+			pose->channelScale[channelIndex] = (channelIndex >= 7 ? 0.2f : 1.0f) / 65535.0f;
+		}
+	}
+	iqm->animation.frameCount = HbAnim_Bench_FrameCount;
+	iqm->animation.framerate = 30.0f;
+	iqm->animation.flags = HbFile_IQM_Animation_Flags_Loop;
+	uint32_t random = 1;
+	for (uint32_t frameIndex = 0; frameIndex < HbAnim_Bench_FrameCount; ++frameIndex) {
+		for (uint32_t channelIndex = 0; channelIndex < HbAnim_Bench_JointCount * HbAnim_Channel_Count; ++channelIndex) {
+			random = random * 1664525u + 1013904223u;
+			iqm->frames[frameIndex][channelIndex] = (HbFile_IQM_Frame) (random >> 16);
+		}
+	}
+}
+
+typedef struct HbAnim_Bench {
+	HbAnim_Clip clip;
+	HbAnim_Instance instances[HbAnim_Bench_InstanceCount];
+	HbBool skinning;
+	uint32_t threadCount;
+} HbAnim_Bench;
+
+static void HbAnim_Bench_SampleCached(void * data) {
+	HbAnim_Bench const * bench = (HbAnim_Bench const *) data;
+	HbAnim_SampleInstanceRange(bench->instances, 0, HbAnim_Bench_CachedInstanceCount, bench->skinning);
+}
+
+static void HbAnim_Bench_SampleRange(void * data) {
+	HbAnim_Bench const * bench = (HbAnim_Bench const *) data;
+	HbAnim_SampleInstanceRange(bench->instances, 0, HbAnim_Bench_InstanceCount, bench->skinning);
+}
+
+static void HbAnim_Bench_SampleThreads(void * data) {
+	HbAnim_Bench const * bench = (HbAnim_Bench const *) data;
+	HbAnim_SampleInstances(bench->instances, HbAnim_Bench_InstanceCount, bench->skinning, bench->threadCount);
+}
+
+int main() {
+	HbCore_InitEngine();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbAnim_Bench");
+
+	HbAnim_Bench_IQM * iqm = (HbAnim_Bench_IQM *) HbMemory_Alloc(tag, sizeof(HbAnim_Bench_IQM), HbTrue);
+	HbAnim_Bench_IQM_Init(iqm);
+	HbFile_IQM_Model model;
+	if (!HbFile_IQM_Model_Init(&model, iqm, sizeof(*iqm))) {
+		printf("The generated model is not valid.\n");
+		return EXIT_FAILURE;
+	}
+	HbAnim_Skeleton skeleton;
+	HbAnim_Skeleton_Init(&skeleton, &model, tag);
+	HbAnim_Bench * bench = (HbAnim_Bench *) HbMemory_Alloc(tag, sizeof(HbAnim_Bench), HbTrue);
+	HbAnim_Clip_Init(&bench->clip, &skeleton, &model, 0);
+	HbAnim_Matrix * matrices = (HbAnim_Matrix *) HbMemory_Alloc(tag,
+			(size_t) HbAnim_Bench_InstanceCount * HbAnim_Bench_JointCount * sizeof(HbAnim_Matrix), HbTrue);
+	for (uint32_t instanceIndex = 0; instanceIndex < HbAnim_Bench_InstanceCount; ++instanceIndex) {
+		HbAnim_Instance * instance = &bench->instances[instanceIndex];
+		instance->clip = &bench->clip;
+		instance->time = 0.0137f * (float) instanceIndex;
+		instance->matrices = matrices + (size_t) instanceIndex * HbAnim_Bench_JointCount;
+	}
+
+	printf("%u joints, %u instances.\n", HbAnim_Bench_JointCount, HbAnim_Bench_InstanceCount);
+	double const cachedJointCount = HbAnim_Bench_JointCount * HbAnim_Bench_CachedInstanceCount * 1.0e-6;
+	double const allJointCount = HbAnim_Bench_JointCount * HbAnim_Bench_InstanceCount * 1.0e-6;
+	for (uint32_t skinning = 0; skinning <= 1; ++skinning) {
+		bench->skinning = (HbBool) skinning;
+		char name[64];
+		snprintf(name, sizeof(name), "HbAnim_SampleInstanceRange, %u instances%s", HbAnim_Bench_CachedInstanceCount,
+				skinning ? ", skinning" : "");
+		HbBench_Report(name, HbBench_Measure(HbAnim_Bench_SampleCached, bench), cachedJointCount, "Mjoints");
+		snprintf(name, sizeof(name), "HbAnim_SampleInstanceRange, %u instances%s", HbAnim_Bench_InstanceCount, skinning ? ", skinning" : "");
+		HbBench_Report(name, HbBench_Measure(HbAnim_Bench_SampleRange, bench), allJointCount, "Mjoints");
+		for (bench->threadCount = 2; bench->threadCount <= 8; bench->threadCount *= 2) {
+			snprintf(name, sizeof(name), "HbAnim_SampleInstances, %u threads%s", bench->threadCount, skinning ? ", skinning" : "");
+			HbBench_Report(name, HbBench_Measure(HbAnim_Bench_SampleThreads, bench), allJointCount, "Mjoints");
+		}
+	}
+
+	HbMemory_Free(matrices);
+	HbMemory_Free(bench);
+	HbAnim_Skeleton_Destroy(&skeleton);
+	HbMemory_Free(iqm);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbCore_ShutdownEngine();
+	return EXIT_SUCCESS;
+}
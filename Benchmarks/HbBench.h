@@ -0,0 +1,42 @@
+#ifndef HbInclude_HbBench
+#define HbInclude_HbBench
+#include "HbPlatform.h"
+#include <stdio.h>
+
+/*
+ * Timing for the benchmarks - console applications, one per file, including this header and linked with the engine library.
+ * With Visual C on Windows, linked with Hardbytes.lib built from Hardbytes.vcxproj, for instance:
+ * cl /O2 /I.. HbAnim_Bench.c Hardbytes.lib
+ * With GCC on Linux, linked with libHardbytes.a - an archive of all the engine .c files, compiled with the same options,
+ * except for the GPU-dependent HbGFX, HbGPU, HbGPUi_D3D, HbGPUi_D3D_CmdList, HbLoad_GPUCopier, HbLoad_TextureStream and HbShader:
+ * gcc -std=gnu11 -O2 -msse3 -I.. HbAnim_Bench.c libHardbytes.a -lm -lpthread
+ * They call HbCore_InitEngine and print the time of one run of every case, the best of enough runs to take HbBench_MinDurationUsec,
+ * and the throughput derived from it.
+ */
+
+#define HbBench_MinDurationUsec 1000000
+#define HbBench_MinRunCount 5
+
+typedef void (* HbBench_Function)(void * data);
+
+// Returns the best time of one run in seconds.
+static double HbBench_Measure(HbBench_Function function, void * data) {
+	// The first run is not measured, so the data is in the caches as much as it would be with many runs.
+	function(data);
+	int64_t bestUsec = INT64_MAX, totalUsec = 0;
+	for (uint32_t runIndex = 0; runIndex < HbBench_MinRunCount || totalUsec < HbBench_MinDurationUsec; ++runIndex) {
+		int64_t startUsec = HbPlatform_Time_RealUsec();
+		function(data);
+		int64_t runUsec = HbPlatform_Time_RealUsec() - startUsec;
+		bestUsec = HbMinI(bestUsec, runUsec);
+		totalUsec += runUsec;
+	}
+	return (double) HbMaxI(bestUsec, 1) * 1.0e-6;
+}
+
+// Prints the time of the case and its throughput in units (like "MB" or "Mpixels") per second, with unitCount in millions.
+static void HbBench_Report(char const * name, double seconds, double unitCount, char const * unit) {
+	printf("%-56s %10.3f ms %12.1f %s/s\n", name, seconds * 1000.0, unitCount / seconds, unit);
+}
+
+#endif
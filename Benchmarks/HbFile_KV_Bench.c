@@ -0,0 +1,80 @@
+// Tokenization of a 32 MB UTF-8 key/value file similar to material definitions, with comments, quoted and unquoted strings,
+// and tokenization with every key and value copied to a UTF-8 buffer.
+// Built as described in HbBench.h:
+// cl /O2 /I.. HbFile_KV_Bench.c Hardbytes.lib
+// gcc -std=gnu11 -O2 -msse3 -I.. HbFile_KV_Bench.c libHardbytes.a -lm -lpthread
+
+#include "HbBench.h"
+#include "HbCore.h"
+#include "HbFile_KV.h"
+
+#define HbFile_KV_Bench_Size (32u << 20)
+#define HbFile_KV_Bench_MaxStringSize 256
+
+typedef struct HbFile_KV_Bench {
+	HbTextU8 const * data;
+	size_t size;
+	HbBool copyStrings;
+	HbTextU8 string[HbFile_KV_Bench_MaxStringSize];
+} HbFile_KV_Bench;
+
+static void HbFile_KV_Bench_Parse(void * data) {
+	HbFile_KV_Bench * bench = (HbFile_KV_Bench *) data;
+	HbFile_KV_Read_Context context;
+	HbFile_KV_Read_Init(&context, bench->data, bench->size, HbTrue);
+	HbFile_KV_Read_TokenType tokenType;
+	while ((tokenType = HbFile_KV_Read_Parse(&context)) != HbFile_KV_Read_TokenType_End) {
+		if (bench->copyStrings) {
+			HbFile_KV_Read_CopyKeyU8(&context, bench->string, HbArrayLength(bench->string));
+			if (tokenType == HbFile_KV_Read_TokenType_KeyValue) {
+				HbFile_KV_Read_CopyValueU8(&context, bench->string, HbArrayLength(bench->string));
+			}
+		}
+	}
+	if (context.syntaxError) {
+		printf("Syntax error in the generated file.\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+int main() {
+	HbCore_InitEngine();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbFile_KV_Bench");
+
+	HbTextU8 * text = (HbTextU8 *) HbMemory_Alloc(tag, HbFile_KV_Bench_Size, HbFalse);
+	size_t size = 0;
+	for (uint32_t materialIndex = 0; ; ++materialIndex) {
+		char material[512];
+		int materialSize = snprintf(material, sizeof(material),
+				"\"materials/world/concrete/wall_%u\"\r\n"
+				"{\r\n"
+				"\t// Base layer of the wall, tiled twice.\r\n"
+				"\t\"$basetexture\" \"textures/world/concrete/wall_%u\"\r\n"
+				"\t\"$bumpmap\" \"textures/world/concrete/wall_%u_normal\"\r\n"
+				"\t$surfaceprop concrete\r\n"
+				"\t\"$basetexturetransform\" \"center .5 .5 scale 2 2 rotate 0 translate 0 0\"\r\n"
+				"\t\"$envmaptint\" \"[ .25 .25 .25 ]\"\r\n"
+				"}\r\n",
+				materialIndex, materialIndex, materialIndex);
+		if (size + (size_t) materialSize > HbFile_KV_Bench_Size) {
+			break;
+		}
+		memcpy(text + size, material, (size_t) materialSize);
+		size += (size_t) materialSize;
+	}
+
+	HbFile_KV_Bench * bench = (HbFile_KV_Bench *) HbMemory_Alloc(tag, sizeof(HbFile_KV_Bench), HbFalse);
+	bench->data = text;
+	bench->size = size;
+	double const sizeMB = (double) size * 1.0e-6;
+	bench->copyStrings = HbFalse;
+	HbBench_Report("HbFile_KV_Read_Parse", HbBench_Measure(HbFile_KV_Bench_Parse, bench), sizeMB, "MB");
+	bench->copyStrings = HbTrue;
+	HbBench_Report("HbFile_KV_Read_Parse, copying the strings", HbBench_Measure(HbFile_KV_Bench_Parse, bench), sizeMB, "MB");
+
+	HbMemory_Free(bench);
+	HbMemory_Free(text);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbCore_ShutdownEngine();
+	return EXIT_SUCCESS;
+}
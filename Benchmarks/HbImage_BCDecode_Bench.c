@@ -0,0 +1,103 @@
+// Decoding of 4x4-compressed mips on the calling thread - of every format with random blocks (in BPTC, with random modes),
+// and of BPTC with all blocks in each mode, as the cost of parsing and decoding differs between them.
+// Built as described in HbBench.h:
+// cl /O2 /I.. HbImage_BCDecode_Bench.c Hardbytes.lib
+// gcc -std=gnu11 -O2 -msse3 -I.. HbImage_BCDecode_Bench.c libHardbytes.a -lm -lpthread
+
+#include "HbBench.h"
+#include "HbCore.h"
+#include "HbImage.h"
+
+#define HbImage_BCDecode_Bench_Size 1024
+#define HbImage_BCDecode_Bench_BlockCount ((HbImage_BCDecode_Bench_Size / 4) * (HbImage_BCDecode_Bench_Size / 4))
+
+// The lowest 2 or 5 bits of BPTC float blocks in modes 1 to 14.
+static uint8_t const HbImage_BCDecode_Bench_BPTCFloatModes[14] = {
+	0x00, 0x01, 0x02, 0x06, 0x0A, 0x0E, 0x12, 0x16, 0x1A, 0x1E, 0x03, 0x07, 0x0B, 0x0F,
+};
+
+typedef struct HbImage_BCDecode_Bench {
+	HbGPU_Image_Format format;
+	uint8_t * blocks;
+	void * target;
+} HbImage_BCDecode_Bench;
+
+static void HbImage_BCDecode_Bench_DecodeMip(void * data) {
+	HbImage_BCDecode_Bench const * bench = (HbImage_BCDecode_Bench const *) data;
+	size_t targetRowPitch = (size_t) HbImage_BCDecode_Bench_Size * HbGPU_Image_Copy_ElementSize(HbImage_BC_GetDecodedFormat(bench->format), HbFalse);
+	HbImage_BC_DecodeMip(bench->format, bench->blocks, HbImage_BCDecode_Bench_Size, HbImage_BCDecode_Bench_Size, 1,
+			bench->target, targetRowPitch, targetRowPitch * HbImage_BCDecode_Bench_Size, 1);
+}
+
+// mode is the BPTC mode of all blocks, or -1 for a random mode in every block.
+static void HbImage_BCDecode_Bench_InitBlocks(HbImage_BCDecode_Bench * bench, int32_t mode) {
+	uint32_t random = 1;
+	size_t blockSize = HbGPU_Image_Copy_ElementSize(bench->format, HbFalse);
+	for (uint32_t blockIndex = 0; blockIndex < HbImage_BCDecode_Bench_BlockCount; ++blockIndex) {
+		uint8_t * block = bench->blocks + blockIndex * blockSize;
+		for (size_t byteIndex = 0; byteIndex < blockSize; ++byteIndex) {
+			random = random * 1664525u + 1013904223u;
+			block[byteIndex] = (uint8_t) (random >> 24);
+		}
+		if (bench->format == HbGPU_Image_Format_BPTC_UNorm || bench->format == HbGPU_Image_Format_BPTC_sRGB) {
+			uint32_t blockMode = mode >= 0 ? (uint32_t) mode : (random >> 8) & 7;
+			block[0] = (uint8_t) ((block[0] & ~((2u << blockMode) - 1)) | (1u << blockMode));
+		} else if (bench->format == HbGPU_Image_Format_BPTC_UFloat || bench->format == HbGPU_Image_Format_BPTC_SFloat) {
+			uint32_t blockMode = mode >= 0 ? (uint32_t) mode : (random >> 8) % HbArrayLength(HbImage_BCDecode_Bench_BPTCFloatModes);
+			uint32_t modeMask = blockMode >= 2 ? 0x1F : 0x3;
+			block[0] = (uint8_t) ((block[0] & ~modeMask) | HbImage_BCDecode_Bench_BPTCFloatModes[blockMode]);
+		}
+	}
+}
+
+static void HbImage_BCDecode_Bench_Run(HbImage_BCDecode_Bench * bench, char const * formatName, int32_t mode) {
+	HbImage_BCDecode_Bench_InitBlocks(bench, mode);
+	char name[64];
+	if (mode >= 0) {
+		snprintf(name, sizeof(name), "%s, mode %d", formatName, (int) mode + (bench->format == HbGPU_Image_Format_BPTC_UNorm ? 0 : 1));
+	} else {
+		snprintf(name, sizeof(name), "%s", formatName);
+	}
+	HbBench_Report(name, HbBench_Measure(HbImage_BCDecode_Bench_DecodeMip, bench),
+			(double) HbImage_BCDecode_Bench_Size * HbImage_BCDecode_Bench_Size * 1.0e-6, "Mtexels");
+}
+
+int main() {
+	HbCore_InitEngine();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbImage_BCDecode_Bench");
+
+	HbImage_BCDecode_Bench bench;
+	// Up to 16 bytes per block and 8 bytes per decoded texel.
+	bench.blocks = (uint8_t *) HbMemory_Alloc(tag, (size_t) HbImage_BCDecode_Bench_BlockCount * 16, HbTrue);
+	bench.target = HbMemory_Alloc(tag, (size_t) HbImage_BCDecode_Bench_Size * HbImage_BCDecode_Bench_Size * 8, HbTrue);
+
+	static struct { HbGPU_Image_Format format; char const * name; } const formats[] = {
+		{ HbGPU_Image_Format_S3TC_A1_UNorm, "S3TC_A1 (BC1)" },
+		{ HbGPU_Image_Format_S3TC_A4_UNorm, "S3TC_A4 (BC2)" },
+		{ HbGPU_Image_Format_S3TC_A8_UNorm, "S3TC_A8 (BC3)" },
+		{ HbGPU_Image_Format_3Dc_R_UNorm, "3Dc_R_UNorm (BC4)" },
+		{ HbGPU_Image_Format_3Dc_RG_SNorm, "3Dc_RG_SNorm (BC5)" },
+		{ HbGPU_Image_Format_BPTC_UFloat, "BPTC_UFloat (BC6H)" },
+		{ HbGPU_Image_Format_BPTC_SFloat, "BPTC_SFloat (BC6H)" },
+		{ HbGPU_Image_Format_BPTC_UNorm, "BPTC_UNorm (BC7)" },
+	};
+	printf("%ux%u texels, 1 thread.\n", HbImage_BCDecode_Bench_Size, HbImage_BCDecode_Bench_Size);
+	for (uint32_t formatIndex = 0; formatIndex < HbArrayLength(formats); ++formatIndex) {
+		bench.format = formats[formatIndex].format;
+		HbImage_BCDecode_Bench_Run(&bench, formats[formatIndex].name, -1);
+	}
+	bench.format = HbGPU_Image_Format_BPTC_UFloat;
+	for (int32_t mode = 0; mode < (int32_t) HbArrayLength(HbImage_BCDecode_Bench_BPTCFloatModes); ++mode) {
+		HbImage_BCDecode_Bench_Run(&bench, "BPTC_UFloat", mode);
+	}
+	bench.format = HbGPU_Image_Format_BPTC_UNorm;
+	for (int32_t mode = 0; mode < 8; ++mode) {
+		HbImage_BCDecode_Bench_Run(&bench, "BPTC_UNorm", mode);
+	}
+
+	HbMemory_Free(bench.target);
+	HbMemory_Free(bench.blocks);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbCore_ShutdownEngine();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,156 @@
+// Decoding of the vertexes and the indexes of a UV sphere with 0x10000 vertexes in the format of HbMesh_Codec_IQM_EncodeMesh,
+// optimized with HbMesh_Geometry.h, and of the indexes with the triangles shuffled, so most differences take multiple bytes.
+// Built as described in HbBench.h:
+// cl /O2 /I.. HbMesh_Codec_Bench.c Hardbytes.lib
+// gcc -std=gnu11 -O2 -msse3 -I.. HbMesh_Codec_Bench.c libHardbytes.a -lm -lpthread
+
+#include "HbBench.h"
+#include "HbCore.h"
+#include "HbMesh.h"
+#include "HbMesh_Geometry.h"
+#include <math.h>
+
+#define HbMesh_Codec_Bench_Segments 255
+#define HbMesh_Codec_Bench_Rings 255
+#define HbMesh_Codec_Bench_VertexCount ((HbMesh_Codec_Bench_Segments + 1) * (HbMesh_Codec_Bench_Rings + 1))
+// Without the degenerate triangles at the poles.
+#define HbMesh_Codec_Bench_TriangleCount (2 * HbMesh_Codec_Bench_Segments * (HbMesh_Codec_Bench_Rings - 1))
+
+typedef struct HbMesh_Codec_Bench {
+	void const * data;
+	size_t dataSize;
+	uint32_t vertexCount;
+	uint32_t triangleCount;
+	void * target;
+} HbMesh_Codec_Bench;
+
+static void HbMesh_Codec_Bench_DecodeVertexes(void * data) {
+	HbMesh_Codec_Bench const * bench = (HbMesh_Codec_Bench const *) data;
+	if (!HbMesh_Codec_DecodeVertexes(bench->data, bench->dataSize, bench->vertexCount, HbMesh_Codec_Vertex_SizeInDwords, bench->target)) {
+		printf("Failed to decode the vertexes.\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void HbMesh_Codec_Bench_DecodeIndexes(void * data) {
+	HbMesh_Codec_Bench const * bench = (HbMesh_Codec_Bench const *) data;
+	if (!HbMesh_Codec_DecodeIndexes(bench->data, bench->dataSize, bench->triangleCount, bench->vertexCount,
+			(HbGPU_Vertex_Index *) bench->target)) {
+		printf("Failed to decode the indexes.\n");
+		exit(EXIT_FAILURE);
+	}
+}
+
+// The values are within the range.
+static uint16_t HbMesh_Codec_Bench_ToUNorm16(float value) {
+	return (uint16_t) (value * 65535.0f + 0.5f);
+}
+
+static int16_t HbMesh_Codec_Bench_ToSNorm16(float value) {
+	return (int16_t) (value * 32767.0f + (value >= 0.0f ? 0.5f : -0.5f));
+}
+
+int main() {
+	HbCore_InitEngine();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbMesh_Codec_Bench");
+
+	// Generating the sphere, with octahedral normals.
+	HbMesh_Codec_Vertex * vertexes = (HbMesh_Codec_Vertex *) HbMemory_Alloc(tag,
+			HbMesh_Codec_Bench_VertexCount * sizeof(HbMesh_Codec_Vertex), HbTrue);
+	for (uint32_t ring = 0; ring <= HbMesh_Codec_Bench_Rings; ++ring) {
+		float theta = 3.14159265f * (float) ring / (float) HbMesh_Codec_Bench_Rings;
+		for (uint32_t segment = 0; segment <= HbMesh_Codec_Bench_Segments; ++segment) {
+			float phi = 2.0f * 3.14159265f * (float) segment / (float) HbMesh_Codec_Bench_Segments;
+			float normal[3] = { sinf(theta) * cosf(phi), cosf(theta), sinf(theta) * sinf(phi) };
+			HbMesh_Codec_Vertex * vertex = &vertexes[ring * (HbMesh_Codec_Bench_Segments + 1) + segment];
+			for (uint32_t componentIndex = 0; componentIndex < 3; ++componentIndex) {
+				vertex->position[componentIndex] = HbMesh_Codec_Bench_ToUNorm16(0.5f + 0.5f * normal[componentIndex]);
+			}
+			vertex->position[3] = 0;
+			float normalL1 = fabsf(normal[0]) + fabsf(normal[1]) + fabsf(normal[2]);
+			float octahedral[2] = { normal[0] / normalL1, normal[1] / normalL1 };
+			if (normal[2] < 0.0f) {
+				float octahedralX = octahedral[0];
+				octahedral[0] = (1.0f - fabsf(octahedral[1])) * (octahedralX >= 0.0f ? 1.0f : -1.0f);
+				octahedral[1] = (1.0f - fabsf(octahedralX)) * (octahedral[1] >= 0.0f ? 1.0f : -1.0f);
+			}
+			vertex->normal[0] = HbMesh_Codec_Bench_ToSNorm16(octahedral[0]);
+			vertex->normal[1] = HbMesh_Codec_Bench_ToSNorm16(octahedral[1]);
+			vertex->texCoord[0] = HbMesh_Codec_Bench_ToUNorm16((float) segment / (float) HbMesh_Codec_Bench_Segments);
+			vertex->texCoord[1] = HbMesh_Codec_Bench_ToUNorm16((float) ring / (float) HbMesh_Codec_Bench_Rings);
+		}
+	}
+	uint32_t * indexes = (uint32_t *) HbMemory_Alloc(tag, (size_t) 3 * HbMesh_Codec_Bench_TriangleCount * sizeof(uint32_t), HbFalse);
+	uint32_t * index = indexes;
+	for (uint32_t ring = 0; ring < HbMesh_Codec_Bench_Rings; ++ring) {
+		for (uint32_t segment = 0; segment < HbMesh_Codec_Bench_Segments; ++segment) {
+			uint32_t v00 = ring * (HbMesh_Codec_Bench_Segments + 1) + segment, v01 = v00 + 1;
+			uint32_t v10 = v00 + HbMesh_Codec_Bench_Segments + 1, v11 = v10 + 1;
+			if (ring != 0) {
+				*(index++) = v00; *(index++) = v01; *(index++) = v10;
+			}
+			if (ring != HbMesh_Codec_Bench_Rings - 1) {
+				*(index++) = v01; *(index++) = v11; *(index++) = v10;
+			}
+		}
+	}
+
+	// Optimizing like for an asset.
+	void * scratch = HbMemory_Alloc(tag,
+			HbMesh_OptimizeVertexCache_GetScratchSize(HbMesh_Codec_Bench_TriangleCount, HbMesh_Codec_Bench_VertexCount), HbFalse);
+	HbMesh_OptimizeVertexCache(indexes, HbMesh_Codec_Bench_TriangleCount, HbMesh_Codec_Bench_VertexCount, indexes, scratch);
+	HbMemory_Free(scratch);
+	uint32_t * remap = (uint32_t *) HbMemory_Alloc(tag, HbMesh_Codec_Bench_VertexCount * sizeof(uint32_t), HbFalse);
+	uint32_t vertexCount = HbMesh_OptimizeVertexFetch(indexes, HbMesh_Codec_Bench_TriangleCount, HbMesh_Codec_Bench_VertexCount, remap);
+	HbMesh_Codec_Vertex * optimizedVertexes = (HbMesh_Codec_Vertex *) HbMemory_Alloc(tag,
+			HbMesh_Codec_Bench_VertexCount * sizeof(HbMesh_Codec_Vertex), HbTrue);
+	HbMesh_RemapVertexes(vertexes, HbMesh_Codec_Bench_VertexCount, sizeof(HbMesh_Codec_Vertex), remap, optimizedVertexes);
+	HbMemory_Free(remap);
+	HbMemory_Free(vertexes);
+
+	// The target is 16-aligned for non-temporal stores, with space for decoding at an unaligned address.
+	HbMesh_Codec_Bench bench = { .vertexCount = vertexCount, .triangleCount = HbMesh_Codec_Bench_TriangleCount };
+	bench.target = HbMemory_Alloc(tag, vertexCount * sizeof(HbMesh_Codec_Vertex) + 16, HbTrue);
+	void * encoded = HbMemory_Alloc(tag, HbMaxSize(HbMesh_Codec_GetVertexesMaxEncodedSize(vertexCount, HbMesh_Codec_Vertex_SizeInDwords),
+			HbMesh_Codec_GetIndexesMaxEncodedSize(HbMesh_Codec_Bench_TriangleCount)), HbFalse);
+	bench.data = encoded;
+	double const vertexMB = (double) (vertexCount * sizeof(HbMesh_Codec_Vertex)) * 1.0e-6;
+	double const indexMCount = 3.0 * HbMesh_Codec_Bench_TriangleCount * 1.0e-6;
+
+	bench.dataSize = HbMesh_Codec_EncodeVertexes(optimizedVertexes, vertexCount, HbMesh_Codec_Vertex_SizeInDwords, encoded);
+	printf("%u vertexes, %.2f bytes per vertex encoded.\n", vertexCount, (double) bench.dataSize / (double) vertexCount);
+	HbBench_Report("HbMesh_Codec_DecodeVertexes, 16-aligned target", HbBench_Measure(HbMesh_Codec_Bench_DecodeVertexes, &bench),
+			vertexMB, "MB");
+	void * alignedTarget = bench.target;
+	bench.target = (uint8_t *) alignedTarget + 4;
+	HbBench_Report("HbMesh_Codec_DecodeVertexes, unaligned target", HbBench_Measure(HbMesh_Codec_Bench_DecodeVertexes, &bench),
+			vertexMB, "MB");
+	bench.target = alignedTarget;
+
+	bench.dataSize = HbMesh_Codec_EncodeIndexes(indexes, HbMesh_Codec_Bench_TriangleCount, vertexCount, encoded);
+	printf("%u indexes, %.2f bytes per index encoded.\n", 3 * HbMesh_Codec_Bench_TriangleCount,
+			(double) bench.dataSize / (3.0 * HbMesh_Codec_Bench_TriangleCount));
+	HbBench_Report("HbMesh_Codec_DecodeIndexes, optimized", HbBench_Measure(HbMesh_Codec_Bench_DecodeIndexes, &bench), indexMCount, "Mindexes");
+
+	uint32_t random = 1;
+	for (uint32_t triangleIndex = HbMesh_Codec_Bench_TriangleCount - 1; triangleIndex > 0; --triangleIndex) {
+		random = random * 1664525u + 1013904223u;
+		uint32_t otherIndex = (uint32_t) (((uint64_t) (random >> 8) * (triangleIndex + 1)) >> 24);
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			uint32_t corner = indexes[3 * triangleIndex + cornerIndex];
+			indexes[3 * triangleIndex + cornerIndex] = indexes[3 * otherIndex + cornerIndex];
+			indexes[3 * otherIndex + cornerIndex] = corner;
+		}
+	}
+	bench.dataSize = HbMesh_Codec_EncodeIndexes(indexes, HbMesh_Codec_Bench_TriangleCount, vertexCount, encoded);
+	printf("Shuffled, %.2f bytes per index encoded.\n", (double) bench.dataSize / (3.0 * HbMesh_Codec_Bench_TriangleCount));
+	HbBench_Report("HbMesh_Codec_DecodeIndexes, shuffled", HbBench_Measure(HbMesh_Codec_Bench_DecodeIndexes, &bench), indexMCount, "Mindexes");
+
+	HbMemory_Free(encoded);
+	HbMemory_Free(bench.target);
+	HbMemory_Free(optimizedVertexes);
+	HbMemory_Free(indexes);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbCore_ShutdownEngine();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,158 @@
+// Building of LOD chains of a UV sphere with about a million triangles, with and without the normals and the texture coordinates,
+// and the errors of the levels reported by HbMesh_LOD_BuildChain compared to their actual deviation from the sphere.
+// Built as described in HbBench.h:
+// cl /O2 /I.. HbMesh_LOD_Bench.c Hardbytes.lib
+// gcc -std=gnu11 -O2 -msse3 -I.. HbMesh_LOD_Bench.c libHardbytes.a -lm -lpthread
+
+#include "HbBench.h"
+#include "HbCore.h"
+#include "HbMesh.h"
+#include <float.h>
+#include <math.h>
+
+#define HbMesh_LOD_Bench_Segments 1024
+#define HbMesh_LOD_Bench_Rings 512
+#define HbMesh_LOD_Bench_Radius 1.0f
+#define HbMesh_LOD_Bench_MaxLevelCount 8
+#define HbMesh_LOD_Bench_LevelTriangleRatio 0.5f
+#define HbMesh_LOD_Bench_MaxError 0.1f
+
+// Position, normal and texture coordinates, like in HbMesh_LOD_IQM_Write.
+#define HbMesh_LOD_Bench_VertexStride 8
+#define HbMesh_LOD_Bench_VertexCount ((HbMesh_LOD_Bench_Segments + 1) * (HbMesh_LOD_Bench_Rings + 1))
+// Without the degenerate triangles at the poles.
+#define HbMesh_LOD_Bench_TriangleCount (2 * HbMesh_LOD_Bench_Segments * (HbMesh_LOD_Bench_Rings - 1))
+
+typedef struct HbMesh_LOD_Bench {
+	float * vertexes;
+	uint32_t * indexes;
+	HbMesh_Simplify_Vertexes simplifyVertexes;
+	HbMesh_LOD_Level levels[HbMesh_LOD_Bench_MaxLevelCount];
+	uint32_t * levelIndexes;
+	uint32_t levelCount;
+	HbMemory_Tag * tag;
+} HbMesh_LOD_Bench;
+
+// Counterclockwise when viewed from the outside, with the vertexes of the texture coordinate seam and of the poles duplicated.
+static void HbMesh_LOD_Bench_InitSphere(HbMesh_LOD_Bench * bench) {
+	for (uint32_t ring = 0; ring <= HbMesh_LOD_Bench_Rings; ++ring) {
+		float theta = 3.14159265f * (float) ring / (float) HbMesh_LOD_Bench_Rings;
+		for (uint32_t segment = 0; segment <= HbMesh_LOD_Bench_Segments; ++segment) {
+			float phi = 2.0f * 3.14159265f * (float) segment / (float) HbMesh_LOD_Bench_Segments;
+			float * vertex = bench->vertexes + HbMesh_LOD_Bench_VertexStride * (ring * (HbMesh_LOD_Bench_Segments + 1) + segment);
+			vertex[3] = sinf(theta) * cosf(phi);
+			vertex[4] = cosf(theta);
+			vertex[5] = sinf(theta) * sinf(phi);
+			vertex[0] = HbMesh_LOD_Bench_Radius * vertex[3];
+			vertex[1] = HbMesh_LOD_Bench_Radius * vertex[4];
+			vertex[2] = HbMesh_LOD_Bench_Radius * vertex[5];
+			vertex[6] = (float) segment / (float) HbMesh_LOD_Bench_Segments;
+			vertex[7] = (float) ring / (float) HbMesh_LOD_Bench_Rings;
+		}
+	}
+	uint32_t * index = bench->indexes;
+	for (uint32_t ring = 0; ring < HbMesh_LOD_Bench_Rings; ++ring) {
+		for (uint32_t segment = 0; segment < HbMesh_LOD_Bench_Segments; ++segment) {
+			uint32_t v00 = ring * (HbMesh_LOD_Bench_Segments + 1) + segment, v01 = v00 + 1;
+			uint32_t v10 = v00 + HbMesh_LOD_Bench_Segments + 1, v11 = v10 + 1;
+			if (ring != 0) {
+				*(index++) = v00; *(index++) = v01; *(index++) = v10;
+			}
+			if (ring != HbMesh_LOD_Bench_Rings - 1) {
+				*(index++) = v01; *(index++) = v11; *(index++) = v10;
+			}
+		}
+	}
+}
+
+// The largest distance from the sphere to the triangles, with all their vertexes on it, so the nearest point to the center is either
+// its projection to the plane of the triangle if it's inside, or the middle of an edge.
+static float HbMesh_LOD_Bench_GetDeviation(float const * vertexes, uint32_t const * indexes, uint32_t triangleCount) {
+	float maxDeviation = 0.0f;
+	for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		float const * p[3];
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			p[cornerIndex] = vertexes + HbMesh_LOD_Bench_VertexStride * indexes[3 * triangleIndex + cornerIndex];
+		}
+		float e01[3] = { p[1][0] - p[0][0], p[1][1] - p[0][1], p[1][2] - p[0][2] };
+		float e02[3] = { p[2][0] - p[0][0], p[2][1] - p[0][1], p[2][2] - p[0][2] };
+		float n[3] = { e01[1] * e02[2] - e01[2] * e02[1], e01[2] * e02[0] - e01[0] * e02[2], e01[0] * e02[1] - e01[1] * e02[0] };
+		float nLengthSquared = n[0] * n[0] + n[1] * n[1] + n[2] * n[2];
+		if (nLengthSquared <= 0.0f) {
+			continue;
+		}
+		// The center is the origin - checking on which side of each edge its projection is.
+		HbBool inside = HbTrue;
+		for (uint32_t edgeIndex = 0; edgeIndex < 3; ++edgeIndex) {
+			float const * a = p[edgeIndex], * b = p[(edgeIndex + 1) % 3];
+			float edgeCross[3] = { a[1] * b[2] - a[2] * b[1], a[2] * b[0] - a[0] * b[2], a[0] * b[1] - a[1] * b[0] };
+			inside &= (edgeCross[0] * n[0] + edgeCross[1] * n[1] + edgeCross[2] * n[2] >= 0.0f);
+		}
+		float nearestDistance;
+		if (inside) {
+			nearestDistance = fabsf(n[0] * p[0][0] + n[1] * p[0][1] + n[2] * p[0][2]) / sqrtf(nLengthSquared);
+		} else {
+			nearestDistance = FLT_MAX;
+			for (uint32_t edgeIndex = 0; edgeIndex < 3; ++edgeIndex) {
+				float const * a = p[edgeIndex], * b = p[(edgeIndex + 1) % 3];
+				float middle[3] = { 0.5f * (a[0] + b[0]), 0.5f * (a[1] + b[1]), 0.5f * (a[2] + b[2]) };
+				nearestDistance = fminf(nearestDistance, sqrtf(middle[0] * middle[0] + middle[1] * middle[1] + middle[2] * middle[2]));
+			}
+		}
+		maxDeviation = fmaxf(maxDeviation, HbMesh_LOD_Bench_Radius - nearestDistance);
+	}
+	return maxDeviation;
+}
+
+static void HbMesh_LOD_Bench_BuildChain(void * data) {
+	HbMesh_LOD_Bench * bench = (HbMesh_LOD_Bench *) data;
+	bench->levelCount = HbMesh_LOD_BuildChain(bench->indexes, HbMesh_LOD_Bench_TriangleCount, &bench->simplifyVertexes,
+			HbMesh_LOD_Bench_MaxLevelCount, HbMesh_LOD_Bench_LevelTriangleRatio, HbMesh_LOD_Bench_MaxError,
+			bench->levels, bench->levelIndexes, bench->tag);
+}
+
+int main() {
+	HbCore_InitEngine();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbMesh_LOD_Bench");
+
+	HbMesh_LOD_Bench bench = { .tag = tag };
+	bench.vertexes = (float *) HbMemory_Alloc(tag,
+			(size_t) HbMesh_LOD_Bench_VertexCount * HbMesh_LOD_Bench_VertexStride * sizeof(float), HbFalse);
+	bench.indexes = (uint32_t *) HbMemory_Alloc(tag, (size_t) 3 * HbMesh_LOD_Bench_TriangleCount * sizeof(uint32_t), HbFalse);
+	bench.levelIndexes = (uint32_t *) HbMemory_Alloc(tag,
+			(size_t) 3 * HbMesh_LOD_Bench_TriangleCount * HbMesh_LOD_Bench_MaxLevelCount * sizeof(uint32_t), HbFalse);
+	HbMesh_LOD_Bench_InitSphere(&bench);
+	float const attributeWeights[] = { 1.0f, 1.0f, 1.0f, 1.0f, 1.0f };
+
+	printf("%u vertexes, %u triangles, deviation from the sphere %g.\n", HbMesh_LOD_Bench_VertexCount, HbMesh_LOD_Bench_TriangleCount,
+			HbMesh_LOD_Bench_GetDeviation(bench.vertexes, bench.indexes, HbMesh_LOD_Bench_TriangleCount));
+	for (uint32_t attributes = 0; attributes <= 1; ++attributes) {
+		bench.simplifyVertexes = (HbMesh_Simplify_Vertexes) {
+			.positions = bench.vertexes,
+			.positionStride = HbMesh_LOD_Bench_VertexStride * sizeof(float),
+			.vertexCount = HbMesh_LOD_Bench_VertexCount,
+		};
+		if (attributes) {
+			bench.simplifyVertexes.attributes = bench.vertexes + 3;
+			bench.simplifyVertexes.attributeStride = HbMesh_LOD_Bench_VertexStride * sizeof(float);
+			bench.simplifyVertexes.attributeWeights = attributeWeights;
+			bench.simplifyVertexes.attributeCount = HbArrayLength(attributeWeights);
+		}
+		HbBench_Report(attributes ? "HbMesh_LOD_BuildChain, normals and texture coordinates" : "HbMesh_LOD_BuildChain, positions",
+				HbBench_Measure(HbMesh_LOD_Bench_BuildChain, &bench), HbMesh_LOD_Bench_TriangleCount * 1.0e-6, "Mtriangles");
+		printf("%8s %10s %16s %16s %16s\n", "Level", "Triangles", "Geometric error", "Deviation", "Attribute error");
+		for (uint32_t levelIndex = 0; levelIndex < bench.levelCount; ++levelIndex) {
+			HbMesh_LOD_Level const * level = &bench.levels[levelIndex];
+			printf("%8u %10u %16g %16g %16g\n", levelIndex, level->triangleCount, level->geometricError,
+					HbMesh_LOD_Bench_GetDeviation(bench.vertexes, bench.levelIndexes + (size_t) 3 * level->triangleFirst, level->triangleCount),
+					level->attributeError);
+		}
+	}
+
+	HbMemory_Free(bench.levelIndexes);
+	HbMemory_Free(bench.indexes);
+	HbMemory_Free(bench.vertexes);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbCore_ShutdownEngine();
+	return EXIT_SUCCESS;
+}
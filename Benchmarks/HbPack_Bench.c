@@ -0,0 +1,97 @@
+// Validation of pack directories with a million items, like when mounting user-generated packs - of version 1 without a hash map,
+// and of version 2 written by HbPack_Write with a hash map, on different numbers of threads.
+// Built as described in HbBench.h:
+// cl /O2 /I.. HbPack_Bench.c Hardbytes.lib
+// gcc -std=gnu11 -O2 -msse3 -I.. HbPack_Bench.c libHardbytes.a -lm -lpthread
+
+#include "HbBench.h"
+#include "HbCore.h"
+#include "HbPack.h"
+
+#define HbPack_Bench_FolderCount 1024
+#define HbPack_Bench_ItemsPerFolder 1024
+#define HbPack_Bench_ItemCount (HbPack_Bench_FolderCount * HbPack_Bench_ItemsPerFolder)
+#define HbPack_Bench_NameSize sizeof("Folder0000/Item0000.dat")
+
+typedef struct HbPack_Bench {
+	void const * pack;
+	uint32_t packSize;
+	uint32_t threadCount;
+} HbPack_Bench;
+
+static void HbPack_Bench_GetInfo(void * data) {
+	HbPack_Bench const * bench = (HbPack_Bench const *) data;
+	HbPack_Info info;
+	HbPack_ErrorReport errorReport;
+	if (!HbPack_GetInfo(bench->pack, bench->packSize, &info, HbTrue, bench->threadCount, &errorReport)) {
+		printf("The pack is not valid (error %u, index %u).\n", (unsigned int) errorReport.error, errorReport.index);
+		exit(EXIT_FAILURE);
+	}
+}
+
+static void HbPack_Bench_Run(HbPack_Bench * bench, char const * versionName) {
+	static uint32_t const threadCounts[] = { 1, 2, 4, 8 };
+	for (uint32_t threadCountIndex = 0; threadCountIndex < HbArrayLength(threadCounts); ++threadCountIndex) {
+		bench->threadCount = threadCounts[threadCountIndex];
+		char name[64];
+		snprintf(name, sizeof(name), "HbPack_GetInfo, %s, %u thread%s", versionName, bench->threadCount, bench->threadCount > 1 ? "s" : "");
+		HbBench_Report(name, HbBench_Measure(HbPack_Bench_GetInfo, bench), HbPack_Bench_ItemCount * 1.0e-6, "Mitems");
+	}
+}
+
+int main() {
+	HbCore_InitEngine();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbPack_Bench");
+
+	// Already in the sorted order, all items sharing the same data.
+	char * names = (char *) HbMemory_Alloc(tag, (size_t) HbPack_Bench_ItemCount * HbPack_Bench_NameSize, HbFalse);
+	for (uint32_t itemIndex = 0; itemIndex < HbPack_Bench_ItemCount; ++itemIndex) {
+		snprintf(names + (size_t) itemIndex * HbPack_Bench_NameSize, HbPack_Bench_NameSize, "Folder%04u/Item%04u.dat",
+				itemIndex / HbPack_Bench_ItemsPerFolder, itemIndex % HbPack_Bench_ItemsPerFolder);
+	}
+	static uint8_t const itemData[16] = { 0 };
+	HbPack_Bench bench;
+
+	// Version 1.
+	uint32_t dataOffset = (uint32_t) (sizeof(HbPack_Header) + HbPack_Bench_ItemCount * sizeof(HbPack_DirectoryEntry));
+	bench.packSize = dataOffset + sizeof(itemData);
+	uint8_t * packV1 = (uint8_t *) HbMemory_Alloc(tag, bench.packSize, HbTrue);
+	memset(packV1, 0, bench.packSize);
+	HbPack_Header * header = (HbPack_Header *) packV1;
+	memcpy(header->id, HbPack_HeaderID, sizeof(header->id));
+	header->itemCount = HbPack_Bench_ItemCount;
+	HbPack_DirectoryEntry * directory = (HbPack_DirectoryEntry *) (header + 1);
+	for (uint32_t itemIndex = 0; itemIndex < HbPack_Bench_ItemCount; ++itemIndex) {
+		HbPack_DirectoryEntry * directoryEntry = &directory[itemIndex];
+		memcpy(directoryEntry->name, names + (size_t) itemIndex * HbPack_Bench_NameSize, HbPack_Bench_NameSize);
+		directoryEntry->offset = dataOffset;
+		directoryEntry->size = sizeof(itemData);
+	}
+	bench.pack = packV1;
+	printf("%u items.\n", HbPack_Bench_ItemCount);
+	HbPack_Bench_Run(&bench, "version 1");
+	HbMemory_Free(packV1);
+
+	// Version 2, with the data deduplicated.
+	HbPack_Write_Item * items = (HbPack_Write_Item *) HbMemory_Alloc(tag, HbPack_Bench_ItemCount * sizeof(HbPack_Write_Item), HbFalse);
+	for (uint32_t itemIndex = 0; itemIndex < HbPack_Bench_ItemCount; ++itemIndex) {
+		HbPack_Write_Item * item = &items[itemIndex];
+		item->name = names + (size_t) itemIndex * HbPack_Bench_NameSize;
+		item->data = itemData;
+		item->size = sizeof(itemData);
+	}
+	void * packV2 = HbPack_Write(tag, items, HbPack_Bench_ItemCount, HbTrue, HbFalse, &bench.packSize);
+	HbMemory_Free(items);
+	if (packV2 == NULL) {
+		printf("Failed to write the version 2 pack.\n");
+		return EXIT_FAILURE;
+	}
+	bench.pack = packV2;
+	HbPack_Bench_Run(&bench, "version 2, hash map");
+	HbMemory_Free(packV2);
+
+	HbMemory_Free(names);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbCore_ShutdownEngine();
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,113 @@
+// Conversion between UTF-8 and UTF-16 and calculation of the converted lengths, of 1 MB of UTF-8 text - ASCII only,
+// ASCII with a few CJK characters like in localized file paths, and CJK only.
+// Built as described in HbBench.h:
+// cl /O2 /I.. HbText_Bench.c Hardbytes.lib
+// gcc -std=gnu11 -O2 -msse3 -I.. HbText_Bench.c libHardbytes.a -lm -lpthread
+
+#include "HbBench.h"
+#include "HbCore.h"
+#include "HbMemory.h"
+#include "HbText.h"
+
+#define HbText_Bench_SizeU8 (1u << 20)
+
+typedef enum HbText_Bench_Function {
+	HbText_Bench_Function_U16FromU8Sized,
+	HbText_Bench_Function_U8FromU16Sized,
+	HbText_Bench_Function_U16FromU8,
+	HbText_Bench_Function_U8FromU16,
+	HbText_Bench_Function_U8LengthU16Elems,
+	HbText_Bench_Function_U16LengthU8Elems,
+	HbText_Bench_Function_Count,
+} HbText_Bench_Function;
+
+// The null-terminated functions also find the length of the source.
+static char const * const HbText_Bench_FunctionNames[HbText_Bench_Function_Count] = {
+	"HbTextU16_FromU8Sized",
+	"HbTextU8_FromU16Sized",
+	"HbTextU16_FromU8",
+	"HbTextU8_FromU16",
+	"HbTextU8_LengthU16Elems",
+	"HbTextU16_LengthU8Elems",
+};
+
+typedef struct HbText_Bench {
+	HbText_Bench_Function function;
+	HbTextU8 * u8; // HbText_Bench_SizeU8 + 1 elements.
+	HbTextU16 * u16; // HbText_Bench_SizeU8 + 1 elements.
+	size_t u8Length;
+	size_t u16Length;
+	size_t result;
+} HbText_Bench;
+
+static void HbText_Bench_Run(void * data) {
+	HbText_Bench * bench = (HbText_Bench *) data;
+	switch (bench->function) {
+	case HbText_Bench_Function_U16FromU8Sized:
+		bench->result = HbTextU16_FromU8Sized(bench->u16, bench->u16Length, bench->u8, bench->u8Length, HbFalse);
+		break;
+	case HbText_Bench_Function_U8FromU16Sized:
+		bench->result = HbTextU8_FromU16Sized(bench->u8, bench->u8Length, bench->u16, bench->u16Length, HbFalse);
+		break;
+	case HbText_Bench_Function_U16FromU8:
+		bench->result = HbTextU16_FromU8(bench->u16, bench->u16Length + 1, bench->u8, HbFalse);
+		break;
+	case HbText_Bench_Function_U8FromU16:
+		bench->result = HbTextU8_FromU16(bench->u8, bench->u8Length + 1, bench->u16, HbFalse);
+		break;
+	case HbText_Bench_Function_U8LengthU16Elems:
+		bench->result = HbTextU8_LengthU16Elems(bench->u8);
+		break;
+	case HbText_Bench_Function_U16LengthU8Elems:
+		bench->result = HbTextU16_LengthU8Elems(bench->u16, HbFalse);
+		break;
+	default:
+		break;
+	}
+}
+
+int main() {
+	HbCore_InitEngine();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbText_Bench");
+
+	HbText_Bench bench;
+	bench.u8 = (HbTextU8 *) HbMemory_Alloc(tag, HbText_Bench_SizeU8 + 1, HbFalse);
+	bench.u16 = (HbTextU16 *) HbMemory_Alloc(tag, (HbText_Bench_SizeU8 + 1) * sizeof(HbTextU16), HbFalse);
+	static char const * const textNames[] = { "ASCII", "ASCII with CJK", "CJK" };
+	for (uint32_t textIndex = 0; textIndex < HbArrayLength(textNames); ++textIndex) {
+		// Words of 2 to 9 characters separated by spaces, of 2-character CJK words every 64 characters in the mixed text.
+		uint32_t random = 1;
+		size_t length = 0;
+		for (uint32_t charIndex = 0; ; ++charIndex) {
+			random = random * 1664525u + 1013904223u;
+			HbTextU32 character;
+			if (textIndex == 2 || (textIndex == 1 && (charIndex & 63) >= 62)) {
+				character = 0x4E00 + (random >> 16) % 0x5000;
+			} else {
+				character = ((random >> 16) & 7) != 0 ? 'a' + (random >> 19) % 26 : ' ';
+			}
+			uint32_t charLength = HbTextU8_WriteValidChar(bench.u8 + length, HbText_Bench_SizeU8 - length, character);
+			if (charLength == 0) {
+				break;
+			}
+			length += charLength;
+		}
+		bench.u8[length] = '\0';
+		bench.u8Length = length;
+		bench.u16Length = HbTextU16_FromU8(bench.u16, HbText_Bench_SizeU8 + 1, bench.u8, HbFalse);
+		printf("%s: %zu UTF-8 elements, %zu UTF-16 elements.\n", textNames[textIndex], bench.u8Length, bench.u16Length);
+		for (uint32_t functionIndex = 0; functionIndex < HbText_Bench_Function_Count; ++functionIndex) {
+			bench.function = (HbText_Bench_Function) functionIndex;
+			char name[64];
+			snprintf(name, sizeof(name), "%s, %s", HbText_Bench_FunctionNames[functionIndex], textNames[textIndex]);
+			// Throughput in the UTF-8 size for all functions.
+			HbBench_Report(name, HbBench_Measure(HbText_Bench_Run, &bench), (double) bench.u8Length * 1.0e-6, "MB");
+		}
+	}
+
+	HbMemory_Free(bench.u16);
+	HbMemory_Free(bench.u8);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbCore_ShutdownEngine();
+	return EXIT_SUCCESS;
+}
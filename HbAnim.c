@@ -0,0 +1,308 @@
+#include "HbAnim.h"
+#include "HbFeedback.h"
+#include "HbParallel.h"
+
+/***********
+ * Skeleton
+ ***********/
+
+// Translation, rotation quaternion XYZW (normalized here) and scale, applied in reverse order.
+static void HbAnimi_Matrix_Compose(float const * translation, float const * rotation, float const * scale, HbAnim_Matrix * matrix) {
+	float x = rotation[0], y = rotation[1], z = rotation[2], w = rotation[3];
+	float lengthSquared = x * x + y * y + z * z + w * w;
+	float normalization = lengthSquared > 0.0f ? 2.0f / lengthSquared : 0.0f;
+	float xx = x * x * normalization, yy = y * y * normalization, zz = z * z * normalization;
+	float xy = x * y * normalization, xz = x * z * normalization, yz = y * z * normalization;
+	float wx = w * x * normalization, wy = w * y * normalization, wz = w * z * normalization;
+	matrix->rows[0] = HbMath_F32x4_LoadXYZW((1.0f - yy - zz) * scale[0], (xy - wz) * scale[1], (xz + wy) * scale[2], translation[0]);
+	matrix->rows[1] = HbMath_F32x4_LoadXYZW((xy + wz) * scale[0], (1.0f - xx - zz) * scale[1], (yz - wx) * scale[2], translation[1]);
+	matrix->rows[2] = HbMath_F32x4_LoadXYZW((xz - wy) * scale[0], (yz + wx) * scale[1], (1.0f - xx - yy) * scale[2], translation[2]);
+}
+
+// Zero if the matrix is singular (such as for joints with zero scale).
+static void HbAnimi_Matrix_Invert(HbAnim_Matrix const * matrix, HbAnim_Matrix * inverse) {
+	HbMath_VecAligned float m[3][4];
+	for (uint32_t rowIndex = 0; rowIndex < 3; ++rowIndex) {
+		HbMath_F32x4_StoreAligned(m[rowIndex], matrix->rows[rowIndex]);
+	}
+	// Adjugate of the 3x3 part divided by the determinant, and the translation transformed by it and negated.
+	float c00 = m[1][1] * m[2][2] - m[1][2] * m[2][1], c01 = m[0][2] * m[2][1] - m[0][1] * m[2][2], c02 = m[0][1] * m[1][2] - m[0][2] * m[1][1];
+	float c10 = m[1][2] * m[2][0] - m[1][0] * m[2][2], c11 = m[0][0] * m[2][2] - m[0][2] * m[2][0], c12 = m[0][2] * m[1][0] - m[0][0] * m[1][2];
+	float c20 = m[1][0] * m[2][1] - m[1][1] * m[2][0], c21 = m[0][1] * m[2][0] - m[0][0] * m[2][1], c22 = m[0][0] * m[1][1] - m[0][1] * m[1][0];
+	float determinant = m[0][0] * c00 + m[0][1] * c10 + m[0][2] * c20;
+	float inverseDeterminant = determinant != 0.0f ? 1.0f / determinant : 0.0f;
+	c00 *= inverseDeterminant; c01 *= inverseDeterminant; c02 *= inverseDeterminant;
+	c10 *= inverseDeterminant; c11 *= inverseDeterminant; c12 *= inverseDeterminant;
+	c20 *= inverseDeterminant; c21 *= inverseDeterminant; c22 *= inverseDeterminant;
+	float tx = m[0][3], ty = m[1][3], tz = m[2][3];
+	inverse->rows[0] = HbMath_F32x4_LoadXYZW(c00, c01, c02, -(c00 * tx + c01 * ty + c02 * tz));
+	inverse->rows[1] = HbMath_F32x4_LoadXYZW(c10, c11, c12, -(c10 * tx + c11 * ty + c12 * tz));
+	inverse->rows[2] = HbMath_F32x4_LoadXYZW(c20, c21, c22, -(c20 * tx + c21 * ty + c22 * tz));
+}
+
+void HbAnim_Skeleton_Init(HbAnim_Skeleton * skeleton, HbFile_IQM_Model const * model, HbMemory_Tag * tag) {
+	HbFile_IQM_Header const * header = model->header;
+	uint32_t jointCount = header->jointCount;
+	skeleton->jointCount = jointCount;
+	skeleton->frameChannelCount = header->frameChannelCount;
+	if (header->frameChannelCount >= HbAnim_Channel_NotAnimated) {
+		HbFeedback_Crash("HbAnim_Skeleton_Init", "%u frame channels, but only up to %u are supported.",
+				header->frameChannelCount, HbAnim_Channel_NotAnimated - 1);
+	}
+	uint32_t batchCount = (jointCount + (HbAnim_JointBatchSize - 1)) / HbAnim_JointBatchSize;
+	size_t batchesSize = batchCount * sizeof(HbAnim_Skeleton_JointBatch), matricesSize = jointCount * sizeof(HbAnim_Matrix);
+	uint8_t * memory = (uint8_t *) HbMemory_Alloc(tag, batchesSize + 2 * matricesSize + jointCount * sizeof(int32_t), HbTrue);
+	skeleton->jointBatches = (HbAnim_Skeleton_JointBatch *) memory;
+	skeleton->bindMatrices = (HbAnim_Matrix *) (memory + batchesSize);
+	skeleton->inverseBindMatrices = (HbAnim_Matrix *) (memory + batchesSize + matricesSize);
+	skeleton->jointParents = (int32_t *) (memory + batchesSize + 2 * matricesSize);
+
+	// Channels of the poses, in the order of the values in the frames, or the base pose if there are no poses.
+	uint32_t frameChannelIndex = 0;
+	for (uint32_t batchIndex = 0; batchIndex < batchCount; ++batchIndex) {
+		HbAnim_Skeleton_JointBatch * batch = &skeleton->jointBatches[batchIndex];
+		HbMath_VecAligned float offsets[HbAnim_Channel_Count][HbAnim_JointBatchSize];
+		HbMath_VecAligned float scales[HbAnim_Channel_Count][HbAnim_JointBatchSize];
+		for (uint32_t lane = 0; lane < HbAnim_JointBatchSize; ++lane) {
+			uint32_t jointIndex = batchIndex * HbAnim_JointBatchSize + lane;
+			for (uint32_t channelIndex = 0; channelIndex < HbAnim_Channel_Count; ++channelIndex) {
+				float offset = 0.0f, scale = 0.0f;
+				uint16_t frameIndex = HbAnim_Channel_NotAnimated;
+				if (jointIndex >= jointCount) {
+					// Identity for the unused lanes, to avoid normalizing zero quaternions.
+					offset = channelIndex >= 6 ? 1.0f : 0.0f;
+				} else if (header->poseCount != 0) {
+					HbFile_IQM_Pose const * pose = &model->poses[jointIndex];
+					offset = pose->channelOffset[channelIndex];
+					if (pose->channelMask & (1u << channelIndex)) {
+						scale = pose->channelScale[channelIndex];
+						frameIndex = (uint16_t) frameChannelIndex++;
+					}
+				} else {
+					HbFile_IQM_Joint const * joint = &model->joints[jointIndex];
+					offset = channelIndex < 3 ? joint->translate[channelIndex] :
+							(channelIndex < 7 ? joint->rotate[channelIndex - 3] : joint->scale[channelIndex - 7]);
+				}
+				offsets[channelIndex][lane] = offset;
+				scales[channelIndex][lane] = scale;
+				batch->channelFrameIndexes[channelIndex][lane] = frameIndex;
+			}
+		}
+		for (uint32_t channelIndex = 0; channelIndex < HbAnim_Channel_Count; ++channelIndex) {
+			batch->channelOffsets[channelIndex] = HbMath_F32x4_LoadAligned(offsets[channelIndex]);
+			batch->channelScales[channelIndex] = HbMath_F32x4_LoadAligned(scales[channelIndex]);
+		}
+	}
+
+	for (uint32_t jointIndex = 0; jointIndex < jointCount; ++jointIndex) {
+		HbFile_IQM_Joint const * joint = &model->joints[jointIndex];
+		int32_t parent = joint->parent;
+		skeleton->jointParents[jointIndex] = parent;
+		HbAnim_Matrix * bindMatrix = &skeleton->bindMatrices[jointIndex];
+		HbAnimi_Matrix_Compose(joint->translate, joint->rotate, joint->scale, bindMatrix);
+		if (parent >= 0) {
+			HbAnim_Matrix_Multiply(&skeleton->bindMatrices[parent], bindMatrix, bindMatrix);
+		}
+		HbAnimi_Matrix_Invert(bindMatrix, &skeleton->inverseBindMatrices[jointIndex]);
+	}
+}
+
+void HbAnim_Skeleton_Destroy(HbAnim_Skeleton * skeleton) {
+	HbMemory_Free(skeleton->jointBatches);
+}
+
+/********
+ * Clips
+ ********/
+
+void HbAnim_Clip_Init(HbAnim_Clip * clip, HbAnim_Skeleton const * skeleton, HbFile_IQM_Model const * model, uint32_t animationIndex) {
+	HbFile_IQM_Animation const * animation = &model->animations[animationIndex];
+	clip->skeleton = skeleton;
+	clip->frames = model->frames + (size_t) animation->frameFirst * skeleton->frameChannelCount;
+	clip->frameCount = animation->frameCount;
+	clip->framesPerSecond = animation->framerate;
+	clip->loop = (animation->flags & HbFile_IQM_Animation_Flags_Loop) != 0;
+}
+
+static void HbAnimi_Clip_DecodeFrame(HbAnim_Skeleton_JointBatch const * batch, HbFile_IQM_Frame const * frame,
+		HbMath_F32x4 channels[HbAnim_Channel_Count]) {
+	for (uint32_t channelIndex = 0; channelIndex < HbAnim_Channel_Count; ++channelIndex) {
+		// Gathering the values of the 4 joints.
+		HbMath_VecAligned float values[HbAnim_JointBatchSize];
+		for (uint32_t lane = 0; lane < HbAnim_JointBatchSize; ++lane) {
+			uint32_t frameIndex = batch->channelFrameIndexes[channelIndex][lane];
+			values[lane] = frameIndex != HbAnim_Channel_NotAnimated ? (float) frame[frameIndex] : 0.0f;
+		}
+		channels[channelIndex] = HbMath_F32x4_MultiplyAdd(batch->channelOffsets[channelIndex],
+				HbMath_F32x4_LoadAligned(values), batch->channelScales[channelIndex]);
+	}
+}
+
+// Writes the matrices from the joint space to the parent space, up to 4 per batch.
+static void HbAnimi_Clip_SampleLocal(HbAnim_Clip const * clip, HbFile_IQM_Frame const * frame0, HbFile_IQM_Frame const * frame1, float factor,
+		HbAnim_Matrix * matrices) {
+	HbAnim_Skeleton const * skeleton = clip->skeleton;
+	uint32_t batchCount = (skeleton->jointCount + (HbAnim_JointBatchSize - 1)) / HbAnim_JointBatchSize;
+	HbMath_F32x4 factors = HbMath_F32x4_LoadReplicated(factor);
+	HbMath_F32x4 one = HbMath_F32x4_LoadReplicated(1.0f), two = HbMath_F32x4_LoadReplicated(2.0f);
+	HbMath_F32x4 signBit = HbMath_F32x4_LoadReplicated(-0.0f);
+	for (uint32_t batchIndex = 0; batchIndex < batchCount; ++batchIndex) {
+		HbAnim_Skeleton_JointBatch const * batch = &skeleton->jointBatches[batchIndex];
+		HbMath_F32x4 channels[HbAnim_Channel_Count], channels1[HbAnim_Channel_Count];
+		HbAnimi_Clip_DecodeFrame(batch, frame0, channels);
+		HbAnimi_Clip_DecodeFrame(batch, frame1, channels1);
+
+		// Taking the shortest path between the rotations.
+		HbMath_F32x4 rotationDot = HbMath_F32x4_Multiply(channels[3], channels1[3]);
+		for (uint32_t channelIndex = 4; channelIndex < 7; ++channelIndex) {
+			rotationDot = HbMath_F32x4_MultiplyAdd(rotationDot, channels[channelIndex], channels1[channelIndex]);
+		}
+		HbMath_F32x4 rotationFlip = HbMath_F32x4_And(rotationDot, signBit);
+		for (uint32_t channelIndex = 0; channelIndex < HbAnim_Channel_Count; ++channelIndex) {
+			HbMath_F32x4 value1 = channels1[channelIndex];
+			if (channelIndex >= 3 && channelIndex < 7) {
+				value1 = HbMath_F32x4_Xor(value1, rotationFlip);
+			}
+			channels[channelIndex] = HbMath_F32x4_MultiplyAdd(channels[channelIndex],
+					HbMath_F32x4_Subtract(value1, channels[channelIndex]), factors);
+		}
+
+		// Normalizing the rotation, with 2 from the conversion to a matrix included.
+		HbMath_F32x4 x = channels[3], y = channels[4], z = channels[5], w = channels[6];
+		HbMath_F32x4 lengthSquared = HbMath_F32x4_Multiply(x, x);
+		lengthSquared = HbMath_F32x4_MultiplyAdd(lengthSquared, y, y);
+		lengthSquared = HbMath_F32x4_MultiplyAdd(lengthSquared, z, z);
+		lengthSquared = HbMath_F32x4_MultiplyAdd(lengthSquared, w, w);
+		HbMath_F32x4 normalization = HbMath_F32x4_DivideFine(two, lengthSquared);
+		HbMath_F32x4 x2 = HbMath_F32x4_Multiply(x, normalization), y2 = HbMath_F32x4_Multiply(y, normalization);
+		HbMath_F32x4 z2 = HbMath_F32x4_Multiply(z, normalization);
+		HbMath_F32x4 xx = HbMath_F32x4_Multiply(x, x2), yy = HbMath_F32x4_Multiply(y, y2), zz = HbMath_F32x4_Multiply(z, z2);
+		HbMath_F32x4 xy = HbMath_F32x4_Multiply(x, y2), xz = HbMath_F32x4_Multiply(x, z2), yz = HbMath_F32x4_Multiply(y, z2);
+		HbMath_F32x4 wx = HbMath_F32x4_Multiply(w, x2), wy = HbMath_F32x4_Multiply(w, y2), wz = HbMath_F32x4_Multiply(w, z2);
+
+		// Translation * rotation * scale, then from 4 joints in each element to 4 elements of each joint.
+		HbMath_F32x4 scaleX = channels[7], scaleY = channels[8], scaleZ = channels[9];
+		HbMath_F32x4 m00 = HbMath_F32x4_Multiply(HbMath_F32x4_Subtract(one, HbMath_F32x4_Add(yy, zz)), scaleX);
+		HbMath_F32x4 m01 = HbMath_F32x4_Multiply(HbMath_F32x4_Subtract(xy, wz), scaleY);
+		HbMath_F32x4 m02 = HbMath_F32x4_Multiply(HbMath_F32x4_Add(xz, wy), scaleZ);
+		HbMath_F32x4 m03 = channels[0];
+		HbMath_F32x4 m10 = HbMath_F32x4_Multiply(HbMath_F32x4_Add(xy, wz), scaleX);
+		HbMath_F32x4 m11 = HbMath_F32x4_Multiply(HbMath_F32x4_Subtract(one, HbMath_F32x4_Add(xx, zz)), scaleY);
+		HbMath_F32x4 m12 = HbMath_F32x4_Multiply(HbMath_F32x4_Subtract(yz, wx), scaleZ);
+		HbMath_F32x4 m13 = channels[1];
+		HbMath_F32x4 m20 = HbMath_F32x4_Multiply(HbMath_F32x4_Subtract(xz, wy), scaleX);
+		HbMath_F32x4 m21 = HbMath_F32x4_Multiply(HbMath_F32x4_Add(yz, wx), scaleY);
+		HbMath_F32x4 m22 = HbMath_F32x4_Multiply(HbMath_F32x4_Subtract(one, HbMath_F32x4_Add(xx, yy)), scaleZ);
+		HbMath_F32x4 m23 = channels[2];
+		HbMath_F32x4_Transpose(m00, m01, m02, m03);
+		HbMath_F32x4_Transpose(m10, m11, m12, m13);
+		HbMath_F32x4_Transpose(m20, m21, m22, m23);
+		HbAnim_Matrix batchMatrices[HbAnim_JointBatchSize] = {
+			{ { m00, m10, m20 } }, { { m01, m11, m21 } }, { { m02, m12, m22 } }, { { m03, m13, m23 } },
+		};
+		uint32_t jointFirst = batchIndex * HbAnim_JointBatchSize;
+		memcpy(&matrices[jointFirst], batchMatrices,
+				HbMinU32(skeleton->jointCount - jointFirst, HbAnim_JointBatchSize) * sizeof(HbAnim_Matrix));
+	}
+}
+
+void HbAnim_Clip_Sample(HbAnim_Clip const * clip, float time, HbBool skinning, HbAnim_Matrix * matrices) {
+	HbAnim_Skeleton const * skeleton = clip->skeleton;
+	uint32_t jointCount = skeleton->jointCount;
+	uint32_t frameCount = clip->frameCount;
+	if (frameCount == 0) {
+		if (skinning) {
+			for (uint32_t jointIndex = 0; jointIndex < jointCount; ++jointIndex) {
+				HbAnim_Matrix * matrix = &matrices[jointIndex];
+				matrix->rows[0] = HbMath_F32x4_LoadXYZW(1.0f, 0.0f, 0.0f, 0.0f);
+				matrix->rows[1] = HbMath_F32x4_LoadXYZW(0.0f, 1.0f, 0.0f, 0.0f);
+				matrix->rows[2] = HbMath_F32x4_LoadXYZW(0.0f, 0.0f, 1.0f, 0.0f);
+			}
+		} else {
+			memcpy(matrices, skeleton->bindMatrices, jointCount * sizeof(HbAnim_Matrix));
+		}
+		return;
+	}
+
+	float frame = time * clip->framesPerSecond;
+	uint32_t frame0, frame1;
+	if (clip->loop) {
+		frame = fmodf(frame, (float) frameCount);
+		if (frame < 0.0f) {
+			frame += (float) frameCount;
+		}
+		frame0 = HbMinU32((uint32_t) frame, frameCount - 1);
+		frame1 = frame0 + 1 < frameCount ? frame0 + 1 : 0;
+	} else {
+		frame = HbClampF(frame, 0.0f, (float) (frameCount - 1));
+		frame0 = (uint32_t) frame;
+		frame1 = HbMinU32(frame0 + 1, frameCount - 1);
+	}
+	HbAnimi_Clip_SampleLocal(clip, clip->frames + (size_t) frame0 * skeleton->frameChannelCount,
+			clip->frames + (size_t) frame1 * skeleton->frameChannelCount, HbClampF(frame - (float) frame0, 0.0f, 1.0f), matrices);
+
+	// Parents are before children, so their matrices are already in the model space.
+	for (uint32_t jointIndex = 0; jointIndex < jointCount; ++jointIndex) {
+		int32_t parent = skeleton->jointParents[jointIndex];
+		if (parent >= 0) {
+			HbAnim_Matrix_Multiply(&matrices[parent], &matrices[jointIndex], &matrices[jointIndex]);
+		}
+	}
+	if (skinning) {
+		for (uint32_t jointIndex = 0; jointIndex < jointCount; ++jointIndex) {
+			HbAnim_Matrix_Multiply(&matrices[jointIndex], &skeleton->inverseBindMatrices[jointIndex], &matrices[jointIndex]);
+		}
+	}
+}
+
+/*************************************
+ * Sampling of many instances at once
+ *************************************/
+
+void HbAnim_SampleInstanceRange(HbAnim_Instance const * instances, uint32_t instanceFirst, uint32_t instanceCount, HbBool skinning) {
+	for (uint32_t instanceIndex = instanceFirst; instanceIndex < instanceFirst + instanceCount; ++instanceIndex) {
+		HbAnim_Instance const * instance = &instances[instanceIndex];
+		HbAnim_Clip_Sample(instance->clip, instance->time, skinning, instance->matrices);
+	}
+}
+
+typedef struct HbAnimi_SampleInstances_Job {
+	HbAnim_Instance const * instances;
+	uint32_t instanceFirst;
+	uint32_t instanceCount;
+	HbBool skinning;
+} HbAnimi_SampleInstances_Job;
+
+static void HbAnimi_SampleInstances_RunJob(void * data) {
+	HbAnimi_SampleInstances_Job const * job = (HbAnimi_SampleInstances_Job const *) data;
+	HbAnim_SampleInstanceRange(job->instances, job->instanceFirst, job->instanceCount, job->skinning);
+}
+
+void HbAnim_SampleInstances(HbAnim_Instance const * instances, uint32_t instanceCount, HbBool skinning, uint32_t threadCount) {
+	uint32_t maxThreadCount = (instanceCount + (HbAnim_SampleInstances_MinInstancesPerThread - 1)) /
+			HbAnim_SampleInstances_MinInstancesPerThread;
+	threadCount = HbMaxU32(HbMinU32(HbMinU32(threadCount, maxThreadCount), HbAnim_SampleInstances_MaxThreads), 1);
+	HbAnimi_SampleInstances_Job jobs[HbAnim_SampleInstances_MaxThreads];
+	HbParallel_Thread threads[HbAnim_SampleInstances_MaxThreads];
+	HbBool threadsStarted[HbAnim_SampleInstances_MaxThreads];
+	uint32_t instancesPerJob = instanceCount / threadCount;
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		HbAnimi_SampleInstances_Job * job = &jobs[jobIndex];
+		job->instances = instances;
+		job->instanceFirst = jobIndex * instancesPerJob;
+		job->instanceCount = (jobIndex + 1 == threadCount) ? instanceCount - job->instanceFirst : instancesPerJob;
+		job->skinning = skinning;
+	}
+	// Job 0 is done on the calling thread, and jobs whose threads couldn't be started too.
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		threadsStarted[jobIndex] = HbParallel_Thread_Start(&threads[jobIndex], "HbAnimSample", HbAnimi_SampleInstances_RunJob, &jobs[jobIndex]);
+	}
+	HbAnimi_SampleInstances_RunJob(&jobs[0]);
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		if (threadsStarted[jobIndex]) {
+			HbParallel_Thread_Destroy(&threads[jobIndex]);
+		} else {
+			HbAnimi_SampleInstances_RunJob(&jobs[jobIndex]);
+		}
+	}
+}
@@ -0,0 +1,108 @@
+#ifndef HbInclude_HbAnim
+#define HbInclude_HbAnim
+#include "HbFile_IQM.h"
+#include "HbMath.h"
+#include "HbMemory.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Skeletal animation of IQM models. Joints are sampled in batches of 4, with the lanes of the vectors holding different joints,
+ * and the quantized frame channels are dequantized when sampling, so clips are used directly from the file.
+ */
+
+/***********
+ * Matrices
+ ***********/
+
+// Affine 3x4, row-major, transforming column vectors - like float3x4 in HLSL, can be copied to constant buffers as is.
+typedef struct HbAnim_Matrix {
+	HbMath_F32x4 rows[3];
+} HbAnim_Matrix;
+
+// a * b (b is applied first).
+HbForceInline void HbAnim_Matrix_Multiply(HbAnim_Matrix const * a, HbAnim_Matrix const * b, HbAnim_Matrix * result) {
+	HbMath_F32x4 b0 = b->rows[0], b1 = b->rows[1], b2 = b->rows[2];
+	HbMath_F32x4 translationMask = HbMath_S32x4_BitsAsF32x4(HbMath_S32x4_LoadXYZW(0, 0, 0, -1));
+	for (uint32_t rowIndex = 0; rowIndex < 3; ++rowIndex) {
+		HbMath_F32x4 row = a->rows[rowIndex];
+		HbMath_F32x4 resultRow = HbMath_F32x4_And(row, translationMask);
+		resultRow = HbMath_F32x4_MultiplyAdd(resultRow, HbMath_F32x4_ReplicateX(row), b0);
+		resultRow = HbMath_F32x4_MultiplyAdd(resultRow, HbMath_F32x4_ReplicateY(row), b1);
+		result->rows[rowIndex] = HbMath_F32x4_MultiplyAdd(resultRow, HbMath_F32x4_ReplicateZ(row), b2);
+	}
+}
+
+/***********
+ * Skeleton
+ ***********/
+
+#define HbAnim_JointBatchSize 4
+#define HbAnim_Channel_Count 10 // Translation XYZ, rotation quaternion XYZW, scale XYZ, like in IQM poses.
+#define HbAnim_Channel_NotAnimated UINT16_MAX
+
+// Joints (JointBatchSize * batch index + lane), with the channels dequantized as offset + frame value * scale.
+typedef struct HbAnim_Skeleton_JointBatch {
+	HbMath_F32x4 channelOffsets[HbAnim_Channel_Count];
+	HbMath_F32x4 channelScales[HbAnim_Channel_Count];
+	uint16_t channelFrameIndexes[HbAnim_Channel_Count][HbAnim_JointBatchSize]; // HbAnim_Channel_NotAnimated for just the offset.
+} HbAnim_Skeleton_JointBatch;
+
+typedef struct HbAnim_Skeleton {
+	uint32_t jointCount;
+	uint32_t frameChannelCount;
+	// All allocated from the tag at once.
+	HbAnim_Skeleton_JointBatch * jointBatches;
+	int32_t * jointParents; // Parents are before children, negative for roots.
+	HbAnim_Matrix * bindMatrices; // From the joint space to the model space in the base pose.
+	HbAnim_Matrix * inverseBindMatrices;
+} HbAnim_Skeleton;
+
+// The model must be initialized successfully. Without poses, the base pose of the joints is used for sampling.
+void HbAnim_Skeleton_Init(HbAnim_Skeleton * skeleton, HbFile_IQM_Model const * model, HbMemory_Tag * tag);
+void HbAnim_Skeleton_Destroy(HbAnim_Skeleton * skeleton);
+
+/********
+ * Clips
+ ********/
+
+typedef struct HbAnim_Clip {
+	HbAnim_Skeleton const * skeleton;
+	HbFile_IQM_Frame const * frames; // In the file.
+	uint32_t frameCount;
+	float framesPerSecond;
+	HbBool loop;
+} HbAnim_Clip;
+
+// The skeleton must be created from the same model.
+void HbAnim_Clip_Init(HbAnim_Clip * clip, HbAnim_Skeleton const * skeleton, HbFile_IQM_Model const * model, uint32_t animationIndex);
+// Writes the matrices of all joints of the skeleton at the time in seconds, from the joint space to the model space,
+// or, if skinning is true, from the model space of the base pose to the animated model space (for vertex skinning).
+// Frames are interpolated linearly (rotation quaternions with normalization), looping clips wrap around from the last frame
+// to the first, and the time in others is clamped. Clips without frames are sampled in the base pose.
+void HbAnim_Clip_Sample(HbAnim_Clip const * clip, float time, HbBool skinning, HbAnim_Matrix * matrices);
+
+/*************************************
+ * Sampling of many instances at once
+ *************************************/
+
+typedef struct HbAnim_Instance {
+	HbAnim_Clip const * clip;
+	float time;
+	HbAnim_Matrix * matrices; // clip->skeleton->jointCount.
+} HbAnim_Instance;
+
+// Samples instances [instanceFirst, instanceFirst + instanceCount). Instances only write their own matrices, so for sampling every frame,
+// contiguous ranges can be given to the jobs of the caller's worker threads without any synchronization between them.
+void HbAnim_SampleInstanceRange(HbAnim_Instance const * instances, uint32_t instanceFirst, uint32_t instanceCount, HbBool skinning);
+// Samples the instances on up to threadCount threads (including the calling one), with contiguous ranges of instances on each.
+// The threads are started and joined in every call, so this is for tools and loading, not for per-frame sampling.
+#define HbAnim_SampleInstances_MaxThreads 64
+#define HbAnim_SampleInstances_MinInstancesPerThread 16
+void HbAnim_SampleInstances(HbAnim_Instance const * instances, uint32_t instanceCount, HbBool skinning, uint32_t threadCount);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
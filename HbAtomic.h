@@ -34,6 +34,31 @@ HbForceInline int64_t HbAtomic_IncrementI64(int64_t volatile * location) {
 	return (int64_t) InterlockedIncrement64((LONG64 volatile *) location);
 }
 
+#elif HbPlatform_Compiler_GNU
+/**************
+ * GNU atomics
+ **************/
+
+// Like the Interlocked functions, these are full barriers.
+
+// Compare and swap.
+
+HbForceInline int32_t HbAtomic_CompareAndSwapI32(int32_t volatile * location, int32_t setValue, int32_t compareValue) {
+	return __sync_val_compare_and_swap(location, compareValue, setValue);
+}
+HbForceInline int64_t HbAtomic_CompareAndSwapI64(int64_t volatile * location, int64_t setValue, int64_t compareValue) {
+	return __sync_val_compare_and_swap(location, compareValue, setValue);
+}
+
+// Basic operations.
+
+HbForceInline int32_t HbAtomic_IncrementI32(int32_t volatile * location) {
+	return __sync_add_and_fetch(location, 1);
+}
+HbForceInline int64_t HbAtomic_IncrementI64(int64_t volatile * location) {
+	return __sync_add_and_fetch(location, 1);
+}
+
 #else
 #error No atomic operations for the target OS.
 #endif
@@ -58,7 +83,7 @@ HbForceInline size_t HbAtomic_CompareAndSwapSize(size_t volatile * location, siz
 	#endif
 }
 HbForceInline void * HbAtomic_CompareAndSwapPointer(void * volatile * location, void * setValue, void * compareValue) {
-	return (void *) HbAtomic_CompareAndSwapU64((size_t volatile *) location, (size_t) setValue, (size_t) compareValue);
+	return (void *) HbAtomic_CompareAndSwapSize((size_t volatile *) location, (size_t) setValue, (size_t) compareValue);
 }
 
 // Basic operations.
@@ -80,20 +105,28 @@ HbForceInline size_t HbAtomic_IncrementSize(size_t volatile * location) {
 // Min/max.
 
 HbForceInline void HbAtomic_MinI32(int32_t volatile * location, int32_t newBound) {
-	int32_t oldValue = *location;
-	while (oldValue > newBound && (oldValue = HbAtomic_CompareAndSwapI32(location, newBound, oldValue)) != oldValue) {}
+	int32_t oldValue = *location, currentValue;
+	while (oldValue > newBound && (currentValue = HbAtomic_CompareAndSwapI32(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MinI64(int64_t volatile * location, int64_t newBound) {
-	int64_t oldValue = *location;
-	while (oldValue > newBound && (oldValue = HbAtomic_CompareAndSwapI64(location, newBound, oldValue)) != oldValue) {}
+	int64_t oldValue = *location, currentValue;
+	while (oldValue > newBound && (currentValue = HbAtomic_CompareAndSwapI64(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MinU32(uint32_t volatile * location, uint32_t newBound) {
-	uint32_t oldValue = *location;
-	while (oldValue > newBound && (oldValue = HbAtomic_CompareAndSwapU32(location, newBound, oldValue)) != oldValue) {}
+	uint32_t oldValue = *location, currentValue;
+	while (oldValue > newBound && (currentValue = HbAtomic_CompareAndSwapU32(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MinU64(uint64_t volatile * location, uint64_t newBound) {
-	uint64_t oldValue = *location;
-	while (oldValue > newBound && (oldValue = HbAtomic_CompareAndSwapU64(location, newBound, oldValue)) != oldValue) {}
+	uint64_t oldValue = *location, currentValue;
+	while (oldValue > newBound && (currentValue = HbAtomic_CompareAndSwapU64(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MinSize(size_t volatile * location, size_t newBound) {
 	#if HbPlatform_CPU_32Bit
@@ -104,20 +137,28 @@ HbForceInline void HbAtomic_MinSize(size_t volatile * location, size_t newBound)
 }
 
 HbForceInline void HbAtomic_MaxI32(int32_t volatile * location, int32_t newBound) {
-	int32_t oldValue = *location;
-	while (oldValue < newBound && (oldValue = HbAtomic_CompareAndSwapI32(location, newBound, oldValue)) != oldValue) {}
+	int32_t oldValue = *location, currentValue;
+	while (oldValue < newBound && (currentValue = HbAtomic_CompareAndSwapI32(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MaxI64(int64_t volatile * location, int64_t newBound) {
-	int64_t oldValue = *location;
-	while (oldValue < newBound && (oldValue = HbAtomic_CompareAndSwapI64(location, newBound, oldValue)) != oldValue) {}
+	int64_t oldValue = *location, currentValue;
+	while (oldValue < newBound && (currentValue = HbAtomic_CompareAndSwapI64(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MaxU32(uint32_t volatile * location, uint32_t newBound) {
-	uint32_t oldValue = *location;
-	while (oldValue < newBound && (oldValue = HbAtomic_CompareAndSwapU32(location, newBound, oldValue)) != oldValue) {}
+	uint32_t oldValue = *location, currentValue;
+	while (oldValue < newBound && (currentValue = HbAtomic_CompareAndSwapU32(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MaxU64(uint64_t volatile * location, uint64_t newBound) {
-	uint64_t oldValue = *location;
-	while (oldValue < newBound && (oldValue = HbAtomic_CompareAndSwapU64(location, newBound, oldValue)) != oldValue) {}
+	uint64_t oldValue = *location, currentValue;
+	while (oldValue < newBound && (currentValue = HbAtomic_CompareAndSwapU64(location, newBound, oldValue)) != oldValue) {
+		oldValue = currentValue;
+	}
 }
 HbForceInline void HbAtomic_MaxSize(size_t volatile * location, size_t newBound) {
 	#if HbPlatform_CPU_32Bit
@@ -73,6 +73,38 @@ HbForceInline int32_t HbBit_HighestOneU64(uint64_t value) {
 	#endif
 }
 
+#define HbBit_RotateLeftU32 _rotl
+#define HbBit_RotateLeftU64 _rotl64
+
+#elif HbPlatform_Compiler_GNU
+HbForceInline int32_t HbBit_LowestOneU32(uint32_t value) {
+	return value != 0 ? __builtin_ctz(value) : -1;
+}
+
+HbForceInline int32_t HbBit_LowestOneU64(uint64_t value) {
+	return value != 0 ? __builtin_ctzll(value) : -1;
+}
+
+HbForceInline int32_t HbBit_HighestOneU32(uint32_t value) {
+	return value != 0 ? 31 - __builtin_clz(value) : -1;
+}
+
+HbForceInline int32_t HbBit_HighestOneU64(uint64_t value) {
+	return value != 0 ? 63 - __builtin_clzll(value) : -1;
+}
+
+// Recognized as rotation instructions by GCC and Clang.
+HbForceInline uint32_t HbBit_RotateLeftU32(uint32_t value, int32_t shift) {
+	return (value << (shift & 31)) | (value >> (-shift & 31));
+}
+HbForceInline uint64_t HbBit_RotateLeftU64(uint64_t value, int32_t shift) {
+	return (value << (shift & 63)) | (value >> (-shift & 63));
+}
+
+#else
+#error No bitwise math functions (HbBit) for the target compiler.
+#endif
+
 #if HbPlatform_CPU_32Bit
 HbForceInline int32_t HbBit_LowestOneSize(size_t value) {
 	return HbBit_LowestOneU32((uint32_t) value);
@@ -89,10 +121,6 @@ HbForceInline int32_t HbBit_HighestOneSize(size_t value) {
 }
 #endif
 
-#else
-#error No bitwise math functions (HbBit) for the target compiler.
-#endif
-
 HbForceInline HbBool HbBit_IsPO2U32(uint32_t value) { return (value & (value - 1)) == 0; }
 HbForceInline HbBool HbBit_IsPO2U64(uint64_t value) { return (value & (value - 1)) == 0; }
 HbForceInline HbBool HbBit_IsPO2Size(size_t value) { return (value & (value - 1)) == 0; }
@@ -7,6 +7,7 @@
 #include <float.h> // Things like FLT_MAX.
 #include <math.h> // fmin, fmax.
 #include <stdarg.h>
+#include <stddef.h> // ptrdiff_t for HbOffsetOf.
 #include <stdint.h> // Using int#_t types for consistency and because uint is shorter than unsigned int.
 #include <stdlib.h> // Things like abs.
 #include <string.h> // memcpy, memmove, memset.
@@ -40,6 +41,9 @@ typedef uint8_t HbBool;
 #if defined(_WIN32)
 #define HbPlatform_OS_Windows 1
 #define HbPlatform_OS_WindowsDesktop 1
+#elif defined(__linux__)
+// For console tools and benchmarks - files, threads and time, but no GPU, windows or input devices.
+#define HbPlatform_OS_Linux 1
 #else
 #error Unsupported target OS.
 #endif
@@ -69,16 +73,36 @@ typedef uint8_t HbBool;
 
 #define HbOffsetOf(type, field) ((ptrdiff_t) (uint8_t const *) &(((type *) NULL)->field))
 
+#if HbPlatform_Compiler_MSVC
+#define HbStaticAssert static_assert
+#else
+#define HbStaticAssert _Static_assert
+#endif
+
 // Force inlining.
 
 #if HbPlatform_Compiler_MSVC
 #define HbForceInline __forceinline
 #elif HbPlatform_Compiler_GNU
-#define HbForceInline __attribute__((always_inline))
+#define HbForceInline inline __attribute__((always_inline))
 #else
 #error No HbForceInline known for the current compiler.
 #endif
 
+// printf format string checking, also for functions supporting a subset of printf specifiers.
+// HbPrintfFormatAttribute(format argument index, first variadic argument index) must be placed before the declaration.
+
+#if HbPlatform_Compiler_MSVC
+#include <sal.h>
+#define HbPrintfFormatString _Printf_format_string_
+#define HbPrintfFormatAttribute(formatIndex, firstArgumentIndex)
+#elif HbPlatform_Compiler_GNU
+#define HbPrintfFormatString
+#define HbPrintfFormatAttribute(formatIndex, firstArgumentIndex) __attribute__((format(printf, formatIndex, firstArgumentIndex)))
+#else
+#error No HbPrintfFormat known for the current compiler.
+#endif
+
 // Stack allocation.
 // WARNING: Don't call with 0, it may cause freeing all the `alloca`ted memory on some compilers.
 
@@ -96,6 +120,10 @@ typedef uint8_t HbBool;
 #define HbByteSwapU16 _byteswap_ushort
 #define HbByteSwapU32 _byteswap_ulong
 #define HbByteSwapU64 _byteswap_uint64
+#elif HbPlatform_Compiler_GNU
+#define HbByteSwapU16 __builtin_bswap16
+#define HbByteSwapU32 __builtin_bswap32
+#define HbByteSwapU64 __builtin_bswap64
 #else
 #error No HbByteSwap for the current compiler.
 #endif
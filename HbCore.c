@@ -2,9 +2,11 @@
 #include "HbInput.h"
 #include "HbMemory.h"
 #include "HbPlatform.h"
+#include "HbText_Intern.h"
 
 void HbCore_InitEngine() {
 	HbMemory_Init(); // Must be the first in case something creates a tag.
+	HbText_Intern_InitGlobal(); // Before everything that names objects.
 	HbPlatform_Init();
 	HbInput_Init();
 }
@@ -12,5 +14,6 @@ void HbCore_InitEngine() {
 void HbCore_ShutdownEngine() {
 	HbInput_Shutdown();
 	HbPlatform_Shutdown();
+	HbText_Intern_ShutdownGlobal();
 	HbMemory_Shutdown();
 }
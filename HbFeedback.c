@@ -34,6 +34,30 @@ void HbFeedback_CrashV(HbBool isAssert, char const * functionName, char const *
 #error No HbFeedback_CrashV for the target Windows application model.
 #endif
 
+#elif HbPlatform_OS_Linux
+
+/******************
+ * Linux-specific.
+ ******************/
+
+#include <stdio.h>
+
+void HbFeedback_DebugMessageForceV(char const * format, va_list arguments) {
+	char message[1024];
+	HbTextA_FormatV(message, HbArrayLength(message), format, arguments);
+	fprintf(stderr, "%s\n", message);
+}
+
+void HbFeedback_CrashV(HbBool isAssert, char const * functionName, char const * messageFormat, va_list messageArguments) {
+	char message[1024];
+	size_t written = HbTextA_Copy(message, HbArrayLength(message), functionName);
+	written += HbTextA_CopyInto(message, HbArrayLength(message), written, isAssert ? " (assertion): " : ": ");
+	HbTextA_FormatV(message + written, HbArrayLength(message) - written, messageFormat, messageArguments);
+	HbFeedback_DebugMessageForce("Fatal error: %s", message);
+	// SIGABRT stops in a debugger like HbFeedback_Break, and terminates otherwise.
+	abort();
+}
+
 #else
 #error No HbFeedback output functions for the target OS.
 #endif
@@ -4,6 +4,9 @@
 #if HbPlatform_OS_Windows
 #include <intrin.h>
 #endif
+#if HbPlatform_OS_Linux
+#include <signal.h>
+#endif
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -12,14 +15,13 @@ extern "C" {
 #define HbFeedback_DebugBuild 1
 #endif
 
-#if HbPlatform_Compiler_MSVC
-#define HbFeedback_StaticAssert static_assert
-#else
-#define HbFeedback_StaticAssert _Static_assert
-#endif
+// Also available without HbFeedback as HbStaticAssert, for the code not depending on the OS.
+#define HbFeedback_StaticAssert HbStaticAssert
 
 #if HbPlatform_OS_Windows
 #define HbFeedback_Break __debugbreak
+#elif HbPlatform_OS_Linux
+#define HbFeedback_Break() raise(SIGTRAP)
 #else
 #error No HbFeedback_Break implementation for the target OS.
 #endif
@@ -1,5 +1,11 @@
 #include "HbFile.h"
-#include "HbFile_IQM.h"
+#if HbPlatform_OS_Linux
+#include <errno.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
 
 HbBool HbFile_Mapping_InitRead(HbFile_Mapping * mapping, HbTextU8 const * path, HbBool max4GB) {
 	#if HbPlatform_OS_Windows
@@ -32,6 +38,27 @@ HbBool HbFile_Mapping_InitRead(HbFile_Mapping * mapping, HbTextU8 const * path,
 		return HbFalse;
 	}
 	return HbTrue;
+	#elif HbPlatform_OS_Linux
+	mapping->linuxFile = open(path, O_RDONLY | O_CLOEXEC);
+	if (mapping->linuxFile < 0) {
+		return HbFalse;
+	}
+	struct stat fileStat;
+	if (fstat(mapping->linuxFile, &fileStat) != 0 || fileStat.st_size <= 0) {
+		close(mapping->linuxFile);
+		return HbFalse;
+	}
+	if ((max4GB && (uint64_t) fileStat.st_size > UINT32_MAX) || (uint64_t) fileStat.st_size > SIZE_MAX) {
+		close(mapping->linuxFile);
+		return HbFalse;
+	}
+	mapping->size = (size_t) fileStat.st_size;
+	mapping->data = mmap(NULL, mapping->size, PROT_READ, MAP_PRIVATE, mapping->linuxFile, 0);
+	if (mapping->data == MAP_FAILED) {
+		close(mapping->linuxFile);
+		return HbFalse;
+	}
+	return HbTrue;
 	#else
 	#error No file mapping implementation for the target OS.
 	#endif
@@ -42,7 +69,80 @@ void HbFile_Mapping_Destroy(HbFile_Mapping * mapping) {
 	UnmapViewOfFile(mapping->data);
 	CloseHandle(mapping->windowsHandle);
 	CloseHandle(mapping->windowsFileHandle);
+	#elif HbPlatform_OS_Linux
+	munmap(mapping->data, mapping->size);
+	close(mapping->linuxFile);
+	#endif
+}
+
+HbBool HbFile_Reader_Init(HbFile_Reader * reader, HbTextU8 const * path) {
+	#if HbPlatform_OS_Windows
+	size_t pathU16Size = HbTextU8_LengthU16Elems(path) + 1;
+	HbTextU16 * pathU16 = HbStackAlloc(HbTextU16, pathU16Size);
+	HbTextU16_FromU8(pathU16, pathU16Size, path, HbFalse);
+	reader->windowsFileHandle = CreateFileW(pathU16, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_RANDOM_ACCESS, NULL);
+	if (reader->windowsFileHandle == INVALID_HANDLE_VALUE) {
+		return HbFalse;
+	}
+	LARGE_INTEGER fileSize;
+	if (!GetFileSizeEx(reader->windowsFileHandle, &fileSize)) {
+		CloseHandle(reader->windowsFileHandle);
+		return HbFalse;
+	}
+	reader->size = (uint64_t) fileSize.QuadPart;
+	return HbTrue;
+	#elif HbPlatform_OS_Linux
+	reader->linuxFile = open(path, O_RDONLY | O_CLOEXEC);
+	if (reader->linuxFile < 0) {
+		return HbFalse;
+	}
+	struct stat fileStat;
+	if (fstat(reader->linuxFile, &fileStat) != 0) {
+		close(reader->linuxFile);
+		return HbFalse;
+	}
+	reader->size = (uint64_t) fileStat.st_size;
+	return HbTrue;
+	#else
+	#error No file reading implementation for the target OS.
+	#endif
+}
+
+void HbFile_Reader_Destroy(HbFile_Reader * reader) {
+	#if HbPlatform_OS_Windows
+	CloseHandle(reader->windowsFileHandle);
+	#elif HbPlatform_OS_Linux
+	close(reader->linuxFile);
 	#endif
 }
 
-char const HbFile_IQM_Magic[16] = "INTERQUAKEMODEL";
+HbBool HbFile_Reader_Read(HbFile_Reader * reader, uint64_t offset, void * buffer, uint32_t size) {
+	if (offset > reader->size || reader->size - offset < size) {
+		return HbFalse;
+	}
+	#if HbPlatform_OS_Windows
+	// With an OVERLAPPED offset, the file pointer is not shared between threads reading from different locations.
+	OVERLAPPED overlapped = { 0 };
+	overlapped.Offset = (DWORD) offset;
+	overlapped.OffsetHigh = (DWORD) (offset >> 32);
+	DWORD bytesRead;
+	return ReadFile(reader->windowsFileHandle, buffer, size, &bytesRead, &overlapped) && bytesRead == size;
+	#elif HbPlatform_OS_Linux
+	// pread doesn't use the shared file offset either, but may read less than requested, for instance, if interrupted by a signal.
+	while (size != 0) {
+		ssize_t bytesRead = pread(reader->linuxFile, buffer, size, (off_t) offset);
+		if (bytesRead <= 0) {
+			if (bytesRead < 0 && errno == EINTR) {
+				continue;
+			}
+			return HbFalse;
+		}
+		buffer = (uint8_t *) buffer + bytesRead;
+		offset += (uint64_t) bytesRead;
+		size -= (uint32_t) bytesRead;
+	}
+	return HbTrue;
+	#else
+	#error No file reading implementation for the target OS.
+	#endif
+}
@@ -14,12 +14,28 @@ typedef struct HbFile_Mapping {
 #if HbPlatform_OS_Windows
 	HANDLE windowsFileHandle;
 	HANDLE windowsHandle;
+#elif HbPlatform_OS_Linux
+	int linuxFile;
 #endif
 } HbFile_Mapping;
 // Fails for empty files.
 HbBool HbFile_Mapping_InitRead(HbFile_Mapping * mapping, HbTextU8 const * path, HbBool max4GB);
 void HbFile_Mapping_Destroy(HbFile_Mapping * mapping);
 
+// Reading of parts of files that are too large to be kept in memory, thread-safe.
+typedef struct HbFile_Reader {
+	uint64_t size;
+#if HbPlatform_OS_Windows
+	HANDLE windowsFileHandle;
+#elif HbPlatform_OS_Linux
+	int linuxFile;
+#endif
+} HbFile_Reader;
+HbBool HbFile_Reader_Init(HbFile_Reader * reader, HbTextU8 const * path);
+void HbFile_Reader_Destroy(HbFile_Reader * reader);
+// Returns false if couldn't read the whole range.
+HbBool HbFile_Reader_Read(HbFile_Reader * reader, uint64_t offset, void * buffer, uint32_t size);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,4 +1,5 @@
 #include "HbFile_DDS.h"
+#include "HbMath.h"
 
 typedef struct HbFile_DDS_PixelFormatImageFormatMapping {
 	HbGPU_Image_Format imageFormat;
@@ -101,44 +102,45 @@ static HbGPU_Image_Format const HbFile_DDS_DXGIFormatsToImageFormats[] = {
 	[HbFile_DDS_DXGIFormat_B4G4R4A4_UNorm] = HbGPU_Image_Format_4_4_4_4_BGRA_UNorm,
 };
 
-void const * HbFile_DDS_ValidateAndGetInfo(void const * dds, size_t ddsSize, HbGPU_Image_Info * info) {
-	if (ddsSize < sizeof(uint32_t) + sizeof(HbFile_DDS_Header)) {
-		return NULL;
+HbBool HbFile_DDS_ValidateHeadAndGetInfo(void const * head, size_t headSize, uint64_t fileSize,
+		HbGPU_Image_Info * info, uint32_t * imageDataOffsetOut) {
+	if (headSize < sizeof(uint32_t) + sizeof(HbFile_DDS_Header)) {
+		return HbFalse;
 	}
-	if (*((uint32_t const *) dds) != HbFile_DDS_Magic) {
-		return NULL;
+	if (*((uint32_t const *) head) != HbFile_DDS_Magic) {
+		return HbFalse;
 	}
-	HbFile_DDS_Header const * header = (HbFile_DDS_Header const *) ((uint8_t const *) dds + sizeof(uint32_t));
+	HbFile_DDS_Header const * header = (HbFile_DDS_Header const *) ((uint8_t const *) head + sizeof(uint32_t));
 	if (header->structSize != sizeof(HbFile_DDS_Header) || (header->flags & HbFile_DDS_Flags_Required) != HbFile_DDS_Flags_Required ||
 			header->height == 0 || header->width == 0) {
-		return NULL;
+		return HbFalse;
 	}
 	uint32_t mipMapCount = 1;
 	if (header->flags & HbFile_DDS_Flags_MipMapCount) {
 		mipMapCount = header->mipMapCount;
 		if (mipMapCount == 0) {
-			return NULL;
+			return HbFalse;
 		}
 	}
 	HbGPU_Image_Dimensions dimensions;
 	uint32_t depth = 1, arraySize = 1;
-	size_t imageDataOffset = sizeof(uint32_t) + sizeof(HbFile_DDS_Header);
+	uint32_t imageDataOffset = sizeof(uint32_t) + sizeof(HbFile_DDS_Header);
 	HbGPU_Image_Format format = HbGPU_Image_Format_Invalid;
 	uint32_t fourCC = (header->pixelFormat.flags & HbFile_DDS_PixelFormat_Flags_FourCC) ? header->pixelFormat.fourCC : 0;
 	if (fourCC == HbFile_DDS_FourCC_DX10) {
-		if (ddsSize < (imageDataOffset + sizeof(HbFile_DDS_HeaderDXT10))) {
-			return NULL;
+		if (headSize < (imageDataOffset + sizeof(HbFile_DDS_HeaderDXT10))) {
+			return HbFalse;
 		}
-		HbFile_DDS_HeaderDXT10 const * headerDXT10 = (HbFile_DDS_HeaderDXT10 const *) ((uint8_t const *) dds + imageDataOffset);
+		HbFile_DDS_HeaderDXT10 const * headerDXT10 = (HbFile_DDS_HeaderDXT10 const *) ((uint8_t const *) head + imageDataOffset);
 		imageDataOffset += sizeof(HbFile_DDS_HeaderDXT10);
 		arraySize = headerDXT10->arraySize;
 		if (arraySize == 0) {
-			return NULL;
+			return HbFalse;
 		}
 		switch (headerDXT10->dimension) {
 		case HbFile_DDS_Dimension_Texture1D:
 			if (header->height != 1) {
-				return NULL;
+				return HbFalse;
 			}
 			dimensions = arraySize > 1 ? HbGPU_Image_Dimensions_1DArray : HbGPU_Image_Dimensions_1D;
 			break;
@@ -151,19 +153,19 @@ void const * HbFile_DDS_ValidateAndGetInfo(void const * dds, size_t ddsSize, HbG
 			break;
 		case HbFile_DDS_Dimension_Texture3D:
 			if (arraySize != 1 || !(header->flags & HbFile_DDS_Flags_Volume)) {
-				return NULL;
+				return HbFalse;
 			}
 			dimensions = HbGPU_Image_Dimensions_3D;
 			depth = header->depth;
 			if (depth == 0) {
-				return NULL;
+				return HbFalse;
 			}
 			break;
 		default:
-			return NULL;
+			return HbFalse;
 		}
 		if (headerDXT10->dxgiFormat >= HbArrayLength(HbFile_DDS_DXGIFormatsToImageFormats)) {
-			return NULL;
+			return HbFalse;
 		}
 		format = HbFile_DDS_DXGIFormatsToImageFormats[headerDXT10->dxgiFormat];
 	} else {
@@ -171,11 +173,11 @@ void const * HbFile_DDS_ValidateAndGetInfo(void const * dds, size_t ddsSize, HbG
 			dimensions = HbGPU_Image_Dimensions_3D;
 			depth = header->depth;
 			if (depth == 0) {
-				return NULL;
+				return HbFalse;
 			}
 		} else if (header->caps2 & HbFile_DDS_Caps2_Cubemap) {
 			if ((header->caps2 & HbFile_DDS_Caps2_CubemapAllFaces) != HbFile_DDS_Caps2_CubemapAllFaces) {
-				return NULL;
+				return HbFalse;
 			}
 			dimensions = HbGPU_Image_Dimensions_Cube;
 		} else {
@@ -227,28 +229,227 @@ void const * HbFile_DDS_ValidateAndGetInfo(void const * dds, size_t ddsSize, HbG
 	info->samplesLog2 = 0;
 	info->usageOptions = 0;
 	if (!HbGPU_Image_Info_CleanupAndValidate(info)) {
+		return HbFalse;
+	}
+	uint64_t requiredImageDataSize = HbFile_DDS_GetImageDataSize(info);
+	if (fileSize < imageDataOffset || fileSize - imageDataOffset < requiredImageDataSize) {
+		return HbFalse;
+	}
+	*imageDataOffsetOut = imageDataOffset;
+	return HbTrue;
+}
+
+void const * HbFile_DDS_ValidateAndGetInfo(void const * dds, size_t ddsSize, HbGPU_Image_Info * info) {
+	uint32_t imageDataOffset;
+	if (!HbFile_DDS_ValidateHeadAndGetInfo(dds, ddsSize, ddsSize, info, &imageDataOffset)) {
 		return NULL;
 	}
-	uint32_t formatElementSize = HbGPU_Image_Copy_ElementSize(format, HbFalse);
-	HbBool formatIs4x4 = HbGPU_Image_Format_Is4x4(format);
-	uint64_t requiredImageDataSize = 0;
-	for (uint32_t mip = 0; mip < mipMapCount; ++mip) {
-		uint32_t mipWidth = header->width, mipHeight = header->height, mipDepth = depth;
-		HbGPU_Image_MipSize(mip, dimensions, &mipWidth, &mipHeight, &mipDepth);
+	return (uint8_t const *) dds + imageDataOffset;
+}
+
+/**********
+ * Writing
+ **********/
+
+uint64_t HbFile_DDS_GetMipDataSize(HbGPU_Image_Info const * info, uint32_t mip) {
+	uint32_t mipWidth = info->width, mipHeight = info->height, mipDepth = HbGPU_Image_Info_Get3DDepth(info);
+	HbGPU_Image_MipSize(mip, info->dimensions, &mipWidth, &mipHeight, &mipDepth);
+	if (HbGPU_Image_Format_Is4x4(info->format)) {
+		mipWidth = (mipWidth + 3) >> 2;
+		mipHeight = (mipHeight + 3) >> 2;
+	}
+	return ((uint64_t) (HbGPU_Image_Copy_ElementSize(info->format, HbFalse) * mipWidth)) * mipHeight * mipDepth;
+}
+
+uint64_t HbFile_DDS_GetImageDataSize(HbGPU_Image_Info const * info) {
+	uint64_t layerSize = 0;
+	for (uint32_t mip = 0; mip < info->mips; ++mip) {
+		layerSize += HbFile_DDS_GetMipDataSize(info, mip);
+	}
+	uint32_t layerCount = HbGPU_Image_Info_GetArrayLayers(info);
+	if (HbGPU_Image_Dimensions_AreCube(info->dimensions)) {
+		layerCount *= 6;
+	}
+	return layerSize * layerCount;
+}
+
+uint32_t HbFile_DDS_WriteHead(HbGPU_Image_Info const * info, void * head) {
+	HbGPU_Image_Format format = info->format;
+	HbFile_DDS_DXGIFormat dxgiFormat = 0;
+	for (HbFile_DDS_DXGIFormat dxgiFormatIndex = 0; dxgiFormatIndex < HbArrayLength(HbFile_DDS_DXGIFormatsToImageFormats); ++dxgiFormatIndex) {
+		if (HbFile_DDS_DXGIFormatsToImageFormats[dxgiFormatIndex] == format) {
+			dxgiFormat = dxgiFormatIndex;
+			break;
+		}
+	}
+	if (format == HbGPU_Image_Format_Invalid || dxgiFormat == 0) {
+		return 0;
+	}
+	HbFile_DDS_FourCC fourCC = HbFile_DDS_FourCC_DX10;
+	if (!HbGPU_Image_Dimensions_AreArray(info->dimensions) && !HbGPU_Image_Dimensions_Are1D(info->dimensions)) {
+		// The first mapping of the format, which is the non-premultiplied one.
+		for (size_t mappingIndex = 0; mappingIndex < HbArrayLength(HbFile_DDS_FourCCImageFormatMappings); ++mappingIndex) {
+			HbFile_DDS_FourCCImageFormatMapping const * mapping = &HbFile_DDS_FourCCImageFormatMappings[mappingIndex];
+			if (mapping->imageFormat == format) {
+				fourCC = mapping->fourCC;
+				break;
+			}
+		}
+	}
+
+	uint8_t * headBytes = (uint8_t *) head;
+	*((uint32_t *) headBytes) = HbFile_DDS_Magic;
+	HbFile_DDS_Header * header = (HbFile_DDS_Header *) (headBytes + sizeof(uint32_t));
+	memset(header, 0, sizeof(HbFile_DDS_Header));
+	header->structSize = sizeof(HbFile_DDS_Header);
+	header->flags = HbFile_DDS_Flags_Required | HbFile_DDS_Flags_MipMapCount;
+	header->height = info->height;
+	header->width = info->width;
+	header->mipMapCount = info->mips;
+	header->pixelFormat.structSize = sizeof(HbFile_DDS_PixelFormat);
+	header->pixelFormat.flags = HbFile_DDS_PixelFormat_Flags_FourCC;
+	header->pixelFormat.fourCC = fourCC;
+	header->caps = HbFile_DDS_Caps_Texture;
+	if (info->mips > 1) {
+		header->caps |= HbFile_DDS_Caps_Complex | HbFile_DDS_Caps_Mipmap;
+	}
+	if (HbGPU_Image_Format_Is4x4(format)) {
+		header->flags |= HbFile_DDS_Flags_LinearSize;
+		header->pitchOrLinearSize = (uint32_t) HbMinI(HbFile_DDS_GetMipDataSize(info, 0), (uint64_t) UINT32_MAX);
+	}
+	if (info->dimensions == HbGPU_Image_Dimensions_3D) {
+		header->flags |= HbFile_DDS_Flags_Volume;
+		header->depth = info->depthOrLayers;
+		header->caps |= HbFile_DDS_Caps_Complex;
+	}
+	if (HbGPU_Image_Dimensions_AreCube(info->dimensions)) {
+		header->caps |= HbFile_DDS_Caps_Complex;
+		header->caps2 = HbFile_DDS_Caps2_Cubemap | HbFile_DDS_Caps2_CubemapAllFaces;
+	}
+	uint32_t headSize = sizeof(uint32_t) + sizeof(HbFile_DDS_Header);
+	if (fourCC != HbFile_DDS_FourCC_DX10) {
+		return headSize;
+	}
+
+	HbFile_DDS_HeaderDXT10 * headerDXT10 = (HbFile_DDS_HeaderDXT10 *) (headBytes + headSize);
+	memset(headerDXT10, 0, sizeof(HbFile_DDS_HeaderDXT10));
+	headerDXT10->dxgiFormat = dxgiFormat;
+	if (HbGPU_Image_Dimensions_Are1D(info->dimensions)) {
+		headerDXT10->dimension = HbFile_DDS_Dimension_Texture1D;
+	} else if (info->dimensions == HbGPU_Image_Dimensions_3D) {
+		headerDXT10->dimension = HbFile_DDS_Dimension_Texture3D;
+	} else {
+		headerDXT10->dimension = HbFile_DDS_Dimension_Texture2D;
+	}
+	if (HbGPU_Image_Dimensions_AreCube(info->dimensions)) {
+		headerDXT10->miscFlags = HbFile_DDS_MiscFlags_TextureCube;
+	}
+	headerDXT10->arraySize = HbGPU_Image_Info_GetArrayLayers(info);
+	headerDXT10->alphaMode = HbFile_DDS_AlphaMode_Unknown;
+	return headSize + sizeof(HbFile_DDS_HeaderDXT10);
+}
+
+/****************************
+ * Copying to upload buffers
+ ****************************/
+
+HbBool HbFile_DDS_CopyLayout_InitFromHead(HbFile_DDS_CopyLayout * layout, void const * head, size_t headSize, uint64_t fileSize) {
+	HbGPU_Image_Info * info = &layout->info;
+	layout->imageData = NULL;
+	if (!HbFile_DDS_ValidateHeadAndGetInfo(head, headSize, fileSize, info, &layout->imageDataOffset)) {
+		return HbFalse;
+	}
+	layout->layerCount = HbGPU_Image_Info_GetArrayLayers(info);
+	if (HbGPU_Image_Dimensions_AreCube(info->dimensions)) {
+		layout->layerCount *= 6;
+	}
+	uint32_t elementSize = HbGPU_Image_Copy_ElementSize(info->format, HbFalse);
+	HbBool formatIs4x4 = HbGPU_Image_Format_Is4x4(info->format);
+	uint64_t sourceOffset = 0;
+	for (uint32_t mip = 0; mip < info->mips; ++mip) {
+		HbFile_DDS_CopyLayout_Mip * layoutMip = &layout->mips[mip];
+		layoutMip->copySize = HbGPU_Image_Copy_MipLayout(info, HbFalse, mip,
+				&layoutMip->copyRowPitch, &layoutMip->rowCount, &layoutMip->depth);
+		if (layoutMip->copySize == 0) {
+			return HbFalse;
+		}
+		uint32_t mipWidth = info->width;
+		HbGPU_Image_MipSize(mip, info->dimensions, &mipWidth, NULL, NULL);
 		if (formatIs4x4) {
 			mipWidth = (mipWidth + 3) >> 2;
-			mipHeight = (mipHeight + 3) >> 2;
 		}
-		requiredImageDataSize += ((uint64_t) (formatElementSize * mipWidth)) * mipHeight * mipDepth;
+		layoutMip->sourceRowSize = mipWidth * elementSize;
+		layoutMip->sourceOffset = sourceOffset;
+		sourceOffset += (uint64_t) layoutMip->sourceRowSize * layoutMip->rowCount * layoutMip->depth;
+	}
+	layout->sourceLayerSize = sourceOffset;
+	return HbTrue;
+}
+
+HbBool HbFile_DDS_CopyLayout_Init(HbFile_DDS_CopyLayout * layout, void const * dds, size_t ddsSize) {
+	if (!HbFile_DDS_CopyLayout_InitFromHead(layout, dds, ddsSize, ddsSize)) {
+		return HbFalse;
 	}
-	if (HbGPU_Image_Dimensions_AreCube(dimensions)) {
-		requiredImageDataSize *= 6;
+	layout->imageData = (uint8_t const *) dds + layout->imageDataOffset;
+	return HbTrue;
+}
+
+uint32_t HbFile_DDS_CopyLayout_GetCopySize(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount) {
+	uint64_t layerCopySize = 0;
+	for (uint32_t mip = mipFirst; mip < mipFirst + mipCount; ++mip) {
+		layerCopySize += layout->mips[mip].copySize;
 	}
-	if (HbGPU_Image_Dimensions_AreArray(dimensions)) {
-		requiredImageDataSize *= arraySize;
+	uint64_t copySize = layerCopySize * layout->layerCount;
+	return copySize <= UINT32_MAX ? (uint32_t) copySize : 0;
+}
+
+// Source rows are tightly packed. Full 16-byte vectors are stored even for the last bytes of rows
+// as long as they can be read from the source, since the target rows are padded to HbGPU_Image_Copy_RowAlignment.
+static void HbFile_DDSi_CopyRowsNonTemporal(uint8_t * target, uint32_t targetRowPitch,
+		uint8_t const * source, uint32_t rowSize, uint32_t rowCount) {
+	uint8_t const * sourceEnd = source + (size_t) rowSize * rowCount;
+	for (uint32_t rowIndex = 0; rowIndex < rowCount; ++rowIndex) {
+		uint32_t offset = 0;
+		for (; offset < rowSize && (size_t) (sourceEnd - (source + offset)) >= 16; offset += 16) {
+			HbMath_U8x16_StoreAlignedNonTemporal(target + offset, HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) (source + offset)));
+		}
+		if (offset < rowSize) {
+			memcpy(target + offset, source + offset, rowSize - offset);
+		}
+		target += targetRowPitch;
+		source += rowSize;
 	}
-	if (ddsSize < imageDataOffset + requiredImageDataSize) {
-		return NULL;
+}
+
+void HbFile_DDS_CopyLayout_GetLayerSourceRange(HbFile_DDS_CopyLayout const * layout, uint32_t layer, uint32_t mipFirst, uint32_t mipCount,
+		uint64_t * fileOffsetOut, uint64_t * sizeOut) {
+	uint64_t mipFirstOffset = layout->mips[mipFirst].sourceOffset;
+	uint32_t mipEnd = mipFirst + mipCount;
+	*fileOffsetOut = layout->imageDataOffset + layer * layout->sourceLayerSize + mipFirstOffset;
+	*sizeOut = (mipEnd < layout->info.mips ? layout->mips[mipEnd].sourceOffset : layout->sourceLayerSize) - mipFirstOffset;
+}
+
+uint32_t HbFile_DDS_CopyLayout_CopyLayerMips(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount,
+		void const * source, void * target) {
+	uint8_t * targetBytes = (uint8_t *) target;
+	uint8_t const * sourceBytes = (uint8_t const *) source;
+	for (uint32_t mip = mipFirst; mip < mipFirst + mipCount; ++mip) {
+		HbFile_DDS_CopyLayout_Mip const * layoutMip = &layout->mips[mip];
+		uint32_t rowCount = layoutMip->rowCount * layoutMip->depth;
+		// 3D layers are not padded beyond the row alignment, so they can be copied as one set of rows.
+		HbFile_DDSi_CopyRowsNonTemporal(targetBytes, layoutMip->copyRowPitch, sourceBytes, layoutMip->sourceRowSize, rowCount);
+		targetBytes += layoutMip->copySize;
+		sourceBytes += (size_t) layoutMip->sourceRowSize * rowCount;
 	}
-	return (uint8_t const *) dds + imageDataOffset;
+	return (uint32_t) (targetBytes - (uint8_t *) target);
+}
+
+void HbFile_DDS_CopyLayout_CopyMips(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount, void * target) {
+	uint8_t * targetBytes = (uint8_t *) target;
+	for (uint32_t layer = 0; layer < layout->layerCount; ++layer) {
+		uint8_t const * layerSource = layout->imageData + layer * layout->sourceLayerSize;
+		targetBytes += HbFile_DDS_CopyLayout_CopyLayerMips(layout, mipFirst, mipCount,
+				layerSource + layout->mips[mipFirst].sourceOffset, targetBytes);
+	}
+	HbMath_NonTemporalStoreFence();
 }
@@ -1,6 +1,6 @@
 #ifndef HbInclude_HbFile_DDS
 #define HbInclude_HbFile_DDS
-#include "HbGPU.h"
+#include "HbGPU_Image.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -188,6 +188,63 @@ typedef struct HbFile_DDS_HeaderDXT10 {
 
 // dds must be 4-aligned. Returns pointer to the texture data if successful, with byte-aligned rows and slices.
 void const * HbFile_DDS_ValidateAndGetInfo(void const * dds, size_t ddsSize, HbGPU_Image_Info * info);
+// For reading the image data from the file in parts - only the head (HbFile_DDS_MaxHeadSize bytes, or less if the file is smaller)
+// needs to be loaded. fileSize is checked to be enough for the image data.
+#define HbFile_DDS_MaxHeadSize (sizeof(uint32_t) + sizeof(HbFile_DDS_Header) + sizeof(HbFile_DDS_HeaderDXT10))
+HbBool HbFile_DDS_ValidateHeadAndGetInfo(void const * head, size_t headSize, uint64_t fileSize,
+		HbGPU_Image_Info * info, uint32_t * imageDataOffsetOut);
+// Array layers and cube sides are stored one after another, with all the mips of each, and rows and slices are tightly packed.
+uint64_t HbFile_DDS_GetMipDataSize(HbGPU_Image_Info const * info, uint32_t mip); // Of one array layer or cube side.
+uint64_t HbFile_DDS_GetImageDataSize(HbGPU_Image_Info const * info);
+// Writes the magic and the headers (up to HbFile_DDS_MaxHeadSize bytes), with the legacy header only for S3TC UNorm 2D images,
+// cubemaps and 3D images for compatibility with older tools. Returns the size of the head (the offset of the image data),
+// or 0 if the format can't be stored in a DDS file.
+uint32_t HbFile_DDS_WriteHead(HbGPU_Image_Info const * info, void * head);
+
+/*
+ * Copying the image data from a DDS file (usually mapped) to an upload buffer (such as a HbLoad_GPUCopier one),
+ * with rows and slices aligned as required by HbGPU_CmdList_Copy_ImageXBuffer.
+ * The layouts of all mips are calculated once, and any range of mips can be uploaded at once - all of them,
+ * the mip tail, or one mip at a time for streaming.
+ * In the upload buffer, subresources are placed in the same order as in the file - the mips of the range for the first
+ * array layer or cube side, then for the next one, and so on.
+ * The layouts and the copying don't depend on the GPU API or on the OS, so they can be used in tools built for any platform,
+ * while the GPU copy commands are recorded with HbFile_DDS_CopyLayout_RecordCopy from HbLoad.h.
+ */
+
+typedef struct HbFile_DDS_CopyLayout_Mip {
+	uint64_t sourceOffset; // Relative to the data of the array layer or cube side.
+	uint32_t sourceRowSize;
+	uint32_t copyRowPitch;
+	uint32_t rowCount; // Per 3D layer, in blocks for compressed formats.
+	uint32_t depth;
+	uint32_t copySize; // Aligned to HbGPU_Image_Copy_SliceAlignment.
+} HbFile_DDS_CopyLayout_Mip;
+
+typedef struct HbFile_DDS_CopyLayout {
+	HbGPU_Image_Info info; // For creating the image.
+	uint8_t const * imageData; // NULL if initialized from the head.
+	uint32_t imageDataOffset; // In the file.
+	uint64_t sourceLayerSize; // All mips of one array layer or cube side.
+	uint32_t layerCount; // Array layers, multiplied by 6 for cubemaps.
+	HbFile_DDS_CopyLayout_Mip mips[1 << HbGPU_Image_MipCountBits];
+} HbFile_DDS_CopyLayout;
+
+// dds must be 4-aligned and must stay accessible while copying.
+HbBool HbFile_DDS_CopyLayout_Init(HbFile_DDS_CopyLayout * layout, void const * dds, size_t ddsSize);
+// Without the image data - the source ranges are read from the file and copied with CopyLayerMips.
+HbBool HbFile_DDS_CopyLayout_InitFromHead(HbFile_DDS_CopyLayout * layout, void const * head, size_t headSize, uint64_t fileSize);
+// Returns the size of the upload buffer region for mips [mipFirst, mipFirst + mipCount) of all layers, or 0 if it's too large.
+uint32_t HbFile_DDS_CopyLayout_GetCopySize(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount);
+// The target must be aligned to HbGPU_Image_Copy_SliceAlignment (upload buffer mappings are) and have GetCopySize bytes.
+// Non-temporal stores are used since the data is only read by the GPU, and upload memory is often write-combined.
+void HbFile_DDS_CopyLayout_CopyMips(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount, void * target);
+// The mips of one layer are contiguous in the file - reading the range and copying it with CopyLayerMips for every layer
+// (the target advanced by the return value) results in the same data as CopyMips. Doesn't fence the non-temporal stores.
+void HbFile_DDS_CopyLayout_GetLayerSourceRange(HbFile_DDS_CopyLayout const * layout, uint32_t layer, uint32_t mipFirst, uint32_t mipCount,
+		uint64_t * fileOffsetOut, uint64_t * sizeOut);
+uint32_t HbFile_DDS_CopyLayout_CopyLayerMips(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount,
+		void const * source, void * target);
 
 #ifdef __cplusplus
 }
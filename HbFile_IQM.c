@@ -0,0 +1,686 @@
+#include "HbFeedback.h"
+#include "HbFile_IQM.h"
+#include "HbMath.h"
+#include "HbText.h"
+
+char const HbFile_IQM_Magic[16] = "INTERQUAKEMODEL";
+
+/*************
+ * Validation
+ *************/
+
+// Elements must be aligned to their size (up to 4 bytes, the alignment of the file).
+static HbBool HbFile_IQMi_IsRangeValid(uint32_t fileSize, uint32_t offset, uint64_t count, uint32_t elementSize) {
+	if (count == 0) {
+		return HbTrue;
+	}
+	return (offset & (HbMinU32(elementSize, 4) - 1)) == 0 && offset <= fileSize && count <= (fileSize - offset) / elementSize;
+}
+
+static uint32_t HbFile_IQMi_VertexArray_GetFormatSize(uint32_t format) {
+	switch (format) {
+	case HbFile_IQM_VertexArray_Format_Byte:
+	case HbFile_IQM_VertexArray_Format_UByte:
+		return 1;
+	case HbFile_IQM_VertexArray_Format_Short:
+	case HbFile_IQM_VertexArray_Format_UShort:
+	case HbFile_IQM_VertexArray_Format_Half:
+		return 2;
+	case HbFile_IQM_VertexArray_Format_Int:
+	case HbFile_IQM_VertexArray_Format_UInt:
+	case HbFile_IQM_VertexArray_Format_Float:
+		return 4;
+	case HbFile_IQM_VertexArray_Format_Double:
+		return 8;
+	}
+	return 0;
+}
+
+HbBool HbFile_IQM_Model_Init(HbFile_IQM_Model * model, void const * iqm, size_t iqmSize) {
+	if (iqmSize < sizeof(HbFile_IQM_Header)) {
+		return HbFalse;
+	}
+	HbFile_IQM_Header const * header = (HbFile_IQM_Header const *) iqm;
+	if (memcmp(header->magic, HbFile_IQM_Magic, sizeof(HbFile_IQM_Magic)) != 0 || header->version != HbFile_IQM_Version ||
+			header->fileSize < sizeof(HbFile_IQM_Header) || header->fileSize > iqmSize) {
+		return HbFalse;
+	}
+	uint32_t fileSize = header->fileSize;
+	uint8_t const * file = (uint8_t const *) iqm;
+	memset(model, 0, sizeof(HbFile_IQM_Model));
+	model->header = header;
+
+	if (!HbFile_IQMi_IsRangeValid(fileSize, header->textOffset, header->textSize, 1) ||
+			(header->textSize != 0 && file[header->textOffset + header->textSize - 1] != '\0')) {
+		return HbFalse;
+	}
+
+	if (!HbFile_IQMi_IsRangeValid(fileSize, header->meshOffset, header->meshCount, sizeof(HbFile_IQM_Mesh))) {
+		return HbFalse;
+	}
+	model->meshes = (HbFile_IQM_Mesh const *) (file + header->meshOffset);
+	for (uint32_t meshIndex = 0; meshIndex < header->meshCount; ++meshIndex) {
+		HbFile_IQM_Mesh const * mesh = &model->meshes[meshIndex];
+		if (mesh->vertexFirst > header->vertexCount || mesh->vertexCount > header->vertexCount - mesh->vertexFirst ||
+				mesh->triangleFirst > header->triangleCount || mesh->triangleCount > header->triangleCount - mesh->triangleFirst) {
+			return HbFalse;
+		}
+	}
+
+	if (!HbFile_IQMi_IsRangeValid(fileSize, header->vertexArrayOffset, header->vertexArrayCount, sizeof(HbFile_IQM_VertexArray))) {
+		return HbFalse;
+	}
+	model->vertexArrays = (HbFile_IQM_VertexArray const *) (file + header->vertexArrayOffset);
+	for (uint32_t vertexArrayIndex = 0; vertexArrayIndex < header->vertexArrayCount; ++vertexArrayIndex) {
+		HbFile_IQM_VertexArray const * vertexArray = &model->vertexArrays[vertexArrayIndex];
+		uint32_t formatSize = HbFile_IQMi_VertexArray_GetFormatSize(vertexArray->format);
+		if (formatSize == 0 || vertexArray->componentCount == 0 || !HbFile_IQMi_IsRangeValid(fileSize, vertexArray->offset,
+				(uint64_t) header->vertexCount * vertexArray->componentCount, formatSize)) {
+			return HbFalse;
+		}
+		if (vertexArray->type <= HbFile_IQM_VertexArray_Type_Color && model->vertexArraysOfTypes[vertexArray->type] == NULL) {
+			model->vertexArraysOfTypes[vertexArray->type] = vertexArray;
+		}
+	}
+
+	uint64_t triangleIndexCount = (uint64_t) header->triangleCount * 3;
+	if (!HbFile_IQMi_IsRangeValid(fileSize, header->triangleOffset, triangleIndexCount, sizeof(HbFile_IQM_TriangleIndex)) ||
+			(header->adjacencyOffset != 0 &&
+			!HbFile_IQMi_IsRangeValid(fileSize, header->adjacencyOffset, triangleIndexCount, sizeof(HbFile_IQM_TriangleIndex)))) {
+		return HbFalse;
+	}
+	model->triangles = (HbFile_IQM_TriangleIndex const *) (file + header->triangleOffset);
+	for (uint32_t triangleIndex = 0; triangleIndex < (uint32_t) triangleIndexCount; ++triangleIndex) {
+		if (model->triangles[triangleIndex] >= header->vertexCount) {
+			return HbFalse;
+		}
+	}
+
+	if (!HbFile_IQMi_IsRangeValid(fileSize, header->jointOffset, header->jointCount, sizeof(HbFile_IQM_Joint))) {
+		return HbFalse;
+	}
+	model->joints = (HbFile_IQM_Joint const *) (file + header->jointOffset);
+	for (uint32_t jointIndex = 0; jointIndex < header->jointCount; ++jointIndex) {
+		if (model->joints[jointIndex].parent >= (int32_t) jointIndex) {
+			return HbFalse;
+		}
+	}
+
+	if ((header->poseCount != 0 && header->poseCount != header->jointCount) ||
+			!HbFile_IQMi_IsRangeValid(fileSize, header->poseOffset, header->poseCount, sizeof(HbFile_IQM_Pose))) {
+		return HbFalse;
+	}
+	model->poses = (HbFile_IQM_Pose const *) (file + header->poseOffset);
+	uint32_t poseChannelCount = 0;
+	for (uint32_t poseIndex = 0; poseIndex < header->poseCount; ++poseIndex) {
+		HbFile_IQM_Pose const * pose = &model->poses[poseIndex];
+		if (pose->parent >= (int32_t) poseIndex) {
+			return HbFalse;
+		}
+		for (uint32_t channelIndex = 0; channelIndex < 10; ++channelIndex) {
+			poseChannelCount += (pose->channelMask >> channelIndex) & 1;
+		}
+	}
+
+	if (!HbFile_IQMi_IsRangeValid(fileSize, header->animationOffset, header->animationCount, sizeof(HbFile_IQM_Animation))) {
+		return HbFalse;
+	}
+	model->animations = (HbFile_IQM_Animation const *) (file + header->animationOffset);
+	for (uint32_t animationIndex = 0; animationIndex < header->animationCount; ++animationIndex) {
+		HbFile_IQM_Animation const * animation = &model->animations[animationIndex];
+		if (animation->frameFirst > header->frameCount || animation->frameCount > header->frameCount - animation->frameFirst) {
+			return HbFalse;
+		}
+	}
+
+	if ((header->frameCount != 0 && header->frameChannelCount != poseChannelCount) || !HbFile_IQMi_IsRangeValid(fileSize,
+			header->frameOffset, (uint64_t) header->frameCount * header->frameChannelCount, sizeof(HbFile_IQM_Frame))) {
+		return HbFalse;
+	}
+	model->frames = (HbFile_IQM_Frame const *) (file + header->frameOffset);
+	if (header->boundsOffset != 0 && header->frameCount != 0) {
+		if (!HbFile_IQMi_IsRangeValid(fileSize, header->boundsOffset, header->frameCount, sizeof(HbFile_IQM_Bounds))) {
+			return HbFalse;
+		}
+		model->bounds = (HbFile_IQM_Bounds const *) (file + header->boundsOffset);
+	}
+
+	// Extensions are a linked list, only extensionCount of them are followed so cycles don't make it endless.
+	uint32_t extensionOffset = header->extensionOffset;
+	for (uint32_t extensionIndex = 0; extensionIndex < header->extensionCount; ++extensionIndex) {
+		if (extensionOffset == 0 || !HbFile_IQMi_IsRangeValid(fileSize, extensionOffset, 1, sizeof(HbFile_IQM_Extension))) {
+			return HbFalse;
+		}
+		HbFile_IQM_Extension const * extension = (HbFile_IQM_Extension const *) (file + extensionOffset);
+		if (!HbFile_IQMi_IsRangeValid(fileSize, extension->dataOffset, extension->dataSize, 1)) {
+			return HbFalse;
+		}
+		extensionOffset = extension->nextOffset;
+	}
+
+	return HbTrue;
+}
+
+char const * HbFile_IQM_Model_GetText(HbFile_IQM_Model const * model, uint32_t offset) {
+	HbFile_IQM_Header const * header = model->header;
+	if (offset >= header->textSize) {
+		return "";
+	}
+	return (char const *) header + header->textOffset + offset;
+}
+
+void const * HbFile_IQM_Model_FindExtension(HbFile_IQM_Model const * model, char const * name, uint32_t * dataSize) {
+	HbFile_IQM_Header const * header = model->header;
+	uint32_t extensionOffset = header->extensionOffset;
+	for (uint32_t extensionIndex = 0; extensionIndex < header->extensionCount; ++extensionIndex) {
+		HbFile_IQM_Extension const * extension = (HbFile_IQM_Extension const *) ((uint8_t const *) header + extensionOffset);
+		if (HbTextA_Compare(HbFile_IQM_Model_GetText(model, extension->name), name) == 0) {
+			*dataSize = extension->dataSize;
+			return (uint8_t const *) header + extension->dataOffset;
+		}
+		extensionOffset = extension->nextOffset;
+	}
+	*dataSize = 0;
+	return NULL;
+}
+
+/*********************************
+ * Vertex array format conversion
+ *********************************/
+
+static uint32_t HbFile_IQMi_Vertex_GetFormatComponentCount(HbGPU_Vertex_Format format) {
+	switch (format) {
+	case HbGPU_Vertex_Format_Float_32x1:
+	case HbGPU_Vertex_Format_UInt_32x1:
+	case HbGPU_Vertex_Format_SInt_32x1:
+		return 1;
+	case HbGPU_Vertex_Format_Float_32x2:
+	case HbGPU_Vertex_Format_Float_16x2:
+	case HbGPU_Vertex_Format_UNorm_16x2:
+	case HbGPU_Vertex_Format_SNorm_16x2:
+	case HbGPU_Vertex_Format_UInt_32x2:
+	case HbGPU_Vertex_Format_UInt_16x2:
+	case HbGPU_Vertex_Format_SInt_32x2:
+	case HbGPU_Vertex_Format_SInt_16x2:
+		return 2;
+	case HbGPU_Vertex_Format_Float_32x3:
+	case HbGPU_Vertex_Format_Float_11_11_10:
+	case HbGPU_Vertex_Format_UInt_32x3:
+	case HbGPU_Vertex_Format_SInt_32x3:
+		return 3;
+	default:
+		return 4;
+	}
+}
+
+static uint32_t HbFile_IQMi_Vertex_GetFormatSize(HbGPU_Vertex_Format format) {
+	switch (format) {
+	case HbGPU_Vertex_Format_Float_32x1:
+	case HbGPU_Vertex_Format_Float_16x2:
+	case HbGPU_Vertex_Format_Float_11_11_10:
+	case HbGPU_Vertex_Format_UNorm_16x2:
+	case HbGPU_Vertex_Format_UNorm_10_10_10_2:
+	case HbGPU_Vertex_Format_UNorm_8x4:
+	case HbGPU_Vertex_Format_SNorm_16x2:
+	case HbGPU_Vertex_Format_SNorm_8x4:
+	case HbGPU_Vertex_Format_UInt_32x1:
+	case HbGPU_Vertex_Format_UInt_16x2:
+	case HbGPU_Vertex_Format_UInt_10_10_10_2:
+	case HbGPU_Vertex_Format_UInt_8x4:
+	case HbGPU_Vertex_Format_SInt_32x1:
+	case HbGPU_Vertex_Format_SInt_16x2:
+	case HbGPU_Vertex_Format_SInt_8x4:
+		return 4;
+	case HbGPU_Vertex_Format_Float_32x2:
+	case HbGPU_Vertex_Format_Float_16x4:
+	case HbGPU_Vertex_Format_UNorm_16x4:
+	case HbGPU_Vertex_Format_SNorm_16x4:
+	case HbGPU_Vertex_Format_UInt_32x2:
+	case HbGPU_Vertex_Format_UInt_16x4:
+	case HbGPU_Vertex_Format_SInt_32x2:
+	case HbGPU_Vertex_Format_SInt_16x4:
+		return 8;
+	case HbGPU_Vertex_Format_Float_32x3:
+	case HbGPU_Vertex_Format_UInt_32x3:
+	case HbGPU_Vertex_Format_SInt_32x3:
+		return 12;
+	default:
+		return 16;
+	}
+}
+
+static HbBool HbFile_IQMi_Vertex_IsFormatInteger(HbGPU_Vertex_Format format) {
+	return format >= HbGPU_Vertex_Format_UInt_32x1;
+}
+
+HbBool HbFile_IQM_CanConvertVertexArray(HbFile_IQM_VertexArray const * vertexArray, HbGPU_Vertex_Semantic semantic, HbGPU_Vertex_Format format) {
+	if (format == HbGPU_Vertex_Format_Float_11_11_10) {
+		return HbFalse;
+	}
+	if (HbFile_IQMi_Vertex_IsFormatInteger(format) && vertexArray->format > HbFile_IQM_VertexArray_Format_UInt) {
+		return HbFalse;
+	}
+	// Octahedral encoding has no space for the bitangent sign.
+	if (semantic == HbGPU_Vertex_Semantic_Tangent && HbFile_IQMi_Vertex_GetFormatComponentCount(format) == 2) {
+		return HbFalse;
+	}
+	return HbTrue;
+}
+
+// Loads up to 4 components, with the missing ones taken from defaults. Integers are normalized if needed, and loaded as is otherwise.
+static HbMath_F32x4 HbFile_IQMi_LoadVertex(uint8_t const * source, uint32_t format, uint32_t componentCount, HbBool normalize,
+		HbMath_F32x4 defaults) {
+	if (componentCount == 4) {
+		// Fast paths for the common formats.
+		if (format == HbFile_IQM_VertexArray_Format_Float) {
+			return HbMath_F32x4_LoadUnaligned((float const *) source);
+		}
+		if (format == HbFile_IQM_VertexArray_Format_UByte) {
+			uint32_t packed;
+			memcpy(&packed, source, sizeof(uint32_t));
+			HbMath_U8x16 zero = HbMath_U8x16_LoadZero();
+			HbMath_F32x4 values = HbMath_S32x4_ConvertToF32x4(HbMath_U16x8_InterleaveLower(
+					HbMath_U8x16_InterleaveLower(HbMath_S32x4_LoadReplicated((int32_t) packed), zero), zero));
+			return normalize ? HbMath_F32x4_Multiply(values, HbMath_F32x4_LoadReplicated(1.0f / 255.0f)) : values;
+		}
+	}
+	HbMath_VecAligned float values[4];
+	HbMath_F32x4_StoreAligned(values, defaults);
+	for (uint32_t componentIndex = 0; componentIndex < componentCount; ++componentIndex) {
+		float value = 0.0f;
+		switch (format) {
+		case HbFile_IQM_VertexArray_Format_Byte:
+			value = (float) ((int8_t const *) source)[componentIndex];
+			if (normalize) {
+				value = fmaxf(value * (1.0f / 127.0f), -1.0f);
+			}
+			break;
+		case HbFile_IQM_VertexArray_Format_UByte:
+			value = (float) source[componentIndex];
+			if (normalize) {
+				value *= 1.0f / 255.0f;
+			}
+			break;
+		case HbFile_IQM_VertexArray_Format_Short:
+			value = (float) ((int16_t const *) source)[componentIndex];
+			if (normalize) {
+				value = fmaxf(value * (1.0f / 32767.0f), -1.0f);
+			}
+			break;
+		case HbFile_IQM_VertexArray_Format_UShort:
+			value = (float) ((uint16_t const *) source)[componentIndex];
+			if (normalize) {
+				value *= 1.0f / 65535.0f;
+			}
+			break;
+		case HbFile_IQM_VertexArray_Format_Int:
+			value = (float) ((int32_t const *) source)[componentIndex];
+			if (normalize) {
+				value = fmaxf((float) ((double) value * (1.0 / 2147483647.0)), -1.0f);
+			}
+			break;
+		case HbFile_IQM_VertexArray_Format_UInt:
+			value = (float) ((uint32_t const *) source)[componentIndex];
+			if (normalize) {
+				value = (float) ((double) value * (1.0 / 4294967295.0));
+			}
+			break;
+		case HbFile_IQM_VertexArray_Format_Half:
+			{
+				uint32_t half = ((uint16_t const *) source)[componentIndex];
+				uint32_t exponent = (half >> 10) & 31, mantissa = half & 1023;
+				if (exponent == 31) {
+					value = mantissa != 0 ? NAN : INFINITY;
+				} else if (exponent != 0) {
+					value = ldexpf((float) (mantissa | 1024), (int32_t) exponent - 25);
+				} else {
+					value = ldexpf((float) mantissa, -24);
+				}
+				if (half & 0x8000) {
+					value = -value;
+				}
+			}
+			break;
+		case HbFile_IQM_VertexArray_Format_Float:
+			value = ((float const *) source)[componentIndex];
+			break;
+		case HbFile_IQM_VertexArray_Format_Double:
+			{
+				double valueDouble;
+				memcpy(&valueDouble, source + componentIndex * sizeof(double), sizeof(double));
+				value = (float) valueDouble;
+			}
+			break;
+		}
+		values[componentIndex] = value;
+	}
+	return HbMath_F32x4_LoadAligned(values);
+}
+
+static HbMath_F32x4 HbFile_IQMi_EncodeOctahedral(HbMath_F32x4 normal) {
+	HbMath_VecAligned float xyzw[4];
+	HbMath_F32x4_StoreAligned(xyzw, normal);
+	float x = xyzw[0], y = xyzw[1], z = xyzw[2];
+	float lengthL1 = fabsf(x) + fabsf(y) + fabsf(z);
+	if (lengthL1 > 0.0f) {
+		x /= lengthL1;
+		y /= lengthL1;
+	}
+	if (z < 0.0f) {
+		// Folding the lower hemisphere over the diagonals.
+		float foldedX = (1.0f - fabsf(y)) * (x >= 0.0f ? 1.0f : -1.0f);
+		y = (1.0f - fabsf(x)) * (y >= 0.0f ? 1.0f : -1.0f);
+		x = foldedX;
+	}
+	return HbMath_F32x4_LoadXYZW(x, y, 0.0f, 0.0f);
+}
+
+static void HbFile_IQMi_StoreVertexNormalized(HbMath_F32x4 values, HbGPU_Vertex_Format format, uint8_t * target) {
+	HbMath_F32x4 zero = HbMath_F32x4_LoadZero(), one = HbMath_F32x4_LoadReplicated(1.0f);
+	HbMath_S32x4 packed;
+	switch (format) {
+	case HbGPU_Vertex_Format_Float_32x1:
+	case HbGPU_Vertex_Format_Float_32x2:
+	case HbGPU_Vertex_Format_Float_32x3:
+	case HbGPU_Vertex_Format_Float_32x4:
+		{
+			HbMath_VecAligned float floats[4];
+			HbMath_F32x4_StoreAligned(floats, values);
+			memcpy(target, floats, HbFile_IQMi_Vertex_GetFormatSize(format));
+		}
+		return;
+	case HbGPU_Vertex_Format_Float_16x2:
+	case HbGPU_Vertex_Format_Float_16x4:
+		{
+			HbMath_S32x4 halves = HbMath_F32x4_ConvertToF16x4(values);
+			packed = HbMath_S32x4_PackToS16x8(halves, halves);
+		}
+		break;
+	case HbGPU_Vertex_Format_UNorm_16x2:
+	case HbGPU_Vertex_Format_UNorm_16x4:
+		// No unsigned saturation of 32-bit values in SSE2, but the range is shifted to signed and back.
+		values = HbMath_F32x4_Multiply(HbMath_F32x4_Min(HbMath_F32x4_Max(values, zero), one), HbMath_F32x4_LoadReplicated(65535.0f));
+		packed = HbMath_F32x4_ConvertToS32x4(HbMath_F32x4_Add(values, HbMath_F32x4_LoadReplicated(0.5f - 32768.0f)));
+		packed = HbMath_S32x4_Xor(HbMath_S32x4_PackToS16x8(packed, packed), HbMath_S32x4_LoadReplicated((int32_t) 0x80008000u));
+		break;
+	case HbGPU_Vertex_Format_SNorm_16x2:
+	case HbGPU_Vertex_Format_SNorm_16x4:
+	case HbGPU_Vertex_Format_SNorm_8x4:
+		{
+			float scale = format == HbGPU_Vertex_Format_SNorm_8x4 ? 127.0f : 32767.0f;
+			values = HbMath_F32x4_Min(HbMath_F32x4_Max(values, HbMath_F32x4_Negate(one)), one);
+			packed = HbMath_F32x4_ConvertToS32x4(HbMath_F32x4_RoundToNearest(HbMath_F32x4_Multiply(values, HbMath_F32x4_LoadReplicated(scale))));
+			packed = HbMath_S32x4_PackToS16x8(packed, packed);
+			if (format == HbGPU_Vertex_Format_SNorm_8x4) {
+				packed = HbMath_S16x8_PackToS8x16(packed, packed);
+			}
+		}
+		break;
+	case HbGPU_Vertex_Format_UNorm_8x4:
+		values = HbMath_F32x4_Multiply(HbMath_F32x4_Min(HbMath_F32x4_Max(values, zero), one), HbMath_F32x4_LoadReplicated(255.0f));
+		packed = HbMath_F32x4_ConvertToS32x4(HbMath_F32x4_Add(values, HbMath_F32x4_LoadReplicated(0.5f)));
+		packed = HbMath_S32x4_PackToS16x8(packed, packed);
+		packed = HbMath_U16x8_PackToU8x16(packed, packed);
+		break;
+	case HbGPU_Vertex_Format_UNorm_10_10_10_2:
+		{
+			values = HbMath_F32x4_Multiply(HbMath_F32x4_Min(HbMath_F32x4_Max(values, zero), one), HbMath_F32x4_LoadXYZW(1023.0f, 1023.0f, 1023.0f, 3.0f));
+			HbMath_VecAligned int32_t components[4];
+			HbMath_S32x4_StoreAligned((HbMath_S32x4 *) components,
+					HbMath_F32x4_ConvertToS32x4(HbMath_F32x4_Add(values, HbMath_F32x4_LoadReplicated(0.5f))));
+			uint32_t packed1010102 = (uint32_t) components[0] | ((uint32_t) components[1] << 10) |
+					((uint32_t) components[2] << 20) | ((uint32_t) components[3] << 30);
+			memcpy(target, &packed1010102, sizeof(uint32_t));
+		}
+		return;
+	default:
+		return;
+	}
+	HbMath_VecAligned uint8_t packedBytes[16];
+	HbMath_S32x4_StoreAligned((HbMath_S32x4 *) packedBytes, packed);
+	memcpy(target, packedBytes, HbFile_IQMi_Vertex_GetFormatSize(format));
+}
+
+static void HbFile_IQMi_StoreVertexInteger(uint8_t const * source, uint32_t sourceFormat, uint32_t sourceComponentCount,
+		HbGPU_Vertex_Format format, uint8_t * target) {
+	int64_t components[4] = { 0, 0, 0, 1 };
+	for (uint32_t componentIndex = 0; componentIndex < HbMinU32(sourceComponentCount, 4); ++componentIndex) {
+		switch (sourceFormat) {
+		case HbFile_IQM_VertexArray_Format_Byte:
+			components[componentIndex] = ((int8_t const *) source)[componentIndex];
+			break;
+		case HbFile_IQM_VertexArray_Format_UByte:
+			components[componentIndex] = source[componentIndex];
+			break;
+		case HbFile_IQM_VertexArray_Format_Short:
+			components[componentIndex] = ((int16_t const *) source)[componentIndex];
+			break;
+		case HbFile_IQM_VertexArray_Format_UShort:
+			components[componentIndex] = ((uint16_t const *) source)[componentIndex];
+			break;
+		case HbFile_IQM_VertexArray_Format_Int:
+			components[componentIndex] = ((int32_t const *) source)[componentIndex];
+			break;
+		case HbFile_IQM_VertexArray_Format_UInt:
+			components[componentIndex] = ((uint32_t const *) source)[componentIndex];
+			break;
+		}
+	}
+	int64_t low, high;
+	uint32_t componentSize;
+	switch (format) {
+	case HbGPU_Vertex_Format_UInt_10_10_10_2:
+		{
+			uint32_t packed = 0;
+			for (uint32_t componentIndex = 0; componentIndex < 4; ++componentIndex) {
+				int64_t componentMax = componentIndex == 3 ? 3 : 1023;
+				packed |= (uint32_t) HbClampI(components[componentIndex], 0, componentMax) << (componentIndex * 10);
+			}
+			memcpy(target, &packed, sizeof(uint32_t));
+		}
+		return;
+	case HbGPU_Vertex_Format_UInt_8x4:
+		low = 0;
+		high = UINT8_MAX;
+		componentSize = 1;
+		break;
+	case HbGPU_Vertex_Format_SInt_8x4:
+		low = INT8_MIN;
+		high = INT8_MAX;
+		componentSize = 1;
+		break;
+	case HbGPU_Vertex_Format_UInt_16x2:
+	case HbGPU_Vertex_Format_UInt_16x4:
+		low = 0;
+		high = UINT16_MAX;
+		componentSize = 2;
+		break;
+	case HbGPU_Vertex_Format_SInt_16x2:
+	case HbGPU_Vertex_Format_SInt_16x4:
+		low = INT16_MIN;
+		high = INT16_MAX;
+		componentSize = 2;
+		break;
+	case HbGPU_Vertex_Format_UInt_32x1:
+	case HbGPU_Vertex_Format_UInt_32x2:
+	case HbGPU_Vertex_Format_UInt_32x3:
+	case HbGPU_Vertex_Format_UInt_32x4:
+		low = 0;
+		high = UINT32_MAX;
+		componentSize = 4;
+		break;
+	default:
+		low = INT32_MIN;
+		high = INT32_MAX;
+		componentSize = 4;
+		break;
+	}
+	uint32_t componentCount = HbFile_IQMi_Vertex_GetFormatComponentCount(format);
+	for (uint32_t componentIndex = 0; componentIndex < componentCount; ++componentIndex) {
+		// Little-endian - the lower bytes of the clamped value.
+		uint32_t component = (uint32_t) HbClampI(components[componentIndex], low, high);
+		memcpy(target + componentIndex * componentSize, &component, componentSize);
+	}
+}
+
+/*****************
+ * Vertex streams
+ *****************/
+
+typedef struct HbFile_IQMi_StreamAttribute {
+	HbMath_F32x4 defaults;
+	uint8_t const * source; // NULL if not taken from the file.
+	uint32_t sourceStride;
+	uint32_t sourceFormat;
+	uint32_t sourceComponentCount;
+	HbGPU_Vertex_Semantic semantic;
+	HbGPU_Vertex_Format format;
+	uint32_t offset;
+} HbFile_IQMi_StreamAttribute;
+
+HbGPU_Vertex_SemanticBits HbFile_IQM_Model_WriteVertexes(HbFile_IQM_Model const * model, uint32_t vertexFirst, uint32_t vertexCount,
+		HbGPU_Vertex_Attribute const * attributes, uint32_t attributeCount, uint32_t streamIndex, HbGPU_Vertex_Stream const * stream,
+		void * target) {
+	uint32_t stride = stream->strideInDwords * sizeof(uint32_t);
+	if (stream->strideInDwords > HbFile_IQM_WriteVertexes_MaxStrideInDwords) {
+		HbFeedback_Crash("HbFile_IQM_Model_WriteVertexes", "The stride is %u dwords, but the maximum is %u.",
+				stream->strideInDwords, HbFile_IQM_WriteVertexes_MaxStrideInDwords);
+	}
+	HbGPU_Vertex_SemanticBits semanticsFromFile = 0;
+
+	HbFile_IQMi_StreamAttribute streamAttributes[HbFile_IQM_WriteVertexes_MaxStrideInDwords];
+	uint32_t streamAttributeCount = 0;
+	for (uint32_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex) {
+		HbGPU_Vertex_Attribute const * attribute = &attributes[attributeIndex];
+		if (attribute->streamIndex != streamIndex) {
+			continue;
+		}
+		if ((attribute->offsetInDwords * sizeof(uint32_t)) + HbFile_IQMi_Vertex_GetFormatSize(attribute->format) > stride ||
+				streamAttributeCount >= HbArrayLength(streamAttributes)) {
+			HbFeedback_Crash("HbFile_IQM_Model_WriteVertexes", "Attribute %u is outside the stride of the stream.", attributeIndex);
+		}
+		HbFile_IQMi_StreamAttribute * streamAttribute = &streamAttributes[streamAttributeCount++];
+		streamAttribute->semantic = attribute->semantic;
+		streamAttribute->format = attribute->format;
+		streamAttribute->offset = attribute->offsetInDwords * sizeof(uint32_t);
+		int32_t type = -1;
+		switch (attribute->semantic) {
+		case HbGPU_Vertex_Semantic_Position:
+			type = HbFile_IQM_VertexArray_Type_Position;
+			streamAttribute->defaults = HbMath_F32x4_LoadXYZW(0.0f, 0.0f, 0.0f, 1.0f);
+			break;
+		case HbGPU_Vertex_Semantic_Normal:
+			type = HbFile_IQM_VertexArray_Type_Normal;
+			streamAttribute->defaults = HbMath_F32x4_LoadXYZW(0.0f, 0.0f, 1.0f, 1.0f);
+			break;
+		case HbGPU_Vertex_Semantic_Tangent:
+			type = HbFile_IQM_VertexArray_Type_Tangent;
+			streamAttribute->defaults = HbMath_F32x4_LoadXYZW(1.0f, 0.0f, 0.0f, 1.0f);
+			break;
+		case HbGPU_Vertex_Semantic_TexCoord:
+			type = HbFile_IQM_VertexArray_Type_TexCoord;
+			streamAttribute->defaults = HbMath_F32x4_LoadXYZW(0.0f, 0.0f, 0.0f, 1.0f);
+			break;
+		case HbGPU_Vertex_Semantic_Color:
+			type = HbFile_IQM_VertexArray_Type_Color;
+			streamAttribute->defaults = HbMath_F32x4_LoadReplicated(1.0f);
+			break;
+		case HbGPU_Vertex_Semantic_BlendIndexes:
+			type = HbFile_IQM_VertexArray_Type_BlendIndexes;
+			streamAttribute->defaults = HbMath_F32x4_LoadXYZW(0.0f, 0.0f, 0.0f, 1.0f);
+			break;
+		case HbGPU_Vertex_Semantic_BlendWeights:
+			type = HbFile_IQM_VertexArray_Type_BlendWeights;
+			streamAttribute->defaults = HbMath_F32x4_LoadXYZW(1.0f, 0.0f, 0.0f, 0.0f);
+			break;
+		default:
+			streamAttribute->defaults = HbMath_F32x4_LoadXYZW(0.0f, 0.0f, 0.0f, 1.0f);
+			break;
+		}
+		HbFile_IQM_VertexArray const * vertexArray = NULL;
+		if (type >= 0 && attribute->semanticIndex == 0) {
+			vertexArray = model->vertexArraysOfTypes[type];
+		}
+		streamAttribute->source = NULL;
+		if (vertexArray != NULL && HbFile_IQM_CanConvertVertexArray(vertexArray, attribute->semantic, attribute->format)) {
+			streamAttribute->sourceStride = HbFile_IQMi_VertexArray_GetFormatSize(vertexArray->format) * vertexArray->componentCount;
+			streamAttribute->source = (uint8_t const *) model->header + vertexArray->offset + vertexFirst * streamAttribute->sourceStride;
+			streamAttribute->sourceFormat = vertexArray->format;
+			streamAttribute->sourceComponentCount = HbMinU32(vertexArray->componentCount, 4);
+			semanticsFromFile |= (HbGPU_Vertex_SemanticBits) 1 << attribute->semantic;
+		}
+	}
+
+	// Building every vertex on the stack and copying it at once, so the target is written sequentially without gaps.
+	HbMath_VecAligned uint32_t vertex[HbFile_IQM_WriteVertexes_MaxStrideInDwords];
+	memset(vertex, 0, stride);
+	uint8_t * targetVertex = (uint8_t *) target;
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		for (uint32_t streamAttributeIndex = 0; streamAttributeIndex < streamAttributeCount; ++streamAttributeIndex) {
+			HbFile_IQMi_StreamAttribute const * streamAttribute = &streamAttributes[streamAttributeIndex];
+			uint8_t * attributeTarget = (uint8_t *) vertex + streamAttribute->offset;
+			uint8_t const * attributeSource = streamAttribute->source;
+			if (attributeSource != NULL) {
+				attributeSource += vertexIndex * streamAttribute->sourceStride;
+			}
+			if (HbFile_IQMi_Vertex_IsFormatInteger(streamAttribute->format)) {
+				if (attributeSource != NULL) {
+					HbFile_IQMi_StoreVertexInteger(attributeSource, streamAttribute->sourceFormat, streamAttribute->sourceComponentCount,
+							streamAttribute->format, attributeTarget);
+				} else {
+					// Defaults - 0 with 1 in W.
+					HbFile_IQMi_StoreVertexInteger(NULL, HbFile_IQM_VertexArray_Format_UByte, 0, streamAttribute->format, attributeTarget);
+				}
+				continue;
+			}
+			HbMath_F32x4 values = streamAttribute->defaults;
+			if (attributeSource != NULL) {
+				values = HbFile_IQMi_LoadVertex(attributeSource, streamAttribute->sourceFormat, streamAttribute->sourceComponentCount,
+						HbTrue, values);
+			}
+			if (streamAttribute->semantic == HbGPU_Vertex_Semantic_Normal || streamAttribute->semantic == HbGPU_Vertex_Semantic_Tangent) {
+				if (HbFile_IQMi_Vertex_GetFormatComponentCount(streamAttribute->format) == 2) {
+					values = HbFile_IQMi_EncodeOctahedral(values);
+				}
+				if (streamAttribute->format >= HbGPU_Vertex_Format_UNorm_16x2 && streamAttribute->format <= HbGPU_Vertex_Format_UNorm_8x4) {
+					HbMath_F32x4 half = HbMath_F32x4_LoadReplicated(0.5f);
+					values = HbMath_F32x4_MultiplyAdd(half, values, half);
+				}
+			}
+			HbFile_IQMi_StoreVertexNormalized(values, streamAttribute->format, attributeTarget);
+		}
+		memcpy(targetVertex, vertex, stride);
+		targetVertex += stride;
+	}
+
+	return semanticsFromFile;
+}
+
+/**********
+ * Indexes
+ **********/
+
+HbBool HbFile_IQM_Model_WriteIndexes(HbFile_IQM_Model const * model, uint32_t triangleFirst, uint32_t triangleCount, uint32_t vertexBase,
+		HbGPU_Vertex_Index * target) {
+	HbFile_IQM_TriangleIndex const * source = model->triangles + (size_t) triangleFirst * 3;
+	uint32_t indexCount = triangleCount * 3;
+	// Rebasing and checking 4 indexes at once, converting with signed saturation by moving the range of 16-bit values to signed.
+	HbMath_U32x4 base = HbMath_U32x4_LoadReplicated(vertexBase), maxIndex = HbMath_U32x4_LoadReplicated(UINT16_MAX);
+	HbMath_U32x4 signedBias = HbMath_U32x4_LoadReplicated(0x8000), outOfRange = HbMath_U32x4_LoadZero();
+	uint32_t indexIndex = 0;
+	for (; indexIndex + 4 <= indexCount; indexIndex += 4) {
+		HbMath_U32x4 indexes = HbMath_U32x4_Subtract(HbMath_U32x4_LoadUnaligned((HbMath_U32x4 const *) (source + indexIndex)), base);
+		outOfRange = HbMath_U32x4_Or(outOfRange, HbMath_U32x4_CompareGreater(indexes, maxIndex));
+		indexes = HbMath_U32x4_Subtract(indexes, signedBias);
+		indexes = HbMath_S32x4_PackToS16x8(indexes, indexes);
+		indexes = HbMath_U32x4_Xor(indexes, HbMath_U32x4_LoadReplicated(0x80008000u));
+		HbMath_U8x16_StoreLower64(target + indexIndex, indexes);
+	}
+	HbBool valid = HbMath_U32x4_SignBits(outOfRange) == 0;
+	for (; indexIndex < indexCount; ++indexIndex) {
+		uint32_t index = source[indexIndex] - vertexBase;
+		valid &= index <= UINT16_MAX;
+		target[indexIndex] = (HbGPU_Vertex_Index) index;
+	}
+	return valid;
+}
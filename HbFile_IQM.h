@@ -1,6 +1,6 @@
 #ifndef HbInclude_HbFile_IQM
 #define HbInclude_HbFile_IQM
-#include "HbCommon.h"
+#include "HbGPU_Vertex.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -79,14 +79,14 @@ typedef struct HbFile_IQM_Joint {
 typedef struct HbFile_IQM_Pose {
 	int32_t parent; // Parent < 0 means this is a root bone.
 	uint32_t channelMask; // Mask of which of the 10 channels are present for this joint pose.
-    float channeloffset[10], channelscale[10]; 
-    // Channels 0..2 are translation <Tx, Ty, Tz> and channels 3..6 are quaternion rotation <Qx, Qy, Qz, Qw>.
-    // Rotation is in relative/parent local space.
-    // Channels 7..9 are scale <Sx, Sy, Sz>.
-    // Output = (input * scale) * rotation + translation.
+	float channelOffset[10], channelScale[10];
+	// Channels 0..2 are translation <Tx, Ty, Tz> and channels 3..6 are quaternion rotation <Qx, Qy, Qz, Qw>.
+	// Rotation is in relative/parent local space.
+	// Channels 7..9 are scale <Sx, Sy, Sz>.
+	// Output = (input * scale) * rotation + translation.
 } HbFile_IQM_Pose;
 
-uint16_t HbFile_IQM_Frame;
+typedef uint16_t HbFile_IQM_Frame; // Value = channelOffset + frame * channelScale, for the channels in channelMask.
 
 typedef uint32_t HbFile_IQM_Animation_Flags;
 enum {
@@ -111,6 +111,56 @@ typedef struct HbFile_IQM_Extension {
 	uint32_t nextOffset;
 } HbFile_IQM_Extension;
 
+/*
+ * Reading of IQM files in place - the file (usually mapped) must stay accessible while the model is used.
+ * All offsets, counts and indexes are validated when the model is initialized, so the data can be used without bounds checking.
+ */
+
+typedef struct HbFile_IQM_Model {
+	HbFile_IQM_Header const * header;
+	HbFile_IQM_Mesh const * meshes;
+	HbFile_IQM_VertexArray const * vertexArrays;
+	// The first vertex array of each known type, or NULL if there's none.
+	HbFile_IQM_VertexArray const * vertexArraysOfTypes[HbFile_IQM_VertexArray_Type_Color + 1];
+	HbFile_IQM_TriangleIndex const * triangles; // 3 per triangle.
+	HbFile_IQM_Joint const * joints; // Parents are before children.
+	HbFile_IQM_Pose const * poses; // Either none or one for every joint.
+	HbFile_IQM_Animation const * animations;
+	HbFile_IQM_Frame const * frames; // frameChannelCount per frame, matching the channel masks of the poses.
+	HbFile_IQM_Bounds const * bounds; // One for every frame, or NULL.
+} HbFile_IQM_Model;
+
+// iqm must be 4-aligned.
+HbBool HbFile_IQM_Model_Init(HbFile_IQM_Model * model, void const * iqm, size_t iqmSize);
+// Returns an empty string for offsets outside the text.
+char const * HbFile_IQM_Model_GetText(HbFile_IQM_Model const * model, uint32_t offset);
+// Returns the data of the first extension with the name, or NULL if there's none. The data may be unaligned.
+void const * HbFile_IQM_Model_FindExtension(HbFile_IQM_Model const * model, char const * name, uint32_t * dataSize);
+
+/*
+ * Conversion of vertex arrays to interleaved GPU vertex streams, with the values loaded as 4 floats and stored in the attribute format:
+ * - Integer arrays are normalized (like colors and blend weights) unless stored in an integer format, which requires an integer array.
+ * - Normals and tangents are biased in UNorm formats (bitangent sign in W of tangents), normals in 2-component formats are octahedral.
+ * - Values are rounded to nearest (even for floats) and clamped to the range of normalized formats, floats too large for the format
+ *   become infinity.
+ * Float_11_11_10 is not supported.
+ */
+
+HbBool HbFile_IQM_CanConvertVertexArray(HbFile_IQM_VertexArray const * vertexArray, HbGPU_Vertex_Semantic semantic, HbGPU_Vertex_Format format);
+// Writes vertexCount vertexes starting from vertexFirst (such as those of a mesh) for the attributes in streamIndex, with the stride
+// of the stream, whole vertexes at once in order (so the target may be write-combined upload memory).
+// Attributes with semantic index 0 are taken from the vertex arrays of the corresponding types, others and those that can't be
+// converted get defaults - 0 with 1 in W, 1 for colors, (1, 0, 0, 0) for blend weights, +Z for normals and +X for tangents.
+// Returns the semantics taken from the file.
+#define HbFile_IQM_WriteVertexes_MaxStrideInDwords 64
+HbGPU_Vertex_SemanticBits HbFile_IQM_Model_WriteVertexes(HbFile_IQM_Model const * model, uint32_t vertexFirst, uint32_t vertexCount,
+		HbGPU_Vertex_Attribute const * attributes, uint32_t attributeCount, uint32_t streamIndex, HbGPU_Vertex_Stream const * stream,
+		void * target);
+// Writes the indexes of the vertexes of the triangles relative to vertexBase (such as the first vertex of the mesh).
+// Returns HbFalse if any of them doesn't fit in HbGPU_Vertex_Index.
+HbBool HbFile_IQM_Model_WriteIndexes(HbFile_IQM_Model const * model, uint32_t triangleFirst, uint32_t triangleCount, uint32_t vertexBase,
+		HbGPU_Vertex_Index * target);
+
 #ifdef __cplusplus
 }
 #endif
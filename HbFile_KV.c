@@ -1,14 +1,18 @@
+#include "HbBit.h"
 #include "HbFeedback.h"
 #include "HbFile_KV.h"
+#include "HbHash.h"
+#include "HbMath.h"
 
 void HbFile_KV_Read_Init(HbFile_KV_Read_Context * context, void const * data, size_t size, HbBool useEscapeSequences) {
 	uint32_t bomSize = HbText_ClassifyUnicodeStream(data, size, &context->isU16, &context->u16NonNativeEndian);
-	context->data.u8 = (uint8_t const *) data + bomSize;
+	context->data.u8 = (HbTextU8 const *) data + bomSize;
 	context->size = HbMinSize(size - bomSize, SIZE_MAX >> 1); // 1 bit used for the quoted flag.
 	if (context->isU16) {
 		context->size &= ~(sizeof(HbTextU16) - 1);
 	}
 	context->useEscapeSequences = useEscapeSequences;
+	context->syntaxError = HbFalse;
 	context->sectionDepth = 0;
 	context->keyString.quoted = HbFalse;
 	context->keyString.position = context->size;
@@ -17,6 +21,30 @@ void HbFile_KV_Read_Init(HbFile_KV_Read_Context * context, void const * data, si
 	context->readResumePosition = 0;
 }
 
+size_t HbFile_KV_Read_GetU8BufferSize(void const * data, size_t size) {
+	HbBool isU16, u16NonNativeEndian;
+	uint32_t bomSize = HbText_ClassifyUnicodeStream(data, size, &isU16, &u16NonNativeEndian);
+	if (!isU16) {
+		return 0;
+	}
+	return HbMaxSize(HbTextU8_MaxElemsFromU16((size - bomSize) / sizeof(HbTextU16)), 1);
+}
+
+void HbFile_KV_Read_InitU8(HbFile_KV_Read_Context * context, void const * data, size_t size, HbBool useEscapeSequences, HbTextU8 * u8Buffer) {
+	HbFile_KV_Read_Init(context, data, size, useEscapeSequences);
+	if (!context->isU16) {
+		return;
+	}
+	size_t u16Elems = context->size / sizeof(HbTextU16);
+	size_t u8Size = HbTextU8_FromU16Sized(u8Buffer, HbTextU8_MaxElemsFromU16(u16Elems), context->data.u16, u16Elems, context->u16NonNativeEndian);
+	context->data.u8 = u8Buffer;
+	context->size = HbMinSize(u8Size, SIZE_MAX >> 1);
+	context->isU16 = HbFalse;
+	context->u16NonNativeEndian = HbFalse;
+	context->keyString.position = context->size;
+	context->valueString.position = context->size;
+}
+
 static HbTextU32 HbFile_KV_Read_GetCharacter(HbFile_KV_Read_Context const * context, size_t positionBytes, uint32_t * bytesToNext) {
 	if (positionBytes >= context->size) {
 		if (bytesToNext != NULL) {
@@ -59,6 +87,69 @@ static HbTextU32 HbFile_KV_Read_GetCharacter(HbFile_KV_Read_Context const * cont
 	return character;
 }
 
+/*
+ * Vectorized skipping of runs of UTF-8 bytes that don't need decoding - ASCII characters that are taken as they are.
+ * The scalar path is used only around characters that may be special, or are not ASCII, and in the last 15 bytes of the file.
+ * UTF-16 files always go through the scalar path.
+ */
+
+typedef enum HbFile_KV_Read_PlainRun {
+	HbFile_KV_Read_PlainRun_Separators, // Whitespace between tokens.
+	HbFile_KV_Read_PlainRun_Comment, // Anything until the end of the line (non-ASCII too, as line breaks can't be inside UTF-8 sequences).
+	HbFile_KV_Read_PlainRun_QuotedString, // Not ", \\ (even without escape sequences), \r (\r\n is returned as \n).
+	HbFile_KV_Read_PlainRun_UnquotedString, // Not whitespace, ", { or }.
+} HbFile_KV_Read_PlainRun;
+
+// Returns the position of the first byte that needs to be handled by the scalar path.
+HbForceInline size_t HbFile_KV_Read_SkipPlainRun(HbFile_KV_Read_Context const * context, size_t position, HbFile_KV_Read_PlainRun run) {
+	if (context->isU16) {
+		return position;
+	}
+	HbTextU8 const * data = context->data.u8;
+	size_t size = context->size;
+	while (position < size && size - position >= sizeof(HbMath_U8x16)) {
+		HbMath_U8x16 bytes = HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) (data + position));
+		HbMath_U8x16 special;
+		switch (run) {
+		case HbFile_KV_Read_PlainRun_Separators:
+			// Anything other than ' ' and '\t' to '\r' stops skipping.
+			special = HbMath_U8x16_Or(HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated(' ')), HbMath_U8x16_CompareLessEqual(
+					HbMath_U8x16_Subtract(bytes, HbMath_U8x16_LoadReplicated('\t')), HbMath_U8x16_LoadReplicated('\r' - '\t')));
+			special = HbMath_U8x16_CompareEqual(special, HbMath_U8x16_LoadZero());
+			break;
+		case HbFile_KV_Read_PlainRun_Comment:
+			special = HbMath_U8x16_Or(HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('\n')),
+					HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('\r')));
+			special = HbMath_U8x16_Or(special, HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadZero()));
+			break;
+		case HbFile_KV_Read_PlainRun_QuotedString:
+			// '\0' and non-ASCII.
+			special = HbMath_U8x16_CompareLessSigned(bytes, HbMath_U8x16_LoadReplicated(1));
+			special = HbMath_U8x16_Or(special, HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('"')));
+			special = HbMath_U8x16_Or(special, HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('\\')));
+			special = HbMath_U8x16_Or(special, HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('\r')));
+			break;
+		default:
+			// Whitespace, control characters and non-ASCII.
+			special = HbMath_U8x16_CompareLessSigned(bytes, HbMath_U8x16_LoadReplicated(' ' + 1));
+			special = HbMath_U8x16_Or(special, HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('"')));
+			special = HbMath_U8x16_Or(special, HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('{')));
+			special = HbMath_U8x16_Or(special, HbMath_U8x16_CompareEqual(bytes, HbMath_U8x16_LoadReplicated('}')));
+			break;
+		}
+		uint32_t specialBits = (uint32_t) HbMath_U8x16_SignBits(special);
+		if (specialBits != 0) {
+			return position + (uint32_t) HbBit_LowestOneU32(specialBits);
+		}
+		position += sizeof(HbMath_U8x16);
+	}
+	return position;
+}
+
+HbForceInline HbFile_KV_Read_PlainRun HbFile_KV_Read_GetStringPlainRun(HbFile_KV_Read_String const * kvString) {
+	return kvString->quoted ? HbFile_KV_Read_PlainRun_QuotedString : HbFile_KV_Read_PlainRun_UnquotedString;
+}
+
 HbTextU32 HbFile_KV_Read_GetStringCharacter(HbFile_KV_Read_Context const * context,
 		HbFile_KV_Read_String const * kvString, size_t offset, uint32_t * bytesToNext) {
 	offset += kvString->position;
@@ -99,9 +190,16 @@ HbTextU32 HbFile_KV_Read_GetStringCharacter(HbFile_KV_Read_Context const * conte
 
 size_t HbFile_KV_Read_StringLengthU8Elems(HbFile_KV_Read_Context const * context, HbFile_KV_Read_String const * kvString) {
 	size_t offset = 0, elems = 0;
+	HbFile_KV_Read_PlainRun plainRun = HbFile_KV_Read_GetStringPlainRun(kvString);
 	HbTextU32 character;
 	uint32_t bytesToNext;
-	while ((character = HbFile_KV_Read_GetStringCharacter(context, kvString, offset, &bytesToNext)) != '\0') {
+	for (;;) {
+		size_t plainEnd = HbFile_KV_Read_SkipPlainRun(context, kvString->position + offset, plainRun) - kvString->position;
+		elems += plainEnd - offset;
+		offset = plainEnd;
+		if ((character = HbFile_KV_Read_GetStringCharacter(context, kvString, offset, &bytesToNext)) == '\0') {
+			break;
+		}
 		offset += bytesToNext;
 		elems += HbTextU8_CharElemCount(character);
 	}
@@ -114,9 +212,22 @@ size_t HbFile_KV_Read_CopyStringU8(HbFile_KV_Read_Context const * context, HbFil
 	size_t sourceOffset = 0;
 	if (targetBufferSizeElems != 0) {
 		--targetBufferSizeElems;
+		HbFile_KV_Read_PlainRun plainRun = HbFile_KV_Read_GetStringPlainRun(kvString);
 		HbTextU32 character;
 		uint32_t bytesToNext;
-		while (targetBufferSizeElems != 0 && (character = HbFile_KV_Read_GetStringCharacter(context, kvString, sourceOffset, &bytesToNext)) != '\0') {
+		while (targetBufferSizeElems != 0) {
+			size_t plainSize = HbFile_KV_Read_SkipPlainRun(context, kvString->position + sourceOffset, plainRun) - (kvString->position + sourceOffset);
+			if (plainSize != 0) {
+				plainSize = HbMinSize(plainSize, targetBufferSizeElems);
+				memcpy(target, context->data.u8 + kvString->position + sourceOffset, plainSize);
+				sourceOffset += plainSize;
+				target += plainSize;
+				targetBufferSizeElems -= plainSize;
+				continue;
+			}
+			if ((character = HbFile_KV_Read_GetStringCharacter(context, kvString, sourceOffset, &bytesToNext)) == '\0') {
+				break;
+			}
 			sourceOffset += bytesToNext;
 			uint32_t written = HbTextU8_WriteValidChar(target, targetBufferSizeElems, character);
 			if (written == 0) {
@@ -147,11 +258,40 @@ HbBool HbFile_KV_Read_StringEqualsCaselessA(HbFile_KV_Read_Context const * conte
 	}
 }
 
+uint32_t HbFile_KV_Read_StringHashCaseless(HbFile_KV_Read_Context const * context, HbFile_KV_Read_String const * kvString) {
+	uint32_t hash = HbHash_FNV1a_Basis;
+	size_t offset = 0;
+	HbFile_KV_Read_PlainRun plainRun = HbFile_KV_Read_GetStringPlainRun(kvString);
+	HbTextU32 character;
+	uint32_t bytesToNext;
+	for (;;) {
+		size_t plainEnd = HbFile_KV_Read_SkipPlainRun(context, kvString->position + offset, plainRun) - kvString->position;
+		for (; offset < plainEnd; ++offset) {
+			hash = HbHash_FNV1a_HashByte(hash, (uint8_t) HbTextA_CharToLower(context->data.u8[kvString->position + offset]));
+		}
+		if ((character = HbFile_KV_Read_GetStringCharacter(context, kvString, offset, &bytesToNext)) == '\0') {
+			break;
+		}
+		offset += bytesToNext;
+		HbTextU8 characterU8[HbTextU8_MaxCharElems];
+		uint32_t characterU8Elems = HbTextU8_WriteValidChar(characterU8, HbArrayLength(characterU8), HbTextU32_ASCIICharToLower(character));
+		for (uint32_t elemIndex = 0; elemIndex < characterU8Elems; ++elemIndex) {
+			hash = HbHash_FNV1a_HashByte(hash, (uint8_t) characterU8[elemIndex]);
+		}
+	}
+	return hash;
+}
+
 static void HbFile_KV_Read_SkipSeparators(HbFile_KV_Read_Context * context) {
 	HbTextU32 character;
 	uint32_t characterSize;
 	HbBool inComment = HbFalse;
-	while ((character = HbFile_KV_Read_GetCharacter(context, context->readResumePosition, &characterSize)) != '\0') {
+	for (;;) {
+		context->readResumePosition = HbFile_KV_Read_SkipPlainRun(context, context->readResumePosition,
+				inComment ? HbFile_KV_Read_PlainRun_Comment : HbFile_KV_Read_PlainRun_Separators);
+		if ((character = HbFile_KV_Read_GetCharacter(context, context->readResumePosition, &characterSize)) == '\0') {
+			break;
+		}
 		if (inComment) {
 			if (character == '\r' || character == '\n') {
 				inComment = HbFalse;
@@ -173,6 +313,19 @@ static void HbFile_KV_Read_SkipSeparators(HbFile_KV_Read_Context * context) {
 	}
 }
 
+// Moves the read position to the end of the string (to the closing quote if it's quoted).
+static void HbFile_KV_Read_SkipString(HbFile_KV_Read_Context * context, HbFile_KV_Read_String const * kvString) {
+	HbFile_KV_Read_PlainRun plainRun = HbFile_KV_Read_GetStringPlainRun(kvString);
+	uint32_t bytesToNext;
+	for (;;) {
+		context->readResumePosition = HbFile_KV_Read_SkipPlainRun(context, context->readResumePosition, plainRun);
+		if (HbFile_KV_Read_GetStringCharacter(context, kvString, context->readResumePosition - kvString->position, &bytesToNext) == '\0') {
+			break;
+		}
+		context->readResumePosition += bytesToNext;
+	}
+}
+
 HbFile_KV_Read_TokenType HbFile_KV_Read_Parse(HbFile_KV_Read_Context * context) {
 	// Clear the token state.
 	context->keyString.quoted = HbFalse;
@@ -190,12 +343,14 @@ HbFile_KV_Read_TokenType HbFile_KV_Read_Parse(HbFile_KV_Read_Context * context)
 	if (character == '{') {
 		// Section without a key - corrupt file.
 		context->readResumePosition = context->size;
+		context->syntaxError = HbTrue;
 		return HbFile_KV_Read_TokenType_End;
 	}
 	if (character == '}') {
 		if (context->sectionDepth == 0) {
 			// Unbalanced sections - corrupt file.
 			context->readResumePosition = context->size;
+			context->syntaxError = HbTrue;
 			return HbFile_KV_Read_TokenType_End;
 		}
 		context->readResumePosition += bytesToNext;
@@ -208,15 +363,13 @@ HbFile_KV_Read_TokenType HbFile_KV_Read_Parse(HbFile_KV_Read_Context * context)
 		context->readResumePosition += bytesToNext;
 	}
 	keyString.position = context->readResumePosition;
-	while ((character = HbFile_KV_Read_GetStringCharacter(
-			context, &keyString, context->readResumePosition - keyString.position, &bytesToNext)) != '\0') {
-		context->readResumePosition += bytesToNext;
-	}
+	HbFile_KV_Read_SkipString(context, &keyString);
 	if (keyString.quoted) {
 		character = HbFile_KV_Read_GetCharacter(context, context->readResumePosition, &bytesToNext);
 		if (character != '"') {
 			// Unclosed quoted string - corrupt file.
 			context->readResumePosition = context->size;
+			context->syntaxError = HbTrue;
 			return HbFile_KV_Read_TokenType_End;
 		}
 		context->readResumePosition += bytesToNext;
@@ -226,6 +379,8 @@ HbFile_KV_Read_TokenType HbFile_KV_Read_Parse(HbFile_KV_Read_Context * context)
 	HbFile_KV_Read_SkipSeparators(context);
 	character = HbFile_KV_Read_GetCharacter(context, context->readResumePosition, &bytesToNext);
 	if (character == '\0') {
+		// Key without a value - corrupt file.
+		context->syntaxError = HbTrue;
 		return HbFile_KV_Read_TokenType_End;
 	}
 	if (character == '{') {
@@ -240,15 +395,13 @@ HbFile_KV_Read_TokenType HbFile_KV_Read_Parse(HbFile_KV_Read_Context * context)
 		context->readResumePosition += bytesToNext;
 	}
 	valueString.position = context->readResumePosition;
-	while ((character = HbFile_KV_Read_GetStringCharacter(
-			context, &valueString, context->readResumePosition - valueString.position, &bytesToNext)) != '\0') {
-		context->readResumePosition += bytesToNext;
-	}
+	HbFile_KV_Read_SkipString(context, &valueString);
 	if (valueString.quoted) {
 		character = HbFile_KV_Read_GetCharacter(context, context->readResumePosition, &bytesToNext);
 		if (character != '"') {
 			// Unclosed quoted string - corrupt file.
 			context->readResumePosition = context->size;
+			context->syntaxError = HbTrue;
 			return HbFile_KV_Read_TokenType_End;
 		}
 		context->readResumePosition += bytesToNext;
@@ -1,6 +1,8 @@
 #ifndef HbInclude_HbFile_KV
 #define HbInclude_HbFile_KV
+#include "HbMemory.h"
 #include "HbText.h"
+#include "HbText_Intern.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -22,6 +24,7 @@ typedef struct HbFile_KV_Read_Context {
 	HbBool u16NonNativeEndian;
 	HbBool useEscapeSequences;
 	// Mutable part.
+	HbBool syntaxError; // Set when HbFile_KV_Read_Parse returns an end token because the file is corrupt, not because it has ended.
 	uint32_t sectionDepth; // 0 when no { has been reached yet. Can't go below 0, } without an { will result in an "end" token.
 	HbFile_KV_Read_String keyString; // Key or section name.
 	HbFile_KV_Read_String valueString;
@@ -31,6 +34,11 @@ typedef struct HbFile_KV_Read_Context {
 
 // Input must be 2-aligned (may be UTF-16).
 void HbFile_KV_Read_Init(HbFile_KV_Read_Context * context, void const * data, size_t size, HbBool useEscapeSequences);
+// UTF-16 input can be converted to UTF-8 once while initializing instead of decoding it in every operation.
+// HbFile_KV_Read_GetU8BufferSize returns the size of the buffer needed for that, or 0 if the input is UTF-8 and is read in place,
+// in which case u8Buffer may be NULL. The buffer must stay alive while the context is used.
+size_t HbFile_KV_Read_GetU8BufferSize(void const * data, size_t size);
+void HbFile_KV_Read_InitU8(HbFile_KV_Read_Context * context, void const * data, size_t size, HbBool useEscapeSequences, HbTextU8 * u8Buffer);
 
 HbTextU32 HbFile_KV_Read_GetStringCharacter(HbFile_KV_Read_Context const * context,
 		HbFile_KV_Read_String const * kvString, size_t offset, uint32_t * bytesToNext);
@@ -61,6 +69,9 @@ HbForceInline HbBool HbFile_KV_Read_ValueEqualsCaselessA(HbFile_KV_Read_Context
 	return HbFile_KV_Read_StringEqualsCaselessA(context, &context->valueString, compareString);
 }
 
+// Same as HbHash_FNV1a_HashTextACaseless of the string converted to UTF-8.
+uint32_t HbFile_KV_Read_StringHashCaseless(HbFile_KV_Read_Context const * context, HbFile_KV_Read_String const * kvString);
+
 typedef enum HbFile_KV_Read_TokenType {
 	HbFile_KV_Read_TokenType_End, // End of the file or syntax error.
 	HbFile_KV_Read_TokenType_KeyValue, // key value.
@@ -69,6 +80,181 @@ typedef enum HbFile_KV_Read_TokenType {
 } HbFile_KV_Read_TokenType;
 HbFile_KV_Read_TokenType HbFile_KV_Read_Parse(HbFile_KV_Read_Context * context);
 
+/***********************************************
+ * Document - the whole file parsed into a tree
+ ***********************************************/
+
+// Strings are not copied - nodes refer to the source data, which must stay alive while the document is used, via the reading context.
+// UTF-16 files are converted to UTF-8 once, though, and the strings refer to the converted copy.
+// The converted copy, the nodes and the child lookup hash map are stored in a single allocation.
+// Children are looked up by the caseless hash of the key combined with the index of the parent, in a hash map shared by the whole document.
+
+#define HbFile_KV_Doc_InvalidNode UINT32_MAX
+#define HbFile_KV_Doc_RootNode 0 // A section without a key containing the top-level nodes.
+
+typedef struct HbFile_KV_Doc_Node {
+	HbFile_KV_Read_String key;
+	HbFile_KV_Read_String value; // Empty for sections.
+	uint32_t keyHash; // HbFile_KV_Read_StringHashCaseless of the key.
+	uint32_t parent;
+	uint32_t nextSibling;
+	uint32_t firstChild;
+	uint32_t childCount : 31;
+	uint32_t isSection : 1;
+} HbFile_KV_Doc_Node;
+
+typedef struct HbFile_KV_Doc {
+	HbFile_KV_Read_Context context; // Only for accessing the strings.
+	void * allocation; // From the tag - UTF-16 input converted to UTF-8 (if needed), the nodes and the hash map.
+	HbFile_KV_Doc_Node * nodes; // nodeCount elements.
+	uint32_t * hashMap; // hashMapIndexMask + 1 indexes of nodes, or HbFile_KV_Doc_InvalidNode for free slots.
+	uint32_t nodeCount; // Including the root.
+	uint32_t hashMapIndexMask;
+} HbFile_KV_Doc;
+
+// The hash in the child lookup map.
+HbForceInline uint32_t HbFile_KV_Doc_GetChildHash(uint32_t keyHash, uint32_t parentIndex) {
+	return keyHash ^ (parentIndex * 0x9E3779B1u);
+}
+
+// Returns false if the file has syntax errors or unclosed sections, or if there are too many nodes.
+HbBool HbFile_KV_Doc_Init(HbFile_KV_Doc * doc, void const * data, size_t size, HbBool useEscapeSequences, HbMemory_Tag * tag);
+void HbFile_KV_Doc_Destroy(HbFile_KV_Doc * doc);
+
+HbForceInline HbFile_KV_Doc_Node const * HbFile_KV_Doc_GetNode(HbFile_KV_Doc const * doc, uint32_t nodeIndex) {
+	return &doc->nodes[nodeIndex];
+}
+HbForceInline HbBool HbFile_KV_Doc_KeyEqualsCaselessA(HbFile_KV_Doc const * doc, uint32_t nodeIndex, char const * compareString) {
+	return HbFile_KV_Read_StringEqualsCaselessA(&doc->context, &doc->nodes[nodeIndex].key, compareString);
+}
+HbForceInline HbBool HbFile_KV_Doc_ValueEqualsCaselessA(HbFile_KV_Doc const * doc, uint32_t nodeIndex, char const * compareString) {
+	return HbFile_KV_Read_StringEqualsCaselessA(&doc->context, &doc->nodes[nodeIndex].value, compareString);
+}
+HbForceInline size_t HbFile_KV_Doc_CopyValueU8(HbFile_KV_Doc const * doc, uint32_t nodeIndex, HbTextU8 * target, size_t targetBufferSizeElems) {
+	return HbFile_KV_Read_CopyStringU8(&doc->context, &doc->nodes[nodeIndex].value, target, targetBufferSizeElems);
+}
+
+// Keys may repeat within a section - FindChild returns the first child with the key, and FindNextSibling the next one with the same key.
+// All lookups return the node index or HbFile_KV_Doc_InvalidNode.
+uint32_t HbFile_KV_Doc_FindChild(HbFile_KV_Doc const * doc, uint32_t parentIndex, char const * key);
+uint32_t HbFile_KV_Doc_FindNextSibling(HbFile_KV_Doc const * doc, uint32_t nodeIndex);
+// Keys separated by /, such as material/$basetexture, so keys containing / can't be looked up with this.
+uint32_t HbFile_KV_Doc_FindPath(HbFile_KV_Doc const * doc, uint32_t parentIndex, char const * path);
+
+/**********************************************************************
+ * Binary compiled format - a document that can be used in place as is
+ **********************************************************************/
+
+/*
+ * The tree is stored with the children of every section in a contiguous range, in breadth-first order, so the parent always precedes
+ * the children. Keys and values are converted to UTF-8 (with escape sequences already applied) and interned - identical strings are stored
+ * once. The child lookup hash map is the same as in HbFile_KV_Doc, so no hashing of keys is needed when loading.
+ * Must be 16-aligned in memory - can be stored as an HbPack item.
+ *
+ * Overall structure:
+ * - HbFile_KV_Binary_Header.
+ * - HbFile_KV_Binary_Node[node count], the first one is the root section.
+ * - uint32_t hash map with HbHash_MapUtil_GetNeededEntriesLog2(node count - 1) bits of the index, if there are more nodes than the root.
+ * - Zero-terminated UTF-8 strings.
+ */
+
+extern char const HbFile_KV_Binary_HeaderID[8];
+
+typedef struct HbAligned(16) HbFile_KV_Binary_Header {
+	char id[8]; // HbFile_KV_Binary_HeaderID.
+	uint32_t nodeCount; // Including the root.
+	uint32_t stringsOffset;
+	uint32_t stringsSize;
+	uint32_t reserved[3]; // Must be zero.
+} HbFile_KV_Binary_Header;
+
+#define HbFile_KV_Binary_NoValue UINT32_MAX // Value string offset of sections.
+
+typedef struct HbFile_KV_Binary_Node {
+	uint32_t keyOffset; // Relative to stringsOffset.
+	uint32_t valueOffset; // HbFile_KV_Binary_NoValue for sections.
+	uint32_t keyHash; // HbHash_FNV1a_HashTextACaseless of the key.
+	uint32_t parent; // HbFile_KV_Doc_InvalidNode for the root.
+	uint32_t firstChild;
+	uint32_t childCount;
+} HbFile_KV_Binary_Node;
+
+// Returns a 16-aligned compiled document allocated from the tag, or NULL if it would be larger than 4 GB.
+void * HbFile_KV_Binary_Compile(HbFile_KV_Doc const * doc, HbMemory_Tag * tag, uint32_t * size);
+
+typedef struct HbFile_KV_Binary_Info {
+	HbFile_KV_Binary_Node const * nodes;
+	uint32_t const * hashMap; // NULL if only the root is present.
+	char const * strings;
+	uint32_t nodeCount;
+	uint32_t hashMapIndexMask;
+	uint32_t stringsSize;
+} HbFile_KV_Binary_Info;
+
+// validate must be true for untrusted data - the structure of the tree, string offsets and hash map indexes will be checked,
+// otherwise, only the header is checked.
+HbBool HbFile_KV_Binary_GetInfo(void const * data, uint32_t size, HbFile_KV_Binary_Info * info, HbBool validate);
+
+HbForceInline HbBool HbFile_KV_Binary_IsSection(HbFile_KV_Binary_Info const * info, uint32_t nodeIndex) {
+	return info->nodes[nodeIndex].valueOffset == HbFile_KV_Binary_NoValue;
+}
+HbForceInline char const * HbFile_KV_Binary_GetKey(HbFile_KV_Binary_Info const * info, uint32_t nodeIndex) {
+	return info->strings + info->nodes[nodeIndex].keyOffset;
+}
+// Empty string for sections.
+HbForceInline char const * HbFile_KV_Binary_GetValue(HbFile_KV_Binary_Info const * info, uint32_t nodeIndex) {
+	uint32_t valueOffset = info->nodes[nodeIndex].valueOffset;
+	return valueOffset != HbFile_KV_Binary_NoValue ? info->strings + valueOffset : "";
+}
+
+// Same as the HbFile_KV_Doc lookups.
+uint32_t HbFile_KV_Binary_FindChild(HbFile_KV_Binary_Info const * info, uint32_t parentIndex, char const * key);
+uint32_t HbFile_KV_Binary_FindNextSibling(HbFile_KV_Binary_Info const * info, uint32_t nodeIndex);
+uint32_t HbFile_KV_Binary_FindPath(HbFile_KV_Binary_Info const * info, uint32_t parentIndex, char const * path);
+
+/************************************************************************
+ * Batch parsing - many files on multiple threads, with interned strings
+ ************************************************************************/
+
+// Keys and values of all the files are added to one HbText_Intern table, so the source data isn't needed after parsing,
+// and strings can be compared as ids (caselessly via caselessID of the entries) rather than decoded again.
+// Nodes are in the same order as in HbFile_KV_Doc, with the root section at HbFile_KV_Doc_RootNode.
+
+#define HbFile_KV_Batch_MaxThreads 16
+
+typedef struct HbFile_KV_Batch_Node {
+	uint32_t key; // Interned id.
+	uint32_t keyCaseless; // caselessID of the key.
+	uint32_t value; // Interned id, or HbText_Intern_InvalidID for sections.
+	uint32_t parent;
+	uint32_t nextSibling;
+	uint32_t firstChild;
+} HbFile_KV_Batch_Node;
+
+typedef struct HbFile_KV_Batch_File {
+	// Input, the data must be 2-aligned (may be UTF-16).
+	void const * data;
+	size_t size;
+	HbBool useEscapeSequences;
+	// Output - allocated from the tag, NULL if the file has syntax errors or unclosed sections, or if the intern table is full.
+	HbFile_KV_Batch_Node * nodes;
+	uint32_t nodeCount; // Including the root.
+} HbFile_KV_Batch_File;
+
+// Files are distributed between the threads dynamically, the calling thread parses files too.
+// Returns whether all the files have been parsed successfully.
+HbBool HbFile_KV_Batch_Parse(HbFile_KV_Batch_File * files, uint32_t fileCount,
+		HbText_Intern * intern, uint32_t threadCount, HbMemory_Tag * tag);
+void HbFile_KV_Batch_DestroyFile(HbFile_KV_Batch_File * file);
+
+HbForceInline HbBool HbFile_KV_Batch_IsSection(HbFile_KV_Batch_File const * file, uint32_t nodeIndex) {
+	return file->nodes[nodeIndex].value == HbText_Intern_InvalidID;
+}
+// keyCaseless is from HbText_Intern_FindCaseless - if it's HbText_Intern_InvalidID, no file contains the key.
+// Both return the node index or HbFile_KV_Doc_InvalidNode.
+uint32_t HbFile_KV_Batch_FindChild(HbFile_KV_Batch_File const * file, uint32_t parentIndex, uint32_t keyCaseless);
+uint32_t HbFile_KV_Batch_FindNextSibling(HbFile_KV_Batch_File const * file, uint32_t nodeIndex);
+
 #ifdef __cplusplus
 }
 #endif
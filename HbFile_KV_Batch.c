@@ -0,0 +1,190 @@
+#include "HbAtomic.h"
+#include "HbFile_KV.h"
+
+typedef struct HbFile_KV_Batchi_Shared {
+	HbFile_KV_Batch_File * files;
+	uint32_t fileCount;
+	uint32_t volatile filesTaken;
+	HbText_Intern * intern;
+	HbMemory_Tag * tag;
+} HbFile_KV_Batchi_Shared;
+
+typedef struct HbFile_KV_Batchi_Worker {
+	HbFile_KV_Batchi_Shared * shared;
+	// Strings converted to UTF-8 before interning, reused between files.
+	HbTextU8 * stringBuffer;
+	size_t stringBufferSize;
+	// UTF-16 files converted to UTF-8 as a whole.
+	HbTextU8 * u8Buffer;
+	size_t u8BufferSize;
+} HbFile_KV_Batchi_Worker;
+
+static uint32_t HbFile_KV_Batchi_InternString(HbFile_KV_Batchi_Worker * worker,
+		HbFile_KV_Read_Context const * context, HbFile_KV_Read_String const * kvString) {
+	size_t length = HbFile_KV_Read_StringLengthU8Elems(context, kvString);
+	if (length + 1 > worker->stringBufferSize) {
+		size_t stringBufferSize = HbMaxSize(length + 1, HbMaxSize(worker->stringBufferSize * 2, 256));
+		HbMemory_Free(worker->stringBuffer);
+		worker->stringBuffer = HbMemory_Alloc(worker->shared->tag, stringBufferSize, HbFalse);
+		worker->stringBufferSize = stringBufferSize;
+	}
+	length = HbFile_KV_Read_CopyStringU8(context, kvString, worker->stringBuffer, worker->stringBufferSize);
+	return HbText_Intern_Add(worker->shared->intern, worker->stringBuffer, length);
+}
+
+static HbBool HbFile_KV_Batchi_ParseFile(HbFile_KV_Batchi_Worker * worker, HbFile_KV_Batch_File * file) {
+	HbMemory_Tag * tag = worker->shared->tag;
+	HbText_Intern * intern = worker->shared->intern;
+	size_t u8BufferSize = HbFile_KV_Read_GetU8BufferSize(file->data, file->size);
+	if (u8BufferSize > worker->u8BufferSize) {
+		HbMemory_Free(worker->u8Buffer);
+		worker->u8Buffer = HbMemory_Alloc(tag, u8BufferSize, HbFalse);
+		worker->u8BufferSize = u8BufferSize;
+	}
+	HbFile_KV_Read_Context context;
+	HbFile_KV_Read_InitU8(&context, file->data, file->size, file->useEscapeSequences, worker->u8Buffer);
+
+	// Nodes are appended in a single pass, growing 2x, to avoid tokenizing the file twice.
+	uint32_t nodeCapacity = 64;
+	HbFile_KV_Batch_Node * nodes = HbMemory_Alloc(tag, nodeCapacity * sizeof(HbFile_KV_Batch_Node), HbFalse);
+	HbFile_KV_Batch_Node * root = &nodes[HbFile_KV_Doc_RootNode];
+	root->key = root->keyCaseless = HbText_Intern_Add(intern, "", 0);
+	root->value = HbText_Intern_InvalidID;
+	root->parent = root->nextSibling = root->firstChild = HbFile_KV_Doc_InvalidNode;
+	uint32_t nodeCount = HbFile_KV_Doc_RootNode + 1;
+	uint32_t sectionIndex = HbFile_KV_Doc_RootNode, previousSiblingIndex = HbFile_KV_Doc_InvalidNode;
+	HbBool succeeded = (root->key != HbText_Intern_InvalidID);
+
+	HbFile_KV_Read_TokenType tokenType;
+	while (succeeded && (tokenType = HbFile_KV_Read_Parse(&context)) != HbFile_KV_Read_TokenType_End) {
+		if (tokenType == HbFile_KV_Read_TokenType_SectionEnd) {
+			previousSiblingIndex = sectionIndex;
+			sectionIndex = nodes[sectionIndex].parent;
+			continue;
+		}
+		if (nodeCount == nodeCapacity) {
+			if (nodeCapacity > HbFile_KV_Doc_InvalidNode / 2) {
+				succeeded = HbFalse;
+				break;
+			}
+			nodeCapacity *= 2;
+			HbMemory_Realloc((void * *) &nodes, (size_t) nodeCapacity * sizeof(HbFile_KV_Batch_Node));
+		}
+		uint32_t nodeIndex = nodeCount++;
+		HbFile_KV_Batch_Node * node = &nodes[nodeIndex];
+		node->key = HbFile_KV_Batchi_InternString(worker, &context, &context.keyString);
+		if (node->key == HbText_Intern_InvalidID) {
+			succeeded = HbFalse;
+			break;
+		}
+		node->keyCaseless = HbText_Intern_Get(intern, node->key)->caselessID;
+		if (tokenType == HbFile_KV_Read_TokenType_SectionStart) {
+			node->value = HbText_Intern_InvalidID;
+		} else {
+			node->value = HbFile_KV_Batchi_InternString(worker, &context, &context.valueString);
+			if (node->value == HbText_Intern_InvalidID) {
+				succeeded = HbFalse;
+				break;
+			}
+		}
+		node->parent = sectionIndex;
+		node->nextSibling = node->firstChild = HbFile_KV_Doc_InvalidNode;
+		if (previousSiblingIndex != HbFile_KV_Doc_InvalidNode) {
+			nodes[previousSiblingIndex].nextSibling = nodeIndex;
+		} else {
+			nodes[sectionIndex].firstChild = nodeIndex;
+		}
+		if (tokenType == HbFile_KV_Read_TokenType_SectionStart) {
+			sectionIndex = nodeIndex;
+			previousSiblingIndex = HbFile_KV_Doc_InvalidNode;
+		} else {
+			previousSiblingIndex = nodeIndex;
+		}
+	}
+	if (!succeeded || context.syntaxError || context.sectionDepth != 0) {
+		HbMemory_Free(nodes);
+		file->nodes = NULL;
+		file->nodeCount = 0;
+		return HbFalse;
+	}
+	file->nodes = nodes;
+	file->nodeCount = nodeCount;
+	return HbTrue;
+}
+
+static void HbFile_KV_Batchi_RunWorker(void * data) {
+	HbFile_KV_Batchi_Worker * worker = (HbFile_KV_Batchi_Worker *) data;
+	HbFile_KV_Batchi_Shared * shared = worker->shared;
+	// Files may differ in size a lot, so they're taken one by one rather than split into ranges in advance.
+	uint32_t fileIndex;
+	while ((fileIndex = HbAtomic_IncrementU32(&shared->filesTaken) - 1) < shared->fileCount) {
+		HbFile_KV_Batchi_ParseFile(worker, &shared->files[fileIndex]);
+	}
+}
+
+HbBool HbFile_KV_Batch_Parse(HbFile_KV_Batch_File * files, uint32_t fileCount,
+		HbText_Intern * intern, uint32_t threadCount, HbMemory_Tag * tag) {
+	HbFile_KV_Batchi_Shared shared;
+	shared.files = files;
+	shared.fileCount = fileCount;
+	shared.filesTaken = 0;
+	shared.intern = intern;
+	shared.tag = tag;
+	threadCount = HbMaxU32(HbMinU32(HbMinU32(threadCount, fileCount), HbFile_KV_Batch_MaxThreads), 1);
+	HbFile_KV_Batchi_Worker workers[HbFile_KV_Batch_MaxThreads];
+	HbParallel_Thread threads[HbFile_KV_Batch_MaxThreads];
+	HbBool threadsStarted[HbFile_KV_Batch_MaxThreads];
+	for (uint32_t workerIndex = 0; workerIndex < threadCount; ++workerIndex) {
+		HbFile_KV_Batchi_Worker * worker = &workers[workerIndex];
+		worker->shared = &shared;
+		worker->stringBuffer = NULL;
+		worker->stringBufferSize = 0;
+		worker->u8Buffer = NULL;
+		worker->u8BufferSize = 0;
+	}
+	// Worker 0 is the calling thread. If some threads couldn't be started, the files are taken by the other workers.
+	for (uint32_t workerIndex = 1; workerIndex < threadCount; ++workerIndex) {
+		threadsStarted[workerIndex] = HbParallel_Thread_Start(&threads[workerIndex], "HbKVBatch", HbFile_KV_Batchi_RunWorker, &workers[workerIndex]);
+	}
+	HbFile_KV_Batchi_RunWorker(&workers[0]);
+	for (uint32_t workerIndex = 1; workerIndex < threadCount; ++workerIndex) {
+		if (threadsStarted[workerIndex]) {
+			HbParallel_Thread_Destroy(&threads[workerIndex]);
+		}
+	}
+	for (uint32_t workerIndex = 0; workerIndex < threadCount; ++workerIndex) {
+		HbMemory_Free(workers[workerIndex].stringBuffer);
+		HbMemory_Free(workers[workerIndex].u8Buffer);
+	}
+	HbBool succeeded = HbTrue;
+	for (uint32_t fileIndex = 0; fileIndex < fileCount; ++fileIndex) {
+		if (files[fileIndex].nodes == NULL) {
+			succeeded = HbFalse;
+		}
+	}
+	return succeeded;
+}
+
+void HbFile_KV_Batch_DestroyFile(HbFile_KV_Batch_File * file) {
+	HbMemory_Free(file->nodes);
+}
+
+uint32_t HbFile_KV_Batch_FindChild(HbFile_KV_Batch_File const * file, uint32_t parentIndex, uint32_t keyCaseless) {
+	if (keyCaseless == HbText_Intern_InvalidID) {
+		return HbFile_KV_Doc_InvalidNode;
+	}
+	uint32_t childIndex = file->nodes[parentIndex].firstChild;
+	while (childIndex != HbFile_KV_Doc_InvalidNode && file->nodes[childIndex].keyCaseless != keyCaseless) {
+		childIndex = file->nodes[childIndex].nextSibling;
+	}
+	return childIndex;
+}
+
+uint32_t HbFile_KV_Batch_FindNextSibling(HbFile_KV_Batch_File const * file, uint32_t nodeIndex) {
+	uint32_t keyCaseless = file->nodes[nodeIndex].keyCaseless;
+	uint32_t siblingIndex = file->nodes[nodeIndex].nextSibling;
+	while (siblingIndex != HbFile_KV_Doc_InvalidNode && file->nodes[siblingIndex].keyCaseless != keyCaseless) {
+		siblingIndex = file->nodes[siblingIndex].nextSibling;
+	}
+	return siblingIndex;
+}
@@ -0,0 +1,304 @@
+#include "HbFile_KV.h"
+#include "HbHash.h"
+
+char const HbFile_KV_Binary_HeaderID[8] = { 'H', 'b', 'K', 'V', 'B', 'i', 'n', '1' };
+
+/************
+ * Compiling
+ ************/
+
+typedef struct HbFile_KV_Binaryi_Interner {
+	char * strings;
+	uint32_t stringsSize;
+	uint32_t * hashMap; // Offsets of strings, or UINT32_MAX for free slots.
+	uint32_t hashMapIndexMask;
+} HbFile_KV_Binaryi_Interner;
+
+static uint32_t HbFile_KV_Binaryi_Interner_Add(HbFile_KV_Binaryi_Interner * interner, char const * string, size_t length) {
+	uint32_t hashMapIndexMask = interner->hashMapIndexMask;
+	uint32_t hash = HbHash_FNV1a_HashTextA(string);
+	uint32_t hashIndex = hash & hashMapIndexMask;
+	uint32_t offset;
+	while ((offset = interner->hashMap[hashIndex]) != UINT32_MAX) {
+		if (HbTextA_Compare(interner->strings + offset, string) == 0) {
+			return offset;
+		}
+		HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+	}
+	offset = interner->stringsSize;
+	// The string may be already decoded in place.
+	memmove(interner->strings + offset, string, length + 1);
+	interner->stringsSize += (uint32_t) length + 1;
+	interner->hashMap[hashIndex] = offset;
+	return offset;
+}
+
+// Decodes the string into the end of the strings buffer (which is reserved for the longest case) and interns it.
+static uint32_t HbFile_KV_Binaryi_Interner_AddKV(HbFile_KV_Binaryi_Interner * interner,
+		HbFile_KV_Read_Context const * context, HbFile_KV_Read_String const * kvString) {
+	size_t length = HbFile_KV_Read_StringLengthU8Elems(context, kvString);
+	char * string = interner->strings + interner->stringsSize;
+	length = HbFile_KV_Read_CopyStringU8(context, kvString, string, length + 1);
+	return HbFile_KV_Binaryi_Interner_Add(interner, string, length);
+}
+
+void * HbFile_KV_Binary_Compile(HbFile_KV_Doc const * doc, HbMemory_Tag * tag, uint32_t * size) {
+	uint32_t nodeCount = doc->nodeCount;
+	HbFile_KV_Read_Context const * context = &doc->context;
+
+	// Gather the strings, the worst case is when none of them are repeated.
+	uint64_t stringsMaxSize = 1; // Empty key of the root.
+	for (uint32_t nodeIndex = HbFile_KV_Doc_RootNode + 1; nodeIndex < nodeCount; ++nodeIndex) {
+		HbFile_KV_Doc_Node const * node = &doc->nodes[nodeIndex];
+		stringsMaxSize += HbFile_KV_Read_StringLengthU8Elems(context, &node->key) + 1;
+		if (!node->isSection) {
+			stringsMaxSize += HbFile_KV_Read_StringLengthU8Elems(context, &node->value) + 1;
+		}
+	}
+	uint32_t stringsMaxCount = (nodeCount - 1) * 2 + 1;
+	uint32_t internerHashMapIndexMaskLog2 = HbHash_MapUtil_GetNeededEntriesLog2(stringsMaxCount);
+	if (stringsMaxSize > UINT32_MAX || internerHashMapIndexMaskLog2 == UINT32_MAX) {
+		return NULL;
+	}
+	HbFile_KV_Binaryi_Interner interner;
+	interner.strings = HbMemory_Alloc(tag, (size_t) stringsMaxSize, HbFalse);
+	interner.stringsSize = 0;
+	interner.hashMapIndexMask = ((uint32_t) 1 << internerHashMapIndexMaskLog2) - 1;
+	interner.hashMap = HbMemory_Alloc(tag, ((size_t) interner.hashMapIndexMask + 1) * sizeof(uint32_t), HbFalse);
+	memset(interner.hashMap, 0xFF, ((size_t) interner.hashMapIndexMask + 1) * sizeof(uint32_t));
+
+	// Breadth-first order, so the children of every section are contiguous.
+	// order is the new order of the document nodes, and firstChildren are the new indexes of the first children of the nodes in the new order.
+	uint32_t * order = HbMemory_Alloc(tag, (size_t) nodeCount * 2 * sizeof(uint32_t), HbFalse), * firstChildren = order + nodeCount;
+	order[0] = HbFile_KV_Doc_RootNode;
+	uint32_t orderedCount = 1;
+	for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+		firstChildren[nodeIndex] = orderedCount;
+		for (uint32_t childIndex = doc->nodes[order[nodeIndex]].firstChild; childIndex != HbFile_KV_Doc_InvalidNode;
+				childIndex = doc->nodes[childIndex].nextSibling) {
+			order[orderedCount++] = childIndex;
+		}
+	}
+
+	uint32_t hashMapIndexMask = 0;
+	uint64_t hashMapOffset = sizeof(HbFile_KV_Binary_Header) + (uint64_t) nodeCount * sizeof(HbFile_KV_Binary_Node), stringsOffset = hashMapOffset;
+	if (nodeCount > 1) {
+		hashMapIndexMask = ((uint32_t) 1 << HbHash_MapUtil_GetNeededEntriesLog2(nodeCount - 1)) - 1;
+		stringsOffset += ((uint64_t) hashMapIndexMask + 1) * sizeof(uint32_t);
+	}
+	if (stringsOffset + stringsMaxSize > UINT32_MAX) {
+		HbMemory_Free(order);
+		HbMemory_Free(interner.hashMap);
+		HbMemory_Free(interner.strings);
+		return NULL;
+	}
+
+	// Nodes are written to a temporary buffer first, as the final size depends on how many strings are repeated.
+	HbFile_KV_Binary_Node * nodes = HbMemory_Alloc(tag, (size_t) nodeCount * sizeof(HbFile_KV_Binary_Node), HbFalse);
+	HbFile_KV_Binary_Node * root = &nodes[0];
+	root->keyOffset = HbFile_KV_Binaryi_Interner_Add(&interner, "", 0);
+	root->valueOffset = HbFile_KV_Binary_NoValue;
+	root->keyHash = HbHash_FNV1a_Basis;
+	root->parent = HbFile_KV_Doc_InvalidNode;
+	for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+		HbFile_KV_Doc_Node const * docNode = &doc->nodes[order[nodeIndex]];
+		HbFile_KV_Binary_Node * node = &nodes[nodeIndex];
+		node->firstChild = firstChildren[nodeIndex];
+		node->childCount = docNode->childCount;
+		for (uint32_t childIndex = node->firstChild; childIndex < node->firstChild + node->childCount; ++childIndex) {
+			nodes[childIndex].parent = nodeIndex;
+		}
+		if (nodeIndex == 0) {
+			continue;
+		}
+		node->keyOffset = HbFile_KV_Binaryi_Interner_AddKV(&interner, context, &docNode->key);
+		node->valueOffset = docNode->isSection ? HbFile_KV_Binary_NoValue : HbFile_KV_Binaryi_Interner_AddKV(&interner, context, &docNode->value);
+		node->keyHash = docNode->keyHash;
+	}
+	HbMemory_Free(order);
+	HbMemory_Free(interner.hashMap);
+
+	uint32_t binarySize = (uint32_t) stringsOffset + interner.stringsSize;
+	uint8_t * binary = HbMemory_Alloc(tag, binarySize, HbTrue);
+	HbFile_KV_Binary_Header * header = (HbFile_KV_Binary_Header *) binary;
+	memcpy(header->id, HbFile_KV_Binary_HeaderID, sizeof(header->id));
+	header->nodeCount = nodeCount;
+	header->stringsOffset = (uint32_t) stringsOffset;
+	header->stringsSize = interner.stringsSize;
+	memset(header->reserved, 0, sizeof(header->reserved));
+	memcpy(binary + sizeof(HbFile_KV_Binary_Header), nodes, (size_t) nodeCount * sizeof(HbFile_KV_Binary_Node));
+	if (nodeCount > 1) {
+		// Inserting in the order of the nodes, so for repeated keys, the first one is found first when probing.
+		uint32_t * hashMap = (uint32_t *) (binary + hashMapOffset);
+		memset(hashMap, 0xFF, ((size_t) hashMapIndexMask + 1) * sizeof(uint32_t));
+		for (uint32_t nodeIndex = 1; nodeIndex < nodeCount; ++nodeIndex) {
+			uint32_t hash = HbFile_KV_Doc_GetChildHash(nodes[nodeIndex].keyHash, nodes[nodeIndex].parent);
+			uint32_t hashIndex = hash & hashMapIndexMask;
+			while (hashMap[hashIndex] != HbFile_KV_Doc_InvalidNode) {
+				HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+			}
+			hashMap[hashIndex] = nodeIndex;
+		}
+	}
+	memcpy(binary + stringsOffset, interner.strings, interner.stringsSize);
+	HbMemory_Free(nodes);
+	HbMemory_Free(interner.strings);
+	*size = binarySize;
+	return binary;
+}
+
+/**********
+ * Reading
+ **********/
+
+static HbBool HbFile_KV_Binaryi_Validate(HbFile_KV_Binary_Info const * info) {
+	uint32_t nodeCount = info->nodeCount, stringsSize = info->stringsSize;
+	HbFile_KV_Binary_Node const * nodes = info->nodes;
+	if (nodes[0].parent != HbFile_KV_Doc_InvalidNode || nodes[0].valueOffset != HbFile_KV_Binary_NoValue) {
+		return HbFalse;
+	}
+	for (uint32_t nodeIndex = 0; nodeIndex < nodeCount; ++nodeIndex) {
+		HbFile_KV_Binary_Node const * node = &nodes[nodeIndex];
+		if (node->keyOffset >= stringsSize || (node->valueOffset != HbFile_KV_Binary_NoValue && node->valueOffset >= stringsSize)) {
+			return HbFalse;
+		}
+		// Children must be after the node, so there are no cycles.
+		if (node->childCount != 0 && (node->valueOffset != HbFile_KV_Binary_NoValue ||
+				node->firstChild <= nodeIndex || node->firstChild > nodeCount || nodeCount - node->firstChild < node->childCount)) {
+			return HbFalse;
+		}
+		if (nodeIndex != 0) {
+			if (node->parent >= nodeIndex) {
+				return HbFalse;
+			}
+			HbFile_KV_Binary_Node const * parent = &nodes[node->parent];
+			if (nodeIndex < parent->firstChild || nodeIndex - parent->firstChild >= parent->childCount) {
+				return HbFalse;
+			}
+		}
+	}
+	// Every node except for the root must be in the hash map, so there are free slots, and probing always terminates.
+	if (info->hashMap != NULL) {
+		uint32_t usedSlots = 0;
+		for (uint32_t hashIndex = 0; hashIndex <= info->hashMapIndexMask; ++hashIndex) {
+			uint32_t nodeIndex = info->hashMap[hashIndex];
+			if (nodeIndex == HbFile_KV_Doc_InvalidNode) {
+				continue;
+			}
+			if (nodeIndex == 0 || nodeIndex >= nodeCount) {
+				return HbFalse;
+			}
+			++usedSlots;
+		}
+		if (usedSlots != nodeCount - 1) {
+			return HbFalse;
+		}
+	}
+	return HbTrue;
+}
+
+HbBool HbFile_KV_Binary_GetInfo(void const * data, uint32_t size, HbFile_KV_Binary_Info * info, HbBool validate) {
+	if (((uintptr_t) data & 15) != 0 || size < sizeof(HbFile_KV_Binary_Header)) {
+		return HbFalse;
+	}
+	HbFile_KV_Binary_Header const * header = (HbFile_KV_Binary_Header const *) data;
+	if (memcmp(header->id, HbFile_KV_Binary_HeaderID, sizeof(header->id)) != 0 ||
+			header->reserved[0] != 0 || header->reserved[1] != 0 || header->reserved[2] != 0) {
+		return HbFalse;
+	}
+	uint32_t nodeCount = header->nodeCount;
+	if (nodeCount == 0 || (size - sizeof(HbFile_KV_Binary_Header)) / sizeof(HbFile_KV_Binary_Node) < nodeCount) {
+		return HbFalse;
+	}
+	uint32_t hashMapOffset = sizeof(HbFile_KV_Binary_Header) + nodeCount * sizeof(HbFile_KV_Binary_Node), hashMapIndexMask = 0;
+	uint32_t stringsMinOffset = hashMapOffset;
+	if (nodeCount > 1) {
+		uint32_t hashMapIndexMaskLog2 = HbHash_MapUtil_GetNeededEntriesLog2(nodeCount - 1);
+		if (hashMapIndexMaskLog2 == UINT32_MAX) {
+			return HbFalse;
+		}
+		hashMapIndexMask = ((uint32_t) 1 << hashMapIndexMaskLog2) - 1;
+		if ((size - hashMapOffset) / sizeof(uint32_t) <= hashMapIndexMask) {
+			return HbFalse;
+		}
+		stringsMinOffset += (hashMapIndexMask + 1) * sizeof(uint32_t);
+	}
+	uint32_t stringsOffset = header->stringsOffset, stringsSize = header->stringsSize;
+	if (stringsOffset < stringsMinOffset || stringsOffset > size || stringsSize == 0 || size - stringsOffset < stringsSize) {
+		return HbFalse;
+	}
+	char const * strings = (char const *) data + stringsOffset;
+	// Any offset within the strings is a terminated string then.
+	if (strings[stringsSize - 1] != '\0') {
+		return HbFalse;
+	}
+	HbFile_KV_Binary_Info binaryInfo;
+	binaryInfo.nodes = (HbFile_KV_Binary_Node const *) ((uint8_t const *) data + sizeof(HbFile_KV_Binary_Header));
+	binaryInfo.hashMap = nodeCount > 1 ? (uint32_t const *) ((uint8_t const *) data + hashMapOffset) : NULL;
+	binaryInfo.strings = strings;
+	binaryInfo.nodeCount = nodeCount;
+	binaryInfo.hashMapIndexMask = hashMapIndexMask;
+	binaryInfo.stringsSize = stringsSize;
+	if (validate && !HbFile_KV_Binaryi_Validate(&binaryInfo)) {
+		return HbFalse;
+	}
+	*info = binaryInfo;
+	return HbTrue;
+}
+
+static uint32_t HbFile_KV_Binaryi_FindChild(HbFile_KV_Binary_Info const * info, uint32_t parentIndex, char const * key, size_t keyLength) {
+	if (info->hashMap == NULL) {
+		return HbFile_KV_Doc_InvalidNode;
+	}
+	uint32_t keyHash = HbHash_FNV1a_Basis;
+	for (size_t characterIndex = 0; characterIndex < keyLength; ++characterIndex) {
+		keyHash = HbHash_FNV1a_HashByte(keyHash, (uint8_t) HbTextA_CharToLower(key[characterIndex]));
+	}
+	uint32_t hashMapIndexMask = info->hashMapIndexMask;
+	uint32_t hash = HbFile_KV_Doc_GetChildHash(keyHash, parentIndex);
+	uint32_t hashIndex = hash & hashMapIndexMask;
+	uint32_t nodeIndex;
+	while ((nodeIndex = info->hashMap[hashIndex]) != HbFile_KV_Doc_InvalidNode) {
+		HbFile_KV_Binary_Node const * node = &info->nodes[nodeIndex];
+		if (node->parent == parentIndex && node->keyHash == keyHash) {
+			char const * nodeKey = HbFile_KV_Binary_GetKey(info, nodeIndex);
+			if (HbTextA_ComparePartCaseless(nodeKey, key, keyLength) == 0 && nodeKey[keyLength] == '\0') {
+				return nodeIndex;
+			}
+		}
+		HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+	}
+	return HbFile_KV_Doc_InvalidNode;
+}
+
+uint32_t HbFile_KV_Binary_FindChild(HbFile_KV_Binary_Info const * info, uint32_t parentIndex, char const * key) {
+	return HbFile_KV_Binaryi_FindChild(info, parentIndex, key, HbTextA_Length(key));
+}
+
+uint32_t HbFile_KV_Binary_FindNextSibling(HbFile_KV_Binary_Info const * info, uint32_t nodeIndex) {
+	HbFile_KV_Binary_Node const * node = &info->nodes[nodeIndex];
+	if (node->parent == HbFile_KV_Doc_InvalidNode) {
+		return HbFile_KV_Doc_InvalidNode;
+	}
+	HbFile_KV_Binary_Node const * parent = &info->nodes[node->parent];
+	char const * key = HbFile_KV_Binary_GetKey(info, nodeIndex);
+	for (uint32_t siblingIndex = nodeIndex + 1; siblingIndex < parent->firstChild + parent->childCount; ++siblingIndex) {
+		if (info->nodes[siblingIndex].keyHash == node->keyHash && HbTextA_CompareCaseless(HbFile_KV_Binary_GetKey(info, siblingIndex), key) == 0) {
+			return siblingIndex;
+		}
+	}
+	return HbFile_KV_Doc_InvalidNode;
+}
+
+uint32_t HbFile_KV_Binary_FindPath(HbFile_KV_Binary_Info const * info, uint32_t parentIndex, char const * path) {
+	uint32_t nodeIndex = parentIndex;
+	for (;;) {
+		char const * separator = strchr(path, '/');
+		size_t keyLength = separator != NULL ? (size_t) (separator - path) : HbTextA_Length(path);
+		nodeIndex = HbFile_KV_Binaryi_FindChild(info, nodeIndex, path, keyLength);
+		if (nodeIndex == HbFile_KV_Doc_InvalidNode || separator == NULL) {
+			return nodeIndex;
+		}
+		path = separator + 1;
+	}
+}
@@ -0,0 +1,198 @@
+#include "HbFile_KV.h"
+#include "HbHash.h"
+
+HbBool HbFile_KV_Doc_Init(HbFile_KV_Doc * doc, void const * data, size_t size, HbBool useEscapeSequences, HbMemory_Tag * tag) {
+	// The allocation contains the UTF-8 conversion of UTF-16 input, then the nodes, appended in a single pass and growing 2x to avoid
+	// tokenizing the file twice, and then the hash map, placed when the node count is known.
+	HbFile_KV_Read_Context * context = &doc->context;
+	size_t u8BufferSize = HbFile_KV_Read_GetU8BufferSize(data, size);
+	uint32_t nodeCapacity = 64;
+	uint8_t * allocation = HbMemory_Alloc(tag, HbAlignSize(u8BufferSize, 16) + nodeCapacity * sizeof(HbFile_KV_Doc_Node), HbFalse);
+	HbFile_KV_Read_InitU8(context, data, size, useEscapeSequences, u8BufferSize != 0 ? (HbTextU8 *) allocation : NULL);
+	// The converted text is usually much smaller than the worst case, the nodes are placed right after it.
+	size_t nodesOffset = u8BufferSize != 0 ? HbAlignSize(context->size, 16) : 0;
+	HbFile_KV_Doc_Node * nodes = (HbFile_KV_Doc_Node *) (allocation + nodesOffset);
+
+	HbFile_KV_Doc_Node * root = &nodes[HbFile_KV_Doc_RootNode];
+	root->key.quoted = root->value.quoted = HbFalse;
+	root->key.position = root->value.position = context->size;
+	root->keyHash = HbHash_FNV1a_Basis;
+	root->parent = root->nextSibling = root->firstChild = HbFile_KV_Doc_InvalidNode;
+	root->childCount = 0;
+	root->isSection = HbTrue;
+	uint32_t nodeCount = HbFile_KV_Doc_RootNode + 1;
+	uint32_t sectionIndex = HbFile_KV_Doc_RootNode, previousSiblingIndex = HbFile_KV_Doc_InvalidNode;
+	HbBool succeeded = HbTrue;
+
+	HbFile_KV_Read_TokenType tokenType;
+	while ((tokenType = HbFile_KV_Read_Parse(context)) != HbFile_KV_Read_TokenType_End) {
+		if (tokenType == HbFile_KV_Read_TokenType_SectionEnd) {
+			// The section itself is the last node added to its parent.
+			previousSiblingIndex = sectionIndex;
+			sectionIndex = nodes[sectionIndex].parent;
+			continue;
+		}
+		// All nodes except for the root are in the hash map.
+		if (nodeCount > HbHash_MapUtil_MaxUsedEntries) {
+			succeeded = HbFalse;
+			break;
+		}
+		if (nodeCount == nodeCapacity) {
+			nodeCapacity *= 2;
+			HbMemory_Realloc((void * *) &allocation, nodesOffset + (size_t) nodeCapacity * sizeof(HbFile_KV_Doc_Node));
+			nodes = (HbFile_KV_Doc_Node *) (allocation + nodesOffset);
+			if (u8BufferSize != 0) {
+				context->data.u8 = (HbTextU8 const *) allocation;
+			}
+		}
+		uint32_t nodeIndex = nodeCount++;
+		HbFile_KV_Doc_Node * node = &nodes[nodeIndex];
+		node->key = context->keyString;
+		node->value = context->valueString;
+		node->keyHash = HbFile_KV_Read_StringHashCaseless(context, &context->keyString);
+		node->parent = sectionIndex;
+		node->nextSibling = node->firstChild = HbFile_KV_Doc_InvalidNode;
+		node->childCount = 0;
+		node->isSection = (tokenType == HbFile_KV_Read_TokenType_SectionStart);
+		HbFile_KV_Doc_Node * section = &nodes[sectionIndex];
+		if (previousSiblingIndex != HbFile_KV_Doc_InvalidNode) {
+			nodes[previousSiblingIndex].nextSibling = nodeIndex;
+		} else {
+			section->firstChild = nodeIndex;
+		}
+		++section->childCount;
+		if (node->isSection) {
+			sectionIndex = nodeIndex;
+			previousSiblingIndex = HbFile_KV_Doc_InvalidNode;
+		} else {
+			previousSiblingIndex = nodeIndex;
+		}
+	}
+	if (!succeeded || context->syntaxError || context->sectionDepth != 0) {
+		HbMemory_Free(allocation);
+		return HbFalse;
+	}
+
+	uint32_t hashMapIndexMask = 0;
+	size_t nodesSize = (size_t) nodeCount * sizeof(HbFile_KV_Doc_Node), hashMapSize = 0;
+	if (nodeCount > 1) {
+		hashMapIndexMask = ((uint32_t) 1 << HbHash_MapUtil_GetNeededEntriesLog2(nodeCount - 1)) - 1;
+		hashMapSize = ((size_t) hashMapIndexMask + 1) * sizeof(uint32_t);
+	}
+	HbMemory_Realloc((void * *) &allocation, nodesOffset + nodesSize + hashMapSize);
+	if (u8BufferSize != 0) {
+		context->data.u8 = (HbTextU8 const *) allocation;
+	}
+	doc->allocation = allocation;
+	doc->nodes = (HbFile_KV_Doc_Node *) (allocation + nodesOffset);
+	doc->hashMap = nodeCount > 1 ? (uint32_t *) (allocation + nodesOffset + nodesSize) : NULL;
+	doc->nodeCount = nodeCount;
+	doc->hashMapIndexMask = hashMapIndexMask;
+	if (doc->hashMap != NULL) {
+		memset(doc->hashMap, 0xFF, hashMapSize);
+		// Inserting in the order of the file, so for repeated keys, the first one is found first when probing.
+		for (uint32_t nodeIndex = HbFile_KV_Doc_RootNode + 1; nodeIndex < nodeCount; ++nodeIndex) {
+			HbFile_KV_Doc_Node const * node = &doc->nodes[nodeIndex];
+			uint32_t hash = HbFile_KV_Doc_GetChildHash(node->keyHash, node->parent);
+			uint32_t hashIndex = hash & hashMapIndexMask;
+			while (doc->hashMap[hashIndex] != HbFile_KV_Doc_InvalidNode) {
+				HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+			}
+			doc->hashMap[hashIndex] = nodeIndex;
+		}
+	}
+	return HbTrue;
+}
+
+void HbFile_KV_Doc_Destroy(HbFile_KV_Doc * doc) {
+	HbMemory_Free(doc->allocation);
+}
+
+// The key doesn't need to be null-terminated. Compared as UTF-8 with only ASCII letters case-insensitive, like the key hashes.
+static HbBool HbFile_KV_Doci_KeyEquals(HbFile_KV_Doc const * doc, uint32_t nodeIndex, char const * key, size_t keyLength) {
+	HbFile_KV_Read_String const * kvString = &doc->nodes[nodeIndex].key;
+	size_t kvOffset = 0, keyOffset = 0;
+	for (;;) {
+		uint32_t bytesToNext;
+		HbTextU32 character = HbFile_KV_Read_GetStringCharacter(&doc->context, kvString, kvOffset, &bytesToNext);
+		if (character == '\0') {
+			return keyOffset == keyLength;
+		}
+		kvOffset += bytesToNext;
+		HbTextU8 characterU8[HbTextU8_MaxCharElems];
+		uint32_t characterU8Elems = HbTextU8_WriteValidChar(characterU8, HbArrayLength(characterU8), HbTextU32_ASCIICharToLower(character));
+		if (characterU8Elems > keyLength - keyOffset) {
+			return HbFalse;
+		}
+		for (uint32_t elemIndex = 0; elemIndex < characterU8Elems; ++elemIndex) {
+			if (characterU8[elemIndex] != HbTextA_CharToLower(key[keyOffset + elemIndex])) {
+				return HbFalse;
+			}
+		}
+		keyOffset += characterU8Elems;
+	}
+}
+
+static uint32_t HbFile_KV_Doci_FindChild(HbFile_KV_Doc const * doc, uint32_t parentIndex, char const * key, size_t keyLength) {
+	if (doc->hashMap == NULL) {
+		return HbFile_KV_Doc_InvalidNode;
+	}
+	uint32_t keyHash = HbHash_FNV1a_Basis;
+	for (size_t characterIndex = 0; characterIndex < keyLength; ++characterIndex) {
+		keyHash = HbHash_FNV1a_HashByte(keyHash, (uint8_t) HbTextA_CharToLower(key[characterIndex]));
+	}
+	uint32_t hashMapIndexMask = doc->hashMapIndexMask;
+	uint32_t hash = HbFile_KV_Doc_GetChildHash(keyHash, parentIndex);
+	uint32_t hashIndex = hash & hashMapIndexMask;
+	uint32_t nodeIndex;
+	while ((nodeIndex = doc->hashMap[hashIndex]) != HbFile_KV_Doc_InvalidNode) {
+		HbFile_KV_Doc_Node const * node = &doc->nodes[nodeIndex];
+		if (node->parent == parentIndex && node->keyHash == keyHash && HbFile_KV_Doci_KeyEquals(doc, nodeIndex, key, keyLength)) {
+			return nodeIndex;
+		}
+		HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+	}
+	return HbFile_KV_Doc_InvalidNode;
+}
+
+uint32_t HbFile_KV_Doc_FindChild(HbFile_KV_Doc const * doc, uint32_t parentIndex, char const * key) {
+	return HbFile_KV_Doci_FindChild(doc, parentIndex, key, HbTextA_Length(key));
+}
+
+uint32_t HbFile_KV_Doc_FindNextSibling(HbFile_KV_Doc const * doc, uint32_t nodeIndex) {
+	HbFile_KV_Read_Context const * context = &doc->context;
+	HbFile_KV_Doc_Node const * node = &doc->nodes[nodeIndex];
+	for (uint32_t siblingIndex = node->nextSibling; siblingIndex != HbFile_KV_Doc_InvalidNode; siblingIndex = doc->nodes[siblingIndex].nextSibling) {
+		HbFile_KV_Doc_Node const * sibling = &doc->nodes[siblingIndex];
+		if (sibling->keyHash != node->keyHash) {
+			continue;
+		}
+		size_t offset = 0, siblingOffset = 0;
+		for (;;) {
+			uint32_t bytesToNext, siblingBytesToNext;
+			HbTextU32 character = HbTextU32_ASCIICharToLower(HbFile_KV_Read_GetStringCharacter(context, &node->key, offset, &bytesToNext));
+			if (character != HbTextU32_ASCIICharToLower(HbFile_KV_Read_GetStringCharacter(context, &sibling->key, siblingOffset, &siblingBytesToNext))) {
+				break;
+			}
+			if (character == '\0') {
+				return siblingIndex;
+			}
+			offset += bytesToNext;
+			siblingOffset += siblingBytesToNext;
+		}
+	}
+	return HbFile_KV_Doc_InvalidNode;
+}
+
+uint32_t HbFile_KV_Doc_FindPath(HbFile_KV_Doc const * doc, uint32_t parentIndex, char const * path) {
+	uint32_t nodeIndex = parentIndex;
+	for (;;) {
+		char const * separator = strchr(path, '/');
+		size_t keyLength = separator != NULL ? (size_t) (separator - path) : HbTextA_Length(path);
+		nodeIndex = HbFile_KV_Doci_FindChild(doc, nodeIndex, path, keyLength);
+		if (nodeIndex == HbFile_KV_Doc_InvalidNode || separator == NULL) {
+			return nodeIndex;
+		}
+		path = separator + 1;
+	}
+}
@@ -1,5 +1,7 @@
 #ifndef HbInclude_HbGPU
 #define HbInclude_HbGPU
+#include "HbGPU_Image.h"
+#include "HbGPU_Vertex.h"
 #include "HbMemory.h"
 #include "HbText.h"
 
@@ -139,181 +141,6 @@ void HbGPU_Buffer_Unmap(HbGPU_Buffer * buffer, uint32_t writeStart, uint32_t wri
  * Image
  ********/
 
-typedef enum HbGPU_Image_Format {
-	HbGPU_Image_Format_Invalid, // Zero.
-	HbGPU_Image_Format_RawStart,
-		HbGPU_Image_Format_4_4_4_4_BGRA_UNorm = HbGPU_Image_Format_RawStart,
-		HbGPU_Image_Format_5_5_5_1_BGRA_UNorm,
-		HbGPU_Image_Format_5_6_5_BGR_UNorm,
-		HbGPU_Image_Format_8_R_UNorm,
-		HbGPU_Image_Format_8_R_UInt,
-		HbGPU_Image_Format_8_R_SNorm,
-		HbGPU_Image_Format_8_R_SInt,
-		HbGPU_Image_Format_8_8_RG_UNorm,
-		HbGPU_Image_Format_8_8_RG_UInt,
-		HbGPU_Image_Format_8_8_RG_SNorm,
-		HbGPU_Image_Format_8_8_RG_SInt,
-		HbGPU_Image_Format_8_8_8_8_RGBA_UNorm,
-		HbGPU_Image_Format_8_8_8_8_RGBA_sRGB,
-		HbGPU_Image_Format_8_8_8_8_RGBA_UInt,
-		HbGPU_Image_Format_8_8_8_8_RGBA_SNorm,
-		HbGPU_Image_Format_8_8_8_8_RGBA_SInt,
-		HbGPU_Image_Format_8_8_8_8_BGRA_UNorm,
-		HbGPU_Image_Format_8_8_8_8_BGRA_sRGB,
-		HbGPU_Image_Format_10_10_10_2_RGBA_UNorm,
-		HbGPU_Image_Format_10_10_10_2_RGBA_UInt,
-		HbGPU_Image_Format_11_11_10_RGB_UFloat,
-		HbGPU_Image_Format_16_R_UNorm,
-		HbGPU_Image_Format_16_R_UInt,
-		HbGPU_Image_Format_16_R_SNorm,
-		HbGPU_Image_Format_16_R_SInt,
-		HbGPU_Image_Format_16_R_SFloat,
-		HbGPU_Image_Format_16_16_RG_UNorm,
-		HbGPU_Image_Format_16_16_RG_UInt,
-		HbGPU_Image_Format_16_16_RG_SNorm,
-		HbGPU_Image_Format_16_16_RG_SInt,
-		HbGPU_Image_Format_16_16_RG_SFloat,
-		HbGPU_Image_Format_16_16_16_16_RGBA_UNorm,
-		HbGPU_Image_Format_16_16_16_16_RGBA_UInt,
-		HbGPU_Image_Format_16_16_16_16_RGBA_SNorm,
-		HbGPU_Image_Format_16_16_16_16_RGBA_SInt,
-		HbGPU_Image_Format_16_16_16_16_RGBA_SFloat,
-		HbGPU_Image_Format_32_R_UInt,
-		HbGPU_Image_Format_32_R_SInt,
-		HbGPU_Image_Format_32_R_SFloat,
-		HbGPU_Image_Format_32_32_RG_UInt,
-		HbGPU_Image_Format_32_32_RG_SInt,
-		HbGPU_Image_Format_32_32_RG_SFloat,
-		HbGPU_Image_Format_32_32_32_32_RGBA_UInt,
-		HbGPU_Image_Format_32_32_32_32_RGBA_SInt,
-		HbGPU_Image_Format_32_32_32_32_RGBA_SFloat,
-	HbGPU_Image_Format_RawEnd = HbGPU_Image_Format_32_32_32_32_RGBA_SFloat,
-	HbGPU_Image_Format_4x4Start,
-		HbGPU_Image_Format_S3TC_A1_UNorm = HbGPU_Image_Format_4x4Start,
-		HbGPU_Image_Format_S3TC_A1_sRGB,
-		HbGPU_Image_Format_S3TC_A4_UNorm,
-		HbGPU_Image_Format_S3TC_A4_sRGB,
-		HbGPU_Image_Format_S3TC_A8_UNorm,
-		HbGPU_Image_Format_S3TC_A8_sRGB,
-		HbGPU_Image_Format_3Dc_R_UNorm,
-		HbGPU_Image_Format_3Dc_R_SNorm,
-		HbGPU_Image_Format_3Dc_RG_UNorm,
-		HbGPU_Image_Format_3Dc_RG_SNorm,
-		HbGPU_Image_Format_BPTC_UFloat,
-		HbGPU_Image_Format_BPTC_SFloat,
-		HbGPU_Image_Format_BPTC_UNorm,
-		HbGPU_Image_Format_BPTC_sRGB,
-	HbGPU_Image_Format_4x4End = HbGPU_Image_Format_BPTC_sRGB,
-	HbGPU_Image_Format_DepthStart,
-		HbGPU_Image_Format_D32 = HbGPU_Image_Format_DepthStart,
-		HbGPU_Image_Format_DepthAndStencilStart,
-			HbGPU_Image_Format_D32_S8 = HbGPU_Image_Format_DepthAndStencilStart,
-		HbGPU_Image_Format_DepthAndStencilEnd = HbGPU_Image_Format_D32_S8,
-	HbGPU_Image_Format_DepthEnd = HbGPU_Image_Format_DepthAndStencilEnd,
-	HbGPU_Image_Format_FormatCount,
-} HbGPU_Image_Format;
-HbForceInline HbBool HbGPU_Image_Format_Is4x4(HbGPU_Image_Format format) {
-	return format >= HbGPU_Image_Format_4x4Start && format <= HbGPU_Image_Format_4x4End;
-}
-HbForceInline HbBool HbGPU_Image_Format_IsDepth(HbGPU_Image_Format format) {
-	return format >= HbGPU_Image_Format_DepthStart && format <= HbGPU_Image_Format_DepthEnd;
-}
-HbForceInline HbBool HbGPU_Image_Format_HasStencil(HbGPU_Image_Format format) {
-	return format >= HbGPU_Image_Format_DepthAndStencilStart && format <= HbGPU_Image_Format_DepthAndStencilEnd;
-}
-HbForceInline HbGPU_Image_Format HbGPU_Image_Format_ToLinear(HbGPU_Image_Format format) {
-	return format == HbGPU_Image_Format_8_8_8_8_RGBA_sRGB ? HbGPU_Image_Format_8_8_8_8_RGBA_UNorm : format;
-}
-
-typedef enum HbGPU_Image_Dimensions {
-	HbGPU_Image_Dimensions_1D,
-	HbGPU_Image_Dimensions_1DArray,
-	HbGPU_Image_Dimensions_2D,
-	HbGPU_Image_Dimensions_2DArray,
-	HbGPU_Image_Dimensions_Cube,
-	HbGPU_Image_Dimensions_CubeArray,
-	HbGPU_Image_Dimensions_3D,
-} HbGPU_Image_Dimensions;
-HbForceInline HbBool HbGPU_Image_Dimensions_AreArray(HbGPU_Image_Dimensions dimensions) {
-	return dimensions == HbGPU_Image_Dimensions_1DArray || dimensions == HbGPU_Image_Dimensions_2DArray ||
-			dimensions == HbGPU_Image_Dimensions_CubeArray;
-}
-HbForceInline HbBool HbGPU_Image_Dimensions_Are1D(HbGPU_Image_Dimensions dimensions) {
-	return dimensions == HbGPU_Image_Dimensions_1D || dimensions == HbGPU_Image_Dimensions_1DArray;
-}
-HbForceInline HbBool HbGPU_Image_Dimensions_Are2D(HbGPU_Image_Dimensions dimensions) {
-	return dimensions == HbGPU_Image_Dimensions_2D || dimensions == HbGPU_Image_Dimensions_2DArray;
-}
-HbForceInline HbBool HbGPU_Image_Dimensions_AreCube(HbGPU_Image_Dimensions dimensions) {
-	return dimensions == HbGPU_Image_Dimensions_Cube || dimensions == HbGPU_Image_Dimensions_CubeArray;
-}
-
-// Limits, based on the targeted D3D feature level 11_0, to prevent overflows (in file loading, for instance),
-// and also for use in bitfields.
-enum {
-	HbGPU_Image_MaxSize1D2DLog2 = 14,
-	HbGPU_Image_MaxSize1D2D = 1 << HbGPU_Image_MaxSize1D2DLog2,
-	HbGPU_Image_MaxSize3DLog2 = 11,
-	HbGPU_Image_MaxSize3D = 1 << HbGPU_Image_MaxSize3DLog2,
-	HbGPU_Image_MipCountBits = 4,
-	HbGPU_Image_MaxLayersLog2 = 11,
-	HbGPU_Image_MaxLayers = 1 << HbGPU_Image_MaxLayersLog2,
-	HbGPU_Image_MaxLayersCube = HbGPU_Image_MaxLayers / 6,
-	HbGPU_Image_MaxSamplesLog2 = 4,
-};
-
-// Force inline so null checks and pointer passing may be removed.
-HbForceInline void HbGPU_Image_MipSize(uint32_t mip, HbGPU_Image_Dimensions dimensions, uint32_t * width, uint32_t * height, uint32_t * depth) {
-	if (width != NULL) {
-		*width = HbMaxU32(*width >> mip, 1);
-	}
-	if (height != NULL) {
-		*height = HbGPU_Image_Dimensions_Are1D(dimensions) ? 1 : HbMaxU32(*height >> mip, 1);
-	}
-	if (depth != NULL) {
-		*depth = (dimensions == HbGPU_Image_Dimensions_3D) ? HbMaxU32(*depth >> mip, 1) : 1;
-	}
-}
-
-typedef uint32_t HbGPU_Image_UsageOptions;
-enum {
-	// Certain color formats only - can be written to in shaders.
-	HbGPU_Image_UsageOptions_ShaderEditable = 1,
-	// Certain color formats only - can be bound as a color render target.
-	HbGPU_Image_UsageOptions_ColorRenderable = HbGPU_Image_UsageOptions_ShaderEditable << 1,
-	// For depth buffers - optimization, can't use as a texture.
-	HbGPU_Image_UsageOptions_DepthTestOnly = HbGPU_Image_UsageOptions_ColorRenderable << 1,
-};
-
-typedef struct HbGPU_Image_Info {
-	HbGPU_Image_Format format;
-	HbGPU_Image_Dimensions dimensions;
-	uint32_t width;
-	uint32_t height; // Must be 1 for 1D.
-	uint32_t depthOrLayers; // Must be 1 for non-arrays and non-3D.
-	uint32_t mips; // Must be at least 1, mips are not allowed for 1D (Metal restriction) and multisampled images.
-	uint32_t samplesLog2; // For 2D non-arrays only - in other cases, only 0 is allowed.
-	HbGPU_Image_UsageOptions usageOptions;
-} HbGPU_Image_Info;
-HbBool HbGPU_Image_Info_CleanupAndValidate(HbGPU_Image_Info * info);
-HbForceInline uint32_t HbGPU_Image_Info_Get3DDepth(HbGPU_Image_Info const * info) {
-	return (info->dimensions == HbGPU_Image_Dimensions_3D) ? info->depthOrLayers : 1;
-}
-HbForceInline uint32_t HbGPU_Image_Info_GetArrayLayers(HbGPU_Image_Info const * info) {
-	return (info->dimensions != HbGPU_Image_Dimensions_3D) ? info->depthOrLayers : 1;
-}
-
-// Element is either a texel (for uncompressed formats) or a block (for compressed formats).
-uint32_t HbGPU_Image_Copy_ElementSize(HbGPU_Image_Format format, HbBool stencil);
-// D3D12_TEXTURE_DATA_PLACEMENT_ALIGNMENT - alignment of each slice (from mip level and above) in copy buffers.
-#define HbGPU_Image_Copy_SliceAlignment 512
-// D3D12_TEXTURE_DATA_PITCH_ALIGNMENT - alignment of each row of elements in copy buffers.
-#define HbGPU_Image_Copy_RowAlignment 256
-// Returns the total slice-aligned size of the mip level, or 0 if not possible to obtain the layout.
-// Assumes valid info (of an existing image, for instance).
-uint32_t HbGPU_Image_Copy_MipLayout(HbGPU_Image_Info const * info, HbBool stencil, uint32_t mip,
-		uint32_t * outRowPitchBytes, uint32_t * out3DLayerPitchRows, uint32_t * outDepth);
-
 typedef struct HbGPU_Image {
 	HbGPU_Image_Info info;
 	#if HbGPU_Implementation_D3D
@@ -628,82 +455,6 @@ HbBool HbGPU_BindingLayout_Init(HbGPU_BindingLayout * layout, HbTextU8 const * n
 		HbGPU_Binding const * bindings, uint32_t bindingCount, HbBool useVertexAttributes);
 void HbGPU_BindingLayout_Destroy(HbGPU_BindingLayout * layout);
 
-/****************
- * Vertex layout
- ****************/
-
-typedef struct HbGPU_Vertex_Stream {
-	uint32_t strideInDwords;
-	uint32_t instanceStepRate; // 0 for per-vertex.
-} HbGPU_Vertex_Stream;
-
-typedef enum HbGPU_Vertex_Semantic {
-	HbGPU_Vertex_Semantic_Position, // Float32x3 preferred.
-	HbGPU_Vertex_Semantic_Normal, // UNorm10.10.10.2 (biased) preferred.
-	HbGPU_Vertex_Semantic_Tangent, // UNorm10.10.10.2 (biased) preferred, bitangent sign in W.
-	HbGPU_Vertex_Semantic_TexCoord, // Float32x2 preferred.
-	HbGPU_Vertex_Semantic_Color, // UNorm8x4 preferred.
-	HbGPU_Vertex_Semantic_BlendIndexes, // UInt8x4 preferred.
-	HbGPU_Vertex_Semantic_BlendWeights, // UNorm8x4 preferred.
-	HbGPU_Vertex_Semantic_InstancePosition, // Float32x3 preferred.
-	HbGPU_Vertex_Semantic_InstanceRotation, // SNorm16x4 preferred, quaternion.
-} HbGPU_Vertex_Semantic;
-// For quick checking of which of the required semantics (with semantic index 0, for instance) are present in a mesh.
-typedef uint32_t HbGPU_Vertex_SemanticBits;
-enum {
-	HbGPU_Vertex_SemanticBits_Position = 1 << HbGPU_Vertex_Semantic_Position,
-	HbGPU_Vertex_SemanticBits_Normal = 1 << HbGPU_Vertex_Semantic_Normal,
-	HbGPU_Vertex_SemanticBits_Tangent = 1 << HbGPU_Vertex_Semantic_Tangent,
-	HbGPU_Vertex_SemanticBits_TexCoord = 1 << HbGPU_Vertex_Semantic_TexCoord,
-	HbGPU_Vertex_SemanticBits_Color = 1 << HbGPU_Vertex_Semantic_Color,
-	HbGPU_Vertex_SemanticBits_BlendIndexes = 1 << HbGPU_Vertex_Semantic_BlendIndexes,
-	HbGPU_Vertex_SemanticBits_BlendWeights = 1 << HbGPU_Vertex_Semantic_BlendWeights,
-	HbGPU_Vertex_SemanticBits_InstancePosition = 1 << HbGPU_Vertex_Semantic_InstancePosition,
-	HbGPU_Vertex_SemanticBits_InstanceRotation = 1 << HbGPU_Vertex_Semantic_InstanceRotation,
-};
-
-typedef enum HbGPU_Vertex_Format {
-	HbGPU_Vertex_Format_Float_32x1,
-	HbGPU_Vertex_Format_Float_32x2,
-	HbGPU_Vertex_Format_Float_32x3,
-	HbGPU_Vertex_Format_Float_32x4,
-	HbGPU_Vertex_Format_Float_16x2,
-	HbGPU_Vertex_Format_Float_16x4,
-	HbGPU_Vertex_Format_Float_11_11_10,
-	HbGPU_Vertex_Format_UNorm_16x2,
-	HbGPU_Vertex_Format_UNorm_16x4,
-	HbGPU_Vertex_Format_UNorm_10_10_10_2,
-	HbGPU_Vertex_Format_UNorm_8x4,
-	HbGPU_Vertex_Format_SNorm_16x2,
-	HbGPU_Vertex_Format_SNorm_16x4,
-	HbGPU_Vertex_Format_SNorm_8x4,
-	HbGPU_Vertex_Format_UInt_32x1,
-	HbGPU_Vertex_Format_UInt_32x2,
-	HbGPU_Vertex_Format_UInt_32x3,
-	HbGPU_Vertex_Format_UInt_32x4,
-	HbGPU_Vertex_Format_UInt_16x2,
-	HbGPU_Vertex_Format_UInt_16x4,
-	HbGPU_Vertex_Format_UInt_10_10_10_2,
-	HbGPU_Vertex_Format_UInt_8x4,
-	HbGPU_Vertex_Format_SInt_32x1,
-	HbGPU_Vertex_Format_SInt_32x2,
-	HbGPU_Vertex_Format_SInt_32x3,
-	HbGPU_Vertex_Format_SInt_32x4,
-	HbGPU_Vertex_Format_SInt_16x2,
-	HbGPU_Vertex_Format_SInt_16x4,
-	HbGPU_Vertex_Format_SInt_8x4,
-} HbGPU_Vertex_Format;
-
-typedef struct HbGPU_Vertex_Attribute {
-	uint32_t streamIndex;
-	HbGPU_Vertex_Semantic semantic;
-	uint32_t semanticIndex;
-	HbGPU_Vertex_Format format;
-	uint32_t offsetInDwords;
-} HbGPU_Vertex_Attribute;
-
-typedef uint16_t HbGPU_Vertex_Index;
-
 /************************
  * Drawing configuration
  ************************/
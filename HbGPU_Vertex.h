@@ -0,0 +1,88 @@
+#ifndef HbInclude_HbGPU_Vertex
+#define HbInclude_HbGPU_Vertex
+#include "HbCommon.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Vertex layout - the description of vertex data, used by meshes and models as well as by GPU pipelines.
+ * This part doesn't depend on the GPU API or on the OS, so it can be used in tools built for any platform.
+ */
+
+typedef struct HbGPU_Vertex_Stream {
+	uint32_t strideInDwords;
+	uint32_t instanceStepRate; // 0 for per-vertex.
+} HbGPU_Vertex_Stream;
+
+typedef enum HbGPU_Vertex_Semantic {
+	HbGPU_Vertex_Semantic_Position, // Float32x3 preferred.
+	HbGPU_Vertex_Semantic_Normal, // UNorm10.10.10.2 (biased) preferred.
+	HbGPU_Vertex_Semantic_Tangent, // UNorm10.10.10.2 (biased) preferred, bitangent sign in W.
+	HbGPU_Vertex_Semantic_TexCoord, // Float32x2 preferred.
+	HbGPU_Vertex_Semantic_Color, // UNorm8x4 preferred.
+	HbGPU_Vertex_Semantic_BlendIndexes, // UInt8x4 preferred.
+	HbGPU_Vertex_Semantic_BlendWeights, // UNorm8x4 preferred.
+	HbGPU_Vertex_Semantic_InstancePosition, // Float32x3 preferred.
+	HbGPU_Vertex_Semantic_InstanceRotation, // SNorm16x4 preferred, quaternion.
+} HbGPU_Vertex_Semantic;
+// For quick checking of which of the required semantics (with semantic index 0, for instance) are present in a mesh.
+typedef uint32_t HbGPU_Vertex_SemanticBits;
+enum {
+	HbGPU_Vertex_SemanticBits_Position = 1 << HbGPU_Vertex_Semantic_Position,
+	HbGPU_Vertex_SemanticBits_Normal = 1 << HbGPU_Vertex_Semantic_Normal,
+	HbGPU_Vertex_SemanticBits_Tangent = 1 << HbGPU_Vertex_Semantic_Tangent,
+	HbGPU_Vertex_SemanticBits_TexCoord = 1 << HbGPU_Vertex_Semantic_TexCoord,
+	HbGPU_Vertex_SemanticBits_Color = 1 << HbGPU_Vertex_Semantic_Color,
+	HbGPU_Vertex_SemanticBits_BlendIndexes = 1 << HbGPU_Vertex_Semantic_BlendIndexes,
+	HbGPU_Vertex_SemanticBits_BlendWeights = 1 << HbGPU_Vertex_Semantic_BlendWeights,
+	HbGPU_Vertex_SemanticBits_InstancePosition = 1 << HbGPU_Vertex_Semantic_InstancePosition,
+	HbGPU_Vertex_SemanticBits_InstanceRotation = 1 << HbGPU_Vertex_Semantic_InstanceRotation,
+};
+
+typedef enum HbGPU_Vertex_Format {
+	HbGPU_Vertex_Format_Float_32x1,
+	HbGPU_Vertex_Format_Float_32x2,
+	HbGPU_Vertex_Format_Float_32x3,
+	HbGPU_Vertex_Format_Float_32x4,
+	HbGPU_Vertex_Format_Float_16x2,
+	HbGPU_Vertex_Format_Float_16x4,
+	HbGPU_Vertex_Format_Float_11_11_10,
+	HbGPU_Vertex_Format_UNorm_16x2,
+	HbGPU_Vertex_Format_UNorm_16x4,
+	HbGPU_Vertex_Format_UNorm_10_10_10_2,
+	HbGPU_Vertex_Format_UNorm_8x4,
+	HbGPU_Vertex_Format_SNorm_16x2,
+	HbGPU_Vertex_Format_SNorm_16x4,
+	HbGPU_Vertex_Format_SNorm_8x4,
+	HbGPU_Vertex_Format_UInt_32x1,
+	HbGPU_Vertex_Format_UInt_32x2,
+	HbGPU_Vertex_Format_UInt_32x3,
+	HbGPU_Vertex_Format_UInt_32x4,
+	HbGPU_Vertex_Format_UInt_16x2,
+	HbGPU_Vertex_Format_UInt_16x4,
+	HbGPU_Vertex_Format_UInt_10_10_10_2,
+	HbGPU_Vertex_Format_UInt_8x4,
+	HbGPU_Vertex_Format_SInt_32x1,
+	HbGPU_Vertex_Format_SInt_32x2,
+	HbGPU_Vertex_Format_SInt_32x3,
+	HbGPU_Vertex_Format_SInt_32x4,
+	HbGPU_Vertex_Format_SInt_16x2,
+	HbGPU_Vertex_Format_SInt_16x4,
+	HbGPU_Vertex_Format_SInt_8x4,
+} HbGPU_Vertex_Format;
+
+typedef struct HbGPU_Vertex_Attribute {
+	uint32_t streamIndex;
+	HbGPU_Vertex_Semantic semantic;
+	uint32_t semanticIndex;
+	HbGPU_Vertex_Format format;
+	uint32_t offsetInDwords;
+} HbGPU_Vertex_Attribute;
+
+typedef uint16_t HbGPU_Vertex_Index;
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -3,6 +3,96 @@
 #include "HbHash.h"
 #include "HbMemory.h"
 
+uint32_t HbHash_FNV1a_HashTextACaseless(char const * text) {
+	uint32_t hash = HbHash_FNV1a_Basis;
+	for (;;) {
+		if (!HbTextA_CanReadU8x16(text)) {
+			if (*text == '\0') {
+				return hash;
+			}
+			hash = HbHash_FNV1a_HashByte(hash, (uint8_t) HbTextA_CharToLower(*(text++)));
+			continue;
+		}
+		HbMath_U8x16 lower = HbTextA_CharsToLowerU8x16(HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) text));
+		uint32_t terminatorMask = (uint32_t) HbMath_U8x16_SignBits(HbMath_U8x16_CompareEqual(lower, HbMath_U8x16_LoadZero()));
+		uint8_t lowerBytes[16];
+		HbMath_U8x16_StoreUnaligned((HbMath_U8x16 *) lowerBytes, lower);
+		uint32_t length = (terminatorMask != 0 ? (uint32_t) HbBit_LowestOneU32(terminatorMask) : 16);
+		for (uint32_t characterIndex = 0; characterIndex < length; ++characterIndex) {
+			hash = HbHash_FNV1a_HashByte(hash, lowerBytes[characterIndex]);
+		}
+		if (terminatorMask != 0) {
+			return hash;
+		}
+		text += 16;
+	}
+}
+
+HbForceInline uint64_t HbHashi_XXH64_Read64(uint8_t const * data) {
+	uint64_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+HbForceInline uint32_t HbHashi_XXH64_Read32(uint8_t const * data) {
+	uint32_t value;
+	memcpy(&value, data, sizeof(value));
+	return value;
+}
+
+HbForceInline uint64_t HbHashi_XXH64_Round(uint64_t accumulator, uint64_t input) {
+	return HbBit_RotateLeftU64(accumulator + input * HbHash_XXH64_Prime2, 31) * HbHash_XXH64_Prime1;
+}
+
+HbForceInline uint64_t HbHashi_XXH64_MergeRound(uint64_t accumulator, uint64_t value) {
+	return (accumulator ^ HbHashi_XXH64_Round(0, value)) * HbHash_XXH64_Prime1 + HbHash_XXH64_Prime4;
+}
+
+uint64_t HbHash_XXH64_Hash(void const * data, size_t size, uint64_t seed) {
+	uint8_t const * bytes = (uint8_t const *) data, * end = bytes + size;
+	uint64_t hash;
+	if (size >= 32) {
+		uint64_t v1 = seed + HbHash_XXH64_Prime1 + HbHash_XXH64_Prime2, v2 = seed + HbHash_XXH64_Prime2;
+		uint64_t v3 = seed, v4 = seed - HbHash_XXH64_Prime1;
+		uint8_t const * stripesEnd = end - 32;
+		do {
+			v1 = HbHashi_XXH64_Round(v1, HbHashi_XXH64_Read64(bytes));
+			v2 = HbHashi_XXH64_Round(v2, HbHashi_XXH64_Read64(bytes + 8));
+			v3 = HbHashi_XXH64_Round(v3, HbHashi_XXH64_Read64(bytes + 16));
+			v4 = HbHashi_XXH64_Round(v4, HbHashi_XXH64_Read64(bytes + 24));
+			bytes += 32;
+		} while (bytes <= stripesEnd);
+		hash = HbBit_RotateLeftU64(v1, 1) + HbBit_RotateLeftU64(v2, 7) + HbBit_RotateLeftU64(v3, 12) + HbBit_RotateLeftU64(v4, 18);
+		hash = HbHashi_XXH64_MergeRound(hash, v1);
+		hash = HbHashi_XXH64_MergeRound(hash, v2);
+		hash = HbHashi_XXH64_MergeRound(hash, v3);
+		hash = HbHashi_XXH64_MergeRound(hash, v4);
+	} else {
+		hash = seed + HbHash_XXH64_Prime5;
+	}
+	hash += (uint64_t) size;
+	while (end - bytes >= 8) {
+		hash ^= HbHashi_XXH64_Round(0, HbHashi_XXH64_Read64(bytes));
+		hash = HbBit_RotateLeftU64(hash, 27) * HbHash_XXH64_Prime1 + HbHash_XXH64_Prime4;
+		bytes += 8;
+	}
+	if (end - bytes >= 4) {
+		hash ^= (uint64_t) HbHashi_XXH64_Read32(bytes) * HbHash_XXH64_Prime1;
+		hash = HbBit_RotateLeftU64(hash, 23) * HbHash_XXH64_Prime2 + HbHash_XXH64_Prime3;
+		bytes += 4;
+	}
+	while (bytes < end) {
+		hash ^= *(bytes++) * HbHash_XXH64_Prime5;
+		hash = HbBit_RotateLeftU64(hash, 11) * HbHash_XXH64_Prime1;
+	}
+	hash ^= hash >> 33;
+	hash *= HbHash_XXH64_Prime2;
+	hash ^= hash >> 29;
+	hash *= HbHash_XXH64_Prime3;
+	hash ^= hash >> 32;
+	return hash;
+}
+
 uint32_t HbHash_MapUtil_GetNeededEntriesLog2(uint32_t usedCount) {
 	if (usedCount == 0) {
 		return 0;
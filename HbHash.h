@@ -16,17 +16,12 @@ HbForceInline uint32_t HbHash_FNV1a_HashByte(uint32_t currentHash, uint8_t byte)
 inline uint32_t HbHash_FNV1a_HashTextA(char const * text) {
 	uint32_t hash = HbHash_FNV1a_Basis;
 	while (*text != '\0') {
-		HbHash_FNV1a_HashByte(hash, (uint8_t) *(text++));
-	}
-	return hash;
-}
-inline uint32_t HbHash_FNV1a_HashTextACaseless(char const * text) {
-	uint32_t hash = HbHash_FNV1a_Basis;
-	while (*text != '\0') {
-		HbHash_FNV1a_HashByte(hash, (uint8_t) HbTextA_CharToLower(*(text++)));
+		hash = HbHash_FNV1a_HashByte(hash, (uint8_t) *(text++));
 	}
 	return hash;
 }
+// Lowercases and finds the terminator in 16 characters at once.
+uint32_t HbHash_FNV1a_HashTextACaseless(char const * text);
 
 #define HbHash_FNV1a_CaseKey1(c0) \
 		((HbHash_FNV1a_Basis ^ (uint8_t) HbTextA_CharToLowerDefine(c0)) * HbHash_FNV1a_Prime)
@@ -65,6 +60,15 @@ inline uint32_t HbHash_FNV1a_HashTextACaseless(char const * text) {
 		((HbHash_FNV1a_CaseKey15(c0, c1, c2, c3, c4, c5, c6, c7, c8, c9, c10, c11, c12, c13, c14) ^ \
 				(uint8_t) HbTextA_CharToLowerDefine(c15)) * HbHash_FNV1a_Prime)
 
+// xxHash64 by Yann Collet, for checksums of file contents.
+// https://github.com/Cyan4973/xxHash/blob/dev/LICENSE
+#define HbHash_XXH64_Prime1 11400714785074694791ull
+#define HbHash_XXH64_Prime2 14029467366897019727ull
+#define HbHash_XXH64_Prime3 1609587929392839161ull
+#define HbHash_XXH64_Prime4 9650029242287828579ull
+#define HbHash_XXH64_Prime5 2870177450012600261ull
+uint64_t HbHash_XXH64_Hash(void const * data, size_t size, uint64_t seed);
+
 // !!!
 // Hash maps can be stored in files, if these are changed, files containing hash maps need to be updated too.
 // Storing can be done for both HbHash_Map instances and in-place hash maps that use HbHash_MapUtil.
@@ -0,0 +1,132 @@
+#ifndef HbInclude_HbImage
+#define HbInclude_HbImage
+#include "HbGPU_Image.h"
+#include "HbImage_BCDecode.h"
+#include "HbMemory.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * CPU processing of image data in HbGPU_Image_Format layouts, for tools and fallbacks when there's no GPU path.
+ * Rows of images and of 4x4 blocks are addressed with pitches in bytes, like in HbGPU_Image_Copy_MipLayout.
+ */
+
+/*************************************
+ * Decoding of 4x4-compressed formats
+ *************************************/
+
+// Blocks, rows of them and ranges of block rows are decoded by the functions in HbImage_BCDecode.h.
+
+// Decodes a whole mip with tightly packed blocks (like in DDS files), on up to threadCount threads (1 to decode on the calling thread only).
+#define HbImage_BC_DecodeMip_MaxThreads 16
+#define HbImage_BC_DecodeMip_MinBlockRowsPerThread 16
+void HbImage_BC_DecodeMip(HbGPU_Image_Format format, void const * source, uint32_t width, uint32_t height, uint32_t depth,
+		void * target, size_t targetRowPitch, size_t targetSlicePitch, uint32_t threadCount);
+
+/*************************************
+ * Encoding to 4x4-compressed formats
+ *************************************/
+
+// S3TC_A1 (with transparent black for texels with alpha below 128), S3TC_A8, 3Dc and BPTC UNorm/sRGB can be encoded,
+// from texels in the format returned by HbImage_BC_GetDecodedFormat. sRGB texels are encoded without conversion to linear.
+// Every quality includes what the lower ones do.
+typedef enum HbImage_BC_Quality {
+	// Endpoints at the extremes of the principal axis of the texels, only BPTC mode 6 (1 subset with alpha).
+	HbImage_BC_Quality_Fast,
+	// Least squares refinement of the endpoints from the selected indices, the 6-value 3Dc mode,
+	// 2-subset BPTC modes with the partition estimated to be the best, and BPTC with separate alpha for transparent blocks.
+	HbImage_BC_Quality_Normal,
+	// More refinement iterations, S3TC_A1 3-color mode for opaque blocks, endpoint search around the initial ones for 3Dc,
+	// more BPTC modes and partitions, and all BPTC alpha channel rotations.
+	HbImage_BC_Quality_High,
+} HbImage_BC_Quality;
+
+HbBool HbImage_BC_CanEncode(HbGPU_Image_Format format);
+void HbImage_BC_EncodeBlock(HbGPU_Image_Format format, HbImage_BC_Quality quality, void const * source, size_t sourceRowPitch, void * block);
+// Encodes a row of blocks from texelWidth texels in up to 4 rows, with the texels outside the source replaced with the nearest edge ones.
+void HbImage_BC_EncodeBlockRow(HbGPU_Image_Format format, HbImage_BC_Quality quality, void const * source,
+		uint32_t texelWidth, uint32_t texelRowCount, size_t sourceRowPitch, void * blocks);
+
+// Images are encoded on up to threadCount threads (including the calling one), taking chunks of block rows of any mip
+// of any layer one by one, so small mips don't leave threads idle.
+#define HbImage_BC_Encode_MaxThreads 64
+#define HbImage_BC_Encode_BlockRowsPerChunk 4
+typedef struct HbImage_BC_Encode_SourceMip {
+	void const * texels;
+	size_t rowPitch;
+	size_t slicePitch; // For 3D images.
+} HbImage_BC_Encode_SourceMip;
+// Writes tightly packed blocks of a single 2D or 3D mip.
+void HbImage_BC_EncodeMip(HbGPU_Image_Format format, HbImage_BC_Quality quality, HbImage_BC_Encode_SourceMip const * source,
+		uint32_t width, uint32_t height, uint32_t depth, void * target, uint32_t threadCount);
+// Writes the image data for a DDS file (HbFile_DDS_GetImageDataSize bytes) with info->format.
+// There are info->mips source mips for every array layer or cube side, in the same order as in DDS files.
+void HbImage_BC_EncodeImage(HbGPU_Image_Info const * info, HbImage_BC_Quality quality, HbImage_BC_Encode_SourceMip const * sourceMips,
+		void * target, uint32_t threadCount);
+// Returns the size of the whole DDS file, writing it if dds is not NULL.
+size_t HbImage_BC_EncodeDDS(HbGPU_Image_Info const * info, HbImage_BC_Quality quality, HbImage_BC_Encode_SourceMip const * sourceMips,
+		void * dds, uint32_t threadCount);
+
+/****************************
+ * Conversion of raw formats
+ ****************************/
+
+// Texels are converted through linear RGBA 32-bit floats, 4 per texel, in 16-byte-aligned rows:
+// - sRGB color is converted to and from linear, alpha is UNorm.
+// - Missing channels are loaded as 0 for green and blue and 1 for alpha, and extra channels are dropped when storing.
+// - Values are rounded to nearest (even for floats) and clamped to the range of normalized formats when storing, floats too large for the format
+//   become infinity, and NaN is stored as 0 in normalized formats.
+// Integer formats are not supported.
+HbBool HbImage_Raw_CanConvert(HbGPU_Image_Format format);
+void HbImage_Raw_LoadRow(HbGPU_Image_Format format, void const * source, uint32_t texelCount, float * rgba);
+void HbImage_Raw_StoreRow(HbGPU_Image_Format format, float const * rgba, uint32_t texelCount, void * target);
+// Converts texels in chunks on the stack. Rows in the same format are copied.
+#define HbImage_Raw_ConvertRow_ChunkTexels 64
+void HbImage_Raw_ConvertRow(HbGPU_Image_Format sourceFormat, void const * source, HbGPU_Image_Format targetFormat, void * target,
+		uint32_t texelCount);
+// Converts a whole mip, on up to threadCount threads (1 to convert on the calling thread only).
+#define HbImage_Raw_ConvertMip_MaxThreads 16
+#define HbImage_Raw_ConvertMip_MinRowsPerThread 32
+void HbImage_Raw_ConvertMip(HbGPU_Image_Format sourceFormat, void const * source, size_t sourceRowPitch, size_t sourceSlicePitch,
+		HbGPU_Image_Format targetFormat, void * target, size_t targetRowPitch, size_t targetSlicePitch,
+		uint32_t width, uint32_t height, uint32_t depth, uint32_t threadCount);
+
+/*****************
+ * Mip generation
+ *****************/
+
+typedef enum HbImage_Mip_Filter {
+	// Average of the source texels covered by the target texel, with partially covered ones weighted for odd sizes.
+	HbImage_Mip_Filter_Box,
+	// Kaiser-windowed sinc, sharper, but may cause ringing around hard edges.
+	HbImage_Mip_Filter_Kaiser,
+} HbImage_Mip_Filter;
+
+typedef struct HbImage_Mip_Options {
+	HbImage_Mip_Filter filter;
+	HbBool wrap; // Whether texels outside the edges are taken from the opposite edge (for tiling textures) rather than clamped.
+	// If above 0, alpha of every mip is scaled so the same fraction of the texels as in mip 0 has alpha above this value,
+	// keeping the coverage of alpha-tested surfaces in the distance.
+	float alphaCoverageReference;
+} HbImage_Mip_Options;
+
+typedef struct HbImage_Mip_Level {
+	void * texels;
+	size_t rowPitch;
+	size_t slicePitch; // For 3D images.
+} HbImage_Mip_Level;
+
+// Generates mips of an image in a format supported by HbImage_Raw_CanConvert, filtering in linear space (sRGB is converted).
+// There are info->mips levels for every array layer or cube side, in the same order as in DDS files - mip 0 is the source,
+// and every next mip is generated from the previous one after it's stored, on up to threadCount threads (including the calling one).
+// Row buffers and filter weights are allocated from tag.
+#define HbImage_Mip_Generate_MaxThreads 16
+#define HbImage_Mip_Generate_MinRowsPerThread 16
+void HbImage_Mip_Generate(HbGPU_Image_Info const * info, HbImage_Mip_Options const * options, HbImage_Mip_Level const * mips,
+		HbMemory_Tag * tag, uint32_t threadCount);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,761 @@
+#include "HbBit.h"
+#include "HbImage_BCDecode.h"
+#include "HbImagei_BC.h"
+#include "HbMath.h"
+
+/**********************************
+ * Tables and bit reading for BPTC
+ **********************************/
+
+uint16_t const HbImagei_BC_Partitions2[64] = {
+	0xCCCC, 0x8888, 0xEEEE, 0xECC8, 0xC880, 0xFEEC, 0xFEC8, 0xEC80, 0xC800, 0xFFEC, 0xFE80, 0xE800, 0xFFE8, 0xFF00, 0xFFF0, 0xF000,
+	0xF710, 0x008E, 0x7100, 0x08CE, 0x008C, 0x7310, 0x3100, 0x8CCE, 0x088C, 0x3110, 0x6666, 0x366C, 0x17E8, 0x0FF0, 0x718E, 0x399C,
+	0xAAAA, 0xF0F0, 0x5A5A, 0x33CC, 0x3C3C, 0x55AA, 0x9696, 0xA55A, 0x73CE, 0x13C8, 0x324C, 0x3BDC, 0x6996, 0xC33C, 0x9966, 0x0660,
+	0x0272, 0x04E4, 0x4E40, 0x2720, 0xC936, 0x936C, 0x39C6, 0x639C, 0x9336, 0x9CC6, 0x817E, 0xE718, 0xCCF0, 0x0FCC, 0x7744, 0xEE22,
+};
+
+uint32_t const HbImagei_BC_Partitions3[64] = {
+	0xAA685050, 0x6A5A5040, 0x5A5A4200, 0x5450A0A8, 0xA5A50000, 0xA0A05050, 0x5555A0A0, 0x5A5A5050,
+	0xAA550000, 0xAA555500, 0xAAAA5500, 0x90909090, 0x94949494, 0xA4A4A4A4, 0xA9A59450, 0x2A0A4250,
+	0xA5945040, 0x0A425054, 0xA5A5A500, 0x55A0A0A0, 0xA8A85454, 0x6A6A4040, 0xA4A45000, 0x1A1A0500,
+	0x0050A4A4, 0xAAA59090, 0x14696914, 0x69691400, 0xA08585A0, 0xAA821414, 0x50A4A450, 0x6A5A0200,
+	0xA9A58000, 0x5090A0A8, 0xA8A09050, 0x24242424, 0x00AA5500, 0x24924924, 0x24499224, 0x50A50A50,
+	0x500AA550, 0xAAAA4444, 0x66660000, 0xA5A0A5A0, 0x50A050A0, 0x69286928, 0x44AAAA44, 0x66666600,
+	0xAA444444, 0x54A854A8, 0x95809580, 0x96969600, 0xA85454A8, 0x80959580, 0xAA141414, 0x96960000,
+	0xAAAA1414, 0xA05050A0, 0xA0A5A5A0, 0x96000000, 0x40804080, 0xA9A8A9A8, 0xAAAAAA44, 0x2A4A5254,
+};
+
+uint8_t const HbImagei_BC_Anchors2Of2[64] = {
+	15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15,
+	15, 2, 8, 2, 2, 8, 8, 15, 2, 8, 2, 2, 8, 8, 2, 2,
+	15, 15, 6, 8, 2, 8, 15, 15, 2, 8, 2, 2, 2, 15, 15, 6,
+	6, 2, 6, 8, 15, 15, 2, 2, 15, 15, 15, 15, 15, 2, 2, 15,
+};
+
+uint8_t const HbImagei_BC_Anchors2Of3[64] = {
+	3, 3, 15, 15, 8, 3, 15, 15, 8, 8, 6, 6, 6, 5, 3, 3,
+	3, 3, 8, 15, 3, 3, 6, 10, 5, 8, 8, 6, 8, 5, 15, 15,
+	8, 15, 3, 5, 6, 10, 8, 15, 15, 3, 15, 5, 15, 15, 15, 15,
+	3, 15, 5, 5, 5, 8, 5, 10, 5, 10, 8, 13, 15, 12, 3, 3,
+};
+
+uint8_t const HbImagei_BC_Anchors3Of3[64] = {
+	15, 8, 8, 3, 15, 15, 3, 8, 15, 15, 15, 15, 15, 15, 15, 8,
+	15, 8, 15, 3, 15, 8, 15, 8, 3, 15, 6, 10, 15, 15, 10, 8,
+	15, 3, 15, 10, 10, 8, 9, 10, 6, 15, 8, 15, 3, 6, 6, 8,
+	15, 3, 15, 15, 15, 15, 15, 15, 15, 15, 15, 15, 3, 15, 15, 8,
+};
+
+uint8_t const HbImagei_BC_Weights2[4] = { 0, 21, 43, 64 };
+
+uint8_t const HbImagei_BC_Weights3[8] = { 0, 9, 18, 27, 37, 46, 55, 64 };
+
+uint8_t const HbImagei_BC_Weights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+uint8_t const * const HbImagei_BC_Weights[5] = { NULL, NULL, HbImagei_BC_Weights2, HbImagei_BC_Weights3, HbImagei_BC_Weights4 };
+
+HbImagei_BC_BPTC_Mode const HbImagei_BC_BPTC_Modes[8] = {
+	{ 3, 4, 0, 0, 4, 0, 1, 0, 3, 0 },
+	{ 2, 6, 0, 0, 6, 0, 0, 1, 3, 0 },
+	{ 3, 6, 0, 0, 5, 0, 0, 0, 2, 0 },
+	{ 2, 6, 0, 0, 7, 0, 1, 0, 2, 0 },
+	{ 1, 0, 2, 1, 5, 6, 0, 0, 2, 3 },
+	{ 1, 0, 2, 0, 7, 8, 0, 0, 2, 2 },
+	{ 1, 0, 0, 0, 7, 7, 1, 0, 4, 0 },
+	{ 2, 6, 0, 0, 5, 5, 1, 0, 2, 0 },
+};
+
+// Blocks are read from the lowest bit of the first byte.
+typedef struct HbImage_BCi_Bits {
+	uint64_t low;
+	uint64_t high;
+	uint32_t position;
+} HbImage_BCi_Bits;
+
+HbForceInline void HbImage_BCi_Bits_Init(HbImage_BCi_Bits * bits, void const * block) {
+	memcpy(&bits->low, block, sizeof(uint64_t));
+	memcpy(&bits->high, (uint8_t const *) block + sizeof(uint64_t), sizeof(uint64_t));
+	bits->position = 0;
+}
+
+// The next 64 bits, with zeros past the end of the block, without advancing.
+HbForceInline uint64_t HbImage_BCi_Bits_Peek64(HbImage_BCi_Bits const * bits) {
+	uint32_t position = bits->position;
+	if (position >= 64) {
+		return bits->high >> (position - 64);
+	}
+	uint64_t value = bits->low >> position;
+	if (position != 0) {
+		value |= bits->high << (64 - position);
+	}
+	return value;
+}
+
+// Up to 32 bits.
+HbForceInline uint32_t HbImage_BCi_Bits_Read(HbImage_BCi_Bits * bits, uint32_t count) {
+	uint32_t value = (uint32_t) HbImage_BCi_Bits_Peek64(bits) & (uint32_t) ((1ull << count) - 1);
+	bits->position += count;
+	return value;
+}
+
+// The indices of all texels of a BPTC block take up to 63 bits, so they're extracted from one window rather than read one by one.
+// Anchor texels (bits in anchorTexels) have one bit less.
+HbForceInline void HbImage_BCi_Bits_ReadIndices(HbImage_BCi_Bits * bits, uint32_t indexBits, uint32_t anchorTexels, uint8_t indices[16]) {
+	uint64_t window = HbImage_BCi_Bits_Peek64(bits);
+	uint32_t windowBits = 0;
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t texelIndexBits = indexBits - ((anchorTexels >> texel) & 1);
+		indices[texel] = (uint8_t) ((window >> windowBits) & ((1u << texelIndexBits) - 1));
+		windowBits += texelIndexBits;
+	}
+	bits->position += windowBits;
+}
+
+// Anchor texels of the partition as a mask, and the subsets of the texels in 2 bits each.
+static void HbImage_BCi_BPTC_GetPartition(uint32_t subsetCount, uint32_t partition, uint32_t * anchorTexels, uint32_t * subsets) {
+	if (subsetCount == 2) {
+		*anchorTexels = 1 | (1u << HbImagei_BC_Anchors2Of2[partition]);
+		// Spreading the 1-bit subsets to every other bit.
+		uint32_t spread = HbImagei_BC_Partitions2[partition];
+		spread = (spread | (spread << 8)) & 0x00FF00FFu;
+		spread = (spread | (spread << 4)) & 0x0F0F0F0Fu;
+		spread = (spread | (spread << 2)) & 0x33333333u;
+		*subsets = (spread | (spread << 1)) & 0x55555555u;
+	} else if (subsetCount == 3) {
+		*anchorTexels = 1 | (1u << HbImagei_BC_Anchors2Of3[partition]) | (1u << HbImagei_BC_Anchors3Of3[partition]);
+		*subsets = HbImagei_BC_Partitions3[partition];
+	} else {
+		*anchorTexels = 1;
+		*subsets = 0;
+	}
+}
+
+/***************
+ * S3TC and 3Dc
+ ***************/
+
+// The 2-bit indices are selected from the palette with comparisons against all 4 values of every texel in a row.
+static uint32_t const HbImage_BCi_S3TC_IndexValues[4][4] = {
+	{ 0, 0, 0, 0 },
+	{ 1, 1 << 2, 1 << 4, 1 << 6 },
+	{ 2, 2 << 2, 2 << 4, 2 << 6 },
+	{ 3, 3 << 2, 3 << 4, 3 << 6 },
+};
+
+// alphas (16 values, or NULL for opaque or punch-through colors) replace the alpha of the palette colors.
+static void HbImage_BCi_S3TC_DecodeColor(uint8_t const * block, HbBool allowPunchThrough, uint8_t const * alphas,
+		uint8_t * target, size_t targetRowPitch) {
+	uint32_t color0 = block[0] | ((uint32_t) block[1] << 8), color1 = block[2] | ((uint32_t) block[3] << 8);
+	uint32_t palette[4];
+	HbImagei_BC_S3TC_GetPalette(color0, color1, allowPunchThrough, palette);
+	HbMath_U32x4 palette0 = HbMath_U32x4_LoadReplicated(palette[0]);
+	HbMath_U32x4 palette1 = HbMath_U32x4_LoadReplicated(palette[1]);
+	HbMath_U32x4 palette2 = HbMath_U32x4_LoadReplicated(palette[2]);
+	HbMath_U32x4 palette3 = HbMath_U32x4_LoadReplicated(palette[3]);
+	HbMath_U32x4 indexValues1 = HbMath_U32x4_LoadUnaligned((HbMath_U32x4 const *) HbImage_BCi_S3TC_IndexValues[1]);
+	HbMath_U32x4 indexValues2 = HbMath_U32x4_LoadUnaligned((HbMath_U32x4 const *) HbImage_BCi_S3TC_IndexValues[2]);
+	HbMath_U32x4 indexMask = HbMath_U32x4_LoadUnaligned((HbMath_U32x4 const *) HbImage_BCi_S3TC_IndexValues[3]);
+	HbMath_U32x4 zero = HbMath_U32x4_LoadZero();
+	// Alphas of rows in the highest bytes of 32-bit lanes.
+	HbMath_U32x4 alphaRows[4];
+	HbMath_U32x4 colorMask = HbMath_U32x4_LoadReplicated(alphas != NULL ? 0x00FFFFFFu : 0xFFFFFFFFu);
+	if (alphas != NULL) {
+		HbMath_U8x16 alphaVector = HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) alphas);
+		HbMath_U16x8 alphas01 = HbMath_U8x16_InterleaveLower(zero, alphaVector);
+		HbMath_U16x8 alphas23 = HbMath_U8x16_InterleaveUpper(zero, alphaVector);
+		alphaRows[0] = HbMath_U16x8_InterleaveLower(zero, alphas01);
+		alphaRows[1] = HbMath_U16x8_InterleaveUpper(zero, alphas01);
+		alphaRows[2] = HbMath_U16x8_InterleaveLower(zero, alphas23);
+		alphaRows[3] = HbMath_U16x8_InterleaveUpper(zero, alphas23);
+	} else {
+		alphaRows[0] = alphaRows[1] = alphaRows[2] = alphaRows[3] = zero;
+	}
+	for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+		HbMath_U32x4 indices = HbMath_U32x4_And(HbMath_U32x4_LoadReplicated(block[4 + rowIndex]), indexMask);
+		HbMath_U32x4 row = HbMath_U32x4_Or(
+				HbMath_U32x4_Or(
+						HbMath_U32x4_And(HbMath_U32x4_CompareEqual(indices, zero), palette0),
+						HbMath_U32x4_And(HbMath_U32x4_CompareEqual(indices, indexValues1), palette1)),
+				HbMath_U32x4_Or(
+						HbMath_U32x4_And(HbMath_U32x4_CompareEqual(indices, indexValues2), palette2),
+						HbMath_U32x4_And(HbMath_U32x4_CompareEqual(indices, indexMask), palette3)));
+		row = HbMath_U32x4_Or(HbMath_U32x4_And(row, colorMask), alphaRows[rowIndex]);
+		HbMath_U32x4_StoreUnaligned((HbMath_U32x4 *) (target + rowIndex * targetRowPitch), row);
+	}
+}
+
+static void HbImage_BCi_S3TC_DecodeExplicitAlpha(uint8_t const * block, uint8_t * alphas) {
+	for (uint32_t texel = 0; texel < 16; texel += 2) {
+		uint8_t alphaPair = block[texel >> 1];
+		alphas[texel] = (alphaPair & 15) * 17;
+		alphas[texel + 1] = (alphaPair >> 4) * 17;
+	}
+}
+
+HbForceInline uint64_t HbImage_BCi_3Dc_LoadIndices(uint8_t const * block) {
+	uint64_t indices = 0;
+	memcpy(&indices, block + 2, 6);
+	return indices;
+}
+
+// Also used for S3TC_A8 alpha.
+static void HbImage_BCi_3Dc_DecodeUNorm(uint8_t const * block, uint8_t * values) {
+	uint8_t palette[8];
+	HbImagei_BC_3Dc_GetPaletteUNorm(block[0], block[1], palette);
+	uint64_t indices = HbImage_BCi_3Dc_LoadIndices(block);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		values[texel] = palette[(indices >> (texel * 3)) & 7];
+	}
+}
+
+static void HbImage_BCi_3Dc_DecodeSNorm(uint8_t const * block, int8_t * values) {
+	int8_t palette[8];
+	HbImagei_BC_3Dc_GetPaletteSNorm((int8_t) block[0], (int8_t) block[1], palette);
+	uint64_t indices = HbImage_BCi_3Dc_LoadIndices(block);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		values[texel] = palette[(indices >> (texel * 3)) & 7];
+	}
+}
+
+/******************
+ * BPTC UNorm/sRGB
+ ******************/
+
+// RGBA8 (in the lowest to the highest byte) of all indices of the subset, in 16 bits for 2 entries at once.
+static void HbImage_BCi_BPTC_GetPalette(uint32_t const endpoint0[4], uint32_t const endpoint1[4], uint32_t indexBits,
+		uint32_t palette[16]) {
+	HbMath_U32x4 endpoint0Vector = HbMath_U32x4_LoadUnaligned((HbMath_U32x4 const *) endpoint0);
+	HbMath_U32x4 endpoint1Vector = HbMath_U32x4_LoadUnaligned((HbMath_U32x4 const *) endpoint1);
+	HbMath_U16x8 endpoints0 = HbMath_S32x4_PackToS16x8(endpoint0Vector, endpoint0Vector);
+	HbMath_U16x8 endpoints1 = HbMath_S32x4_PackToS16x8(endpoint1Vector, endpoint1Vector);
+	HbMath_U16x8 weightMax = HbMath_U16x8_LoadReplicated(64), rounding = HbMath_U16x8_LoadReplicated(32);
+	uint8_t const * weights = HbImagei_BC_Weights[indexBits];
+	for (uint32_t entryIndex = 0; entryIndex < (1u << indexBits); entryIndex += 4) {
+		HbMath_U16x8 entries[2];
+		for (uint32_t pairIndex = 0; pairIndex < 2; ++pairIndex) {
+			HbMath_U16x8 pairWeights = HbMath_U32x4_CombineXYXY(
+					HbMath_U16x8_LoadReplicated(weights[entryIndex + pairIndex * 2]),
+					HbMath_U16x8_LoadReplicated(weights[entryIndex + pairIndex * 2 + 1]));
+			// (64 - weight) * endpoint0 + weight * endpoint1 + 32 is up to 16352.
+			entries[pairIndex] = HbMath_U16x8_ShiftRight(HbMath_U16x8_Add(HbMath_U16x8_Add(
+					HbMath_U16x8_MultiplyLow(endpoints0, HbMath_U16x8_Subtract(weightMax, pairWeights)),
+					HbMath_U16x8_MultiplyLow(endpoints1, pairWeights)), rounding), 6);
+		}
+		HbMath_U8x16_StoreUnaligned((HbMath_U8x16 *) &palette[entryIndex], HbMath_U16x8_PackToU8x16(entries[0], entries[1]));
+	}
+}
+
+static void HbImage_BCi_BPTC_DecodeUNorm(uint8_t const * block, uint8_t * target, size_t targetRowPitch) {
+	int32_t modeIndex = HbBit_LowestOneU32(block[0]);
+	if (modeIndex < 0) {
+		for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+			memset(target + rowIndex * targetRowPitch, 0, 4 * 4);
+		}
+		return;
+	}
+	HbImagei_BC_BPTC_Mode const * mode = &HbImagei_BC_BPTC_Modes[modeIndex];
+	HbImage_BCi_Bits bits;
+	HbImage_BCi_Bits_Init(&bits, block);
+	bits.position = (uint32_t) modeIndex + 1;
+	uint32_t partition = HbImage_BCi_Bits_Read(&bits, mode->partitionBits);
+	uint32_t rotation = HbImage_BCi_Bits_Read(&bits, mode->rotationBits);
+	uint32_t indexSelection = HbImage_BCi_Bits_Read(&bits, mode->indexSelectionBits);
+
+	// Subset N has endpoints 2N and 2N+1, channels are stored for all endpoints, then P-bits.
+	// The loops are over all 6 endpoints (with 0 bits read for the missing ones) so they don't depend on the mode, which is
+	// mispredicted when it changes between blocks.
+	uint32_t endpointCount = mode->subsetCount * 2;
+	uint32_t endpoints[6][4];
+	for (uint32_t channel = 0; channel < 4; ++channel) {
+		uint32_t channelBits = channel < 3 ? mode->colorBits : mode->alphaBits;
+		for (uint32_t endpointIndex = 0; endpointIndex < 6; ++endpointIndex) {
+			endpoints[endpointIndex][channel] = HbImage_BCi_Bits_Read(&bits, endpointIndex < endpointCount ? channelBits : 0);
+		}
+	}
+	uint32_t hasPBits = mode->endpointPBits | mode->sharedPBits;
+	uint32_t pBits = HbImage_BCi_Bits_Read(&bits, mode->endpointPBits * endpointCount + mode->sharedPBits * mode->subsetCount);
+	uint32_t colorBits = mode->colorBits + hasPBits, alphaBits = mode->alphaBits + (hasPBits & (mode->alphaBits != 0));
+	for (uint32_t endpointIndex = 0; endpointIndex < 6; ++endpointIndex) {
+		uint32_t * endpoint = endpoints[endpointIndex];
+		uint32_t pBit = (pBits >> (endpointIndex >> mode->sharedPBits)) & hasPBits;
+		for (uint32_t channel = 0; channel < 4; ++channel) {
+			endpoint[channel] = (endpoint[channel] << hasPBits) | pBit;
+		}
+		for (uint32_t channel = 0; channel < 3; ++channel) {
+			endpoint[channel] = (endpoint[channel] << (8 - colorBits)) | (endpoint[channel] >> (2 * colorBits - 8));
+		}
+		endpoint[3] = alphaBits != 0 ? (endpoint[3] << (8 - alphaBits)) | (endpoint[3] >> (2 * alphaBits - 8)) : 255;
+	}
+
+	uint32_t anchorTexels, subsets;
+	HbImage_BCi_BPTC_GetPartition(mode->subsetCount, partition, &anchorTexels, &subsets);
+	uint8_t indices[16], secondaryIndices[16];
+	HbImage_BCi_Bits_ReadIndices(&bits, mode->indexBits, anchorTexels, indices);
+	if (mode->secondaryIndexBits != 0) {
+		HbImage_BCi_Bits_ReadIndices(&bits, mode->secondaryIndexBits, 1, secondaryIndices);
+	}
+
+	uint32_t colorIndexBits = mode->indexBits, alphaIndexBits = mode->indexBits;
+	uint8_t const * colorIndices = indices, * alphaIndices = indices;
+	if (mode->secondaryIndexBits != 0) {
+		if (indexSelection) {
+			colorIndexBits = mode->secondaryIndexBits;
+			colorIndices = secondaryIndices;
+		} else {
+			alphaIndexBits = mode->secondaryIndexBits;
+			alphaIndices = secondaryIndices;
+		}
+	}
+	// Interpolating the palettes of the subsets rather than the texels, as there are as many texels as entries in a palette.
+	// With separate alpha indices, alpha is taken from its own palette.
+	uint32_t colorPalettes[3][16], secondaryPalettes[1][16];
+	uint32_t (* alphaPalettes)[16] = colorPalettes;
+	for (uint32_t subset = 0; subset < mode->subsetCount; ++subset) {
+		HbImage_BCi_BPTC_GetPalette(endpoints[subset * 2], endpoints[subset * 2 + 1], colorIndexBits, colorPalettes[subset]);
+	}
+	if (mode->secondaryIndexBits != 0) {
+		// Only in modes with 1 subset.
+		HbImage_BCi_BPTC_GetPalette(endpoints[0], endpoints[1], alphaIndexBits, secondaryPalettes[0]);
+		alphaPalettes = secondaryPalettes;
+	}
+	// Without rotation, alpha is swapped with itself.
+	uint32_t rotatedShift = 8 * ((rotation - 1) & 3);
+	uint32_t texelColors[16];
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t subset = (subsets >> (texel * 2)) & 3;
+		uint32_t texelColor = (colorPalettes[subset][colorIndices[texel]] & 0x00FFFFFFu) |
+				(alphaPalettes[subset][alphaIndices[texel]] & 0xFF000000u);
+		uint32_t rotated = (texelColor >> rotatedShift) & 0xFF;
+		texelColors[texel] = (texelColor & ~(0xFF000000u | (0xFFu << rotatedShift))) | ((texelColor >> 24) << rotatedShift) | (rotated << 24);
+	}
+	for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+		memcpy(target + rowIndex * targetRowPitch, &texelColors[rowIndex * 4], 4 * sizeof(uint32_t));
+	}
+}
+
+/*************
+ * BPTC float
+ *************/
+
+// Endpoints are R0-R3 (only R0 and R1 with one subset), with the delta-coded bits of the endpoints and the partition scattered in the header.
+enum {
+	HbImage_BCi_BPTCFloat_R0, HbImage_BCi_BPTCFloat_G0, HbImage_BCi_BPTCFloat_B0,
+	HbImage_BCi_BPTCFloat_R1, HbImage_BCi_BPTCFloat_G1, HbImage_BCi_BPTCFloat_B1,
+	HbImage_BCi_BPTCFloat_R2, HbImage_BCi_BPTCFloat_G2, HbImage_BCi_BPTCFloat_B2,
+	HbImage_BCi_BPTCFloat_R3, HbImage_BCi_BPTCFloat_G3, HbImage_BCi_BPTCFloat_B3,
+};
+
+// Bits of a component stored contiguously, from firstBit to lastBit (which is lower for the reversed high bits in some modes).
+typedef struct HbImage_BCi_BPTCFloat_Segment {
+	uint8_t component; // Endpoint * 3 + channel.
+	uint8_t firstBit;
+	uint8_t lastBit;
+} HbImage_BCi_BPTCFloat_Segment;
+
+typedef struct HbImage_BCi_BPTCFloat_Mode {
+	uint8_t subsetCount;
+	uint8_t endpointBits;
+	uint8_t deltaBits[3]; // Same as endpointBits if not transformed.
+	HbBool transformed; // Whether the endpoints other than the first are deltas.
+	uint8_t segmentCount;
+	HbImage_BCi_BPTCFloat_Segment segments[23];
+} HbImage_BCi_BPTCFloat_Mode;
+
+// Header bits following the mode bits, in the order of the modes in the specification.
+#define R0 HbImage_BCi_BPTCFloat_R0
+#define G0 HbImage_BCi_BPTCFloat_G0
+#define B0 HbImage_BCi_BPTCFloat_B0
+#define R1 HbImage_BCi_BPTCFloat_R1
+#define G1 HbImage_BCi_BPTCFloat_G1
+#define B1 HbImage_BCi_BPTCFloat_B1
+#define R2 HbImage_BCi_BPTCFloat_R2
+#define G2 HbImage_BCi_BPTCFloat_G2
+#define B2 HbImage_BCi_BPTCFloat_B2
+#define R3 HbImage_BCi_BPTCFloat_R3
+#define G3 HbImage_BCi_BPTCFloat_G3
+#define B3 HbImage_BCi_BPTCFloat_B3
+static HbImage_BCi_BPTCFloat_Mode const HbImage_BCi_BPTCFloat_Modes[14] = {
+	// Mode 1, 0x00.
+	{ 2, 10, { 5, 5, 5 }, HbTrue, 19, {
+		{ G2, 4, 4 }, { B2, 4, 4 }, { B3, 4, 4 }, { R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 4 }, { G3, 4, 4 },
+		{ G2, 0, 3 }, { G1, 0, 4 }, { B3, 0, 0 }, { G3, 0, 3 }, { B1, 0, 4 }, { B3, 1, 1 }, { B2, 0, 3 }, { R2, 0, 4 },
+		{ B3, 2, 2 }, { R3, 0, 4 }, { B3, 3, 3 },
+	} },
+	// Mode 2, 0x01.
+	{ 2, 7, { 6, 6, 6 }, HbTrue, 23, {
+		{ G2, 5, 5 }, { G3, 4, 4 }, { G3, 5, 5 }, { R0, 0, 6 }, { B3, 0, 0 }, { B3, 1, 1 }, { B2, 4, 4 }, { G0, 0, 6 },
+		{ B2, 5, 5 }, { B3, 2, 2 }, { G2, 4, 4 }, { B0, 0, 6 }, { B3, 3, 3 }, { B3, 5, 5 }, { B3, 4, 4 }, { R1, 0, 5 },
+		{ G2, 0, 3 }, { G1, 0, 5 }, { G3, 0, 3 }, { B1, 0, 5 }, { B2, 0, 3 }, { R2, 0, 5 }, { R3, 0, 5 },
+	} },
+	// Mode 3, 0x02.
+	{ 2, 11, { 5, 4, 4 }, HbTrue, 18, {
+		{ R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 4 }, { R0, 10, 10 }, { G2, 0, 3 }, { G1, 0, 3 }, { G0, 10, 10 },
+		{ B3, 0, 0 }, { G3, 0, 3 }, { B1, 0, 3 }, { B0, 10, 10 }, { B3, 1, 1 }, { B2, 0, 3 }, { R2, 0, 4 }, { B3, 2, 2 },
+		{ R3, 0, 4 }, { B3, 3, 3 },
+	} },
+	// Mode 4, 0x06.
+	{ 2, 11, { 4, 5, 4 }, HbTrue, 20, {
+		{ R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 3 }, { R0, 10, 10 }, { G3, 4, 4 }, { G2, 0, 3 }, { G1, 0, 4 },
+		{ G0, 10, 10 }, { G3, 0, 3 }, { B1, 0, 3 }, { B0, 10, 10 }, { B3, 1, 1 }, { B2, 0, 3 }, { R2, 0, 3 }, { B3, 0, 0 },
+		{ B3, 2, 2 }, { R3, 0, 3 }, { G2, 4, 4 }, { B3, 3, 3 },
+	} },
+	// Mode 5, 0x0A.
+	{ 2, 11, { 4, 4, 5 }, HbTrue, 20, {
+		{ R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 3 }, { R0, 10, 10 }, { B2, 4, 4 }, { G2, 0, 3 }, { G1, 0, 3 },
+		{ G0, 10, 10 }, { B3, 0, 0 }, { G3, 0, 3 }, { B1, 0, 4 }, { B0, 10, 10 }, { B2, 0, 3 }, { R2, 0, 3 }, { B3, 1, 1 },
+		{ B3, 2, 2 }, { R3, 0, 3 }, { B3, 4, 4 }, { B3, 3, 3 },
+	} },
+	// Mode 6, 0x0E.
+	{ 2, 9, { 5, 5, 5 }, HbTrue, 19, {
+		{ R0, 0, 8 }, { B2, 4, 4 }, { G0, 0, 8 }, { G2, 4, 4 }, { B0, 0, 8 }, { B3, 4, 4 }, { R1, 0, 4 }, { G3, 4, 4 },
+		{ G2, 0, 3 }, { G1, 0, 4 }, { B3, 0, 0 }, { G3, 0, 3 }, { B1, 0, 4 }, { B3, 1, 1 }, { B2, 0, 3 }, { R2, 0, 4 },
+		{ B3, 2, 2 }, { R3, 0, 4 }, { B3, 3, 3 },
+	} },
+	// Mode 7, 0x12.
+	{ 2, 8, { 6, 5, 5 }, HbTrue, 19, {
+		{ R0, 0, 7 }, { G3, 4, 4 }, { B2, 4, 4 }, { G0, 0, 7 }, { B3, 2, 2 }, { G2, 4, 4 }, { B0, 0, 7 }, { B3, 3, 3 },
+		{ B3, 4, 4 }, { R1, 0, 5 }, { G2, 0, 3 }, { G1, 0, 4 }, { B3, 0, 0 }, { G3, 0, 3 }, { B1, 0, 4 }, { B3, 1, 1 },
+		{ B2, 0, 3 }, { R2, 0, 5 }, { R3, 0, 5 },
+	} },
+	// Mode 8, 0x16.
+	{ 2, 8, { 5, 6, 5 }, HbTrue, 21, {
+		{ R0, 0, 7 }, { B3, 0, 0 }, { B2, 4, 4 }, { G0, 0, 7 }, { G2, 5, 5 }, { G2, 4, 4 }, { B0, 0, 7 }, { G3, 5, 5 },
+		{ B3, 4, 4 }, { R1, 0, 4 }, { G3, 4, 4 }, { G2, 0, 3 }, { G1, 0, 5 }, { G3, 0, 3 }, { B1, 0, 4 }, { B3, 1, 1 },
+		{ B2, 0, 3 }, { R2, 0, 4 }, { B3, 2, 2 }, { R3, 0, 4 }, { B3, 3, 3 },
+	} },
+	// Mode 9, 0x1A.
+	{ 2, 8, { 5, 5, 6 }, HbTrue, 21, {
+		{ R0, 0, 7 }, { B3, 1, 1 }, { B2, 4, 4 }, { G0, 0, 7 }, { B2, 5, 5 }, { G2, 4, 4 }, { B0, 0, 7 }, { B3, 5, 5 },
+		{ B3, 4, 4 }, { R1, 0, 4 }, { G3, 4, 4 }, { G2, 0, 3 }, { G1, 0, 4 }, { B3, 0, 0 }, { G3, 0, 3 }, { B1, 0, 5 },
+		{ B2, 0, 3 }, { R2, 0, 4 }, { B3, 2, 2 }, { R3, 0, 4 }, { B3, 3, 3 },
+	} },
+	// Mode 10, 0x1E.
+	{ 2, 6, { 6, 6, 6 }, HbFalse, 23, {
+		{ R0, 0, 5 }, { G3, 4, 4 }, { B3, 0, 0 }, { B3, 1, 1 }, { B2, 4, 4 }, { G0, 0, 5 }, { G2, 5, 5 }, { B2, 5, 5 },
+		{ B3, 2, 2 }, { G2, 4, 4 }, { B0, 0, 5 }, { G3, 5, 5 }, { B3, 3, 3 }, { B3, 5, 5 }, { B3, 4, 4 }, { R1, 0, 5 },
+		{ G2, 0, 3 }, { G1, 0, 5 }, { G3, 0, 3 }, { B1, 0, 5 }, { B2, 0, 3 }, { R2, 0, 5 }, { R3, 0, 5 },
+	} },
+	// Mode 11, 0x03.
+	{ 1, 10, { 10, 10, 10 }, HbFalse, 6, {
+		{ R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 9 }, { G1, 0, 9 }, { B1, 0, 9 },
+	} },
+	// Mode 12, 0x07.
+	{ 1, 11, { 9, 9, 9 }, HbTrue, 9, {
+		{ R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 8 }, { R0, 10, 10 }, { G1, 0, 8 }, { G0, 10, 10 }, { B1, 0, 8 },
+		{ B0, 10, 10 },
+	} },
+	// Mode 13, 0x0B.
+	{ 1, 12, { 8, 8, 8 }, HbTrue, 9, {
+		{ R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 7 }, { R0, 11, 10 }, { G1, 0, 7 }, { G0, 11, 10 }, { B1, 0, 7 },
+		{ B0, 11, 10 },
+	} },
+	// Mode 14, 0x0F.
+	{ 1, 16, { 4, 4, 4 }, HbTrue, 9, {
+		{ R0, 0, 9 }, { G0, 0, 9 }, { B0, 0, 9 }, { R1, 0, 3 }, { R0, 15, 10 }, { G1, 0, 3 }, { G0, 15, 10 }, { B1, 0, 3 },
+		{ B0, 15, 10 },
+	} },
+};
+#undef R0
+#undef G0
+#undef B0
+#undef R1
+#undef G1
+#undef B1
+#undef R2
+#undef G2
+#undef B2
+#undef R3
+#undef G3
+#undef B3
+
+// Indexed by the 5 mode bits (with only the lower 2 used if they're 0 or 1), -1 for reserved modes.
+static int8_t const HbImage_BCi_BPTCFloat_ModeIndices[32] = {
+	0, 1, 2, 10, 0, 1, 3, 11, 0, 1, 4, 12, 0, 1, 5, 13,
+	0, 1, 6, -1, 0, 1, 7, -1, 0, 1, 8, -1, 0, 1, 9, -1,
+};
+
+HbForceInline int32_t HbImage_BCi_BPTCFloat_SignExtend(uint32_t value, uint32_t bits) {
+	uint32_t signBit = (uint32_t) 1 << (bits - 1);
+	return (int32_t) ((value ^ signBit) - signBit);
+}
+
+static int32_t HbImage_BCi_BPTCFloat_Unquantize(int32_t value, uint32_t bits, HbBool isSigned) {
+	if (!isSigned) {
+		if (bits >= 15 || value == 0) {
+			return value;
+		}
+		if (value == (1 << bits) - 1) {
+			return 0xFFFF;
+		}
+		return ((value << 16) + 0x8000) >> bits;
+	}
+	if (bits >= 16) {
+		return value;
+	}
+	HbBool isNegative = value < 0;
+	int32_t magnitude = isNegative ? -value : value;
+	int32_t unquantized;
+	if (magnitude == 0) {
+		unquantized = 0;
+	} else if (magnitude >= (1 << (bits - 1)) - 1) {
+		unquantized = 0x7FFF;
+	} else {
+		unquantized = ((magnitude << 15) + 0x4000) >> (bits - 1);
+	}
+	return isNegative ? -unquantized : unquantized;
+}
+
+// Half-precision RGBA (with alpha of 1.0) of all indices of the subset, 2 entries at once. The interpolation is done in 32 bits via the
+// sums of the products of 16-bit pairs, with the unsigned endpoints biased to the signed range, and the interpolated values are converted
+// to the bits of half-precision floats.
+static void HbImage_BCi_BPTCFloat_GetPalette(int32_t const endpoint0[3], int32_t const endpoint1[3], uint32_t indexBits, HbBool isSigned,
+		uint64_t palette[16]) {
+	int32_t bias = isSigned ? 0 : 0x8000;
+	HbMath_S32x4 endpoint0Vector = HbMath_S32x4_LoadXYZW(endpoint0[0] - bias, endpoint0[1] - bias, endpoint0[2] - bias, -bias);
+	HbMath_S32x4 endpoint1Vector = HbMath_S32x4_LoadXYZW(endpoint1[0] - bias, endpoint1[1] - bias, endpoint1[2] - bias, -bias);
+	HbMath_U16x8 endpointPairs = HbMath_U16x8_InterleaveLower(
+			HbMath_S32x4_PackToS16x8(endpoint0Vector, endpoint0Vector), HbMath_S32x4_PackToS16x8(endpoint1Vector, endpoint1Vector));
+	HbMath_S32x4 unbiasAndRounding = HbMath_S32x4_LoadReplicated(64 * bias + 32);
+	// The alpha lanes are interpolated to 0.
+	HbMath_S32x4 alpha = HbMath_S32x4_LoadXYZW(0, 0, 0, 0x3C00);
+	HbMath_S32x4 negativeBits = HbMath_S32x4_LoadReplicated((int32_t) 0xFFFF8000u);
+	uint8_t const * weights = HbImagei_BC_Weights[indexBits];
+	for (uint32_t entryIndex = 0; entryIndex < (1u << indexBits); entryIndex += 2) {
+		HbMath_S32x4 entries[2];
+		for (uint32_t pairIndex = 0; pairIndex < 2; ++pairIndex) {
+			uint32_t weight = weights[entryIndex + pairIndex];
+			HbMath_S32x4 value = HbMath_S32x4_ShiftRight(HbMath_S32x4_Add(HbMath_S16x8_MultiplyAddPairs(endpointPairs,
+					HbMath_U32x4_LoadReplicated((weight << 16) | (64 - weight))), unbiasAndRounding), 6);
+			if (isSigned) {
+				// Sign and magnitude, with the sign bit in the signed 16-bit range (0x8000 | magnitude as a negative number) for packing.
+				HbMath_S32x4 sign = HbMath_S32x4_ShiftRight(value, 31);
+				HbMath_S32x4 magnitude = HbMath_S32x4_Subtract(HbMath_S32x4_Xor(value, sign), sign);
+				value = HbMath_S32x4_Or(
+						HbMath_S32x4_ShiftRight(HbMath_S32x4_Subtract(HbMath_S32x4_ShiftLeft(magnitude, 5), magnitude), 5),
+						HbMath_S32x4_And(sign, negativeBits));
+			} else {
+				value = HbMath_S32x4_ShiftRight(HbMath_S32x4_Subtract(HbMath_S32x4_ShiftLeft(value, 5), value), 6);
+			}
+			entries[pairIndex] = HbMath_S32x4_Or(value, alpha);
+		}
+		HbMath_U16x8_StoreUnaligned((HbMath_U16x8 *) &palette[entryIndex], HbMath_S32x4_PackToS16x8(entries[0], entries[1]));
+	}
+}
+
+static void HbImage_BCi_BPTCFloat_Decode(uint8_t const * block, HbBool isSigned, uint8_t * target, size_t targetRowPitch) {
+	HbImage_BCi_Bits bits;
+	HbImage_BCi_Bits_Init(&bits, block);
+	uint32_t modeBits = HbImage_BCi_Bits_Read(&bits, 2);
+	if (modeBits >= 2) {
+		modeBits |= HbImage_BCi_Bits_Read(&bits, 3) << 2;
+	}
+	int32_t modeIndex = HbImage_BCi_BPTCFloat_ModeIndices[modeBits];
+	if (modeIndex < 0) {
+		for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+			memset(target + rowIndex * targetRowPitch, 0, 4 * 4 * sizeof(uint16_t));
+		}
+		return;
+	}
+	HbImage_BCi_BPTCFloat_Mode const * mode = &HbImage_BCi_BPTCFloat_Modes[modeIndex];
+
+	uint32_t components[12] = { 0 };
+	for (uint32_t segmentIndex = 0; segmentIndex < mode->segmentCount; ++segmentIndex) {
+		HbImage_BCi_BPTCFloat_Segment const * segment = &mode->segments[segmentIndex];
+		uint32_t * component = &components[segment->component];
+		if (segment->lastBit >= segment->firstBit) {
+			*component |= HbImage_BCi_Bits_Read(&bits, segment->lastBit - segment->firstBit + 1) << segment->firstBit;
+		} else {
+			for (uint32_t bit = segment->firstBit; bit >= segment->lastBit; --bit) {
+				*component |= HbImage_BCi_Bits_Read(&bits, 1) << bit;
+			}
+		}
+	}
+	uint32_t partition = mode->subsetCount > 1 ? HbImage_BCi_Bits_Read(&bits, 5) : 0;
+
+	// Endpoints as signed values with endpointBits, then unquantized to 16 bits.
+	uint32_t endpointCount = mode->subsetCount * 2;
+	uint32_t endpointBits = mode->endpointBits;
+	int32_t endpoints[4][3];
+	for (uint32_t channel = 0; channel < 3; ++channel) {
+		uint32_t endpointMask = (uint32_t) ((1ull << endpointBits) - 1);
+		int32_t endpoint0 = (int32_t) components[channel];
+		if (isSigned) {
+			endpoint0 = HbImage_BCi_BPTCFloat_SignExtend((uint32_t) endpoint0, endpointBits);
+		}
+		endpoints[0][channel] = endpoint0;
+		for (uint32_t endpointIndex = 1; endpointIndex < endpointCount; ++endpointIndex) {
+			uint32_t component = components[endpointIndex * 3 + channel];
+			int32_t endpoint;
+			if (mode->transformed) {
+				component = (uint32_t) (endpoint0 + HbImage_BCi_BPTCFloat_SignExtend(component, mode->deltaBits[channel])) & endpointMask;
+			}
+			endpoint = isSigned ? HbImage_BCi_BPTCFloat_SignExtend(component, endpointBits) : (int32_t) component;
+			endpoints[endpointIndex][channel] = endpoint;
+		}
+		for (uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex) {
+			endpoints[endpointIndex][channel] = HbImage_BCi_BPTCFloat_Unquantize(endpoints[endpointIndex][channel], endpointBits, isSigned);
+		}
+	}
+
+	uint32_t indexBits = mode->subsetCount > 1 ? 3 : 4;
+	uint32_t anchorTexels, subsets;
+	HbImage_BCi_BPTC_GetPartition(mode->subsetCount, partition, &anchorTexels, &subsets);
+	uint8_t indices[16];
+	HbImage_BCi_Bits_ReadIndices(&bits, indexBits, anchorTexels, indices);
+	uint64_t palettes[2][16];
+	for (uint32_t subset = 0; subset < mode->subsetCount; ++subset) {
+		HbImage_BCi_BPTCFloat_GetPalette(endpoints[subset * 2], endpoints[subset * 2 + 1], indexBits, isSigned, palettes[subset]);
+	}
+	uint64_t texelColors[16];
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		texelColors[texel] = palettes[(subsets >> (texel * 2)) & 3][indices[texel]];
+	}
+	for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+		memcpy(target + rowIndex * targetRowPitch, &texelColors[rowIndex * 4], 4 * sizeof(uint64_t));
+	}
+}
+
+/*************************
+ * Block and mip decoding
+ *************************/
+
+HbGPU_Image_Format HbImage_BC_GetDecodedFormat(HbGPU_Image_Format format) {
+	switch (format) {
+	case HbGPU_Image_Format_S3TC_A1_UNorm:
+	case HbGPU_Image_Format_S3TC_A4_UNorm:
+	case HbGPU_Image_Format_S3TC_A8_UNorm:
+	case HbGPU_Image_Format_BPTC_UNorm:
+		return HbGPU_Image_Format_8_8_8_8_RGBA_UNorm;
+	case HbGPU_Image_Format_S3TC_A1_sRGB:
+	case HbGPU_Image_Format_S3TC_A4_sRGB:
+	case HbGPU_Image_Format_S3TC_A8_sRGB:
+	case HbGPU_Image_Format_BPTC_sRGB:
+		return HbGPU_Image_Format_8_8_8_8_RGBA_sRGB;
+	case HbGPU_Image_Format_3Dc_R_UNorm:
+		return HbGPU_Image_Format_8_R_UNorm;
+	case HbGPU_Image_Format_3Dc_R_SNorm:
+		return HbGPU_Image_Format_8_R_SNorm;
+	case HbGPU_Image_Format_3Dc_RG_UNorm:
+		return HbGPU_Image_Format_8_8_RG_UNorm;
+	case HbGPU_Image_Format_3Dc_RG_SNorm:
+		return HbGPU_Image_Format_8_8_RG_SNorm;
+	case HbGPU_Image_Format_BPTC_UFloat:
+	case HbGPU_Image_Format_BPTC_SFloat:
+		return HbGPU_Image_Format_16_16_16_16_RGBA_SFloat;
+	default:
+		break;
+	}
+	return HbGPU_Image_Format_Invalid;
+}
+
+void HbImage_BC_DecodeBlock(HbGPU_Image_Format format, void const * block, void * target, size_t targetRowPitch) {
+	uint8_t const * blockBytes = (uint8_t const *) block;
+	uint8_t * targetBytes = (uint8_t *) target;
+	uint8_t alphas[16];
+	switch (format) {
+	case HbGPU_Image_Format_S3TC_A1_UNorm:
+	case HbGPU_Image_Format_S3TC_A1_sRGB:
+		HbImage_BCi_S3TC_DecodeColor(blockBytes, HbTrue, NULL, targetBytes, targetRowPitch);
+		break;
+	case HbGPU_Image_Format_S3TC_A4_UNorm:
+	case HbGPU_Image_Format_S3TC_A4_sRGB:
+		HbImage_BCi_S3TC_DecodeExplicitAlpha(blockBytes, alphas);
+		HbImage_BCi_S3TC_DecodeColor(blockBytes + 8, HbFalse, alphas, targetBytes, targetRowPitch);
+		break;
+	case HbGPU_Image_Format_S3TC_A8_UNorm:
+	case HbGPU_Image_Format_S3TC_A8_sRGB:
+		HbImage_BCi_3Dc_DecodeUNorm(blockBytes, alphas);
+		HbImage_BCi_S3TC_DecodeColor(blockBytes + 8, HbFalse, alphas, targetBytes, targetRowPitch);
+		break;
+	case HbGPU_Image_Format_3Dc_R_UNorm:
+	case HbGPU_Image_Format_3Dc_R_SNorm: {
+		uint8_t values[16];
+		if (format == HbGPU_Image_Format_3Dc_R_SNorm) {
+			HbImage_BCi_3Dc_DecodeSNorm(blockBytes, (int8_t *) values);
+		} else {
+			HbImage_BCi_3Dc_DecodeUNorm(blockBytes, values);
+		}
+		for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+			memcpy(targetBytes + rowIndex * targetRowPitch, values + rowIndex * 4, 4);
+		}
+		break;
+	}
+	case HbGPU_Image_Format_3Dc_RG_UNorm:
+	case HbGPU_Image_Format_3Dc_RG_SNorm: {
+		uint8_t values[2][16];
+		if (format == HbGPU_Image_Format_3Dc_RG_SNorm) {
+			HbImage_BCi_3Dc_DecodeSNorm(blockBytes, (int8_t *) values[0]);
+			HbImage_BCi_3Dc_DecodeSNorm(blockBytes + 8, (int8_t *) values[1]);
+		} else {
+			HbImage_BCi_3Dc_DecodeUNorm(blockBytes, values[0]);
+			HbImage_BCi_3Dc_DecodeUNorm(blockBytes + 8, values[1]);
+		}
+		HbMath_U8x16 red = HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) values[0]);
+		HbMath_U8x16 green = HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) values[1]);
+		uint8_t texels[32];
+		HbMath_U8x16_StoreUnaligned((HbMath_U8x16 *) texels, HbMath_U8x16_InterleaveLower(red, green));
+		HbMath_U8x16_StoreUnaligned((HbMath_U8x16 *) (texels + 16), HbMath_U8x16_InterleaveUpper(red, green));
+		for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+			memcpy(targetBytes + rowIndex * targetRowPitch, texels + rowIndex * 8, 8);
+		}
+		break;
+	}
+	case HbGPU_Image_Format_BPTC_UFloat:
+	case HbGPU_Image_Format_BPTC_SFloat:
+		HbImage_BCi_BPTCFloat_Decode(blockBytes, format == HbGPU_Image_Format_BPTC_SFloat, targetBytes, targetRowPitch);
+		break;
+	case HbGPU_Image_Format_BPTC_UNorm:
+	case HbGPU_Image_Format_BPTC_sRGB:
+		HbImage_BCi_BPTC_DecodeUNorm(blockBytes, targetBytes, targetRowPitch);
+		break;
+	default:
+		break;
+	}
+}
+
+HbForceInline uint32_t HbImage_BCi_GetDecodedTexelSize(HbGPU_Image_Format format) {
+	return HbGPU_Image_Copy_ElementSize(HbImage_BC_GetDecodedFormat(format), HbFalse);
+}
+
+void HbImage_BC_DecodeBlockRow(HbGPU_Image_Format format, void const * blocks, uint32_t texelWidth, uint32_t texelRowCount,
+		void * target, size_t targetRowPitch) {
+	uint8_t const * block = (uint8_t const *) blocks;
+	uint8_t * targetBytes = (uint8_t *) target;
+	uint32_t blockSize = HbGPU_Image_Copy_ElementSize(format, HbFalse);
+	uint32_t texelSize = HbImage_BCi_GetDecodedTexelSize(format);
+	uint32_t fullBlockCount = texelRowCount >= 4 ? texelWidth >> 2 : 0;
+	for (uint32_t blockIndex = 0; blockIndex < fullBlockCount; ++blockIndex) {
+		HbImage_BC_DecodeBlock(format, block, targetBytes, targetRowPitch);
+		block += blockSize;
+		targetBytes += 4 * texelSize;
+	}
+	// Blocks partially outside the target (on the right edge or in the bottom row of a mip) are decoded to a temporary block.
+	texelRowCount = HbMinU32(texelRowCount, 4);
+	for (uint32_t texelX = fullBlockCount * 4; texelX < texelWidth; texelX += 4) {
+		uint8_t texels[4 * 4 * 8];
+		size_t texelsRowPitch = 4 * texelSize;
+		HbImage_BC_DecodeBlock(format, block, texels, texelsRowPitch);
+		size_t copyRowSize = HbMinU32(texelWidth - texelX, 4) * texelSize;
+		for (uint32_t rowIndex = 0; rowIndex < texelRowCount; ++rowIndex) {
+			memcpy(targetBytes + rowIndex * targetRowPitch, texels + rowIndex * texelsRowPitch, copyRowSize);
+		}
+		block += blockSize;
+		targetBytes += 4 * texelSize;
+	}
+}
+
+void HbImage_BC_DecodeMipBlockRows(HbGPU_Image_Format format, void const * source, uint32_t width, uint32_t height,
+		uint32_t blockRowFirst, uint32_t blockRowEnd, void * target, size_t targetRowPitch, size_t targetSlicePitch) {
+	if (width == 0 || height == 0) {
+		return;
+	}
+	uint32_t blocksWide = (width + 3) >> 2, blocksHigh = (height + 3) >> 2;
+	size_t sourceRowPitch = (size_t) blocksWide * HbGPU_Image_Copy_ElementSize(format, HbFalse);
+	uint8_t const * sourceBytes = (uint8_t const *) source;
+	uint8_t * targetBytes = (uint8_t *) target;
+	for (uint32_t blockRow = blockRowFirst; blockRow < blockRowEnd; ++blockRow) {
+		uint32_t slice = blockRow / blocksHigh, sliceBlockRow = blockRow - slice * blocksHigh;
+		HbImage_BC_DecodeBlockRow(format, sourceBytes + blockRow * sourceRowPitch, width, HbMinU32(height - sliceBlockRow * 4, 4),
+				targetBytes + slice * targetSlicePitch + sliceBlockRow * 4 * targetRowPitch, targetRowPitch);
+	}
+}
@@ -0,0 +1,42 @@
+#ifndef HbInclude_HbImage_BCDecode
+#define HbInclude_HbImage_BCDecode
+#include "HbGPU_Image.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Decoding of 4x4-compressed formats on the CPU. Rows of texels and of 4x4 blocks are addressed with pitches in bytes,
+ * like in HbGPU_Image_Copy_MipLayout.
+ *
+ * This part doesn't depend on the GPU API or on the OS, so it can be used in tools built for any platform.
+ * Decoding of whole mips on multiple threads is provided by HbImage_BC_DecodeMip in HbImage.h.
+ */
+
+// The format the texels are decoded to:
+// - S3TC and BPTC UNorm/sRGB - 8_8_8_8_RGBA in the same color space (the decoded sRGB values are not converted to linear).
+// - 3Dc - 8_R or 8_8_RG with the same signedness.
+// - BPTC float - 16_16_16_16_RGBA_SFloat with alpha of 1.
+// Invalid BPTC blocks are decoded to zeros, like on the GPU.
+// Returns HbGPU_Image_Format_Invalid for formats that are not 4x4-compressed, which are ignored by the decoding functions.
+HbGPU_Image_Format HbImage_BC_GetDecodedFormat(HbGPU_Image_Format format);
+
+// Writes 4 rows of 4 texels.
+void HbImage_BC_DecodeBlock(HbGPU_Image_Format format, void const * block, void * target, size_t targetRowPitch);
+// Decodes a row of blocks, with texelWidth (not necessarily a multiple of 4) texels in every target row
+// and texelRowCount (up to 4, less for the last row of a mip with the height not a multiple of 4) target rows.
+void HbImage_BC_DecodeBlockRow(HbGPU_Image_Format format, void const * blocks, uint32_t texelWidth, uint32_t texelRowCount,
+		void * target, size_t targetRowPitch);
+
+// Decodes the block rows from blockRowFirst to blockRowEnd (exclusive) of a mip with tightly packed blocks (like in DDS files),
+// with the block rows of all the depth slices numbered contiguously - there are HbImage_BC_GetMipBlockRowCount of them.
+HbForceInline uint32_t HbImage_BC_GetMipBlockRowCount(uint32_t height, uint32_t depth) {
+	return ((height + 3) >> 2) * depth;
+}
+void HbImage_BC_DecodeMipBlockRows(HbGPU_Image_Format format, void const * source, uint32_t width, uint32_t height,
+		uint32_t blockRowFirst, uint32_t blockRowEnd, void * target, size_t targetRowPitch, size_t targetSlicePitch);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,61 @@
+#include "HbImage.h"
+#include "HbParallel.h"
+
+// The last job gets the remainder of the block rows.
+typedef struct HbImage_BCi_DecodeMip_Job {
+	HbGPU_Image_Format format;
+	void const * source;
+	uint32_t width;
+	uint32_t height;
+	void * target;
+	size_t targetRowPitch;
+	size_t targetSlicePitch;
+	uint32_t blockRowFirst;
+	uint32_t blockRowEnd;
+} HbImage_BCi_DecodeMip_Job;
+
+static void HbImage_BCi_DecodeMip_RunJob(void * data) {
+	HbImage_BCi_DecodeMip_Job const * job = (HbImage_BCi_DecodeMip_Job const *) data;
+	HbImage_BC_DecodeMipBlockRows(job->format, job->source, job->width, job->height, job->blockRowFirst, job->blockRowEnd,
+			job->target, job->targetRowPitch, job->targetSlicePitch);
+}
+
+void HbImage_BC_DecodeMip(HbGPU_Image_Format format, void const * source, uint32_t width, uint32_t height, uint32_t depth,
+		void * target, size_t targetRowPitch, size_t targetSlicePitch, uint32_t threadCount) {
+	if (width == 0 || height == 0 || depth == 0) {
+		return;
+	}
+	uint32_t blockRowCount = HbImage_BC_GetMipBlockRowCount(height, depth);
+	uint32_t maxThreadCount = (blockRowCount + (HbImage_BC_DecodeMip_MinBlockRowsPerThread - 1)) /
+			HbImage_BC_DecodeMip_MinBlockRowsPerThread;
+	threadCount = HbMinU32(HbMinU32(threadCount, maxThreadCount), HbImage_BC_DecodeMip_MaxThreads);
+	threadCount = HbMaxU32(threadCount, 1);
+	HbImage_BCi_DecodeMip_Job jobs[HbImage_BC_DecodeMip_MaxThreads];
+	HbParallel_Thread threads[HbImage_BC_DecodeMip_MaxThreads];
+	HbBool threadsStarted[HbImage_BC_DecodeMip_MaxThreads];
+	uint32_t blockRowsPerJob = blockRowCount / threadCount;
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		HbImage_BCi_DecodeMip_Job * job = &jobs[jobIndex];
+		job->format = format;
+		job->source = source;
+		job->width = width;
+		job->height = height;
+		job->target = target;
+		job->targetRowPitch = targetRowPitch;
+		job->targetSlicePitch = targetSlicePitch;
+		job->blockRowFirst = jobIndex * blockRowsPerJob;
+		job->blockRowEnd = (jobIndex + 1 == threadCount) ? blockRowCount : job->blockRowFirst + blockRowsPerJob;
+	}
+	// Job 0 is done on the calling thread, and jobs whose threads couldn't be started too.
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		threadsStarted[jobIndex] = HbParallel_Thread_Start(&threads[jobIndex], "HbImageDecode", HbImage_BCi_DecodeMip_RunJob, &jobs[jobIndex]);
+	}
+	HbImage_BCi_DecodeMip_RunJob(&jobs[0]);
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		if (threadsStarted[jobIndex]) {
+			HbParallel_Thread_Destroy(&threads[jobIndex]);
+		} else {
+			HbImage_BCi_DecodeMip_RunJob(&jobs[jobIndex]);
+		}
+	}
+}
@@ -0,0 +1,938 @@
+#include "HbAtomic.h"
+#include "HbFeedback.h"
+#include "HbFile_DDS.h"
+#include "HbImage.h"
+#include "HbImagei_BC.h"
+#include "HbMath.h"
+#include "HbParallel.h"
+
+/*************************************
+ * Texels and palette index selection
+ *************************************/
+
+// Texels of a block in the structure-of-arrays layout to process 4 texels at once, 0 to 255 (-127 to 127 for SNorm).
+typedef struct HbMath_VecAligned HbImage_BCi_Encode_Texels {
+	float channels[4][16];
+} HbImage_BCi_Encode_Texels;
+
+static void HbImage_BCi_Encode_LoadTexels(HbGPU_Image_Format format, uint8_t const * source,
+		uint32_t texelWidth, uint32_t texelRowCount, size_t sourceRowPitch, HbImage_BCi_Encode_Texels * texels) {
+	uint32_t texelSize = HbGPU_Image_Copy_ElementSize(HbImage_BC_GetDecodedFormat(format), HbFalse);
+	HbBool isSigned = (format == HbGPU_Image_Format_3Dc_R_SNorm || format == HbGPU_Image_Format_3Dc_RG_SNorm);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t x = HbMinU32(texel & 3, texelWidth - 1), y = HbMinU32(texel >> 2, texelRowCount - 1);
+		uint8_t const * texelSource = source + y * sourceRowPitch + x * texelSize;
+		for (uint32_t channel = 0; channel < 4; ++channel) {
+			float value;
+			if (channel >= texelSize) {
+				value = (channel == 3 ? 255.0f : 0.0f);
+			} else if (isSigned) {
+				value = (float) HbMaxI32((int8_t) texelSource[channel], -127);
+			} else {
+				value = (float) texelSource[channel];
+			}
+			texels->channels[channel][texel] = value;
+		}
+	}
+}
+
+static int32_t const HbImage_BCi_Encode_LaneBits[4] = { 1, 2, 4, 8 };
+
+// All bits set in the lanes of the texels present in the 4 bits of quadMask.
+static HbForceInline HbMath_F32x4 HbImage_BCi_Encode_LaneMask(uint32_t quadMask) {
+	HbMath_S32x4 laneBits = HbMath_S32x4_LoadUnaligned((HbMath_S32x4 const *) HbImage_BCi_Encode_LaneBits);
+	return HbMath_S32x4_BitsAsF32x4(HbMath_S32x4_CompareEqual(
+			HbMath_S32x4_And(HbMath_S32x4_LoadReplicated((int32_t) quadMask), laneBits), laneBits));
+}
+
+HbForceInline float HbImage_BCi_Encode_Sum(HbMath_F32x4 v) {
+	float lanes[4];
+	HbMath_F32x4_StoreUnaligned(lanes, v);
+	return (lanes[0] + lanes[1]) + (lanes[2] + lanes[3]);
+}
+
+// Finds the nearest palette entry (in the first channelCount channels) for every texel in texelMask, 4 texels at once.
+// Returns the sum of the squared errors.
+static float HbImage_BCi_Encode_SelectIndices(float const (* channels)[16], uint32_t channelCount,
+		float const (* palette)[4], uint32_t paletteSize, uint32_t texelMask, uint8_t * indices) {
+	HbMath_F32x4 errorSum = HbMath_F32x4_LoadZero();
+	for (uint32_t texelFirst = 0; texelFirst < 16; texelFirst += 4) {
+		uint32_t quadMask = (texelMask >> texelFirst) & 15;
+		if (quadMask == 0) {
+			continue;
+		}
+		HbMath_F32x4 texelChannels[4];
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			texelChannels[channel] = HbMath_F32x4_LoadUnaligned(&channels[channel][texelFirst]);
+		}
+		HbMath_F32x4 bestErrors = HbMath_F32x4_LoadReplicated(FLT_MAX), bestIndices = HbMath_F32x4_LoadZero();
+		for (uint32_t entry = 0; entry < paletteSize; ++entry) {
+			HbMath_F32x4 errors = HbMath_F32x4_LoadZero();
+			for (uint32_t channel = 0; channel < channelCount; ++channel) {
+				HbMath_F32x4 difference = HbMath_F32x4_Subtract(texelChannels[channel], HbMath_F32x4_LoadReplicated(palette[entry][channel]));
+				errors = HbMath_F32x4_MultiplyAdd(errors, difference, difference);
+			}
+			HbMath_F32x4 isBetter = HbMath_F32x4_CompareLess(errors, bestErrors);
+			bestErrors = HbMath_F32x4_Select(isBetter, errors, bestErrors);
+			bestIndices = HbMath_F32x4_Select(isBetter, HbMath_F32x4_LoadReplicated((float) entry), bestIndices);
+		}
+		errorSum = HbMath_F32x4_Add(errorSum, HbMath_F32x4_And(bestErrors, HbImage_BCi_Encode_LaneMask(quadMask)));
+		float quadIndices[4];
+		HbMath_F32x4_StoreUnaligned(quadIndices, bestIndices);
+		for (uint32_t quadTexel = 0; quadTexel < 4; ++quadTexel) {
+			if (quadMask & (1u << quadTexel)) {
+				indices[texelFirst + quadTexel] = (uint8_t) quadIndices[quadTexel];
+			}
+		}
+	}
+	return HbImage_BCi_Encode_Sum(errorSum);
+}
+
+/***********************
+ * Endpoint calculation
+ ***********************/
+
+// Places the endpoints at the extremes of the projections of the texels in texelMask (must not be 0) onto their principal axis.
+static void HbImage_BCi_Encode_FitLine(float const (* channels)[16], uint32_t channelCount, uint32_t texelMask, float (* endpoints)[4]) {
+	HbMath_F32x4 laneMasks[4];
+	float texelCount = 0.0f;
+	for (uint32_t quadIndex = 0; quadIndex < 4; ++quadIndex) {
+		uint32_t quadMask = (texelMask >> (quadIndex * 4)) & 15;
+		laneMasks[quadIndex] = HbImage_BCi_Encode_LaneMask(quadMask);
+		texelCount += (float) ((quadMask & 1) + ((quadMask >> 1) & 1) + ((quadMask >> 2) & 1) + (quadMask >> 3));
+	}
+	HbMath_F32x4 floatMax = HbMath_F32x4_LoadReplicated(FLT_MAX), floatMin = HbMath_F32x4_LoadReplicated(-FLT_MAX);
+	float mean[4], minimum[4], maximum[4];
+	for (uint32_t channel = 0; channel < channelCount; ++channel) {
+		HbMath_F32x4 sum = HbMath_F32x4_LoadZero(), channelMin = floatMax, channelMax = floatMin;
+		for (uint32_t quadIndex = 0; quadIndex < 4; ++quadIndex) {
+			HbMath_F32x4 values = HbMath_F32x4_LoadUnaligned(&channels[channel][quadIndex * 4]);
+			sum = HbMath_F32x4_Add(sum, HbMath_F32x4_And(values, laneMasks[quadIndex]));
+			channelMin = HbMath_F32x4_Min(channelMin, HbMath_F32x4_Select(laneMasks[quadIndex], values, floatMax));
+			channelMax = HbMath_F32x4_Max(channelMax, HbMath_F32x4_Select(laneMasks[quadIndex], values, floatMin));
+		}
+		mean[channel] = HbImage_BCi_Encode_Sum(sum) / texelCount;
+		channelMin = HbMath_F32x4_Min(channelMin, HbMath_F32x4_RotateZWXY(channelMin));
+		channelMax = HbMath_F32x4_Max(channelMax, HbMath_F32x4_RotateZWXY(channelMax));
+		channelMin = HbMath_F32x4_Min(channelMin, HbMath_F32x4_RotateYZWX(channelMin));
+		channelMax = HbMath_F32x4_Max(channelMax, HbMath_F32x4_RotateYZWX(channelMax));
+		HbMath_F32x4_StoreX(&minimum[channel], channelMin);
+		HbMath_F32x4_StoreX(&maximum[channel], channelMax);
+	}
+
+	// Texels relative to the mean (zero outside the mask), and the covariance matrix of the channels.
+	HbMath_F32x4 offsets[4][4];
+	float covariance[4][4];
+	for (uint32_t channel = 0; channel < channelCount; ++channel) {
+		HbMath_F32x4 channelMean = HbMath_F32x4_LoadReplicated(mean[channel]);
+		for (uint32_t quadIndex = 0; quadIndex < 4; ++quadIndex) {
+			offsets[channel][quadIndex] = HbMath_F32x4_And(HbMath_F32x4_Subtract(
+					HbMath_F32x4_LoadUnaligned(&channels[channel][quadIndex * 4]), channelMean), laneMasks[quadIndex]);
+		}
+	}
+	for (uint32_t channel0 = 0; channel0 < channelCount; ++channel0) {
+		for (uint32_t channel1 = channel0; channel1 < channelCount; ++channel1) {
+			HbMath_F32x4 sum = HbMath_F32x4_LoadZero();
+			for (uint32_t quadIndex = 0; quadIndex < 4; ++quadIndex) {
+				sum = HbMath_F32x4_MultiplyAdd(sum, offsets[channel0][quadIndex], offsets[channel1][quadIndex]);
+			}
+			covariance[channel0][channel1] = covariance[channel1][channel0] = HbImage_BCi_Encode_Sum(sum);
+		}
+	}
+
+	// Power iteration starting from the diagonal of the bounding box, which is usually close to the principal axis already.
+	float axis[4];
+	for (uint32_t channel = 0; channel < channelCount; ++channel) {
+		axis[channel] = maximum[channel] - minimum[channel];
+	}
+	float axisLengthSquared = 0.0f;
+	for (uint32_t iteration = 0; iteration < 8; ++iteration) {
+		float nextAxis[4], nextAxisMax = 0.0f;
+		for (uint32_t channel0 = 0; channel0 < channelCount; ++channel0) {
+			float value = 0.0f;
+			for (uint32_t channel1 = 0; channel1 < channelCount; ++channel1) {
+				value += covariance[channel0][channel1] * axis[channel1];
+			}
+			nextAxis[channel0] = value;
+			nextAxisMax = fmaxf(nextAxisMax, fabsf(value));
+		}
+		if (nextAxisMax <= 1.0e-6f) {
+			break;
+		}
+		axisLengthSquared = 0.0f;
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			axis[channel] = nextAxis[channel] / nextAxisMax;
+			axisLengthSquared += axis[channel] * axis[channel];
+		}
+	}
+	if (axisLengthSquared <= 0.0f) {
+		// All the texels are the same.
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			endpoints[0][channel] = endpoints[1][channel] = mean[channel];
+		}
+		return;
+	}
+
+	HbMath_F32x4 projectionMin = floatMax, projectionMax = floatMin;
+	for (uint32_t quadIndex = 0; quadIndex < 4; ++quadIndex) {
+		HbMath_F32x4 projections = HbMath_F32x4_LoadZero();
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			projections = HbMath_F32x4_MultiplyAdd(projections, offsets[channel][quadIndex], HbMath_F32x4_LoadReplicated(axis[channel]));
+		}
+		projectionMin = HbMath_F32x4_Min(projectionMin, HbMath_F32x4_Select(laneMasks[quadIndex], projections, floatMax));
+		projectionMax = HbMath_F32x4_Max(projectionMax, HbMath_F32x4_Select(laneMasks[quadIndex], projections, floatMin));
+	}
+	projectionMin = HbMath_F32x4_Min(projectionMin, HbMath_F32x4_RotateZWXY(projectionMin));
+	projectionMax = HbMath_F32x4_Max(projectionMax, HbMath_F32x4_RotateZWXY(projectionMax));
+	projectionMin = HbMath_F32x4_Min(projectionMin, HbMath_F32x4_RotateYZWX(projectionMin));
+	projectionMax = HbMath_F32x4_Max(projectionMax, HbMath_F32x4_RotateYZWX(projectionMax));
+	float positionMin, positionMax;
+	HbMath_F32x4_StoreX(&positionMin, projectionMin);
+	HbMath_F32x4_StoreX(&positionMax, projectionMax);
+	positionMin /= axisLengthSquared;
+	positionMax /= axisLengthSquared;
+	for (uint32_t channel = 0; channel < channelCount; ++channel) {
+		endpoints[0][channel] = HbClampF(mean[channel] + axis[channel] * positionMin, minimum[channel], maximum[channel]);
+		endpoints[1][channel] = HbClampF(mean[channel] + axis[channel] * positionMax, minimum[channel], maximum[channel]);
+	}
+}
+
+// Least squares endpoints for the texels in texelMask with the interpolation weights (0 to 1 towards endpoint 1) of their indices.
+// Returns HbFalse if all the texels use the same weight.
+static HbBool HbImage_BCi_Encode_FitIndices(float const (* channels)[16], uint32_t channelCount, uint32_t texelMask,
+		uint8_t const * indices, float const * weights, float (* endpoints)[4]) {
+	float sum00 = 0.0f, sum11 = 0.0f, sum01 = 0.0f, sumTexels0[4] = { 0.0f }, sumTexels1[4] = { 0.0f };
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		if (!(texelMask & (1u << texel))) {
+			continue;
+		}
+		float weight1 = weights[indices[texel]], weight0 = 1.0f - weight1;
+		sum00 += weight0 * weight0;
+		sum11 += weight1 * weight1;
+		sum01 += weight0 * weight1;
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			sumTexels0[channel] += weight0 * channels[channel][texel];
+			sumTexels1[channel] += weight1 * channels[channel][texel];
+		}
+	}
+	float determinant = sum00 * sum11 - sum01 * sum01;
+	if (determinant <= 1.0e-4f) {
+		return HbFalse;
+	}
+	float inverseDeterminant = 1.0f / determinant;
+	for (uint32_t channel = 0; channel < channelCount; ++channel) {
+		endpoints[0][channel] = (sum11 * sumTexels0[channel] - sum01 * sumTexels1[channel]) * inverseDeterminant;
+		endpoints[1][channel] = (sum00 * sumTexels1[channel] - sum01 * sumTexels0[channel]) * inverseDeterminant;
+	}
+	return HbTrue;
+}
+
+/***************
+ * S3TC and 3Dc
+ ***************/
+
+static float const HbImage_BCi_Encode_S3TCWeights4[4] = { 0.0f, 1.0f, 1.0f / 3.0f, 2.0f / 3.0f };
+static float const HbImage_BCi_Encode_S3TCWeights3[4] = { 0.0f, 1.0f, 0.5f, 0.0f };
+
+HbForceInline uint32_t HbImage_BCi_Encode_QuantizeS3TC(float const * color) {
+	uint32_t r = (uint32_t) HbClampF(color[0] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+	uint32_t g = (uint32_t) HbClampF(color[1] * (63.0f / 255.0f) + 0.5f, 0.0f, 63.0f);
+	uint32_t b = (uint32_t) HbClampF(color[2] * (31.0f / 255.0f) + 0.5f, 0.0f, 31.0f);
+	return (r << 11) | (g << 5) | b;
+}
+
+// With allowPunchThrough, the texels with alpha below 128 are made transparent black with the 3-color mode.
+static void HbImage_BCi_Encode_S3TCColor(HbImage_BCi_Encode_Texels const * texels, HbImage_BC_Quality quality,
+		HbBool allowPunchThrough, uint8_t * block) {
+	uint32_t opaqueMask = 0xFFFF;
+	if (allowPunchThrough) {
+		for (uint32_t texel = 0; texel < 16; ++texel) {
+			if (texels->channels[3][texel] < 128.0f) {
+				opaqueMask &= ~(1u << texel);
+			}
+		}
+	}
+	uint32_t bestColors[2] = { 0, 0 };
+	uint8_t bestIndices[16];
+	memset(bestIndices, 3, sizeof(bestIndices)); // Transparent black with colors 0 and 0 if no texels are opaque.
+	if (opaqueMask != 0) {
+		float lineEndpoints[2][4];
+		HbImage_BCi_Encode_FitLine(texels->channels, 3, opaqueMask, lineEndpoints);
+		uint32_t iterationCount = (quality >= HbImage_BC_Quality_High ? 3 : (quality >= HbImage_BC_Quality_Normal ? 1 : 0));
+		float bestError = FLT_MAX;
+		for (uint32_t threeColors = 0; threeColors < 2; ++threeColors) {
+			// 4 colors can't be used with transparent texels, and 3 colors are only tried for opaque blocks at high quality.
+			if (threeColors ? (!allowPunchThrough || (opaqueMask == 0xFFFF && quality < HbImage_BC_Quality_High)) : opaqueMask != 0xFFFF) {
+				continue;
+			}
+			float endpoints[2][4];
+			memcpy(endpoints, lineEndpoints, sizeof(endpoints));
+			for (uint32_t iteration = 0; ; ++iteration) {
+				uint32_t colors[2] = { HbImage_BCi_Encode_QuantizeS3TC(endpoints[0]), HbImage_BCi_Encode_QuantizeS3TC(endpoints[1]) };
+				if (threeColors ? colors[0] > colors[1] : colors[0] < colors[1]) {
+					uint32_t color = colors[0];
+					colors[0] = colors[1];
+					colors[1] = color;
+					float endpoint[4];
+					memcpy(endpoint, endpoints[0], sizeof(endpoint));
+					memcpy(endpoints[0], endpoints[1], sizeof(endpoint));
+					memcpy(endpoints[1], endpoint, sizeof(endpoint));
+				}
+				// Equal colors are interpreted as 3 colors with punch-through, only the first is used then.
+				HbBool paletteHasTransparent = allowPunchThrough && colors[0] <= colors[1];
+				uint32_t palette[4];
+				HbImagei_BC_S3TC_GetPalette(colors[0], colors[1], allowPunchThrough, palette);
+				float paletteChannels[4][4];
+				for (uint32_t entry = 0; entry < 4; ++entry) {
+					for (uint32_t channel = 0; channel < 4; ++channel) {
+						paletteChannels[entry][channel] = (float) ((palette[entry] >> (channel * 8)) & 0xFF);
+					}
+				}
+				uint8_t indices[16];
+				memset(indices, 3, sizeof(indices));
+				float error = HbImage_BCi_Encode_SelectIndices(texels->channels, 3, paletteChannels, paletteHasTransparent ? 3 : 4,
+						opaqueMask, indices);
+				if (error < bestError) {
+					bestError = error;
+					bestColors[0] = colors[0];
+					bestColors[1] = colors[1];
+					memcpy(bestIndices, indices, sizeof(bestIndices));
+				}
+				if (iteration >= iterationCount || !HbImage_BCi_Encode_FitIndices(texels->channels, 3, opaqueMask, indices,
+						paletteHasTransparent ? HbImage_BCi_Encode_S3TCWeights3 : HbImage_BCi_Encode_S3TCWeights4, endpoints)) {
+					break;
+				}
+			}
+		}
+	}
+	block[0] = (uint8_t) bestColors[0];
+	block[1] = (uint8_t) (bestColors[0] >> 8);
+	block[2] = (uint8_t) bestColors[1];
+	block[3] = (uint8_t) (bestColors[1] >> 8);
+	for (uint32_t rowIndex = 0; rowIndex < 4; ++rowIndex) {
+		uint8_t const * rowIndices = &bestIndices[rowIndex * 4];
+		block[4 + rowIndex] = (uint8_t) (rowIndices[0] | (rowIndices[1] << 2) | (rowIndices[2] << 4) | (rowIndices[3] << 6));
+	}
+}
+
+static float HbImage_BCi_Encode_3DcEvaluate(float const (* values)[16], HbBool isSigned, int32_t endpoint0, int32_t endpoint1,
+		uint8_t * indices) {
+	float palette[8][4];
+	if (isSigned) {
+		int8_t signedPalette[8];
+		HbImagei_BC_3Dc_GetPaletteSNorm(endpoint0, endpoint1, signedPalette);
+		for (uint32_t entry = 0; entry < 8; ++entry) {
+			palette[entry][0] = (float) signedPalette[entry];
+		}
+	} else {
+		uint8_t unsignedPalette[8];
+		HbImagei_BC_3Dc_GetPaletteUNorm((uint32_t) endpoint0, (uint32_t) endpoint1, unsignedPalette);
+		for (uint32_t entry = 0; entry < 8; ++entry) {
+			palette[entry][0] = (float) unsignedPalette[entry];
+		}
+	}
+	return HbImage_BCi_Encode_SelectIndices(values, 1, palette, 8, 0xFFFF, indices);
+}
+
+// Also used for S3TC_A8 alpha.
+static void HbImage_BCi_Encode_3Dc(float const (* values)[16], HbBool isSigned, HbImage_BC_Quality quality, uint8_t * block) {
+	int32_t valueMin = isSigned ? -127 : 0, valueMax = isSigned ? 127 : 255;
+	// The 6-value mode has the extremes in the palette, so only the values between them need to be covered by the endpoints.
+	float minimum = FLT_MAX, maximum = -FLT_MAX, innerMinimum = FLT_MAX, innerMaximum = -FLT_MAX;
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		float value = (*values)[texel];
+		minimum = fminf(minimum, value);
+		maximum = fmaxf(maximum, value);
+		if (value != (float) valueMin && value != (float) valueMax) {
+			innerMinimum = fminf(innerMinimum, value);
+			innerMaximum = fmaxf(innerMaximum, value);
+		}
+	}
+	if (innerMinimum > innerMaximum) {
+		innerMinimum = innerMaximum = (float) valueMin;
+	}
+	// 8 values if endpoint 0 is greater than endpoint 1, 6 values and the extremes otherwise.
+	int32_t candidates[2][2] = {
+		{ (int32_t) (maximum + (isSigned && maximum < 0.0f ? -0.5f : 0.5f)), (int32_t) (minimum + (isSigned && minimum < 0.0f ? -0.5f : 0.5f)) },
+		{ (int32_t) (innerMinimum + (innerMinimum < 0.0f ? -0.5f : 0.5f)), (int32_t) (innerMaximum + (innerMaximum < 0.0f ? -0.5f : 0.5f)) },
+	};
+	uint32_t candidateCount = (quality >= HbImage_BC_Quality_Normal ? 2 : 1);
+	int32_t searchRadius = (quality >= HbImage_BC_Quality_High ? 2 : 0);
+	int32_t bestEndpoints[2] = { candidates[0][0], candidates[0][1] };
+	uint8_t bestIndices[16], indices[16];
+	float bestError = FLT_MAX;
+	for (uint32_t candidateIndex = 0; candidateIndex < candidateCount; ++candidateIndex) {
+		for (int32_t offset0 = -searchRadius; offset0 <= searchRadius; ++offset0) {
+			for (int32_t offset1 = -searchRadius; offset1 <= searchRadius; ++offset1) {
+				int32_t endpoint0 = HbClampI32(candidates[candidateIndex][0] + offset0, valueMin, valueMax);
+				int32_t endpoint1 = HbClampI32(candidates[candidateIndex][1] + offset1, valueMin, valueMax);
+				// Staying in the mode of the candidate, though equal endpoints are fine for both.
+				if (candidateIndex == 0 ? endpoint0 < endpoint1 : endpoint0 > endpoint1) {
+					continue;
+				}
+				float error = HbImage_BCi_Encode_3DcEvaluate(values, isSigned, endpoint0, endpoint1, indices);
+				if (error < bestError) {
+					bestError = error;
+					bestEndpoints[0] = endpoint0;
+					bestEndpoints[1] = endpoint1;
+					memcpy(bestIndices, indices, sizeof(bestIndices));
+				}
+			}
+		}
+	}
+	block[0] = (uint8_t) bestEndpoints[0];
+	block[1] = (uint8_t) bestEndpoints[1];
+	uint64_t packedIndices = 0;
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		packedIndices |= (uint64_t) bestIndices[texel] << (texel * 3);
+	}
+	for (uint32_t byteIndex = 0; byteIndex < 6; ++byteIndex) {
+		block[2 + byteIndex] = (uint8_t) (packedIndices >> (byteIndex * 8));
+	}
+}
+
+/*******
+ * BPTC
+ *******/
+
+// Quantized endpoints of a subset, without P-bits.
+typedef struct HbImage_BCi_Encode_BPTCSubset {
+	uint32_t endpoints[2][4];
+	uint32_t pBits[2]; // Same for both endpoints with shared P-bits.
+} HbImage_BCi_Encode_BPTCSubset;
+
+// Quantizes an endpoint to the bits of its channels with the P-bit (-1 if there's none), returns the squared error of the expanded value.
+static float HbImage_BCi_Encode_QuantizeBPTCEndpoint(float const * endpoint, uint32_t channelCount, uint32_t const * bits, int32_t pBit,
+		uint32_t * quantized, uint32_t * expanded) {
+	float error = 0.0f;
+	for (uint32_t channel = 0; channel < channelCount; ++channel) {
+		uint32_t channelBits = bits[channel] + (pBit >= 0), value;
+		float level = endpoint[channel] * ((float) ((1u << channelBits) - 1) / 255.0f);
+		uint32_t quantizedMax = (1u << bits[channel]) - 1;
+		if (pBit >= 0) {
+			quantized[channel] = (uint32_t) HbClampF((level - (float) pBit) * 0.5f + 0.5f, 0.0f, (float) quantizedMax);
+			value = (quantized[channel] << 1) | (uint32_t) pBit;
+		} else {
+			quantized[channel] = (uint32_t) HbClampF(level + 0.5f, 0.0f, (float) quantizedMax);
+			value = quantized[channel];
+		}
+		expanded[channel] = (value << (8 - channelBits)) | (value >> (2 * channelBits - 8));
+		float difference = (float) expanded[channel] - endpoint[channel];
+		error += difference * difference;
+	}
+	return error;
+}
+
+// Fits the endpoints of a subset with the texels in texelMask. Returns the sum of the squared errors.
+static float HbImage_BCi_Encode_FitBPTCSubset(float const (* channels)[16], uint32_t channelCount, uint32_t const * bits,
+		HbBool endpointPBits, HbBool sharedPBits, uint32_t indexBits, uint32_t texelMask, uint32_t iterationCount,
+		HbImage_BCi_Encode_BPTCSubset * subset, uint8_t * indices) {
+	float endpoints[2][4];
+	HbImage_BCi_Encode_FitLine(channels, channelCount, texelMask, endpoints);
+	uint32_t paletteSize = 1u << indexBits;
+	uint8_t const * weights = HbImagei_BC_Weights[indexBits];
+	float weightsFloat[16];
+	for (uint32_t entry = 0; entry < paletteSize; ++entry) {
+		weightsFloat[entry] = (float) weights[entry] * (1.0f / 64.0f);
+	}
+	float bestError = FLT_MAX;
+	for (uint32_t iteration = 0; ; ++iteration) {
+		HbImage_BCi_Encode_BPTCSubset candidate;
+		uint32_t expanded[2][4];
+		if (sharedPBits) {
+			float pBitError = FLT_MAX;
+			for (int32_t pBit = 0; pBit < 2; ++pBit) {
+				uint32_t pBitQuantized[2][4], pBitExpanded[2][4];
+				float error = HbImage_BCi_Encode_QuantizeBPTCEndpoint(endpoints[0], channelCount, bits, pBit, pBitQuantized[0], pBitExpanded[0]) +
+						HbImage_BCi_Encode_QuantizeBPTCEndpoint(endpoints[1], channelCount, bits, pBit, pBitQuantized[1], pBitExpanded[1]);
+				if (error < pBitError) {
+					pBitError = error;
+					memcpy(candidate.endpoints, pBitQuantized, sizeof(pBitQuantized));
+					memcpy(expanded, pBitExpanded, sizeof(pBitExpanded));
+					candidate.pBits[0] = candidate.pBits[1] = (uint32_t) pBit;
+				}
+			}
+		} else {
+			for (uint32_t endpointIndex = 0; endpointIndex < 2; ++endpointIndex) {
+				if (!endpointPBits) {
+					HbImage_BCi_Encode_QuantizeBPTCEndpoint(endpoints[endpointIndex], channelCount, bits, -1,
+							candidate.endpoints[endpointIndex], expanded[endpointIndex]);
+					candidate.pBits[endpointIndex] = 0;
+					continue;
+				}
+				float pBitError = FLT_MAX;
+				for (int32_t pBit = 0; pBit < 2; ++pBit) {
+					uint32_t pBitQuantized[4], pBitExpanded[4];
+					float error = HbImage_BCi_Encode_QuantizeBPTCEndpoint(endpoints[endpointIndex], channelCount, bits, pBit,
+							pBitQuantized, pBitExpanded);
+					if (error < pBitError) {
+						pBitError = error;
+						memcpy(candidate.endpoints[endpointIndex], pBitQuantized, sizeof(pBitQuantized));
+						memcpy(expanded[endpointIndex], pBitExpanded, sizeof(pBitExpanded));
+						candidate.pBits[endpointIndex] = (uint32_t) pBit;
+					}
+				}
+			}
+		}
+		float palette[16][4];
+		for (uint32_t entry = 0; entry < paletteSize; ++entry) {
+			for (uint32_t channel = 0; channel < channelCount; ++channel) {
+				palette[entry][channel] = (float) HbImagei_BC_BPTC_Interpolate(expanded[0][channel], expanded[1][channel], weights[entry]);
+			}
+		}
+		uint8_t candidateIndices[16];
+		float error = HbImage_BCi_Encode_SelectIndices(channels, channelCount, palette, paletteSize, texelMask, candidateIndices);
+		if (error < bestError) {
+			bestError = error;
+			*subset = candidate;
+			for (uint32_t texel = 0; texel < 16; ++texel) {
+				if (texelMask & (1u << texel)) {
+					indices[texel] = candidateIndices[texel];
+				}
+			}
+		}
+		if (iteration >= iterationCount ||
+				!HbImage_BCi_Encode_FitIndices(channels, channelCount, texelMask, candidateIndices, weightsFloat, endpoints)) {
+			break;
+		}
+		for (uint32_t endpointIndex = 0; endpointIndex < 2; ++endpointIndex) {
+			for (uint32_t channel = 0; channel < channelCount; ++channel) {
+				endpoints[endpointIndex][channel] = HbClampF(endpoints[endpointIndex][channel], 0.0f, 255.0f);
+			}
+		}
+	}
+	return bestError;
+}
+
+// The highest bit of the index of the anchor texel of every subset is not stored and must be 0 - swapping the endpoints if it isn't.
+static void HbImage_BCi_Encode_FixBPTCAnchor(HbImage_BCi_Encode_BPTCSubset * subset, uint32_t indexBits, uint32_t texelMask,
+		uint32_t anchorTexel, uint8_t * indices) {
+	uint32_t indexMax = (1u << indexBits) - 1;
+	if (indices[anchorTexel] <= (indexMax >> 1)) {
+		return;
+	}
+	for (uint32_t channel = 0; channel < 4; ++channel) {
+		uint32_t endpoint = subset->endpoints[0][channel];
+		subset->endpoints[0][channel] = subset->endpoints[1][channel];
+		subset->endpoints[1][channel] = endpoint;
+	}
+	uint32_t pBit = subset->pBits[0];
+	subset->pBits[0] = subset->pBits[1];
+	subset->pBits[1] = pBit;
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		if (texelMask & (1u << texel)) {
+			indices[texel] = (uint8_t) (indexMax - indices[texel]);
+		}
+	}
+}
+
+// Blocks are written from the lowest bit of the first byte.
+typedef struct HbImage_BCi_Encode_Bits {
+	uint64_t low;
+	uint64_t high;
+	uint32_t position;
+} HbImage_BCi_Encode_Bits;
+
+// Up to 32 bits.
+HbForceInline void HbImage_BCi_Encode_Bits_Write(HbImage_BCi_Encode_Bits * bits, uint32_t value, uint32_t count) {
+	uint64_t maskedValue = value & ((1ull << count) - 1);
+	uint32_t position = bits->position;
+	if (position >= 64) {
+		bits->high |= maskedValue << (position - 64);
+	} else {
+		bits->low |= maskedValue << position;
+		if (position + count > 64) {
+			bits->high |= maskedValue >> (64 - position);
+		}
+	}
+	bits->position = position + count;
+}
+
+// For mode 5, the alpha of the color endpoints is the separate alpha, and the secondary indices are the alpha ones.
+static void HbImage_BCi_Encode_WriteBPTC(uint32_t modeIndex, uint32_t partition, uint32_t rotation,
+		HbImage_BCi_Encode_BPTCSubset const * subsets, uint8_t const * indices, uint8_t const * secondaryIndices, uint8_t * block) {
+	HbImagei_BC_BPTC_Mode const * mode = &HbImagei_BC_BPTC_Modes[modeIndex];
+	HbImage_BCi_Encode_Bits bits = { 0 };
+	HbImage_BCi_Encode_Bits_Write(&bits, 1u << modeIndex, modeIndex + 1);
+	HbImage_BCi_Encode_Bits_Write(&bits, partition, mode->partitionBits);
+	HbImage_BCi_Encode_Bits_Write(&bits, rotation, mode->rotationBits);
+	HbImage_BCi_Encode_Bits_Write(&bits, 0, mode->indexSelectionBits);
+	uint32_t endpointCount = mode->subsetCount * 2;
+	for (uint32_t channel = 0; channel < 3; ++channel) {
+		for (uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex) {
+			HbImage_BCi_Encode_Bits_Write(&bits, subsets[endpointIndex >> 1].endpoints[endpointIndex & 1][channel], mode->colorBits);
+		}
+	}
+	for (uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex) {
+		HbImage_BCi_Encode_Bits_Write(&bits, subsets[endpointIndex >> 1].endpoints[endpointIndex & 1][3], mode->alphaBits);
+	}
+	if (mode->endpointPBits) {
+		for (uint32_t endpointIndex = 0; endpointIndex < endpointCount; ++endpointIndex) {
+			HbImage_BCi_Encode_Bits_Write(&bits, subsets[endpointIndex >> 1].pBits[endpointIndex & 1], 1);
+		}
+	} else if (mode->sharedPBits) {
+		for (uint32_t subsetIndex = 0; subsetIndex < mode->subsetCount; ++subsetIndex) {
+			HbImage_BCi_Encode_Bits_Write(&bits, subsets[subsetIndex].pBits[0], 1);
+		}
+	}
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		HbImage_BCi_Encode_Bits_Write(&bits, indices[texel],
+				mode->indexBits - HbImagei_BC_BPTC_IsAnchor(mode->subsetCount, partition, texel));
+	}
+	if (mode->secondaryIndexBits != 0) {
+		for (uint32_t texel = 0; texel < 16; ++texel) {
+			HbImage_BCi_Encode_Bits_Write(&bits, secondaryIndices[texel], mode->secondaryIndexBits - (texel == 0));
+		}
+	}
+	memcpy(block, &bits.low, sizeof(uint64_t));
+	memcpy(block + sizeof(uint64_t), &bits.high, sizeof(uint64_t));
+}
+
+HbForceInline uint32_t HbImage_BCi_Encode_GetBPTCSubsetMask(uint32_t subsetCount, uint32_t partition, uint32_t subsetIndex) {
+	if (subsetCount < 2) {
+		return 0xFFFF;
+	}
+	uint32_t subset1Mask = HbImagei_BC_Partitions2[partition];
+	return subsetIndex != 0 ? subset1Mask : (~subset1Mask & 0xFFFF);
+}
+
+// Modes with up to 2 subsets where the alpha (if present) is interpolated with the same indices as the color.
+static void HbImage_BCi_Encode_BPTCCombined(HbImage_BCi_Encode_Texels const * texels, uint32_t modeIndex, uint32_t partition,
+		uint32_t iterationCount, uint8_t * block) {
+	HbImagei_BC_BPTC_Mode const * mode = &HbImagei_BC_BPTC_Modes[modeIndex];
+	uint32_t bits[4] = { mode->colorBits, mode->colorBits, mode->colorBits, mode->alphaBits };
+	uint32_t channelCount = (mode->alphaBits != 0 ? 4 : 3);
+	HbImage_BCi_Encode_BPTCSubset subsets[2];
+	uint8_t indices[16];
+	for (uint32_t subsetIndex = 0; subsetIndex < mode->subsetCount; ++subsetIndex) {
+		HbImage_BCi_Encode_BPTCSubset * subset = &subsets[subsetIndex];
+		memset(subset, 0, sizeof(HbImage_BCi_Encode_BPTCSubset));
+		uint32_t texelMask = HbImage_BCi_Encode_GetBPTCSubsetMask(mode->subsetCount, partition, subsetIndex);
+		HbImage_BCi_Encode_FitBPTCSubset(texels->channels, channelCount, bits, mode->endpointPBits, mode->sharedPBits, mode->indexBits,
+				texelMask, iterationCount, subset, indices);
+		HbImage_BCi_Encode_FixBPTCAnchor(subset, mode->indexBits, texelMask,
+				subsetIndex != 0 ? HbImagei_BC_Anchors2Of2[partition] : 0, indices);
+	}
+	HbImage_BCi_Encode_WriteBPTC(modeIndex, partition, 0, subsets, indices, NULL, block);
+}
+
+// Mode 5 - one subset with the alpha interpolated separately, after swapping it with the color channel selected by the rotation.
+static void HbImage_BCi_Encode_BPTCSeparateAlpha(HbImage_BCi_Encode_Texels const * texels, uint32_t rotation,
+		uint32_t iterationCount, uint8_t * block) {
+	HbImagei_BC_BPTC_Mode const * mode = &HbImagei_BC_BPTC_Modes[5];
+	HbImage_BCi_Encode_Texels rotated = *texels;
+	if (rotation != 0) {
+		memcpy(rotated.channels[rotation - 1], texels->channels[3], sizeof(rotated.channels[3]));
+		memcpy(rotated.channels[3], texels->channels[rotation - 1], sizeof(rotated.channels[3]));
+	}
+	uint32_t colorBits[3] = { mode->colorBits, mode->colorBits, mode->colorBits }, alphaBits = mode->alphaBits;
+	HbImage_BCi_Encode_BPTCSubset colorSubset = { 0 }, alphaSubset = { 0 };
+	uint8_t colorIndices[16], alphaIndices[16];
+	HbImage_BCi_Encode_FitBPTCSubset(rotated.channels, 3, colorBits, HbFalse, HbFalse, mode->indexBits,
+			0xFFFF, iterationCount, &colorSubset, colorIndices);
+	HbImage_BCi_Encode_FixBPTCAnchor(&colorSubset, mode->indexBits, 0xFFFF, 0, colorIndices);
+	HbImage_BCi_Encode_FitBPTCSubset(&rotated.channels[3], 1, &alphaBits, HbFalse, HbFalse, mode->secondaryIndexBits,
+			0xFFFF, iterationCount, &alphaSubset, alphaIndices);
+	HbImage_BCi_Encode_FixBPTCAnchor(&alphaSubset, mode->secondaryIndexBits, 0xFFFF, 0, alphaIndices);
+	colorSubset.endpoints[0][3] = alphaSubset.endpoints[0][0];
+	colorSubset.endpoints[1][3] = alphaSubset.endpoints[1][0];
+	HbImage_BCi_Encode_WriteBPTC(5, 0, rotation, &colorSubset, colorIndices, alphaIndices, block);
+}
+
+// Estimates the error of every 2-subset partition with unquantized endpoints, and returns the best ones, in order, in partitions.
+static void HbImage_BCi_Encode_FindBPTCPartitions(HbImage_BCi_Encode_Texels const * texels, uint32_t channelCount, uint32_t indexBits,
+		uint32_t * partitions, uint32_t partitionCount) {
+	float partitionErrors[64];
+	uint32_t paletteSize = 1u << indexBits;
+	uint8_t const * weights = HbImagei_BC_Weights[indexBits];
+	for (uint32_t partition = 0; partition < 64; ++partition) {
+		float error = 0.0f;
+		for (uint32_t subsetIndex = 0; subsetIndex < 2; ++subsetIndex) {
+			uint32_t texelMask = HbImage_BCi_Encode_GetBPTCSubsetMask(2, partition, subsetIndex);
+			float endpoints[2][4], palette[16][4];
+			HbImage_BCi_Encode_FitLine(texels->channels, channelCount, texelMask, endpoints);
+			for (uint32_t entry = 0; entry < paletteSize; ++entry) {
+				float weight1 = (float) weights[entry] * (1.0f / 64.0f), weight0 = 1.0f - weight1;
+				for (uint32_t channel = 0; channel < channelCount; ++channel) {
+					palette[entry][channel] = endpoints[0][channel] * weight0 + endpoints[1][channel] * weight1;
+				}
+			}
+			uint8_t indices[16];
+			error += HbImage_BCi_Encode_SelectIndices(texels->channels, channelCount, palette, paletteSize, texelMask, indices);
+		}
+		partitionErrors[partition] = error;
+	}
+	// Insertion of the partitions into the sorted list of the best ones.
+	uint32_t foundCount = 0;
+	for (uint32_t partition = 0; partition < 64; ++partition) {
+		uint32_t position = foundCount;
+		while (position > 0 && partitionErrors[partition] < partitionErrors[partitions[position - 1]]) {
+			if (position < partitionCount) {
+				partitions[position] = partitions[position - 1];
+			}
+			--position;
+		}
+		if (position < partitionCount) {
+			partitions[position] = partition;
+			foundCount = HbMinU32(foundCount + 1, partitionCount);
+		}
+	}
+}
+
+// Decodes the candidate block and replaces the best one with it if it's closer to the texels.
+static void HbImage_BCi_Encode_TryBPTC(HbImage_BCi_Encode_Texels const * texels, uint8_t const * candidate,
+		float * bestError, uint8_t * block) {
+	uint8_t decoded[16][4];
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_BPTC_UNorm, candidate, decoded, 4 * 4);
+	float error = 0.0f;
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		for (uint32_t channel = 0; channel < 4; ++channel) {
+			float difference = (float) decoded[texel][channel] - texels->channels[channel][texel];
+			error += difference * difference;
+		}
+	}
+	if (error < *bestError) {
+		*bestError = error;
+		memcpy(block, candidate, 16);
+	}
+}
+
+static void HbImage_BCi_Encode_BPTC(HbImage_BCi_Encode_Texels const * texels, HbImage_BC_Quality quality, uint8_t * block) {
+	HbBool isOpaque = HbTrue;
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		if (texels->channels[3][texel] != 255.0f) {
+			isOpaque = HbFalse;
+			break;
+		}
+	}
+	uint32_t iterationCount = (quality >= HbImage_BC_Quality_High ? 2 : (quality >= HbImage_BC_Quality_Normal ? 1 : 0));
+	float bestError = FLT_MAX;
+	uint8_t candidate[16];
+	HbImage_BCi_Encode_BPTCCombined(texels, 6, 0, iterationCount, candidate);
+	if (quality < HbImage_BC_Quality_Normal) {
+		memcpy(block, candidate, 16);
+		return;
+	}
+	HbImage_BCi_Encode_TryBPTC(texels, candidate, &bestError, block);
+	uint32_t partitions[4];
+	uint32_t partitionCount = (quality >= HbImage_BC_Quality_High ? 4 : 1);
+	if (isOpaque) {
+		// Mode 1 - 3-bit indices, mode 3 - 2-bit indices with more precise endpoints.
+		HbImage_BCi_Encode_FindBPTCPartitions(texels, 3, 3, partitions, partitionCount);
+		for (uint32_t partitionIndex = 0; partitionIndex < partitionCount; ++partitionIndex) {
+			HbImage_BCi_Encode_BPTCCombined(texels, 1, partitions[partitionIndex], iterationCount, candidate);
+			HbImage_BCi_Encode_TryBPTC(texels, candidate, &bestError, block);
+			if (quality >= HbImage_BC_Quality_High) {
+				HbImage_BCi_Encode_BPTCCombined(texels, 3, partitions[partitionIndex], iterationCount, candidate);
+				HbImage_BCi_Encode_TryBPTC(texels, candidate, &bestError, block);
+			}
+		}
+	} else {
+		uint32_t rotationCount = (quality >= HbImage_BC_Quality_High ? 4 : 1);
+		for (uint32_t rotation = 0; rotation < rotationCount; ++rotation) {
+			HbImage_BCi_Encode_BPTCSeparateAlpha(texels, rotation, iterationCount, candidate);
+			HbImage_BCi_Encode_TryBPTC(texels, candidate, &bestError, block);
+		}
+		if (quality >= HbImage_BC_Quality_High) {
+			// Mode 7 - 2 subsets with alpha.
+			HbImage_BCi_Encode_FindBPTCPartitions(texels, 4, 2, partitions, partitionCount);
+			for (uint32_t partitionIndex = 0; partitionIndex < partitionCount; ++partitionIndex) {
+				HbImage_BCi_Encode_BPTCCombined(texels, 7, partitions[partitionIndex], iterationCount, candidate);
+				HbImage_BCi_Encode_TryBPTC(texels, candidate, &bestError, block);
+			}
+		}
+	}
+}
+
+/********************************
+ * Block, row and image encoding
+ ********************************/
+
+HbBool HbImage_BC_CanEncode(HbGPU_Image_Format format) {
+	switch (format) {
+	case HbGPU_Image_Format_S3TC_A1_UNorm:
+	case HbGPU_Image_Format_S3TC_A1_sRGB:
+	case HbGPU_Image_Format_S3TC_A8_UNorm:
+	case HbGPU_Image_Format_S3TC_A8_sRGB:
+	case HbGPU_Image_Format_3Dc_R_UNorm:
+	case HbGPU_Image_Format_3Dc_R_SNorm:
+	case HbGPU_Image_Format_3Dc_RG_UNorm:
+	case HbGPU_Image_Format_3Dc_RG_SNorm:
+	case HbGPU_Image_Format_BPTC_UNorm:
+	case HbGPU_Image_Format_BPTC_sRGB:
+		return HbTrue;
+	default:
+		break;
+	}
+	return HbFalse;
+}
+
+static void HbImage_BCi_Encode_Texels_ToBlock(HbGPU_Image_Format format, HbImage_BC_Quality quality,
+		HbImage_BCi_Encode_Texels const * texels, uint8_t * block) {
+	switch (format) {
+	case HbGPU_Image_Format_S3TC_A1_UNorm:
+	case HbGPU_Image_Format_S3TC_A1_sRGB:
+		HbImage_BCi_Encode_S3TCColor(texels, quality, HbTrue, block);
+		break;
+	case HbGPU_Image_Format_S3TC_A8_UNorm:
+	case HbGPU_Image_Format_S3TC_A8_sRGB:
+		HbImage_BCi_Encode_3Dc(&texels->channels[3], HbFalse, quality, block);
+		HbImage_BCi_Encode_S3TCColor(texels, quality, HbFalse, block + 8);
+		break;
+	case HbGPU_Image_Format_3Dc_R_UNorm:
+	case HbGPU_Image_Format_3Dc_R_SNorm:
+		HbImage_BCi_Encode_3Dc(&texels->channels[0], format == HbGPU_Image_Format_3Dc_R_SNorm, quality, block);
+		break;
+	case HbGPU_Image_Format_3Dc_RG_UNorm:
+	case HbGPU_Image_Format_3Dc_RG_SNorm:
+		HbImage_BCi_Encode_3Dc(&texels->channels[0], format == HbGPU_Image_Format_3Dc_RG_SNorm, quality, block);
+		HbImage_BCi_Encode_3Dc(&texels->channels[1], format == HbGPU_Image_Format_3Dc_RG_SNorm, quality, block + 8);
+		break;
+	case HbGPU_Image_Format_BPTC_UNorm:
+	case HbGPU_Image_Format_BPTC_sRGB:
+		HbImage_BCi_Encode_BPTC(texels, quality, block);
+		break;
+	default:
+		HbFeedback_Crash("HbImage_BCi_Encode_Texels_ToBlock", "Format %u can't be encoded.", (uint32_t) format);
+	}
+}
+
+void HbImage_BC_EncodeBlock(HbGPU_Image_Format format, HbImage_BC_Quality quality, void const * source, size_t sourceRowPitch, void * block) {
+	HbImage_BCi_Encode_Texels texels;
+	HbImage_BCi_Encode_LoadTexels(format, (uint8_t const *) source, 4, 4, sourceRowPitch, &texels);
+	HbImage_BCi_Encode_Texels_ToBlock(format, quality, &texels, (uint8_t *) block);
+}
+
+void HbImage_BC_EncodeBlockRow(HbGPU_Image_Format format, HbImage_BC_Quality quality, void const * source,
+		uint32_t texelWidth, uint32_t texelRowCount, size_t sourceRowPitch, void * blocks) {
+	uint8_t const * texelSource = (uint8_t const *) source;
+	uint8_t * block = (uint8_t *) blocks;
+	uint32_t blockSize = HbGPU_Image_Copy_ElementSize(format, HbFalse);
+	uint32_t texelSize = HbGPU_Image_Copy_ElementSize(HbImage_BC_GetDecodedFormat(format), HbFalse);
+	texelRowCount = HbMinU32(texelRowCount, 4);
+	for (uint32_t texelX = 0; texelX < texelWidth; texelX += 4) {
+		HbImage_BCi_Encode_Texels texels;
+		HbImage_BCi_Encode_LoadTexels(format, texelSource + texelX * texelSize, HbMinU32(texelWidth - texelX, 4), texelRowCount,
+				sourceRowPitch, &texels);
+		HbImage_BCi_Encode_Texels_ToBlock(format, quality, &texels, block);
+		block += blockSize;
+	}
+}
+
+// Chunks of block rows are taken by the threads until there are none left, in the order of the mips in the target.
+typedef struct HbImage_BCi_Encode_Task {
+	HbGPU_Image_Info const * info;
+	HbImage_BC_Quality quality;
+	HbImage_BC_Encode_SourceMip const * sourceMips;
+	uint8_t * target;
+	uint32_t blockSize;
+	uint32_t mipChunkFirsts[(1 << HbGPU_Image_MipCountBits) + 1]; // Within a layer.
+	uint64_t mipTargetOffsets[1 << HbGPU_Image_MipCountBits]; // Within a layer.
+	uint64_t layerTargetSize;
+	uint32_t chunkCount;
+	uint32_t volatile nextChunk;
+} HbImage_BCi_Encode_Task;
+
+static void HbImage_BCi_Encode_RunThread(void * data) {
+	HbImage_BCi_Encode_Task * task = (HbImage_BCi_Encode_Task *) data;
+	HbGPU_Image_Info const * info = task->info;
+	uint32_t layerChunkCount = task->mipChunkFirsts[info->mips];
+	for (;;) {
+		uint32_t chunk = HbAtomic_IncrementU32(&task->nextChunk) - 1;
+		if (chunk >= task->chunkCount) {
+			break;
+		}
+		uint32_t layer = chunk / layerChunkCount, layerChunk = chunk - layer * layerChunkCount;
+		uint32_t mip = 0;
+		while (layerChunk >= task->mipChunkFirsts[mip + 1]) {
+			++mip;
+		}
+		uint32_t mipWidth = info->width, mipHeight = info->height, mipDepth = HbGPU_Image_Info_Get3DDepth(info);
+		HbGPU_Image_MipSize(mip, info->dimensions, &mipWidth, &mipHeight, &mipDepth);
+		uint32_t blocksHigh = (mipHeight + 3) >> 2;
+		size_t blockRowSize = (size_t) ((mipWidth + 3) >> 2) * task->blockSize;
+		HbImage_BC_Encode_SourceMip const * sourceMip = &task->sourceMips[layer * info->mips + mip];
+		uint8_t * mipTarget = task->target + layer * task->layerTargetSize + task->mipTargetOffsets[mip];
+		uint32_t blockRowFirst = (layerChunk - task->mipChunkFirsts[mip]) * HbImage_BC_Encode_BlockRowsPerChunk;
+		uint32_t blockRowEnd = HbMinU32(blockRowFirst + HbImage_BC_Encode_BlockRowsPerChunk, blocksHigh * mipDepth);
+		for (uint32_t blockRow = blockRowFirst; blockRow < blockRowEnd; ++blockRow) {
+			uint32_t slice = blockRow / blocksHigh, sliceBlockRow = blockRow - slice * blocksHigh;
+			HbImage_BC_EncodeBlockRow(info->format, task->quality,
+					(uint8_t const *) sourceMip->texels + slice * sourceMip->slicePitch + sliceBlockRow * 4 * sourceMip->rowPitch,
+					mipWidth, mipHeight - sliceBlockRow * 4, sourceMip->rowPitch, mipTarget + blockRow * blockRowSize);
+		}
+	}
+}
+
+void HbImage_BC_EncodeImage(HbGPU_Image_Info const * info, HbImage_BC_Quality quality, HbImage_BC_Encode_SourceMip const * sourceMips,
+		void * target, uint32_t threadCount) {
+	if (!HbImage_BC_CanEncode(info->format)) {
+		HbFeedback_Crash("HbImage_BC_EncodeImage", "Format %u can't be encoded.", (uint32_t) info->format);
+	}
+	HbImage_BCi_Encode_Task task;
+	task.info = info;
+	task.quality = quality;
+	task.sourceMips = sourceMips;
+	task.target = (uint8_t *) target;
+	task.blockSize = HbGPU_Image_Copy_ElementSize(info->format, HbFalse);
+	uint32_t layerChunkCount = 0;
+	uint64_t layerTargetSize = 0;
+	for (uint32_t mip = 0; mip < info->mips; ++mip) {
+		uint32_t mipHeight = info->height, mipDepth = HbGPU_Image_Info_Get3DDepth(info);
+		HbGPU_Image_MipSize(mip, info->dimensions, NULL, &mipHeight, &mipDepth);
+		task.mipChunkFirsts[mip] = layerChunkCount;
+		layerChunkCount += (((mipHeight + 3) >> 2) * mipDepth + (HbImage_BC_Encode_BlockRowsPerChunk - 1)) /
+				HbImage_BC_Encode_BlockRowsPerChunk;
+		task.mipTargetOffsets[mip] = layerTargetSize;
+		layerTargetSize += HbFile_DDS_GetMipDataSize(info, mip);
+	}
+	task.mipChunkFirsts[info->mips] = layerChunkCount;
+	task.layerTargetSize = layerTargetSize;
+	uint32_t layerCount = HbGPU_Image_Info_GetArrayLayers(info);
+	if (HbGPU_Image_Dimensions_AreCube(info->dimensions)) {
+		layerCount *= 6;
+	}
+	task.chunkCount = layerChunkCount * layerCount;
+	task.nextChunk = 0;
+	threadCount = HbMinU32(HbMinU32(threadCount, task.chunkCount), HbImage_BC_Encode_MaxThreads);
+	threadCount = HbMaxU32(threadCount, 1);
+	// The calling thread takes chunks too, and the chunks not taken by threads that couldn't be started will be taken by the others.
+	HbParallel_Thread threads[HbImage_BC_Encode_MaxThreads];
+	HbBool threadsStarted[HbImage_BC_Encode_MaxThreads];
+	for (uint32_t threadIndex = 1; threadIndex < threadCount; ++threadIndex) {
+		threadsStarted[threadIndex] = HbParallel_Thread_Start(&threads[threadIndex], "HbImageEncode", HbImage_BCi_Encode_RunThread, &task);
+	}
+	HbImage_BCi_Encode_RunThread(&task);
+	for (uint32_t threadIndex = 1; threadIndex < threadCount; ++threadIndex) {
+		if (threadsStarted[threadIndex]) {
+			HbParallel_Thread_Destroy(&threads[threadIndex]);
+		}
+	}
+}
+
+void HbImage_BC_EncodeMip(HbGPU_Image_Format format, HbImage_BC_Quality quality, HbImage_BC_Encode_SourceMip const * source,
+		uint32_t width, uint32_t height, uint32_t depth, void * target, uint32_t threadCount) {
+	HbGPU_Image_Info info = { 0 };
+	info.format = format;
+	info.dimensions = depth > 1 ? HbGPU_Image_Dimensions_3D : HbGPU_Image_Dimensions_2D;
+	info.width = width;
+	info.height = height;
+	info.depthOrLayers = depth;
+	info.mips = 1;
+	HbImage_BC_EncodeImage(&info, quality, source, target, threadCount);
+}
+
+size_t HbImage_BC_EncodeDDS(HbGPU_Image_Info const * info, HbImage_BC_Quality quality, HbImage_BC_Encode_SourceMip const * sourceMips,
+		void * dds, uint32_t threadCount) {
+	uint8_t head[HbFile_DDS_MaxHeadSize];
+	uint32_t headSize = HbFile_DDS_WriteHead(info, head);
+	if (headSize == 0) {
+		HbFeedback_Crash("HbImage_BC_EncodeDDS", "Format %u can't be stored in DDS.", (uint32_t) info->format);
+	}
+	size_t ddsSize = headSize + (size_t) HbFile_DDS_GetImageDataSize(info);
+	if (dds != NULL) {
+		memcpy(dds, head, headSize);
+		HbImage_BC_EncodeImage(info, quality, sourceMips, (uint8_t *) dds + headSize, threadCount);
+	}
+	return ddsSize;
+}
@@ -0,0 +1,398 @@
+#include "HbFeedback.h"
+#include "HbImage.h"
+#include "HbMath.h"
+#include "HbParallel.h"
+
+/**********
+ * Filters
+ **********/
+
+// Kaiser-windowed sinc, with the radius in target texels and the parameters commonly used for mipmapping.
+#define HbImage_Mipi_Kaiser_Radius 3.0
+#define HbImage_Mipi_Kaiser_Alpha 4.0
+
+// Source texels contributing to one target texel along one axis, with the edge addressing already applied to the indices.
+typedef struct HbImage_Mipi_Tap {
+	uint32_t index;
+	float weight;
+} HbImage_Mipi_Tap;
+
+typedef struct HbImage_Mipi_Axis {
+	uint32_t sourceSize;
+	uint32_t targetSize;
+	uint32_t tapCount; // Per target texel, the same for all of them, with zero weights for the unused ones.
+	HbImage_Mipi_Tap * taps;
+} HbImage_Mipi_Axis;
+
+static double HbImage_Mipi_BesselI0(double x) {
+	// Power series - converges quickly for the arguments in the Kaiser window.
+	double sum = 1.0, term = 1.0, quarterXSquared = 0.25 * x * x;
+	for (uint32_t k = 1; k < 64; ++k) {
+		term *= quarterXSquared / (double) (k * k);
+		sum += term;
+		if (term < sum * 1.0e-12) {
+			break;
+		}
+	}
+	return sum;
+}
+
+// The range of the source texels that may contribute to the target texel.
+static void HbImage_Mipi_Axis_GetTapRange(HbImage_Mip_Filter filter, uint32_t sourceSize, uint32_t targetSize, uint32_t target,
+		int32_t * first, int32_t * end) {
+	double scale = (double) sourceSize / (double) targetSize;
+	if (filter == HbImage_Mip_Filter_Kaiser) {
+		double center = ((double) target + 0.5) * scale, radius = HbImage_Mipi_Kaiser_Radius * scale;
+		*first = (int32_t) floor(center - radius - 0.5);
+		*end = (int32_t) ceil(center + radius - 0.5) + 1;
+	} else {
+		*first = (int32_t) floor((double) target * scale);
+		*end = (int32_t) ceil(((double) target + 1.0) * scale);
+	}
+}
+
+// Not normalized.
+static double HbImage_Mipi_Axis_GetWeight(HbImage_Mip_Filter filter, uint32_t sourceSize, uint32_t targetSize, uint32_t target,
+		int32_t source) {
+	double scale = (double) sourceSize / (double) targetSize;
+	if (filter == HbImage_Mip_Filter_Kaiser) {
+		// The distance in target texels, with the cutoff frequency of the sinc at the Nyquist frequency of the target.
+		double distance = (((double) source + 0.5) - ((double) target + 0.5) * scale) / scale;
+		double windowPosition = distance / HbImage_Mipi_Kaiser_Radius;
+		if (fabs(windowPosition) >= 1.0) {
+			return 0.0;
+		}
+		double sinc = 1.0;
+		if (fabs(distance) > 1.0e-9) {
+			sinc = sin(HbMath_F64_Pi * distance) / (HbMath_F64_Pi * distance);
+		}
+		double window = HbImage_Mipi_BesselI0(HbImage_Mipi_Kaiser_Alpha * sqrt(1.0 - windowPosition * windowPosition)) /
+				HbImage_Mipi_BesselI0(HbImage_Mipi_Kaiser_Alpha);
+		double weight = sinc * window;
+		// Zeros of the sinc computed imprecisely, such as when the size is not reduced along the axis.
+		return fabs(weight) < 1.0e-6 ? 0.0 : weight;
+	}
+	// The part of the source texel covered by the target texel.
+	double start = fmax((double) source, (double) target * scale), end = fmin((double) source + 1.0, ((double) target + 1.0) * scale);
+	return fmax(end - start, 0.0);
+}
+
+static uint32_t HbImage_Mipi_Axis_GetTapCount(HbImage_Mip_Filter filter, uint32_t sourceSize, uint32_t targetSize) {
+	uint32_t tapCount = 1;
+	for (uint32_t target = 0; target < targetSize; ++target) {
+		int32_t first, end, usedFirst = INT32_MAX, usedLast = INT32_MIN;
+		HbImage_Mipi_Axis_GetTapRange(filter, sourceSize, targetSize, target, &first, &end);
+		for (int32_t source = first; source < end; ++source) {
+			if (HbImage_Mipi_Axis_GetWeight(filter, sourceSize, targetSize, target, source) != 0.0) {
+				usedFirst = HbMinI32(usedFirst, source);
+				usedLast = HbMaxI32(usedLast, source);
+			}
+		}
+		if (usedFirst <= usedLast) {
+			tapCount = HbMaxU32(tapCount, (uint32_t) (usedLast - usedFirst + 1));
+		}
+	}
+	return tapCount;
+}
+
+// axis->taps must have targetSize * tapCount elements.
+static void HbImage_Mipi_Axis_FillTaps(HbImage_Mipi_Axis * axis, HbImage_Mip_Filter filter, HbBool wrap) {
+	uint32_t sourceSize = axis->sourceSize, targetSize = axis->targetSize;
+	for (uint32_t target = 0; target < targetSize; ++target) {
+		HbImage_Mipi_Tap * taps = &axis->taps[target * axis->tapCount];
+		int32_t first, end;
+		HbImage_Mipi_Axis_GetTapRange(filter, sourceSize, targetSize, target, &first, &end);
+		while (first < end && HbImage_Mipi_Axis_GetWeight(filter, sourceSize, targetSize, target, first) == 0.0) {
+			++first;
+		}
+		double weightSum = 0.0;
+		for (uint32_t tapIndex = 0; tapIndex < axis->tapCount; ++tapIndex) {
+			int32_t source = first + (int32_t) tapIndex;
+			double weight = source < end ? HbImage_Mipi_Axis_GetWeight(filter, sourceSize, targetSize, target, source) : 0.0;
+			if (wrap) {
+				source %= (int32_t) sourceSize;
+				if (source < 0) {
+					source += (int32_t) sourceSize;
+				}
+			} else {
+				source = HbClampI32(source, 0, (int32_t) sourceSize - 1);
+			}
+			taps[tapIndex].index = (uint32_t) source;
+			taps[tapIndex].weight = (float) weight;
+			weightSum += weight;
+		}
+		if (weightSum != 0.0) {
+			for (uint32_t tapIndex = 0; tapIndex < axis->tapCount; ++tapIndex) {
+				taps[tapIndex].weight = (float) (taps[tapIndex].weight / weightSum);
+			}
+		}
+	}
+}
+
+/********************
+ * Passes over a mip
+ ********************/
+
+typedef enum HbImage_Mipi_Stage {
+	HbImage_Mipi_Stage_Filter, // From the source to the target.
+	HbImage_Mipi_Stage_MeasureAlpha, // Of the target.
+	HbImage_Mipi_Stage_ScaleAlpha, // Of the target, in place.
+} HbImage_Mipi_Stage;
+
+typedef struct HbImage_Mipi_Pass {
+	HbImage_Mipi_Stage stage;
+	HbGPU_Image_Format format;
+	HbImage_Mip_Level const * source;
+	HbImage_Mip_Level const * target;
+	HbImage_Mipi_Axis axes[3]; // Only the sizes are used for the alpha stages, with the target size being the size of the mip.
+	HbBool gatherAlphaHistogram;
+	float alphaScale;
+} HbImage_Mipi_Pass;
+
+// Target rows of all the slices are numbered contiguously, the last job gets the remainder.
+typedef struct HbImage_Mipi_Job {
+	HbImage_Mipi_Pass const * pass;
+	uint32_t rowFirst;
+	uint32_t rowEnd;
+	float * sourceRow;
+	float * accumulatedRow;
+	float * targetRow;
+	uint32_t alphaHistogram[256]; // Of alpha rounded to 8 bits.
+} HbImage_Mipi_Job;
+
+HbForceInline void HbImage_Mipi_Job_AddToHistogram(HbImage_Mipi_Job * job, float const * rgba, uint32_t texelCount) {
+	for (uint32_t texel = 0; texel < texelCount; ++texel) {
+		++job->alphaHistogram[(uint32_t) (HbClampF(rgba[texel * 4 + 3], 0.0f, 1.0f) * 255.0f + 0.5f)];
+	}
+}
+
+static void HbImage_Mipi_Job_Filter(HbImage_Mipi_Job * job) {
+	HbImage_Mipi_Pass const * pass = job->pass;
+	HbImage_Mipi_Axis const * axisX = &pass->axes[0], * axisY = &pass->axes[1], * axisZ = &pass->axes[2];
+	uint32_t sourceWidth = axisX->sourceSize, targetWidth = axisX->targetSize;
+	HbMath_F32x4 * sourceRow = (HbMath_F32x4 *) job->sourceRow;
+	HbMath_F32x4 * accumulatedRow = (HbMath_F32x4 *) job->accumulatedRow;
+	HbMath_F32x4 * targetRow = (HbMath_F32x4 *) job->targetRow;
+	for (uint32_t row = job->rowFirst; row < job->rowEnd; ++row) {
+		uint32_t targetZ = row / axisY->targetSize, targetY = row - targetZ * axisY->targetSize;
+		for (uint32_t x = 0; x < sourceWidth; ++x) {
+			accumulatedRow[x] = HbMath_F32x4_LoadZero();
+		}
+		// Vertical (and depth) filtering of whole source rows.
+		HbImage_Mipi_Tap const * tapsZ = &axisZ->taps[targetZ * axisZ->tapCount], * tapsY = &axisY->taps[targetY * axisY->tapCount];
+		for (uint32_t tapIndexZ = 0; tapIndexZ < axisZ->tapCount; ++tapIndexZ) {
+			HbImage_Mipi_Tap tapZ = tapsZ[tapIndexZ];
+			for (uint32_t tapIndexY = 0; tapIndexY < axisY->tapCount; ++tapIndexY) {
+				HbImage_Mipi_Tap tapY = tapsY[tapIndexY];
+				float weight = tapZ.weight * tapY.weight;
+				if (weight == 0.0f) {
+					continue;
+				}
+				HbImage_Raw_LoadRow(pass->format, (uint8_t const *) pass->source->texels +
+						tapZ.index * pass->source->slicePitch + tapY.index * pass->source->rowPitch, sourceWidth, job->sourceRow);
+				HbMath_F32x4 weights = HbMath_F32x4_LoadReplicated(weight);
+				for (uint32_t x = 0; x < sourceWidth; ++x) {
+					accumulatedRow[x] = HbMath_F32x4_MultiplyAdd(accumulatedRow[x], sourceRow[x], weights);
+				}
+			}
+		}
+		// Horizontal filtering.
+		HbImage_Mipi_Tap const * tapsX = axisX->taps;
+		for (uint32_t x = 0; x < targetWidth; ++x) {
+			HbMath_F32x4 texel = HbMath_F32x4_LoadZero();
+			for (uint32_t tapIndexX = 0; tapIndexX < axisX->tapCount; ++tapIndexX) {
+				texel = HbMath_F32x4_MultiplyAdd(texel, accumulatedRow[tapsX->index], HbMath_F32x4_LoadReplicated(tapsX->weight));
+				++tapsX;
+			}
+			targetRow[x] = texel;
+		}
+		if (pass->gatherAlphaHistogram) {
+			HbImage_Mipi_Job_AddToHistogram(job, job->targetRow, targetWidth);
+		}
+		HbImage_Raw_StoreRow(pass->format, job->targetRow, targetWidth,
+				(uint8_t *) pass->target->texels + targetZ * pass->target->slicePitch + targetY * pass->target->rowPitch);
+	}
+}
+
+static void HbImage_Mipi_Job_Run(void * data) {
+	HbImage_Mipi_Job * job = (HbImage_Mipi_Job *) data;
+	HbImage_Mipi_Pass const * pass = job->pass;
+	memset(job->alphaHistogram, 0, sizeof(job->alphaHistogram));
+	if (pass->stage == HbImage_Mipi_Stage_Filter) {
+		HbImage_Mipi_Job_Filter(job);
+		return;
+	}
+	uint32_t width = pass->axes[0].targetSize, height = pass->axes[1].targetSize;
+	for (uint32_t row = job->rowFirst; row < job->rowEnd; ++row) {
+		uint32_t z = row / height, y = row - z * height;
+		uint8_t * rowTexels = (uint8_t *) pass->target->texels + z * pass->target->slicePitch + y * pass->target->rowPitch;
+		HbImage_Raw_LoadRow(pass->format, rowTexels, width, job->sourceRow);
+		if (pass->stage == HbImage_Mipi_Stage_MeasureAlpha) {
+			HbImage_Mipi_Job_AddToHistogram(job, job->sourceRow, width);
+			continue;
+		}
+		for (uint32_t x = 0; x < width; ++x) {
+			job->sourceRow[x * 4 + 3] *= pass->alphaScale;
+		}
+		HbImage_Raw_StoreRow(pass->format, job->sourceRow, width, rowTexels);
+	}
+}
+
+// Sums the alpha histograms of the jobs to alphaHistogram if it's not NULL.
+static void HbImage_Mipi_Pass_Run(HbImage_Mipi_Pass const * pass, HbImage_Mipi_Job * jobs, uint32_t threadCount, uint32_t * alphaHistogram) {
+	uint32_t rowCount = pass->axes[1].targetSize * pass->axes[2].targetSize;
+	uint32_t maxThreadCount = (rowCount + (HbImage_Mip_Generate_MinRowsPerThread - 1)) / HbImage_Mip_Generate_MinRowsPerThread;
+	threadCount = HbMaxU32(HbMinU32(threadCount, maxThreadCount), 1);
+	HbParallel_Thread threads[HbImage_Mip_Generate_MaxThreads];
+	HbBool threadsStarted[HbImage_Mip_Generate_MaxThreads];
+	uint32_t rowsPerJob = rowCount / threadCount;
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		HbImage_Mipi_Job * job = &jobs[jobIndex];
+		job->pass = pass;
+		job->rowFirst = jobIndex * rowsPerJob;
+		job->rowEnd = (jobIndex + 1 == threadCount) ? rowCount : job->rowFirst + rowsPerJob;
+	}
+	// Job 0 is done on the calling thread, and jobs whose threads couldn't be started too.
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		threadsStarted[jobIndex] = HbParallel_Thread_Start(&threads[jobIndex], "HbImageMip", HbImage_Mipi_Job_Run, &jobs[jobIndex]);
+	}
+	HbImage_Mipi_Job_Run(&jobs[0]);
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		if (threadsStarted[jobIndex]) {
+			HbParallel_Thread_Destroy(&threads[jobIndex]);
+		} else {
+			HbImage_Mipi_Job_Run(&jobs[jobIndex]);
+		}
+	}
+	if (alphaHistogram != NULL) {
+		memset(alphaHistogram, 0, 256 * sizeof(uint32_t));
+		for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+			for (uint32_t bin = 0; bin < 256; ++bin) {
+				alphaHistogram[bin] += jobs[jobIndex].alphaHistogram[bin];
+			}
+		}
+	}
+}
+
+/*****************
+ * Alpha coverage
+ *****************/
+
+// The number of texels with alpha above the reference.
+static uint64_t HbImage_Mipi_GetCoveredCount(uint32_t const * alphaHistogram, float reference) {
+	uint64_t count = 0;
+	for (uint32_t bin = 0; bin < 256; ++bin) {
+		if ((float) bin * (1.0f / 255.0f) > reference) {
+			count += alphaHistogram[bin];
+		}
+	}
+	return count;
+}
+
+// The scale for alpha making the number of texels with alpha above the reference the closest to coveredCount,
+// and of the scales that are equally close, the closest to 1, so mips already having that coverage are not changed.
+static float HbImage_Mipi_GetAlphaScale(uint32_t const * alphaHistogram, float reference, double coveredCount) {
+	if (coveredCount <= 0.0) {
+		return 1.0f;
+	}
+	float bestScale = 1.0f;
+	double bestError = fabs((double) HbImage_Mipi_GetCoveredCount(alphaHistogram, reference) - coveredCount);
+	// With the scale of reference / ((firstBin - 0.5) / 255), the texels in firstBin and above are covered.
+	uint64_t binsCoveredCount = 0;
+	for (uint32_t firstBin = 255; firstBin >= 1 && bestError > 0.0; --firstBin) {
+		binsCoveredCount += alphaHistogram[firstBin];
+		double error = fabs((double) binsCoveredCount - coveredCount);
+		float scale = reference * 255.0f / ((float) firstBin - 0.5f);
+		if (error < bestError || (error == bestError && fabsf(scale - 1.0f) < fabsf(bestScale - 1.0f))) {
+			bestError = error;
+			bestScale = scale;
+		}
+	}
+	return bestScale;
+}
+
+/*************
+ * Generation
+ *************/
+
+void HbImage_Mip_Generate(HbGPU_Image_Info const * info, HbImage_Mip_Options const * options, HbImage_Mip_Level const * mips,
+		HbMemory_Tag * tag, uint32_t threadCount) {
+	if (!HbImage_Raw_CanConvert(info->format)) {
+		HbFeedback_Crash("HbImage_Mip_Generate", "Format %u can't be converted.", (uint32_t) info->format);
+	}
+	if (info->mips <= 1) {
+		return;
+	}
+	threadCount = HbMaxU32(HbMinU32(threadCount, HbImage_Mip_Generate_MaxThreads), 1);
+	uint32_t layerCount = HbGPU_Image_Info_GetArrayLayers(info);
+	if (HbGPU_Image_Dimensions_AreCube(info->dimensions)) {
+		layerCount *= 6;
+	}
+	uint32_t sizes[3] = { info->width, info->height, HbGPU_Image_Info_Get3DDepth(info) };
+	HbGPU_Image_MipSize(0, info->dimensions, &sizes[0], &sizes[1], &sizes[2]);
+	uint32_t mip1Width = sizes[0];
+	HbGPU_Image_MipSize(1, info->dimensions, &mip1Width, NULL, NULL);
+
+	// The source and the accumulated rows are up to the width of mip 0 (the source of mip 1 and measured for the alpha coverage),
+	// the target row is up to the width of mip 1.
+	HbImage_Mipi_Job jobs[HbImage_Mip_Generate_MaxThreads];
+	size_t jobRowsSize = ((size_t) sizes[0] * 2 + mip1Width) * (4 * sizeof(float));
+	uint8_t * rowMemory = (uint8_t *) HbMemory_Alloc(tag, jobRowsSize * threadCount, HbTrue);
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		HbImage_Mipi_Job * job = &jobs[jobIndex];
+		job->sourceRow = (float *) (rowMemory + jobIndex * jobRowsSize);
+		job->accumulatedRow = job->sourceRow + sizes[0] * 4;
+		job->targetRow = job->accumulatedRow + sizes[0] * 4;
+	}
+
+	float alphaCoverageReference = options->alphaCoverageReference;
+	uint32_t alphaHistogram[256];
+	for (uint32_t layer = 0; layer < layerCount; ++layer) {
+		HbImage_Mip_Level const * layerMips = &mips[layer * info->mips];
+		double coveredFraction = 0.0;
+		if (alphaCoverageReference > 0.0f) {
+			HbImage_Mipi_Pass measurePass = { .stage = HbImage_Mipi_Stage_MeasureAlpha, .format = info->format, .target = &layerMips[0] };
+			for (uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex) {
+				measurePass.axes[axisIndex].targetSize = sizes[axisIndex];
+			}
+			HbImage_Mipi_Pass_Run(&measurePass, jobs, threadCount, alphaHistogram);
+			coveredFraction = (double) HbImage_Mipi_GetCoveredCount(alphaHistogram, alphaCoverageReference) /
+					((double) sizes[0] * sizes[1] * sizes[2]);
+		}
+		for (uint32_t mip = 1; mip < info->mips; ++mip) {
+			HbImage_Mipi_Pass pass = { .stage = HbImage_Mipi_Stage_Filter, .format = info->format,
+					.source = &layerMips[mip - 1], .target = &layerMips[mip], .gatherAlphaHistogram = alphaCoverageReference > 0.0f };
+			uint32_t sourceSizes[3] = { info->width, info->height, sizes[2] }, targetSizes[3] = { info->width, info->height, sizes[2] };
+			HbGPU_Image_MipSize(mip - 1, info->dimensions, &sourceSizes[0], &sourceSizes[1], &sourceSizes[2]);
+			HbGPU_Image_MipSize(mip, info->dimensions, &targetSizes[0], &targetSizes[1], &targetSizes[2]);
+			uint32_t tapTotal = 0;
+			for (uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex) {
+				HbImage_Mipi_Axis * axis = &pass.axes[axisIndex];
+				axis->sourceSize = sourceSizes[axisIndex];
+				axis->targetSize = targetSizes[axisIndex];
+				axis->tapCount = HbImage_Mipi_Axis_GetTapCount(options->filter, axis->sourceSize, axis->targetSize);
+				tapTotal += axis->targetSize * axis->tapCount;
+			}
+			HbImage_Mipi_Tap * taps = (HbImage_Mipi_Tap *) HbMemory_Alloc(tag, tapTotal * sizeof(HbImage_Mipi_Tap), HbFalse);
+			for (uint32_t axisIndex = 0; axisIndex < 3; ++axisIndex) {
+				HbImage_Mipi_Axis * axis = &pass.axes[axisIndex];
+				axis->taps = taps;
+				taps += axis->targetSize * axis->tapCount;
+				HbImage_Mipi_Axis_FillTaps(axis, options->filter, options->wrap);
+			}
+			HbImage_Mipi_Pass_Run(&pass, jobs, threadCount, pass.gatherAlphaHistogram ? alphaHistogram : NULL);
+			HbMemory_Free(pass.axes[0].taps);
+			if (pass.gatherAlphaHistogram) {
+				double texelCount = (double) pass.axes[0].targetSize * pass.axes[1].targetSize * pass.axes[2].targetSize;
+				float alphaScale = HbImage_Mipi_GetAlphaScale(alphaHistogram, alphaCoverageReference, coveredFraction * texelCount);
+				if (alphaScale != 1.0f) {
+					pass.stage = HbImage_Mipi_Stage_ScaleAlpha;
+					pass.alphaScale = alphaScale;
+					HbImage_Mipi_Pass_Run(&pass, jobs, threadCount, NULL);
+				}
+			}
+		}
+	}
+
+	HbMemory_Free(rowMemory);
+}
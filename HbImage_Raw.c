@@ -0,0 +1,596 @@
+#include "HbFeedback.h"
+#include "HbImage.h"
+#include "HbMath.h"
+#include "HbParallel.h"
+
+/**********************
+ * Format descriptions
+ **********************/
+
+typedef enum HbImage_Rawi_Type {
+	HbImage_Rawi_Type_Unsupported, // Zero, integer formats.
+	HbImage_Rawi_Type_UNorm,
+	HbImage_Rawi_Type_SNorm,
+	HbImage_Rawi_Type_sRGB, // Alpha is UNorm.
+	HbImage_Rawi_Type_Float,
+	HbImage_Rawi_Type_Packed, // Channels of different sizes in one integer, handled for every format separately.
+} HbImage_Rawi_Type;
+
+typedef struct HbImage_Rawi_Format {
+	uint8_t type; // HbImage_Rawi_Type.
+	uint8_t channelCount;
+	uint8_t channelSize;
+	HbBool bgra;
+} HbImage_Rawi_Format;
+
+static HbImage_Rawi_Format const HbImage_Rawi_Formats[HbGPU_Image_Format_RawEnd + 1] = {
+	[HbGPU_Image_Format_4_4_4_4_BGRA_UNorm] = { HbImage_Rawi_Type_Packed, 4, 0, HbTrue },
+	[HbGPU_Image_Format_5_5_5_1_BGRA_UNorm] = { HbImage_Rawi_Type_Packed, 4, 0, HbTrue },
+	[HbGPU_Image_Format_5_6_5_BGR_UNorm] = { HbImage_Rawi_Type_Packed, 3, 0, HbTrue },
+	[HbGPU_Image_Format_8_R_UNorm] = { HbImage_Rawi_Type_UNorm, 1, 1 },
+	[HbGPU_Image_Format_8_R_SNorm] = { HbImage_Rawi_Type_SNorm, 1, 1 },
+	[HbGPU_Image_Format_8_8_RG_UNorm] = { HbImage_Rawi_Type_UNorm, 2, 1 },
+	[HbGPU_Image_Format_8_8_RG_SNorm] = { HbImage_Rawi_Type_SNorm, 2, 1 },
+	[HbGPU_Image_Format_8_8_8_8_RGBA_UNorm] = { HbImage_Rawi_Type_UNorm, 4, 1 },
+	[HbGPU_Image_Format_8_8_8_8_RGBA_sRGB] = { HbImage_Rawi_Type_sRGB, 4, 1 },
+	[HbGPU_Image_Format_8_8_8_8_RGBA_SNorm] = { HbImage_Rawi_Type_SNorm, 4, 1 },
+	[HbGPU_Image_Format_8_8_8_8_BGRA_UNorm] = { HbImage_Rawi_Type_UNorm, 4, 1, HbTrue },
+	[HbGPU_Image_Format_8_8_8_8_BGRA_sRGB] = { HbImage_Rawi_Type_sRGB, 4, 1, HbTrue },
+	[HbGPU_Image_Format_10_10_10_2_RGBA_UNorm] = { HbImage_Rawi_Type_Packed, 4 },
+	[HbGPU_Image_Format_11_11_10_RGB_UFloat] = { HbImage_Rawi_Type_Packed, 3 },
+	[HbGPU_Image_Format_16_R_UNorm] = { HbImage_Rawi_Type_UNorm, 1, 2 },
+	[HbGPU_Image_Format_16_R_SNorm] = { HbImage_Rawi_Type_SNorm, 1, 2 },
+	[HbGPU_Image_Format_16_R_SFloat] = { HbImage_Rawi_Type_Float, 1, 2 },
+	[HbGPU_Image_Format_16_16_RG_UNorm] = { HbImage_Rawi_Type_UNorm, 2, 2 },
+	[HbGPU_Image_Format_16_16_RG_SNorm] = { HbImage_Rawi_Type_SNorm, 2, 2 },
+	[HbGPU_Image_Format_16_16_RG_SFloat] = { HbImage_Rawi_Type_Float, 2, 2 },
+	[HbGPU_Image_Format_16_16_16_16_RGBA_UNorm] = { HbImage_Rawi_Type_UNorm, 4, 2 },
+	[HbGPU_Image_Format_16_16_16_16_RGBA_SNorm] = { HbImage_Rawi_Type_SNorm, 4, 2 },
+	[HbGPU_Image_Format_16_16_16_16_RGBA_SFloat] = { HbImage_Rawi_Type_Float, 4, 2 },
+	[HbGPU_Image_Format_32_R_SFloat] = { HbImage_Rawi_Type_Float, 1, 4 },
+	[HbGPU_Image_Format_32_32_RG_SFloat] = { HbImage_Rawi_Type_Float, 2, 4 },
+	[HbGPU_Image_Format_32_32_32_32_RGBA_SFloat] = { HbImage_Rawi_Type_Float, 4, 4 },
+};
+
+HbBool HbImage_Raw_CanConvert(HbGPU_Image_Format format) {
+	return format <= HbGPU_Image_Format_RawEnd && HbImage_Rawi_Formats[format].type != HbImage_Rawi_Type_Unsupported;
+}
+
+/****************************
+ * Channel value conversions
+ ****************************/
+
+static float const HbImage_Rawi_SRGBToLinear[256] = {
+	0.0f, 0.000303527f, 0.000607054f, 0.000910581f, 0.001214108f, 0.001517635f, 0.001821162f, 0.0021246888f,
+	0.002428216f, 0.0027317428f, 0.00303527f, 0.0033465358f, 0.0036765074f, 0.004024717f, 0.004391442f, 0.0047769533f,
+	0.0051815165f, 0.0056053917f, 0.006048833f, 0.0065120906f, 0.00699541f, 0.007499032f, 0.008023193f, 0.008568126f,
+	0.009134059f, 0.009721218f, 0.010329823f, 0.010960094f, 0.011612245f, 0.012286488f, 0.0129830325f, 0.013702083f,
+	0.014443844f, 0.015208514f, 0.015996294f, 0.016807375f, 0.017641954f, 0.01850022f, 0.019382361f, 0.020288562f,
+	0.02121901f, 0.022173885f, 0.023153367f, 0.024157632f, 0.02518686f, 0.026241222f, 0.027320892f, 0.02842604f,
+	0.029556835f, 0.030713445f, 0.031896032f, 0.033104766f, 0.034339808f, 0.035601314f, 0.03688945f, 0.038204372f,
+	0.039546236f, 0.0409152f, 0.04231141f, 0.04373503f, 0.045186203f, 0.046665087f, 0.048171826f, 0.049706567f,
+	0.051269457f, 0.052860647f, 0.054480277f, 0.05612849f, 0.05780543f, 0.059511237f, 0.061246052f, 0.063010015f,
+	0.064803265f, 0.06662594f, 0.06847817f, 0.070360094f, 0.07227185f, 0.07421357f, 0.07618538f, 0.07818742f,
+	0.08021982f, 0.08228271f, 0.08437621f, 0.08650046f, 0.08865558f, 0.09084171f, 0.093058966f, 0.09530747f,
+	0.09758735f, 0.099898726f, 0.10224173f, 0.104616486f, 0.107023105f, 0.10946171f, 0.11193243f, 0.114435375f,
+	0.116970666f, 0.11953843f, 0.122138776f, 0.12477182f, 0.12743768f, 0.13013647f, 0.13286832f, 0.13563333f,
+	0.13843161f, 0.14126329f, 0.14412847f, 0.14702727f, 0.14995979f, 0.15292615f, 0.15592647f, 0.15896083f,
+	0.16202937f, 0.1651322f, 0.1682694f, 0.17144111f, 0.1746474f, 0.17788842f, 0.18116425f, 0.18447499f,
+	0.18782078f, 0.19120169f, 0.19461784f, 0.19806932f, 0.20155625f, 0.20507874f, 0.20863687f, 0.21223076f,
+	0.2158605f, 0.2195262f, 0.22322796f, 0.22696587f, 0.23074006f, 0.23455058f, 0.23839757f, 0.24228112f,
+	0.24620132f, 0.25015828f, 0.2541521f, 0.25818285f, 0.26225066f, 0.2663556f, 0.2704978f, 0.2746773f,
+	0.27889428f, 0.28314874f, 0.28744084f, 0.29177064f, 0.29613826f, 0.30054379f, 0.3049873f, 0.30946892f,
+	0.31398872f, 0.31854677f, 0.3231432f, 0.3277781f, 0.33245152f, 0.33716363f, 0.34191442f, 0.34670407f,
+	0.3515326f, 0.35640013f, 0.3613068f, 0.3662526f, 0.3712377f, 0.37626213f, 0.38132602f, 0.38642943f,
+	0.39157248f, 0.39675522f, 0.40197778f, 0.4072402f, 0.4125426f, 0.41788507f, 0.42326766f, 0.4286905f,
+	0.43415365f, 0.43965718f, 0.4452012f, 0.4507858f, 0.45641103f, 0.462077f, 0.4677838f, 0.47353148f,
+	0.47932017f, 0.48514995f, 0.49102086f, 0.49693298f, 0.5028865f, 0.50888133f, 0.5149177f, 0.52099556f,
+	0.5271151f, 0.5332764f, 0.5394795f, 0.54572445f, 0.55201143f, 0.5583404f, 0.5647115f, 0.57112485f,
+	0.57758045f, 0.58407843f, 0.59061885f, 0.59720176f, 0.60382736f, 0.61049557f, 0.6172066f, 0.6239604f,
+	0.63075715f, 0.63759685f, 0.6444797f, 0.65140563f, 0.65837485f, 0.6653873f, 0.67244315f, 0.6795425f,
+	0.6866853f, 0.69387174f, 0.7011019f, 0.70837575f, 0.7156935f, 0.7230551f, 0.73046076f, 0.7379104f,
+	0.7454042f, 0.7529422f, 0.7605245f, 0.76815116f, 0.7758222f, 0.7835378f, 0.7912979f, 0.7991027f,
+	0.80695224f, 0.8148466f, 0.82278574f, 0.8307699f, 0.838799f, 0.8468732f, 0.8549926f, 0.8631572f,
+	0.8713671f, 0.8796224f, 0.8879231f, 0.8962694f, 0.9046612f, 0.91309863f, 0.92158186f, 0.9301109f,
+	0.9386857f, 0.9473065f, 0.9559733f, 0.9646863f, 0.9734453f, 0.9822506f, 0.9911021f, 1.0f,
+};
+
+// Linear values at the midpoints between sRGB values - the rounded sRGB value is the number of thresholds not above the linear one.
+static float const HbImage_Rawi_SRGBThresholds[256] = {
+	0.0001517635f, 0.0004552905f, 0.0007588175f, 0.0010623444f, 0.0013658714f, 0.0016693984f, 0.0019729254f, 0.0022764525f,
+	0.0025799794f, 0.0028835062f, 0.0031883009f, 0.0035092593f, 0.003848315f, 0.004205748f, 0.004581833f, 0.0049768374f,
+	0.005391024f, 0.0058246506f, 0.0062779696f, 0.0067512277f, 0.0072446684f, 0.0077585303f, 0.0082930485f, 0.008848453f,
+	0.0094249705f, 0.010022826f, 0.010642237f, 0.011283421f, 0.0119465925f, 0.01263196f, 0.013339732f, 0.014070112f,
+	0.014823303f, 0.015599503f, 0.01639891f, 0.017221715f, 0.018068114f, 0.018938294f, 0.019832443f, 0.020750744f,
+	0.021693382f, 0.022660539f, 0.02365239f, 0.024669115f, 0.025710888f, 0.026777882f, 0.02787027f, 0.02898822f,
+	0.030131903f, 0.03130148f, 0.032497123f, 0.03371899f, 0.034967244f, 0.036242045f, 0.037543554f, 0.038871925f,
+	0.04022732f, 0.041609887f, 0.043019786f, 0.044457164f, 0.04592217f, 0.047414962f, 0.048935685f, 0.050484486f,
+	0.052061506f, 0.053666897f, 0.055300802f, 0.05696336f, 0.058654718f, 0.060375012f, 0.062124383f, 0.063902974f,
+	0.06571092f, 0.06754835f, 0.06941541f, 0.071312234f, 0.073238954f, 0.07519571f, 0.07718261f, 0.07919982f,
+	0.08124744f, 0.083325624f, 0.08543449f, 0.087574154f, 0.08974477f, 0.09194644f, 0.0941793f, 0.096443474f,
+	0.098739095f, 0.10106627f, 0.10342513f, 0.105815805f, 0.1082384f, 0.110693045f, 0.11317986f, 0.11569897f,
+	0.11825048f, 0.12083452f, 0.1234512f, 0.12610064f, 0.12878296f, 0.13149826f, 0.13424668f, 0.1370283f,
+	0.13984327f, 0.14269169f, 0.14557366f, 0.14848931f, 0.15143873f, 0.15442206f, 0.15743938f, 0.16049083f,
+	0.1635765f, 0.16669649f, 0.16985093f, 0.17303991f, 0.17626357f, 0.17952198f, 0.18281525f, 0.1861435f,
+	0.18950683f, 0.19290535f, 0.19633915f, 0.19980834f, 0.20331304f, 0.20685335f, 0.21042934f, 0.21404114f,
+	0.21768884f, 0.22137256f, 0.2250924f, 0.22884843f, 0.23264076f, 0.2364695f, 0.24033478f, 0.24423663f,
+	0.2481752f, 0.25215057f, 0.25616285f, 0.26021212f, 0.26429847f, 0.26842204f, 0.2725829f, 0.2767811f,
+	0.2810168f, 0.2852901f, 0.28960103f, 0.29394972f, 0.2983363f, 0.3027608f, 0.30722335f, 0.31172404f,
+	0.31626296f, 0.32084018f, 0.32545584f, 0.33010998f, 0.33480275f, 0.33953416f, 0.34430438f, 0.34911346f,
+	0.3539615f, 0.35884857f, 0.36377478f, 0.36874023f, 0.37374496f, 0.37878913f, 0.38387278f, 0.388996f,
+	0.3941589f, 0.39936152f, 0.40460402f, 0.40988642f, 0.41520882f, 0.42057136f, 0.42597404f, 0.43141702f,
+	0.43690035f, 0.44242412f, 0.44798842f, 0.4535933f, 0.45923892f, 0.4649253f, 0.47065252f, 0.4764207f,
+	0.48222992f, 0.48808023f, 0.49397177f, 0.49990454f, 0.5058787f, 0.5118943f, 0.5179514f, 0.5240501f,
+	0.5301905f, 0.5363727f, 0.54259676f, 0.5488627f, 0.55517066f, 0.5615207f, 0.5679129f, 0.5743473f,
+	0.58082414f, 0.58734334f, 0.593905f, 0.6005092f, 0.6071561f, 0.6138457f, 0.6205781f, 0.62735337f,
+	0.6341716f, 0.6410329f, 0.64793724f, 0.6548848f, 0.66187567f, 0.6689098f, 0.67598736f, 0.68310845f,
+	0.6902731f, 0.69748133f, 0.7047334f, 0.71202916f, 0.7193688f, 0.72675246f, 0.73418003f, 0.7416518f,
+	0.7491677f, 0.7567278f, 0.7643323f, 0.7719811f, 0.7796744f, 0.7874123f, 0.79519475f, 0.8030219f,
+	0.81089383f, 0.8188105f, 0.8267722f, 0.8347788f, 0.8428305f, 0.8509273f, 0.8590692f, 0.8672565f,
+	0.87548906f, 0.88376707f, 0.89209056f, 0.9004596f, 0.9088742f, 0.91733456f, 0.9258406f, 0.9343926f,
+	0.94299036f, 0.95163417f, 0.96032405f, 0.96906f, 0.97784215f, 0.98667055f, 0.99554527f,
+	FLT_MAX,
+};
+
+static HbForceInline uint32_t HbImage_Rawi_LinearToSRGB(float value) {
+	uint32_t position = 0;
+	for (uint32_t step = 128; step != 0; step >>= 1) {
+		if (HbImage_Rawi_SRGBThresholds[position + step - 1] <= value) {
+			position += step;
+		}
+	}
+	return position;
+}
+
+// NaN is stored as 0.
+HbForceInline uint32_t HbImage_Rawi_QuantizeUNorm(float value, uint32_t maxValue) {
+	return (uint32_t) (HbClampF(value, 0.0f, 1.0f) * (float) maxValue + 0.5f);
+}
+
+HbForceInline int32_t HbImage_Rawi_QuantizeSNorm(float value, int32_t maxValue) {
+	return (int32_t) roundf(HbClampF(value, -1.0f, 1.0f) * (float) maxValue);
+}
+
+// Floats with a 5-bit exponent and mantissaBits bits of mantissa, like half-precision floats (10) and 11_11_10 (6 and 5).
+// Floats too large for the format become infinity, and negative values are stored as 0 without the sign bit.
+
+static float HbImage_Rawi_DecodeSmallFloat(uint32_t bits, uint32_t mantissaBits, HbBool hasSign) {
+	uint32_t exponent = (bits >> mantissaBits) & 31, mantissa = bits & ((1u << mantissaBits) - 1);
+	float value;
+	if (exponent == 0) {
+		value = ldexpf((float) mantissa, -14 - (int32_t) mantissaBits);
+	} else {
+		uint32_t valueBits;
+		if (exponent == 31) {
+			valueBits = 0x7F800000u | (mantissa << (23 - mantissaBits));
+		} else {
+			valueBits = ((exponent + (127 - 15)) << 23) | (mantissa << (23 - mantissaBits));
+		}
+		memcpy(&value, &valueBits, sizeof(value));
+	}
+	return (hasSign && (bits >> (mantissaBits + 5)) & 1) ? -value : value;
+}
+
+// Shifting right with rounding to nearest even.
+HbForceInline uint32_t HbImage_Rawi_ShiftRightRounded(uint32_t value, uint32_t shift) {
+	if (shift == 0) {
+		return value;
+	}
+	if (shift >= 32) {
+		return 0;
+	}
+	return (uint32_t) (((uint64_t) value + ((1u << (shift - 1)) - 1) + ((value >> shift) & 1)) >> shift);
+}
+
+static uint32_t HbImage_Rawi_EncodeSmallFloat(float value, uint32_t mantissaBits, HbBool hasSign) {
+	uint32_t valueBits;
+	memcpy(&valueBits, &value, sizeof(valueBits));
+	uint32_t sign = hasSign ? (valueBits >> 31) << (mantissaBits + 5) : 0, magnitudeBits = valueBits & 0x7FFFFFFFu;
+	if (magnitudeBits > 0x7F800000u) {
+		// NaN.
+		return sign | (31u << mantissaBits) | (1u << (mantissaBits - 1));
+	}
+	if (!hasSign && (valueBits >> 31)) {
+		return 0;
+	}
+	int32_t exponent = (int32_t) (magnitudeBits >> 23) - (127 - 15);
+	uint32_t encoded;
+	if (exponent >= 31) {
+		encoded = 31u << mantissaBits;
+	} else if (exponent <= 0) {
+		// Denormal, with the implicit 1 of the mantissa made explicit.
+		encoded = HbImage_Rawi_ShiftRightRounded((magnitudeBits & 0x7FFFFFu) | 0x800000u, (uint32_t) (24 - (int32_t) mantissaBits - exponent));
+	} else {
+		// Rounding may carry into the exponent, up to infinity, which is correct.
+		encoded = HbImage_Rawi_ShiftRightRounded(((uint32_t) exponent << 23) | (magnitudeBits & 0x7FFFFFu), 23 - mantissaBits);
+	}
+	return sign | encoded;
+}
+
+/******************
+ * Loading of rows
+ ******************/
+
+static void HbImage_Rawi_LoadUNorm8(uint8_t const * source, uint32_t texelCount, uint32_t channelCount, HbBool bgra, float * rgba) {
+	uint32_t texel = 0;
+	if (channelCount == 4) {
+		HbMath_U8x16 zero = HbMath_U8x16_LoadZero();
+		HbMath_F32x4 scale = HbMath_F32x4_LoadReplicated(1.0f / 255.0f);
+		for (; texel + 4 <= texelCount; texel += 4) {
+			HbMath_U8x16 bytes = HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) (source + texel * 4));
+			HbMath_U16x8 words[2] = { HbMath_U8x16_InterleaveLower(bytes, zero), HbMath_U8x16_InterleaveUpper(bytes, zero) };
+			for (uint32_t quadTexel = 0; quadTexel < 4; ++quadTexel) {
+				HbMath_U16x8 texelWords = words[quadTexel >> 1];
+				HbMath_S32x4 texelValues = (quadTexel & 1) ? HbMath_U16x8_InterleaveUpper(texelWords, zero) :
+						HbMath_U16x8_InterleaveLower(texelWords, zero);
+				HbMath_F32x4 texelRGBA = HbMath_F32x4_Multiply(HbMath_S32x4_ConvertToF32x4(texelValues), scale);
+				if (bgra) {
+					texelRGBA = HbMath_F32x4_SwapXZ(texelRGBA);
+				}
+				HbMath_F32x4_StoreAligned(rgba + (texel + quadTexel) * 4, texelRGBA);
+			}
+		}
+	}
+	for (; texel < texelCount; ++texel) {
+		float * texelRGBA = rgba + texel * 4;
+		uint8_t const * texelSource = source + texel * channelCount;
+		texelRGBA[1] = texelRGBA[2] = 0.0f;
+		texelRGBA[3] = 1.0f;
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			texelRGBA[channel] = (float) texelSource[channel] * (1.0f / 255.0f);
+		}
+		if (bgra) {
+			float blue = texelRGBA[0];
+			texelRGBA[0] = texelRGBA[2];
+			texelRGBA[2] = blue;
+		}
+	}
+}
+
+static void HbImage_Rawi_LoadSRGB8(uint8_t const * source, uint32_t texelCount, HbBool bgra, float * rgba) {
+	uint32_t redChannel = bgra ? 2 : 0;
+	for (uint32_t texel = 0; texel < texelCount; ++texel) {
+		float * texelRGBA = rgba + texel * 4;
+		uint8_t const * texelSource = source + texel * 4;
+		texelRGBA[0] = HbImage_Rawi_SRGBToLinear[texelSource[redChannel]];
+		texelRGBA[1] = HbImage_Rawi_SRGBToLinear[texelSource[1]];
+		texelRGBA[2] = HbImage_Rawi_SRGBToLinear[texelSource[2 - redChannel]];
+		texelRGBA[3] = (float) texelSource[3] * (1.0f / 255.0f);
+	}
+}
+
+static void HbImage_Rawi_LoadChannels(HbImage_Rawi_Format const * format, uint8_t const * source, uint32_t texelCount, float * rgba) {
+	uint32_t channelCount = format->channelCount, texelSize = channelCount * format->channelSize;
+	for (uint32_t texel = 0; texel < texelCount; ++texel) {
+		float * texelRGBA = rgba + texel * 4;
+		uint8_t const * texelSource = source + texel * texelSize;
+		texelRGBA[1] = texelRGBA[2] = 0.0f;
+		texelRGBA[3] = 1.0f;
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			float value;
+			switch (format->channelSize) {
+			case 1:
+				value = fmaxf((float) (int8_t) texelSource[channel] * (1.0f / 127.0f), -1.0f);
+				break;
+			case 2: {
+				uint16_t bits;
+				memcpy(&bits, texelSource + channel * 2, sizeof(bits));
+				if (format->type == HbImage_Rawi_Type_UNorm) {
+					value = (float) bits * (1.0f / 65535.0f);
+				} else if (format->type == HbImage_Rawi_Type_SNorm) {
+					value = fmaxf((float) (int16_t) bits * (1.0f / 32767.0f), -1.0f);
+				} else {
+					value = HbImage_Rawi_DecodeSmallFloat(bits, 10, HbTrue);
+				}
+				break;
+			}
+			default:
+				memcpy(&value, texelSource + channel * 4, sizeof(value));
+				break;
+			}
+			texelRGBA[channel] = value;
+		}
+	}
+}
+
+static void HbImage_Rawi_LoadPacked(HbGPU_Image_Format format, uint8_t const * source, uint32_t texelCount, float * rgba) {
+	for (uint32_t texel = 0; texel < texelCount; ++texel) {
+		float * texelRGBA = rgba + texel * 4;
+		uint16_t bits16;
+		uint32_t bits32;
+		switch (format) {
+		case HbGPU_Image_Format_4_4_4_4_BGRA_UNorm:
+			memcpy(&bits16, source + texel * 2, sizeof(bits16));
+			texelRGBA[0] = (float) ((bits16 >> 8) & 15) * (1.0f / 15.0f);
+			texelRGBA[1] = (float) ((bits16 >> 4) & 15) * (1.0f / 15.0f);
+			texelRGBA[2] = (float) (bits16 & 15) * (1.0f / 15.0f);
+			texelRGBA[3] = (float) (bits16 >> 12) * (1.0f / 15.0f);
+			break;
+		case HbGPU_Image_Format_5_5_5_1_BGRA_UNorm:
+			memcpy(&bits16, source + texel * 2, sizeof(bits16));
+			texelRGBA[0] = (float) ((bits16 >> 10) & 31) * (1.0f / 31.0f);
+			texelRGBA[1] = (float) ((bits16 >> 5) & 31) * (1.0f / 31.0f);
+			texelRGBA[2] = (float) (bits16 & 31) * (1.0f / 31.0f);
+			texelRGBA[3] = (float) (bits16 >> 15);
+			break;
+		case HbGPU_Image_Format_5_6_5_BGR_UNorm:
+			memcpy(&bits16, source + texel * 2, sizeof(bits16));
+			texelRGBA[0] = (float) (bits16 >> 11) * (1.0f / 31.0f);
+			texelRGBA[1] = (float) ((bits16 >> 5) & 63) * (1.0f / 63.0f);
+			texelRGBA[2] = (float) (bits16 & 31) * (1.0f / 31.0f);
+			texelRGBA[3] = 1.0f;
+			break;
+		case HbGPU_Image_Format_10_10_10_2_RGBA_UNorm:
+			memcpy(&bits32, source + texel * 4, sizeof(bits32));
+			texelRGBA[0] = (float) (bits32 & 1023) * (1.0f / 1023.0f);
+			texelRGBA[1] = (float) ((bits32 >> 10) & 1023) * (1.0f / 1023.0f);
+			texelRGBA[2] = (float) ((bits32 >> 20) & 1023) * (1.0f / 1023.0f);
+			texelRGBA[3] = (float) (bits32 >> 30) * (1.0f / 3.0f);
+			break;
+		case HbGPU_Image_Format_11_11_10_RGB_UFloat:
+			memcpy(&bits32, source + texel * 4, sizeof(bits32));
+			texelRGBA[0] = HbImage_Rawi_DecodeSmallFloat(bits32 & 2047, 6, HbFalse);
+			texelRGBA[1] = HbImage_Rawi_DecodeSmallFloat((bits32 >> 11) & 2047, 6, HbFalse);
+			texelRGBA[2] = HbImage_Rawi_DecodeSmallFloat(bits32 >> 22, 5, HbFalse);
+			texelRGBA[3] = 1.0f;
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void HbImage_Raw_LoadRow(HbGPU_Image_Format format, void const * source, uint32_t texelCount, float * rgba) {
+	if (!HbImage_Raw_CanConvert(format)) {
+		HbFeedback_Crash("HbImage_Raw_LoadRow", "Format %u can't be converted.", (uint32_t) format);
+	}
+	HbImage_Rawi_Format const * formatInfo = &HbImage_Rawi_Formats[format];
+	uint8_t const * sourceBytes = (uint8_t const *) source;
+	switch (formatInfo->type) {
+	case HbImage_Rawi_Type_UNorm:
+		if (formatInfo->channelSize == 1) {
+			HbImage_Rawi_LoadUNorm8(sourceBytes, texelCount, formatInfo->channelCount, formatInfo->bgra, rgba);
+			return;
+		}
+		break;
+	case HbImage_Rawi_Type_sRGB:
+		HbImage_Rawi_LoadSRGB8(sourceBytes, texelCount, formatInfo->bgra, rgba);
+		return;
+	case HbImage_Rawi_Type_Packed:
+		HbImage_Rawi_LoadPacked(format, sourceBytes, texelCount, rgba);
+		return;
+	default:
+		break;
+	}
+	HbImage_Rawi_LoadChannels(formatInfo, sourceBytes, texelCount, rgba);
+}
+
+/******************
+ * Storing of rows
+ ******************/
+
+static void HbImage_Rawi_StoreUNorm8(float const * rgba, uint32_t texelCount, uint32_t channelCount, HbBool bgra, uint8_t * target) {
+	uint32_t texel = 0;
+	if (channelCount == 4) {
+		HbMath_F32x4 scale = HbMath_F32x4_LoadReplicated(255.0f), half = HbMath_F32x4_LoadReplicated(0.5f);
+		HbMath_F32x4 zero = HbMath_F32x4_LoadZero();
+		for (; texel + 4 <= texelCount; texel += 4) {
+			HbMath_S32x4 texelValues[4];
+			for (uint32_t quadTexel = 0; quadTexel < 4; ++quadTexel) {
+				HbMath_F32x4 texelRGBA = HbMath_F32x4_LoadAligned(rgba + (texel + quadTexel) * 4);
+				if (bgra) {
+					texelRGBA = HbMath_F32x4_SwapXZ(texelRGBA);
+				}
+				// NaN is replaced with the second operand of Max.
+				texelRGBA = HbMath_F32x4_Min(HbMath_F32x4_Max(HbMath_F32x4_Multiply(texelRGBA, scale), zero), scale);
+				texelValues[quadTexel] = HbMath_F32x4_ConvertToS32x4(HbMath_F32x4_Add(texelRGBA, half));
+			}
+			HbMath_U8x16_StoreUnaligned((HbMath_U8x16 *) (target + texel * 4), HbMath_U16x8_PackToU8x16(
+					HbMath_S32x4_PackToS16x8(texelValues[0], texelValues[1]), HbMath_S32x4_PackToS16x8(texelValues[2], texelValues[3])));
+		}
+	}
+	for (; texel < texelCount; ++texel) {
+		float const * texelRGBA = rgba + texel * 4;
+		uint8_t * texelTarget = target + texel * channelCount;
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			uint32_t sourceChannel = (bgra && channel != 1 && channel != 3) ? 2 - channel : channel;
+			texelTarget[channel] = (uint8_t) HbImage_Rawi_QuantizeUNorm(texelRGBA[sourceChannel], 255);
+		}
+	}
+}
+
+static void HbImage_Rawi_StoreSRGB8(float const * rgba, uint32_t texelCount, HbBool bgra, uint8_t * target) {
+	uint32_t redChannel = bgra ? 2 : 0;
+	for (uint32_t texel = 0; texel < texelCount; ++texel) {
+		float const * texelRGBA = rgba + texel * 4;
+		uint8_t * texelTarget = target + texel * 4;
+		texelTarget[redChannel] = (uint8_t) HbImage_Rawi_LinearToSRGB(texelRGBA[0]);
+		texelTarget[1] = (uint8_t) HbImage_Rawi_LinearToSRGB(texelRGBA[1]);
+		texelTarget[2 - redChannel] = (uint8_t) HbImage_Rawi_LinearToSRGB(texelRGBA[2]);
+		texelTarget[3] = (uint8_t) HbImage_Rawi_QuantizeUNorm(texelRGBA[3], 255);
+	}
+}
+
+static void HbImage_Rawi_StoreChannels(HbImage_Rawi_Format const * format, float const * rgba, uint32_t texelCount, uint8_t * target) {
+	uint32_t channelCount = format->channelCount, texelSize = channelCount * format->channelSize;
+	for (uint32_t texel = 0; texel < texelCount; ++texel) {
+		float const * texelRGBA = rgba + texel * 4;
+		uint8_t * texelTarget = target + texel * texelSize;
+		for (uint32_t channel = 0; channel < channelCount; ++channel) {
+			float value = texelRGBA[channel];
+			switch (format->channelSize) {
+			case 1:
+				texelTarget[channel] = (uint8_t) (int8_t) HbImage_Rawi_QuantizeSNorm(value, 127);
+				break;
+			case 2: {
+				uint16_t bits;
+				if (format->type == HbImage_Rawi_Type_UNorm) {
+					bits = (uint16_t) HbImage_Rawi_QuantizeUNorm(value, 65535);
+				} else if (format->type == HbImage_Rawi_Type_SNorm) {
+					bits = (uint16_t) (int16_t) HbImage_Rawi_QuantizeSNorm(value, 32767);
+				} else {
+					bits = (uint16_t) HbImage_Rawi_EncodeSmallFloat(value, 10, HbTrue);
+				}
+				memcpy(texelTarget + channel * 2, &bits, sizeof(bits));
+				break;
+			}
+			default:
+				memcpy(texelTarget + channel * 4, &value, sizeof(value));
+				break;
+			}
+		}
+	}
+}
+
+static void HbImage_Rawi_StorePacked(HbGPU_Image_Format format, float const * rgba, uint32_t texelCount, uint8_t * target) {
+	for (uint32_t texel = 0; texel < texelCount; ++texel) {
+		float const * texelRGBA = rgba + texel * 4;
+		uint16_t bits16;
+		uint32_t bits32;
+		switch (format) {
+		case HbGPU_Image_Format_4_4_4_4_BGRA_UNorm:
+			bits16 = (uint16_t) (HbImage_Rawi_QuantizeUNorm(texelRGBA[2], 15) | (HbImage_Rawi_QuantizeUNorm(texelRGBA[1], 15) << 4) |
+					(HbImage_Rawi_QuantizeUNorm(texelRGBA[0], 15) << 8) | (HbImage_Rawi_QuantizeUNorm(texelRGBA[3], 15) << 12));
+			memcpy(target + texel * 2, &bits16, sizeof(bits16));
+			break;
+		case HbGPU_Image_Format_5_5_5_1_BGRA_UNorm:
+			bits16 = (uint16_t) (HbImage_Rawi_QuantizeUNorm(texelRGBA[2], 31) | (HbImage_Rawi_QuantizeUNorm(texelRGBA[1], 31) << 5) |
+					(HbImage_Rawi_QuantizeUNorm(texelRGBA[0], 31) << 10) | (HbImage_Rawi_QuantizeUNorm(texelRGBA[3], 1) << 15));
+			memcpy(target + texel * 2, &bits16, sizeof(bits16));
+			break;
+		case HbGPU_Image_Format_5_6_5_BGR_UNorm:
+			bits16 = (uint16_t) (HbImage_Rawi_QuantizeUNorm(texelRGBA[2], 31) | (HbImage_Rawi_QuantizeUNorm(texelRGBA[1], 63) << 5) |
+					(HbImage_Rawi_QuantizeUNorm(texelRGBA[0], 31) << 11));
+			memcpy(target + texel * 2, &bits16, sizeof(bits16));
+			break;
+		case HbGPU_Image_Format_10_10_10_2_RGBA_UNorm:
+			bits32 = HbImage_Rawi_QuantizeUNorm(texelRGBA[0], 1023) | (HbImage_Rawi_QuantizeUNorm(texelRGBA[1], 1023) << 10) |
+					(HbImage_Rawi_QuantizeUNorm(texelRGBA[2], 1023) << 20) | (HbImage_Rawi_QuantizeUNorm(texelRGBA[3], 3) << 30);
+			memcpy(target + texel * 4, &bits32, sizeof(bits32));
+			break;
+		case HbGPU_Image_Format_11_11_10_RGB_UFloat:
+			bits32 = HbImage_Rawi_EncodeSmallFloat(texelRGBA[0], 6, HbFalse) | (HbImage_Rawi_EncodeSmallFloat(texelRGBA[1], 6, HbFalse) << 11) |
+					(HbImage_Rawi_EncodeSmallFloat(texelRGBA[2], 5, HbFalse) << 22);
+			memcpy(target + texel * 4, &bits32, sizeof(bits32));
+			break;
+		default:
+			break;
+		}
+	}
+}
+
+void HbImage_Raw_StoreRow(HbGPU_Image_Format format, float const * rgba, uint32_t texelCount, void * target) {
+	if (!HbImage_Raw_CanConvert(format)) {
+		HbFeedback_Crash("HbImage_Raw_StoreRow", "Format %u can't be converted.", (uint32_t) format);
+	}
+	HbImage_Rawi_Format const * formatInfo = &HbImage_Rawi_Formats[format];
+	uint8_t * targetBytes = (uint8_t *) target;
+	switch (formatInfo->type) {
+	case HbImage_Rawi_Type_UNorm:
+		if (formatInfo->channelSize == 1) {
+			HbImage_Rawi_StoreUNorm8(rgba, texelCount, formatInfo->channelCount, formatInfo->bgra, targetBytes);
+			return;
+		}
+		break;
+	case HbImage_Rawi_Type_sRGB:
+		HbImage_Rawi_StoreSRGB8(rgba, texelCount, formatInfo->bgra, targetBytes);
+		return;
+	case HbImage_Rawi_Type_Packed:
+		HbImage_Rawi_StorePacked(format, rgba, texelCount, targetBytes);
+		return;
+	default:
+		break;
+	}
+	HbImage_Rawi_StoreChannels(formatInfo, rgba, texelCount, targetBytes);
+}
+
+/*************
+ * Conversion
+ *************/
+
+void HbImage_Raw_ConvertRow(HbGPU_Image_Format sourceFormat, void const * source, HbGPU_Image_Format targetFormat, void * target,
+		uint32_t texelCount) {
+	uint32_t sourceTexelSize = HbGPU_Image_Copy_ElementSize(sourceFormat, HbFalse);
+	if (sourceFormat == targetFormat && HbImage_Raw_CanConvert(sourceFormat)) {
+		memcpy(target, source, (size_t) texelCount * sourceTexelSize);
+		return;
+	}
+	uint32_t targetTexelSize = HbGPU_Image_Copy_ElementSize(targetFormat, HbFalse);
+	HbMath_VecAligned float rgba[HbImage_Raw_ConvertRow_ChunkTexels * 4];
+	for (uint32_t texelFirst = 0; texelFirst < texelCount; texelFirst += HbImage_Raw_ConvertRow_ChunkTexels) {
+		uint32_t chunkTexelCount = HbMinU32(texelCount - texelFirst, HbImage_Raw_ConvertRow_ChunkTexels);
+		HbImage_Raw_LoadRow(sourceFormat, (uint8_t const *) source + (size_t) texelFirst * sourceTexelSize, chunkTexelCount, rgba);
+		HbImage_Raw_StoreRow(targetFormat, rgba, chunkTexelCount, (uint8_t *) target + (size_t) texelFirst * targetTexelSize);
+	}
+}
+
+// Rows of all the slices are numbered contiguously, the last job gets the remainder.
+typedef struct HbImage_Rawi_ConvertMip_Job {
+	HbGPU_Image_Format sourceFormat;
+	uint8_t const * source;
+	size_t sourceRowPitch;
+	size_t sourceSlicePitch;
+	HbGPU_Image_Format targetFormat;
+	uint8_t * target;
+	size_t targetRowPitch;
+	size_t targetSlicePitch;
+	uint32_t width;
+	uint32_t height;
+	uint32_t rowFirst;
+	uint32_t rowEnd;
+} HbImage_Rawi_ConvertMip_Job;
+
+static void HbImage_Rawi_ConvertMip_RunJob(void * data) {
+	HbImage_Rawi_ConvertMip_Job const * job = (HbImage_Rawi_ConvertMip_Job const *) data;
+	for (uint32_t row = job->rowFirst; row < job->rowEnd; ++row) {
+		uint32_t slice = row / job->height, sliceRow = row - slice * job->height;
+		HbImage_Raw_ConvertRow(job->sourceFormat, job->source + slice * job->sourceSlicePitch + sliceRow * job->sourceRowPitch,
+				job->targetFormat, job->target + slice * job->targetSlicePitch + sliceRow * job->targetRowPitch, job->width);
+	}
+}
+
+void HbImage_Raw_ConvertMip(HbGPU_Image_Format sourceFormat, void const * source, size_t sourceRowPitch, size_t sourceSlicePitch,
+		HbGPU_Image_Format targetFormat, void * target, size_t targetRowPitch, size_t targetSlicePitch,
+		uint32_t width, uint32_t height, uint32_t depth, uint32_t threadCount) {
+	if (!HbImage_Raw_CanConvert(sourceFormat) || !HbImage_Raw_CanConvert(targetFormat)) {
+		HbFeedback_Crash("HbImage_Raw_ConvertMip", "Format %u or %u can't be converted.", (uint32_t) sourceFormat, (uint32_t) targetFormat);
+	}
+	if (width == 0 || height == 0 || depth == 0) {
+		return;
+	}
+	uint32_t rowCount = height * depth;
+	uint32_t maxThreadCount = (rowCount + (HbImage_Raw_ConvertMip_MinRowsPerThread - 1)) / HbImage_Raw_ConvertMip_MinRowsPerThread;
+	threadCount = HbMinU32(HbMinU32(threadCount, maxThreadCount), HbImage_Raw_ConvertMip_MaxThreads);
+	threadCount = HbMaxU32(threadCount, 1);
+	HbImage_Rawi_ConvertMip_Job jobs[HbImage_Raw_ConvertMip_MaxThreads];
+	HbParallel_Thread threads[HbImage_Raw_ConvertMip_MaxThreads];
+	HbBool threadsStarted[HbImage_Raw_ConvertMip_MaxThreads];
+	uint32_t rowsPerJob = rowCount / threadCount;
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		HbImage_Rawi_ConvertMip_Job * job = &jobs[jobIndex];
+		job->sourceFormat = sourceFormat;
+		job->source = (uint8_t const *) source;
+		job->sourceRowPitch = sourceRowPitch;
+		job->sourceSlicePitch = sourceSlicePitch;
+		job->targetFormat = targetFormat;
+		job->target = (uint8_t *) target;
+		job->targetRowPitch = targetRowPitch;
+		job->targetSlicePitch = targetSlicePitch;
+		job->width = width;
+		job->height = height;
+		job->rowFirst = jobIndex * rowsPerJob;
+		job->rowEnd = (jobIndex + 1 == threadCount) ? rowCount : job->rowFirst + rowsPerJob;
+	}
+	// Job 0 is done on the calling thread, and jobs whose threads couldn't be started too.
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		threadsStarted[jobIndex] = HbParallel_Thread_Start(&threads[jobIndex], "HbImageConvert", HbImage_Rawi_ConvertMip_RunJob, &jobs[jobIndex]);
+	}
+	HbImage_Rawi_ConvertMip_RunJob(&jobs[0]);
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		if (threadsStarted[jobIndex]) {
+			HbParallel_Thread_Destroy(&threads[jobIndex]);
+		} else {
+			HbImage_Rawi_ConvertMip_RunJob(&jobs[jobIndex]);
+		}
+	}
+}
@@ -0,0 +1,144 @@
+#ifndef HbInclude_HbImagei_BC
+#define HbInclude_HbImagei_BC
+#include "HbImage_BCDecode.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+// Tables and palette calculation shared by the decoders and the encoders of 4x4-compressed formats.
+
+/*******
+ * BPTC
+ *******/
+
+// Bit N is the subset of texel N.
+extern uint16_t const HbImagei_BC_Partitions2[64];
+// Bits 2N and 2N+1 are the subset of texel N.
+extern uint32_t const HbImagei_BC_Partitions3[64];
+// The texels whose indices are stored with one bit less (the anchor of the first subset is always texel 0).
+extern uint8_t const HbImagei_BC_Anchors2Of2[64];
+extern uint8_t const HbImagei_BC_Anchors2Of3[64];
+extern uint8_t const HbImagei_BC_Anchors3Of3[64];
+// Interpolation weights out of 64 for 2, 3 and 4-bit indices.
+extern uint8_t const HbImagei_BC_Weights2[4];
+extern uint8_t const HbImagei_BC_Weights3[8];
+extern uint8_t const HbImagei_BC_Weights4[16];
+extern uint8_t const * const HbImagei_BC_Weights[5];
+
+HbForceInline uint32_t HbImagei_BC_BPTC_GetSubset(uint32_t subsetCount, uint32_t partition, uint32_t texel) {
+	switch (subsetCount) {
+	case 2:
+		return (HbImagei_BC_Partitions2[partition] >> texel) & 1;
+	case 3:
+		return (HbImagei_BC_Partitions3[partition] >> (texel * 2)) & 3;
+	}
+	return 0;
+}
+
+HbForceInline HbBool HbImagei_BC_BPTC_IsAnchor(uint32_t subsetCount, uint32_t partition, uint32_t texel) {
+	switch (subsetCount) {
+	case 2:
+		return texel == 0 || texel == HbImagei_BC_Anchors2Of2[partition];
+	case 3:
+		return texel == 0 || texel == HbImagei_BC_Anchors2Of3[partition] || texel == HbImagei_BC_Anchors3Of3[partition];
+	}
+	return texel == 0;
+}
+
+typedef struct HbImagei_BC_BPTC_Mode {
+	uint8_t subsetCount;
+	uint8_t partitionBits;
+	uint8_t rotationBits;
+	uint8_t indexSelectionBits;
+	uint8_t colorBits;
+	uint8_t alphaBits; // 0 if opaque.
+	uint8_t endpointPBits; // Whether every endpoint has a P-bit.
+	uint8_t sharedPBits; // Whether both endpoints of every subset share a P-bit.
+	uint8_t indexBits;
+	uint8_t secondaryIndexBits; // Separate alpha or color indices.
+} HbImagei_BC_BPTC_Mode;
+
+extern HbImagei_BC_BPTC_Mode const HbImagei_BC_BPTC_Modes[8];
+
+HbForceInline uint32_t HbImagei_BC_BPTC_Interpolate(uint32_t endpoint0, uint32_t endpoint1, uint32_t weight) {
+	return ((64 - weight) * endpoint0 + weight * endpoint1 + 32) >> 6;
+}
+
+/***************
+ * S3TC and 3Dc
+ ***************/
+
+HbForceInline uint32_t HbImagei_BC_S3TC_Expand565(uint32_t color) {
+	uint32_t r = color >> 11, g = (color >> 5) & 63, b = color & 31;
+	return ((r << 3) | (r >> 2)) | (((g << 2) | (g >> 4)) << 8) | (((b << 3) | (b >> 2)) << 16);
+}
+
+// (weight0 * color0 + weight1 * color1) / divisor for every byte of 8_8_8_8 colors, with alpha of 0xFF.
+HbForceInline uint32_t HbImagei_BC_S3TC_Mix(uint32_t color0, uint32_t weight0, uint32_t color1, uint32_t weight1, uint32_t divisor) {
+	uint32_t mix = 0xFF000000u;
+	for (uint32_t shift = 0; shift < 24; shift += 8) {
+		uint32_t channel = (((color0 >> shift) & 0xFF) * weight0 + ((color1 >> shift) & 0xFF) * weight1 + (divisor >> 1)) / divisor;
+		mix |= channel << shift;
+	}
+	return mix;
+}
+
+// Palette in 8_8_8_8_RGBA colors - with allowPunchThrough, 3 colors and transparent black if color0 <= color1.
+HbForceInline void HbImagei_BC_S3TC_GetPalette(uint32_t color0, uint32_t color1, HbBool allowPunchThrough, uint32_t * palette) {
+	palette[0] = HbImagei_BC_S3TC_Expand565(color0) | 0xFF000000u;
+	palette[1] = HbImagei_BC_S3TC_Expand565(color1) | 0xFF000000u;
+	if (color0 > color1 || !allowPunchThrough) {
+		palette[2] = HbImagei_BC_S3TC_Mix(palette[0], 2, palette[1], 1, 3);
+		palette[3] = HbImagei_BC_S3TC_Mix(palette[0], 1, palette[1], 2, 3);
+	} else {
+		palette[2] = HbImagei_BC_S3TC_Mix(palette[0], 1, palette[1], 1, 2);
+		palette[3] = 0; // Transparent black.
+	}
+}
+
+// Also used for S3TC_A8 alpha.
+HbForceInline void HbImagei_BC_3Dc_GetPaletteUNorm(uint32_t endpoint0, uint32_t endpoint1, uint8_t * palette) {
+	palette[0] = (uint8_t) endpoint0;
+	palette[1] = (uint8_t) endpoint1;
+	if (endpoint0 > endpoint1) {
+		for (uint32_t index = 2; index < 8; ++index) {
+			palette[index] = (uint8_t) (((8 - index) * endpoint0 + (index - 1) * endpoint1 + 3) / 7);
+		}
+	} else {
+		for (uint32_t index = 2; index < 6; ++index) {
+			palette[index] = (uint8_t) (((6 - index) * endpoint0 + (index - 1) * endpoint1 + 2) / 5);
+		}
+		palette[6] = 0;
+		palette[7] = 255;
+	}
+}
+
+// Rounds to the nearest, half away from zero.
+HbForceInline int32_t HbImagei_BC_3Dc_DivideRounded(int32_t value, int32_t divisor) {
+	return (value + (value >= 0 ? divisor >> 1 : -(divisor >> 1))) / divisor;
+}
+
+HbForceInline void HbImagei_BC_3Dc_GetPaletteSNorm(int32_t endpoint0, int32_t endpoint1, int8_t * palette) {
+	// -128 is the same as -127.
+	HbBool sixValues = endpoint0 <= endpoint1;
+	endpoint0 = HbMaxI32(endpoint0, -127);
+	endpoint1 = HbMaxI32(endpoint1, -127);
+	palette[0] = (int8_t) endpoint0;
+	palette[1] = (int8_t) endpoint1;
+	if (!sixValues) {
+		for (int32_t index = 2; index < 8; ++index) {
+			palette[index] = (int8_t) HbImagei_BC_3Dc_DivideRounded((8 - index) * endpoint0 + (index - 1) * endpoint1, 7);
+		}
+	} else {
+		for (int32_t index = 2; index < 6; ++index) {
+			palette[index] = (int8_t) HbImagei_BC_3Dc_DivideRounded((6 - index) * endpoint0 + (index - 1) * endpoint1, 5);
+		}
+		palette[6] = -127;
+		palette[7] = 127;
+	}
+}
+
+#ifdef __cplusplus
+}
+#endif
+#endif
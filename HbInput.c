@@ -1,7 +1,7 @@
 #include "HbFeedback.h"
 #include "HbHash.h"
 #include "HbInput.h"
-#include "HbText.h"
+#include "HbText_Intern.h"
 
 HbMemory_Tag * HbInput_MemoryTag;
 
@@ -152,15 +152,23 @@ char const * const HbInput_Button_BindingNames[HbInput_Button_Code_Count] = {
 	[HbInput_Button_Code_MediaSelect] = "MediaSelect",
 };
 
+// Lowercase name ids in HbText_Intern_Global, so names are compared as integers.
+static uint32_t HbInput_Button_BindingNameCaselessIDs[HbInput_Button_Code_Count];
 static HbInput_Button_Code * HbInput_Button_BindingNameHashMap;
 static uint32_t HbInput_Button_BindingNameHashMapMask;
 
-HbInput_Button_Code HbInput_Button_CodeForBindingName(char const * bindingName) {
-	uint32_t hash = HbHash_FNV1a_HashTextACaseless(bindingName);
+HbInput_Button_Code HbInput_Button_CodeForBindingNameID(uint32_t bindingNameID) {
+	if (bindingNameID == HbText_Intern_InvalidID) {
+		return HbInput_Button_Code_Invalid;
+	}
+	HbText_Intern_Entry const * caselessEntry = HbText_Intern_Get(&HbText_Intern_Global,
+			HbText_Intern_Get(&HbText_Intern_Global, bindingNameID)->caselessID);
+	// The hash of the lowercase string is the caseless hash.
+	uint32_t hash = caselessEntry->hash;
 	uint32_t index = hash & HbInput_Button_BindingNameHashMapMask;
 	HbInput_Button_Code button;
 	while ((button = HbInput_Button_BindingNameHashMap[index]) != HbInput_Button_Code_Invalid) {
-		if (HbTextA_CompareCaseless(HbInput_Button_BindingNames[button], bindingName) == 0) {
+		if (HbInput_Button_BindingNameCaselessIDs[button] == caselessEntry->caselessID) {
 			break;
 		}
 		HbHash_MapUtil_PerturbateIndex(&hash, &index, HbInput_Button_BindingNameHashMapMask);
@@ -168,6 +176,11 @@ HbInput_Button_Code HbInput_Button_CodeForBindingName(char const * bindingName)
 	return button;
 }
 
+HbInput_Button_Code HbInput_Button_CodeForBindingName(char const * bindingName) {
+	// Not interning, names of buttons that don't exist are not needed in the table.
+	return HbInput_Button_CodeForBindingNameID(HbText_Intern_FindCaselessA(&HbText_Intern_Global, bindingName));
+}
+
 uint32_t HbInput_Button_AreDown[(HbInput_Button_Code_Count + 31) >> 5];
 
 HbInput_Gamepad const * HbInput_Gamepad_GetByHandle(uint32_t handle) {
@@ -210,9 +223,16 @@ void HbInput_Init() {
 	for (uint32_t buttonCode = 1; buttonCode < HbInput_Button_Code_Count; ++buttonCode) {
 		char const * bindingName = HbInput_Button_BindingNames[buttonCode];
 		if (bindingName == NULL) {
+			HbInput_Button_BindingNameCaselessIDs[buttonCode] = HbText_Intern_InvalidID;
 			continue;
 		}
-		uint32_t bindingNameHash = HbHash_FNV1a_HashTextACaseless(bindingName);
+		uint32_t bindingNameID = HbText_Intern_AddA(&HbText_Intern_Global, bindingName);
+		if (bindingNameID == HbText_Intern_InvalidID) {
+			HbFeedback_Crash("HbInput_Init", "Failed to intern the binding name %s.", bindingName);
+		}
+		HbText_Intern_Entry const * bindingNameEntry = HbText_Intern_Get(&HbText_Intern_Global, bindingNameID);
+		HbInput_Button_BindingNameCaselessIDs[buttonCode] = bindingNameEntry->caselessID;
+		uint32_t bindingNameHash = bindingNameEntry->caselessHash;
 		uint32_t bindingNameHashMapIndex = bindingNameHash & HbInput_Button_BindingNameHashMapMask;
 		while (HbInput_Button_BindingNameHashMap[bindingNameHashMapIndex] != HbInput_Button_Code_Invalid) {
 			HbHash_MapUtil_PerturbateIndex(&bindingNameHash, &bindingNameHashMapIndex, HbInput_Button_BindingNameHashMapMask);
@@ -179,6 +179,8 @@ typedef enum HbInput_Code_Button {
 extern char const * const HbInput_Button_BindingNames[HbInput_Button_Code_Count];
 
 HbInput_Button_Code HbInput_Button_CodeForBindingName(char const * bindingName);
+// For names from HbText_Intern_Global (such as keys of config files parsed with it), the comparison is caseless.
+HbInput_Button_Code HbInput_Button_CodeForBindingNameID(uint32_t bindingNameID);
 
 extern uint32_t HbInput_Button_AreDown[(HbInput_Button_Code_Count + 31) >> 5];
 HbForceInline HbBool HbInput_Button_IsDown(HbInput_Button_Code button) {
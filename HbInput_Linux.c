@@ -0,0 +1,21 @@
+#include "HbPlatform.h"
+#if HbPlatform_OS_Linux
+#include "HbInput.h"
+
+// Linux is only targeted by console tools and benchmarks, which don't have windows, so no input devices are ever connected.
+
+void HbInputi_InitPlatform() {}
+
+void HbInputi_ShutdownPlatform() {}
+
+void HbInput_Gamepad_Update() {}
+
+uint32_t HbInput_Gamepad_GetCount() {
+	return 0;
+}
+
+HbInput_Gamepad const * HbInput_Gamepad_GetByIndex(uint32_t index) {
+	return NULL;
+}
+
+#endif
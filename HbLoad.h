@@ -1,5 +1,7 @@
 #ifndef HbInclude_HbLoad
 #define HbInclude_HbLoad
+#include "HbFile.h"
+#include "HbFile_DDS.h"
 #include "HbGPU.h"
 #include "HbMemory.h"
 #include "HbParallel.h"
@@ -23,7 +25,7 @@ typedef struct HbLoad_GPUCopier_Submission {
 } HbLoad_GPUCopier_Submission;
 
 typedef struct HbLoad_GPUCopier {
-	HbTextU8 * name; // Allocated from the tag - for large buffer creation.
+	HbTextU8 const * name; // In HbText_Intern_Global - for large buffer creation.
 	HbGPU_Device * device;
 	uint32_t submissionCount;
 	HbLoad_GPUCopier_Submission * submissions; // Allocated from the tag.
@@ -34,7 +36,7 @@ typedef struct HbLoad_GPUCopier {
 	HbLoad_GPUCopier_Submission * queueSubmittedStart, * queueSubmittedEnd; // Order matters.
 } HbLoad_GPUCopier;
 
-HbBool HbLoad_GPUCopier_Init(HbLoad_GPUCopier * copier, HbTextU8 * name, HbGPU_Device * device, HbMemory_Tag * tag,
+HbBool HbLoad_GPUCopier_Init(HbLoad_GPUCopier * copier, HbTextU8 const * name, HbGPU_Device * device, HbMemory_Tag * tag,
 		uint32_t submissionCount, uint32_t bufferSize);
 void HbLoad_GPUCopier_Destroy(HbLoad_GPUCopier * copier);
 // Call occasionally to move slots of the completed submissions back to the free queue, and most importantly to mark the asset as loaded
@@ -56,4 +58,84 @@ void * HbLoad_GPUCopier_GetBuffer(HbLoad_GPUCopier_Submission * submission, uint
 void HbLoad_GPUCopier_Submit(HbLoad_GPUCopier_Submission * submission);
 void HbLoad_GPUCopier_Abort(HbLoad_GPUCopier_Submission * submission); // Don't do this after submission - only to cancel an failed request.
 
+/********************************
+ * Mip streaming of DDS textures
+ ********************************/
+
+// The mip tail (the mips with the largest side of up to HbLoad_TextureStream_TailMaxSize) is loaded right after a texture is added,
+// and more detailed mips are loaded one at a time for the textures with the highest priority that need them, within a fixed budget.
+// When the budget is exceeded, the most detailed mips of the textures with lower priority (or more mips than needed) are evicted.
+// The resident mips are stored in an image of their own size, and changing the resident mip range is done by creating a new image
+// and copying the mips staying resident to it from the old one on the copy queue (along with uploading the new mips).
+// After that, the old image becomes retired - the owner should switch to the new image, and destroy the retired one
+// when the GPU is not using it anymore. The sizes of the images are counted as their upload buffer sizes,
+// and the budget must have room for both the old and the new image of a texture while switching.
+// Images are in the CrossQueue usage after loading, which can be used as textures without barriers.
+// Everything is single-threaded, and the copier must be dedicated to the stream (its completions are handled by the stream).
+
+// Copies the region written by HbFile_DDS_CopyLayout_CopyMips at bufferOffset (slice-aligned) to an image created with layout->info,
+// or, for streaming, to an image containing only mips starting from imageMipFirst (0 for the full image).
+void HbFile_DDS_CopyLayout_RecordCopy(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount,
+		HbGPU_CmdList * cmdList, HbGPU_Image * image, uint32_t imageMipFirst, HbGPU_Buffer * buffer, uint32_t bufferOffset);
+
+#define HbLoad_TextureStream_TailMaxSize 64
+
+typedef struct HbLoad_TextureStream_Texture {
+	struct HbLoad_TextureStream * stream;
+	uint32_t streamTextureIndex;
+	HbTextU8 const * name; // In HbText_Intern_Global - for image creation.
+	HbFile_Reader * reader;
+	uint64_t fileOffset; // Of the DDS file in the reader (may be in an archive).
+	HbFile_DDS_CopyLayout layout;
+	uint32_t tailMipFirst;
+	// All these images contain mips from the specified one to the least detailed mip of the full texture, and exist if it's < layout.info.mips.
+	HbGPU_Image image;
+	uint32_t residentMipFirst;
+	HbGPU_Image loadingImage; // Being copied to on the copy queue.
+	uint32_t loadingMipFirst;
+	HbGPU_Image retiredImage;
+	uint32_t retiredMipFirst;
+	uint32_t wantedMipFirst;
+	uint32_t priority;
+	HbBool loading;
+	HbBool failed; // Reading has failed, not loading more mips.
+} HbLoad_TextureStream_Texture;
+
+typedef struct HbLoad_TextureStream {
+	HbGPU_Device * device;
+	HbLoad_GPUCopier * copier;
+	HbMemory_Tag * tag;
+	uint64_t budget;
+	uint64_t residentSize; // All the images, including the ones being loaded and retired.
+	uint64_t releasingSize; // The retired images and the ones that will be retired when loading is complete.
+	uint32_t uploadSizePerUpdate;
+	HbLoad_TextureStream_Texture * * textures;
+	uint32_t textureCount;
+	uint32_t textureCapacity;
+	void * readBuffer;
+	uint32_t readBufferSize;
+} HbLoad_TextureStream;
+
+void HbLoad_TextureStream_Init(HbLoad_TextureStream * stream, HbGPU_Device * device, HbLoad_GPUCopier * copier, HbMemory_Tag * tag,
+		uint64_t budget, uint32_t uploadSizePerUpdate);
+void HbLoad_TextureStream_Destroy(HbLoad_TextureStream * stream); // All the textures must be destroyed before.
+// Handles the completed loads, and starts loading the tails and the wanted mips until uploadSizePerUpdate is reached.
+void HbLoad_TextureStream_Update(HbLoad_TextureStream * stream);
+
+// Reads the head of the DDS file, the tail will be loaded by the next Update.
+HbBool HbLoad_TextureStream_Texture_Init(HbLoad_TextureStream_Texture * texture, HbLoad_TextureStream * stream, HbTextU8 const * name,
+		HbFile_Reader * reader, uint64_t fileOffset, uint64_t fileSize);
+// Awaits the completion of loading if needed. None of the images must be in use by the GPU.
+void HbLoad_TextureStream_Texture_Destroy(HbLoad_TextureStream_Texture * texture);
+// screenSize is the number of pixels covered by the largest side of the texture, or 0 if it's not visible - the most detailed wanted mip
+// is the one not larger than that, and textures covering more pixels get their mips loaded earlier.
+void HbLoad_TextureStream_Texture_Request(HbLoad_TextureStream_Texture * texture, uint32_t screenSize);
+HbForceInline HbBool HbLoad_TextureStream_Texture_IsResident(HbLoad_TextureStream_Texture const * texture) {
+	return texture->residentMipFirst < texture->layout.info.mips;
+}
+HbForceInline HbBool HbLoad_TextureStream_Texture_HasRetiredImage(HbLoad_TextureStream_Texture const * texture) {
+	return texture->retiredMipFirst < texture->layout.info.mips;
+}
+void HbLoad_TextureStream_Texture_DestroyRetiredImage(HbLoad_TextureStream_Texture * texture);
+
 #endif
@@ -1,42 +1,41 @@
 #include "HbLoad.h"
+#include "HbText_Builder.h"
+#include "HbText_Intern.h"
 
-HbBool HbLoad_GPUCopier_Init(HbLoad_GPUCopier * copier, HbTextU8 * name, HbGPU_Device * device, HbMemory_Tag * tag,
+HbBool HbLoad_GPUCopier_Init(HbLoad_GPUCopier * copier, HbTextU8 const * name, HbGPU_Device * device, HbMemory_Tag * tag,
 		uint32_t submissionCount, uint32_t bufferSize) {
 	if (submissionCount == 0 || bufferSize == 0) {
 		return HbFalse;
 	}
 
-	size_t nameLength = 0;
-	HbTextU8 * submissionFieldName = NULL;
-	size_t submissionFieldNameSize = 0;
-	size_t submissionFieldNameSuffixOffset = 0;
+	// Submission field names share the prefix, only the index and the field are rewritten for every object.
+	HbTextU8 submissionFieldNameStackBuffer[128];
+	HbText_Builder submissionFieldName;
+	HbText_Builder_InitGrowable(&submissionFieldName, tag, submissionFieldNameStackBuffer, sizeof(submissionFieldNameStackBuffer));
+	size_t submissionFieldNamePrefixLength = 0;
+	copier->name = NULL;
 	if (name != NULL) {
-		nameLength = HbTextU8_LengthElems(name);
-		copier->name = HbMemory_TryAlloc(tag, nameLength + 1, HbFalse);
-		if (copier->name != NULL) {
-			HbTextA_Copy(copier->name, nameLength + 1, name);
+		size_t nameLength = HbTextU8_LengthElems(name);
+		uint32_t nameID = HbText_Intern_Add(&HbText_Intern_Global, name, nameLength);
+		if (nameID != HbText_Intern_InvalidID) {
+			copier->name = HbText_Intern_GetText(&HbText_Intern_Global, nameID);
 		}
-		char const submissionFieldNamePrefix[] = "";
-		// Used fields: fence (length 5), cmdList (7), buffer (6).
-		submissionFieldNameSize = nameLength + HbText_Decimal_MaxLengthU32 + sizeof(".submissions[].cmdList");
-		submissionFieldName = HbStackAlloc(HbTextU8, submissionFieldNameSize);
-		submissionFieldNameSuffixOffset = HbTextA_Copy(submissionFieldName, submissionFieldNameSize, name);
-		submissionFieldNameSuffixOffset += HbTextA_CopyInto(submissionFieldName, submissionFieldNameSize, submissionFieldNameSuffixOffset, ".submissions[");
-	} else {
-		copier->name = NULL;
+		HbText_Builder_AppendSized(&submissionFieldName, name, nameLength);
+		HbText_Builder_AppendA(&submissionFieldName, ".submissions[");
+		submissionFieldNamePrefixLength = submissionFieldName.length;
 	}
 
 	copier->device = device;
 
 	if (!HbParallel_Mutex_Init(&copier->queueMutex)) {
-		HbMemory_Free(copier->name);
+		HbText_Builder_Destroy(&submissionFieldName);
 		return HbFalse;
 	}
 	copier->queueFree = NULL;
 	copier->submissions = HbMemory_TryAlloc(tag, submissionCount * sizeof(HbLoad_GPUCopier_Submission), HbFalse);
 	if (copier->submissions == NULL) {
 		HbParallel_Mutex_Destroy(&copier->queueMutex);
-		HbMemory_Free(copier->name);
+		HbText_Builder_Destroy(&submissionFieldName);
 		return HbFalse;
 	}
 	copier->submissionCount = submissionCount;
@@ -46,24 +45,30 @@ HbBool HbLoad_GPUCopier_Init(HbLoad_GPUCopier * copier, HbTextU8 * name, HbGPU_D
 		submission->index = submissionIndex;
 		submission->largeBufferUsed = HbFalse;
 		HbBool submissionInitialized = HbTrue;
-		if (submissionFieldName != NULL) {
-			HbTextA_Format(submissionFieldName + submissionFieldNameSuffixOffset, submissionFieldNameSize - submissionFieldNameSuffixOffset,
-					"%u].fence", submissionIndex);
+		HbTextU8 const * fieldName = NULL;
+		if (name != NULL) {
+			HbText_Builder_SetLength(&submissionFieldName, submissionFieldNamePrefixLength);
+			HbText_Builder_Format(&submissionFieldName, "%u].fence", submissionIndex);
+			fieldName = HbText_Builder_GetText(&submissionFieldName);
 		}
-		if (!HbGPU_Fence_Init(&submission->fence, submissionFieldName, device, HbGPU_CmdQueue_Copy)) {
+		if (!HbGPU_Fence_Init(&submission->fence, fieldName, device, HbGPU_CmdQueue_Copy)) {
 			submissionInitialized = HbFalse;
 		} else {
-			if (submissionFieldName != NULL) {
-				HbTextA_Format(submissionFieldName + submissionFieldNameSuffixOffset, submissionFieldNameSize - submissionFieldNameSuffixOffset,
-						"%u].cmdList", submissionIndex);
+			if (name != NULL) {
+				HbText_Builder_SetLength(&submissionFieldName, submissionFieldNamePrefixLength);
+				HbText_Builder_Format(&submissionFieldName, "%u].cmdList", submissionIndex);
+				fieldName = HbText_Builder_GetText(&submissionFieldName);
 			}
-			if (!HbGPU_CmdList_Init(&submission->cmdList, submissionFieldName, device, HbGPU_CmdQueue_Copy)) {
+			if (!HbGPU_CmdList_Init(&submission->cmdList, fieldName, device, HbGPU_CmdQueue_Copy)) {
 				HbGPU_Fence_Destroy(&submission->fence);
 				submissionInitialized = HbFalse;
 			} else {
-				HbTextA_Format(submissionFieldName + submissionFieldNameSuffixOffset, submissionFieldNameSize - submissionFieldNameSuffixOffset,
-						"%u].buffer", submissionIndex);
-				if (!HbGPU_Buffer_Init(&submission->buffer, submissionFieldName, device, HbGPU_Buffer_Access_CPUToGPU, bufferSize, HbFalse, HbGPU_Buffer_Usage_CPUToGPU)) {
+				if (name != NULL) {
+					HbText_Builder_SetLength(&submissionFieldName, submissionFieldNamePrefixLength);
+					HbText_Builder_Format(&submissionFieldName, "%u].buffer", submissionIndex);
+					fieldName = HbText_Builder_GetText(&submissionFieldName);
+				}
+				if (!HbGPU_Buffer_Init(&submission->buffer, fieldName, device, HbGPU_Buffer_Access_CPUToGPU, bufferSize, HbFalse, HbGPU_Buffer_Usage_CPUToGPU)) {
 					HbGPU_CmdList_Destroy(&submission->cmdList);
 					HbGPU_Fence_Destroy(&submission->fence);
 					submissionInitialized = HbFalse;
@@ -87,13 +92,14 @@ HbBool HbLoad_GPUCopier_Init(HbLoad_GPUCopier * copier, HbTextU8 * name, HbGPU_D
 			}
 			HbMemory_Free(copier->submissions);
 			HbParallel_Mutex_Destroy(&copier->queueMutex);
-			HbMemory_Free(copier->name);
+			HbText_Builder_Destroy(&submissionFieldName);
 			return HbFalse;
 		}
 		submission->nextInQueue = copier->queueFree;
 		copier->queueFree = submission;
 	}
 	copier->queueSubmittedStart = copier->queueSubmittedEnd = NULL;
+	HbText_Builder_Destroy(&submissionFieldName);
 
 	return HbTrue;
 }
@@ -117,7 +123,6 @@ void HbLoad_GPUCopier_Destroy(HbLoad_GPUCopier * copier) {
 	}
 	HbMemory_Free(copier->submissions);
 	HbParallel_Mutex_Destroy(&copier->queueMutex);
-	HbMemory_Free(copier->name);
 }
 
 HbBool HbLoad_GPUCopier_HandleCompletion(HbLoad_GPUCopier * copier, void * * requestDataOut, HbBool blockUntilComplete) {
@@ -193,14 +198,16 @@ void * HbLoad_GPUCopier_GetBuffer(HbLoad_GPUCopier_Submission * submission, uint
 		*bufferOut = &submission->buffer;
 		return submission->bufferMapping;
 	}
-	HbTextU8 * largeBufferName = NULL;
+	// The name is only for debugging, so it's truncated rather than allocated if it's too long.
+	HbTextU8 largeBufferNameBuffer[256];
+	HbText_Builder largeBufferName;
+	HbText_Builder_InitFixed(&largeBufferName, largeBufferNameBuffer, sizeof(largeBufferNameBuffer));
 	HbTextU8 const * copierName = submission->copier->name;
 	if (copierName != NULL) {
-		size_t largeBufferNameSize = HbTextU8_LengthElems(copierName) + HbText_Decimal_MaxLengthU32 + sizeof(".submissions[].largeBuffer");
-		largeBufferName = HbStackAlloc(HbTextU8, largeBufferNameSize);
-		HbTextA_Format(largeBufferName, largeBufferNameSize, "%s.submissions[%u].largeBuffer", copierName, submission->index);
+		HbText_Builder_Format(&largeBufferName, "%s.submissions[%u].largeBuffer", copierName, submission->index);
 	}
-	if (!HbGPU_Buffer_Init(&submission->largeBuffer, largeBufferName, submission->copier->device,
+	if (!HbGPU_Buffer_Init(&submission->largeBuffer, copierName != NULL ? HbText_Builder_GetText(&largeBufferName) : NULL,
+			submission->copier->device,
 			HbGPU_Buffer_Access_CPUToGPU, size, HbFalse, HbGPU_Buffer_Usage_CPUToGPU)) {
 		return NULL;
 	}
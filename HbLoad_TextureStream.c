@@ -0,0 +1,411 @@
+#include "HbLoad.h"
+#include "HbFeedback.h"
+#include "HbText_Intern.h"
+
+void HbFile_DDS_CopyLayout_RecordCopy(HbFile_DDS_CopyLayout const * layout, uint32_t mipFirst, uint32_t mipCount,
+		HbGPU_CmdList * cmdList, HbGPU_Image * image, uint32_t imageMipFirst, HbGPU_Buffer * buffer, uint32_t bufferOffset) {
+	HbGPU_Image_Info const * info = &layout->info;
+	HbBool isCube = HbGPU_Image_Dimensions_AreCube(info->dimensions);
+	for (uint32_t layer = 0; layer < layout->layerCount; ++layer) {
+		HbGPU_Image_Slice slice = {
+			.cubeSide = isCube ? layer % 6 : 0,
+			.layer = isCube ? layer / 6 : layer,
+		};
+		for (uint32_t mip = mipFirst; mip < mipFirst + mipCount; ++mip) {
+			HbFile_DDS_CopyLayout_Mip const * layoutMip = &layout->mips[mip];
+			slice.mip = mip - imageMipFirst;
+			uint32_t mipWidth = info->width, mipHeight = info->height;
+			HbGPU_Image_MipSize(mip, info->dimensions, &mipWidth, &mipHeight, NULL);
+			HbGPU_CmdList_Copy_ImageXBuffer(cmdList, HbFalse, image, slice, 0, 0, 0,
+					buffer, bufferOffset, layoutMip->copyRowPitch, layoutMip->rowCount, mipWidth, mipHeight, layoutMip->depth);
+			bufferOffset += layoutMip->copySize;
+		}
+	}
+}
+
+// The most detailed mip of an image with a 4x4-compressed format must consist of whole blocks (Direct3D restriction).
+static HbBool HbLoad_TextureStreami_IsMipFirstValid(HbGPU_Image_Info const * info, uint32_t mip) {
+	if (mip == 0 || !HbGPU_Image_Format_Is4x4(info->format)) {
+		return HbTrue;
+	}
+	uint32_t mipWidth = info->width, mipHeight = info->height;
+	HbGPU_Image_MipSize(mip, info->dimensions, &mipWidth, &mipHeight, NULL);
+	return ((mipWidth | mipHeight) & 3) == 0;
+}
+
+static uint32_t HbLoad_TextureStreami_GetMipMaxSide(HbGPU_Image_Info const * info, uint32_t mip) {
+	uint32_t mipWidth = info->width, mipHeight = info->height, mipDepth = info->depthOrLayers;
+	HbGPU_Image_MipSize(mip, info->dimensions, &mipWidth, &mipHeight, &mipDepth);
+	return HbMaxU32(HbMaxU32(mipWidth, mipHeight), mipDepth);
+}
+
+// Of an image with mips from mipFirst to the least detailed one, 0 if none.
+static uint64_t HbLoad_TextureStreami_GetImageSize(HbLoad_TextureStream_Texture const * texture, uint32_t mipFirst) {
+	HbFile_DDS_CopyLayout const * layout = &texture->layout;
+	uint64_t layerSize = 0;
+	for (uint32_t mip = mipFirst; mip < layout->info.mips; ++mip) {
+		layerSize += layout->mips[mip].copySize;
+	}
+	return layerSize * layout->layerCount;
+}
+
+static HbBool HbLoad_TextureStreami_CanSwitch(HbLoad_TextureStream_Texture const * texture) {
+	// Only one retired image at once, so the owner has a chance to stop using it.
+	return !texture->loading && !texture->failed && !HbLoad_TextureStream_Texture_HasRetiredImage(texture);
+}
+
+// Returns layout.info.mips if nothing needs to be loaded.
+static uint32_t HbLoad_TextureStreami_GetLoadMipFirst(HbLoad_TextureStream_Texture const * texture) {
+	if (!HbLoad_TextureStream_Texture_IsResident(texture)) {
+		return texture->tailMipFirst;
+	}
+	if (texture->wantedMipFirst >= texture->residentMipFirst) {
+		return texture->layout.info.mips;
+	}
+	uint32_t mip = texture->residentMipFirst - 1;
+	while (!HbLoad_TextureStreami_IsMipFirstValid(&texture->layout.info, mip)) {
+		--mip; // Mip 0 is always valid.
+	}
+	return mip;
+}
+
+// Returns layout.info.mips if nothing can be evicted (the tail is never evicted).
+static uint32_t HbLoad_TextureStreami_GetEvictMipFirst(HbLoad_TextureStream_Texture const * texture) {
+	if (texture->residentMipFirst >= texture->tailMipFirst) {
+		return texture->layout.info.mips;
+	}
+	uint32_t mip = texture->residentMipFirst + 1;
+	while (mip < texture->tailMipFirst && !HbLoad_TextureStreami_IsMipFirstValid(&texture->layout.info, mip)) {
+		++mip;
+	}
+	return mip;
+}
+
+static HbBool HbLoad_TextureStreami_ReserveReadBuffer(HbLoad_TextureStream * stream, uint32_t size) {
+	if (size <= stream->readBufferSize) {
+		return HbTrue;
+	}
+	if (stream->readBuffer == NULL) {
+		stream->readBuffer = HbMemory_TryAlloc(stream->tag, size, HbTrue);
+		if (stream->readBuffer == NULL) {
+			return HbFalse;
+		}
+	} else if (!HbMemory_TryRealloc(&stream->readBuffer, size)) {
+		return HbFalse;
+	}
+	stream->readBufferSize = size;
+	return HbTrue;
+}
+
+// Creates the image with mips starting from mipFirst, uploads the missing mips and copies the resident ones to it.
+static HbBool HbLoad_TextureStreami_StartSwitch(HbLoad_TextureStream_Texture * texture, uint32_t mipFirst, uint32_t * uploadSizeOut) {
+	HbLoad_TextureStream * stream = texture->stream;
+	HbFile_DDS_CopyLayout const * layout = &texture->layout;
+	HbGPU_Image_Info const * info = &layout->info;
+	HbBool isResident = HbLoad_TextureStream_Texture_IsResident(texture);
+
+	uint32_t uploadMipCount = mipFirst < texture->residentMipFirst ? texture->residentMipFirst - mipFirst : 0;
+	uint32_t uploadSize = 0;
+	if (uploadMipCount != 0) {
+		uploadSize = HbFile_DDS_CopyLayout_GetCopySize(layout, mipFirst, uploadMipCount);
+		if (uploadSize == 0) {
+			texture->failed = HbTrue;
+			return HbFalse;
+		}
+	}
+
+	HbLoad_GPUCopier_Submission * submission = HbLoad_GPUCopier_Request(stream->copier, texture);
+	if (submission == NULL) {
+		return HbFalse;
+	}
+	HbGPU_Buffer * buffer;
+	HbGPU_CmdList * cmdList;
+	uint8_t * mapping = HbLoad_GPUCopier_GetBuffer(submission, uploadSize, &buffer, &cmdList);
+	if (mapping == NULL) {
+		HbLoad_GPUCopier_Abort(submission);
+		return HbFalse;
+	}
+
+	// The mips of every layer are read separately since they're contiguous in the file only within one layer.
+	if (uploadMipCount != 0) {
+		uint8_t * target = mapping;
+		for (uint32_t layer = 0; layer < layout->layerCount; ++layer) {
+			uint64_t sourceOffset, sourceSize;
+			HbFile_DDS_CopyLayout_GetLayerSourceRange(layout, layer, mipFirst, uploadMipCount, &sourceOffset, &sourceSize);
+			// The source is never larger than the upload buffer region.
+			if (!HbLoad_TextureStreami_ReserveReadBuffer(stream, (uint32_t) sourceSize)) {
+				HbLoad_GPUCopier_Abort(submission);
+				return HbFalse;
+			}
+			if (!HbFile_Reader_Read(texture->reader, texture->fileOffset + sourceOffset, stream->readBuffer, (uint32_t) sourceSize)) {
+				HbLoad_GPUCopier_Abort(submission);
+				texture->failed = HbTrue;
+				return HbFalse;
+			}
+			target += HbFile_DDS_CopyLayout_CopyLayerMips(layout, mipFirst, uploadMipCount, stream->readBuffer, target);
+		}
+		HbMath_NonTemporalStoreFence();
+	}
+
+	HbGPU_Image * loadingImage = &texture->loadingImage;
+	loadingImage->info = *info;
+	HbGPU_Image_MipSize(mipFirst, info->dimensions, &loadingImage->info.width, &loadingImage->info.height,
+			info->dimensions == HbGPU_Image_Dimensions_3D ? &loadingImage->info.depthOrLayers : NULL);
+	loadingImage->info.mips -= mipFirst;
+	// Cross-queue usage is implicitly promoted to copy target on the copy queue, and to texture on the graphics queue.
+	if (!HbGPU_Image_InitWithValidInfo(loadingImage, texture->name, stream->device, HbGPU_Image_Usage_CrossQueue, NULL)) {
+		HbLoad_GPUCopier_Abort(submission);
+		return HbFalse;
+	}
+
+	if (uploadMipCount != 0) {
+		HbFile_DDS_CopyLayout_RecordCopy(layout, mipFirst, uploadMipCount, cmdList, loadingImage, mipFirst, buffer, 0);
+	}
+	if (isResident) {
+		HbBool isCube = HbGPU_Image_Dimensions_AreCube(info->dimensions);
+		uint32_t keptMipFirst = HbMaxU32(mipFirst, texture->residentMipFirst);
+		for (uint32_t layer = 0; layer < layout->layerCount; ++layer) {
+			HbGPU_Image_Slice targetSlice = {
+				.cubeSide = isCube ? layer % 6 : 0,
+				.layer = isCube ? layer / 6 : layer,
+			};
+			HbGPU_Image_Slice sourceSlice = targetSlice;
+			for (uint32_t mip = keptMipFirst; mip < info->mips; ++mip) {
+				targetSlice.mip = mip - mipFirst;
+				sourceSlice.mip = mip - texture->residentMipFirst;
+				uint32_t mipWidth = info->width, mipHeight = info->height, mipDepth = info->depthOrLayers;
+				HbGPU_Image_MipSize(mip, info->dimensions, &mipWidth, &mipHeight, &mipDepth);
+				HbGPU_CmdList_Copy_ImageXImage(cmdList, loadingImage, targetSlice, 0, 0, 0,
+						&texture->image, sourceSlice, 0, 0, 0, mipWidth, mipHeight, mipDepth);
+			}
+		}
+	}
+
+	HbLoad_GPUCopier_Submit(submission);
+	texture->loadingMipFirst = mipFirst;
+	texture->loading = HbTrue;
+	stream->residentSize += HbLoad_TextureStreami_GetImageSize(texture, mipFirst);
+	if (isResident) {
+		stream->releasingSize += HbLoad_TextureStreami_GetImageSize(texture, texture->residentMipFirst);
+	}
+	*uploadSizeOut = uploadSize;
+	return HbTrue;
+}
+
+static void HbLoad_TextureStreami_CompleteSwitch(HbLoad_TextureStream_Texture * texture) {
+	if (HbLoad_TextureStream_Texture_IsResident(texture)) {
+		texture->retiredImage = texture->image;
+		texture->retiredMipFirst = texture->residentMipFirst;
+	}
+	texture->image = texture->loadingImage;
+	texture->residentMipFirst = texture->loadingMipFirst;
+	texture->loading = HbFalse;
+}
+
+// Starts evicting mips of textures with priority lower than the specified one until neededSize will be released.
+// The memory is actually released when the retired images are destroyed.
+static HbBool HbLoad_TextureStreami_Evict(HbLoad_TextureStream * stream, uint32_t priority, uint64_t neededSize) {
+	while (neededSize != 0) {
+		HbLoad_TextureStream_Texture * evictTexture = NULL;
+		uint32_t evictPriority = 0;
+		for (uint32_t textureIndex = 0; textureIndex < stream->textureCount; ++textureIndex) {
+			HbLoad_TextureStream_Texture * texture = stream->textures[textureIndex];
+			if (!HbLoad_TextureStreami_CanSwitch(texture) ||
+					HbLoad_TextureStreami_GetEvictMipFirst(texture) >= texture->layout.info.mips) {
+				continue;
+			}
+			// Mips that are not wanted anymore are evicted before anything else.
+			uint32_t texturePriority = texture->wantedMipFirst > texture->residentMipFirst ? 0 : texture->priority;
+			if (texturePriority < priority && (evictTexture == NULL || texturePriority < evictPriority)) {
+				evictTexture = texture;
+				evictPriority = texturePriority;
+			}
+		}
+		if (evictTexture == NULL) {
+			return HbFalse;
+		}
+		uint32_t evictMipFirst = HbLoad_TextureStreami_GetEvictMipFirst(evictTexture);
+		uint64_t releasedSize = HbLoad_TextureStreami_GetImageSize(evictTexture, evictTexture->residentMipFirst) -
+				HbLoad_TextureStreami_GetImageSize(evictTexture, evictMipFirst);
+		uint32_t uploadSize;
+		if (!HbLoad_TextureStreami_StartSwitch(evictTexture, evictMipFirst, &uploadSize)) {
+			return HbFalse;
+		}
+		neededSize -= HbMinI(neededSize, releasedSize);
+	}
+	return HbTrue;
+}
+
+void HbLoad_TextureStream_Init(HbLoad_TextureStream * stream, HbGPU_Device * device, HbLoad_GPUCopier * copier, HbMemory_Tag * tag,
+		uint64_t budget, uint32_t uploadSizePerUpdate) {
+	stream->device = device;
+	stream->copier = copier;
+	stream->tag = tag;
+	stream->budget = budget;
+	stream->residentSize = 0;
+	stream->releasingSize = 0;
+	stream->uploadSizePerUpdate = uploadSizePerUpdate;
+	stream->textures = NULL;
+	stream->textureCount = 0;
+	stream->textureCapacity = 0;
+	stream->readBuffer = NULL;
+	stream->readBufferSize = 0;
+}
+
+void HbLoad_TextureStream_Destroy(HbLoad_TextureStream * stream) {
+	if (stream->textureCount != 0) {
+		HbFeedback_Crash("HbLoad_TextureStream_Destroy", "%u textures have not been destroyed.", stream->textureCount);
+	}
+	HbMemory_Free(stream->readBuffer);
+	HbMemory_Free(stream->textures);
+}
+
+void HbLoad_TextureStream_Update(HbLoad_TextureStream * stream) {
+	void * requestData;
+	while (HbLoad_GPUCopier_HandleCompletion(stream->copier, &requestData, HbFalse)) {
+		HbLoad_TextureStreami_CompleteSwitch((HbLoad_TextureStream_Texture *) requestData);
+	}
+
+	uint32_t uploadedSize = 0;
+	while (uploadedSize < stream->uploadSizePerUpdate) {
+		// Tails first, then the next mip of the texture with the highest priority.
+		HbLoad_TextureStream_Texture * loadTexture = NULL;
+		uint32_t loadPriority = 0;
+		for (uint32_t textureIndex = 0; textureIndex < stream->textureCount; ++textureIndex) {
+			HbLoad_TextureStream_Texture * texture = stream->textures[textureIndex];
+			if (!HbLoad_TextureStreami_CanSwitch(texture) ||
+					HbLoad_TextureStreami_GetLoadMipFirst(texture) >= texture->layout.info.mips) {
+				continue;
+			}
+			uint32_t texturePriority = HbLoad_TextureStream_Texture_IsResident(texture) ? texture->priority : UINT32_MAX;
+			if (loadTexture == NULL || texturePriority > loadPriority) {
+				loadTexture = texture;
+				loadPriority = texturePriority;
+			}
+		}
+		if (loadTexture == NULL) {
+			break;
+		}
+		uint32_t loadMipFirst = HbLoad_TextureStreami_GetLoadMipFirst(loadTexture);
+		uint64_t loadSize = HbLoad_TextureStreami_GetImageSize(loadTexture, loadMipFirst);
+		// The current image of the texture will be released after loading, but until then, both images exist.
+		uint64_t keptSize = stream->residentSize - stream->releasingSize -
+				HbLoad_TextureStreami_GetImageSize(loadTexture, loadTexture->residentMipFirst);
+		if (keptSize + loadSize > stream->budget &&
+				!HbLoad_TextureStreami_Evict(stream, loadPriority, keptSize + loadSize - stream->budget)) {
+			break;
+		}
+		if (stream->residentSize + loadSize > stream->budget) {
+			break; // Waiting for the retired images to be destroyed.
+		}
+		uint32_t uploadSize;
+		if (!HbLoad_TextureStreami_StartSwitch(loadTexture, loadMipFirst, &uploadSize)) {
+			if (loadTexture->failed) {
+				continue;
+			}
+			break;
+		}
+		uploadedSize += uploadSize;
+	}
+}
+
+HbBool HbLoad_TextureStream_Texture_Init(HbLoad_TextureStream_Texture * texture, HbLoad_TextureStream * stream, HbTextU8 const * name,
+		HbFile_Reader * reader, uint64_t fileOffset, uint64_t fileSize) {
+	uint32_t head[(HbFile_DDS_MaxHeadSize + sizeof(uint32_t) - 1) / sizeof(uint32_t)];
+	uint32_t headSize = (uint32_t) HbMinI(HbFile_DDS_MaxHeadSize, fileSize);
+	if (!HbFile_Reader_Read(reader, fileOffset, head, headSize)) {
+		return HbFalse;
+	}
+	HbFile_DDS_CopyLayout * layout = &texture->layout;
+	if (!HbFile_DDS_CopyLayout_InitFromHead(layout, head, headSize, fileSize)) {
+		return HbFalse;
+	}
+	HbGPU_Image_Info const * info = &layout->info;
+
+	if (stream->textureCount >= stream->textureCapacity) {
+		uint32_t newCapacity = HbMaxU32(stream->textureCapacity * 2, 16);
+		if (stream->textures == NULL) {
+			stream->textures = HbMemory_TryAlloc(stream->tag, newCapacity * sizeof(HbLoad_TextureStream_Texture *), HbFalse);
+			if (stream->textures == NULL) {
+				return HbFalse;
+			}
+		} else if (!HbMemory_TryRealloc((void * *) &stream->textures, newCapacity * sizeof(HbLoad_TextureStream_Texture *))) {
+			return HbFalse;
+		}
+		stream->textureCapacity = newCapacity;
+	}
+	texture->stream = stream;
+	texture->streamTextureIndex = stream->textureCount;
+	stream->textures[stream->textureCount++] = texture;
+
+	texture->name = NULL;
+	if (name != NULL) {
+		uint32_t nameID = HbText_Intern_Add(&HbText_Intern_Global, name, HbTextU8_LengthElems(name));
+		if (nameID != HbText_Intern_InvalidID) {
+			texture->name = HbText_Intern_GetText(&HbText_Intern_Global, nameID);
+		}
+	}
+	texture->reader = reader;
+	texture->fileOffset = fileOffset;
+
+	uint32_t tailMipFirst = 0;
+	while (tailMipFirst + 1 < info->mips && HbLoad_TextureStreami_GetMipMaxSide(info, tailMipFirst) > HbLoad_TextureStream_TailMaxSize) {
+		++tailMipFirst;
+	}
+	while (!HbLoad_TextureStreami_IsMipFirstValid(info, tailMipFirst)) {
+		--tailMipFirst;
+	}
+	texture->tailMipFirst = tailMipFirst;
+
+	texture->residentMipFirst = info->mips;
+	texture->loadingMipFirst = info->mips;
+	texture->retiredMipFirst = info->mips;
+	texture->wantedMipFirst = tailMipFirst;
+	texture->priority = 0;
+	texture->loading = HbFalse;
+	texture->failed = HbFalse;
+	return HbTrue;
+}
+
+void HbLoad_TextureStream_Texture_Destroy(HbLoad_TextureStream_Texture * texture) {
+	HbLoad_TextureStream * stream = texture->stream;
+	while (texture->loading) {
+		void * requestData;
+		if (HbLoad_GPUCopier_HandleCompletion(stream->copier, &requestData, HbTrue)) {
+			HbLoad_TextureStreami_CompleteSwitch((HbLoad_TextureStream_Texture *) requestData);
+		}
+	}
+	HbLoad_TextureStream_Texture_DestroyRetiredImage(texture);
+	if (HbLoad_TextureStream_Texture_IsResident(texture)) {
+		HbGPU_Image_Destroy(&texture->image);
+		stream->residentSize -= HbLoad_TextureStreami_GetImageSize(texture, texture->residentMipFirst);
+	}
+	HbLoad_TextureStream_Texture * movedTexture = stream->textures[--stream->textureCount];
+	stream->textures[texture->streamTextureIndex] = movedTexture;
+	movedTexture->streamTextureIndex = texture->streamTextureIndex;
+}
+
+void HbLoad_TextureStream_Texture_Request(HbLoad_TextureStream_Texture * texture, uint32_t screenSize) {
+	texture->priority = screenSize;
+	uint32_t wantedMipFirst = texture->tailMipFirst;
+	if (screenSize != 0) {
+		// The least detailed mip that still has at least as many texels as the pixels covered.
+		uint32_t maxSide = HbLoad_TextureStreami_GetMipMaxSide(&texture->layout.info, 0);
+		wantedMipFirst = 0;
+		while (wantedMipFirst < texture->tailMipFirst && (maxSide >> (wantedMipFirst + 1)) >= screenSize) {
+			++wantedMipFirst;
+		}
+	}
+	texture->wantedMipFirst = wantedMipFirst;
+}
+
+void HbLoad_TextureStream_Texture_DestroyRetiredImage(HbLoad_TextureStream_Texture * texture) {
+	if (!HbLoad_TextureStream_Texture_HasRetiredImage(texture)) {
+		return;
+	}
+	HbGPU_Image_Destroy(&texture->retiredImage);
+	uint64_t retiredSize = HbLoad_TextureStreami_GetImageSize(texture, texture->retiredMipFirst);
+	texture->stream->residentSize -= retiredSize;
+	texture->stream->releasingSize -= retiredSize;
+	texture->retiredMipFirst = texture->layout.info.mips;
+}
@@ -91,6 +91,8 @@ typedef __m128i HbMath_U32x4;
 #define HbMath_S32x4_LoadReplicated _mm_set1_epi32
 #define HbMath_U32x4_LoadReplicated(value) _mm_set1_epi32((int32_t) (value))
 #define HbMath_F32x4_LoadX000 _mm_set_ss
+#define HbMath_F32x4_LoadXYZW _mm_setr_ps
+#define HbMath_S32x4_LoadXYZW _mm_setr_epi32
 #define HbMath_F32x4_StoreAligned _mm_store_ps
 #define HbMath_S32x4_StoreAligned _mm_store_si128
 #define HbMath_U32x4_StoreAligned HbMath_S32x4_StoreAligned
@@ -119,6 +121,8 @@ HbForceInline HbMath_F32x4 HbMath_F32x4_ReplicateW(HbMath_F32x4 v) { return _mm_
 HbForceInline HbMath_F32x4 HbMath_F32x4_RotateYZWX(HbMath_F32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(0, 3, 2, 1)); }
 HbForceInline HbMath_F32x4 HbMath_F32x4_RotateZWXY(HbMath_F32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(1, 0, 3, 2)); }
 HbForceInline HbMath_F32x4 HbMath_F32x4_RotateWXYZ(HbMath_F32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 1, 0, 3)); }
+// RGBA to BGRA and back.
+HbForceInline HbMath_F32x4 HbMath_F32x4_SwapXZ(HbMath_F32x4 v) { return _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 0, 1, 2)); }
 #define HbMath_S32x4_RotateYZWX(v) _mm_shuffle_epi32(v, _MM_SHUFFLE(0, 3, 2, 1))
 #define HbMath_U32x4_RotateYZWX HbMath_S32x4_RotateYZWX
 #define HbMath_S32x4_RotateZWXY(v) _mm_shuffle_epi32(v, _MM_SHUFFLE(1, 0, 3, 2))
@@ -130,6 +134,19 @@ HbForceInline HbMath_F32x4 HbMath_F32x4_RotateWXYZ(HbMath_F32x4 v) { return _mm_
 
 #define HbMath_F32x4_CombineXYXY _mm_movelh_ps
 #define HbMath_F32x4_CombineZWZW(a, b) _mm_movehl_ps(b, a)
+#define HbMath_S32x4_CombineXYXY _mm_unpacklo_epi64
+#define HbMath_U32x4_CombineXYXY HbMath_S32x4_CombineXYXY
+#define HbMath_S32x4_CombineZWZW _mm_unpackhi_epi64
+#define HbMath_U32x4_CombineZWZW HbMath_S32x4_CombineZWZW
+// a.x, b.x, a.y, b.y and a.z, b.z, a.w, b.w - for transposing.
+#define HbMath_F32x4_InterleaveXY _mm_unpacklo_ps
+#define HbMath_F32x4_InterleaveZW _mm_unpackhi_ps
+#define HbMath_S32x4_InterleaveXY _mm_unpacklo_epi32
+#define HbMath_U32x4_InterleaveXY HbMath_S32x4_InterleaveXY
+#define HbMath_S32x4_InterleaveZW _mm_unpackhi_epi32
+#define HbMath_U32x4_InterleaveZW HbMath_S32x4_InterleaveZW
+// Rows to columns, in place (the arguments must be variables).
+#define HbMath_F32x4_Transpose(v0, v1, v2, v3) _MM_TRANSPOSE4_PS(v0, v1, v2, v3)
 
 #define HbMath_F32x4_BitsAsS32x4 _mm_castps_si128
 #define HbMath_F32x4_BitsAsU32x4 HbMath_F32x4_BitsAsS32x4
@@ -151,6 +168,10 @@ HbForceInline HbMath_F32x4 HbMath_F32x4_RotateWXYZ(HbMath_F32x4 v) { return _mm_
 #define HbMath_S32x4_CompareEqual _mm_cmpeq_epi32
 #define HbMath_U32x4_CompareEqual HbMath_S32x4_CompareEqual
 #define HbMath_S32x4_CompareGreater _mm_cmpgt_epi32
+// Bit N is the highest bit of lane N - for checking whether any comparison has passed.
+#define HbMath_F32x4_SignBits _mm_movemask_ps
+#define HbMath_S32x4_SignBits(v) _mm_movemask_ps(_mm_castsi128_ps(v))
+#define HbMath_U32x4_SignBits HbMath_S32x4_SignBits
 
 #define HbMath_F32x4_And _mm_and_ps
 #define HbMath_S32x4_And _mm_and_si128
@@ -165,6 +186,10 @@ HbForceInline HbMath_F32x4 HbMath_F32x4_RotateWXYZ(HbMath_F32x4 v) { return _mm_
 #define HbMath_F32x4_Xor _mm_xor_ps
 #define HbMath_S32x4_Xor _mm_xor_si128
 #define HbMath_U32x4_Xor HbMath_S32x4_Xor
+#define HbMath_S32x4_ShiftLeft _mm_slli_epi32
+#define HbMath_U32x4_ShiftLeft HbMath_S32x4_ShiftLeft
+#define HbMath_S32x4_ShiftRight _mm_srai_epi32 // Arithmetic.
+#define HbMath_U32x4_ShiftRight _mm_srli_epi32
 HbForceInline HbMath_F32x4 HbMath_F32x4_Select(HbMath_F32x4 mask, HbMath_F32x4 a, HbMath_F32x4 b) {
 	return HbMath_F32x4_Or(HbMath_F32x4_And(a, mask), HbMath_F32x4_AndNot(b, mask));
 }
@@ -172,6 +197,11 @@ HbForceInline HbMath_S32x4 HbMath_S32x4_Select(HbMath_S32x4 mask, HbMath_S32x4 a
 	return HbMath_S32x4_Or(HbMath_S32x4_And(a, mask), HbMath_S32x4_AndNot(b, mask));
 }
 #define HbMath_U32x4_Select HbMath_S32x4_Select
+// No unsigned comparison in SSE2, flipping the sign bit maps unsigned order to signed.
+HbForceInline HbMath_U32x4 HbMath_U32x4_CompareGreater(HbMath_U32x4 a, HbMath_U32x4 b) {
+	HbMath_U32x4 signBit = HbMath_U32x4_LoadReplicated(0x80000000u);
+	return HbMath_S32x4_CompareGreater(HbMath_U32x4_Xor(a, signBit), HbMath_U32x4_Xor(b, signBit));
+}
 
 #define HbMath_F32x4_Add _mm_add_ps
 #define HbMath_S32x4_Add _mm_add_epi32
@@ -211,6 +241,73 @@ HbForceInline HbMath_F32x4 HbMath_F32x4_Cross(HbMath_F32x4 a, HbMath_F32x4 b) {
 			HbMath_F32x4_Multiply(_mm_shuffle_ps(a, a, _MM_SHUFFLE(3, 1, 0, 2)), _mm_shuffle_ps(b, b, _MM_SHUFFLE(3, 0, 2, 1))));
 }
 
+// 8-bit lanes, mostly for scanning text.
+typedef __m128i HbMath_U8x16;
+#define HbMath_U8x16_LoadZero _mm_setzero_si128
+#define HbMath_U8x16_LoadAligned _mm_load_si128
+#define HbMath_U8x16_LoadUnaligned _mm_loadu_si128
+#define HbMath_U8x16_LoadReplicated(value) _mm_set1_epi8((char) (value))
+// Load 4 or 8 bytes from any address to the lower bytes, zeroing the rest.
+HbForceInline HbMath_U8x16 HbMath_U8x16_LoadLower32(void const * address) { int32_t v; memcpy(&v, address, sizeof(v)); return _mm_cvtsi32_si128(v); }
+#define HbMath_U8x16_LoadLower64(address) _mm_loadl_epi64((__m128i const *) (address))
+#define HbMath_U8x16_StoreUnaligned _mm_storeu_si128
+// Stores the lower 8 bytes.
+#define HbMath_U8x16_StoreLower64(address, v) _mm_storel_epi64((__m128i *) (address), v)
+// Bypassing the cache, for write-combined memory like GPU upload buffers. The address must be 16-aligned.
+#define HbMath_U8x16_StoreAlignedNonTemporal(address, v) _mm_stream_si128((__m128i *) (address), v)
+// Must be done after non-temporal stores before the data is used by other threads or devices.
+#define HbMath_NonTemporalStoreFence _mm_sfence
+#define HbMath_U8x16_CompareEqual _mm_cmpeq_epi8
+// Bytes 0x80 and above are treated as negative, so they are less than any ASCII character.
+#define HbMath_U8x16_CompareLessSigned _mm_cmplt_epi8
+// Bit N is the highest bit of byte N.
+#define HbMath_U8x16_SignBits _mm_movemask_epi8
+#define HbMath_U8x16_And _mm_and_si128
+#define HbMath_U8x16_Or _mm_or_si128
+#define HbMath_U8x16_Xor _mm_xor_si128
+#define HbMath_U8x16_Add _mm_add_epi8
+#define HbMath_U8x16_Subtract _mm_sub_epi8
+#define HbMath_U8x16_Min _mm_min_epu8
+// Moves the bytes to higher lanes (byteCount must be a constant), filling the lower ones with zeros.
+#define HbMath_U8x16_ShiftLanesUp _mm_slli_si128
+// Bytes 0-7 or 8-15 of a and b interleaved as a0, b0, a1, b1... - zero-extends to 16 bits with zero b.
+#define HbMath_U8x16_InterleaveLower _mm_unpacklo_epi8
+#define HbMath_U8x16_InterleaveUpper _mm_unpackhi_epi8
+// Unsigned a <= b via the minimum, as there's no unsigned comparison in SSE2.
+#define HbMath_U8x16_CompareLessEqual(a, b) HbMath_U8x16_CompareEqual(HbMath_U8x16_Min(a, b), a)
+
+// 16-bit lanes, mostly for UTF-16 text.
+typedef __m128i HbMath_U16x8;
+#define HbMath_U16x8_LoadZero _mm_setzero_si128
+#define HbMath_U16x8_LoadUnaligned _mm_loadu_si128
+#define HbMath_U16x8_LoadReplicated(value) _mm_set1_epi16((short) (value))
+#define HbMath_U16x8_StoreUnaligned _mm_storeu_si128
+#define HbMath_U16x8_CompareEqual _mm_cmpeq_epi16
+#define HbMath_U16x8_And _mm_and_si128
+#define HbMath_U16x8_Or _mm_or_si128
+#define HbMath_U16x8_Xor _mm_xor_si128
+#define HbMath_U16x8_Add _mm_add_epi16
+#define HbMath_U16x8_Subtract _mm_sub_epi16
+// The lower 16 bits of the products.
+#define HbMath_U16x8_MultiplyLow _mm_mullo_epi16
+#define HbMath_U16x8_ShiftLeft _mm_slli_epi16
+#define HbMath_U16x8_ShiftRight _mm_srli_epi16
+// Lanes 0-3 or 4-7 of a and b interleaved - zero-extends to 32 bits with zero b.
+#define HbMath_U16x8_InterleaveLower _mm_unpacklo_epi16
+#define HbMath_U16x8_InterleaveUpper _mm_unpackhi_epi16
+// Comparisons of the lanes as signed.
+#define HbMath_S16x8_Max _mm_max_epi16
+#define HbMath_S16x8_CompareLess _mm_cmplt_epi16
+// Sums of the products of the pairs of signed lanes - a0 * b0 + a1 * b1, a2 * b2 + a3 * b3... in 32-bit lanes.
+#define HbMath_S16x8_MultiplyAddPairs _mm_madd_epi16
+HbForceInline HbMath_U16x8 HbMath_U16x8_SwapBytes(HbMath_U16x8 v) { return HbMath_U16x8_Or(HbMath_U16x8_ShiftLeft(v, 8), HbMath_U16x8_ShiftRight(v, 8)); }
+// Lanes 0-7 from a, 8-15 from b, with values above 0xFF (as signed) saturated.
+#define HbMath_U16x8_PackToU8x16 _mm_packus_epi16
+// Lanes 0-3 from a, 4-7 from b, saturated to the signed 16-bit range.
+#define HbMath_S32x4_PackToS16x8 _mm_packs_epi32
+// Lanes 0-7 from a, 8-15 from b, saturated to the signed 8-bit range.
+#define HbMath_S16x8_PackToS8x16 _mm_packs_epi16
+
 #else
 #error No HbMath vector intrinsics for the target platform.
 #endif
@@ -228,6 +325,30 @@ HbForceInline HbMath_F32x4 HbMath_F32x4_RoundToNearest(HbMath_F32x4 v) {
 	return HbMath_F32x4_Add(truncated, HbMath_S32x4_ConvertToF32x4(HbMath_F32x4_ConvertToS32x4(HbMath_F32x4_Add(fractional, fractional))));
 }
 
+// Rounds to nearest even, with values too large for half precision converted to infinity.
+// Returns the halves in the lower 16 bits of the lanes, sign-extended so they can be packed with HbMath_S32x4_PackToS16x8.
+// Based on the SSE2 method by Fabian Giesen (public domain).
+HbForceInline HbMath_S32x4 HbMath_F32x4_ConvertToF16x4(HbMath_F32x4 v) {
+	HbMath_S32x4 bits = HbMath_F32x4_BitsAsS32x4(v);
+	HbMath_S32x4 sign = HbMath_S32x4_And(bits, HbMath_S32x4_LoadReplicated(INT32_MIN));
+	HbMath_S32x4 absolute = HbMath_S32x4_Xor(bits, sign);
+	// Subnormal halves - the FPU rounds the mantissa when it's shifted to the lower bits by adding a power of 2.
+	HbMath_S32x4 subnormalMagic = HbMath_S32x4_LoadReplicated(((127 - 15) + (23 - 10) + 1) << 23);
+	HbMath_S32x4 subnormal = HbMath_S32x4_Subtract(HbMath_F32x4_BitsAsS32x4(HbMath_F32x4_Add(
+			HbMath_S32x4_BitsAsF32x4(absolute), HbMath_S32x4_BitsAsF32x4(subnormalMagic))), subnormalMagic);
+	// Normal halves - rebiasing the exponent and rounding the mantissa, with an extra 1 for ties if the result is odd.
+	HbMath_S32x4 mantissaOdd = HbMath_S32x4_ShiftRight(HbMath_S32x4_ShiftLeft(absolute, 31 - 13), 31);
+	HbMath_S32x4 normal = HbMath_U32x4_ShiftRight(HbMath_S32x4_Subtract(
+			HbMath_S32x4_Add(absolute, HbMath_S32x4_LoadReplicated(0xFFF - ((127 - 15) << 23))), mantissaOdd), 13);
+	HbMath_S32x4 result = HbMath_S32x4_Select(
+			HbMath_S32x4_CompareGreater(HbMath_S32x4_LoadReplicated((127 - 14) << 23), absolute), subnormal, normal);
+	// Infinity for values from 65536, quiet NaN for NaN.
+	HbMath_S32x4 special = HbMath_S32x4_Or(HbMath_S32x4_LoadReplicated(0x7C00), HbMath_S32x4_And(
+			HbMath_S32x4_CompareGreater(absolute, HbMath_S32x4_LoadReplicated(0x7F800000)), HbMath_S32x4_LoadReplicated(0x200)));
+	result = HbMath_S32x4_Select(HbMath_S32x4_CompareGreater(HbMath_S32x4_LoadReplicated((127 + 16) << 23), absolute), result, special);
+	return HbMath_S32x4_Or(result, HbMath_S32x4_ShiftRight(sign, 16));
+}
+
 /***************
  * Trigonometry
  ***************/
@@ -1,7 +1,7 @@
 #include "HbBit.h"
 #include "HbFeedback.h"
 #include "HbMemory.h"
-#include "HbText.h"
+#include "HbText_Intern.h"
 
 /***************************************
  * Tag-based memory allocation tracking
@@ -25,17 +25,30 @@ void HbMemory_Shutdown() {
 }
 
 HbMemory_Tag * HbMemory_Tag_Create(char const * name) {
-	HbMemory_Tag * tag = malloc(sizeof(HbMemory_Tag));
+	if (name == NULL) {
+		name = "";
+	}
+	uint32_t nameID = HbText_Intern_InvalidID;
+	size_t nameSize = 0;
+	if (HbText_Intern_GlobalInitialized) {
+		nameID = HbText_Intern_AddA(&HbText_Intern_Global, name);
+	}
+	if (nameID == HbText_Intern_InvalidID) {
+		nameSize = HbTextA_Length(name) + 1;
+	}
+	HbMemory_Tag * tag = malloc(sizeof(HbMemory_Tag) + nameSize);
 	if (tag == NULL) {
 		HbFeedback_Crash("HbMemory_Tag_Create", "Failed to allocate memory for a tag.");
 	}
 	if (!HbParallel_Mutex_Init(&tag->mutex)) {
 		HbFeedback_Crash("HbMemory_Tag_Create", "Failed to initialize the mutex for a tag.");
 	}
-	if (name != NULL) {
-		HbTextA_Copy(tag->name, HbArrayLength(tag->name), name);
+	tag->nameID = nameID;
+	if (nameID != HbText_Intern_InvalidID) {
+		tag->name = HbText_Intern_GetText(&HbText_Intern_Global, nameID);
 	} else {
-		tag->name[0] = '\0';
+		memcpy(tag + 1, name, nameSize);
+		tag->name = (char const *) (tag + 1);
 	}
 	tag->allocationFirst = tag->allocationLast = NULL;
 	tag->totalAllocatedSize = 0;
@@ -332,7 +345,7 @@ void HbMemory_Array2L_ReservePiecePointers(HbMemory_Array2L * array2L, size_t el
 		memcpy(pieces, array2L->pieces.few, pieceCountOld * sizeof(void * *));
 		array2L->pieces.many = pieces;
 	} else {
-		HbMemory_DoRealloc(&((void *) array2L->pieces.many), pieceCount * sizeof(void * *), array2L->fileName, array2L->fileLine, HbTrue);
+		HbMemory_DoRealloc((void * *) &array2L->pieces.many, pieceCount * sizeof(void * *), array2L->fileName, array2L->fileLine, HbTrue);
 	}
 	memset(array2L->pieces.many + pieceCountOld, 0, (pieceCount - pieceCountOld) * sizeof(void * *));
 	array2L->pieceCountLog2 = pieceCountLog2;
@@ -35,7 +35,9 @@ typedef struct HbAligned(16) HbMemoryi_Allocation {
 } HbMemoryi_Allocation;
 
 typedef struct HbMemory_Tag {
-	char name[64];
+	// Interned in HbText_Intern_Global if the tag is created when it's initialized, otherwise stored after the tag structure.
+	char const * name;
+	uint32_t nameID; // In HbText_Intern_Global, or HbText_Intern_InvalidID if not interned.
 	HbParallel_Mutex mutex;
 	HbMemoryi_Allocation * allocationFirst, * allocationLast; // Protected by the mutex.
 	size_t totalAllocatedSize; // Protected by the mutex.
@@ -91,7 +93,7 @@ void HbMemory_Array2L_Destroy(HbMemory_Array2L * array2L);
 void HbMemory_Array2L_ReservePiecePointers(HbMemory_Array2L * array2L, size_t elementCount);
 void HbMemory_Array2L_Resize(HbMemory_Array2L * array2L, size_t elementCount, HbBool onlyReserveMemory);
 HbForceInline void const * const * HbMemory_Array2L_GetPiecesC(HbMemory_Array2L const * array2L) {
-	return array2L->pieceCountLog2 <= HbMemory_Array2L_PieceCountFewLog2 ? array2L->pieces.few : array2L->pieces.many;
+	return (void const * const *) (array2L->pieceCountLog2 <= HbMemory_Array2L_PieceCountFewLog2 ? array2L->pieces.few : array2L->pieces.many);
 }
 HbForceInline void * * HbMemory_Array2L_GetPieces(HbMemory_Array2L * array2L) {
 	return (void * *) HbMemory_Array2L_GetPiecesC((HbMemory_Array2L const *) array2L);
@@ -0,0 +1,172 @@
+#ifndef HbInclude_HbMesh
+#define HbInclude_HbMesh
+#include "HbFile_IQM.h"
+#include "HbMemory.h"
+#include "HbMesh_Geometry.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Mesh processing depending on the engine - simplification, levels of detail and compression of IQM meshes,
+ * in addition to the OS-independent processing in HbMesh_Geometry.h, with the same conventions for indexes and positions.
+ * Temporary arrays are allocated from tag.
+ */
+
+/*****************
+ * Simplification
+ *****************/
+
+// Vertex data considered in simplification. Attributes are attributeCount floats at attributes + vertex index * attributeStride,
+// multiplied by the weights, and their errors are added to the position errors in units of the extent of the mesh
+// (the largest side of its bounding box), so a weight of 1 makes a change of 1 in the attribute as bad as moving by the extent.
+#define HbMesh_Simplify_MaxAttributes 16
+typedef struct HbMesh_Simplify_Vertexes {
+	float const * positions;
+	size_t positionStride;
+	float const * attributes;
+	size_t attributeStride;
+	float const * attributeWeights;
+	uint32_t attributeCount;
+	uint32_t vertexCount;
+} HbMesh_Simplify_Vertexes;
+
+// Collapses edges into one of their vertexes, so only the indexes are changed, in the order of the quadric error
+// (Garland, Heckbert, "Surface Simplification Using Quadric Error Metrics") including the attributes
+// (Hoppe, "New Quadric Metric for Simplifying Meshes with Appearance Attributes").
+// Vertexes at the same position with different attributes form seams, which, like open borders, are only collapsed along themselves,
+// and vertexes where that's not possible (corners of seams and borders, non-manifold topology) are kept.
+// Stops at targetTriangleCount or before the geometric error (in the model space) would exceed maxError. target may be the same as indexes.
+// Returns the triangle count, and, if the pointers are not NULL, the largest quadric errors of the collapses that were done:
+// - Geometric - the root mean square (weighted by the areas) of the distances from the new position of a vertex to the planes
+//   of the triangles merged into it. This is an estimate, not a bound - on curved surfaces, it's usually a few times larger
+//   than the actual deviation, as the planes far from the vertex are included.
+// - Attribute - the root mean square of the length of the change of the weighted attributes across those triangles.
+uint32_t HbMesh_Simplify(uint32_t const * indexes, uint32_t triangleCount, HbMesh_Simplify_Vertexes const * vertexes,
+		uint32_t targetTriangleCount, float maxError, uint32_t * target, float * geometricError, float * attributeError, HbMemory_Tag * tag);
+
+/*******************
+ * Levels of detail
+ *******************/
+
+typedef struct HbMesh_LOD_Level {
+	uint32_t triangleFirst; // In the index array of the levels, 3 indexes per triangle.
+	uint32_t triangleCount;
+	// Quadric errors (see HbMesh_Simplify) of the levels up to this one summed, as each is simplified from the previous one.
+	float geometricError; // In the model space.
+	float attributeError; // Of the weighted attributes.
+} HbMesh_LOD_Level;
+
+// Simplifies every level from the previous one to about levelTriangleRatio of its triangles, until there are maxLevelCount levels,
+// the geometric error reaches maxError, or a level can't be simplified to less than HbMesh_LOD_MaxLevelTriangleRatio of the previous one.
+// The original mesh is not included. levelIndexes must have space for 3 * triangleCount * maxLevelCount indexes.
+// Returns the number of levels.
+#define HbMesh_LOD_MaxLevelTriangleRatio 0.95f
+uint32_t HbMesh_LOD_BuildChain(uint32_t const * indexes, uint32_t triangleCount, HbMesh_Simplify_Vertexes const * vertexes,
+		uint32_t maxLevelCount, float levelTriangleRatio, float maxError, HbMesh_LOD_Level * levels, uint32_t * levelIndexes,
+		HbMemory_Tag * tag);
+// Returns 0 for the original mesh or 1 + the index of the coarsest level with the geometric error projected to the screen within maxPixelError.
+// distance - from the camera to the nearest point of the bounds of the mesh in the model space.
+// projectionScale - viewport height / (2 * tan(vertical field of view / 2)) in the model space units.
+uint32_t HbMesh_LOD_Select(HbMesh_LOD_Level const * levels, uint32_t levelCount, float distance, float projectionScale, float maxPixelError);
+
+// Levels stored in an IQM extension, for all meshes of the model, with 4-aligned data containing:
+// - HbMesh_LOD_IQM_Header.
+// - HbMesh_LOD_IQM_Mesh for every mesh.
+// - HbMesh_LOD_Level of all meshes.
+// - 3 * triangleCount indexes of the vertexes of the IQM model (like HbFile_IQM_TriangleIndex) - of the mesh for each level.
+#define HbMesh_LOD_IQM_ExtensionName "HbMesh_LOD"
+typedef struct HbMesh_LOD_IQM_Header {
+	uint32_t meshCount;
+	uint32_t levelCount;
+	uint32_t triangleCount;
+} HbMesh_LOD_IQM_Header;
+typedef struct HbMesh_LOD_IQM_Mesh {
+	uint32_t levelFirst;
+	uint32_t levelCount;
+} HbMesh_LOD_IQM_Mesh;
+typedef struct HbMesh_LOD_IQM {
+	HbMesh_LOD_IQM_Mesh const * meshes;
+	HbMesh_LOD_Level const * levels;
+	HbFile_IQM_TriangleIndex const * triangles;
+} HbMesh_LOD_IQM;
+// Returns HbFalse if the model doesn't have valid levels - the ranges and the indexes are validated.
+HbBool HbMesh_LOD_IQM_Init(HbMesh_LOD_IQM * lods, HbFile_IQM_Model const * model);
+// Builds the levels of all meshes from the positions and, with the weights, normals and texture coordinates, and returns a copy of the IQM file
+// (allocated from tag, iqmSize bytes) with the extension added before the existing ones, so it's found before levels built earlier.
+void * HbMesh_LOD_IQM_Write(HbFile_IQM_Model const * model, uint32_t maxLevelCount, float levelTriangleRatio, float maxError,
+		float normalWeight, float texCoordWeight, HbMemory_Tag * tag, uint32_t * iqmSize);
+
+/**************
+ * Compression
+ **************/
+
+// Vertexes of up to HbMesh_Codec_MaxVertexSizeInDwords are encoded in groups of HbMesh_Codec_GroupVertexCount, as differences of every byte
+// from the same byte of the previous vertex, with the bits used per byte in every group (0, 2, 4 or 8) chosen for the largest difference.
+// This is lossless, and quantizing vertexes, sorting them in the order of use (HbMesh_OptimizeVertexFetch) and keeping attributes that change
+// together in the same dwords makes the differences smaller. Decoding is done with SIMD, in blocks that are written to the target sequentially,
+// with non-temporal stores if the target is 16-aligned and the vertex size is a multiple of 16 bytes, so it can be an upload buffer mapping.
+#define HbMesh_Codec_MaxVertexSizeInDwords 16
+#define HbMesh_Codec_GroupVertexCount 16
+HbForceInline size_t HbMesh_Codec_GetVertexesMaxEncodedSize(uint32_t vertexCount, uint32_t vertexSizeInDwords) {
+	// A header byte and up to 4 bytes for each byte of every dword.
+	return (size_t) ((vertexCount + (HbMesh_Codec_GroupVertexCount - 1)) / HbMesh_Codec_GroupVertexCount) * vertexSizeInDwords *
+			(1 + 4 * HbMesh_Codec_GroupVertexCount);
+}
+// Returns the size of the encoded data.
+size_t HbMesh_Codec_EncodeVertexes(void const * vertexes, uint32_t vertexCount, uint32_t vertexSizeInDwords, void * target);
+// Returns HbFalse if the data is not valid or not of exactly dataSize bytes, in this case the target may be partially written.
+HbBool HbMesh_Codec_DecodeVertexes(void const * data, size_t dataSize, uint32_t vertexCount, uint32_t vertexSizeInDwords, void * target);
+
+// Indexes of up to 0x10000 vertexes (to be decoded as HbGPU_Vertex_Index) are encoded as variable-length differences from the next vertex
+// not used yet, so for vertexes in the order of use, new vertexes take 1 byte, as well as ones used recently.
+HbForceInline size_t HbMesh_Codec_GetIndexesMaxEncodedSize(uint32_t triangleCount) { return (size_t) 9 * triangleCount; }
+size_t HbMesh_Codec_EncodeIndexes(uint32_t const * indexes, uint32_t triangleCount, uint32_t vertexCount, void * target);
+// Returns HbFalse if the data is not valid, not of exactly dataSize bytes, or has indexes not less than vertexCount.
+HbBool HbMesh_Codec_DecodeIndexes(void const * data, size_t dataSize, uint32_t triangleCount, uint32_t vertexCount,
+		HbGPU_Vertex_Index * target);
+
+// IQM meshes with positions quantized within bounds shared by the meshes of the model (so vertexes at the same positions stay there),
+// octahedral normals, and texture coordinates quantized within their range in every mesh.
+typedef struct HbMesh_Codec_Vertex {
+	uint16_t position[4]; // UNorm16, W is 0.
+	int16_t normal[2]; // Octahedral SNorm16.
+	uint16_t texCoord[2]; // UNorm16.
+} HbMesh_Codec_Vertex;
+#define HbMesh_Codec_Vertex_SizeInDwords (sizeof(HbMesh_Codec_Vertex) / sizeof(uint32_t))
+#define HbMesh_Codec_Vertex_AttributeCount 3
+extern HbGPU_Vertex_Attribute const HbMesh_Codec_Vertex_Attributes[HbMesh_Codec_Vertex_AttributeCount]; // In stream 0.
+// Value = offset + scale * normalized value, for the shaders.
+typedef struct HbMesh_Codec_Dequantization {
+	float positionOffset[3], positionScale[3];
+	float texCoordOffset[2], texCoordScale[2];
+} HbMesh_Codec_Dequantization;
+// 4-aligned, followed by vertexDataSize bytes of vertexes and indexDataSize bytes of indexes relative to the first vertex of the mesh.
+typedef struct HbMesh_Codec_Mesh_Header {
+	uint32_t vertexCount;
+	uint32_t triangleCount;
+	uint32_t vertexDataSize;
+	uint32_t indexDataSize;
+	HbMesh_Codec_Dequantization dequantization;
+} HbMesh_Codec_Mesh_Header;
+typedef struct HbMesh_Codec_Mesh {
+	HbMesh_Codec_Mesh_Header const * header;
+	void const * vertexData;
+	void const * indexData;
+} HbMesh_Codec_Mesh;
+// Bounds of the positions of all vertexes of the model, for quantizing all its meshes.
+void HbMesh_Codec_IQM_GetBounds(HbFile_IQM_Model const * model, HbFile_IQM_Bounds * bounds);
+// Returns the encoded mesh (allocated from tag) of dataSize bytes, or NULL if it has more than 0x10000 vertexes or indexes outside it.
+// Positions outside the bounds are clamped.
+void * HbMesh_Codec_IQM_EncodeMesh(HbFile_IQM_Model const * model, uint32_t meshIndex, HbFile_IQM_Bounds const * bounds,
+		HbMemory_Tag * tag, uint32_t * dataSize);
+// data must be 4-aligned. Validates the header and the sizes, the encoded data itself is validated while decoding.
+HbBool HbMesh_Codec_Mesh_Init(HbMesh_Codec_Mesh * mesh, void const * data, size_t dataSize);
+// For uploading with HbLoad_GPUCopier, the vertexes can be decoded to the beginning of the buffer mapping and the indexes after them
+// (vertexCount * sizeof(HbMesh_Codec_Vertex) + 3 * triangleCount * sizeof(HbGPU_Vertex_Index) bytes).
+HbBool HbMesh_Codec_Mesh_Decode(HbMesh_Codec_Mesh const * mesh, HbMesh_Codec_Vertex * vertexTarget, HbGPU_Vertex_Index * indexTarget);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
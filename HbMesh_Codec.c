@@ -0,0 +1,475 @@
+#include "HbMesh.h"
+#include "HbBit.h"
+#include "HbFeedback.h"
+#include "HbMath.h"
+#include <math.h>
+#include <stddef.h>
+
+/***********
+ * Vertexes
+ ***********/
+
+// Every dword of every group is stored as a header byte with 2-bit modes of its bytes, and the differences of every byte
+// (zigzag-encoded so small negative differences are small too) for the vertexes of the group, packed according to the modes:
+// 0 - all are zero, 1 - 2 bits (4 in every byte from the low bits), 2 - 4 bits (2 in every byte), 3 - 8 bits.
+// Vertexes after the end of the last group are encoded as copies of the last vertex.
+
+HbForceInline size_t HbMeshi_Codec_GetPlaneSize(uint32_t mode) {
+	return mode != 0 ? (size_t) 2 << mode : 0;
+}
+
+size_t HbMesh_Codec_EncodeVertexes(void const * vertexes, uint32_t vertexCount, uint32_t vertexSizeInDwords, void * target) {
+	if (vertexSizeInDwords == 0 || vertexSizeInDwords > HbMesh_Codec_MaxVertexSizeInDwords) {
+		HbFeedback_Crash("HbMesh_Codec_EncodeVertexes", "Vertex size is %u dwords, but 1 to %u are supported.",
+				vertexSizeInDwords, HbMesh_Codec_MaxVertexSizeInDwords);
+	}
+	uint8_t const * source = (uint8_t const *) vertexes;
+	uint8_t * targetBytes = (uint8_t *) target;
+	size_t vertexSize = (size_t) vertexSizeInDwords * sizeof(uint32_t);
+	for (uint32_t groupFirst = 0; groupFirst < vertexCount; groupFirst += HbMesh_Codec_GroupVertexCount) {
+		uint32_t groupVertexCount = HbMinU32(vertexCount - groupFirst, HbMesh_Codec_GroupVertexCount);
+		uint8_t const * groupSource = source + groupFirst * vertexSize;
+		for (uint32_t dwordIndex = 0; dwordIndex < vertexSizeInDwords; ++dwordIndex) {
+			uint8_t * header = targetBytes++;
+			*header = 0;
+			for (uint32_t byteIndex = 0; byteIndex < sizeof(uint32_t); ++byteIndex) {
+				size_t byteOffset = dwordIndex * sizeof(uint32_t) + byteIndex;
+				uint8_t previous = groupFirst != 0 ? groupSource[byteOffset - vertexSize] : 0;
+				uint8_t differences[HbMesh_Codec_GroupVertexCount];
+				uint8_t maxDifference = 0;
+				for (uint32_t groupVertexIndex = 0; groupVertexIndex < HbMesh_Codec_GroupVertexCount; ++groupVertexIndex) {
+					uint8_t difference = 0;
+					if (groupVertexIndex < groupVertexCount) {
+						uint8_t value = groupSource[groupVertexIndex * vertexSize + byteOffset];
+						difference = (uint8_t) (value - previous);
+						difference = (uint8_t) ((difference << 1) ^ (uint8_t) ((int8_t) difference >> 7));
+						previous = value;
+					}
+					differences[groupVertexIndex] = difference;
+					maxDifference = (uint8_t) HbMaxU32(maxDifference, difference);
+				}
+				uint32_t mode = maxDifference == 0 ? 0 : (maxDifference < 4 ? 1 : (maxDifference < 16 ? 2 : 3));
+				*header |= (uint8_t) (mode << (2 * byteIndex));
+				size_t planeSize = HbMeshi_Codec_GetPlaneSize(mode);
+				switch (mode) {
+				case 1:
+					for (uint32_t planeByteIndex = 0; planeByteIndex < planeSize; ++planeByteIndex) {
+						uint8_t const * planeDifferences = &differences[4 * planeByteIndex];
+						targetBytes[planeByteIndex] = (uint8_t) (planeDifferences[0] | (planeDifferences[1] << 2) |
+								(planeDifferences[2] << 4) | (planeDifferences[3] << 6));
+					}
+					break;
+				case 2:
+					for (uint32_t planeByteIndex = 0; planeByteIndex < planeSize; ++planeByteIndex) {
+						targetBytes[planeByteIndex] = (uint8_t) (differences[2 * planeByteIndex] | (differences[2 * planeByteIndex + 1] << 4));
+					}
+					break;
+				case 3:
+					memcpy(targetBytes, differences, planeSize);
+					break;
+				}
+				targetBytes += planeSize;
+			}
+		}
+	}
+	return (size_t) (targetBytes - (uint8_t *) target);
+}
+
+HbForceInline HbMath_U8x16 HbMeshi_Codec_DecodePlane(uint8_t const * source, uint32_t mode) {
+	HbMath_U8x16 packed, low, high;
+	switch (mode) {
+	case 1:
+		{
+			// Spreading the 4 2-bit values of every byte to 4 consecutive bytes.
+			packed = HbMath_U8x16_LoadLower32(source);
+			HbMath_U8x16 mask = HbMath_U8x16_LoadReplicated(3);
+			low = HbMath_U8x16_InterleaveLower(HbMath_U8x16_And(packed, mask), HbMath_U8x16_And(HbMath_U16x8_ShiftRight(packed, 2), mask));
+			high = HbMath_U8x16_InterleaveLower(HbMath_U8x16_And(HbMath_U16x8_ShiftRight(packed, 4), mask),
+					HbMath_U8x16_And(HbMath_U16x8_ShiftRight(packed, 6), mask));
+			return HbMath_U16x8_InterleaveLower(low, high);
+		}
+	case 2:
+		{
+			packed = HbMath_U8x16_LoadLower64(source);
+			HbMath_U8x16 mask = HbMath_U8x16_LoadReplicated(15);
+			return HbMath_U8x16_InterleaveLower(HbMath_U8x16_And(packed, mask), HbMath_U8x16_And(HbMath_U16x8_ShiftRight(packed, 4), mask));
+		}
+	case 3:
+		return HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) source);
+	}
+	return HbMath_U8x16_LoadZero();
+}
+
+HbForceInline HbMath_U8x16 HbMeshi_Codec_DecodeZigzag(HbMath_U8x16 differences) {
+	// (difference >> 1) ^ -(difference & 1).
+	HbMath_U8x16 one = HbMath_U8x16_LoadReplicated(1);
+	return HbMath_U8x16_Xor(HbMath_U8x16_And(HbMath_U16x8_ShiftRight(differences, 1), HbMath_U8x16_LoadReplicated(0x7F)),
+			HbMath_U8x16_Subtract(HbMath_U8x16_LoadZero(), HbMath_U8x16_And(differences, one)));
+}
+
+HbBool HbMesh_Codec_DecodeVertexes(void const * data, size_t dataSize, uint32_t vertexCount, uint32_t vertexSizeInDwords, void * target) {
+	if (vertexSizeInDwords == 0 || vertexSizeInDwords > HbMesh_Codec_MaxVertexSizeInDwords) {
+		return HbFalse;
+	}
+	uint8_t const * source = (uint8_t const *) data, * sourceEnd = source + dataSize;
+	uint8_t * targetBytes = (uint8_t *) target;
+	size_t vertexSize = (size_t) vertexSizeInDwords * sizeof(uint32_t);
+	// The group is decoded to dwords of all vertexes, then transposed 4x4 dwords at once to vertexes padded to 16 bytes.
+	uint32_t rowSizeInDwords = HbAlignU32(vertexSizeInDwords, 4);
+	HbMath_VecAligned uint32_t columns[HbMesh_Codec_MaxVertexSizeInDwords][HbMesh_Codec_GroupVertexCount];
+	HbMath_VecAligned uint32_t rows[HbMesh_Codec_GroupVertexCount * HbMesh_Codec_MaxVertexSizeInDwords];
+	memset(columns[vertexSizeInDwords], 0, (rowSizeInDwords - vertexSizeInDwords) * sizeof(columns[0]));
+	// The dwords of the previous vertex, replicated.
+	HbMath_U8x16 previousDwords[HbMesh_Codec_MaxVertexSizeInDwords];
+	for (uint32_t dwordIndex = 0; dwordIndex < vertexSizeInDwords; ++dwordIndex) {
+		previousDwords[dwordIndex] = HbMath_U8x16_LoadZero();
+	}
+	// Upload buffers are write-combined, so whole groups are written to them bypassing the cache if possible.
+	HbBool groupsContiguous = rowSizeInDwords == vertexSizeInDwords;
+	HbBool storeNonTemporal = groupsContiguous && ((uintptr_t) target & 15) == 0;
+
+	for (uint32_t groupFirst = 0; groupFirst < vertexCount; groupFirst += HbMesh_Codec_GroupVertexCount) {
+		for (uint32_t dwordIndex = 0; dwordIndex < vertexSizeInDwords; ++dwordIndex) {
+			if (source == sourceEnd) {
+				return HbFalse;
+			}
+			uint32_t header = *(source++);
+			uint32_t modes[4];
+			size_t columnSize = 0;
+			for (uint32_t byteIndex = 0; byteIndex < 4; ++byteIndex) {
+				modes[byteIndex] = (header >> (2 * byteIndex)) & 3;
+				columnSize += HbMeshi_Codec_GetPlaneSize(modes[byteIndex]);
+			}
+			if ((size_t) (sourceEnd - source) < columnSize) {
+				return HbFalse;
+			}
+			// Planes of bytes 0-3 of the dword of vertexes 0-15.
+			HbMath_U8x16 planes[4];
+			for (uint32_t byteIndex = 0; byteIndex < 4; ++byteIndex) {
+				planes[byteIndex] = HbMeshi_Codec_DecodeZigzag(HbMeshi_Codec_DecodePlane(source, modes[byteIndex]));
+				source += HbMeshi_Codec_GetPlaneSize(modes[byteIndex]);
+			}
+			HbMath_U8x16 bytes01Lower = HbMath_U8x16_InterleaveLower(planes[0], planes[1]);
+			HbMath_U8x16 bytes01Upper = HbMath_U8x16_InterleaveUpper(planes[0], planes[1]);
+			HbMath_U8x16 bytes23Lower = HbMath_U8x16_InterleaveLower(planes[2], planes[3]);
+			HbMath_U8x16 bytes23Upper = HbMath_U8x16_InterleaveUpper(planes[2], planes[3]);
+			HbMath_U8x16 dwords[4] = {
+				HbMath_U16x8_InterleaveLower(bytes01Lower, bytes23Lower),
+				HbMath_U16x8_InterleaveUpper(bytes01Lower, bytes23Lower),
+				HbMath_U16x8_InterleaveLower(bytes01Upper, bytes23Upper),
+				HbMath_U16x8_InterleaveUpper(bytes01Upper, bytes23Upper),
+			};
+			// Prefix sum of the differences of the bytes across the vertexes.
+			HbMath_U8x16 previous = previousDwords[dwordIndex];
+			for (uint32_t quadIndex = 0; quadIndex < 4; ++quadIndex) {
+				HbMath_U8x16 quad = dwords[quadIndex];
+				quad = HbMath_U8x16_Add(quad, HbMath_U8x16_ShiftLanesUp(quad, 4));
+				quad = HbMath_U8x16_Add(quad, HbMath_U8x16_ShiftLanesUp(quad, 8));
+				quad = HbMath_U8x16_Add(quad, previous);
+				previous = HbMath_U32x4_ReplicateW(quad);
+				HbMath_U32x4_StoreAligned((HbMath_U32x4 *) &columns[dwordIndex][4 * quadIndex], quad);
+			}
+			previousDwords[dwordIndex] = previous;
+		}
+
+		for (uint32_t dwordIndex = 0; dwordIndex < rowSizeInDwords; dwordIndex += 4) {
+			for (uint32_t quadIndex = 0; quadIndex < 4; ++quadIndex) {
+				HbMath_U32x4 column0 = HbMath_U32x4_LoadAligned((HbMath_U32x4 const *) &columns[dwordIndex][4 * quadIndex]);
+				HbMath_U32x4 column1 = HbMath_U32x4_LoadAligned((HbMath_U32x4 const *) &columns[dwordIndex + 1][4 * quadIndex]);
+				HbMath_U32x4 column2 = HbMath_U32x4_LoadAligned((HbMath_U32x4 const *) &columns[dwordIndex + 2][4 * quadIndex]);
+				HbMath_U32x4 column3 = HbMath_U32x4_LoadAligned((HbMath_U32x4 const *) &columns[dwordIndex + 3][4 * quadIndex]);
+				HbMath_U32x4 columns01XY = HbMath_U32x4_InterleaveXY(column0, column1);
+				HbMath_U32x4 columns01ZW = HbMath_U32x4_InterleaveZW(column0, column1);
+				HbMath_U32x4 columns23XY = HbMath_U32x4_InterleaveXY(column2, column3);
+				HbMath_U32x4 columns23ZW = HbMath_U32x4_InterleaveZW(column2, column3);
+				uint32_t * quadRows = &rows[4 * quadIndex * rowSizeInDwords + dwordIndex];
+				HbMath_U32x4_StoreAligned((HbMath_U32x4 *) quadRows, HbMath_U32x4_CombineXYXY(columns01XY, columns23XY));
+				HbMath_U32x4_StoreAligned((HbMath_U32x4 *) (quadRows + rowSizeInDwords), HbMath_U32x4_CombineZWZW(columns01XY, columns23XY));
+				HbMath_U32x4_StoreAligned((HbMath_U32x4 *) (quadRows + 2 * rowSizeInDwords), HbMath_U32x4_CombineXYXY(columns01ZW, columns23ZW));
+				HbMath_U32x4_StoreAligned((HbMath_U32x4 *) (quadRows + 3 * rowSizeInDwords), HbMath_U32x4_CombineZWZW(columns01ZW, columns23ZW));
+			}
+		}
+
+		uint32_t groupVertexCount = HbMinU32(vertexCount - groupFirst, HbMesh_Codec_GroupVertexCount);
+		if (groupsContiguous) {
+			size_t groupSize = groupVertexCount * vertexSize;
+			if (storeNonTemporal) {
+				for (size_t offset = 0; offset < groupSize; offset += 16) {
+					HbMath_U8x16_StoreAlignedNonTemporal(targetBytes + offset,
+							HbMath_U8x16_LoadAligned((HbMath_U8x16 const *) ((uint8_t const *) rows + offset)));
+				}
+			} else {
+				memcpy(targetBytes, rows, groupSize);
+			}
+			targetBytes += groupSize;
+		} else {
+			for (uint32_t groupVertexIndex = 0; groupVertexIndex < groupVertexCount; ++groupVertexIndex) {
+				memcpy(targetBytes, &rows[groupVertexIndex * rowSizeInDwords], vertexSize);
+				targetBytes += vertexSize;
+			}
+		}
+	}
+
+	if (storeNonTemporal) {
+		HbMath_NonTemporalStoreFence();
+	}
+	return source == sourceEnd;
+}
+
+/**********
+ * Indexes
+ **********/
+
+// Every index is the zigzag-encoded difference from the next unused vertex, stored in 7-bit parts with the high bit set if more follow.
+// The next unused vertex grows by max(1 - difference, 0) after every index, so for runs of single-byte codes (new vertexes and ones
+// used recently), it's a prefix sum, and they're decoded with SIMD.
+
+size_t HbMesh_Codec_EncodeIndexes(uint32_t const * indexes, uint32_t triangleCount, uint32_t vertexCount, void * target) {
+	if (vertexCount > 0x10000) {
+		HbFeedback_Crash("HbMesh_Codec_EncodeIndexes", "%u vertexes specified, but up to 0x10000 are supported.", vertexCount);
+	}
+	uint8_t * targetBytes = (uint8_t *) target;
+	uint32_t nextVertex = 0;
+	for (uint32_t indexIndex = 0; indexIndex < 3 * triangleCount; ++indexIndex) {
+		uint32_t index = indexes[indexIndex];
+		if (index >= vertexCount) {
+			HbFeedback_Crash("HbMesh_Codec_EncodeIndexes", "Index %u is %u, but there are %u vertexes.", indexIndex, index, vertexCount);
+		}
+		int32_t difference = (int32_t) nextVertex - (int32_t) index;
+		uint32_t code = ((uint32_t) difference << 1) ^ (uint32_t) (difference >> 31);
+		for (; code >= 0x80; code >>= 7) {
+			*(targetBytes++) = (uint8_t) (code | 0x80);
+		}
+		*(targetBytes++) = (uint8_t) code;
+		nextVertex = HbMaxU32(nextVertex, index + 1);
+	}
+	return (size_t) (targetBytes - (uint8_t *) target);
+}
+
+HbBool HbMesh_Codec_DecodeIndexes(void const * data, size_t dataSize, uint32_t triangleCount, uint32_t vertexCount,
+		HbGPU_Vertex_Index * target) {
+	uint8_t const * source = (uint8_t const *) data, * sourceEnd = source + dataSize;
+	uint32_t indexCount = 3 * triangleCount, indexIndex = 0, nextVertex = 0;
+	HbMath_U16x8 const zero = HbMath_U16x8_LoadZero(), one = HbMath_U16x8_LoadReplicated(1);
+	HbMath_U16x8 const allOnes = HbMath_U16x8_LoadReplicated(0xFFFF);
+	while (indexIndex < indexCount) {
+		// Up to 8 single-byte codes - all 8 lanes are stored, but only the ones in the run are checked, and the rest are overwritten later.
+		// Checking the first byte before trying, as the SIMD setup is slower than the scalar decoding of a multi-byte code.
+		if (indexCount - indexIndex >= 8 && (size_t) (sourceEnd - source) >= 8 && source[0] < 0x80) {
+			HbMath_U8x16 codeBytes = HbMath_U8x16_LoadLower64(source);
+			uint32_t runLength = (uint32_t) HbBit_LowestOneU32((uint32_t) HbMath_U8x16_SignBits(codeBytes) | (1u << 8));
+			HbMath_U16x8 codes = HbMath_U8x16_InterleaveLower(codeBytes, zero);
+			HbMath_U16x8 differences = HbMath_U16x8_Xor(HbMath_U16x8_ShiftRight(codes, 1),
+					HbMath_U16x8_Subtract(zero, HbMath_U16x8_And(codes, one)));
+			HbMath_U16x8 increments = HbMath_S16x8_Max(HbMath_U16x8_Subtract(one, differences), zero);
+			HbMath_U16x8 sums = HbMath_U16x8_Add(increments, HbMath_U8x16_ShiftLanesUp(increments, 2));
+			sums = HbMath_U16x8_Add(sums, HbMath_U8x16_ShiftLanesUp(sums, 4));
+			sums = HbMath_U16x8_Add(sums, HbMath_U8x16_ShiftLanesUp(sums, 8));
+			// Relative to nextVertex before the run, from -63 to 7 * 65 + 64, so checked against the bounds clamped to 16 bits.
+			HbMath_U16x8 relativeIndexes = HbMath_U16x8_Subtract(HbMath_U16x8_Subtract(sums, increments), differences);
+			HbMath_U16x8 invalid = HbMath_U16x8_Or(
+					HbMath_S16x8_CompareLess(relativeIndexes, HbMath_U16x8_LoadReplicated(0 - HbMinU32(nextVertex, 0x8000))),
+					HbMath_U16x8_Xor(HbMath_S16x8_CompareLess(relativeIndexes,
+							HbMath_U16x8_LoadReplicated(HbMinU32(vertexCount - nextVertex, 0x7FFF))), allOnes));
+			if (((uint32_t) HbMath_U8x16_SignBits(invalid) & ((1u << (2 * runLength)) - 1)) != 0) {
+				return HbFalse;
+			}
+			HbMath_U16x8_StoreUnaligned((HbMath_U16x8 *) (target + indexIndex),
+					HbMath_U16x8_Add(relativeIndexes, HbMath_U16x8_LoadReplicated(nextVertex)));
+			uint16_t runSums[8];
+			HbMath_U16x8_StoreUnaligned((HbMath_U16x8 *) runSums, sums);
+			nextVertex += runSums[runLength - 1];
+			source += runLength;
+			indexIndex += runLength;
+			continue;
+		}
+		// Differences between vertexes of up to 0x10000 are encoded in up to 3 bytes.
+		uint32_t code = 0;
+		for (uint32_t shift = 0; ; shift += 7) {
+			if (source == sourceEnd || shift > 14) {
+				return HbFalse;
+			}
+			uint32_t codeByte = *(source++);
+			code |= (codeByte & 0x7F) << shift;
+			if (!(codeByte & 0x80)) {
+				break;
+			}
+		}
+		// Too large differences wrap around and are rejected by the unsigned comparison.
+		uint32_t index = nextVertex - ((code >> 1) ^ (0 - (code & 1)));
+		if (index >= vertexCount) {
+			return HbFalse;
+		}
+		target[indexIndex++] = (HbGPU_Vertex_Index) index;
+		nextVertex = HbMaxU32(nextVertex, index + 1);
+	}
+	return source == sourceEnd;
+}
+
+/*************
+ * IQM meshes
+ *************/
+
+HbGPU_Vertex_Attribute const HbMesh_Codec_Vertex_Attributes[HbMesh_Codec_Vertex_AttributeCount] = {
+	{ .semantic = HbGPU_Vertex_Semantic_Position, .format = HbGPU_Vertex_Format_UNorm_16x4,
+			.offsetInDwords = offsetof(HbMesh_Codec_Vertex, position) / sizeof(uint32_t) },
+	{ .semantic = HbGPU_Vertex_Semantic_Normal, .format = HbGPU_Vertex_Format_SNorm_16x2,
+			.offsetInDwords = offsetof(HbMesh_Codec_Vertex, normal) / sizeof(uint32_t) },
+	{ .semantic = HbGPU_Vertex_Semantic_TexCoord, .format = HbGPU_Vertex_Format_UNorm_16x2,
+			.offsetInDwords = offsetof(HbMesh_Codec_Vertex, texCoord) / sizeof(uint32_t) },
+};
+
+void HbMesh_Codec_IQM_GetBounds(HbFile_IQM_Model const * model, HbFile_IQM_Bounds * bounds) {
+	HbGPU_Vertex_Attribute const positionAttribute = { .semantic = HbGPU_Vertex_Semantic_Position, .format = HbGPU_Vertex_Format_Float_32x3 };
+	HbGPU_Vertex_Stream const positionStream = { .strideInDwords = 3 };
+	float positions[256][3];
+	float mins[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, maxs[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	float xyRadiusSquared = 0.0f, radiusSquared = 0.0f;
+	uint32_t vertexCount = model->header->vertexCount;
+	for (uint32_t vertexFirst = 0; vertexFirst < vertexCount; vertexFirst += HbArrayLength(positions)) {
+		uint32_t chunkVertexCount = HbMinU32(vertexCount - vertexFirst, HbArrayLength(positions));
+		if (!(HbFile_IQM_Model_WriteVertexes(model, vertexFirst, chunkVertexCount, &positionAttribute, 1, 0, &positionStream, positions) &
+				HbGPU_Vertex_SemanticBits_Position)) {
+			break;
+		}
+		for (uint32_t chunkVertexIndex = 0; chunkVertexIndex < chunkVertexCount; ++chunkVertexIndex) {
+			float const * position = positions[chunkVertexIndex];
+			for (uint32_t componentIndex = 0; componentIndex < 3; ++componentIndex) {
+				mins[componentIndex] = fminf(mins[componentIndex], position[componentIndex]);
+				maxs[componentIndex] = fmaxf(maxs[componentIndex], position[componentIndex]);
+			}
+			float xyLengthSquared = position[0] * position[0] + position[1] * position[1];
+			xyRadiusSquared = fmaxf(xyRadiusSquared, xyLengthSquared);
+			radiusSquared = fmaxf(radiusSquared, xyLengthSquared + position[2] * position[2]);
+		}
+	}
+	for (uint32_t componentIndex = 0; componentIndex < 3; ++componentIndex) {
+		if (mins[componentIndex] > maxs[componentIndex]) {
+			mins[componentIndex] = maxs[componentIndex] = 0.0f;
+		}
+		bounds->mins[componentIndex] = mins[componentIndex];
+		bounds->maxs[componentIndex] = maxs[componentIndex];
+	}
+	bounds->xyRadius = sqrtf(xyRadiusSquared);
+	bounds->radius = sqrtf(radiusSquared);
+}
+
+static uint16_t HbMeshi_Codec_QuantizeUNorm16(float value, float offset, float scale) {
+	return scale > 0.0f ? (uint16_t) (HbClampF((value - offset) / scale, 0.0f, 1.0f) * 65535.0f + 0.5f) : 0;
+}
+
+void * HbMesh_Codec_IQM_EncodeMesh(HbFile_IQM_Model const * model, uint32_t meshIndex, HbFile_IQM_Bounds const * bounds,
+		HbMemory_Tag * tag, uint32_t * dataSize) {
+	HbFile_IQM_Mesh const * mesh = &model->meshes[meshIndex];
+	uint32_t vertexCount = mesh->vertexCount, triangleCount = mesh->triangleCount;
+	if (vertexCount > 0x10000) {
+		return NULL;
+	}
+	uint32_t * indexes = (uint32_t *) HbMemory_Alloc(tag, HbMaxSize((size_t) 3 * triangleCount, 1) * sizeof(uint32_t), HbFalse);
+	HbFile_IQM_TriangleIndex const * meshTriangles = model->triangles + (size_t) 3 * mesh->triangleFirst;
+	for (uint32_t indexIndex = 0; indexIndex < 3 * triangleCount; ++indexIndex) {
+		indexes[indexIndex] = meshTriangles[indexIndex] - mesh->vertexFirst;
+		if (indexes[indexIndex] >= vertexCount) {
+			HbMemory_Free(indexes);
+			return NULL;
+		}
+	}
+
+	// Normals are encoded when written, positions and texture coordinates need the dequantization parameters first.
+	enum {
+		vertexPositionOffset = 0,
+		vertexNormalOffset = 3,
+		vertexTexCoordOffset = 4,
+		vertexStrideInDwords = 6,
+	};
+	HbGPU_Vertex_Attribute const vertexAttributes[] = {
+		{ .semantic = HbGPU_Vertex_Semantic_Position, .format = HbGPU_Vertex_Format_Float_32x3, .offsetInDwords = vertexPositionOffset },
+		{ .semantic = HbGPU_Vertex_Semantic_Normal, .format = HbGPU_Vertex_Format_SNorm_16x2, .offsetInDwords = vertexNormalOffset },
+		{ .semantic = HbGPU_Vertex_Semantic_TexCoord, .format = HbGPU_Vertex_Format_Float_32x2, .offsetInDwords = vertexTexCoordOffset },
+	};
+	HbGPU_Vertex_Stream const vertexStream = { .strideInDwords = vertexStrideInDwords };
+	uint32_t * vertexesInFile = (uint32_t *) HbMemory_Alloc(tag,
+			HbMaxSize(vertexCount, 1) * vertexStrideInDwords * sizeof(uint32_t), HbFalse);
+	HbGPU_Vertex_SemanticBits semanticsInFile = HbFile_IQM_Model_WriteVertexes(model, mesh->vertexFirst, vertexCount,
+			vertexAttributes, HbArrayLength(vertexAttributes), 0, &vertexStream, vertexesInFile);
+
+	HbMesh_Codec_Mesh_Header header;
+	header.vertexCount = vertexCount;
+	header.triangleCount = triangleCount;
+	HbMesh_Codec_Dequantization * dequantization = &header.dequantization;
+	for (uint32_t componentIndex = 0; componentIndex < 3; ++componentIndex) {
+		dequantization->positionOffset[componentIndex] = bounds->mins[componentIndex];
+		dequantization->positionScale[componentIndex] = fmaxf(bounds->maxs[componentIndex] - bounds->mins[componentIndex], 0.0f);
+	}
+	float texCoordMins[2] = { 0.0f, 0.0f }, texCoordMaxs[2] = { 0.0f, 0.0f };
+	if ((semanticsInFile & HbGPU_Vertex_SemanticBits_TexCoord) && vertexCount != 0) {
+		float const * texCoord = (float const *) (vertexesInFile + vertexTexCoordOffset);
+		texCoordMins[0] = texCoordMaxs[0] = texCoord[0];
+		texCoordMins[1] = texCoordMaxs[1] = texCoord[1];
+		for (uint32_t vertexIndex = 1; vertexIndex < vertexCount; ++vertexIndex) {
+			texCoord = (float const *) (vertexesInFile + vertexIndex * vertexStrideInDwords + vertexTexCoordOffset);
+			for (uint32_t componentIndex = 0; componentIndex < 2; ++componentIndex) {
+				texCoordMins[componentIndex] = fminf(texCoordMins[componentIndex], texCoord[componentIndex]);
+				texCoordMaxs[componentIndex] = fmaxf(texCoordMaxs[componentIndex], texCoord[componentIndex]);
+			}
+		}
+	}
+	for (uint32_t componentIndex = 0; componentIndex < 2; ++componentIndex) {
+		dequantization->texCoordOffset[componentIndex] = texCoordMins[componentIndex];
+		dequantization->texCoordScale[componentIndex] = texCoordMaxs[componentIndex] - texCoordMins[componentIndex];
+	}
+
+	HbMesh_Codec_Vertex * vertexes = (HbMesh_Codec_Vertex *) HbMemory_Alloc(tag,
+			HbMaxSize(vertexCount, 1) * sizeof(HbMesh_Codec_Vertex), HbFalse);
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		uint32_t const * vertexInFile = vertexesInFile + vertexIndex * vertexStrideInDwords;
+		float const * position = (float const *) (vertexInFile + vertexPositionOffset);
+		float const * texCoord = (float const *) (vertexInFile + vertexTexCoordOffset);
+		HbMesh_Codec_Vertex * vertex = &vertexes[vertexIndex];
+		for (uint32_t componentIndex = 0; componentIndex < 3; ++componentIndex) {
+			vertex->position[componentIndex] = HbMeshi_Codec_QuantizeUNorm16(position[componentIndex],
+					dequantization->positionOffset[componentIndex], dequantization->positionScale[componentIndex]);
+		}
+		vertex->position[3] = 0;
+		memcpy(vertex->normal, vertexInFile + vertexNormalOffset, sizeof(vertex->normal));
+		for (uint32_t componentIndex = 0; componentIndex < 2; ++componentIndex) {
+			vertex->texCoord[componentIndex] = HbMeshi_Codec_QuantizeUNorm16(texCoord[componentIndex],
+					dequantization->texCoordOffset[componentIndex], dequantization->texCoordScale[componentIndex]);
+		}
+	}
+	HbMemory_Free(vertexesInFile);
+
+	uint8_t * data = (uint8_t *) HbMemory_Alloc(tag, sizeof(HbMesh_Codec_Mesh_Header) +
+			HbMesh_Codec_GetVertexesMaxEncodedSize(vertexCount, HbMesh_Codec_Vertex_SizeInDwords) +
+			HbMesh_Codec_GetIndexesMaxEncodedSize(triangleCount), HbFalse);
+	uint8_t * vertexData = data + sizeof(HbMesh_Codec_Mesh_Header);
+	header.vertexDataSize = (uint32_t) HbMesh_Codec_EncodeVertexes(vertexes, vertexCount, HbMesh_Codec_Vertex_SizeInDwords, vertexData);
+	header.indexDataSize = (uint32_t) HbMesh_Codec_EncodeIndexes(indexes, triangleCount, vertexCount, vertexData + header.vertexDataSize);
+	memcpy(data, &header, sizeof(HbMesh_Codec_Mesh_Header));
+	HbMemory_Free(vertexes);
+	HbMemory_Free(indexes);
+	*dataSize = (uint32_t) sizeof(HbMesh_Codec_Mesh_Header) + header.vertexDataSize + header.indexDataSize;
+	return data;
+}
+
+HbBool HbMesh_Codec_Mesh_Init(HbMesh_Codec_Mesh * mesh, void const * data, size_t dataSize) {
+	if (dataSize < sizeof(HbMesh_Codec_Mesh_Header)) {
+		return HbFalse;
+	}
+	HbMesh_Codec_Mesh_Header const * header = (HbMesh_Codec_Mesh_Header const *) data;
+	if (header->vertexCount > 0x10000 ||
+			(uint64_t) header->vertexDataSize + header->indexDataSize > dataSize - sizeof(HbMesh_Codec_Mesh_Header)) {
+		return HbFalse;
+	}
+	mesh->header = header;
+	mesh->vertexData = header + 1;
+	mesh->indexData = (uint8_t const *) mesh->vertexData + header->vertexDataSize;
+	return HbTrue;
+}
+
+HbBool HbMesh_Codec_Mesh_Decode(HbMesh_Codec_Mesh const * mesh, HbMesh_Codec_Vertex * vertexTarget, HbGPU_Vertex_Index * indexTarget) {
+	HbMesh_Codec_Mesh_Header const * header = mesh->header;
+	return HbMesh_Codec_DecodeVertexes(mesh->vertexData, header->vertexDataSize, header->vertexCount,
+					HbMesh_Codec_Vertex_SizeInDwords, vertexTarget) &&
+			HbMesh_Codec_DecodeIndexes(mesh->indexData, header->indexDataSize, header->triangleCount, header->vertexCount, indexTarget);
+}
@@ -0,0 +1,124 @@
+#ifndef HbInclude_HbMesh_Geometry
+#define HbInclude_HbMesh_Geometry
+#include "HbCommon.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * CPU processing of indexed triangle lists for asset tools and loading, such as those of IQM meshes
+ * (with the indexes made relative to the first vertex of the mesh). Indexes are 32-bit, like HbFile_IQM_TriangleIndex,
+ * and positions are 3 floats at the beginning of every vertex of positionStride bytes.
+ *
+ * This part doesn't depend on the rest of the engine or on the OS, so it can be used in tools built for any platform.
+ * Temporary memory is provided by the caller as a 4-aligned scratch buffer of the size returned by the GetScratchSize function
+ * of the operation, which may be reused between calls.
+ */
+
+/***************
+ * Optimization
+ ***************/
+
+// Post-transform vertex cache efficiency of the triangles, with the cache simulated as a FIFO of cacheSize vertexes.
+typedef struct HbMesh_VertexCacheStats {
+	uint32_t transformCount; // Cache misses.
+	float acmr; // Average cache miss ratio - transforms per triangle, 0.5 at best for large regular grids, 3 at worst.
+	float atvr; // Average transform to vertex ratio - transforms per referenced vertex, 1 at best.
+} HbMesh_VertexCacheStats;
+size_t HbMesh_GetVertexCacheStats_GetScratchSize(uint32_t vertexCount);
+void HbMesh_GetVertexCacheStats(uint32_t const * indexes, uint32_t triangleCount, uint32_t vertexCount, uint32_t cacheSize,
+		HbMesh_VertexCacheStats * stats, void * scratch);
+
+// The optimizations are applied in this order, each one keeping the result of the previous mostly intact:
+// - Reordering of the triangles for the post-transform vertex cache (Forsyth's linear-speed algorithm).
+// - Reordering of clusters of triangles to draw the outer surfaces first, for less overdraw, keeping the cache efficiency within
+//   the threshold (Sander, Nehab, Barczak, "Fast Triangle Reordering for Vertex Locality and Reduced Overdraw").
+// - Reordering of the vertexes in the order of their first use by the triangles, for the locality of vertex fetching.
+
+// The cache is modeled as LRU of this size, but it's good for other sizes too, and for FIFO caches.
+#define HbMesh_OptimizeVertexCache_CacheSize 32
+size_t HbMesh_OptimizeVertexCache_GetScratchSize(uint32_t triangleCount, uint32_t vertexCount);
+// target may be the same as indexes.
+void HbMesh_OptimizeVertexCache(uint32_t const * indexes, uint32_t triangleCount, uint32_t vertexCount, uint32_t * target,
+		void * scratch);
+
+// Clusters are split where the vertex cache of this size would be fully missed, and also where the cache miss ratio of the part
+// of the cluster from the last split is no more than threshold (1.05 for up to 5% worse cache efficiency) times that of the cluster.
+#define HbMesh_OptimizeOverdraw_CacheSize 16
+size_t HbMesh_OptimizeOverdraw_GetScratchSize(uint32_t triangleCount, uint32_t vertexCount);
+void HbMesh_OptimizeOverdraw(uint32_t * indexes, uint32_t triangleCount, float const * positions, size_t positionStride, uint32_t vertexCount,
+		float threshold, void * scratch);
+
+// Renumbers the vertexes in place in the indexes, writing the new index of every old vertex (UINT32_MAX for unused vertexes,
+// which are dropped) to remap (vertexCount elements). Returns the new vertex count.
+uint32_t HbMesh_OptimizeVertexFetch(uint32_t * indexes, uint32_t triangleCount, uint32_t vertexCount, uint32_t * remap);
+// Moves vertexes of vertexSize bytes to their new places, target must not overlap source.
+void HbMesh_RemapVertexes(void const * source, uint32_t vertexCount, size_t vertexSize, uint32_t const * remap, void * target);
+
+/***********
+ * Meshlets
+ ***********/
+
+// Small clusters of triangles with bounds for culling of parts of meshes on the CPU or the GPU,
+// sized for mesh shaders and for compute culling with one thread per triangle.
+#define HbMesh_Meshlet_MaxVertexes 64
+#define HbMesh_Meshlet_MaxTriangles 124
+
+// 44 bytes, can be used as a GPU structured buffer element as is.
+typedef struct HbMesh_Meshlet {
+	float center[3], radius; // Bounding sphere.
+	// Normal cone - all triangles are back-facing if dot(normalize(coneApex - eye), normalize(coneAxis)) >= coneCutoff.
+	// Axis and cutoff are SNorm8 (cutoff of 127 for meshlets that can't be culled this way).
+	float coneApex[3];
+	int8_t coneAxisAndCutoff[4];
+	uint32_t vertexFirst; // In the vertex array of the meshlets.
+	uint32_t triangleFirst; // In the triangle array of the meshlets.
+	uint16_t vertexCount, triangleCount;
+} HbMesh_Meshlet;
+
+// Meshlet vertexes are indexes of the vertexes of the mesh. Meshlet triangles are 3 8-bit indexes of the meshlet vertexes
+// in bits 0:7, 8:15 and 16:23 of 32-bit words, in the original winding order.
+// The arrays must have space for HbMesh_Meshlet_GetMaxCount meshlets, and for as many vertexes as there are in all of them at most
+// (HbMesh_Meshlet_MaxVertexes per meshlet) and triangleCount triangles.
+HbForceInline uint32_t HbMesh_Meshlet_GetMaxCount(uint32_t triangleCount) {
+	// Meshlets are only finished when no more triangles fit, so except for the last one, each has as many triangles
+	// as needed to use more than MaxVertexes - 3 vertexes, or MaxTriangles.
+	uint32_t minTriangles = HbMinU32((HbMesh_Meshlet_MaxVertexes - 3) / 3 + 1, HbMesh_Meshlet_MaxTriangles);
+	return (triangleCount + (minTriangles - 1)) / minTriangles;
+}
+size_t HbMesh_Meshlet_Build_GetScratchSize(uint32_t triangleCount, uint32_t vertexCount);
+// Grows meshlets over connected triangles, preferring those adding fewer new vertexes, and, with coneWeight above 0 (up to 1),
+// those with normals closer to the meshlet average for tighter cones. Best used after HbMesh_OptimizeVertexCache.
+// Returns the number of meshlets.
+uint32_t HbMesh_Meshlet_Build(uint32_t const * indexes, uint32_t triangleCount, float const * positions, size_t positionStride,
+		uint32_t vertexCount, float coneWeight, HbMesh_Meshlet * meshlets, uint32_t * meshletVertexes, uint32_t * meshletTriangles,
+		void * scratch);
+
+// Reference CPU culling, with the view transformation and the tile depth bounds from the previous frame or a depth prepass
+// being the same as the GPU implementations would use.
+typedef struct HbMesh_Meshlet_Culler {
+	float frustumPlanes[6][4]; // Normalized, in the model space, XYZ pointing inside.
+	float modelToClip[4][4];
+	float eyePosition[3];
+	float const * tileFarthestDepths;
+	uint32_t viewportWidth, viewportHeight;
+	uint32_t tileSizeLog2;
+	uint32_t widthTiles, heightTiles;
+} HbMesh_Meshlet_Culler;
+// modelToClip - rows of the matrix transforming column vectors (with the model, view and projection transformations),
+// with the clip space Z from 0 to W, reversed so the near plane is at 1 after the division by W.
+// eyePosition - the camera position in the model space.
+// tileFarthestDepths - NULL, or the farthest depth buffer values in every tile of 1 << tileSizeLog2 pixels of the viewport,
+// for occlusion culling - like layer 1 of the front face test array written by HbGFX_Tile_GetDepthBounds,
+// with tileSizeLog2 of HbGFX_Tile_TileSizeLog2.
+void HbMesh_Meshlet_Culler_Init(HbMesh_Meshlet_Culler * culler, float const modelToClip[4][4], float const eyePosition[3],
+		float const * tileFarthestDepths, uint32_t tileSizeLog2, uint32_t viewportWidth, uint32_t viewportHeight);
+HbBool HbMesh_Meshlet_Culler_IsVisible(HbMesh_Meshlet_Culler const * culler, HbMesh_Meshlet const * meshlet);
+// Writes the indexes of the visible meshlets, returns their number.
+uint32_t HbMesh_Meshlet_Culler_Cull(HbMesh_Meshlet_Culler const * culler, HbMesh_Meshlet const * meshlets, uint32_t meshletCount,
+		uint32_t * visibleIndexes);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
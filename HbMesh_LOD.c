@@ -0,0 +1,222 @@
+#include "HbMesh.h"
+#include "HbText.h"
+#include <math.h>
+
+/********
+ * Chain
+ ********/
+
+uint32_t HbMesh_LOD_BuildChain(uint32_t const * indexes, uint32_t triangleCount, HbMesh_Simplify_Vertexes const * vertexes,
+		uint32_t maxLevelCount, float levelTriangleRatio, float maxError, HbMesh_LOD_Level * levels, uint32_t * levelIndexes,
+		HbMemory_Tag * tag) {
+	uint32_t levelCount = 0;
+	uint32_t const * previousIndexes = indexes;
+	uint32_t previousTriangleCount = triangleCount, levelTriangleFirst = 0;
+	float previousGeometricError = 0.0f, previousAttributeError = 0.0f;
+	while (levelCount < maxLevelCount && previousTriangleCount != 0 && previousGeometricError < maxError) {
+		uint32_t * currentIndexes = levelIndexes + (size_t) 3 * levelTriangleFirst;
+		float levelGeometricError, levelAttributeError;
+		uint32_t levelTriangleCount = HbMesh_Simplify(previousIndexes, previousTriangleCount, vertexes,
+				(uint32_t) ((float) previousTriangleCount * levelTriangleRatio), maxError - previousGeometricError, currentIndexes,
+				&levelGeometricError, &levelAttributeError, tag);
+		if ((float) levelTriangleCount >= (float) previousTriangleCount * HbMesh_LOD_MaxLevelTriangleRatio) {
+			break;
+		}
+		// Simplified from the previous level, with the quadrics of the previous level, not of the original mesh, so summed.
+		HbMesh_LOD_Level * level = &levels[levelCount++];
+		level->triangleFirst = levelTriangleFirst;
+		level->triangleCount = levelTriangleCount;
+		level->geometricError = previousGeometricError + levelGeometricError;
+		level->attributeError = previousAttributeError + levelAttributeError;
+		previousIndexes = currentIndexes;
+		previousTriangleCount = levelTriangleCount;
+		previousGeometricError = level->geometricError;
+		previousAttributeError = level->attributeError;
+		levelTriangleFirst += levelTriangleCount;
+	}
+	return levelCount;
+}
+
+uint32_t HbMesh_LOD_Select(HbMesh_LOD_Level const * levels, uint32_t levelCount, float distance, float projectionScale, float maxPixelError) {
+	// Errors grow with the level, so the first one that's too coarse is after the result.
+	float maxLevelError = maxPixelError * distance / projectionScale;
+	uint32_t levelIndex = 0;
+	while (levelIndex < levelCount && levels[levelIndex].geometricError <= maxLevelError) {
+		++levelIndex;
+	}
+	return levelIndex;
+}
+
+/******************
+ * IQM persistence
+ ******************/
+
+HbBool HbMesh_LOD_IQM_Init(HbMesh_LOD_IQM * lods, HbFile_IQM_Model const * model) {
+	uint32_t dataSize;
+	uint8_t const * data = (uint8_t const *) HbFile_IQM_Model_FindExtension(model, HbMesh_LOD_IQM_ExtensionName, &dataSize);
+	if (data == NULL || ((uintptr_t) data & 3) != 0 || dataSize < sizeof(HbMesh_LOD_IQM_Header)) {
+		return HbFalse;
+	}
+	HbMesh_LOD_IQM_Header const * header = (HbMesh_LOD_IQM_Header const *) data;
+	uint32_t meshCount = model->header->meshCount;
+	if (header->meshCount != meshCount || (uint64_t) sizeof(HbMesh_LOD_IQM_Header) + (uint64_t) meshCount * sizeof(HbMesh_LOD_IQM_Mesh) +
+			(uint64_t) header->levelCount * sizeof(HbMesh_LOD_Level) + (uint64_t) header->triangleCount * 3 * sizeof(HbFile_IQM_TriangleIndex) >
+			dataSize) {
+		return HbFalse;
+	}
+	lods->meshes = (HbMesh_LOD_IQM_Mesh const *) (header + 1);
+	lods->levels = (HbMesh_LOD_Level const *) (lods->meshes + meshCount);
+	lods->triangles = (HbFile_IQM_TriangleIndex const *) (lods->levels + header->levelCount);
+	for (uint32_t meshIndex = 0; meshIndex < meshCount; ++meshIndex) {
+		HbMesh_LOD_IQM_Mesh const * lodMesh = &lods->meshes[meshIndex];
+		if (lodMesh->levelFirst > header->levelCount || lodMesh->levelCount > header->levelCount - lodMesh->levelFirst) {
+			return HbFalse;
+		}
+		HbFile_IQM_Mesh const * mesh = &model->meshes[meshIndex];
+		for (uint32_t levelIndex = 0; levelIndex < lodMesh->levelCount; ++levelIndex) {
+			HbMesh_LOD_Level const * level = &lods->levels[lodMesh->levelFirst + levelIndex];
+			if (level->triangleFirst > header->triangleCount || level->triangleCount > header->triangleCount - level->triangleFirst) {
+				return HbFalse;
+			}
+			HbFile_IQM_TriangleIndex const * levelTriangles = lods->triangles + (size_t) 3 * level->triangleFirst;
+			for (uint32_t indexIndex = 0; indexIndex < 3 * level->triangleCount; ++indexIndex) {
+				if (levelTriangles[indexIndex] - mesh->vertexFirst >= mesh->vertexCount) {
+					return HbFalse;
+				}
+			}
+		}
+	}
+	return HbTrue;
+}
+
+void * HbMesh_LOD_IQM_Write(HbFile_IQM_Model const * model, uint32_t maxLevelCount, float levelTriangleRatio, float maxError,
+		float normalWeight, float texCoordWeight, HbMemory_Tag * tag, uint32_t * iqmSize) {
+	HbFile_IQM_Header const * header = model->header;
+	uint32_t meshCount = header->meshCount;
+
+	// Positions, normals and texture coordinates, converted to floats from any format.
+	enum {
+		vertexPositionOffset = 0,
+		vertexNormalOffset = 3,
+		vertexTexCoordOffset = 6,
+		vertexStrideInDwords = 8,
+	};
+	HbGPU_Vertex_Attribute const vertexAttributes[] = {
+		{ .semantic = HbGPU_Vertex_Semantic_Position, .format = HbGPU_Vertex_Format_Float_32x3, .offsetInDwords = vertexPositionOffset },
+		{ .semantic = HbGPU_Vertex_Semantic_Normal, .format = HbGPU_Vertex_Format_Float_32x3, .offsetInDwords = vertexNormalOffset },
+		{ .semantic = HbGPU_Vertex_Semantic_TexCoord, .format = HbGPU_Vertex_Format_Float_32x2, .offsetInDwords = vertexTexCoordOffset },
+	};
+	HbGPU_Vertex_Stream const vertexStream = { .strideInDwords = vertexStrideInDwords };
+	float const attributeWeights[] = { normalWeight, normalWeight, normalWeight, texCoordWeight, texCoordWeight };
+
+	HbMesh_LOD_IQM_Mesh * lodMeshes = (HbMesh_LOD_IQM_Mesh *) HbMemory_Alloc(tag, HbMaxSize(meshCount, 1) * sizeof(HbMesh_LOD_IQM_Mesh), HbFalse);
+	HbMesh_LOD_Level * levels = (HbMesh_LOD_Level *) HbMemory_Alloc(tag,
+			HbMaxSize((size_t) meshCount * maxLevelCount, 1) * sizeof(HbMesh_LOD_Level), HbFalse);
+	uint32_t levelCount = 0;
+	uint32_t * levelTriangles = NULL;
+	uint32_t levelTriangleCount = 0;
+	for (uint32_t meshIndex = 0; meshIndex < meshCount; ++meshIndex) {
+		HbFile_IQM_Mesh const * mesh = &model->meshes[meshIndex];
+		HbMesh_LOD_IQM_Mesh * lodMesh = &lodMeshes[meshIndex];
+		lodMesh->levelFirst = levelCount;
+		lodMesh->levelCount = 0;
+		if (mesh->triangleCount == 0 || mesh->vertexCount == 0 || maxLevelCount == 0) {
+			continue;
+		}
+
+		float * meshVertexes = (float *) HbMemory_Alloc(tag, (size_t) mesh->vertexCount * vertexStrideInDwords * sizeof(float), HbFalse);
+		HbGPU_Vertex_SemanticBits semanticsInFile = HbFile_IQM_Model_WriteVertexes(model, mesh->vertexFirst, mesh->vertexCount,
+				vertexAttributes, HbArrayLength(vertexAttributes), 0, &vertexStream, meshVertexes);
+		HbMesh_Simplify_Vertexes simplifyVertexes = {
+			.positions = meshVertexes + vertexPositionOffset,
+			.positionStride = vertexStrideInDwords * sizeof(float),
+			.vertexCount = mesh->vertexCount,
+		};
+		// Normals and texture coordinates are adjacent, and only the ones in the file are used.
+		HbBool hasNormals = (semanticsInFile & HbGPU_Vertex_SemanticBits_Normal) != 0 && normalWeight > 0.0f;
+		HbBool hasTexCoords = (semanticsInFile & HbGPU_Vertex_SemanticBits_TexCoord) != 0 && texCoordWeight > 0.0f;
+		if (hasNormals || hasTexCoords) {
+			simplifyVertexes.attributes = meshVertexes + (hasNormals ? vertexNormalOffset : vertexTexCoordOffset);
+			simplifyVertexes.attributeStride = vertexStrideInDwords * sizeof(float);
+			simplifyVertexes.attributeWeights = attributeWeights + (hasNormals ? 0 : 3);
+			simplifyVertexes.attributeCount = (hasNormals ? 3 : 0) + (hasTexCoords ? 2 : 0);
+		}
+
+		uint32_t * meshIndexes = (uint32_t *) HbMemory_Alloc(tag,
+				(size_t) 3 * mesh->triangleCount * (1 + maxLevelCount) * sizeof(uint32_t), HbFalse);
+		uint32_t * meshLevelIndexes = meshIndexes + (size_t) 3 * mesh->triangleCount;
+		HbFile_IQM_TriangleIndex const * meshTriangles = model->triangles + (size_t) 3 * mesh->triangleFirst;
+		for (uint32_t indexIndex = 0; indexIndex < 3 * mesh->triangleCount; ++indexIndex) {
+			// Validated by the model initialization to be in the file, but not necessarily in the mesh.
+			meshIndexes[indexIndex] = HbMinU32(meshTriangles[indexIndex] - mesh->vertexFirst, mesh->vertexCount - 1);
+		}
+		uint32_t meshLevelCount = HbMesh_LOD_BuildChain(meshIndexes, mesh->triangleCount, &simplifyVertexes,
+				maxLevelCount, levelTriangleRatio, maxError, levels + levelCount, meshLevelIndexes, tag);
+		uint32_t meshLevelTriangleCount = 0;
+		for (uint32_t levelIndex = 0; levelIndex < meshLevelCount; ++levelIndex) {
+			HbMesh_LOD_Level * level = &levels[levelCount + levelIndex];
+			level->triangleFirst += levelTriangleCount;
+			meshLevelTriangleCount += level->triangleCount;
+		}
+		size_t levelTrianglesSize = HbMaxSize((size_t) 3 * (levelTriangleCount + meshLevelTriangleCount) * sizeof(uint32_t), 1);
+		if (levelTriangles != NULL) {
+			HbMemory_Realloc((void * *) &levelTriangles, levelTrianglesSize);
+		} else {
+			levelTriangles = (uint32_t *) HbMemory_Alloc(tag, levelTrianglesSize, HbFalse);
+		}
+		for (uint32_t indexIndex = 0; indexIndex < 3 * meshLevelTriangleCount; ++indexIndex) {
+			levelTriangles[(size_t) 3 * levelTriangleCount + indexIndex] = mesh->vertexFirst + meshLevelIndexes[indexIndex];
+		}
+		lodMesh->levelCount = meshLevelCount;
+		levelCount += meshLevelCount;
+		levelTriangleCount += meshLevelTriangleCount;
+		HbMemory_Free(meshIndexes);
+		HbMemory_Free(meshVertexes);
+	}
+
+	// The original file, then the text with the extension name added, the extension, and its data.
+	char const * extensionName = HbMesh_LOD_IQM_ExtensionName;
+	uint32_t extensionNameSize = (uint32_t) HbTextA_Length(extensionName) + 1;
+	uint32_t textOffset = HbAlignU32(header->fileSize, 4);
+	uint32_t textSize = header->textSize + extensionNameSize;
+	uint32_t extensionOffset = HbAlignU32(textOffset + textSize, 4);
+	uint32_t dataOffset = extensionOffset + sizeof(HbFile_IQM_Extension);
+	uint32_t dataSize = sizeof(HbMesh_LOD_IQM_Header) + meshCount * sizeof(HbMesh_LOD_IQM_Mesh) + levelCount * sizeof(HbMesh_LOD_Level) +
+			3 * levelTriangleCount * sizeof(HbFile_IQM_TriangleIndex);
+	*iqmSize = dataOffset + dataSize;
+	uint8_t * iqm = (uint8_t *) HbMemory_Alloc(tag, *iqmSize, HbFalse);
+	memcpy(iqm, header, header->fileSize);
+	memset(iqm + header->fileSize, 0, textOffset - header->fileSize);
+	memcpy(iqm + textOffset, (uint8_t const *) header + header->textOffset, header->textSize);
+	memcpy(iqm + textOffset + header->textSize, extensionName, extensionNameSize);
+	memset(iqm + textOffset + textSize, 0, extensionOffset - (textOffset + textSize));
+	HbFile_IQM_Header * newHeader = (HbFile_IQM_Header *) iqm;
+	HbFile_IQM_Extension * extension = (HbFile_IQM_Extension *) (iqm + extensionOffset);
+	extension->name = header->textSize;
+	extension->dataSize = dataSize;
+	extension->dataOffset = dataOffset;
+	extension->nextOffset = header->extensionOffset;
+	newHeader->fileSize = *iqmSize;
+	newHeader->textOffset = textOffset;
+	newHeader->textSize = textSize;
+	newHeader->extensionCount = header->extensionCount + 1;
+	newHeader->extensionOffset = extensionOffset;
+	uint8_t * data = iqm + dataOffset;
+	HbMesh_LOD_IQM_Header * lodHeader = (HbMesh_LOD_IQM_Header *) data;
+	lodHeader->meshCount = meshCount;
+	lodHeader->levelCount = levelCount;
+	lodHeader->triangleCount = levelTriangleCount;
+	data += sizeof(HbMesh_LOD_IQM_Header);
+	memcpy(data, lodMeshes, meshCount * sizeof(HbMesh_LOD_IQM_Mesh));
+	data += meshCount * sizeof(HbMesh_LOD_IQM_Mesh);
+	memcpy(data, levels, levelCount * sizeof(HbMesh_LOD_Level));
+	data += levelCount * sizeof(HbMesh_LOD_Level);
+	if (levelTriangles != NULL) {
+		memcpy(data, levelTriangles, (size_t) 3 * levelTriangleCount * sizeof(HbFile_IQM_TriangleIndex));
+		HbMemory_Free(levelTriangles);
+	}
+
+	HbMemory_Free(levels);
+	HbMemory_Free(lodMeshes);
+	return iqm;
+}
@@ -0,0 +1,432 @@
+#include "HbMesh_Geometry.h"
+#include <float.h>
+#include <math.h>
+
+/*********
+ * Bounds
+ *********/
+
+HbForceInline float const * HbMeshi_Meshlet_GetPosition(float const * positions, size_t positionStride, uint32_t vertexIndex) {
+	return (float const *) ((uint8_t const *) positions + vertexIndex * positionStride);
+}
+
+HbForceInline float HbMeshi_Meshlet_Dot(float const a[3], float const b[3]) {
+	return a[0] * b[0] + a[1] * b[1] + a[2] * b[2];
+}
+
+// Returns the length before normalization, leaves zero vectors unchanged.
+static float HbMeshi_Meshlet_Normalize(float vector[3]) {
+	float length = sqrtf(HbMeshi_Meshlet_Dot(vector, vector));
+	if (length > 0.0f) {
+		float lengthInverse = 1.0f / length;
+		vector[0] *= lengthInverse;
+		vector[1] *= lengthInverse;
+		vector[2] *= lengthInverse;
+	}
+	return length;
+}
+
+// Normalized, or zero for degenerate triangles.
+static void HbMeshi_Meshlet_GetTriangleNormal(float const * p0, float const * p1, float const * p2, float normal[3]) {
+	float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] }, e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+	normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+	HbMeshi_Meshlet_Normalize(normal);
+}
+
+static void HbMeshi_Meshlet_ComputeBounds(HbMesh_Meshlet * meshlet, uint32_t const * meshletVertexes, uint32_t const * meshletTriangles,
+		float const * positions, size_t positionStride) {
+	uint32_t const * vertexes = meshletVertexes + meshlet->vertexFirst;
+	uint32_t const * triangles = meshletTriangles + meshlet->triangleFirst;
+
+	// Bounding sphere (Ritter's) - starting with the most distant pair of the points extreme along the axes, and growing to enclose all.
+	uint32_t axisMins[3] = { 0, 0, 0 }, axisMaxs[3] = { 0, 0, 0 };
+	for (uint32_t vertexIndex = 1; vertexIndex < meshlet->vertexCount; ++vertexIndex) {
+		float const * position = HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[vertexIndex]);
+		for (uint32_t axis = 0; axis < 3; ++axis) {
+			if (position[axis] < HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[axisMins[axis]])[axis]) {
+				axisMins[axis] = vertexIndex;
+			}
+			if (position[axis] > HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[axisMaxs[axis]])[axis]) {
+				axisMaxs[axis] = vertexIndex;
+			}
+		}
+	}
+	float center[3] = { 0.0f, 0.0f, 0.0f }, radius = -1.0f;
+	for (uint32_t axis = 0; axis < 3; ++axis) {
+		float const * positionMin = HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[axisMins[axis]]);
+		float const * positionMax = HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[axisMaxs[axis]]);
+		float difference[3] = { positionMax[0] - positionMin[0], positionMax[1] - positionMin[1], positionMax[2] - positionMin[2] };
+		float axisRadius = 0.5f * sqrtf(HbMeshi_Meshlet_Dot(difference, difference));
+		if (axisRadius > radius) {
+			radius = axisRadius;
+			for (uint32_t centerAxis = 0; centerAxis < 3; ++centerAxis) {
+				center[centerAxis] = 0.5f * (positionMin[centerAxis] + positionMax[centerAxis]);
+			}
+		}
+	}
+	for (uint32_t vertexIndex = 0; vertexIndex < meshlet->vertexCount; ++vertexIndex) {
+		float const * position = HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[vertexIndex]);
+		float difference[3] = { position[0] - center[0], position[1] - center[1], position[2] - center[2] };
+		float distance = sqrtf(HbMeshi_Meshlet_Dot(difference, difference));
+		if (distance > radius) {
+			// Moving the center towards the point so the sphere touches it and the opposite side of the old sphere.
+			float shift = 0.5f * (distance - radius);
+			radius += shift;
+			shift /= distance;
+			for (uint32_t axis = 0; axis < 3; ++axis) {
+				center[axis] += difference[axis] * shift;
+			}
+		}
+	}
+	memcpy(meshlet->center, center, sizeof(center));
+	// Rounding errors in the growth may leave points slightly outside.
+	meshlet->radius = radius * (1.0f + FLT_EPSILON * 4.0f);
+
+	// Normal cone, with the quantized axis so the cutoff is conservative for it.
+	memcpy(meshlet->coneApex, center, sizeof(center));
+	meshlet->coneAxisAndCutoff[0] = meshlet->coneAxisAndCutoff[1] = meshlet->coneAxisAndCutoff[2] = 0;
+	meshlet->coneAxisAndCutoff[3] = INT8_MAX;
+	float axis[3] = { 0.0f, 0.0f, 0.0f };
+	for (uint32_t triangleIndex = 0; triangleIndex < meshlet->triangleCount; ++triangleIndex) {
+		uint32_t triangle = triangles[triangleIndex];
+		float normal[3];
+		HbMeshi_Meshlet_GetTriangleNormal(HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[triangle & 0xFF]),
+				HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[(triangle >> 8) & 0xFF]),
+				HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[(triangle >> 16) & 0xFF]), normal);
+		axis[0] += normal[0];
+		axis[1] += normal[1];
+		axis[2] += normal[2];
+	}
+	if (HbMeshi_Meshlet_Normalize(axis) <= 0.0f) {
+		return;
+	}
+	int8_t axisQuantized[3];
+	for (uint32_t axisComponent = 0; axisComponent < 3; ++axisComponent) {
+		axisQuantized[axisComponent] = (int8_t) lrintf(axis[axisComponent] * 127.0f);
+		axis[axisComponent] = (float) axisQuantized[axisComponent] * (1.0f / 127.0f);
+	}
+	if (HbMeshi_Meshlet_Normalize(axis) <= 0.0f) {
+		return;
+	}
+	float minNormalDot = 1.0f;
+	for (uint32_t triangleIndex = 0; triangleIndex < meshlet->triangleCount; ++triangleIndex) {
+		uint32_t triangle = triangles[triangleIndex];
+		float normal[3];
+		HbMeshi_Meshlet_GetTriangleNormal(HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[triangle & 0xFF]),
+				HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[(triangle >> 8) & 0xFF]),
+				HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[(triangle >> 16) & 0xFF]), normal);
+		if (HbMeshi_Meshlet_Dot(normal, normal) > 0.0f) {
+			minNormalDot = fminf(minNormalDot, HbMeshi_Meshlet_Dot(normal, axis));
+		}
+	}
+	if (minNormalDot <= 0.0f) {
+		// The normals span a hemisphere or more, some triangles are always front-facing.
+		return;
+	}
+	// The apex is placed along the axis behind the planes of all triangles.
+	float apexDistance = -FLT_MAX;
+	for (uint32_t triangleIndex = 0; triangleIndex < meshlet->triangleCount; ++triangleIndex) {
+		uint32_t triangle = triangles[triangleIndex];
+		float const * p0 = HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[triangle & 0xFF]);
+		float const * p1 = HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[(triangle >> 8) & 0xFF]);
+		float const * p2 = HbMeshi_Meshlet_GetPosition(positions, positionStride, vertexes[(triangle >> 16) & 0xFF]);
+		float normal[3];
+		HbMeshi_Meshlet_GetTriangleNormal(p0, p1, p2, normal);
+		if (HbMeshi_Meshlet_Dot(normal, normal) <= 0.0f) {
+			continue;
+		}
+		float centroidOffset[3];
+		for (uint32_t axisComponent = 0; axisComponent < 3; ++axisComponent) {
+			centroidOffset[axisComponent] = (p0[axisComponent] + p1[axisComponent] + p2[axisComponent]) * (1.0f / 3.0f) - center[axisComponent];
+		}
+		apexDistance = fmaxf(apexDistance, -HbMeshi_Meshlet_Dot(centroidOffset, normal) / HbMeshi_Meshlet_Dot(axis, normal));
+	}
+	for (uint32_t axisComponent = 0; axisComponent < 3; ++axisComponent) {
+		meshlet->coneApex[axisComponent] = center[axisComponent] - axis[axisComponent] * apexDistance;
+		meshlet->coneAxisAndCutoff[axisComponent] = axisQuantized[axisComponent];
+	}
+	// Sine of the angle between the axis and the farthest normal, rounded up so more meshlets are treated as visible.
+	float cutoff = sqrtf(fmaxf(1.0f - minNormalDot * minNormalDot, 0.0f));
+	meshlet->coneAxisAndCutoff[3] = (int8_t) HbMinI32((int32_t) ceilf(cutoff * 127.0f), INT8_MAX);
+}
+
+/***********
+ * Building
+ ***********/
+
+#define HbMeshi_Meshlet_VertexNotInMeshlet UINT8_MAX
+
+// The 4-byte arrays are placed before the 1-byte ones.
+typedef struct HbMeshi_Meshlet_ScratchLayout {
+	size_t vertexTrianglesFirstOffset;
+	size_t vertexTriangleCountsOffset;
+	size_t vertexTrianglesOffset;
+	size_t triangleNormalsOffset;
+	size_t vertexLocalIndexesOffset;
+	size_t triangleAddedOffset;
+	size_t size;
+} HbMeshi_Meshlet_ScratchLayout;
+
+static void HbMeshi_Meshlet_ScratchLayout_Init(HbMeshi_Meshlet_ScratchLayout * layout, uint32_t triangleCount, uint32_t vertexCount) {
+	layout->vertexTrianglesFirstOffset = 0;
+	layout->vertexTriangleCountsOffset = layout->vertexTrianglesFirstOffset + (size_t) vertexCount * sizeof(uint32_t);
+	layout->vertexTrianglesOffset = layout->vertexTriangleCountsOffset + (size_t) vertexCount * sizeof(uint32_t);
+	layout->triangleNormalsOffset = layout->vertexTrianglesOffset + (size_t) 3 * triangleCount * sizeof(uint32_t);
+	layout->vertexLocalIndexesOffset = layout->triangleNormalsOffset + (size_t) 3 * triangleCount * sizeof(float);
+	layout->triangleAddedOffset = layout->vertexLocalIndexesOffset + (size_t) vertexCount * sizeof(uint8_t);
+	layout->size = layout->triangleAddedOffset + (size_t) triangleCount * sizeof(HbBool);
+}
+
+size_t HbMesh_Meshlet_Build_GetScratchSize(uint32_t triangleCount, uint32_t vertexCount) {
+	HbMeshi_Meshlet_ScratchLayout layout;
+	HbMeshi_Meshlet_ScratchLayout_Init(&layout, triangleCount, vertexCount);
+	return layout.size;
+}
+
+uint32_t HbMesh_Meshlet_Build(uint32_t const * indexes, uint32_t triangleCount, float const * positions, size_t positionStride,
+		uint32_t vertexCount, float coneWeight, HbMesh_Meshlet * meshlets, uint32_t * meshletVertexes, uint32_t * meshletTriangles,
+		void * scratch) {
+	if (triangleCount == 0) {
+		return 0;
+	}
+
+	HbMeshi_Meshlet_ScratchLayout layout;
+	HbMeshi_Meshlet_ScratchLayout_Init(&layout, triangleCount, vertexCount);
+	uint8_t * memory = (uint8_t *) scratch;
+	uint32_t * vertexTrianglesFirst = (uint32_t *) (memory + layout.vertexTrianglesFirstOffset);
+	uint32_t * vertexTriangleCounts = (uint32_t *) (memory + layout.vertexTriangleCountsOffset);
+	uint32_t * vertexTriangles = (uint32_t *) (memory + layout.vertexTrianglesOffset);
+	float * triangleNormals = (float *) (memory + layout.triangleNormalsOffset);
+	uint8_t * vertexLocalIndexes = memory + layout.vertexLocalIndexesOffset;
+	HbBool * triangleAdded = (HbBool *) (memory + layout.triangleAddedOffset);
+
+	// Triangles using every vertex, for adding the neighbors of the triangles already in the meshlet.
+	memset(vertexTriangleCounts, 0, vertexCount * sizeof(uint32_t));
+	for (uint32_t indexIndex = 0; indexIndex < 3 * triangleCount; ++indexIndex) {
+		++vertexTriangleCounts[indexes[indexIndex]];
+	}
+	uint32_t vertexTrianglesTotal = 0;
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		vertexTrianglesFirst[vertexIndex] = vertexTrianglesTotal;
+		vertexTrianglesTotal += vertexTriangleCounts[vertexIndex];
+		vertexTriangleCounts[vertexIndex] = 0;
+	}
+	for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		uint32_t const * triangle = indexes + 3 * triangleIndex;
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			// Degenerate triangles are referenced once per corner, this only makes them checked multiple times.
+			uint32_t vertexIndex = triangle[cornerIndex];
+			vertexTriangles[vertexTrianglesFirst[vertexIndex] + vertexTriangleCounts[vertexIndex]++] = triangleIndex;
+		}
+		HbMeshi_Meshlet_GetTriangleNormal(HbMeshi_Meshlet_GetPosition(positions, positionStride, triangle[0]),
+				HbMeshi_Meshlet_GetPosition(positions, positionStride, triangle[1]),
+				HbMeshi_Meshlet_GetPosition(positions, positionStride, triangle[2]), triangleNormals + 3 * triangleIndex);
+	}
+	memset(vertexLocalIndexes, HbMeshi_Meshlet_VertexNotInMeshlet, vertexCount * sizeof(uint8_t));
+	memset(triangleAdded, 0, triangleCount * sizeof(HbBool));
+
+	uint32_t meshletCount = 0;
+	HbMesh_Meshlet * meshlet = &meshlets[0];
+	meshlet->vertexFirst = 0;
+	meshlet->triangleFirst = 0;
+	meshlet->vertexCount = meshlet->triangleCount = 0;
+	float meshletNormal[3] = { 0.0f, 0.0f, 0.0f };
+	uint32_t nextTriangleToScan = 0; // For starting new meshlets and continuing ones with no unadded neighbors left.
+	for (uint32_t addedTriangleCount = 0; addedTriangleCount < triangleCount; ++addedTriangleCount) {
+		// Choosing the neighbor adding the fewest vertexes (as that's the limit usually reached first), with the closest normal.
+		uint32_t bestTriangle = UINT32_MAX;
+		uint32_t bestNewVertexCount = 0;
+		if (meshlet->triangleCount < HbMesh_Meshlet_MaxTriangles) {
+			float bestScore = FLT_MAX;
+			float meshletAverageNormal[3] = { meshletNormal[0], meshletNormal[1], meshletNormal[2] };
+			HbMeshi_Meshlet_Normalize(meshletAverageNormal);
+			for (uint32_t meshletVertexIndex = 0; meshletVertexIndex < meshlet->vertexCount; ++meshletVertexIndex) {
+				uint32_t vertexIndex = meshletVertexes[meshlet->vertexFirst + meshletVertexIndex];
+				uint32_t const * vertexTriangleIndexes = vertexTriangles + vertexTrianglesFirst[vertexIndex];
+				for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < vertexTriangleCounts[vertexIndex]; ++vertexTriangleIndex) {
+					uint32_t triangleIndex = vertexTriangleIndexes[vertexTriangleIndex];
+					if (triangleAdded[triangleIndex]) {
+						continue;
+					}
+					uint32_t const * triangle = indexes + 3 * triangleIndex;
+					uint32_t newVertexCount = (vertexLocalIndexes[triangle[0]] == HbMeshi_Meshlet_VertexNotInMeshlet) +
+							(vertexLocalIndexes[triangle[1]] == HbMeshi_Meshlet_VertexNotInMeshlet && triangle[1] != triangle[0]) +
+							(vertexLocalIndexes[triangle[2]] == HbMeshi_Meshlet_VertexNotInMeshlet &&
+									triangle[2] != triangle[0] && triangle[2] != triangle[1]);
+					if (meshlet->vertexCount + newVertexCount > HbMesh_Meshlet_MaxVertexes) {
+						continue;
+					}
+					float score = (float) newVertexCount +
+							coneWeight * (1.0f - HbMeshi_Meshlet_Dot(triangleNormals + 3 * triangleIndex, meshletAverageNormal));
+					if (score < bestScore) {
+						bestTriangle = triangleIndex;
+						bestNewVertexCount = newVertexCount;
+						bestScore = score;
+					}
+				}
+			}
+		}
+		if (bestTriangle == UINT32_MAX) {
+			while (triangleAdded[nextTriangleToScan]) {
+				++nextTriangleToScan;
+			}
+			bestTriangle = nextTriangleToScan;
+			uint32_t const * triangle = indexes + 3 * bestTriangle;
+			bestNewVertexCount = (vertexLocalIndexes[triangle[0]] == HbMeshi_Meshlet_VertexNotInMeshlet) +
+					(vertexLocalIndexes[triangle[1]] == HbMeshi_Meshlet_VertexNotInMeshlet && triangle[1] != triangle[0]) +
+					(vertexLocalIndexes[triangle[2]] == HbMeshi_Meshlet_VertexNotInMeshlet &&
+							triangle[2] != triangle[0] && triangle[2] != triangle[1]);
+			if (meshlet->triangleCount >= HbMesh_Meshlet_MaxTriangles ||
+					meshlet->vertexCount + bestNewVertexCount > HbMesh_Meshlet_MaxVertexes) {
+				// Finishing the meshlet and starting a new one.
+				HbMeshi_Meshlet_ComputeBounds(meshlet, meshletVertexes, meshletTriangles, positions, positionStride);
+				for (uint32_t meshletVertexIndex = 0; meshletVertexIndex < meshlet->vertexCount; ++meshletVertexIndex) {
+					vertexLocalIndexes[meshletVertexes[meshlet->vertexFirst + meshletVertexIndex]] = HbMeshi_Meshlet_VertexNotInMeshlet;
+				}
+				HbMesh_Meshlet * nextMeshlet = &meshlets[++meshletCount];
+				nextMeshlet->vertexFirst = meshlet->vertexFirst + meshlet->vertexCount;
+				nextMeshlet->triangleFirst = meshlet->triangleFirst + meshlet->triangleCount;
+				nextMeshlet->vertexCount = nextMeshlet->triangleCount = 0;
+				meshlet = nextMeshlet;
+				meshletNormal[0] = meshletNormal[1] = meshletNormal[2] = 0.0f;
+			}
+		}
+
+		uint32_t const * triangle = indexes + 3 * bestTriangle;
+		uint32_t localTriangle = 0;
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			uint32_t vertexIndex = triangle[cornerIndex];
+			if (vertexLocalIndexes[vertexIndex] == HbMeshi_Meshlet_VertexNotInMeshlet) {
+				vertexLocalIndexes[vertexIndex] = (uint8_t) meshlet->vertexCount;
+				meshletVertexes[meshlet->vertexFirst + meshlet->vertexCount++] = vertexIndex;
+			}
+			localTriangle |= (uint32_t) vertexLocalIndexes[vertexIndex] << (8 * cornerIndex);
+		}
+		meshletTriangles[meshlet->triangleFirst + meshlet->triangleCount++] = localTriangle;
+		triangleAdded[bestTriangle] = HbTrue;
+		meshletNormal[0] += triangleNormals[3 * bestTriangle];
+		meshletNormal[1] += triangleNormals[3 * bestTriangle + 1];
+		meshletNormal[2] += triangleNormals[3 * bestTriangle + 2];
+	}
+	HbMeshi_Meshlet_ComputeBounds(meshlet, meshletVertexes, meshletTriangles, positions, positionStride);
+	++meshletCount;
+	return meshletCount;
+}
+
+/**********
+ * Culling
+ **********/
+
+void HbMesh_Meshlet_Culler_Init(HbMesh_Meshlet_Culler * culler, float const modelToClip[4][4], float const eyePosition[3],
+		float const * tileFarthestDepths, uint32_t tileSizeLog2, uint32_t viewportWidth, uint32_t viewportHeight) {
+	memcpy(culler->modelToClip, modelToClip, sizeof(culler->modelToClip));
+	memcpy(culler->eyePosition, eyePosition, sizeof(culler->eyePosition));
+	culler->tileFarthestDepths = tileFarthestDepths;
+	culler->viewportWidth = viewportWidth;
+	culler->viewportHeight = viewportHeight;
+	culler->tileSizeLog2 = tileSizeLog2;
+	culler->widthTiles = (viewportWidth + ((1u << tileSizeLog2) - 1)) >> tileSizeLog2;
+	culler->heightTiles = (viewportHeight + ((1u << tileSizeLog2) - 1)) >> tileSizeLog2;
+	// -W <= X <= W, -W <= Y <= W, 0 <= Z <= W.
+	for (uint32_t component = 0; component < 4; ++component) {
+		float x = modelToClip[0][component], y = modelToClip[1][component], z = modelToClip[2][component], w = modelToClip[3][component];
+		culler->frustumPlanes[0][component] = w + x;
+		culler->frustumPlanes[1][component] = w - x;
+		culler->frustumPlanes[2][component] = w + y;
+		culler->frustumPlanes[3][component] = w - y;
+		culler->frustumPlanes[4][component] = z;
+		culler->frustumPlanes[5][component] = w - z;
+	}
+	for (uint32_t planeIndex = 0; planeIndex < 6; ++planeIndex) {
+		float * plane = culler->frustumPlanes[planeIndex];
+		float length = HbMeshi_Meshlet_Normalize(plane);
+		if (length > 0.0f) {
+			plane[3] /= length;
+		} else {
+			// The far plane at infinity.
+			plane[3] = 1.0f;
+		}
+	}
+}
+
+HbBool HbMesh_Meshlet_Culler_IsVisible(HbMesh_Meshlet_Culler const * culler, HbMesh_Meshlet const * meshlet) {
+	for (uint32_t planeIndex = 0; planeIndex < 6; ++planeIndex) {
+		float const * plane = culler->frustumPlanes[planeIndex];
+		if (HbMeshi_Meshlet_Dot(plane, meshlet->center) + plane[3] < -meshlet->radius) {
+			return HbFalse;
+		}
+	}
+
+	if (meshlet->coneAxisAndCutoff[3] < INT8_MAX) {
+		float axis[3] = { (float) meshlet->coneAxisAndCutoff[0], (float) meshlet->coneAxisAndCutoff[1], (float) meshlet->coneAxisAndCutoff[2] };
+		HbMeshi_Meshlet_Normalize(axis);
+		float eyeToApex[3] = { meshlet->coneApex[0] - culler->eyePosition[0], meshlet->coneApex[1] - culler->eyePosition[1],
+				meshlet->coneApex[2] - culler->eyePosition[2] };
+		float eyeToApexLength = sqrtf(HbMeshi_Meshlet_Dot(eyeToApex, eyeToApex));
+		if (HbMeshi_Meshlet_Dot(eyeToApex, axis) >= (float) meshlet->coneAxisAndCutoff[3] * (1.0f / 127.0f) * eyeToApexLength) {
+			return HbFalse;
+		}
+	}
+
+	if (culler->tileFarthestDepths != NULL) {
+		// The screen rectangle and the nearest depth of the box around the sphere, which contains the projection of the sphere.
+		float screenMin[2] = { FLT_MAX, FLT_MAX }, screenMax[2] = { -FLT_MAX, -FLT_MAX }, nearestDepth = 0.0f;
+		for (uint32_t cornerIndex = 0; cornerIndex < 8; ++cornerIndex) {
+			float corner[4] = {
+				meshlet->center[0] + ((cornerIndex & 1) ? meshlet->radius : -meshlet->radius),
+				meshlet->center[1] + ((cornerIndex & 2) ? meshlet->radius : -meshlet->radius),
+				meshlet->center[2] + ((cornerIndex & 4) ? meshlet->radius : -meshlet->radius),
+				1.0f,
+			};
+			float clip[4];
+			for (uint32_t row = 0; row < 4; ++row) {
+				float const * matrixRow = culler->modelToClip[row];
+				clip[row] = matrixRow[0] * corner[0] + matrixRow[1] * corner[1] + matrixRow[2] * corner[2] + matrixRow[3];
+			}
+			if (clip[3] <= FLT_EPSILON) {
+				// Crossing the plane of the eye, can't be projected.
+				return HbTrue;
+			}
+			float wInverse = 1.0f / clip[3];
+			float screen[2] = {
+				(clip[0] * wInverse * 0.5f + 0.5f) * (float) culler->viewportWidth,
+				(clip[1] * wInverse * -0.5f + 0.5f) * (float) culler->viewportHeight,
+			};
+			for (uint32_t screenAxis = 0; screenAxis < 2; ++screenAxis) {
+				screenMin[screenAxis] = fminf(screenMin[screenAxis], screen[screenAxis]);
+				screenMax[screenAxis] = fmaxf(screenMax[screenAxis], screen[screenAxis]);
+			}
+			nearestDepth = fmaxf(nearestDepth, clip[2] * wInverse);
+		}
+		float tileSizeInverse = 1.0f / (float) (1u << culler->tileSizeLog2);
+		uint32_t tileMinX = (uint32_t) HbClampF(screenMin[0] * tileSizeInverse, 0.0f, (float) (culler->widthTiles - 1));
+		uint32_t tileMaxX = (uint32_t) HbClampF(screenMax[0] * tileSizeInverse, 0.0f, (float) (culler->widthTiles - 1));
+		uint32_t tileMinY = (uint32_t) HbClampF(screenMin[1] * tileSizeInverse, 0.0f, (float) (culler->heightTiles - 1));
+		uint32_t tileMaxY = (uint32_t) HbClampF(screenMax[1] * tileSizeInverse, 0.0f, (float) (culler->heightTiles - 1));
+		for (uint32_t tileY = tileMinY; tileY <= tileMaxY; ++tileY) {
+			float const * tileRowFarthestDepths = culler->tileFarthestDepths + (size_t) tileY * culler->widthTiles;
+			for (uint32_t tileX = tileMinX; tileX <= tileMaxX; ++tileX) {
+				// Reversed depth - greater is nearer.
+				if (nearestDepth >= tileRowFarthestDepths[tileX]) {
+					return HbTrue;
+				}
+			}
+		}
+		return HbFalse;
+	}
+
+	return HbTrue;
+}
+
+uint32_t HbMesh_Meshlet_Culler_Cull(HbMesh_Meshlet_Culler const * culler, HbMesh_Meshlet const * meshlets, uint32_t meshletCount,
+		uint32_t * visibleIndexes) {
+	uint32_t visibleCount = 0;
+	for (uint32_t meshletIndex = 0; meshletIndex < meshletCount; ++meshletIndex) {
+		if (HbMesh_Meshlet_Culler_IsVisible(culler, &meshlets[meshletIndex])) {
+			visibleIndexes[visibleCount++] = meshletIndex;
+		}
+	}
+	return visibleCount;
+}
@@ -0,0 +1,433 @@
+#include "HbMesh_Geometry.h"
+#include <math.h>
+
+/**************
+ * Cache stats
+ **************/
+
+size_t HbMesh_GetVertexCacheStats_GetScratchSize(uint32_t vertexCount) {
+	return (size_t) vertexCount * sizeof(uint32_t);
+}
+
+void HbMesh_GetVertexCacheStats(uint32_t const * indexes, uint32_t triangleCount, uint32_t vertexCount, uint32_t cacheSize,
+		HbMesh_VertexCacheStats * stats, void * scratch) {
+	// A vertex is in the FIFO if less than cacheSize vertexes have been transformed after it.
+	// Stamps are the transform counts after the vertexes were transformed, 0 for never transformed ones.
+	uint32_t * stamps = (uint32_t *) scratch;
+	memset(stamps, 0, vertexCount * sizeof(uint32_t));
+	uint32_t transformCount = 0, vertexUsedCount = 0;
+	for (uint32_t indexIndex = 0; indexIndex < 3 * triangleCount; ++indexIndex) {
+		uint32_t vertexIndex = indexes[indexIndex];
+		if (stamps[vertexIndex] == 0 || transformCount - stamps[vertexIndex] >= cacheSize) {
+			vertexUsedCount += (stamps[vertexIndex] == 0);
+			stamps[vertexIndex] = ++transformCount;
+		}
+	}
+	stats->transformCount = transformCount;
+	stats->acmr = triangleCount != 0 ? (float) transformCount / (float) triangleCount : 0.0f;
+	stats->atvr = vertexUsedCount != 0 ? (float) transformCount / (float) vertexUsedCount : 0.0f;
+}
+
+/***************
+ * Vertex cache
+ ***************/
+
+// Scoring from Tom Forsyth's "Linear-Speed Vertex Cache Optimisation".
+#define HbMeshi_Forsyth_CacheDecayPower 1.5f
+#define HbMeshi_Forsyth_LastTriangleScore 0.75f
+#define HbMeshi_Forsyth_ValenceBoostScale 2.0f
+#define HbMeshi_Forsyth_ValenceBoostPower 0.5f
+#define HbMeshi_Forsyth_ValenceTableSize 32
+
+typedef struct HbMeshi_Forsyth_Scores {
+	float cachePositions[HbMesh_OptimizeVertexCache_CacheSize];
+	float valences[HbMeshi_Forsyth_ValenceTableSize];
+} HbMeshi_Forsyth_Scores;
+
+static void HbMeshi_Forsyth_Scores_Init(HbMeshi_Forsyth_Scores * scores) {
+	for (uint32_t position = 0; position < HbMesh_OptimizeVertexCache_CacheSize; ++position) {
+		// The vertexes of the last triangle get a fixed score so the same triangle isn't favored over the new ones.
+		scores->cachePositions[position] = position < 3 ? HbMeshi_Forsyth_LastTriangleScore :
+				powf(1.0f - (float) (position - 3) / (float) (HbMesh_OptimizeVertexCache_CacheSize - 3), HbMeshi_Forsyth_CacheDecayPower);
+	}
+	scores->valences[0] = 0.0f;
+	for (uint32_t valence = 1; valence < HbMeshi_Forsyth_ValenceTableSize; ++valence) {
+		scores->valences[valence] = HbMeshi_Forsyth_ValenceBoostScale * powf((float) valence, -HbMeshi_Forsyth_ValenceBoostPower);
+	}
+}
+
+// cachePosition is negative for vertexes not in the cache.
+static float HbMeshi_Forsyth_GetVertexScore(HbMeshi_Forsyth_Scores const * scores, int32_t cachePosition, uint32_t remainingTriangleCount) {
+	if (remainingTriangleCount == 0) {
+		return -1.0f;
+	}
+	// Vertexes with few remaining triangles are boosted so they're finished off instead of being left alone.
+	float score = remainingTriangleCount < HbMeshi_Forsyth_ValenceTableSize ? scores->valences[remainingTriangleCount] :
+			HbMeshi_Forsyth_ValenceBoostScale * powf((float) remainingTriangleCount, -HbMeshi_Forsyth_ValenceBoostPower);
+	if (cachePosition >= 0) {
+		score += scores->cachePositions[cachePosition];
+	}
+	return score;
+}
+
+// Triangles using every vertex (with the ones already added swapped to the end), per-vertex and per-triangle state,
+// and the copy of the source indexes if optimizing in place.
+typedef struct HbMeshi_Forsyth_ScratchLayout {
+	size_t vertexTrianglesFirstOffset;
+	size_t vertexTrianglesOffset;
+	size_t vertexRemainingTriangleCountsOffset;
+	size_t vertexCachePositionsOffset;
+	size_t vertexScoresOffset;
+	size_t triangleScoresOffset;
+	size_t sourceIndexesOffset;
+	size_t size;
+} HbMeshi_Forsyth_ScratchLayout;
+
+static void HbMeshi_Forsyth_ScratchLayout_Init(HbMeshi_Forsyth_ScratchLayout * layout, uint32_t triangleCount, uint32_t vertexCount) {
+	layout->vertexTrianglesFirstOffset = 0;
+	layout->vertexTrianglesOffset = layout->vertexTrianglesFirstOffset + (size_t) vertexCount * sizeof(uint32_t);
+	layout->vertexRemainingTriangleCountsOffset = layout->vertexTrianglesOffset + (size_t) 3 * triangleCount * sizeof(uint32_t);
+	layout->vertexCachePositionsOffset = layout->vertexRemainingTriangleCountsOffset + (size_t) vertexCount * sizeof(uint32_t);
+	layout->vertexScoresOffset = layout->vertexCachePositionsOffset + (size_t) vertexCount * sizeof(int32_t);
+	layout->triangleScoresOffset = layout->vertexScoresOffset + (size_t) vertexCount * sizeof(float);
+	layout->sourceIndexesOffset = layout->triangleScoresOffset + (size_t) triangleCount * sizeof(float);
+	layout->size = layout->sourceIndexesOffset + (size_t) 3 * triangleCount * sizeof(uint32_t);
+}
+
+size_t HbMesh_OptimizeVertexCache_GetScratchSize(uint32_t triangleCount, uint32_t vertexCount) {
+	HbMeshi_Forsyth_ScratchLayout layout;
+	HbMeshi_Forsyth_ScratchLayout_Init(&layout, triangleCount, vertexCount);
+	return layout.size;
+}
+
+void HbMesh_OptimizeVertexCache(uint32_t const * indexes, uint32_t triangleCount, uint32_t vertexCount, uint32_t * target,
+		void * scratch) {
+	if (triangleCount == 0) {
+		return;
+	}
+	HbMeshi_Forsyth_Scores scores;
+	HbMeshi_Forsyth_Scores_Init(&scores);
+
+	HbMeshi_Forsyth_ScratchLayout layout;
+	HbMeshi_Forsyth_ScratchLayout_Init(&layout, triangleCount, vertexCount);
+	uint8_t * memory = (uint8_t *) scratch;
+	uint32_t * vertexTrianglesFirst = (uint32_t *) (memory + layout.vertexTrianglesFirstOffset);
+	uint32_t * vertexTriangles = (uint32_t *) (memory + layout.vertexTrianglesOffset);
+	uint32_t * vertexRemainingTriangleCounts = (uint32_t *) (memory + layout.vertexRemainingTriangleCountsOffset);
+	int32_t * vertexCachePositions = (int32_t *) (memory + layout.vertexCachePositionsOffset);
+	float * vertexScores = (float *) (memory + layout.vertexScoresOffset);
+	float * triangleScores = (float *) (memory + layout.triangleScoresOffset);
+	if (target == indexes) {
+		uint32_t * sourceIndexes = (uint32_t *) (memory + layout.sourceIndexesOffset);
+		memcpy(sourceIndexes, indexes, (size_t) 3 * triangleCount * sizeof(uint32_t));
+		indexes = sourceIndexes;
+	}
+
+	memset(vertexRemainingTriangleCounts, 0, vertexCount * sizeof(uint32_t));
+	for (uint32_t indexIndex = 0; indexIndex < 3 * triangleCount; ++indexIndex) {
+		++vertexRemainingTriangleCounts[indexes[indexIndex]];
+	}
+	uint32_t vertexTrianglesTotal = 0;
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		vertexTrianglesFirst[vertexIndex] = vertexTrianglesTotal;
+		vertexTrianglesTotal += vertexRemainingTriangleCounts[vertexIndex];
+		vertexRemainingTriangleCounts[vertexIndex] = 0;
+	}
+	for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			uint32_t vertexIndex = indexes[3 * triangleIndex + cornerIndex];
+			vertexTriangles[vertexTrianglesFirst[vertexIndex] + vertexRemainingTriangleCounts[vertexIndex]++] = triangleIndex;
+		}
+	}
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		vertexCachePositions[vertexIndex] = -1;
+		vertexScores[vertexIndex] = HbMeshi_Forsyth_GetVertexScore(&scores, -1, vertexRemainingTriangleCounts[vertexIndex]);
+	}
+	uint32_t bestTriangle = 0;
+	float bestTriangleScore = -1.0f;
+	for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		uint32_t const * triangle = indexes + 3 * triangleIndex;
+		float triangleScore = vertexScores[triangle[0]] + vertexScores[triangle[1]] + vertexScores[triangle[2]];
+		triangleScores[triangleIndex] = triangleScore;
+		if (triangleScore > bestTriangleScore) {
+			bestTriangle = triangleIndex;
+			bestTriangleScore = triangleScore;
+		}
+	}
+
+	// The vertexes of the added triangle are put in the front, and up to 3 old ones are pushed out of the back.
+	uint32_t cache[2][HbMesh_OptimizeVertexCache_CacheSize + 3];
+	uint32_t cacheSize = 0, cacheCurrent = 0;
+	uint32_t nextTriangleToScan = 0; // For choosing the next triangle when there are no candidates using the vertexes in the cache.
+	for (uint32_t targetTriangleIndex = 0; targetTriangleIndex < triangleCount; ++targetTriangleIndex) {
+		if (bestTriangle == UINT32_MAX) {
+			// Added triangles have the score of -1 as they're removed from all vertexes.
+			while (triangleScores[nextTriangleToScan] < 0.0f) {
+				++nextTriangleToScan;
+			}
+			bestTriangle = nextTriangleToScan;
+		}
+		uint32_t const * triangle = indexes + 3 * bestTriangle;
+		memcpy(target + 3 * targetTriangleIndex, triangle, 3 * sizeof(uint32_t));
+		triangleScores[bestTriangle] = -1.0f;
+
+		uint32_t const * oldCache = cache[cacheCurrent];
+		uint32_t * newCache = cache[cacheCurrent ^ 1];
+		uint32_t newCacheSize = 0;
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			uint32_t vertexIndex = triangle[cornerIndex];
+			// Removing the triangle from the ones remaining for the vertex.
+			uint32_t * remainingTriangles = vertexTriangles + vertexTrianglesFirst[vertexIndex];
+			uint32_t remainingTriangleCount = vertexRemainingTriangleCounts[vertexIndex];
+			for (uint32_t remainingTriangleIndex = 0; remainingTriangleIndex < remainingTriangleCount; ++remainingTriangleIndex) {
+				if (remainingTriangles[remainingTriangleIndex] == bestTriangle) {
+					remainingTriangles[remainingTriangleIndex] = remainingTriangles[remainingTriangleCount - 1];
+					remainingTriangles[remainingTriangleCount - 1] = bestTriangle;
+					vertexRemainingTriangleCounts[vertexIndex] = remainingTriangleCount - 1;
+					break;
+				}
+			}
+			// Degenerate triangles may have the same vertex in multiple corners.
+			if (vertexCachePositions[vertexIndex] != -2) {
+				vertexCachePositions[vertexIndex] = -2;
+				newCache[newCacheSize++] = vertexIndex;
+			}
+		}
+		for (uint32_t oldCacheIndex = 0; oldCacheIndex < cacheSize; ++oldCacheIndex) {
+			uint32_t vertexIndex = oldCache[oldCacheIndex];
+			if (vertexCachePositions[vertexIndex] != -2) {
+				newCache[newCacheSize++] = vertexIndex;
+			}
+		}
+
+		// Updating the scores of the vertexes that have been in the cache or have been pushed out of it, and of their triangles.
+		for (uint32_t newCacheIndex = 0; newCacheIndex < newCacheSize; ++newCacheIndex) {
+			uint32_t vertexIndex = newCache[newCacheIndex];
+			int32_t cachePosition = newCacheIndex < HbMesh_OptimizeVertexCache_CacheSize ? (int32_t) newCacheIndex : -1;
+			vertexCachePositions[vertexIndex] = cachePosition;
+			vertexScores[vertexIndex] = HbMeshi_Forsyth_GetVertexScore(&scores, cachePosition, vertexRemainingTriangleCounts[vertexIndex]);
+		}
+		bestTriangle = UINT32_MAX;
+		bestTriangleScore = -1.0f;
+		for (uint32_t newCacheIndex = 0; newCacheIndex < newCacheSize; ++newCacheIndex) {
+			uint32_t vertexIndex = newCache[newCacheIndex];
+			uint32_t const * remainingTriangles = vertexTriangles + vertexTrianglesFirst[vertexIndex];
+			uint32_t remainingTriangleCount = vertexRemainingTriangleCounts[vertexIndex];
+			for (uint32_t remainingTriangleIndex = 0; remainingTriangleIndex < remainingTriangleCount; ++remainingTriangleIndex) {
+				uint32_t triangleIndex = remainingTriangles[remainingTriangleIndex];
+				uint32_t const * remainingTriangle = indexes + 3 * triangleIndex;
+				float triangleScore = vertexScores[remainingTriangle[0]] + vertexScores[remainingTriangle[1]] + vertexScores[remainingTriangle[2]];
+				triangleScores[triangleIndex] = triangleScore;
+				if (triangleScore > bestTriangleScore) {
+					bestTriangle = triangleIndex;
+					bestTriangleScore = triangleScore;
+				}
+			}
+		}
+
+		cacheSize = HbMinU32(newCacheSize, HbMesh_OptimizeVertexCache_CacheSize);
+		cacheCurrent ^= 1;
+	}
+}
+
+/***********
+ * Overdraw
+ ***********/
+
+typedef struct HbMeshi_Overdraw_Cluster {
+	uint32_t triangleFirst;
+	uint32_t triangleCount;
+	float sortKey;
+} HbMeshi_Overdraw_Cluster;
+
+static int HbMeshi_Overdraw_CompareClusters(void const * cluster1Pointer, void const * cluster2Pointer) {
+	HbMeshi_Overdraw_Cluster const * cluster1 = (HbMeshi_Overdraw_Cluster const *) cluster1Pointer;
+	HbMeshi_Overdraw_Cluster const * cluster2 = (HbMeshi_Overdraw_Cluster const *) cluster2Pointer;
+	// Outer (facing away from the center) first, keeping the original order otherwise.
+	if (cluster1->sortKey != cluster2->sortKey) {
+		return cluster1->sortKey > cluster2->sortKey ? -1 : 1;
+	}
+	return cluster1->triangleFirst < cluster2->triangleFirst ? -1 : (cluster1->triangleFirst > cluster2->triangleFirst);
+}
+
+// Returns the number of vertexes of the triangle missing in the FIFO cache, updating it.
+static uint32_t HbMeshi_Overdraw_TransformTriangle(uint32_t const * triangle, uint32_t * stamps, uint32_t * transformCount) {
+	uint32_t missCount = 0;
+	for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+		uint32_t vertexIndex = triangle[cornerIndex];
+		if (*transformCount - stamps[vertexIndex] >= HbMesh_OptimizeOverdraw_CacheSize) {
+			stamps[vertexIndex] = ++*transformCount;
+			++missCount;
+		}
+	}
+	return missCount;
+}
+
+// The normal is not normalized, with the length of twice the area.
+static void HbMeshi_Overdraw_GetTriangleGeometry(uint32_t const * triangle, float const * positions, size_t positionStride,
+		double normal[3], double centroid[3]) {
+	float const * p0 = (float const *) ((uint8_t const *) positions + triangle[0] * positionStride);
+	float const * p1 = (float const *) ((uint8_t const *) positions + triangle[1] * positionStride);
+	float const * p2 = (float const *) ((uint8_t const *) positions + triangle[2] * positionStride);
+	double e1[3] = { (double) p1[0] - p0[0], (double) p1[1] - p0[1], (double) p1[2] - p0[2] };
+	double e2[3] = { (double) p2[0] - p0[0], (double) p2[1] - p0[1], (double) p2[2] - p0[2] };
+	normal[0] = e1[1] * e2[2] - e1[2] * e2[1];
+	normal[1] = e1[2] * e2[0] - e1[0] * e2[2];
+	normal[2] = e1[0] * e2[1] - e1[1] * e2[0];
+	for (uint32_t axis = 0; axis < 3; ++axis) {
+		centroid[axis] = ((double) p0[axis] + (double) p1[axis] + (double) p2[axis]) * (1.0 / 3.0);
+	}
+}
+
+// Clusters are 4-aligned like the rest of the arrays.
+static size_t HbMeshi_Overdraw_GetClustersOffset(uint32_t vertexCount) {
+	return (size_t) vertexCount * sizeof(uint32_t);
+}
+
+static size_t HbMeshi_Overdraw_GetSourceIndexesOffset(uint32_t triangleCount, uint32_t vertexCount) {
+	return HbMeshi_Overdraw_GetClustersOffset(vertexCount) + (size_t) triangleCount * sizeof(HbMeshi_Overdraw_Cluster);
+}
+
+size_t HbMesh_OptimizeOverdraw_GetScratchSize(uint32_t triangleCount, uint32_t vertexCount) {
+	return HbMeshi_Overdraw_GetSourceIndexesOffset(triangleCount, vertexCount) + (size_t) 3 * triangleCount * sizeof(uint32_t);
+}
+
+void HbMesh_OptimizeOverdraw(uint32_t * indexes, uint32_t triangleCount, float const * positions, size_t positionStride, uint32_t vertexCount,
+		float threshold, void * scratch) {
+	if (triangleCount == 0) {
+		return;
+	}
+
+	uint8_t * memory = (uint8_t *) scratch;
+	uint32_t * stamps = (uint32_t *) memory;
+	HbMeshi_Overdraw_Cluster * clusters = (HbMeshi_Overdraw_Cluster *) (memory + HbMeshi_Overdraw_GetClustersOffset(vertexCount));
+	uint32_t * sourceIndexes = (uint32_t *) (memory + HbMeshi_Overdraw_GetSourceIndexesOffset(triangleCount, vertexCount));
+	memcpy(sourceIndexes, indexes, (size_t) 3 * triangleCount * sizeof(uint32_t));
+
+	// Hard boundaries - where all vertexes of a triangle miss the cache, so the triangles before can be moved without losing anything.
+	// The stamps start far enough in the past for the cache to be empty.
+	uint32_t transformCount = HbMesh_OptimizeOverdraw_CacheSize;
+	memset(stamps, 0, vertexCount * sizeof(uint32_t));
+	uint32_t clusterCount = 0;
+	for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		if (HbMeshi_Overdraw_TransformTriangle(sourceIndexes + 3 * triangleIndex, stamps, &transformCount) == 3 || triangleIndex == 0) {
+			clusters[clusterCount].triangleFirst = triangleIndex;
+			clusters[clusterCount].triangleCount = 0;
+			++clusterCount;
+		}
+		++clusters[clusterCount - 1].triangleCount;
+	}
+
+	// Soft boundaries - where the part of the cluster since the last split, simulated with the cache empty at the split,
+	// is efficient enough already. The first part stays in place of the hard cluster, the rest are appended.
+	uint32_t hardClusterCount = clusterCount;
+	for (uint32_t hardClusterIndex = 0; hardClusterIndex < hardClusterCount; ++hardClusterIndex) {
+		uint32_t clusterTriangleFirst = clusters[hardClusterIndex].triangleFirst;
+		uint32_t clusterTriangleEnd = clusterTriangleFirst + clusters[hardClusterIndex].triangleCount;
+		uint32_t clusterTransformCount = 0;
+		transformCount += HbMesh_OptimizeOverdraw_CacheSize;
+		for (uint32_t triangleIndex = clusterTriangleFirst; triangleIndex < clusterTriangleEnd; ++triangleIndex) {
+			clusterTransformCount += HbMeshi_Overdraw_TransformTriangle(sourceIndexes + 3 * triangleIndex, stamps, &transformCount);
+		}
+		float targetACMR = threshold * (float) clusterTransformCount / (float) (clusterTriangleEnd - clusterTriangleFirst);
+		uint32_t partTriangleFirst = clusterTriangleFirst, partTransformCount = 0;
+		transformCount += HbMesh_OptimizeOverdraw_CacheSize;
+		for (uint32_t triangleIndex = clusterTriangleFirst; triangleIndex < clusterTriangleEnd; ++triangleIndex) {
+			partTransformCount += HbMeshi_Overdraw_TransformTriangle(sourceIndexes + 3 * triangleIndex, stamps, &transformCount);
+			if (triangleIndex + 1 < clusterTriangleEnd &&
+					(float) partTransformCount <= targetACMR * (float) (triangleIndex + 1 - partTriangleFirst)) {
+				if (partTriangleFirst == clusterTriangleFirst) {
+					clusters[hardClusterIndex].triangleCount = triangleIndex + 1 - partTriangleFirst;
+				} else {
+					clusters[clusterCount].triangleFirst = partTriangleFirst;
+					clusters[clusterCount].triangleCount = triangleIndex + 1 - partTriangleFirst;
+					++clusterCount;
+				}
+				partTriangleFirst = triangleIndex + 1;
+				partTransformCount = 0;
+				transformCount += HbMesh_OptimizeOverdraw_CacheSize;
+			}
+		}
+		if (partTriangleFirst != clusterTriangleFirst) {
+			clusters[clusterCount].triangleFirst = partTriangleFirst;
+			clusters[clusterCount].triangleCount = clusterTriangleEnd - partTriangleFirst;
+			++clusterCount;
+		}
+	}
+
+	// The center of the mesh, with the triangles weighted by their areas.
+	double meshCentroid[3] = { 0.0, 0.0, 0.0 }, meshArea = 0.0;
+	for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		double normal[3], centroid[3];
+		HbMeshi_Overdraw_GetTriangleGeometry(sourceIndexes + 3 * triangleIndex, positions, positionStride, normal, centroid);
+		double area = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+		for (uint32_t axis = 0; axis < 3; ++axis) {
+			meshCentroid[axis] += area * centroid[axis];
+		}
+		meshArea += area;
+	}
+	if (meshArea > 0.0) {
+		for (uint32_t axis = 0; axis < 3; ++axis) {
+			meshCentroid[axis] /= meshArea;
+		}
+	}
+
+	// Sorting by how much the clusters face away from the center, with their centroids and normals also weighted by the areas.
+	for (uint32_t clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex) {
+		HbMeshi_Overdraw_Cluster * cluster = &clusters[clusterIndex];
+		double clusterNormal[3] = { 0.0, 0.0, 0.0 }, clusterCentroid[3] = { 0.0, 0.0, 0.0 }, clusterArea = 0.0;
+		for (uint32_t triangleIndex = cluster->triangleFirst; triangleIndex < cluster->triangleFirst + cluster->triangleCount; ++triangleIndex) {
+			double normal[3], centroid[3];
+			HbMeshi_Overdraw_GetTriangleGeometry(sourceIndexes + 3 * triangleIndex, positions, positionStride, normal, centroid);
+			double area = sqrt(normal[0] * normal[0] + normal[1] * normal[1] + normal[2] * normal[2]);
+			for (uint32_t axis = 0; axis < 3; ++axis) {
+				clusterNormal[axis] += normal[axis];
+				clusterCentroid[axis] += area * centroid[axis];
+			}
+			clusterArea += area;
+		}
+		double clusterNormalLength = sqrt(clusterNormal[0] * clusterNormal[0] + clusterNormal[1] * clusterNormal[1] +
+				clusterNormal[2] * clusterNormal[2]);
+		double sortKey = 0.0;
+		if (clusterArea > 0.0 && clusterNormalLength > 0.0) {
+			for (uint32_t axis = 0; axis < 3; ++axis) {
+				sortKey += (clusterCentroid[axis] / clusterArea - meshCentroid[axis]) * clusterNormal[axis];
+			}
+			sortKey /= clusterNormalLength;
+		}
+		cluster->sortKey = (float) sortKey;
+	}
+	qsort(clusters, clusterCount, sizeof(HbMeshi_Overdraw_Cluster), HbMeshi_Overdraw_CompareClusters);
+
+	uint32_t * targetIndexes = indexes;
+	for (uint32_t clusterIndex = 0; clusterIndex < clusterCount; ++clusterIndex) {
+		HbMeshi_Overdraw_Cluster const * cluster = &clusters[clusterIndex];
+		memcpy(targetIndexes, sourceIndexes + 3 * cluster->triangleFirst, (size_t) 3 * cluster->triangleCount * sizeof(uint32_t));
+		targetIndexes += 3 * cluster->triangleCount;
+	}
+}
+
+/***************
+ * Vertex fetch
+ ***************/
+
+uint32_t HbMesh_OptimizeVertexFetch(uint32_t * indexes, uint32_t triangleCount, uint32_t vertexCount, uint32_t * remap) {
+	memset(remap, 0xFF, vertexCount * sizeof(uint32_t));
+	uint32_t newVertexCount = 0;
+	for (uint32_t indexIndex = 0; indexIndex < 3 * triangleCount; ++indexIndex) {
+		uint32_t * index = &indexes[indexIndex];
+		if (remap[*index] == UINT32_MAX) {
+			remap[*index] = newVertexCount++;
+		}
+		*index = remap[*index];
+	}
+	return newVertexCount;
+}
+
+void HbMesh_RemapVertexes(void const * source, uint32_t vertexCount, size_t vertexSize, uint32_t const * remap, void * target) {
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		if (remap[vertexIndex] != UINT32_MAX) {
+			memcpy((uint8_t *) target + remap[vertexIndex] * vertexSize, (uint8_t const *) source + vertexIndex * vertexSize, vertexSize);
+		}
+	}
+}
@@ -0,0 +1,696 @@
+#include "HbFeedback.h"
+#include "HbHash.h"
+#include "HbMesh.h"
+#include <float.h>
+#include <math.h>
+
+/***********
+ * Quadrics
+ ***********/
+
+// Squared distance to planes, or squared deviation of linearly interpolated attributes, as p^T * a * p + 2 * b.p + c,
+// summed with the weights (areas) of the planes and triangles, so the error is the sum divided by the weight.
+typedef struct HbMeshi_Simplify_Quadric {
+	float a00, a11, a22, a10, a20, a21;
+	float b0, b1, b2;
+	float c;
+	float weight;
+} HbMeshi_Simplify_Quadric;
+
+// The attribute part of the attribute quadric of a vertex - with the value of the attribute being v, it adds 2 * v * (g.p + d) + v^2 * weight.
+typedef struct HbMeshi_Simplify_AttributeGradient {
+	float g[3];
+	float d;
+} HbMeshi_Simplify_AttributeGradient;
+
+static void HbMeshi_Simplify_Quadric_Add(HbMeshi_Simplify_Quadric * quadric, HbMeshi_Simplify_Quadric const * addend) {
+	quadric->a00 += addend->a00;
+	quadric->a11 += addend->a11;
+	quadric->a22 += addend->a22;
+	quadric->a10 += addend->a10;
+	quadric->a20 += addend->a20;
+	quadric->a21 += addend->a21;
+	quadric->b0 += addend->b0;
+	quadric->b1 += addend->b1;
+	quadric->b2 += addend->b2;
+	quadric->c += addend->c;
+	quadric->weight += addend->weight;
+}
+
+// (n.p + d)^2 * weight, or, for attributes, (g.p + d - v)^2 * weight without the terms with v.
+static void HbMeshi_Simplify_Quadric_AddLinear(HbMeshi_Simplify_Quadric * quadric, float const n[3], float d, float weight) {
+	quadric->a00 += weight * n[0] * n[0];
+	quadric->a11 += weight * n[1] * n[1];
+	quadric->a22 += weight * n[2] * n[2];
+	quadric->a10 += weight * n[1] * n[0];
+	quadric->a20 += weight * n[2] * n[0];
+	quadric->a21 += weight * n[2] * n[1];
+	quadric->b0 += weight * n[0] * d;
+	quadric->b1 += weight * n[1] * d;
+	quadric->b2 += weight * n[2] * d;
+	quadric->c += weight * d * d;
+}
+
+// Not divided by the weight.
+static float HbMeshi_Simplify_Quadric_Evaluate(HbMeshi_Simplify_Quadric const * quadric, float const p[3]) {
+	float ap0 = quadric->a00 * p[0] + quadric->a10 * p[1] + quadric->a20 * p[2];
+	float ap1 = quadric->a10 * p[0] + quadric->a11 * p[1] + quadric->a21 * p[2];
+	float ap2 = quadric->a20 * p[0] + quadric->a21 * p[1] + quadric->a22 * p[2];
+	return p[0] * ap0 + p[1] * ap1 + p[2] * ap2 + 2.0f * (quadric->b0 * p[0] + quadric->b1 * p[1] + quadric->b2 * p[2]) + quadric->c;
+}
+
+/*****************
+ * Mesh structure
+ *****************/
+
+typedef enum HbMeshi_Simplify_Kind {
+	HbMeshi_Simplify_Kind_Unused,
+	HbMeshi_Simplify_Kind_Manifold, // Can be collapsed into any neighbor.
+	HbMeshi_Simplify_Kind_Border, // Can be collapsed only along the open edges.
+	HbMeshi_Simplify_Kind_Seam, // Two wedges (vertexes at the same position), can be collapsed only along the seam edges.
+	HbMeshi_Simplify_Kind_Locked,
+} HbMeshi_Simplify_Kind;
+
+typedef struct HbMeshi_Simplify_Collapse {
+	uint32_t source; // Position representative vertexes.
+	uint32_t target;
+	float error; // Of the position and the attributes, for ordering.
+	float positionError;
+} HbMeshi_Simplify_Collapse;
+
+#define HbMeshi_Simplify_EdgeWeight 10.0f
+
+typedef struct HbMeshi_Simplify_State {
+	uint32_t vertexCount;
+	uint32_t attributeCount;
+	uint32_t * indexes;
+	uint32_t triangleCount;
+	float * positions; // Normalized to the extent, 3 per vertex.
+	float * attributes; // attributeCount per vertex, multiplied by the weights.
+	// Vertexes at the same position are linked in circular lists of wedges, with the position representative being the first of them.
+	uint32_t * positionRepresentatives;
+	uint32_t * wedgeNext;
+	uint8_t * kinds; // HbMeshi_Simplify_Kind of the position representatives.
+	// Triangles using the vertexes.
+	uint32_t * vertexTrianglesFirst;
+	uint32_t * vertexTriangleCounts;
+	uint32_t * vertexTriangles;
+	HbMeshi_Simplify_Quadric * positionQuadrics; // Of the position representatives.
+	HbMeshi_Simplify_Quadric * attributeQuadrics; // Of all wedges.
+	HbMeshi_Simplify_AttributeGradient * attributeGradients; // attributeCount per wedge.
+	HbBool * collapseTouched; // For the position representatives, in the current pass.
+	uint32_t * collapseRemap;
+} HbMeshi_Simplify_State;
+
+static void HbMeshi_Simplify_BuildTriangleAdjacency(HbMeshi_Simplify_State * state) {
+	uint32_t vertexCount = state->vertexCount;
+	memset(state->vertexTriangleCounts, 0, vertexCount * sizeof(uint32_t));
+	for (uint32_t indexIndex = 0; indexIndex < 3 * state->triangleCount; ++indexIndex) {
+		++state->vertexTriangleCounts[state->indexes[indexIndex]];
+	}
+	uint32_t vertexTrianglesTotal = 0;
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		state->vertexTrianglesFirst[vertexIndex] = vertexTrianglesTotal;
+		vertexTrianglesTotal += state->vertexTriangleCounts[vertexIndex];
+		state->vertexTriangleCounts[vertexIndex] = 0;
+	}
+	for (uint32_t triangleIndex = 0; triangleIndex < state->triangleCount; ++triangleIndex) {
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			uint32_t vertexIndex = state->indexes[3 * triangleIndex + cornerIndex];
+			state->vertexTriangles[state->vertexTrianglesFirst[vertexIndex] + state->vertexTriangleCounts[vertexIndex]++] = triangleIndex;
+		}
+	}
+}
+
+// The index of the corner of the triangle with the vertex, which must be in the triangle.
+HbForceInline uint32_t HbMeshi_Simplify_GetCorner(uint32_t const * triangle, uint32_t vertexIndex) {
+	return triangle[0] == vertexIndex ? 0 : (triangle[1] == vertexIndex ? 1 : 2);
+}
+
+// Whether there's a triangle with the directed edge from one vertex to another.
+static HbBool HbMeshi_Simplify_HasEdge(HbMeshi_Simplify_State const * state, uint32_t from, uint32_t to) {
+	uint32_t const * vertexTriangles = state->vertexTriangles + state->vertexTrianglesFirst[from];
+	for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < state->vertexTriangleCounts[from]; ++vertexTriangleIndex) {
+		uint32_t const * triangle = state->indexes + 3 * vertexTriangles[vertexTriangleIndex];
+		if (triangle[(HbMeshi_Simplify_GetCorner(triangle, from) + 1) % 3] == to) {
+			return HbTrue;
+		}
+	}
+	return HbFalse;
+}
+
+// The number of triangles with the directed edge between positions (of any wedges).
+static uint32_t HbMeshi_Simplify_CountPositionEdges(HbMeshi_Simplify_State const * state, uint32_t fromRepresentative, uint32_t toRepresentative) {
+	uint32_t edgeCount = 0;
+	uint32_t wedge = fromRepresentative;
+	do {
+		uint32_t const * vertexTriangles = state->vertexTriangles + state->vertexTrianglesFirst[wedge];
+		for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < state->vertexTriangleCounts[wedge]; ++vertexTriangleIndex) {
+			uint32_t const * triangle = state->indexes + 3 * vertexTriangles[vertexTriangleIndex];
+			uint32_t next = triangle[(HbMeshi_Simplify_GetCorner(triangle, wedge) + 1) % 3];
+			edgeCount += (state->positionRepresentatives[next] == toRepresentative);
+		}
+		wedge = state->wedgeNext[wedge];
+	} while (wedge != fromRepresentative);
+	return edgeCount;
+}
+
+static void HbMeshi_Simplify_ClassifyVertexes(HbMeshi_Simplify_State * state) {
+	for (uint32_t vertexIndex = 0; vertexIndex < state->vertexCount; ++vertexIndex) {
+		if (state->positionRepresentatives[vertexIndex] != vertexIndex) {
+			continue;
+		}
+		uint32_t wedgeCount = 0, positionOpenEdgeCount = 0;
+		HbBool nonManifold = HbFalse, wedgesHaveTwoOpenEdges = HbTrue;
+		uint32_t wedge = vertexIndex;
+		do {
+			if (state->vertexTriangleCounts[wedge] != 0) {
+				++wedgeCount;
+				uint32_t wedgeOpenEdgeCount = 0;
+				uint32_t const * vertexTriangles = state->vertexTriangles + state->vertexTrianglesFirst[wedge];
+				for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < state->vertexTriangleCounts[wedge]; ++vertexTriangleIndex) {
+					uint32_t const * triangle = state->indexes + 3 * vertexTriangles[vertexTriangleIndex];
+					uint32_t corner = HbMeshi_Simplify_GetCorner(triangle, wedge);
+					uint32_t next = triangle[(corner + 1) % 3], previous = triangle[(corner + 2) % 3];
+					wedgeOpenEdgeCount += !HbMeshi_Simplify_HasEdge(state, next, wedge);
+					wedgeOpenEdgeCount += !HbMeshi_Simplify_HasEdge(state, wedge, previous);
+					uint32_t nextRepresentative = state->positionRepresentatives[next];
+					uint32_t previousRepresentative = state->positionRepresentatives[previous];
+					if (nextRepresentative == vertexIndex || previousRepresentative == vertexIndex ||
+							HbMeshi_Simplify_CountPositionEdges(state, vertexIndex, nextRepresentative) != 1) {
+						nonManifold = HbTrue;
+					}
+					positionOpenEdgeCount += (HbMeshi_Simplify_CountPositionEdges(state, nextRepresentative, vertexIndex) == 0);
+					positionOpenEdgeCount += (HbMeshi_Simplify_CountPositionEdges(state, vertexIndex, previousRepresentative) == 0);
+				}
+				if (wedgeOpenEdgeCount != 2) {
+					wedgesHaveTwoOpenEdges = HbFalse;
+				}
+			}
+			wedge = state->wedgeNext[wedge];
+		} while (wedge != vertexIndex);
+		HbMeshi_Simplify_Kind kind = HbMeshi_Simplify_Kind_Locked;
+		if (wedgeCount == 0) {
+			kind = HbMeshi_Simplify_Kind_Unused;
+		} else if (!nonManifold) {
+			if (wedgeCount == 1) {
+				if (positionOpenEdgeCount == 0) {
+					kind = HbMeshi_Simplify_Kind_Manifold;
+				} else if (positionOpenEdgeCount == 2) {
+					kind = HbMeshi_Simplify_Kind_Border;
+				}
+			} else if (wedgeCount == 2 && positionOpenEdgeCount == 0 && wedgesHaveTwoOpenEdges) {
+				kind = HbMeshi_Simplify_Kind_Seam;
+			}
+		}
+		state->kinds[vertexIndex] = (uint8_t) kind;
+	}
+}
+
+/************
+ * Collapses
+ ************/
+
+// Finds the wedges of the target position the wedges of the source are collapsed into, returns HbFalse if the collapse isn't allowed.
+static HbBool HbMeshi_Simplify_GetCollapseWedges(HbMeshi_Simplify_State const * state, uint32_t source, uint32_t target,
+		uint32_t sourceWedges[2], uint32_t targetWedges[2], uint32_t * wedgeCount) {
+	HbMeshi_Simplify_Kind sourceKind = (HbMeshi_Simplify_Kind) state->kinds[source];
+	HbMeshi_Simplify_Kind targetKind = (HbMeshi_Simplify_Kind) state->kinds[target];
+	switch (sourceKind) {
+	case HbMeshi_Simplify_Kind_Manifold:
+		break;
+	case HbMeshi_Simplify_Kind_Border:
+		if ((targetKind != HbMeshi_Simplify_Kind_Border && targetKind != HbMeshi_Simplify_Kind_Locked) ||
+				HbMeshi_Simplify_CountPositionEdges(state, source, target) + HbMeshi_Simplify_CountPositionEdges(state, target, source) != 1) {
+			return HbFalse;
+		}
+		break;
+	case HbMeshi_Simplify_Kind_Seam:
+		if (targetKind != HbMeshi_Simplify_Kind_Seam && targetKind != HbMeshi_Simplify_Kind_Locked) {
+			return HbFalse;
+		}
+		break;
+	default:
+		return HbFalse;
+	}
+	// Every wedge must be connected to exactly one wedge of the target, and seam wedges to different ones.
+	*wedgeCount = 0;
+	uint32_t wedge = source;
+	do {
+		if (state->vertexTriangleCounts[wedge] != 0) {
+			uint32_t targetWedge = UINT32_MAX;
+			uint32_t const * vertexTriangles = state->vertexTriangles + state->vertexTrianglesFirst[wedge];
+			for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < state->vertexTriangleCounts[wedge]; ++vertexTriangleIndex) {
+				uint32_t const * triangle = state->indexes + 3 * vertexTriangles[vertexTriangleIndex];
+				for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+					uint32_t cornerVertex = triangle[cornerIndex];
+					if (state->positionRepresentatives[cornerVertex] == target) {
+						if (targetWedge != UINT32_MAX && targetWedge != cornerVertex) {
+							return HbFalse;
+						}
+						targetWedge = cornerVertex;
+					}
+				}
+			}
+			if (targetWedge == UINT32_MAX) {
+				return HbFalse;
+			}
+			sourceWedges[*wedgeCount] = wedge;
+			targetWedges[*wedgeCount] = targetWedge;
+			++*wedgeCount;
+		}
+		wedge = state->wedgeNext[wedge];
+	} while (wedge != source);
+	return *wedgeCount != 2 || targetWedges[0] != targetWedges[1];
+}
+
+// Returns the sum of the position and the attribute errors, with the position error written separately.
+static float HbMeshi_Simplify_GetCollapseError(HbMeshi_Simplify_State const * state, uint32_t source, uint32_t target,
+		uint32_t const sourceWedges[2], uint32_t const targetWedges[2], uint32_t wedgeCount, float * positionError) {
+	float const * targetPosition = state->positions + 3 * target;
+	HbMeshi_Simplify_Quadric const * positionQuadric = &state->positionQuadrics[source];
+	// Rounding may make the errors slightly negative.
+	*positionError = positionQuadric->weight > 0.0f ?
+			fmaxf(HbMeshi_Simplify_Quadric_Evaluate(positionQuadric, targetPosition) / positionQuadric->weight, 0.0f) : 0.0f;
+	float error = *positionError;
+	if (state->attributeCount != 0) {
+		for (uint32_t wedgeIndex = 0; wedgeIndex < wedgeCount; ++wedgeIndex) {
+			HbMeshi_Simplify_Quadric const * attributeQuadric = &state->attributeQuadrics[sourceWedges[wedgeIndex]];
+			if (attributeQuadric->weight <= 0.0f) {
+				continue;
+			}
+			float attributeError = HbMeshi_Simplify_Quadric_Evaluate(attributeQuadric, targetPosition);
+			HbMeshi_Simplify_AttributeGradient const * gradients = state->attributeGradients + state->attributeCount * sourceWedges[wedgeIndex];
+			float const * targetAttributes = state->attributes + state->attributeCount * targetWedges[wedgeIndex];
+			for (uint32_t attributeIndex = 0; attributeIndex < state->attributeCount; ++attributeIndex) {
+				HbMeshi_Simplify_AttributeGradient const * gradient = &gradients[attributeIndex];
+				float value = targetAttributes[attributeIndex];
+				attributeError += 2.0f * value * (gradient->g[0] * targetPosition[0] + gradient->g[1] * targetPosition[1] +
+						gradient->g[2] * targetPosition[2] + gradient->d) + value * value * attributeQuadric->weight;
+			}
+			error += attributeError / attributeQuadric->weight;
+		}
+	}
+	return fmaxf(error, 0.0f);
+}
+
+// Whether moving the source to the target would flip any of the remaining triangles.
+static HbBool HbMeshi_Simplify_HasTriangleFlips(HbMeshi_Simplify_State const * state, uint32_t source, uint32_t target) {
+	float const * targetPosition = state->positions + 3 * target;
+	uint32_t wedge = source;
+	do {
+		uint32_t const * vertexTriangles = state->vertexTriangles + state->vertexTrianglesFirst[wedge];
+		for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < state->vertexTriangleCounts[wedge]; ++vertexTriangleIndex) {
+			uint32_t const * triangle = state->indexes + 3 * vertexTriangles[vertexTriangleIndex];
+			uint32_t corner = HbMeshi_Simplify_GetCorner(triangle, wedge);
+			uint32_t next = state->positionRepresentatives[triangle[(corner + 1) % 3]];
+			uint32_t previous = state->positionRepresentatives[triangle[(corner + 2) % 3]];
+			if (next == target || previous == target) {
+				// Removed by the collapse.
+				continue;
+			}
+			float const * p0 = state->positions + 3 * source;
+			float const * p1 = state->positions + 3 * next;
+			float const * p2 = state->positions + 3 * previous;
+			float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] }, e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+			float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+			float newE1[3] = { p1[0] - targetPosition[0], p1[1] - targetPosition[1], p1[2] - targetPosition[2] };
+			float newE2[3] = { p2[0] - targetPosition[0], p2[1] - targetPosition[1], p2[2] - targetPosition[2] };
+			float newN[3] = { newE1[1] * newE2[2] - newE1[2] * newE2[1], newE1[2] * newE2[0] - newE1[0] * newE2[2],
+					newE1[0] * newE2[1] - newE1[1] * newE2[0] };
+			if (n[0] * newN[0] + n[1] * newN[1] + n[2] * newN[2] <= 0.0f) {
+				return HbTrue;
+			}
+		}
+		wedge = state->wedgeNext[wedge];
+	} while (wedge != source);
+	return HbFalse;
+}
+
+static int HbMeshi_Simplify_CompareCollapses(void const * collapse1Pointer, void const * collapse2Pointer) {
+	HbMeshi_Simplify_Collapse const * collapse1 = (HbMeshi_Simplify_Collapse const *) collapse1Pointer;
+	HbMeshi_Simplify_Collapse const * collapse2 = (HbMeshi_Simplify_Collapse const *) collapse2Pointer;
+	if (collapse1->error != collapse2->error) {
+		return collapse1->error < collapse2->error ? -1 : 1;
+	}
+	return collapse1->source < collapse2->source ? -1 : (collapse1->source > collapse2->source);
+}
+
+/*****************
+ * Simplification
+ *****************/
+
+uint32_t HbMesh_Simplify(uint32_t const * indexes, uint32_t triangleCount, HbMesh_Simplify_Vertexes const * vertexes,
+		uint32_t targetTriangleCount, float maxError, uint32_t * target, float * geometricError, float * attributeError, HbMemory_Tag * tag) {
+	uint32_t vertexCount = vertexes->vertexCount, attributeCount = vertexes->attributeCount;
+	if (attributeCount > HbMesh_Simplify_MaxAttributes) {
+		HbFeedback_Crash("HbMesh_Simplify", "%u attributes specified, but up to %u are supported.", attributeCount, HbMesh_Simplify_MaxAttributes);
+	}
+	if (geometricError != NULL) {
+		*geometricError = 0.0f;
+	}
+	if (attributeError != NULL) {
+		*attributeError = 0.0f;
+	}
+	if (triangleCount <= targetTriangleCount || vertexCount == 0) {
+		memmove(target, indexes, (size_t) 3 * triangleCount * sizeof(uint32_t));
+		return triangleCount;
+	}
+
+	HbMeshi_Simplify_State state;
+	state.vertexCount = vertexCount;
+	state.attributeCount = attributeCount;
+	state.triangleCount = triangleCount;
+	state.indexes = (uint32_t *) HbMemory_Alloc(tag, (size_t) 3 * triangleCount * sizeof(uint32_t), HbFalse);
+	memcpy(state.indexes, indexes, (size_t) 3 * triangleCount * sizeof(uint32_t));
+	state.positions = (float *) HbMemory_Alloc(tag, (size_t) 3 * vertexCount * sizeof(float), HbFalse);
+	state.attributes = attributeCount != 0 ?
+			(float *) HbMemory_Alloc(tag, (size_t) attributeCount * vertexCount * sizeof(float), HbFalse) : NULL;
+	state.positionRepresentatives = (uint32_t *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(uint32_t), HbFalse);
+	state.wedgeNext = (uint32_t *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(uint32_t), HbFalse);
+	state.kinds = (uint8_t *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(uint8_t), HbFalse);
+	state.vertexTrianglesFirst = (uint32_t *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(uint32_t), HbFalse);
+	state.vertexTriangleCounts = (uint32_t *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(uint32_t), HbFalse);
+	state.vertexTriangles = (uint32_t *) HbMemory_Alloc(tag, (size_t) 3 * triangleCount * sizeof(uint32_t), HbFalse);
+	state.positionQuadrics = (HbMeshi_Simplify_Quadric *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(HbMeshi_Simplify_Quadric), HbFalse);
+	state.attributeQuadrics = attributeCount != 0 ?
+			(HbMeshi_Simplify_Quadric *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(HbMeshi_Simplify_Quadric), HbFalse) : NULL;
+	state.attributeGradients = attributeCount != 0 ? (HbMeshi_Simplify_AttributeGradient *) HbMemory_Alloc(tag,
+			(size_t) attributeCount * vertexCount * sizeof(HbMeshi_Simplify_AttributeGradient), HbFalse) : NULL;
+	state.collapseTouched = (HbBool *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(HbBool), HbFalse);
+	state.collapseRemap = (uint32_t *) HbMemory_Alloc(tag, (size_t) vertexCount * sizeof(uint32_t), HbFalse);
+	HbMeshi_Simplify_Collapse * collapses = (HbMeshi_Simplify_Collapse *) HbMemory_Alloc(tag,
+			(size_t) vertexCount * sizeof(HbMeshi_Simplify_Collapse), HbFalse);
+
+	// Positions normalized to the extent, so errors don't depend on the scale of the model.
+	float positionMins[3] = { FLT_MAX, FLT_MAX, FLT_MAX }, positionMaxs[3] = { -FLT_MAX, -FLT_MAX, -FLT_MAX };
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		float const * position = (float const *) ((uint8_t const *) vertexes->positions + vertexIndex * vertexes->positionStride);
+		for (uint32_t axis = 0; axis < 3; ++axis) {
+			positionMins[axis] = fminf(positionMins[axis], position[axis]);
+			positionMaxs[axis] = fmaxf(positionMaxs[axis], position[axis]);
+		}
+	}
+	float extent = fmaxf(fmaxf(positionMaxs[0] - positionMins[0], positionMaxs[1] - positionMins[1]), positionMaxs[2] - positionMins[2]);
+	float extentInverse = extent > 0.0f ? 1.0f / extent : 0.0f;
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		float const * position = (float const *) ((uint8_t const *) vertexes->positions + vertexIndex * vertexes->positionStride);
+		for (uint32_t axis = 0; axis < 3; ++axis) {
+			state.positions[3 * vertexIndex + axis] = (position[axis] - positionMins[axis]) * extentInverse;
+		}
+		if (attributeCount != 0) {
+			float const * attributes = (float const *) ((uint8_t const *) vertexes->attributes + vertexIndex * vertexes->attributeStride);
+			for (uint32_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex) {
+				state.attributes[attributeCount * vertexIndex + attributeIndex] = attributes[attributeIndex] * vertexes->attributeWeights[attributeIndex];
+			}
+		}
+	}
+
+	// Welding of the wedges by their original positions.
+	uint32_t hashMapSize = 1;
+	while (hashMapSize < vertexCount + (vertexCount >> 1)) {
+		hashMapSize <<= 1;
+	}
+	uint32_t * hashMap = (uint32_t *) HbMemory_Alloc(tag, (size_t) hashMapSize * sizeof(uint32_t), HbFalse);
+	memset(hashMap, 0xFF, (size_t) hashMapSize * sizeof(uint32_t));
+	for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+		uint8_t const * position = (uint8_t const *) vertexes->positions + vertexIndex * vertexes->positionStride;
+		uint32_t hash = HbHash_FNV1a_Basis;
+		for (uint32_t byteIndex = 0; byteIndex < 3 * sizeof(float); ++byteIndex) {
+			hash = HbHash_FNV1a_HashByte(hash, position[byteIndex]);
+		}
+		uint32_t bucket = hash & (hashMapSize - 1);
+		while (hashMap[bucket] != UINT32_MAX && memcmp((uint8_t const *) vertexes->positions + hashMap[bucket] * vertexes->positionStride,
+				position, 3 * sizeof(float)) != 0) {
+			bucket = (bucket + 1) & (hashMapSize - 1);
+		}
+		if (hashMap[bucket] == UINT32_MAX) {
+			hashMap[bucket] = vertexIndex;
+			state.positionRepresentatives[vertexIndex] = vertexIndex;
+			state.wedgeNext[vertexIndex] = vertexIndex;
+		} else {
+			uint32_t representative = hashMap[bucket];
+			state.positionRepresentatives[vertexIndex] = representative;
+			state.wedgeNext[vertexIndex] = state.wedgeNext[representative];
+			state.wedgeNext[representative] = vertexIndex;
+		}
+	}
+	HbMemory_Free(hashMap);
+
+	HbMeshi_Simplify_BuildTriangleAdjacency(&state);
+	HbMeshi_Simplify_ClassifyVertexes(&state);
+
+	// Quadrics of the triangle planes and of the attributes interpolated over the triangles.
+	memset(state.positionQuadrics, 0, (size_t) vertexCount * sizeof(HbMeshi_Simplify_Quadric));
+	if (attributeCount != 0) {
+		memset(state.attributeQuadrics, 0, (size_t) vertexCount * sizeof(HbMeshi_Simplify_Quadric));
+		memset(state.attributeGradients, 0, (size_t) attributeCount * vertexCount * sizeof(HbMeshi_Simplify_AttributeGradient));
+	}
+	for (uint32_t triangleIndex = 0; triangleIndex < triangleCount; ++triangleIndex) {
+		uint32_t const * triangle = state.indexes + 3 * triangleIndex;
+		float const * p0 = state.positions + 3 * triangle[0];
+		float const * p1 = state.positions + 3 * triangle[1];
+		float const * p2 = state.positions + 3 * triangle[2];
+		float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] }, e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+		float n[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+		float nLength = sqrtf(n[0] * n[0] + n[1] * n[1] + n[2] * n[2]);
+		if (nLength <= 0.0f) {
+			continue;
+		}
+		float area = 0.5f * nLength;
+		n[0] /= nLength;
+		n[1] /= nLength;
+		n[2] /= nLength;
+		HbMeshi_Simplify_Quadric quadric;
+		memset(&quadric, 0, sizeof(quadric));
+		HbMeshi_Simplify_Quadric_AddLinear(&quadric, n, -(n[0] * p0[0] + n[1] * p0[1] + n[2] * p0[2]), area);
+		quadric.weight = area;
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			HbMeshi_Simplify_Quadric_Add(&state.positionQuadrics[state.positionRepresentatives[triangle[cornerIndex]]], &quadric);
+		}
+
+		// Borders and seams are kept in place with planes perpendicular to the triangles.
+		for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+			uint32_t edgeStart = triangle[cornerIndex], edgeEnd = triangle[(cornerIndex + 1) % 3];
+			if (HbMeshi_Simplify_HasEdge(&state, edgeEnd, edgeStart)) {
+				continue;
+			}
+			float const * edgeStartPosition = state.positions + 3 * edgeStart, * edgeEndPosition = state.positions + 3 * edgeEnd;
+			float edge[3] = { edgeEndPosition[0] - edgeStartPosition[0], edgeEndPosition[1] - edgeStartPosition[1],
+					edgeEndPosition[2] - edgeStartPosition[2] };
+			float edgeNormal[3] = { edge[1] * n[2] - edge[2] * n[1], edge[2] * n[0] - edge[0] * n[2], edge[0] * n[1] - edge[1] * n[0] };
+			float edgeLengthSquared = edge[0] * edge[0] + edge[1] * edge[1] + edge[2] * edge[2];
+			if (edgeLengthSquared <= 0.0f) {
+				continue;
+			}
+			// The edge is perpendicular to the normal, so the length of their cross product is the length of the edge.
+			float edgeLengthInverse = 1.0f / sqrtf(edgeLengthSquared);
+			edgeNormal[0] *= edgeLengthInverse;
+			edgeNormal[1] *= edgeLengthInverse;
+			edgeNormal[2] *= edgeLengthInverse;
+			HbMeshi_Simplify_Quadric edgeQuadric;
+			memset(&edgeQuadric, 0, sizeof(edgeQuadric));
+			float edgeWeight = edgeLengthSquared * HbMeshi_Simplify_EdgeWeight;
+			HbMeshi_Simplify_Quadric_AddLinear(&edgeQuadric, edgeNormal,
+					-(edgeNormal[0] * edgeStartPosition[0] + edgeNormal[1] * edgeStartPosition[1] + edgeNormal[2] * edgeStartPosition[2]),
+					edgeWeight);
+			edgeQuadric.weight = edgeWeight;
+			HbMeshi_Simplify_Quadric_Add(&state.positionQuadrics[state.positionRepresentatives[edgeStart]], &edgeQuadric);
+			HbMeshi_Simplify_Quadric_Add(&state.positionQuadrics[state.positionRepresentatives[edgeEnd]], &edgeQuadric);
+		}
+
+		if (attributeCount != 0) {
+			// Gradients g of the attributes in the plane of the triangle, with g.p + d equal to the values at the vertexes.
+			// Solving [e1; e2; n] * g = [a1 - a0; a2 - a0; 0] with the inverse of the matrix,
+			// which has the columns (e2 x n, n x e1, e1 x e2) divided by the determinant.
+			float e2CrossN[3] = { e2[1] * n[2] - e2[2] * n[1], e2[2] * n[0] - e2[0] * n[2], e2[0] * n[1] - e2[1] * n[0] };
+			float nCrossE1[3] = { n[1] * e1[2] - n[2] * e1[1], n[2] * e1[0] - n[0] * e1[2], n[0] * e1[1] - n[1] * e1[0] };
+			float determinantInverse = 1.0f / (e1[0] * e2CrossN[0] + e1[1] * e2CrossN[1] + e1[2] * e2CrossN[2]);
+			HbMeshi_Simplify_Quadric attributeQuadric;
+			memset(&attributeQuadric, 0, sizeof(attributeQuadric));
+			attributeQuadric.weight = area;
+			HbMeshi_Simplify_AttributeGradient gradients[HbMesh_Simplify_MaxAttributes];
+			float const * a0 = state.attributes + attributeCount * triangle[0];
+			float const * a1 = state.attributes + attributeCount * triangle[1];
+			float const * a2 = state.attributes + attributeCount * triangle[2];
+			for (uint32_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex) {
+				float delta1 = (a1[attributeIndex] - a0[attributeIndex]) * determinantInverse;
+				float delta2 = (a2[attributeIndex] - a0[attributeIndex]) * determinantInverse;
+				float g[3] = { e2CrossN[0] * delta1 + nCrossE1[0] * delta2, e2CrossN[1] * delta1 + nCrossE1[1] * delta2,
+						e2CrossN[2] * delta1 + nCrossE1[2] * delta2 };
+				float d = a0[attributeIndex] - (g[0] * p0[0] + g[1] * p0[1] + g[2] * p0[2]);
+				HbMeshi_Simplify_Quadric_AddLinear(&attributeQuadric, g, d, area);
+				HbMeshi_Simplify_AttributeGradient * gradient = &gradients[attributeIndex];
+				gradient->g[0] = -area * g[0];
+				gradient->g[1] = -area * g[1];
+				gradient->g[2] = -area * g[2];
+				gradient->d = -area * d;
+			}
+			for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+				uint32_t vertexIndex = triangle[cornerIndex];
+				HbMeshi_Simplify_Quadric_Add(&state.attributeQuadrics[vertexIndex], &attributeQuadric);
+				HbMeshi_Simplify_AttributeGradient * vertexGradients = state.attributeGradients + attributeCount * vertexIndex;
+				for (uint32_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex) {
+					HbMeshi_Simplify_AttributeGradient * vertexGradient = &vertexGradients[attributeIndex];
+					HbMeshi_Simplify_AttributeGradient const * gradient = &gradients[attributeIndex];
+					vertexGradient->g[0] += gradient->g[0];
+					vertexGradient->g[1] += gradient->g[1];
+					vertexGradient->g[2] += gradient->g[2];
+					vertexGradient->d += gradient->d;
+				}
+			}
+		}
+	}
+
+	// Passes of independent collapses - for each position, the cheapest collapse is found, and they're done in the order of the error,
+	// skipping those near the ones already done in the pass, as their errors and flip checks would be outdated.
+	float maxErrorNormalized = maxError * extentInverse;
+	float errorLimit = maxErrorNormalized * maxErrorNormalized, resultPositionError = 0.0f, resultAttributeError = 0.0f;
+	while (state.triangleCount > targetTriangleCount) {
+		uint32_t collapseCount = 0;
+		for (uint32_t source = 0; source < vertexCount; ++source) {
+			if (state.positionRepresentatives[source] != source) {
+				continue;
+			}
+			HbMeshi_Simplify_Kind sourceKind = (HbMeshi_Simplify_Kind) state.kinds[source];
+			if (sourceKind != HbMeshi_Simplify_Kind_Manifold && sourceKind != HbMeshi_Simplify_Kind_Border &&
+					sourceKind != HbMeshi_Simplify_Kind_Seam) {
+				continue;
+			}
+			HbMeshi_Simplify_Collapse * collapse = &collapses[collapseCount];
+			collapse->source = source;
+			collapse->target = UINT32_MAX;
+			collapse->error = FLT_MAX;
+			collapse->positionError = FLT_MAX;
+			uint32_t wedge = source;
+			do {
+				uint32_t const * vertexTriangles = state.vertexTriangles + state.vertexTrianglesFirst[wedge];
+				for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < state.vertexTriangleCounts[wedge]; ++vertexTriangleIndex) {
+					uint32_t const * triangle = state.indexes + 3 * vertexTriangles[vertexTriangleIndex];
+					uint32_t corner = HbMeshi_Simplify_GetCorner(triangle, wedge);
+					for (uint32_t neighborCornerOffset = 1; neighborCornerOffset <= 2; ++neighborCornerOffset) {
+						uint32_t neighbor = state.positionRepresentatives[triangle[(corner + neighborCornerOffset) % 3]];
+						uint32_t sourceWedges[2], targetWedges[2], wedgeCount;
+						if (neighbor == source || !HbMeshi_Simplify_GetCollapseWedges(&state, source, neighbor, sourceWedges, targetWedges, &wedgeCount)) {
+							continue;
+						}
+						float collapsePositionError;
+						float collapseError = HbMeshi_Simplify_GetCollapseError(&state, source, neighbor, sourceWedges, targetWedges, wedgeCount,
+								&collapsePositionError);
+						if (collapseError < collapse->error) {
+							collapse->target = neighbor;
+							collapse->error = collapseError;
+							collapse->positionError = collapsePositionError;
+						}
+					}
+				}
+				wedge = state.wedgeNext[wedge];
+			} while (wedge != source);
+			// The limit is only for the geometry, as the attribute errors are in different units.
+			if (collapse->target != UINT32_MAX && collapse->positionError <= errorLimit) {
+				++collapseCount;
+			}
+		}
+		qsort(collapses, collapseCount, sizeof(HbMeshi_Simplify_Collapse), HbMeshi_Simplify_CompareCollapses);
+
+		memset(state.collapseTouched, 0, (size_t) vertexCount * sizeof(HbBool));
+		for (uint32_t vertexIndex = 0; vertexIndex < vertexCount; ++vertexIndex) {
+			state.collapseRemap[vertexIndex] = vertexIndex;
+		}
+		uint32_t triangleCountLeft = state.triangleCount, collapsesDone = 0;
+		for (uint32_t collapseIndex = 0; collapseIndex < collapseCount && triangleCountLeft > targetTriangleCount; ++collapseIndex) {
+			HbMeshi_Simplify_Collapse const * collapse = &collapses[collapseIndex];
+			uint32_t source = collapse->source, targetVertex = collapse->target;
+			if (state.collapseTouched[source] || state.collapseTouched[targetVertex] ||
+					HbMeshi_Simplify_HasTriangleFlips(&state, source, targetVertex)) {
+				continue;
+			}
+			uint32_t sourceWedges[2], targetWedges[2], wedgeCount;
+			HbMeshi_Simplify_GetCollapseWedges(&state, source, targetVertex, sourceWedges, targetWedges, &wedgeCount);
+			for (uint32_t wedgeIndex = 0; wedgeIndex < wedgeCount; ++wedgeIndex) {
+				state.collapseRemap[sourceWedges[wedgeIndex]] = targetWedges[wedgeIndex];
+				if (attributeCount != 0) {
+					HbMeshi_Simplify_Quadric_Add(&state.attributeQuadrics[targetWedges[wedgeIndex]], &state.attributeQuadrics[sourceWedges[wedgeIndex]]);
+					HbMeshi_Simplify_AttributeGradient * targetGradients = state.attributeGradients + attributeCount * targetWedges[wedgeIndex];
+					HbMeshi_Simplify_AttributeGradient const * sourceGradients = state.attributeGradients + attributeCount * sourceWedges[wedgeIndex];
+					for (uint32_t attributeIndex = 0; attributeIndex < attributeCount; ++attributeIndex) {
+						targetGradients[attributeIndex].g[0] += sourceGradients[attributeIndex].g[0];
+						targetGradients[attributeIndex].g[1] += sourceGradients[attributeIndex].g[1];
+						targetGradients[attributeIndex].g[2] += sourceGradients[attributeIndex].g[2];
+						targetGradients[attributeIndex].d += sourceGradients[attributeIndex].d;
+					}
+				}
+			}
+			HbMeshi_Simplify_Quadric_Add(&state.positionQuadrics[targetVertex], &state.positionQuadrics[source]);
+			// Marking the neighborhood, and counting the triangles with both vertexes, which will be removed.
+			uint32_t wedge = source;
+			do {
+				uint32_t const * vertexTriangles = state.vertexTriangles + state.vertexTrianglesFirst[wedge];
+				for (uint32_t vertexTriangleIndex = 0; vertexTriangleIndex < state.vertexTriangleCounts[wedge]; ++vertexTriangleIndex) {
+					uint32_t const * triangle = state.indexes + 3 * vertexTriangles[vertexTriangleIndex];
+					HbBool hasTarget = HbFalse;
+					for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+						uint32_t cornerRepresentative = state.positionRepresentatives[triangle[cornerIndex]];
+						state.collapseTouched[cornerRepresentative] = HbTrue;
+						hasTarget |= (cornerRepresentative == targetVertex);
+					}
+					triangleCountLeft -= hasTarget;
+				}
+				wedge = state.wedgeNext[wedge];
+			} while (wedge != source);
+			resultPositionError = fmaxf(resultPositionError, collapse->positionError);
+			resultAttributeError = fmaxf(resultAttributeError, collapse->error - collapse->positionError);
+			++collapsesDone;
+		}
+		if (collapsesDone == 0) {
+			break;
+		}
+
+		// Removing the triangles that have become degenerate.
+		uint32_t newTriangleCount = 0;
+		for (uint32_t triangleIndex = 0; triangleIndex < state.triangleCount; ++triangleIndex) {
+			uint32_t const * triangle = state.indexes + 3 * triangleIndex;
+			uint32_t v0 = state.collapseRemap[triangle[0]], v1 = state.collapseRemap[triangle[1]], v2 = state.collapseRemap[triangle[2]];
+			uint32_t r0 = state.positionRepresentatives[v0], r1 = state.positionRepresentatives[v1], r2 = state.positionRepresentatives[v2];
+			if (r0 == r1 || r1 == r2 || r2 == r0) {
+				continue;
+			}
+			uint32_t * newTriangle = state.indexes + 3 * newTriangleCount++;
+			newTriangle[0] = v0;
+			newTriangle[1] = v1;
+			newTriangle[2] = v2;
+		}
+		state.triangleCount = newTriangleCount;
+		HbMeshi_Simplify_BuildTriangleAdjacency(&state);
+	}
+
+	memcpy(target, state.indexes, (size_t) 3 * state.triangleCount * sizeof(uint32_t));
+	if (geometricError != NULL) {
+		*geometricError = sqrtf(resultPositionError) * extent;
+	}
+	if (attributeError != NULL) {
+		*attributeError = sqrtf(fmaxf(resultAttributeError, 0.0f));
+	}
+	triangleCount = state.triangleCount;
+
+	HbMemory_Free(collapses);
+	HbMemory_Free(state.collapseRemap);
+	HbMemory_Free(state.collapseTouched);
+	if (attributeCount != 0) {
+		HbMemory_Free(state.attributeGradients);
+		HbMemory_Free(state.attributeQuadrics);
+	}
+	HbMemory_Free(state.positionQuadrics);
+	HbMemory_Free(state.vertexTriangles);
+	HbMemory_Free(state.vertexTriangleCounts);
+	HbMemory_Free(state.vertexTrianglesFirst);
+	HbMemory_Free(state.kinds);
+	HbMemory_Free(state.wedgeNext);
+	HbMemory_Free(state.positionRepresentatives);
+	if (attributeCount != 0) {
+		HbMemory_Free(state.attributes);
+	}
+	HbMemory_Free(state.positions);
+	HbMemory_Free(state.indexes);
+	return triangleCount;
+}
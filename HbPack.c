@@ -1,125 +1,635 @@
+#include "HbAtomic.h"
 #include "HbHash.h"
+#include "HbMath.h"
 #include "HbPack.h"
+#include "HbParallel.h"
 
 char const HbPack_HeaderID[12] = { 'H', 'a', 'r', 'd', 'b', 'y', 't', 'e', 's', 'P', 'a', 'k' };
+char const HbPack_HeaderIDV2[12] = { 'H', 'a', 'r', 'd', 'b', 'y', 't', 'e', 's', 'P', 'k', '2' };
 
-HbBool HbPack_GetInfo(void const * pack, uint32_t packSize, HbPack_Info * info, HbBool validateDirectory) {
-	if (((uintptr_t) pack & 15) != 0 || packSize < sizeof(HbPack_Header)) {
-		return HbFalse;
+/******************************
+ * Version 2 name table access
+ ******************************/
+
+#define HbPacki_NameBlockSize ((uint32_t) 1 << HbPack_NameBlockSizeLog2)
+#define HbPacki_NameBlockMask (HbPacki_NameBlockSize - 1)
+
+HbForceInline char const * HbPacki_GetNameRecordV2(HbPack_Info const * info, uint32_t itemIndex) {
+	return (char const *) (info->start + info->namesOffset + HbPack_GetDirectoryV2(info)[itemIndex].nameOffset);
+}
+
+// For records other than block heads. The name buffer must contain the previous name.
+static size_t HbPacki_DecodeNameRecordV2(char const * record, char * name, size_t previousLength) {
+	uint8_t const * recordBytes = (uint8_t const *) record;
+	size_t prefixLength = 0;
+	uint32_t shift = 0;
+	uint8_t recordByte;
+	do {
+		recordByte = *(recordBytes++);
+		prefixLength |= (size_t) (recordByte & 0x7F) << shift;
+		shift += 7;
+	} while ((recordByte & 0x80) != 0 && shift < 32);
+	// Clamped so the buffer is never overrun even for packs loaded without validation.
+	prefixLength = HbMinSize(prefixLength, previousLength);
+	return prefixLength + HbTextA_Copy(name + prefixLength, HbPack_MaxNameSize - prefixLength, (char const *) recordBytes);
+}
+
+uint32_t HbPack_GetItemNameHash(HbPack_Info const * info, uint32_t itemIndex) {
+	if (info->version >= 2) {
+		return HbPack_GetDirectoryV2(info)[itemIndex].nameHash;
 	}
-	HbPack_Header const * header = (HbPack_Header *) pack;
-	if (memcmp(header->id, HbPack_HeaderID, sizeof(HbPack_HeaderID)) != 0) {
-		return HbFalse;
+	return HbHash_FNV1a_HashTextACaseless(HbPack_GetDirectory(info)[itemIndex].name);
+}
+
+size_t HbPack_GetItemName(HbPack_Info const * info, uint32_t itemIndex, char * name) {
+	if (info->version < 2) {
+		return HbTextA_Copy(name, HbPack_MaxNameSize, HbPack_GetDirectory(info)[itemIndex].name);
 	}
-	uint32_t itemCount = header->itemCount;
-	if (itemCount == 0) {
-		return HbFalse;
+	uint32_t recordIndex = itemIndex & ~HbPacki_NameBlockMask;
+	size_t nameLength = HbTextA_Copy(name, HbPack_MaxNameSize, HbPacki_GetNameRecordV2(info, recordIndex));
+	while (recordIndex < itemIndex) {
+		++recordIndex;
+		nameLength = HbPacki_DecodeNameRecordV2(HbPacki_GetNameRecordV2(info, recordIndex), name, nameLength);
 	}
-	if ((packSize - sizeof(HbPack_Header)) / sizeof(HbPack_DirectoryEntry) < itemCount) {
-		return HbFalse;
+	return nameLength;
+}
+
+size_t HbPack_GetNextItemName(HbPack_Info const * info, uint32_t itemIndex, char * name, size_t previousLength) {
+	if (info->version < 2) {
+		return HbTextA_Copy(name, HbPack_MaxNameSize, HbPack_GetDirectory(info)[itemIndex].name);
 	}
-	if (validateDirectory) {
-		HbPack_DirectoryEntry const * directory = (HbPack_DirectoryEntry const *) ((uint8_t const *) pack + sizeof(HbPack_Header));
-		for (uint32_t itemIndex = 0; itemIndex < itemCount; ++itemCount) {
-			HbPack_DirectoryEntry const * directoryEntry = &directory[itemIndex];
-			if (directoryEntry->name[0] == '\0' || directoryEntry->name[HbPack_MaxItemNameSize - 1] != '\0' ||
-					(directoryEntry->offset & 15) != 0 || directoryEntry->offset > packSize ||
-					(packSize - directoryEntry->offset) < directoryEntry->size) {
-				return HbFalse;
+	if ((itemIndex & HbPacki_NameBlockMask) == 0) {
+		return HbTextA_Copy(name, HbPack_MaxNameSize, HbPacki_GetNameRecordV2(info, itemIndex));
+	}
+	return HbPacki_DecodeNameRecordV2(HbPacki_GetNameRecordV2(info, itemIndex), name, previousLength);
+}
+
+/***********************
+ * Directory validation
+ ***********************/
+
+static HbPack_Error HbPacki_Validation_CheckItemBounds(uint32_t offset, uint32_t size, uint32_t packSize) {
+	if ((offset & 15) != 0) {
+		return HbPack_Error_ItemMisaligned;
+	}
+	if (offset > packSize || (packSize - offset) < size) {
+		return HbPack_Error_ItemOutOfBounds;
+	}
+	return HbPack_Error_None;
+}
+
+static HbPack_Error HbPacki_Validation_CheckItem(HbPack_DirectoryEntry const * directoryEntry, uint32_t packSize) {
+	if (directoryEntry->name[0] == '\0') {
+		return HbPack_Error_ItemNameEmpty;
+	}
+	if (directoryEntry->name[HbPack_MaxItemNameSize - 1] != '\0') {
+		return HbPack_Error_ItemNameUnterminated;
+	}
+	return HbPacki_Validation_CheckItemBounds(directoryEntry->offset, directoryEntry->size, packSize);
+}
+
+// Both ranges must start at multiples of 4 so SIMD loads are aligned, and items must also start at the beginning of a name block.
+typedef struct HbPacki_Validation_Job {
+	HbPack_Info const * info;
+	uint32_t itemFirst;
+	uint32_t itemEnd;
+	uint32_t hashMapSlotFirst;
+	uint32_t hashMapSlotEnd;
+	HbPack_ErrorReport directoryError;
+	HbPack_ErrorReport hashMapError;
+} HbPacki_Validation_Job;
+
+// Returns the index of the first item failing the checks that can be done for 4 items at once, or itemEnd.
+// The offset and the size are in the last 8 bytes of entries of both versions, and for version 1, name[52:55] is before them.
+static uint32_t HbPacki_Validation_FindFailingItemBounds(HbPack_Info const * info, uint32_t itemIndex, uint32_t itemEnd) {
+	HbBool isVersion1 = (info->version < 2);
+	uint32_t entryVectorCount = (isVersion1 ? sizeof(HbPack_DirectoryEntry) : sizeof(HbPack_DirectoryEntryV2)) / sizeof(HbMath_U32x4);
+	HbMath_U32x4 const * directoryVectors = (HbMath_U32x4 const *) (isVersion1 ?
+			(void const *) HbPack_GetDirectory(info) : (void const *) HbPack_GetDirectoryV2(info));
+	// Entries are transposed to have one field of 4 entries in every vector.
+	// For version 1, name[0] is in the low byte of dword 0 and name[55] is in the high byte of dword 13.
+	HbMath_U32x4 byteMask = HbMath_U32x4_LoadReplicated(0xFF);
+	HbMath_U32x4 lastNameByteMax = HbMath_U32x4_LoadReplicated(0xFFFFFF);
+	HbMath_U32x4 offsetAlignmentMask = HbMath_U32x4_LoadReplicated(15);
+	HbMath_U32x4 packSizes = HbMath_U32x4_LoadReplicated(info->size);
+	HbMath_U32x4 zero = HbMath_U32x4_LoadZero();
+	for (; itemIndex + 4 <= itemEnd; itemIndex += 4) {
+		HbMath_U32x4 const * entries = directoryVectors + itemIndex * entryVectorCount;
+		HbMath_U32x4 tail0 = HbMath_U32x4_LoadAligned(&entries[entryVectorCount - 1]);
+		HbMath_U32x4 tail1 = HbMath_U32x4_LoadAligned(&entries[2 * entryVectorCount - 1]);
+		HbMath_U32x4 tail2 = HbMath_U32x4_LoadAligned(&entries[3 * entryVectorCount - 1]);
+		HbMath_U32x4 tail3 = HbMath_U32x4_LoadAligned(&entries[4 * entryVectorCount - 1]);
+		HbMath_U32x4 tailZW01 = HbMath_U32x4_InterleaveZW(tail0, tail1), tailZW23 = HbMath_U32x4_InterleaveZW(tail2, tail3);
+		HbMath_U32x4 offsets = HbMath_U32x4_CombineXYXY(tailZW01, tailZW23);
+		HbMath_U32x4 sizes = HbMath_U32x4_CombineZWZW(tailZW01, tailZW23);
+		HbMath_U32x4 failed = HbMath_S32x4_CompareGreater(HbMath_U32x4_And(offsets, offsetAlignmentMask), zero);
+		failed = HbMath_U32x4_Or(failed, HbMath_U32x4_CompareGreater(offsets, packSizes));
+		failed = HbMath_U32x4_Or(failed, HbMath_U32x4_CompareGreater(sizes, HbMath_U32x4_Subtract(packSizes, offsets)));
+		if (isVersion1) {
+			HbMath_U32x4 nameStarts = HbMath_U32x4_CombineXYXY(
+					HbMath_U32x4_InterleaveXY(HbMath_U32x4_LoadAligned(&entries[0]), HbMath_U32x4_LoadAligned(&entries[4])),
+					HbMath_U32x4_InterleaveXY(HbMath_U32x4_LoadAligned(&entries[8]), HbMath_U32x4_LoadAligned(&entries[12])));
+			HbMath_U32x4 nameEnds = HbMath_U32x4_CombineZWZW(HbMath_U32x4_InterleaveXY(tail0, tail1), HbMath_U32x4_InterleaveXY(tail2, tail3));
+			failed = HbMath_U32x4_Or(failed, HbMath_U32x4_CompareEqual(HbMath_U32x4_And(nameStarts, byteMask), zero));
+			failed = HbMath_U32x4_Or(failed, HbMath_U32x4_CompareGreater(nameEnds, lastNameByteMax));
+		}
+		if (HbMath_U32x4_SignBits(failed) != 0) {
+			break; // Find the exact entry in the scalar loop.
+		}
+	}
+	for (; itemIndex < itemEnd; ++itemIndex) {
+		HbPack_Error error;
+		if (isVersion1) {
+			error = HbPacki_Validation_CheckItem(&HbPack_GetDirectory(info)[itemIndex], info->size);
+		} else {
+			HbPack_DirectoryEntryV2 const * directoryEntry = &HbPack_GetDirectoryV2(info)[itemIndex];
+			error = HbPacki_Validation_CheckItemBounds(directoryEntry->offset, directoryEntry->size, info->size);
+		}
+		if (error != HbPack_Error_None) {
+			break;
+		}
+	}
+	return itemIndex;
+}
+
+// Checks the name records of version 2 items, starting from the beginning of a name block.
+static HbPack_ErrorReport HbPacki_Validation_CheckNamesV2(HbPack_Info const * info, uint32_t itemFirst, uint32_t itemEnd) {
+	HbPack_ErrorReport errorReport = { .error = HbPack_Error_None, .index = 0 };
+	HbPack_DirectoryEntryV2 const * directory = HbPack_GetDirectoryV2(info);
+	uint8_t const * names = info->start + info->namesOffset;
+	uint32_t namesSize = info->namesSize;
+	size_t previousLength = 0;
+	for (uint32_t itemIndex = itemFirst; itemIndex < itemEnd; ++itemIndex) {
+		errorReport.index = itemIndex;
+		uint32_t nameOffset = directory[itemIndex].nameOffset;
+		if (nameOffset >= namesSize) {
+			errorReport.error = HbPack_Error_ItemNameOutOfBounds;
+			return errorReport;
+		}
+		uint8_t const * record = names + nameOffset;
+		size_t recordSpace = namesSize - nameOffset;
+		size_t prefixLength = 0;
+		if ((itemIndex & HbPacki_NameBlockMask) != 0) {
+			// Names are shorter than HbPack_MaxNameSize, so the prefix length takes 2 bytes at most.
+			size_t prefixLengthSize = 0;
+			uint8_t recordByte;
+			do {
+				if (prefixLengthSize >= HbMinSize(recordSpace, 2)) {
+					errorReport.error = HbPack_Error_ItemNamePrefixInvalid;
+					return errorReport;
+				}
+				recordByte = record[prefixLengthSize];
+				prefixLength |= (size_t) (recordByte & 0x7F) << (prefixLengthSize * 7);
+				++prefixLengthSize;
+			} while ((recordByte & 0x80) != 0);
+			if (prefixLength > previousLength) {
+				errorReport.error = HbPack_Error_ItemNamePrefixInvalid;
+				return errorReport;
 			}
+			record += prefixLengthSize;
+			recordSpace -= prefixLengthSize;
+		}
+		size_t maxSuffixSize = HbPack_MaxNameSize - prefixLength;
+		uint8_t const * terminator = memchr(record, '\0', HbMinSize(recordSpace, maxSuffixSize));
+		if (terminator == NULL) {
+			errorReport.error = (recordSpace > maxSuffixSize ? HbPack_Error_ItemNameTooLong : HbPack_Error_ItemNameUnterminated);
+			return errorReport;
+		}
+		previousLength = prefixLength + (size_t) (terminator - record);
+		if (previousLength == 0) {
+			errorReport.error = HbPack_Error_ItemNameEmpty;
+			return errorReport;
+		}
+	}
+	errorReport.index = 0;
+	return errorReport;
+}
+
+static void HbPacki_Validation_ValidateDirectory(HbPacki_Validation_Job * job) {
+	HbPack_Info const * info = job->info;
+	uint32_t itemFirst = job->itemFirst, itemEnd = job->itemEnd;
+	job->directoryError.error = HbPack_Error_None;
+	job->directoryError.index = 0;
+	uint32_t failingItemIndex = HbPacki_Validation_FindFailingItemBounds(info, itemFirst, itemEnd);
+	if (info->version >= 2) {
+		// Name errors are reported before other errors of the same item, like in version 1.
+		HbPack_ErrorReport nameError = HbPacki_Validation_CheckNamesV2(info, itemFirst, HbMinU32(failingItemIndex + 1, itemEnd));
+		if (nameError.error != HbPack_Error_None) {
+			job->directoryError = nameError;
+			return;
+		}
+	}
+	if (failingItemIndex < itemEnd) {
+		job->directoryError.error = (info->version >= 2 ?
+				HbPacki_Validation_CheckItemBounds(HbPack_GetItemOffset(info, failingItemIndex), HbPack_GetItemSize(info, failingItemIndex), info->size) :
+				HbPacki_Validation_CheckItem(&HbPack_GetDirectory(info)[failingItemIndex], info->size));
+		job->directoryError.index = failingItemIndex;
+	}
+}
+
+static void HbPacki_Validation_ValidateHashMap(HbPacki_Validation_Job * job) {
+	uint32_t const * hashMap = (uint32_t const *) (job->info->start + job->info->hashMapOffset);
+	uint32_t itemCount = job->info->itemCount;
+	uint32_t slotIndex = job->hashMapSlotFirst, slotEnd = job->hashMapSlotEnd;
+	job->hashMapError.error = HbPack_Error_None;
+	job->hashMapError.index = 0;
+	// HbPack_InvalidItemIndex + 1 wraps to 0, so a single comparison checks both the index and that it's not a free slot.
+	HbMath_U32x4 one = HbMath_U32x4_LoadReplicated(1);
+	HbMath_U32x4 itemCounts = HbMath_U32x4_LoadReplicated(itemCount);
+	for (; slotIndex + 4 <= slotEnd; slotIndex += 4) {
+		HbMath_U32x4 slots = HbMath_U32x4_LoadAligned((HbMath_U32x4 const *) &hashMap[slotIndex]);
+		if (HbMath_U32x4_SignBits(HbMath_U32x4_CompareGreater(HbMath_U32x4_Add(slots, one), itemCounts)) != 0) {
+			break;
+		}
+	}
+	for (; slotIndex < slotEnd; ++slotIndex) {
+		uint32_t hashMapEntry = hashMap[slotIndex];
+		if (hashMapEntry != HbPack_InvalidItemIndex && hashMapEntry >= itemCount) {
+			job->hashMapError.error = HbPack_Error_HashMapItemIndexInvalid;
+			job->hashMapError.index = slotIndex;
+			return;
 		}
 	}
+}
+
+static void HbPacki_Validation_RunJob(void * data) {
+	HbPacki_Validation_Job * job = (HbPacki_Validation_Job *) data;
+	HbPacki_Validation_ValidateDirectory(job);
+	if (job->info->hashMapOffset != 0) {
+		HbPacki_Validation_ValidateHashMap(job);
+	}
+}
+
+static HbPack_ErrorReport HbPacki_Validation_Run(HbPack_Info const * info, uint32_t threadCount) {
+	uint32_t itemCount = info->itemCount;
+	uint32_t hashMapSlotCount = (info->hashMapOffset != 0 ? info->hashMapIndexMask + 1 : 0);
+	uint32_t maxThreadCount = (itemCount + (HbPack_Validation_MinItemsPerThread - 1)) / HbPack_Validation_MinItemsPerThread;
+	threadCount = HbMinU32(HbMinU32(threadCount, maxThreadCount), HbPack_Validation_MaxThreads);
+	threadCount = HbMaxU32(threadCount, 1);
+	HbPacki_Validation_Job jobs[HbPack_Validation_MaxThreads];
+	HbParallel_Thread threads[HbPack_Validation_MaxThreads];
+	HbBool threadsStarted[HbPack_Validation_MaxThreads];
+	// Split items at name block boundaries and hash map slots at multiples of 4, the last job gets the remainder.
+	uint32_t itemsPerJob = (itemCount / threadCount) & ~HbPacki_NameBlockMask;
+	uint32_t hashMapSlotsPerJob = (hashMapSlotCount / threadCount) & ~((uint32_t) 3);
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		HbPacki_Validation_Job * job = &jobs[jobIndex];
+		HbBool isLastJob = (jobIndex + 1 == threadCount);
+		job->info = info;
+		job->itemFirst = jobIndex * itemsPerJob;
+		job->itemEnd = isLastJob ? itemCount : job->itemFirst + itemsPerJob;
+		job->hashMapSlotFirst = jobIndex * hashMapSlotsPerJob;
+		job->hashMapSlotEnd = isLastJob ? hashMapSlotCount : job->hashMapSlotFirst + hashMapSlotsPerJob;
+		job->hashMapError.error = HbPack_Error_None;
+		job->hashMapError.index = 0;
+	}
+	// Job 0 is done on the calling thread, and jobs whose threads couldn't be started too.
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		threadsStarted[jobIndex] = HbParallel_Thread_Start(&threads[jobIndex], "HbPackValidate", HbPacki_Validation_RunJob, &jobs[jobIndex]);
+	}
+	HbPacki_Validation_RunJob(&jobs[0]);
+	for (uint32_t jobIndex = 1; jobIndex < threadCount; ++jobIndex) {
+		if (threadsStarted[jobIndex]) {
+			HbParallel_Thread_Destroy(&threads[jobIndex]);
+		} else {
+			HbPacki_Validation_RunJob(&jobs[jobIndex]);
+		}
+	}
+	// Report the same error as serial validation would - the directory is checked before the hash map, ranges are in order.
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		if (jobs[jobIndex].directoryError.error != HbPack_Error_None) {
+			return jobs[jobIndex].directoryError;
+		}
+	}
+	for (uint32_t jobIndex = 0; jobIndex < threadCount; ++jobIndex) {
+		if (jobs[jobIndex].hashMapError.error != HbPack_Error_None) {
+			return jobs[jobIndex].hashMapError;
+		}
+	}
+	return jobs[0].directoryError;
+}
+
+/***********************
+ * Pack info and lookup
+ ***********************/
+
+HbForceInline HbBool HbPacki_GetInfo_Fail(HbPack_ErrorReport * errorReport, HbPack_Error error) {
+	if (errorReport != NULL) {
+		errorReport->error = error;
+		errorReport->index = 0;
+	}
+	return HbFalse;
+}
+
+// The structures in the beginning are checked against headSize, items against packSize.
+static HbBool HbPacki_GetInfo(void const * pack, uint32_t headSize, uint32_t packSize, HbPack_Info * info,
+		HbBool validateDirectory, uint32_t validationThreadCount, HbPack_ErrorReport * errorReport) {
+	if (((uintptr_t) pack & 15) != 0) {
+		return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_PackMisaligned);
+	}
+	if (headSize < sizeof(HbPack_Header)) {
+		return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_HeaderTruncated);
+	}
+	HbPack_Header const * header = (HbPack_Header *) pack;
+	uint32_t version, headerSize, directoryEntrySize;
+	if (memcmp(header->id, HbPack_HeaderID, sizeof(HbPack_HeaderID)) == 0) {
+		version = 1;
+		headerSize = sizeof(HbPack_Header);
+		directoryEntrySize = sizeof(HbPack_DirectoryEntry);
+	} else if (memcmp(header->id, HbPack_HeaderIDV2, sizeof(HbPack_HeaderIDV2)) == 0) {
+		version = 2;
+		headerSize = sizeof(HbPack_HeaderV2);
+		directoryEntrySize = sizeof(HbPack_DirectoryEntryV2);
+	} else {
+		return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_HeaderIDMismatch);
+	}
+	if (headSize < headerSize) {
+		return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_HeaderTruncated);
+	}
+	uint32_t itemCount = header->itemCount;
+	if (itemCount == 0) {
+		return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_NoItems);
+	}
+	if ((headSize - headerSize) / directoryEntrySize < itemCount) {
+		return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_DirectoryTruncated);
+	}
+	uint32_t hashMapOffset = 0, hashMapIndexMask = 0;
+	uint32_t contentHashesOffset = headerSize + itemCount * directoryEntrySize;
 	if (header->hashMapPresent) {
-		uint32_t hashMapOffset = sizeof(HbPack_Header) + itemCount * sizeof(HbPack_DirectoryEntry);
+		hashMapOffset = contentHashesOffset;
 		uint32_t hashMapIndexMaskLog2 = HbHash_MapUtil_GetNeededEntriesLog2(itemCount);
 		if (hashMapIndexMaskLog2 == 0 || hashMapIndexMaskLog2 == UINT32_MAX) {
-			return HbFalse;
+			return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_HashMapTooManyItems);
 		}
-		uint32_t hashMapIndexMask = ((uint32_t) 1 << hashMapIndexMaskLog2) - 1;
-		// Validation.
-		uint32_t hashMapMaxSize = (packSize - hashMapOffset) / sizeof(uint32_t);
+		hashMapIndexMask = ((uint32_t) 1 << hashMapIndexMaskLog2) - 1;
+		uint32_t hashMapMaxSize = (headSize - hashMapOffset) / sizeof(uint32_t);
 		if (hashMapMaxSize == 0 || (hashMapMaxSize - 1) < hashMapIndexMask) {
-			return HbFalse;
-		}
-		if (validateDirectory) {
-			uint32_t const * hashMap = (uint32_t const *) ((uint8_t const *) pack + hashMapOffset);
-			uint32_t hashMapIndex = 0;
-			for (;;) { // Not a true for loop for safety in case of 0xFFFFFFFF mask.
-				uint32_t hashMapEntry = hashMap[hashMapIndex];
-				if (hashMapEntry != HbPack_InvalidItemIndex && hashMapEntry >= itemCount) {
-					return HbFalse;
-				}
-				if (hashMapIndex >= hashMapIndexMask) {
-					break;
-				}
-				++hashMapIndex;
-			}
+			return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_HashMapTruncated);
+		}
+		contentHashesOffset += (hashMapIndexMask + 1) * sizeof(uint32_t);
+	}
+	if (header->contentHashesPresent) {
+		if ((headSize - contentHashesOffset) / sizeof(uint64_t) < itemCount) {
+			return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_ContentHashesTruncated);
 		}
-		info->hashMapOffset = hashMapOffset;
-		info->hashMapIndexMask = hashMapIndexMask;
 	} else {
-		info->hashMapOffset = 0;
-		info->hashMapIndexMask = 0;
+		contentHashesOffset = 0;
+	}
+	uint32_t namesOffset = 0, namesSize = 0;
+	if (version >= 2) {
+		HbPack_HeaderV2 const * headerV2 = (HbPack_HeaderV2 const *) pack;
+		if (headerV2->reserved[0] != 0 || headerV2->reserved[1] != 0) {
+			return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_HeaderReservedNotZero);
+		}
+		namesOffset = headerV2->namesOffset;
+		namesSize = headerV2->namesSize;
+		if (namesSize == 0 || namesOffset > headSize || (headSize - namesOffset) < namesSize) {
+			return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_NamesOutOfBounds);
+		}
+	}
+	HbPack_Info packInfo;
+	packInfo.start = pack;
+	packInfo.size = packSize;
+	packInfo.itemCount = itemCount;
+	packInfo.version = version;
+	packInfo.hashMapOffset = hashMapOffset;
+	packInfo.hashMapIndexMask = hashMapIndexMask;
+	packInfo.contentHashesOffset = contentHashesOffset;
+	packInfo.namesOffset = namesOffset;
+	packInfo.namesSize = namesSize;
+	HbPack_ErrorReport validationError = { .error = HbPack_Error_None, .index = 0 };
+	if (validateDirectory) {
+		validationError = HbPacki_Validation_Run(&packInfo, validationThreadCount);
+	}
+	if (errorReport != NULL) {
+		*errorReport = validationError;
 	}
-	info->start = pack;
-	info->size = packSize;
-	info->itemCount = itemCount;
+	if (validationError.error != HbPack_Error_None) {
+		return HbFalse;
+	}
+	*info = packInfo;
 	return HbTrue;
 }
 
-uint32_t HbPack_FindFirstPrefixed(HbPack_Info const * info, char const * namePrefix) {
-	size_t namePrefixLength = HbTextA_Length(namePrefix);
-	HbPack_DirectoryEntry const * directory = HbPack_GetDirectory(info);
-	uint32_t lowerBound = 0, upperBound = info->itemCount;
+HbBool HbPack_GetInfo(void const * pack, uint32_t packSize, HbPack_Info * info,
+		HbBool validateDirectory, uint32_t validationThreadCount, HbPack_ErrorReport * errorReport) {
+	return HbPacki_GetInfo(pack, packSize, packSize, info, validateDirectory, validationThreadCount, errorReport);
+}
+
+uint32_t HbPack_GetHeadSize(void const * headStart) {
+	HbPack_Header const * header = (HbPack_Header const *) headStart;
+	uint64_t headSize;
+	if (memcmp(header->id, HbPack_HeaderID, sizeof(HbPack_HeaderID)) == 0) {
+		headSize = sizeof(HbPack_Header) + (uint64_t) header->itemCount * sizeof(HbPack_DirectoryEntry);
+	} else if (memcmp(header->id, HbPack_HeaderIDV2, sizeof(HbPack_HeaderIDV2)) == 0) {
+		headSize = sizeof(HbPack_HeaderV2) + (uint64_t) header->itemCount * sizeof(HbPack_DirectoryEntryV2);
+	} else {
+		return 0;
+	}
+	if (header->hashMapPresent) {
+		uint32_t hashMapIndexMaskLog2 = HbHash_MapUtil_GetNeededEntriesLog2(header->itemCount);
+		if (hashMapIndexMaskLog2 == UINT32_MAX) {
+			return 0;
+		}
+		headSize += ((uint64_t) 1 << hashMapIndexMaskLog2) * sizeof(uint32_t);
+	}
+	if (header->contentHashesPresent) {
+		headSize += (uint64_t) header->itemCount * sizeof(uint64_t);
+	}
+	if (memcmp(header->id, HbPack_HeaderIDV2, sizeof(HbPack_HeaderIDV2)) == 0) {
+		HbPack_HeaderV2 const * headerV2 = (HbPack_HeaderV2 const *) headStart;
+		headSize = HbMaxI(headSize, (uint64_t) headerV2->namesOffset + headerV2->namesSize);
+	}
+	return headSize <= UINT32_MAX ? (uint32_t) headSize : 0;
+}
+
+HbBool HbPack_GetInfoFromHead(void const * head, uint32_t headSize, uint32_t packSize, HbPack_Info * info,
+		HbBool validateDirectory, uint32_t validationThreadCount, HbPack_ErrorReport * errorReport) {
+	if (headSize > packSize) {
+		return HbPacki_GetInfo_Fail(errorReport, HbPack_Error_HeaderTruncated);
+	}
+	return HbPacki_GetInfo(head, headSize, packSize, info, validateDirectory, validationThreadCount, errorReport);
+}
+
+// A whole version 1 name is compared as 4 blocks of 16 characters, with the key lowercased and zero-padded once per lookup.
+// The tail after the terminator should be zero too, but validation only checks name[55], so the comparison stops at the terminator.
+typedef struct HbPacki_KeyV1 {
+	HbMath_U8x16 lower[4];
+	uint64_t compareMask; // Characters to compare - the last 8 bytes of the directory entry are not a part of the name.
+} HbPacki_KeyV1;
+
+static void HbPacki_KeyV1_Init(HbPacki_KeyV1 * keyV1, char const * key, size_t keyLength) {
+	// If the key is longer than a version 1 name can be, the name terminator will be different from the key anyway.
+	size_t compareLength = HbMinSize(keyLength, HbPack_MaxItemNameSize);
+	uint8_t * keyBytes = (uint8_t *) keyV1->lower;
+	memset(keyBytes, 0, sizeof(keyV1->lower));
+	for (size_t characterIndex = 0; characterIndex < compareLength && key[characterIndex] != '\0'; ++characterIndex) {
+		keyBytes[characterIndex] = (uint8_t) HbTextA_CharToLower(key[characterIndex]);
+	}
+	keyV1->compareMask = ((uint64_t) 1 << compareLength) - 1;
+}
+
+HbForceInline int HbPacki_KeyV1_Compare(HbPacki_KeyV1 const * keyV1, HbPack_DirectoryEntry const * directoryEntry) {
+	HbMath_U8x16 const * nameBlocks = (HbMath_U8x16 const *) directoryEntry;
+	HbMath_U8x16 zero = HbMath_U8x16_LoadZero();
+	uint64_t equalMask = 0, terminatorMask = 0;
+	for (uint32_t blockIndex = 0; blockIndex < HbArrayLength(keyV1->lower); ++blockIndex) {
+		HbMath_U8x16 name = HbMath_U8x16_LoadUnaligned(&nameBlocks[blockIndex]);
+		HbMath_U8x16 nameLower = HbTextA_CharsToLowerU8x16(name);
+		equalMask |= (uint64_t) (uint32_t) HbMath_U8x16_SignBits(HbMath_U8x16_CompareEqual(nameLower, keyV1->lower[blockIndex])) <<
+				(blockIndex * 16);
+		terminatorMask |= (uint64_t) (uint32_t) HbMath_U8x16_SignBits(HbMath_U8x16_CompareEqual(name, zero)) << (blockIndex * 16);
+	}
+	// Characters up to and including the first terminator (all if there's none, the last 8 bytes are excluded by compareMask anyway).
+	uint64_t nameMask = terminatorMask ^ (terminatorMask - 1);
+	uint64_t differenceMask = ~equalMask & keyV1->compareMask & nameMask;
+	if (differenceMask == 0) {
+		return 0;
+	}
+	uint32_t characterIndex = (uint32_t) HbBit_LowestOneU64(differenceMask);
+	return (uint8_t) HbTextA_CharToLower(directoryEntry->name[characterIndex]) - ((uint8_t const *) keyV1->lower)[characterIndex];
+}
+
+// Returns the first item whose name is not less than the key and writes its name to the buffer, or itemCount if there's no such item.
+// Only the first keyLength characters are compared, pass SIZE_MAX to compare whole names (the comparison stops at the terminator).
+static uint32_t HbPacki_LowerBound(HbPack_Info const * info, char const * key, size_t keyLength, char * name) {
+	uint32_t itemCount = info->itemCount;
+	if (info->version < 2) {
+		HbPack_DirectoryEntry const * directory = HbPack_GetDirectory(info);
+		HbPacki_KeyV1 keyV1;
+		HbPacki_KeyV1_Init(&keyV1, key, keyLength);
+		uint32_t lowerBound = 0, upperBound = itemCount;
+		while (lowerBound < upperBound) {
+			uint32_t itemIndex = lowerBound + ((upperBound - lowerBound) >> 1);
+			if (HbPacki_KeyV1_Compare(&keyV1, &directory[itemIndex]) < 0) {
+				lowerBound = itemIndex + 1;
+			} else {
+				upperBound = itemIndex;
+			}
+		}
+		if (lowerBound < itemCount) {
+			HbTextA_Copy(name, HbPack_MaxNameSize, directory[lowerBound].name);
+		}
+		return lowerBound;
+	}
+	// Binary search on block heads, which are stored fully.
+	uint32_t lowerBound = 0, upperBound = (itemCount + HbPacki_NameBlockMask) >> HbPack_NameBlockSizeLog2;
 	while (lowerBound < upperBound) {
-		uint32_t entryIndex = lowerBound + ((upperBound - lowerBound) >> 1);
-		int32_t comparison = HbTextA_ComparePartCaseless(directory[entryIndex].name, namePrefix, namePrefixLength);
-		if (comparison < 0) {
-			upperBound = entryIndex;
-		} else if (comparison > 0) {
-			lowerBound = entryIndex + 1;
+		uint32_t blockIndex = lowerBound + ((upperBound - lowerBound) >> 1);
+		if (HbTextA_ComparePartCaseless(HbPacki_GetNameRecordV2(info, blockIndex << HbPack_NameBlockSizeLog2), key, keyLength) < 0) {
+			lowerBound = blockIndex + 1;
 		} else {
-			// Rewind to the first with the prefix.
-			while (entryIndex > 0) {
-				if (HbTextA_ComparePartCaseless(directory[entryIndex - 1].name, namePrefix, namePrefixLength) == 0) {
-					--entryIndex;
-				} else {
-					break;
-				}
+			upperBound = blockIndex;
+		}
+	}
+	// The head of the previous block is less than the key, the rest of that block needs to be checked linearly.
+	if (lowerBound != 0) {
+		uint32_t itemIndex = (lowerBound - 1) << HbPack_NameBlockSizeLog2;
+		uint32_t blockEnd = HbMinU32(itemIndex + HbPacki_NameBlockSize, itemCount);
+		size_t nameLength = HbTextA_Copy(name, HbPack_MaxNameSize, HbPacki_GetNameRecordV2(info, itemIndex));
+		while (++itemIndex < blockEnd) {
+			nameLength = HbPacki_DecodeNameRecordV2(HbPacki_GetNameRecordV2(info, itemIndex), name, nameLength);
+			if (HbTextA_ComparePartCaseless(name, key, keyLength) >= 0) {
+				return itemIndex;
 			}
-			return entryIndex;
 		}
 	}
-	return HbPack_InvalidItemIndex;
+	uint32_t itemIndex = lowerBound << HbPack_NameBlockSizeLog2;
+	if (itemIndex >= itemCount) {
+		return itemCount;
+	}
+	HbTextA_Copy(name, HbPack_MaxNameSize, HbPacki_GetNameRecordV2(info, itemIndex));
+	return itemIndex;
+}
+
+uint32_t HbPack_FindFirstPrefixed(HbPack_Info const * info, char const * namePrefix) {
+	size_t namePrefixLength = HbTextA_Length(namePrefix);
+	char name[HbPack_MaxNameSize];
+	uint32_t itemIndex = HbPacki_LowerBound(info, namePrefix, namePrefixLength, name);
+	if (itemIndex >= info->itemCount || HbTextA_ComparePartCaseless(name, namePrefix, namePrefixLength) != 0) {
+		return HbPack_InvalidItemIndex;
+	}
+	return itemIndex;
 }
 
-HbPack_DirectoryEntry const * HbPack_Find(HbPack_Info const * info, char const * name) {
-	HbPack_DirectoryEntry const * directory = HbPack_GetDirectory(info);
+uint32_t HbPack_Find(HbPack_Info const * info, char const * name) {
+	char itemName[HbPack_MaxNameSize];
 	if (info->hashMapOffset != 0) {
 		uint32_t hashIndexMask = info->hashMapIndexMask;
 		uint32_t const * hashMap = (uint32_t const *) (info->start + info->hashMapOffset);
-		uint32_t hash = HbHash_FNV1a_HashTextACaseless(name);
+		uint32_t nameHash = HbHash_FNV1a_HashTextACaseless(name);
+		uint32_t hash = nameHash;
 		uint32_t hashIndex = hash & hashIndexMask;
-		uint32_t entryIndex;
-		while ((entryIndex = hashMap[hashIndex]) != HbPack_InvalidItemIndex) {
-			if (HbTextA_CompareCaseless(directory[entryIndex].name, name) == 0) {
-				return &directory[entryIndex];
+		uint32_t itemIndex;
+		while ((itemIndex = hashMap[hashIndex]) != HbPack_InvalidItemIndex) {
+			if (info->version >= 2) {
+				if (HbPack_GetDirectoryV2(info)[itemIndex].nameHash == nameHash) {
+					HbPack_GetItemName(info, itemIndex, itemName);
+					if (HbTextA_CompareCaseless(itemName, name) == 0) {
+						return itemIndex;
+					}
+				}
+			} else {
+				if (HbTextA_CompareCaseless(HbPack_GetDirectory(info)[itemIndex].name, name) == 0) {
+					return itemIndex;
+				}
 			}
 			HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashIndexMask);
 		}
-	} else {
-		uint32_t lowerBound = 0, upperBound = info->itemCount;
-		while (lowerBound < upperBound) {
-			uint32_t entryIndex = lowerBound + ((upperBound - lowerBound) >> 1);
-			int32_t comparison = HbTextA_CompareCaseless(directory[entryIndex].name, name);
-			if (comparison < 0) {
-				upperBound = entryIndex;
-			} else if (comparison > 0) {
-				lowerBound = entryIndex + 1;
-			} else {
-				return &directory[entryIndex];
-			}
+		return HbPack_InvalidItemIndex;
+	}
+	uint32_t itemIndex = HbPacki_LowerBound(info, name, SIZE_MAX, itemName);
+	if (itemIndex >= info->itemCount || HbTextA_CompareCaseless(itemName, name) != 0) {
+		return HbPack_InvalidItemIndex;
+	}
+	return itemIndex;
+}
+
+/******************************
+ * Lazy integrity verification
+ ******************************/
+
+void HbPack_Verifier_Init(HbPack_Verifier * verifier, HbPack_Info const * info, HbMemory_Tag * tag) {
+	verifier->info = *info;
+	if (info->contentHashesOffset == 0) {
+		verifier->itemStates = NULL;
+		return;
+	}
+	size_t itemStatesSize = (((size_t) info->itemCount + ((1 << HbPack_Verifier_ItemStatesPerWordLog2) - 1)) >>
+			HbPack_Verifier_ItemStatesPerWordLog2) * sizeof(uint32_t);
+	verifier->itemStates = HbMemory_Alloc(tag, itemStatesSize, HbFalse);
+	memset(verifier->itemStates, 0, itemStatesSize); // HbPack_Verifier_ItemState_Unchecked.
+}
+
+void HbPack_Verifier_Destroy(HbPack_Verifier * verifier) {
+	HbMemory_Free(verifier->itemStates);
+}
+
+HbBool HbPack_Verifier_CheckItem(HbPack_Verifier * verifier, uint32_t itemIndex) {
+	if (verifier->itemStates == NULL) {
+		return HbTrue;
+	}
+	uint32_t volatile * itemStateWord = &verifier->itemStates[itemIndex >> HbPack_Verifier_ItemStatesPerWordLog2];
+	uint32_t itemStateShift = (itemIndex & ((1 << HbPack_Verifier_ItemStatesPerWordLog2) - 1)) * HbPack_Verifier_ItemStateBits;
+	uint32_t itemStateMask = ((1 << HbPack_Verifier_ItemStateBits) - 1) << itemStateShift;
+	HbPack_Verifier_ItemState itemState = (HbPack_Verifier_ItemState) ((*itemStateWord & itemStateMask) >> itemStateShift);
+	if (itemState != HbPack_Verifier_ItemState_Unchecked) {
+		return itemState == HbPack_Verifier_ItemState_Valid;
+	}
+	// If multiple threads check the same item for the first time at once, they will all get the same result, so no need to lock.
+	HbBool valid = (HbHash_XXH64_Hash(HbPack_GetItemData(&verifier->info, itemIndex), HbPack_GetItemSize(&verifier->info, itemIndex),
+			HbPack_ContentHashSeed) == HbPack_GetContentHashes(&verifier->info)[itemIndex]);
+	itemState = valid ? HbPack_Verifier_ItemState_Valid : HbPack_Verifier_ItemState_Corrupt;
+	// Other items in the same word may be updated concurrently.
+	uint32_t oldWord = *itemStateWord;
+	for (;;) {
+		uint32_t newWord = (oldWord & ~itemStateMask) | ((uint32_t) itemState << itemStateShift);
+		uint32_t currentWord = HbAtomic_CompareAndSwapU32(itemStateWord, newWord, oldWord);
+		if (currentWord == oldWord) {
+			break;
 		}
+		oldWord = currentWord;
 	}
-	return NULL;
+	return valid;
 }
+
@@ -1,6 +1,7 @@
 #ifndef HbInclude_HbPack
 #define HbInclude_HbPack
-#include "HbCommon.h"
+#include "HbMemory.h"
+#include "HbParallel.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -13,58 +14,330 @@ extern "C" {
  * - Alphabetically sorted (ignoring case for ASCII) central directory for quick binary search and folder contents iteration.
  * - Optional hash map (in HbHash_Map_* format, but without dummy entries) for even quicker lookups.
  * - Directory record and hash map located in the beginning for sequential reading.
+ * - Optional 64-bit content hashes of items for integrity checking. Items with identical contents may share the same data.
  *
  * Can be used with both whole-file reading and with file memory mapping.
  *
  * The format is designed for use both as a package for multiple assets and as a container for other asset formats.
  * This is similar to .*x files used by Microsoft Office. Path names are a more flexible and extensible alternative to things like FourCC.
  *
+ * There are two versions of the directory:
+ * - Version 1 (HbPack_HeaderID) - 64-byte HbPack_DirectoryEntry with the name stored inline, limited to 55 characters.
+ * - Version 2 (HbPack_HeaderIDV2) - 16-byte HbPack_DirectoryEntryV2 with the hash of the name, and the names stored separately
+ *   in a front-coded table. Names are grouped in blocks of 1 << HbPack_NameBlockSizeLog2, the first name of every block is stored fully
+ *   (so binary search can be done on block heads directly), and each of the rest is stored as the length of the prefix shared with the
+ *   previous name (LEB128 varint) followed by the remaining zero-terminated suffix.
+ *
  * Overall structure:
- * - HbPack_Header.
- * - HbPack_DirectoryEntry[item count].
+ * - HbPack_Header (HbPack_HeaderV2 for version 2).
+ * - HbPack_DirectoryEntry[item count] or HbPack_DirectoryEntryV2[item count].
  * - Optional hash map with uint32_t indexes of directory entries. The mask of the hash is HbHash_Map_GetIndexMask32(item count).
+ * - Optional uint64_t[item count] HbHash_XXH64_Hash of the contents of each item with HbPack_ContentHashSeed.
+ * - For version 2, the name table.
  * - Item contents, each 16-aligned.
  */
 
 // Must be in the beginning.
 extern char const HbPack_HeaderID[12];
+extern char const HbPack_HeaderIDV2[12];
 
 typedef struct HbAligned(16) HbPack_Header {
-	char id[12]; // HbPack_HeaderID.
-	uint32_t itemCount : 31;
+	char id[12]; // HbPack_HeaderID or HbPack_HeaderIDV2.
+	uint32_t itemCount : 30;
+	uint32_t contentHashesPresent : 1;
 	uint32_t hashMapPresent : 1; // The index mask is calculated as HbHash_Map_GetIndexMask32(itemCount).
 } HbPack_Header;
 
+typedef struct HbAligned(16) HbPack_HeaderV2 {
+	HbPack_Header common;
+	uint32_t namesOffset;
+	uint32_t namesSize;
+	uint32_t reserved[2]; // Must be zero.
+} HbPack_HeaderV2;
+
 #define HbPack_InvalidItemIndex UINT32_MAX
 
-#define HbPack_MaxItemNameSize 56 // Including the zero terminator.
+#define HbPack_MaxItemCount ((1u << 30) - 1)
+
+#define HbPack_ContentHashSeed 0
+
+#define HbPack_MaxItemNameSize 56 // Including the zero terminator, for version 1.
+#define HbPack_MaxNameSize 1024 // Including the zero terminator, for all versions - use for name buffers.
 
 typedef struct HbAligned(16) HbPack_DirectoryEntry {
-	char name[HbPack_MaxItemNameSize]; // The tail must be zero-filled. Use HbTextA_CompareCaseless for comparison. Path separator is /.
-	uint32_t offset;
+	// The tail should be zero-filled, but readers ignore it. Use HbTextA_CompareCaseless for comparison. Path separator is /.
+	char name[HbPack_MaxItemNameSize];
+	uint32_t offset; // May be the same for multiple items with identical contents.
 	uint32_t size;
 } HbPack_DirectoryEntry;
 
+#define HbPack_NameBlockSizeLog2 4
+
+typedef struct HbAligned(16) HbPack_DirectoryEntryV2 {
+	uint32_t nameHash; // HbHash_FNV1a_HashTextACaseless of the full name.
+	uint32_t nameOffset; // Relative to namesOffset.
+	uint32_t offset; // May be the same for multiple items with identical contents.
+	uint32_t size;
+} HbPack_DirectoryEntryV2;
+
 typedef struct HbPack_Info {
 	uint8_t const * start;
 	uint32_t size;
 	uint32_t itemCount;
+	uint32_t version;
 	// Can be calculated from itemCount, but for faster access later.
 	uint32_t hashMapOffset; // 0 if no hash map (if using binary search only for more compact storage).
 	uint32_t hashMapIndexMask;
+	uint32_t contentHashesOffset; // 0 if no content hashes.
+	uint32_t namesOffset; // Version 2 only.
+	uint32_t namesSize;
 } HbPack_Info;
 
+typedef enum HbPack_Error {
+	HbPack_Error_None,
+	HbPack_Error_PackMisaligned, // The start of the pack is not 16-aligned.
+	HbPack_Error_HeaderTruncated,
+	HbPack_Error_HeaderIDMismatch,
+	HbPack_Error_HeaderReservedNotZero,
+	HbPack_Error_NoItems,
+	HbPack_Error_DirectoryTruncated,
+	HbPack_Error_HashMapTooManyItems,
+	HbPack_Error_HashMapTruncated,
+	HbPack_Error_ContentHashesTruncated,
+	HbPack_Error_NamesOutOfBounds,
+	// Directory validation errors, index is the item index.
+	HbPack_Error_ItemNameEmpty,
+	HbPack_Error_ItemNameUnterminated,
+	HbPack_Error_ItemNameTooLong,
+	HbPack_Error_ItemNameOutOfBounds,
+	HbPack_Error_ItemNamePrefixInvalid,
+	HbPack_Error_ItemMisaligned,
+	HbPack_Error_ItemOutOfBounds,
+	// Directory validation error, index is the hash map slot.
+	HbPack_Error_HashMapItemIndexInvalid,
+} HbPack_Error;
+
+typedef struct HbPack_ErrorReport {
+	HbPack_Error error;
+	uint32_t index; // For directory validation errors, the lowest failing one. 0 for other errors.
+} HbPack_ErrorReport;
+
+// Directories smaller than this are validated on the calling thread only.
+#define HbPack_Validation_MinItemsPerThread 16384
+#define HbPack_Validation_MaxThreads 16
+
+// Accepts both versions of the directory.
 // validateDirectory must be true for user-generated content, with false only the size of the header will be validated.
-// With validateDirectory, alignment, item offsets, sizes and hash map indexes will be validated.
-HbBool HbPack_GetInfo(void const * pack, uint32_t packSize, HbPack_Info * info, HbBool validateDirectory);
+// With validateDirectory, alignment, item offsets, sizes, names and hash map indexes will be validated.
+// Large directories are split between validationThreadCount threads, including the calling one (0 is treated as 1).
+// errorReport is optional, and is written both on success and on failure.
+HbBool HbPack_GetInfo(void const * pack, uint32_t packSize, HbPack_Info * info,
+		HbBool validateDirectory, uint32_t validationThreadCount, HbPack_ErrorReport * errorReport);
 
+// For packs that are read partially rather than mapped, the head is the header, the directory, the hash map, the content hashes and the names.
+// headStart must contain at least HbPack_HeadMinReadSize bytes (valid packs are never smaller). Returns 0 if the header is invalid.
+#define HbPack_HeadMinReadSize sizeof(HbPack_HeaderV2)
+uint32_t HbPack_GetHeadSize(void const * headStart);
+// Like HbPack_GetInfo, but only the first headSize bytes of the pack are in memory, and items are validated against packSize.
+// HbPack_GetItemData and HbPack_Verifier can't be used with such info.
+HbBool HbPack_GetInfoFromHead(void const * head, uint32_t headSize, uint32_t packSize, HbPack_Info * info,
+		HbBool validateDirectory, uint32_t validationThreadCount, HbPack_ErrorReport * errorReport);
+
+// Version 1 only.
 HbForceInline HbPack_DirectoryEntry const * HbPack_GetDirectory(HbPack_Info const * info) {
 	return (HbPack_DirectoryEntry const *) (info->start + sizeof(HbPack_Header));
 }
+// Version 2 only.
+HbForceInline HbPack_DirectoryEntryV2 const * HbPack_GetDirectoryV2(HbPack_Info const * info) {
+	return (HbPack_DirectoryEntryV2 const *) (info->start + sizeof(HbPack_HeaderV2));
+}
+
+// NULL if the pack has no content hashes.
+HbForceInline uint64_t const * HbPack_GetContentHashes(HbPack_Info const * info) {
+	return info->contentHashesOffset != 0 ? (uint64_t const *) (info->start + info->contentHashesOffset) : NULL;
+}
+
+// Version-independent item access.
+
+HbForceInline uint32_t HbPack_GetItemOffset(HbPack_Info const * info, uint32_t itemIndex) {
+	return info->version >= 2 ? HbPack_GetDirectoryV2(info)[itemIndex].offset : HbPack_GetDirectory(info)[itemIndex].offset;
+}
+HbForceInline uint32_t HbPack_GetItemSize(HbPack_Info const * info, uint32_t itemIndex) {
+	return info->version >= 2 ? HbPack_GetDirectoryV2(info)[itemIndex].size : HbPack_GetDirectory(info)[itemIndex].size;
+}
+HbForceInline void const * HbPack_GetItemData(HbPack_Info const * info, uint32_t itemIndex) {
+	return info->start + HbPack_GetItemOffset(info, itemIndex);
+}
+// HbHash_FNV1a_HashTextACaseless of the name - stored for version 2, calculated for version 1.
+uint32_t HbPack_GetItemNameHash(HbPack_Info const * info, uint32_t itemIndex);
+// The buffer must be HbPack_MaxNameSize long. Returns the length of the name.
+size_t HbPack_GetItemName(HbPack_Info const * info, uint32_t itemIndex, char * name);
+// For sequential iteration - the buffer must contain the name of itemIndex - 1 with previousLength,
+// so for version 2 only one record needs to be decoded rather than the whole block.
+size_t HbPack_GetNextItemName(HbPack_Info const * info, uint32_t itemIndex, char * name, size_t previousLength);
 
 // Uses binary search to find the first item with the specified prefix. For the first item in a folder, end the prefix with a /.
 uint32_t HbPack_FindFirstPrefixed(HbPack_Info const * info, char const * prefix);
-HbPack_DirectoryEntry const * HbPack_Find(HbPack_Info const * info, char const * path);
+// Returns the item index or HbPack_InvalidItemIndex.
+uint32_t HbPack_Find(HbPack_Info const * info, char const * path);
+
+/**********************************************************
+ * Lazy integrity verification of contents on first access
+ **********************************************************/
+
+// Hashing is done on the first check of every item and the result is cached, so the whole pack doesn't need to be hashed when mounting.
+
+typedef enum HbPack_Verifier_ItemState {
+	HbPack_Verifier_ItemState_Unchecked,
+	HbPack_Verifier_ItemState_Valid,
+	HbPack_Verifier_ItemState_Corrupt,
+} HbPack_Verifier_ItemState;
+
+#define HbPack_Verifier_ItemStateBits 2
+#define HbPack_Verifier_ItemStatesPerWordLog2 4
+
+typedef struct HbPack_Verifier {
+	HbPack_Info info;
+	uint32_t * itemStates; // Allocated from the tag, HbPack_Verifier_ItemStateBits per item, modified atomically. NULL if no content hashes.
+} HbPack_Verifier;
+
+void HbPack_Verifier_Init(HbPack_Verifier * verifier, HbPack_Info const * info, HbMemory_Tag * tag);
+void HbPack_Verifier_Destroy(HbPack_Verifier * verifier);
+// Thread-safe. Returns true if the contents of the item match the content hash, or if the pack has no content hashes.
+HbBool HbPack_Verifier_CheckItem(HbPack_Verifier * verifier, uint32_t itemIndex);
+
+/******************************************
+ * Pack writing with content deduplication
+ ******************************************/
+
+typedef struct HbPack_Write_Item {
+	char const * name;
+	void const * data;
+	uint32_t size;
+} HbPack_Write_Item;
+
+// Writes a version 2 pack. Items with identical contents are stored once, with multiple directory entries pointing to the data.
+// The items array is sorted in place. Returns a 16-aligned pack allocated from the tag, or NULL if there are invalid or duplicate names,
+// or if the pack would be larger than 4 GB.
+void * HbPack_Write(HbMemory_Tag * tag, HbPack_Write_Item * items, uint32_t itemCount,
+		HbBool writeHashMap, HbBool writeContentHashes, uint32_t * packSize);
+
+/*********************************************************************
+ * Mount table - multiple packs merged into a single lookup structure
+ *********************************************************************/
+
+// Packs mounted later shadow items with the same path in packs mounted earlier (for patches and mods).
+// The merged directory is kept sorted (ignoring case for ASCII) so folders can be iterated across all packs,
+// and a hash map of the merged directory is rebuilt on every mount, so lookups don't depend on the number of packs.
+// Mounting is not thread-safe, but lookups can be done from multiple threads between mounts.
+
+typedef struct HbPack_Mount_Entry {
+	uint32_t packIndex; // In the order of mounting.
+	uint32_t itemIndex; // In the directory of the pack.
+	uint32_t nameHash; // To skip decoding names of colliding entries in lookups.
+} HbPack_Mount_Entry;
+
+typedef struct HbPack_Mount {
+	HbMemory_Tag * tag;
+	HbPack_Info * packs; // Allocated from the tag, packCount elements.
+	HbPack_Mount_Entry * entries; // Allocated from the tag, entryCount elements, one for every unique path.
+	uint32_t * hashMap; // Allocated from the tag, hashMapIndexMask + 1 indexes of entries, or HbPack_InvalidItemIndex for free slots.
+	uint32_t packCount;
+	uint32_t entryCount;
+	uint32_t hashMapIndexMask;
+} HbPack_Mount;
+
+void HbPack_Mount_Init(HbPack_Mount * mount, HbMemory_Tag * tag);
+void HbPack_Mount_Destroy(HbPack_Mount * mount);
+// The pack data must stay accessible while it's mounted. Returns false if there are too many items in total.
+HbBool HbPack_Mount_Add(HbPack_Mount * mount, HbPack_Info const * info);
+
+HbForceInline HbPack_Info const * HbPack_Mount_GetPack(HbPack_Mount const * mount, uint32_t entryIndex) {
+	return &mount->packs[mount->entries[entryIndex].packIndex];
+}
+HbForceInline uint32_t HbPack_Mount_GetItemSize(HbPack_Mount const * mount, uint32_t entryIndex) {
+	return HbPack_GetItemSize(HbPack_Mount_GetPack(mount, entryIndex), mount->entries[entryIndex].itemIndex);
+}
+HbForceInline void const * HbPack_Mount_GetItemData(HbPack_Mount const * mount, uint32_t entryIndex) {
+	return HbPack_GetItemData(HbPack_Mount_GetPack(mount, entryIndex), mount->entries[entryIndex].itemIndex);
+}
+// The buffer must be HbPack_MaxNameSize long. Returns the length of the name.
+HbForceInline size_t HbPack_Mount_GetItemName(HbPack_Mount const * mount, uint32_t entryIndex, char * name) {
+	return HbPack_GetItemName(HbPack_Mount_GetPack(mount, entryIndex), mount->entries[entryIndex].itemIndex, name);
+}
+
+// Returns the index of the entry in the merged directory, or HbPack_InvalidItemIndex.
+// For folder iteration, go through the following entries while their names still have the prefix.
+uint32_t HbPack_Mount_FindFirstPrefixed(HbPack_Mount const * mount, char const * prefix);
+uint32_t HbPack_Mount_Find(HbPack_Mount const * mount, char const * path);
+
+/**************************************************
+ * Item cache with a memory budget for large packs
+ **************************************************/
+
+// Items are read explicitly into memory allocated from the tag rather than accessed through a mapped view, so the amount of memory used
+// by the contents of packs larger than the budget (or RAM) is controlled by the cache instead of the OS page cache.
+// Eviction uses the CLOCK algorithm (an approximation of LRU with a referenced bit per item). Acquired items are pinned until released,
+// and are never evicted - if all resident items are pinned, the budget may be exceeded temporarily.
+// All functions except for Init and Destroy are thread-safe. Reading is done outside the lock.
+
+// Offset is relative to the start of the pack. Returns false if couldn't read the whole range.
+typedef HbBool (* HbPack_Cache_Read)(void * userData, uint64_t offset, void * buffer, uint32_t size);
+// For HbFile_Reader as userData.
+HbBool HbPack_Cache_ReadFile(void * reader, uint64_t offset, void * buffer, uint32_t size);
+
+typedef struct HbPack_Cache_Slot {
+	void * data; // Allocated from the tag, 16-aligned. NULL while loading or if free.
+	uint32_t itemIndex; // For free slots, the index of the next free slot.
+	uint32_t size;
+	uint32_t pinCount;
+	uint32_t loading : 1;
+	uint32_t referenced : 1; // Cleared when the clock hand passes the slot, the slot is evicted if passed without the bit.
+	uint32_t free : 1;
+} HbPack_Cache_Slot;
+
+typedef struct HbPack_Cache_Stats {
+	uint64_t hits;
+	uint64_t misses;
+	uint64_t evictions;
+	uint64_t readFailures; // Including content hash mismatches.
+	uint64_t residentSize; // Including items being loaded.
+	uint32_t residentItemCount;
+} HbPack_Cache_Stats;
+
+typedef struct HbPack_Cache {
+	HbMemory_Tag * tag;
+	HbPack_Info info; // Only the head is required to be in memory.
+	HbPack_Cache_Read read;
+	void * readUserData;
+	HbBool verifyContents; // Check content hashes of items when they are read, if the pack has them.
+	uint64_t budget;
+	HbParallel_Mutex mutex;
+	HbParallel_CondEvent loadedCondEvent; // Signaled when loading of any item is finished.
+	uint32_t * itemSlots; // Allocated from the tag, info.itemCount indexes of slots, or HbPack_InvalidItemIndex for non-resident items.
+	HbPack_Cache_Slot * slots; // Allocated from the tag, slotCount elements.
+	uint32_t slotCount;
+	uint32_t firstFreeSlot; // HbPack_InvalidItemIndex if all slots are used.
+	uint32_t clockHand;
+	HbPack_Cache_Stats stats;
+} HbPack_Cache;
+
+HbBool HbPack_Cache_Init(HbPack_Cache * cache, HbPack_Info const * info, HbPack_Cache_Read read, void * readUserData,
+		uint64_t budget, HbBool verifyContents, HbMemory_Tag * tag);
+// No items may be acquired at this point.
+void HbPack_Cache_Destroy(HbPack_Cache * cache);
+// Evicts items until the resident size fits in the new budget (or only pinned items are left).
+void HbPack_Cache_SetBudget(HbPack_Cache * cache, uint64_t budget);
+// Pins the item and returns its data (with the size given by HbPack_GetItemSize), loading it if needed.
+// If another thread is loading the same item, waits for it. Returns NULL if couldn't read the item, in this case it must not be released.
+void const * HbPack_Cache_Acquire(HbPack_Cache * cache, uint32_t itemIndex);
+void HbPack_Cache_Release(HbPack_Cache * cache, uint32_t itemIndex);
+// Loads the item without pinning it, so a later acquisition is a hit unless it's evicted in between. Returns false if couldn't read.
+// Counted in the statistics like an acquisition.
+HbBool HbPack_Cache_Prefetch(HbPack_Cache * cache, uint32_t itemIndex);
+// Returns false if the item is pinned or being loaded. Returns true if it's not resident.
+HbBool HbPack_Cache_Evict(HbPack_Cache * cache, uint32_t itemIndex);
+void HbPack_Cache_GetStats(HbPack_Cache * cache, HbPack_Cache_Stats * stats);
 
 #ifdef __cplusplus
 }
@@ -0,0 +1,199 @@
+#include "HbFile.h"
+#include "HbHash.h"
+#include "HbPack.h"
+
+HbBool HbPack_Cache_ReadFile(void * reader, uint64_t offset, void * buffer, uint32_t size) {
+	return HbFile_Reader_Read((HbFile_Reader *) reader, offset, buffer, size);
+}
+
+HbBool HbPack_Cache_Init(HbPack_Cache * cache, HbPack_Info const * info, HbPack_Cache_Read read, void * readUserData,
+		uint64_t budget, HbBool verifyContents, HbMemory_Tag * tag) {
+	if (!HbParallel_Mutex_Init(&cache->mutex)) {
+		return HbFalse;
+	}
+	HbParallel_CondEvent_Init(&cache->loadedCondEvent);
+	cache->tag = tag;
+	cache->info = *info;
+	cache->read = read;
+	cache->readUserData = readUserData;
+	cache->verifyContents = verifyContents && info->contentHashesOffset != 0;
+	cache->budget = budget;
+	cache->itemSlots = HbMemory_Alloc(tag, (size_t) info->itemCount * sizeof(uint32_t), HbFalse);
+	memset(cache->itemSlots, 0xFF, (size_t) info->itemCount * sizeof(uint32_t));
+	cache->slots = NULL;
+	cache->slotCount = 0;
+	cache->firstFreeSlot = HbPack_InvalidItemIndex;
+	cache->clockHand = 0;
+	memset(&cache->stats, 0, sizeof(cache->stats));
+	return HbTrue;
+}
+
+void HbPack_Cache_Destroy(HbPack_Cache * cache) {
+	for (uint32_t slotIndex = 0; slotIndex < cache->slotCount; ++slotIndex) {
+		HbMemory_Free(cache->slots[slotIndex].data);
+	}
+	HbMemory_Free(cache->slots);
+	HbMemory_Free(cache->itemSlots);
+	HbParallel_CondEvent_Destroy(&cache->loadedCondEvent);
+	HbParallel_Mutex_Destroy(&cache->mutex);
+}
+
+// The functions below must be called with the mutex locked.
+
+static void HbPacki_Cache_FreeSlot(HbPack_Cache * cache, uint32_t slotIndex) {
+	HbPack_Cache_Slot * slot = &cache->slots[slotIndex];
+	cache->itemSlots[slot->itemIndex] = HbPack_InvalidItemIndex;
+	cache->stats.residentSize -= slot->size;
+	--cache->stats.residentItemCount;
+	HbMemory_Free(slot->data);
+	slot->data = NULL;
+	slot->free = 1;
+	slot->itemIndex = cache->firstFreeSlot;
+	cache->firstFreeSlot = slotIndex;
+}
+
+static uint32_t HbPacki_Cache_AllocateSlot(HbPack_Cache * cache) {
+	if (cache->firstFreeSlot == HbPack_InvalidItemIndex) {
+		// There can't be more slots than items, and every item occupies at most one slot.
+		uint32_t oldSlotCount = cache->slotCount;
+		uint32_t newSlotCount = HbMinU32(HbMaxU32(oldSlotCount * 2, 16), cache->info.itemCount);
+		size_t slotsSize = (size_t) newSlotCount * sizeof(HbPack_Cache_Slot);
+		if (cache->slots != NULL) {
+			HbMemory_Realloc((void * *) &cache->slots, slotsSize);
+		} else {
+			cache->slots = HbMemory_Alloc(cache->tag, slotsSize, HbFalse);
+		}
+		for (uint32_t slotIndex = oldSlotCount; slotIndex < newSlotCount; ++slotIndex) {
+			HbPack_Cache_Slot * slot = &cache->slots[slotIndex];
+			slot->data = NULL;
+			slot->free = 1;
+			slot->itemIndex = slotIndex + 1 < newSlotCount ? slotIndex + 1 : HbPack_InvalidItemIndex;
+		}
+		cache->firstFreeSlot = oldSlotCount;
+		cache->slotCount = newSlotCount;
+	}
+	uint32_t slotIndex = cache->firstFreeSlot;
+	cache->firstFreeSlot = cache->slots[slotIndex].itemIndex;
+	cache->slots[slotIndex].free = 0;
+	return slotIndex;
+}
+
+static void HbPacki_Cache_EvictToFit(HbPack_Cache * cache, uint64_t incomingSize) {
+	// In the first revolution, the hand may only clear the referenced bits, so two revolutions at most.
+	uint32_t stepsLeft = cache->slotCount * 2;
+	while (cache->stats.residentSize + incomingSize > cache->budget && cache->stats.residentItemCount != 0 && stepsLeft-- != 0) {
+		if (cache->clockHand >= cache->slotCount) {
+			cache->clockHand = 0;
+		}
+		uint32_t slotIndex = cache->clockHand++;
+		HbPack_Cache_Slot * slot = &cache->slots[slotIndex];
+		if (slot->free || slot->loading || slot->pinCount != 0) {
+			continue;
+		}
+		if (slot->referenced) {
+			slot->referenced = 0;
+			continue;
+		}
+		HbPacki_Cache_FreeSlot(cache, slotIndex);
+		++cache->stats.evictions;
+	}
+}
+
+void HbPack_Cache_SetBudget(HbPack_Cache * cache, uint64_t budget) {
+	HbParallel_Mutex_Lock(&cache->mutex);
+	cache->budget = budget;
+	HbPacki_Cache_EvictToFit(cache, 0);
+	HbParallel_Mutex_Unlock(&cache->mutex);
+}
+
+void const * HbPack_Cache_Acquire(HbPack_Cache * cache, uint32_t itemIndex) {
+	HbParallel_Mutex_Lock(&cache->mutex);
+	uint32_t slotIndex;
+	while ((slotIndex = cache->itemSlots[itemIndex]) != HbPack_InvalidItemIndex) {
+		HbPack_Cache_Slot * slot = &cache->slots[slotIndex];
+		if (!slot->loading) {
+			++slot->pinCount;
+			slot->referenced = 1;
+			++cache->stats.hits;
+			void const * data = slot->data;
+			HbParallel_Mutex_Unlock(&cache->mutex);
+			return data;
+		}
+		// If loading fails in the other thread, the item will not be resident anymore, and this thread will try to load it itself.
+		HbParallel_CondEvent_Await(&cache->loadedCondEvent, &cache->mutex);
+	}
+	++cache->stats.misses;
+	uint32_t size = HbPack_GetItemSize(&cache->info, itemIndex);
+	HbPacki_Cache_EvictToFit(cache, size);
+	// Reserve the slot before reading so other threads wait for this load instead of reading the same item, and account for the size.
+	slotIndex = HbPacki_Cache_AllocateSlot(cache);
+	HbPack_Cache_Slot * slot = &cache->slots[slotIndex];
+	slot->itemIndex = itemIndex;
+	slot->size = size;
+	slot->pinCount = 1;
+	slot->loading = 1;
+	slot->referenced = 1;
+	cache->itemSlots[itemIndex] = slotIndex;
+	cache->stats.residentSize += size;
+	++cache->stats.residentItemCount;
+	HbParallel_Mutex_Unlock(&cache->mutex);
+
+	void * data = HbMemory_TryAlloc(cache->tag, HbMaxU32(size, 1), HbTrue);
+	HbBool loaded = data != NULL && cache->read(cache->readUserData, HbPack_GetItemOffset(&cache->info, itemIndex), data, size);
+	if (loaded && cache->verifyContents) {
+		loaded = (HbHash_XXH64_Hash(data, size, HbPack_ContentHashSeed) == HbPack_GetContentHashes(&cache->info)[itemIndex]);
+	}
+
+	HbParallel_Mutex_Lock(&cache->mutex);
+	// The slots may have been reallocated while reading.
+	slot = &cache->slots[slotIndex];
+	slot->loading = 0;
+	if (loaded) {
+		slot->data = data;
+	} else {
+		HbMemory_Free(data);
+		HbPacki_Cache_FreeSlot(cache, slotIndex);
+		++cache->stats.readFailures;
+		data = NULL;
+	}
+	HbParallel_CondEvent_SignalAll(&cache->loadedCondEvent);
+	HbParallel_Mutex_Unlock(&cache->mutex);
+	return data;
+}
+
+void HbPack_Cache_Release(HbPack_Cache * cache, uint32_t itemIndex) {
+	HbParallel_Mutex_Lock(&cache->mutex);
+	--cache->slots[cache->itemSlots[itemIndex]].pinCount;
+	HbParallel_Mutex_Unlock(&cache->mutex);
+}
+
+HbBool HbPack_Cache_Prefetch(HbPack_Cache * cache, uint32_t itemIndex) {
+	if (HbPack_Cache_Acquire(cache, itemIndex) == NULL) {
+		return HbFalse;
+	}
+	HbPack_Cache_Release(cache, itemIndex);
+	return HbTrue;
+}
+
+HbBool HbPack_Cache_Evict(HbPack_Cache * cache, uint32_t itemIndex) {
+	HbParallel_Mutex_Lock(&cache->mutex);
+	HbBool evicted = HbTrue;
+	uint32_t slotIndex = cache->itemSlots[itemIndex];
+	if (slotIndex != HbPack_InvalidItemIndex) {
+		HbPack_Cache_Slot const * slot = &cache->slots[slotIndex];
+		if (slot->loading || slot->pinCount != 0) {
+			evicted = HbFalse;
+		} else {
+			HbPacki_Cache_FreeSlot(cache, slotIndex);
+			++cache->stats.evictions;
+		}
+	}
+	HbParallel_Mutex_Unlock(&cache->mutex);
+	return evicted;
+}
+
+void HbPack_Cache_GetStats(HbPack_Cache * cache, HbPack_Cache_Stats * stats) {
+	HbParallel_Mutex_Lock(&cache->mutex);
+	*stats = cache->stats;
+	HbParallel_Mutex_Unlock(&cache->mutex);
+}
@@ -0,0 +1,169 @@
+#include "HbFeedback.h"
+#include "HbHash.h"
+#include "HbPack.h"
+
+void HbPack_Mount_Init(HbPack_Mount * mount, HbMemory_Tag * tag) {
+	mount->tag = tag;
+	mount->packs = NULL;
+	mount->entries = NULL;
+	mount->hashMap = NULL;
+	mount->packCount = 0;
+	mount->entryCount = 0;
+	mount->hashMapIndexMask = 0;
+}
+
+void HbPack_Mount_Destroy(HbPack_Mount * mount) {
+	HbMemory_Free(mount->hashMap);
+	HbMemory_Free(mount->entries);
+	HbMemory_Free(mount->packs);
+}
+
+static void HbPacki_Mount_RebuildHashMap(HbPack_Mount * mount) {
+	HbMemory_Free(mount->hashMap);
+	mount->hashMap = NULL;
+	mount->hashMapIndexMask = 0;
+	uint32_t entryCount = mount->entryCount;
+	uint32_t indexBitCount = HbHash_MapUtil_GetNeededEntriesLog2(entryCount);
+	if (indexBitCount == 0) {
+		return;
+	}
+	uint32_t hashMapIndexMask = ((uint32_t) 1 << indexBitCount) - 1;
+	uint32_t * hashMap = HbMemory_Alloc(mount->tag, ((size_t) hashMapIndexMask + 1) * sizeof(uint32_t), HbFalse);
+	memset(hashMap, 0xFF, ((size_t) hashMapIndexMask + 1) * sizeof(uint32_t));
+	for (uint32_t entryIndex = 0; entryIndex < entryCount; ++entryIndex) {
+		uint32_t hash = mount->entries[entryIndex].nameHash;
+		uint32_t hashIndex = hash & hashMapIndexMask;
+		while (hashMap[hashIndex] != HbPack_InvalidItemIndex) {
+			HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+		}
+		hashMap[hashIndex] = entryIndex;
+	}
+	mount->hashMap = hashMap;
+	mount->hashMapIndexMask = hashMapIndexMask;
+}
+
+// Decodes names of items going through a directory in order, so front-coded names are not decoded from the beginning of the block.
+typedef struct HbPacki_Mount_NameCursor {
+	HbPack_Info const * info;
+	uint32_t itemIndex;
+	size_t length;
+	char name[HbPack_MaxNameSize];
+} HbPacki_Mount_NameCursor;
+
+static void HbPacki_Mount_NameCursor_Seek(HbPacki_Mount_NameCursor * cursor, HbPack_Info const * info, uint32_t itemIndex) {
+	if (cursor->info == info && cursor->itemIndex == itemIndex) {
+		return;
+	}
+	if (cursor->info == info && cursor->itemIndex + 1 == itemIndex) {
+		cursor->length = HbPack_GetNextItemName(info, itemIndex, cursor->name, cursor->length);
+	} else {
+		cursor->length = HbPack_GetItemName(info, itemIndex, cursor->name);
+	}
+	cursor->info = info;
+	cursor->itemIndex = itemIndex;
+}
+
+HbBool HbPack_Mount_Add(HbPack_Mount * mount, HbPack_Info const * info) {
+	if (mount->packCount >= HbPack_InvalidItemIndex || (uint64_t) mount->entryCount + info->itemCount > HbHash_MapUtil_MaxUsedEntries) {
+		return HbFalse;
+	}
+
+	uint32_t packIndex = mount->packCount;
+	size_t packsSize = ((size_t) packIndex + 1) * sizeof(HbPack_Info);
+	if (mount->packs != NULL) {
+		HbMemory_Realloc((void * *) &mount->packs, packsSize);
+	} else {
+		mount->packs = HbMemory_Alloc(mount->tag, packsSize, HbFalse);
+	}
+	mount->packs[packIndex] = *info;
+	mount->packCount = packIndex + 1;
+	HbPack_Info const * newPack = &mount->packs[packIndex];
+
+	// Both the merged directory and the directory of the new pack are sorted, so merge them in one pass.
+	// For equal paths, the item from the new pack replaces the old entry.
+	uint32_t oldEntryCount = mount->entryCount, newItemCount = info->itemCount;
+	HbPack_Mount_Entry const * oldEntries = mount->entries;
+	HbPack_Mount_Entry * entries = HbMemory_Alloc(mount->tag,
+			HbMaxSize(((size_t) oldEntryCount + newItemCount) * sizeof(HbPack_Mount_Entry), 1), HbFalse);
+	HbPacki_Mount_NameCursor oldNameCursor, newNameCursor;
+	oldNameCursor.info = NULL;
+	newNameCursor.info = NULL;
+	uint32_t entryCount = 0, oldEntryIndex = 0, newItemIndex = 0;
+	while (oldEntryIndex < oldEntryCount || newItemIndex < newItemCount) {
+		int32_t comparison;
+		if (oldEntryIndex >= oldEntryCount) {
+			comparison = 1;
+		} else if (newItemIndex >= newItemCount) {
+			comparison = -1;
+		} else {
+			HbPack_Mount_Entry const * oldEntry = &oldEntries[oldEntryIndex];
+			HbPacki_Mount_NameCursor_Seek(&oldNameCursor, &mount->packs[oldEntry->packIndex], oldEntry->itemIndex);
+			HbPacki_Mount_NameCursor_Seek(&newNameCursor, newPack, newItemIndex);
+			comparison = HbTextA_CompareCaseless(oldNameCursor.name, newNameCursor.name);
+		}
+		if (comparison < 0) {
+			entries[entryCount++] = oldEntries[oldEntryIndex++];
+		} else {
+			if (comparison == 0) {
+				++oldEntryIndex; // Shadowed.
+			}
+			entries[entryCount].packIndex = packIndex;
+			entries[entryCount].itemIndex = newItemIndex;
+			entries[entryCount].nameHash = HbPack_GetItemNameHash(newPack, newItemIndex);
+			++newItemIndex;
+			++entryCount;
+		}
+	}
+	HbMemory_Free(mount->entries);
+	mount->entries = entries;
+	mount->entryCount = entryCount;
+
+	HbPacki_Mount_RebuildHashMap(mount);
+	return HbTrue;
+}
+
+uint32_t HbPack_Mount_FindFirstPrefixed(HbPack_Mount const * mount, char const * prefix) {
+	size_t prefixLength = HbTextA_Length(prefix);
+	char name[HbPack_MaxNameSize];
+	// Lower bound - the first entry not less than the prefix.
+	uint32_t lowerBound = 0, upperBound = mount->entryCount;
+	while (lowerBound < upperBound) {
+		uint32_t entryIndex = lowerBound + ((upperBound - lowerBound) >> 1);
+		HbPack_Mount_GetItemName(mount, entryIndex, name);
+		if (HbTextA_ComparePartCaseless(name, prefix, prefixLength) < 0) {
+			lowerBound = entryIndex + 1;
+		} else {
+			upperBound = entryIndex;
+		}
+	}
+	if (lowerBound >= mount->entryCount) {
+		return HbPack_InvalidItemIndex;
+	}
+	HbPack_Mount_GetItemName(mount, lowerBound, name);
+	if (HbTextA_ComparePartCaseless(name, prefix, prefixLength) != 0) {
+		return HbPack_InvalidItemIndex;
+	}
+	return lowerBound;
+}
+
+uint32_t HbPack_Mount_Find(HbPack_Mount const * mount, char const * path) {
+	if (mount->hashMap == NULL) {
+		return HbPack_InvalidItemIndex;
+	}
+	char name[HbPack_MaxNameSize];
+	uint32_t hashMapIndexMask = mount->hashMapIndexMask;
+	uint32_t nameHash = HbHash_FNV1a_HashTextACaseless(path);
+	uint32_t hash = nameHash;
+	uint32_t hashIndex = hash & hashMapIndexMask;
+	uint32_t entryIndex;
+	while ((entryIndex = mount->hashMap[hashIndex]) != HbPack_InvalidItemIndex) {
+		if (mount->entries[entryIndex].nameHash == nameHash) {
+			HbPack_Mount_GetItemName(mount, entryIndex, name);
+			if (HbTextA_CompareCaseless(name, path) == 0) {
+				return entryIndex;
+			}
+		}
+		HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+	}
+	return HbPack_InvalidItemIndex;
+}
@@ -0,0 +1,162 @@
+#include "HbHash.h"
+#include "HbPack.h"
+
+// Length of the prefix shared with the previous name, or 0 for block heads, stored fully.
+static size_t HbPacki_Write_GetSharedPrefixLength(HbPack_Write_Item const * items, uint32_t itemIndex) {
+	if ((itemIndex & ((1u << HbPack_NameBlockSizeLog2) - 1)) == 0) {
+		return 0;
+	}
+	char const * name = items[itemIndex].name, * previousName = items[itemIndex - 1].name;
+	size_t prefixLength = 0;
+	while (name[prefixLength] != '\0' && name[prefixLength] == previousName[prefixLength]) {
+		++prefixLength;
+	}
+	return prefixLength;
+}
+
+static int HbPacki_Write_CompareItems(void const * item1, void const * item2) {
+	return HbTextA_CompareCaseless(((HbPack_Write_Item const *) item1)->name, ((HbPack_Write_Item const *) item2)->name);
+}
+
+void * HbPack_Write(HbMemory_Tag * tag, HbPack_Write_Item * items, uint32_t itemCount,
+		HbBool writeHashMap, HbBool writeContentHashes, uint32_t * packSize) {
+	if (itemCount == 0 || itemCount > HbPack_MaxItemCount) {
+		return NULL;
+	}
+	for (uint32_t itemIndex = 0; itemIndex < itemCount; ++itemIndex) {
+		size_t nameLength = HbTextA_Length(items[itemIndex].name);
+		if (nameLength == 0 || nameLength >= HbPack_MaxNameSize) {
+			return NULL;
+		}
+	}
+	qsort(items, itemCount, sizeof(HbPack_Write_Item), HbPacki_Write_CompareItems);
+	for (uint32_t itemIndex = 1; itemIndex < itemCount; ++itemIndex) {
+		if (HbTextA_CompareCaseless(items[itemIndex - 1].name, items[itemIndex].name) == 0) {
+			return NULL;
+		}
+	}
+
+	uint64_t size = sizeof(HbPack_HeaderV2) + (uint64_t) itemCount * sizeof(HbPack_DirectoryEntryV2);
+	uint32_t hashMapIndexMask = 0;
+	uint64_t hashMapOffset = size;
+	if (writeHashMap) {
+		uint32_t hashMapIndexMaskLog2 = HbHash_MapUtil_GetNeededEntriesLog2(itemCount);
+		if (hashMapIndexMaskLog2 == UINT32_MAX) {
+			return NULL;
+		}
+		hashMapIndexMask = ((uint32_t) 1 << hashMapIndexMaskLog2) - 1;
+		size += ((uint64_t) hashMapIndexMask + 1) * sizeof(uint32_t);
+	}
+	uint64_t contentHashesOffset = size;
+	if (writeContentHashes) {
+		size += (uint64_t) itemCount * sizeof(uint64_t);
+	}
+	// Front-coded names - varint shared prefix length (not for block heads) and the zero-terminated suffix.
+	uint64_t namesOffset = size;
+	for (uint32_t itemIndex = 0; itemIndex < itemCount; ++itemIndex) {
+		size_t prefixLength = HbPacki_Write_GetSharedPrefixLength(items, itemIndex);
+		if ((itemIndex & ((1u << HbPack_NameBlockSizeLog2) - 1)) != 0) {
+			size += (prefixLength >= 0x80 ? 2 : 1);
+		}
+		size += HbTextA_Length(items[itemIndex].name) - prefixLength + 1;
+	}
+	uint64_t namesSize = size - namesOffset;
+	size = (size + 15) & ~((uint64_t) 15);
+
+	// Find the items with identical contents (and the first item with them) using content hashes.
+	// dataOwners[i] is the index of the item whose data is stored for item i.
+	uint64_t * contentHashes = HbMemory_Alloc(tag, (size_t) itemCount * sizeof(uint64_t), HbFalse);
+	uint32_t * dataOwners = HbMemory_Alloc(tag, (size_t) itemCount * sizeof(uint32_t), HbFalse);
+	uint32_t * itemOffsets = HbMemory_Alloc(tag, (size_t) itemCount * sizeof(uint32_t), HbFalse);
+	uint32_t contentMapIndexMask = ((uint32_t) 1 << HbHash_MapUtil_GetNeededEntriesLog2(itemCount)) - 1;
+	uint32_t * contentMap = HbMemory_Alloc(tag, ((size_t) contentMapIndexMask + 1) * sizeof(uint32_t), HbFalse);
+	memset(contentMap, 0xFF, ((size_t) contentMapIndexMask + 1) * sizeof(uint32_t));
+	for (uint32_t itemIndex = 0; itemIndex < itemCount; ++itemIndex) {
+		HbPack_Write_Item const * item = &items[itemIndex];
+		uint64_t contentHash = HbHash_XXH64_Hash(item->data, item->size, HbPack_ContentHashSeed);
+		contentHashes[itemIndex] = contentHash;
+		uint32_t hash = (uint32_t) contentHash;
+		uint32_t hashIndex = hash & contentMapIndexMask;
+		uint32_t otherItemIndex;
+		while ((otherItemIndex = contentMap[hashIndex]) != HbPack_InvalidItemIndex) {
+			HbPack_Write_Item const * otherItem = &items[otherItemIndex];
+			if (contentHashes[otherItemIndex] == contentHash && otherItem->size == item->size &&
+					memcmp(otherItem->data, item->data, item->size) == 0) {
+				break;
+			}
+			HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, contentMapIndexMask);
+		}
+		if (otherItemIndex != HbPack_InvalidItemIndex) {
+			dataOwners[itemIndex] = otherItemIndex;
+			itemOffsets[itemIndex] = itemOffsets[otherItemIndex];
+			continue;
+		}
+		contentMap[hashIndex] = itemIndex;
+		dataOwners[itemIndex] = itemIndex;
+		if (size > UINT32_MAX) {
+			break;
+		}
+		itemOffsets[itemIndex] = (uint32_t) size;
+		size = (size + item->size + 15) & ~((uint64_t) 15);
+	}
+	HbMemory_Free(contentMap);
+	if (size > UINT32_MAX) {
+		HbMemory_Free(itemOffsets);
+		HbMemory_Free(dataOwners);
+		HbMemory_Free(contentHashes);
+		return NULL;
+	}
+
+	uint8_t * pack = HbMemory_Alloc(tag, (size_t) size, HbTrue);
+	memset(pack, 0, (size_t) size);
+	HbPack_HeaderV2 * header = (HbPack_HeaderV2 *) pack;
+	memcpy(header->common.id, HbPack_HeaderIDV2, sizeof(HbPack_HeaderIDV2));
+	header->common.itemCount = itemCount;
+	header->common.contentHashesPresent = (writeContentHashes ? 1 : 0);
+	header->common.hashMapPresent = (writeHashMap ? 1 : 0);
+	header->namesOffset = (uint32_t) namesOffset;
+	header->namesSize = (uint32_t) namesSize;
+	HbPack_DirectoryEntryV2 * directory = (HbPack_DirectoryEntryV2 *) (pack + sizeof(HbPack_HeaderV2));
+	uint8_t * nameRecord = pack + namesOffset;
+	for (uint32_t itemIndex = 0; itemIndex < itemCount; ++itemIndex) {
+		HbPack_Write_Item const * item = &items[itemIndex];
+		HbPack_DirectoryEntryV2 * directoryEntry = &directory[itemIndex];
+		directoryEntry->nameHash = HbHash_FNV1a_HashTextACaseless(item->name);
+		directoryEntry->nameOffset = (uint32_t) (nameRecord - (pack + namesOffset));
+		size_t prefixLength = HbPacki_Write_GetSharedPrefixLength(items, itemIndex);
+		if ((itemIndex & ((1u << HbPack_NameBlockSizeLog2) - 1)) != 0) {
+			if (prefixLength >= 0x80) {
+				*(nameRecord++) = (uint8_t) (prefixLength | 0x80);
+				*(nameRecord++) = (uint8_t) (prefixLength >> 7);
+			} else {
+				*(nameRecord++) = (uint8_t) prefixLength;
+			}
+		}
+		nameRecord += HbTextA_Copy((char *) nameRecord, HbPack_MaxNameSize, item->name + prefixLength) + 1;
+		directoryEntry->offset = itemOffsets[itemIndex];
+		directoryEntry->size = item->size;
+		if (dataOwners[itemIndex] == itemIndex) {
+			memcpy(pack + itemOffsets[itemIndex], item->data, item->size);
+		}
+	}
+	if (writeHashMap) {
+		uint32_t * hashMap = (uint32_t *) (pack + hashMapOffset);
+		memset(hashMap, 0xFF, ((size_t) hashMapIndexMask + 1) * sizeof(uint32_t));
+		for (uint32_t itemIndex = 0; itemIndex < itemCount; ++itemIndex) {
+			uint32_t hash = directory[itemIndex].nameHash;
+			uint32_t hashIndex = hash & hashMapIndexMask;
+			while (hashMap[hashIndex] != HbPack_InvalidItemIndex) {
+				HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+			}
+			hashMap[hashIndex] = itemIndex;
+		}
+	}
+	if (writeContentHashes) {
+		memcpy(pack + contentHashesOffset, contentHashes, (size_t) itemCount * sizeof(uint64_t));
+	}
+	HbMemory_Free(itemOffsets);
+	HbMemory_Free(dataOwners);
+	HbMemory_Free(contentHashes);
+	*packSize = (uint32_t) size;
+	return pack;
+}
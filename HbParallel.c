@@ -1,7 +1,10 @@
+#if defined(__linux__) && !defined(_GNU_SOURCE)
+#define _GNU_SOURCE // pthread_setname_np.
+#endif
 #include "HbParallel.h"
+#include "HbText.h"
 
 #if HbPlatform_OS_Windows
-#include "HbText.h"
 #include <process.h>
 #include <Windows.h>
 
@@ -62,4 +65,38 @@ HbBool HbParallel_Thread_Start(HbParallel_Thread * thread, char const * name, Hb
 	return HbTrue;
 }
 
+#elif HbPlatform_OS_Linux
+
+typedef struct HbParalleli_Linux_Thread_Parameters {
+	HbParallel_Thread_Entry entry;
+	void * data;
+} HbParalleli_Linux_Thread_Parameters;
+
+static void * HbParalleli_Linux_Thread_Entry(void * parametersPointer) {
+	HbParalleli_Linux_Thread_Parameters parameters = *((HbParalleli_Linux_Thread_Parameters const *) parametersPointer);
+	free(parametersPointer);
+	parameters.entry(parameters.data);
+	return NULL;
+}
+
+HbBool HbParallel_Thread_Start(HbParallel_Thread * thread, char const * name, HbParallel_Thread_Entry entry, void * data) {
+	HbParalleli_Linux_Thread_Parameters * parameters = malloc(sizeof(HbParalleli_Linux_Thread_Parameters));
+	if (parameters == NULL) {
+		return HbFalse;
+	}
+	parameters->entry = entry;
+	parameters->data = data;
+	if (pthread_create(thread, NULL, HbParalleli_Linux_Thread_Entry, parameters) != 0) {
+		free(parameters);
+		return HbFalse;
+	}
+	if (name != NULL && name[0] != '\0') {
+		// Linux names are limited to HbParallel_Thread_MaxNameLength too, and longer ones are not truncated, but rejected.
+		char truncatedName[HbParallel_Thread_MaxNameLength + 1];
+		HbTextA_Copy(truncatedName, HbArrayLength(truncatedName), name);
+		pthread_setname_np(*thread, truncatedName);
+	}
+	return HbTrue;
+}
+
 #endif
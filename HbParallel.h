@@ -5,6 +5,9 @@
 #include <intrin.h>
 #include <Windows.h>
 #endif
+#if HbPlatform_OS_Linux
+#include <pthread.h>
+#endif
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -51,6 +54,44 @@ HbForceInline void HbParallel_Thread_Destroy(HbParallel_Thread * thread) {
 	CloseHandle(*thread);
 }
 
+#elif HbPlatform_OS_Linux
+/***********************************
+ * POSIX parallelization primitives
+ ***********************************/
+
+typedef pthread_mutex_t HbParallel_Mutex;
+HbForceInline HbBool HbParallel_Mutex_Init(HbParallel_Mutex * mutex) {
+	return pthread_mutex_init(mutex, NULL) == 0;
+}
+#define HbParallel_Mutex_Destroy pthread_mutex_destroy
+#define HbParallel_Mutex_Lock pthread_mutex_lock
+#define HbParallel_Mutex_Unlock pthread_mutex_unlock
+
+typedef pthread_rwlock_t HbParallel_RWLock;
+HbForceInline HbBool HbParallel_RWLock_Init(HbParallel_RWLock * lock) {
+	return pthread_rwlock_init(lock, NULL) == 0;
+}
+#define HbParallel_RWLock_Destroy pthread_rwlock_destroy
+#define HbParallel_RWLock_LockRead pthread_rwlock_rdlock
+#define HbParallel_RWLock_UnlockRead pthread_rwlock_unlock
+#define HbParallel_RWLock_LockWrite pthread_rwlock_wrlock
+#define HbParallel_RWLock_UnlockWrite pthread_rwlock_unlock
+
+// Initialization can only fail because of resource limits, which are not expected for condition variables without attributes.
+typedef pthread_cond_t HbParallel_CondEvent;
+#define HbParallel_CondEvent_Init(condEvent) pthread_cond_init((condEvent), NULL)
+#define HbParallel_CondEvent_Destroy pthread_cond_destroy
+#define HbParallel_CondEvent_Await pthread_cond_wait
+#define HbParallel_CondEvent_Signal pthread_cond_signal
+#define HbParallel_CondEvent_SignalAll pthread_cond_broadcast
+
+typedef pthread_t HbParallel_Thread;
+typedef void (* HbParallel_Thread_Entry)(void * data);
+HbBool HbParallel_Thread_Start(HbParallel_Thread * thread, char const * name, HbParallel_Thread_Entry entry, void * data);
+HbForceInline void HbParallel_Thread_Destroy(HbParallel_Thread * thread) {
+	pthread_join(*thread, NULL);
+}
+
 #else
 #error No parallelization API implementation for the target OS.
 #endif
@@ -0,0 +1,23 @@
+#include "HbPlatform.h"
+#if HbPlatform_OS_Linux
+#include "HbFeedback.h"
+#include <time.h>
+
+static struct timespec HbPlatformi_Time_Linux_Origin;
+
+void HbPlatform_Init() {
+	if (clock_gettime(CLOCK_MONOTONIC, &HbPlatformi_Time_Linux_Origin) != 0) {
+		HbFeedback_Crash("HbPlatform_Init", "Failed to obtain the monotonic clock time.");
+	}
+}
+
+void HbPlatform_Shutdown() {}
+
+int64_t HbPlatform_Time_RealUsec() {
+	struct timespec time;
+	clock_gettime(CLOCK_MONOTONIC, &time);
+	return ((int64_t) time.tv_sec - (int64_t) HbPlatformi_Time_Linux_Origin.tv_sec) * 1000000 +
+			((int64_t) time.tv_nsec - (int64_t) HbPlatformi_Time_Linux_Origin.tv_nsec) / 1000;
+}
+
+#endif
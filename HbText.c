@@ -1,3 +1,5 @@
+#include "HbBit.h"
+#include "HbMath.h"
 #include "HbText.h"
 #include <stdio.h>
 
@@ -40,6 +42,41 @@ size_t HbTextA_Copy(char * target, size_t targetBufferSize, char const * source)
 	return (size_t) (target - originalTarget);
 }
 
+int HbTextA_ComparePartCaseless(char const * a, char const * b, size_t maxLength) {
+	size_t offset = 0;
+	while (offset < maxLength) {
+		char const * aBlock = a + offset, * bBlock = b + offset;
+		if (!HbTextA_CanReadU8x16(aBlock) || !HbTextA_CanReadU8x16(bBlock)) {
+			// One character at a time until the next page.
+			int difference = (uint8_t) HbTextA_CharToLower(*aBlock) - (uint8_t) HbTextA_CharToLower(*bBlock);
+			if (difference != 0 || *aBlock == '\0') {
+				return difference;
+			}
+			++offset;
+			continue;
+		}
+		HbMath_U8x16 aLower = HbTextA_CharsToLowerU8x16(HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) aBlock));
+		HbMath_U8x16 bLower = HbTextA_CharsToLowerU8x16(HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) bBlock));
+		// Stopping at the first different character or at the terminator of both.
+		uint32_t stopMask = ~(uint32_t) HbMath_U8x16_SignBits(HbMath_U8x16_CompareEqual(aLower, bLower)) |
+				(uint32_t) HbMath_U8x16_SignBits(HbMath_U8x16_CompareEqual(aLower, HbMath_U8x16_LoadZero()));
+		stopMask &= 0xFFFF;
+		if (stopMask != 0) {
+			size_t stopOffset = offset + (uint32_t) HbBit_LowestOneU32(stopMask);
+			if (stopOffset >= maxLength) {
+				return 0;
+			}
+			return (uint8_t) HbTextA_CharToLower(a[stopOffset]) - (uint8_t) HbTextA_CharToLower(b[stopOffset]);
+		}
+		offset += 16;
+	}
+	return 0;
+}
+
+int HbTextA_CompareCaseless(char const * a, char const * b) {
+	return HbTextA_ComparePartCaseless(a, b, SIZE_MAX);
+}
+
 size_t HbTextA_FormatV(char * target, size_t targetBufferSize, char const * format, va_list arguments) {
 	if (target == NULL || targetBufferSize == 0) {
 		// Normalize both arguments.
@@ -73,7 +110,9 @@ size_t HbTextA_Format(char * target, size_t targetBufferSize, char const * forma
  * UTF-8
  ********/
 
-HbTextU32 HbTextU8_NextChar(HbTextU8 const * * cursor, size_t maxElems) {
+// The decoders and the encoders are inlined into the bulk conversion loops.
+
+HbForceInline HbTextU32 HbTextU8i_NextChar(HbTextU8 const * * cursor, size_t maxElems) {
 	if (maxElems == 0) {
 		return '\0';
 	}
@@ -120,7 +159,40 @@ HbTextU32 HbTextU8_NextChar(HbTextU8 const * * cursor, size_t maxElems) {
 	return HbText_InvalidSubstitute;
 }
 
-uint32_t HbTextU8_WriteValidChar(HbTextU8 * target, size_t targetBufferSizeElems, HbTextU32 character) {
+HbForceInline HbTextU32 HbTextU16i_NextChar(HbTextU16 const * * cursor, size_t maxElems, HbBool nonNativeEndian) {
+	if (maxElems == 0) {
+		return '\0';
+	}
+	HbTextU16 first = (*cursor)[0];
+	if (first == '\0') {
+		return '\0';
+	}
+	++(*cursor);
+	if (nonNativeEndian) {
+		first = HbByteSwapU16(first);
+	}
+	HbTextU32 character;
+	if ((first >> 10) == (0xD800 >> 10)) {
+		if (maxElems < 2) {
+			return HbText_InvalidSubstitute;
+		}
+		HbTextU16 second = (*cursor)[0];
+		if (nonNativeEndian) {
+			second = HbByteSwapU16(second);
+		}
+		// A high surrogate not followed by a low one is invalid on its own, the next element is a separate character.
+		if ((second >> 10) != (0xDC00 >> 10)) {
+			return HbText_InvalidSubstitute;
+		}
+		++(*cursor);
+		character = 0x10000 + (((HbTextU32) (first & 0x3FF) << 10) | (second & 0x3FF));
+	} else {
+		character = first;
+	}
+	return HbTextU32_ValidateChar(character);
+}
+
+HbForceInline uint32_t HbTextU8i_WriteValidChar(HbTextU8 * target, size_t targetBufferSizeElems, HbTextU32 character) {
 	uint32_t elemCount = HbTextU8_ValidCharElemCount(character);
 	if (targetBufferSizeElems < elemCount) {
 		return 0;
@@ -149,61 +221,7 @@ uint32_t HbTextU8_WriteValidChar(HbTextU8 * target, size_t targetBufferSizeElems
 	return elemCount;
 }
 
-size_t HbTextU8_FromU16(HbTextU8 * target, size_t targetBufferSizeElems, HbTextU16 const * source, HbBool nonNativeEndian) {
-	HbTextU8 * targetStart = target;
-	if (targetBufferSizeElems != 0) {
-		--targetBufferSizeElems;
-		HbTextU32 character;
-		while (targetBufferSizeElems != 0 && (character = HbTextU16_NextChar(&source, HbTextU16_MaxCharElems, nonNativeEndian)) != '\0') {
-			uint32_t written = HbTextU8_WriteValidChar(target, targetBufferSizeElems, character);
-			if (written == 0) {
-				break;
-			}
-			target += written;
-			targetBufferSizeElems -= written;
-		}
-		*target = '\0';
-	}
-	return (size_t) (target - targetStart);
-}
-
-/*********
- * UTF-16
- *********/
-
-HbTextU32 HbTextU16_NextChar(HbTextU16 const * * cursor, size_t maxElems, HbBool nonNativeEndian) {
-	if (maxElems == 0) {
-		return '\0';
-	}
-	HbTextU16 first = (*cursor)[0];
-	if (first == '\0') {
-		return '\0';
-	}
-	++(*cursor);
-	if (nonNativeEndian) {
-		first = HbByteSwapU16(first);
-	}
-	HbTextU32 character;
-	if ((first >> 10) == (0xD800 >> 10)) {
-		if (maxElems < 2) {
-			return HbText_InvalidSubstitute;
-		}
-		HbTextU16 second = (*cursor)[0];
-		if ((second >> 10) == (0xDC00 >> 10)) {
-			return HbText_InvalidSubstitute;
-		}
-		++(*cursor);
-		if (nonNativeEndian) {
-			second = HbByteSwapU16(second);
-		}
-		character = ((HbTextU32) (first & 0x3FF) << 10) | (second & 0x3FF);
-	} else {
-		character = first;
-	}
-	return HbTextU32_ValidateChar(character);
-}
-
-uint32_t HbTextU16_WriteValidChar(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU32 character, HbBool nonNativeEndian) {
+HbForceInline uint32_t HbTextU16i_WriteValidChar(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU32 character, HbBool nonNativeEndian) {
 	if (targetBufferSizeElems == 0) {
 		return 0;
 	}
@@ -225,6 +243,135 @@ uint32_t HbTextU16_WriteValidChar(HbTextU16 * target, size_t targetBufferSizeEle
 	return 1;
 }
 
+HbTextU32 HbTextU8_NextChar(HbTextU8 const * * cursor, size_t maxElems) {
+	return HbTextU8i_NextChar(cursor, maxElems);
+}
+
+uint32_t HbTextU8_WriteValidChar(HbTextU8 * target, size_t targetBufferSizeElems, HbTextU32 character) {
+	return HbTextU8i_WriteValidChar(target, targetBufferSizeElems, character);
+}
+
+size_t HbTextU8_LengthU16ElemsSized(HbTextU8 const * text, size_t elems) {
+	HbTextU8 const * textEnd = text + elems;
+	size_t length = 0;
+	while (text != textEnd) {
+		// Count ASCII 16 elements at once.
+		while ((size_t) (textEnd - text) >= 16 && HbMath_U8x16_SignBits(HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) text)) == 0) {
+			text += 16;
+			length += 16;
+		}
+		if (text == textEnd) {
+			break;
+		}
+		// Count characters one by one until the next ASCII one after them, then try the vector path again.
+		do {
+			if (*text == '\0') {
+				++text;
+				++length;
+				continue;
+			}
+			length += 1 + ((HbTextU8i_NextChar(&text, (size_t) (textEnd - text)) >> 16) != 0);
+		} while (text != textEnd && (*text & 0x80) != 0);
+	}
+	return length;
+}
+
+size_t HbTextU8_FromU16Sized(HbTextU8 * target, size_t targetSizeElems,
+		HbTextU16 const * source, size_t sourceElems, HbBool nonNativeEndian) {
+	HbTextU8 * targetStart = target, * targetEnd = target + targetSizeElems;
+	HbTextU16 const * sourceEnd = source + sourceElems;
+	HbMath_U16x8 nonASCIIBits = HbMath_U16x8_LoadReplicated(0xFF80), zero = HbMath_U16x8_LoadZero();
+	HbTextU16 nonASCIIElemBits = nonNativeEndian ? 0x80FF : 0xFF80;
+	while (source != sourceEnd) {
+		// Convert ASCII 8 elements at once.
+		while ((size_t) (sourceEnd - source) >= 8 && (size_t) (targetEnd - target) >= 8) {
+			HbMath_U16x8 elems = HbMath_U16x8_LoadUnaligned((HbMath_U16x8 const *) source);
+			if (nonNativeEndian) {
+				elems = HbMath_U16x8_SwapBytes(elems);
+			}
+			if (HbMath_U8x16_SignBits(HbMath_U16x8_CompareEqual(HbMath_U16x8_And(elems, nonASCIIBits), zero)) != 0xFFFF) {
+				break;
+			}
+			HbMath_U8x16_StoreLower64(target, HbMath_U16x8_PackToU8x16(elems, elems));
+			source += 8;
+			target += 8;
+		}
+		if (source == sourceEnd) {
+			break;
+		}
+		// Convert characters one by one until the next ASCII one after them, then try the vector path again.
+		do {
+			uint32_t written;
+			if (*source == '\0') {
+				if (target == targetEnd) {
+					return (size_t) (target - targetStart);
+				}
+				*target = '\0';
+				++source;
+				written = 1;
+			} else {
+				HbTextU32 character = HbTextU16i_NextChar(&source, (size_t) (sourceEnd - source), nonNativeEndian);
+				written = HbTextU8i_WriteValidChar(target, (size_t) (targetEnd - target), character);
+				if (written == 0) {
+					return (size_t) (target - targetStart);
+				}
+			}
+			target += written;
+		} while (source != sourceEnd && (*source & nonASCIIElemBits) != 0);
+	}
+	return (size_t) (target - targetStart);
+}
+
+size_t HbTextU8_FromU16(HbTextU8 * target, size_t targetBufferSizeElems, HbTextU16 const * source, HbBool nonNativeEndian) {
+	if (targetBufferSizeElems == 0) {
+		return 0;
+	}
+	size_t length = HbTextU8_FromU16Sized(target, targetBufferSizeElems - 1,
+			source, HbTextU16_LengthElemsNoTerminator(source), nonNativeEndian);
+	target[length] = '\0';
+	return length;
+}
+
+/*********
+ * UTF-16
+ *********/
+
+HbTextU32 HbTextU16_NextChar(HbTextU16 const * * cursor, size_t maxElems, HbBool nonNativeEndian) {
+	return HbTextU16i_NextChar(cursor, maxElems, nonNativeEndian);
+}
+
+size_t HbTextU16_LengthU8ElemsSized(HbTextU16 const * text, size_t elems, HbBool nonNativeEndian) {
+	HbTextU16 const * textEnd = text + elems;
+	HbTextU16 nonASCIIElemBits = nonNativeEndian ? 0x80FF : 0xFF80;
+	HbMath_U16x8 nonASCIIBits = HbMath_U16x8_LoadReplicated(nonASCIIElemBits), zero = HbMath_U16x8_LoadZero();
+	size_t length = 0;
+	while (text != textEnd) {
+		// Count ASCII 8 elements at once.
+		while ((size_t) (textEnd - text) >= 8 && HbMath_U8x16_SignBits(HbMath_U16x8_CompareEqual(
+				HbMath_U16x8_And(HbMath_U16x8_LoadUnaligned((HbMath_U16x8 const *) text), nonASCIIBits), zero)) == 0xFFFF) {
+			text += 8;
+			length += 8;
+		}
+		if (text == textEnd) {
+			break;
+		}
+		// Count characters one by one until the next ASCII one after them, then try the vector path again.
+		do {
+			if (*text == '\0') {
+				++text;
+				++length;
+				continue;
+			}
+			length += HbTextU8_ValidCharElemCount(HbTextU16i_NextChar(&text, (size_t) (textEnd - text), nonNativeEndian));
+		} while (text != textEnd && (*text & nonASCIIElemBits) != 0);
+	}
+	return length;
+}
+
+uint32_t HbTextU16_WriteValidChar(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU32 character, HbBool nonNativeEndian) {
+	return HbTextU16i_WriteValidChar(target, targetBufferSizeElems, character, nonNativeEndian);
+}
+
 size_t HbTextU16_Copy(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU16 const * source, HbBool nonNativeEndian) {
 	HbTextU16 * targetStart = target;
 	if (targetBufferSizeElems != 0) {
@@ -243,20 +390,55 @@ size_t HbTextU16_Copy(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU1
 	return (size_t) (target - targetStart);
 }
 
-size_t HbTextU16_FromU8(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU8 const * source, HbBool nonNativeEndian) {
-	HbTextU16 * targetStart = target;
-	if (targetBufferSizeElems != 0) {
-		--targetBufferSizeElems;
-		HbTextU32 character;
-		while (targetBufferSizeElems != 0 && (character = HbTextU8_NextChar(&source, HbTextU8_MaxCharElems)) != '\0') {
-			uint32_t written = HbTextU16_WriteValidChar(target, targetBufferSizeElems, character, nonNativeEndian);
-			if (written == 0) {
+size_t HbTextU16_FromU8Sized(HbTextU16 * target, size_t targetSizeElems,
+		HbTextU8 const * source, size_t sourceElems, HbBool nonNativeEndian) {
+	HbTextU16 * targetStart = target, * targetEnd = target + targetSizeElems;
+	HbTextU8 const * sourceEnd = source + sourceElems;
+	HbMath_U8x16 zero = HbMath_U8x16_LoadZero();
+	while (source != sourceEnd) {
+		// Convert ASCII 16 elements at once, placing the zero byte first for the non-native byte order.
+		while ((size_t) (sourceEnd - source) >= 16 && (size_t) (targetEnd - target) >= 16) {
+			HbMath_U8x16 elems = HbMath_U8x16_LoadUnaligned((HbMath_U8x16 const *) source);
+			if (HbMath_U8x16_SignBits(elems) != 0) {
 				break;
 			}
-			target += written;
-			targetBufferSizeElems -= written;
+			if (nonNativeEndian) {
+				HbMath_U16x8_StoreUnaligned((HbMath_U16x8 *) target, HbMath_U8x16_InterleaveLower(zero, elems));
+				HbMath_U16x8_StoreUnaligned((HbMath_U16x8 *) (target + 8), HbMath_U8x16_InterleaveUpper(zero, elems));
+			} else {
+				HbMath_U16x8_StoreUnaligned((HbMath_U16x8 *) target, HbMath_U8x16_InterleaveLower(elems, zero));
+				HbMath_U16x8_StoreUnaligned((HbMath_U16x8 *) (target + 8), HbMath_U8x16_InterleaveUpper(elems, zero));
+			}
+			source += 16;
+			target += 16;
 		}
-		*target = '\0';
+		if (source == sourceEnd) {
+			break;
+		}
+		// Convert characters one by one until the next ASCII one after them, then try the vector path again.
+		do {
+			HbTextU32 character;
+			if (*source == '\0') {
+				character = '\0';
+				++source;
+			} else {
+				character = HbTextU8i_NextChar(&source, (size_t) (sourceEnd - source));
+			}
+			uint32_t written = HbTextU16i_WriteValidChar(target, (size_t) (targetEnd - target), character, nonNativeEndian);
+			if (written == 0) {
+				return (size_t) (target - targetStart);
+			}
+			target += written;
+		} while (source != sourceEnd && (*source & 0x80) != 0);
 	}
 	return (size_t) (target - targetStart);
 }
+
+size_t HbTextU16_FromU8(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU8 const * source, HbBool nonNativeEndian) {
+	if (targetBufferSizeElems == 0) {
+		return 0;
+	}
+	size_t length = HbTextU16_FromU8Sized(target, targetBufferSizeElems - 1, source, HbTextU8_LengthElems(source), nonNativeEndian);
+	target[length] = '\0';
+	return length;
+}
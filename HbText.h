@@ -1,6 +1,7 @@
 #ifndef HbInclude_HbText
 #define HbInclude_HbText
 #include "HbCommon.h"
+#include "HbMath.h"
 #ifdef __cplusplus
 extern "C" {
 #endif
@@ -60,25 +61,37 @@ HbForceInline char HbTextA_CharToUpper(char character) {
 	}
 	return character;
 }
-#define HbTextA_CharToLowerDefine(character) ((((uint8_t) (character) - 'A') < 'Z' - 'A') ? (character) + ('a' - 'A') : (character))
-#define HbTextA_CharToUpperDefine(character) ((((uint8_t) (character) - 'a') < 'z' - 'a') ? (character) - ('a' - 'A') : (character))
+#define HbTextA_CharToLowerDefine(character) ((((uint8_t) (character) - 'A') <= 'Z' - 'A') ? (character) + ('a' - 'A') : (character))
+#define HbTextA_CharToUpperDefine(character) ((((uint8_t) (character) - 'a') <= 'z' - 'a') ? (character) - ('a' - 'A') : (character))
+HbForceInline HbMath_U8x16 HbTextA_CharsToLowerU8x16(HbMath_U8x16 characters) {
+	HbMath_U8x16 isUpper = HbMath_U8x16_CompareLessEqual(
+			HbMath_U8x16_Subtract(characters, HbMath_U8x16_LoadReplicated('A')), HbMath_U8x16_LoadReplicated('Z' - 'A'));
+	return HbMath_U8x16_Or(characters, HbMath_U8x16_And(isUpper, HbMath_U8x16_LoadReplicated('a' - 'A')));
+}
+// Strings are read 16 bytes at once, including past the terminator, but only when that doesn't cross a page boundary.
+#define HbTextA_SafeReadPageSize 4096
+HbForceInline HbBool HbTextA_CanReadU8x16(void const * address) {
+	#ifdef __SANITIZE_ADDRESS__
+	// AddressSanitizer reports reads past the end of the object even if they stay within the page.
+	return HbFalse;
+	#else
+	return ((uintptr_t) address & (HbTextA_SafeReadPageSize - 1)) <= HbTextA_SafeReadPageSize - 16;
+	#endif
+}
 #define HbTextA_Length strlen
 #define HbTextA_Compare strcmp
 #define HbTextA_ComparePart strncmp
-#if HbPlatform_OS_Windows
-#define HbTextA_CompareCaseless _stricmp
-#define HbTextA_ComparePartCaseless _strnicmp
-#else
-#define HbTextA_CompareCaseless strcasecmp
-#define HbTextA_ComparePartCaseless strncasecmp
-#endif
+// Only ASCII letters are case-insensitive, like in the C locale, and the result is the difference of the first lowercase bytes that differ.
+int HbTextA_CompareCaseless(char const * a, char const * b);
+int HbTextA_ComparePartCaseless(char const * a, char const * b, size_t maxLength);
 size_t HbTextA_Copy(char * target, size_t targetBufferSize, char const * source);
 inline size_t HbTextA_CopyInto(char * target, size_t targetBufferSize, size_t targetOffset, char const * source) {
 	return (targetOffset < targetBufferSize ?
 			HbTextA_Copy(target + targetOffset, targetBufferSize - targetOffset, source) : 0u);
 }
-size_t HbTextA_FormatV(char * target, size_t targetBufferSize, char const * format, va_list arguments);
-size_t HbTextA_Format(char * target, size_t targetBufferSize, char const * format, ...);
+size_t HbTextA_FormatV(char * target, size_t targetBufferSize, HbPrintfFormatString char const * format, va_list arguments);
+HbPrintfFormatAttribute(3, 4)
+size_t HbTextA_Format(char * target, size_t targetBufferSize, HbPrintfFormatString char const * format, ...);
 
 /*******************************************************************
  * Common Unicode
@@ -142,13 +155,10 @@ inline size_t HbTextU8_LengthChars(HbTextU8 const * text) {
 	}
 	return length;
 };
+// Exact number of UTF-16 elements HbTextU16_FromU8Sized will write (null characters are converted like any other).
+size_t HbTextU8_LengthU16ElemsSized(HbTextU8 const * text, size_t elems);
 inline size_t HbTextU8_LengthU16Elems(HbTextU8 const * text) {
-	size_t length = 0;
-	HbTextU32 character;
-	while ((character = HbTextU8_NextChar(&text, HbTextU8_MaxCharElems)) != '\0') {
-		length += 1 + ((character >> 16) != 0);
-	}
-	return length;
+	return HbTextU8_LengthU16ElemsSized(text, HbTextU8_LengthElems(text));
 }
 
 // Places a character in the buffer if possible, returning the number of elements actually written.
@@ -158,6 +168,13 @@ uint32_t HbTextU8_WriteValidChar(HbTextU8 * target, size_t targetBufferSizeElems
 // Allocate HbTextU16_LengthU8Elems elements for this.
 size_t HbTextU8_FromU16(HbTextU8 * target, size_t targetBufferSizeElems, HbTextU16 const * source, HbBool nonNativeEndian);
 
+// Bulk conversion of a buffer with a known length, such as a whole text file. Null characters are converted like any other.
+// Doesn't null-terminate, stops before the first character that doesn't fit. Returns the number of elements written.
+// HbTextU8_MaxElemsFromU16(sourceElems) is always enough, HbTextU16_LengthU8ElemsSized is exact.
+#define HbTextU8_MaxElemsFromU16(u16Elems) ((u16Elems) * 3)
+size_t HbTextU8_FromU16Sized(HbTextU8 * target, size_t targetSizeElems,
+		HbTextU16 const * source, size_t sourceElems, HbBool nonNativeEndian);
+
 /*********
  * UTF-16
  *********/
@@ -182,13 +199,17 @@ inline size_t HbTextU16_LengthChars(HbTextU16 const * text, HbBool nonNativeEndi
 	}
 	return length;
 };
-inline size_t HbTextU16_LengthU8Elems(HbTextU16 const * text, HbBool nonNativeEndian) {
-	size_t length = 0;
-	HbTextU32 character;
-	while ((character = HbTextU16_NextChar(&text, HbTextU16_MaxCharElems, nonNativeEndian)) != '\0') {
-		length += HbTextU8_ValidCharElemCount(character);
+inline size_t HbTextU16_LengthElemsNoTerminator(HbTextU16 const * text) {
+	HbTextU16 const * start = text;
+	while (*text != '\0') {
+		++text;
 	}
-	return length;
+	return (size_t) (text - start);
+}
+// Exact number of UTF-8 elements HbTextU8_FromU16Sized will write (null characters are converted like any other).
+size_t HbTextU16_LengthU8ElemsSized(HbTextU16 const * text, size_t elems, HbBool nonNativeEndian);
+inline size_t HbTextU16_LengthU8Elems(HbTextU16 const * text, HbBool nonNativeEndian) {
+	return HbTextU16_LengthU8ElemsSized(text, HbTextU16_LengthElemsNoTerminator(text), nonNativeEndian);
 }
 
 // Places a character in the buffer if possible, returning the number of elements actually written.
@@ -201,6 +222,11 @@ size_t HbTextU16_Copy(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU1
 // Allocate HbTextU8_LengthU16Elems elements for this.
 size_t HbTextU16_FromU8(HbTextU16 * target, size_t targetBufferSizeElems, HbTextU8 const * source, HbBool nonNativeEndian);
 
+// Same as HbTextU8_FromU16Sized, HbTextU16_MaxElemsFromU8(sourceElems) is always enough, HbTextU8_LengthU16ElemsSized is exact.
+#define HbTextU16_MaxElemsFromU8(u8Elems) (u8Elems)
+size_t HbTextU16_FromU8Sized(HbTextU16 * target, size_t targetSizeElems,
+		HbTextU8 const * source, size_t sourceElems, HbBool nonNativeEndian);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,439 @@
+#include "HbFeedback.h"
+#include "HbText_Builder.h"
+#include <stddef.h>
+
+void HbText_Builder_InitFixed(HbText_Builder * builder, HbTextU8 * buffer, size_t bufferSize) {
+	builder->buffer = buffer;
+	builder->length = 0;
+	builder->bufferSize = bufferSize;
+	builder->tag = NULL;
+	builder->bufferAllocated = HbFalse;
+	builder->truncated = HbFalse;
+	buffer[0] = '\0';
+}
+
+void HbText_Builder_InitGrowable(HbText_Builder * builder, HbMemory_Tag * tag, HbTextU8 * initialBuffer, size_t initialBufferSize) {
+	builder->buffer = initialBufferSize != 0 ? initialBuffer : NULL;
+	builder->length = 0;
+	builder->bufferSize = initialBufferSize;
+	builder->tag = tag;
+	builder->bufferAllocated = HbFalse;
+	builder->truncated = HbFalse;
+	if (builder->buffer != NULL) {
+		builder->buffer[0] = '\0';
+	}
+}
+
+void HbText_Builder_Destroy(HbText_Builder * builder) {
+	if (builder->bufferAllocated) {
+		HbMemory_Free(builder->buffer);
+	}
+}
+
+HbBool HbText_Builder_Reserve(HbText_Builder * builder, size_t appendLength) {
+	size_t neededSize = builder->length + appendLength + 1;
+	if (neededSize <= builder->bufferSize) {
+		return HbTrue;
+	}
+	if (builder->tag == NULL || neededSize <= appendLength) {
+		return HbFalse;
+	}
+	size_t newBufferSize = HbMaxSize(HbMaxSize(neededSize, builder->bufferSize * 2), 64);
+	if (builder->bufferAllocated) {
+		if (!HbMemory_TryRealloc((void * *) &builder->buffer, newBufferSize)) {
+			return HbFalse;
+		}
+	} else {
+		HbTextU8 * newBuffer = HbMemory_TryAlloc(builder->tag, newBufferSize, HbFalse);
+		if (newBuffer == NULL) {
+			return HbFalse;
+		}
+		if (builder->buffer != NULL) {
+			memcpy(newBuffer, builder->buffer, builder->length + 1);
+		} else {
+			newBuffer[0] = '\0';
+		}
+		builder->buffer = newBuffer;
+		builder->bufferAllocated = HbTrue;
+	}
+	builder->bufferSize = newBufferSize;
+	return HbTrue;
+}
+
+HbBool HbText_Builder_AppendSized(HbText_Builder * builder, HbTextU8 const * text, size_t length) {
+	HbBool fits = HbText_Builder_Reserve(builder, length);
+	if (!fits) {
+		builder->truncated = HbTrue;
+		if (builder->buffer == NULL) {
+			return HbFalse;
+		}
+		length = builder->bufferSize - 1 - builder->length;
+		// Don't leave a partial UTF-8 character.
+		while (length != 0 && ((uint8_t) text[length] >> 6) == 2) {
+			--length;
+		}
+	}
+	memcpy(builder->buffer + builder->length, text, length);
+	builder->length += length;
+	builder->buffer[builder->length] = '\0';
+	return fits;
+}
+
+HbBool HbText_Builder_AppendChar(HbText_Builder * builder, char character) {
+	if (!HbText_Builder_Reserve(builder, 1)) {
+		builder->truncated = HbTrue;
+		return HbFalse;
+	}
+	builder->buffer[builder->length++] = character;
+	builder->buffer[builder->length] = '\0';
+	return HbTrue;
+}
+
+/**********************************
+ * Numbers (without the C runtime)
+ **********************************/
+
+static char const HbText_Builderi_DigitPairs[] =
+		"00010203040506070809101112131415161718192021222324252627282930313233343536373839"
+		"40414243444546474849505152535455565758596061626364656667686970717273747576777879"
+		"8081828384858687888990919293949596979899";
+
+// Writes the digits to the end of the buffer, returns the index of the first digit.
+static uint32_t HbText_Builderi_WriteDecimal(char buffer[HbText_Decimal_MaxLengthU64], uint64_t value) {
+	uint32_t position = HbText_Decimal_MaxLengthU64;
+	while (value >= 100) {
+		uint32_t pairIndex = (uint32_t) (value % 100) * 2;
+		value /= 100;
+		buffer[--position] = HbText_Builderi_DigitPairs[pairIndex + 1];
+		buffer[--position] = HbText_Builderi_DigitPairs[pairIndex];
+	}
+	if (value >= 10) {
+		buffer[--position] = HbText_Builderi_DigitPairs[value * 2 + 1];
+		buffer[--position] = HbText_Builderi_DigitPairs[value * 2];
+	} else {
+		buffer[--position] = (char) ('0' + value);
+	}
+	return position;
+}
+
+static uint32_t HbText_Builderi_WriteHex(char buffer[16], uint64_t value, HbBool upperCase) {
+	char const * digits = upperCase ? "0123456789ABCDEF" : "0123456789abcdef";
+	uint32_t position = 16;
+	do {
+		buffer[--position] = digits[value & 15];
+		value >>= 4;
+	} while (value != 0);
+	return position;
+}
+
+// The prefix (sign) is placed before the padding.
+static HbBool HbText_Builderi_AppendPadded(HbText_Builder * builder, char const * prefix, size_t prefixLength,
+		char const * text, size_t length, size_t width, char padding) {
+	size_t paddingLength = width > prefixLength + length ? width - (prefixLength + length) : 0;
+	HbBool fits = HbTrue;
+	if (padding == ' ') {
+		while (paddingLength-- != 0) {
+			fits &= HbText_Builder_AppendChar(builder, ' ');
+		}
+		paddingLength = 0;
+	}
+	fits &= HbText_Builder_AppendSized(builder, prefix, prefixLength);
+	while (paddingLength-- != 0) {
+		fits &= HbText_Builder_AppendChar(builder, padding);
+	}
+	fits &= HbText_Builder_AppendSized(builder, text, length);
+	return fits;
+}
+
+HbBool HbText_Builder_AppendU64(HbText_Builder * builder, uint64_t value, uint32_t minDigits) {
+	char digits[HbText_Decimal_MaxLengthU64];
+	uint32_t position = HbText_Builderi_WriteDecimal(digits, value);
+	return HbText_Builderi_AppendPadded(builder, "", 0, digits + position, HbText_Decimal_MaxLengthU64 - position, minDigits, '0');
+}
+
+HbBool HbText_Builder_AppendS64(HbText_Builder * builder, int64_t value, uint32_t minDigits) {
+	char digits[HbText_Decimal_MaxLengthU64];
+	// Negating in unsigned to handle INT64_MIN.
+	uint32_t position = HbText_Builderi_WriteDecimal(digits, value < 0 ? 0 - (uint64_t) value : (uint64_t) value);
+	return HbText_Builderi_AppendPadded(builder, "-", value < 0, digits + position, HbText_Decimal_MaxLengthU64 - position, minDigits + (value < 0), '0');
+}
+
+HbBool HbText_Builder_AppendHex(HbText_Builder * builder, uint64_t value, uint32_t minDigits, HbBool upperCase) {
+	char digits[16];
+	uint32_t position = HbText_Builderi_WriteHex(digits, value, upperCase);
+	return HbText_Builderi_AppendPadded(builder, "", 0, digits + position, 16 - position, minDigits, '0');
+}
+
+// Fills the digits of the number without the sign, returns the length.
+static uint32_t HbText_Builderi_WriteF64(char buffer[64], double value, uint32_t fractionDigits) {
+	static uint32_t const powersOf10[HbText_Builder_MaxFractionDigits + 1] = {
+		1, 10, 100, 1000, 10000, 100000, 1000000, 10000000, 100000000, 1000000000,
+	};
+	if (value != value) {
+		memcpy(buffer, "nan", 3);
+		return 3;
+	}
+	if (value > DBL_MAX) {
+		memcpy(buffer, "inf", 3);
+		return 3;
+	}
+	fractionDigits = HbMinU32(fractionDigits, HbText_Builder_MaxFractionDigits);
+	int32_t exponent = 0;
+	if (value >= 1e18) {
+		// Doesn't fit in the integer part, switch to the exponential notation.
+		exponent = (int32_t) floor(log10(value));
+		value /= pow(10.0, exponent);
+		if (value >= 10.0) {
+			value /= 10.0;
+			++exponent;
+		}
+	}
+	uint64_t integer = (uint64_t) value;
+	uint32_t fractionScale = powersOf10[fractionDigits];
+	double fractionScaled = (value - (double) integer) * fractionScale;
+	uint32_t fraction = (uint32_t) fractionScaled;
+	// Rounding exact halves to even like printf.
+	double remainder = fractionScaled - (double) fraction;
+	if (remainder > 0.5 || (remainder == 0.5 && ((fractionDigits != 0 ? fraction : (uint32_t) integer) & 1))) {
+		++fraction;
+	}
+	if (fraction >= fractionScale) {
+		fraction -= fractionScale;
+		++integer;
+	}
+	if (exponent != 0 && integer >= 10) {
+		// Rounded up to 10.
+		integer = 1;
+		++exponent;
+	}
+	uint32_t length = 0;
+	char digits[HbText_Decimal_MaxLengthU64];
+	uint32_t position = HbText_Builderi_WriteDecimal(digits, integer);
+	memcpy(buffer, digits + position, HbText_Decimal_MaxLengthU64 - position);
+	length += HbText_Decimal_MaxLengthU64 - position;
+	if (fractionDigits != 0) {
+		buffer[length++] = '.';
+		for (uint32_t digitIndex = fractionDigits; digitIndex-- != 0; ) {
+			buffer[length + digitIndex] = (char) ('0' + fraction % 10);
+			fraction /= 10;
+		}
+		length += fractionDigits;
+	}
+	if (exponent != 0) {
+		buffer[length++] = 'e';
+		buffer[length++] = '+';
+		position = HbText_Builderi_WriteDecimal(digits, (uint64_t) exponent);
+		if (HbText_Decimal_MaxLengthU64 - position < 2) {
+			buffer[length++] = '0';
+		}
+		memcpy(buffer + length, digits + position, HbText_Decimal_MaxLengthU64 - position);
+		length += HbText_Decimal_MaxLengthU64 - position;
+	}
+	return length;
+}
+
+HbBool HbText_Builder_AppendF64(HbText_Builder * builder, double value, uint32_t fractionDigits) {
+	char digits[64];
+	HbBool negative = signbit(value) != 0;
+	uint32_t length = HbText_Builderi_WriteF64(digits, negative ? -value : value, fractionDigits);
+	return HbText_Builderi_AppendPadded(builder, "-", negative, digits, length, 0, ' ');
+}
+
+/*************
+ * Formatting
+ *************/
+
+typedef enum HbText_Builderi_ArgumentSize {
+	HbText_Builderi_ArgumentSize_Char,
+	HbText_Builderi_ArgumentSize_Short,
+	HbText_Builderi_ArgumentSize_Int,
+	HbText_Builderi_ArgumentSize_Long,
+	HbText_Builderi_ArgumentSize_LongLong,
+	HbText_Builderi_ArgumentSize_Size,
+} HbText_Builderi_ArgumentSize;
+
+HbBool HbText_Builder_FormatV(HbText_Builder * builder, char const * format, va_list arguments) {
+	HbBool fits = HbTrue;
+	for (;;) {
+		char const * specifier = strchr(format, '%');
+		if (specifier == NULL) {
+			fits &= HbText_Builder_AppendA(builder, format);
+			break;
+		}
+		fits &= HbText_Builder_AppendSized(builder, format, (size_t) (specifier - format));
+		char const * cursor = specifier + 1;
+		char padding = ' ';
+		HbBool leftAligned = HbFalse;
+		for (;; ++cursor) {
+			if (*cursor == '0') {
+				padding = '0';
+			} else if (*cursor == '-') {
+				leftAligned = HbTrue;
+			} else {
+				break;
+			}
+		}
+		size_t width = 0;
+		while (*cursor >= '0' && *cursor <= '9') {
+			width = width * 10 + (size_t) (*(cursor++) - '0');
+		}
+		uint32_t precision = 6;
+		if (*cursor == '.') {
+			precision = 0;
+			while (*(++cursor) >= '0' && *cursor <= '9') {
+				precision = precision * 10 + (uint32_t) (*cursor - '0');
+			}
+		}
+		// hh and h arguments are promoted to int, and converted back when printed.
+		HbText_Builderi_ArgumentSize size = HbText_Builderi_ArgumentSize_Int;
+		if (*cursor == 'h') {
+			if (cursor[1] == 'h') {
+				size = HbText_Builderi_ArgumentSize_Char;
+				cursor += 2;
+			} else {
+				size = HbText_Builderi_ArgumentSize_Short;
+				++cursor;
+			}
+		} else if (*cursor == 'l') {
+			if (cursor[1] == 'l') {
+				size = HbText_Builderi_ArgumentSize_LongLong;
+				cursor += 2;
+			} else {
+				size = HbText_Builderi_ArgumentSize_Long;
+				++cursor;
+			}
+		} else if (*cursor == 'z') {
+			size = HbText_Builderi_ArgumentSize_Size;
+			++cursor;
+		}
+		char digits[64];
+		char const * text = digits;
+		size_t length;
+		char const * prefix = "";
+		size_t prefixLength = 0;
+		switch (*cursor) {
+		case '%':
+			digits[0] = '%';
+			length = 1;
+			break;
+		case 'c':
+			digits[0] = (char) va_arg(arguments, int);
+			length = 1;
+			break;
+		case 's':
+			text = va_arg(arguments, char const *);
+			if (text == NULL) {
+				text = "(null)";
+			}
+			length = HbTextA_Length(text);
+			break;
+		case 'd':
+		case 'i': {
+			int64_t value;
+			switch (size) {
+			case HbText_Builderi_ArgumentSize_Long:
+				value = va_arg(arguments, long);
+				break;
+			case HbText_Builderi_ArgumentSize_LongLong:
+				value = va_arg(arguments, long long);
+				break;
+			case HbText_Builderi_ArgumentSize_Size:
+				// %zd - the signed counterpart of size_t, which is ptrdiff_t on all the supported targets.
+				value = va_arg(arguments, ptrdiff_t);
+				break;
+			case HbText_Builderi_ArgumentSize_Char:
+				value = (signed char) va_arg(arguments, int);
+				break;
+			case HbText_Builderi_ArgumentSize_Short:
+				value = (short) va_arg(arguments, int);
+				break;
+			default:
+				value = va_arg(arguments, int);
+				break;
+			}
+			uint32_t position = HbText_Builderi_WriteDecimal(digits, value < 0 ? 0 - (uint64_t) value : (uint64_t) value);
+			text = digits + position;
+			length = HbText_Decimal_MaxLengthU64 - position;
+			prefix = "-";
+			prefixLength = (value < 0);
+			break;
+		}
+		case 'u':
+		case 'x':
+		case 'X': {
+			uint64_t value;
+			switch (size) {
+			case HbText_Builderi_ArgumentSize_Long:
+				value = va_arg(arguments, unsigned long);
+				break;
+			case HbText_Builderi_ArgumentSize_LongLong:
+				value = va_arg(arguments, unsigned long long);
+				break;
+			case HbText_Builderi_ArgumentSize_Size:
+				value = va_arg(arguments, size_t);
+				break;
+			case HbText_Builderi_ArgumentSize_Char:
+				value = (unsigned char) va_arg(arguments, unsigned int);
+				break;
+			case HbText_Builderi_ArgumentSize_Short:
+				value = (unsigned short) va_arg(arguments, unsigned int);
+				break;
+			default:
+				value = va_arg(arguments, unsigned int);
+				break;
+			}
+			uint32_t position;
+			if (*cursor == 'u') {
+				position = HbText_Builderi_WriteDecimal(digits, value);
+				length = HbText_Decimal_MaxLengthU64 - position;
+			} else {
+				position = HbText_Builderi_WriteHex(digits, value, *cursor == 'X');
+				length = 16 - position;
+			}
+			text = digits + position;
+			break;
+		}
+		case 'f': {
+			double value = va_arg(arguments, double);
+			HbBool negative = signbit(value) != 0;
+			length = HbText_Builderi_WriteF64(digits, negative ? -value : value, precision);
+			prefix = "-";
+			prefixLength = negative;
+			break;
+		}
+		default:
+			HbFeedback_Assert(HbFalse, "HbText_Builder_FormatV", "Unsupported format specifier in %s.", format);
+			// Output the specifier as is, but the arguments can't be skipped without knowing their types.
+			if (*cursor == '\0') {
+				--cursor;
+			}
+			text = specifier;
+			length = (size_t) (cursor + 1 - specifier);
+			padding = ' ';
+			width = 0;
+			break;
+		}
+		if (leftAligned) {
+			// Padded with spaces after the text, ignoring the 0 flag.
+			fits &= HbText_Builderi_AppendPadded(builder, prefix, prefixLength, text, length, 0, ' ');
+			for (size_t written = prefixLength + length; written < width; ++written) {
+				fits &= HbText_Builder_AppendChar(builder, ' ');
+			}
+		} else {
+			if (padding == '0' && (*cursor == 'c' || *cursor == 's')) {
+				padding = ' ';
+			}
+			fits &= HbText_Builderi_AppendPadded(builder, prefix, prefixLength, text, length, width, padding);
+		}
+		format = cursor + 1;
+	}
+	return fits;
+}
+
+HbBool HbText_Builder_Format(HbText_Builder * builder, char const * format, ...) {
+	va_list arguments;
+	va_start(arguments, format);
+	HbBool fits = HbText_Builder_FormatV(builder, format, arguments);
+	va_end(arguments);
+	return fits;
+}
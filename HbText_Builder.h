@@ -0,0 +1,78 @@
+#ifndef HbInclude_HbText_Builder
+#define HbInclude_HbText_Builder
+#include "HbMemory.h"
+#include "HbText.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Appending text and numbers to a buffer without the C runtime formatting and locales.
+ *
+ * The buffer is either fixed (the text is truncated at a character boundary of what's appended if it doesn't fit),
+ * or growable - allocated from a memory tag, optionally starting with an external buffer (such as a stack array)
+ * so short strings don't need any allocation.
+ * The text is always null-terminated, so it can be passed to functions accepting strings after every append.
+ *
+ * HbText_Builder_Format supports a subset of printf:
+ * %% %c %s, %d %i %u %x %X with the - and 0 flags, width and hh/h/l/ll/z sizes, %f with precision (6 by default, up to 9).
+ * The format is checked as printf by GCC and Clang, and by MSVC only with code analysis. Unsupported specifiers are written as is,
+ * with an assertion failure, as their arguments can't be skipped.
+ */
+
+#define HbText_Builder_MaxFractionDigits 9
+
+typedef struct HbText_Builder {
+	HbTextU8 * buffer;
+	size_t length;
+	size_t bufferSize; // Including the terminator.
+	HbMemory_Tag * tag; // NULL for fixed buffers.
+	HbBool bufferAllocated; // Whether the buffer has been allocated from the tag.
+	HbBool truncated; // Something didn't fit in a fixed buffer, or growing has failed.
+} HbText_Builder;
+
+// bufferSize must be at least 1.
+void HbText_Builder_InitFixed(HbText_Builder * builder, HbTextU8 * buffer, size_t bufferSize);
+// initialBuffer may be NULL (with initialBufferSize 0) to allocate from the tag on the first append.
+void HbText_Builder_InitGrowable(HbText_Builder * builder, HbMemory_Tag * tag, HbTextU8 * initialBuffer, size_t initialBufferSize);
+void HbText_Builder_Destroy(HbText_Builder * builder);
+
+HbForceInline HbTextU8 const * HbText_Builder_GetText(HbText_Builder const * builder) {
+	// The growable builder may have no buffer before the first append.
+	return builder->buffer != NULL ? builder->buffer : "";
+}
+// Cuts the text to the length (that must not be larger than the current one), for reusing a common prefix.
+HbForceInline void HbText_Builder_SetLength(HbText_Builder * builder, size_t length) {
+	builder->length = length;
+	if (builder->buffer != NULL) {
+		builder->buffer[length] = '\0';
+	}
+}
+
+// Return false if the text has been truncated.
+HbBool HbText_Builder_Reserve(HbText_Builder * builder, size_t appendLength);
+HbBool HbText_Builder_AppendSized(HbText_Builder * builder, HbTextU8 const * text, size_t length);
+HbForceInline HbBool HbText_Builder_AppendA(HbText_Builder * builder, char const * text) {
+	return HbText_Builder_AppendSized(builder, text, HbTextA_Length(text));
+}
+HbBool HbText_Builder_AppendChar(HbText_Builder * builder, char character);
+HbBool HbText_Builder_AppendU64(HbText_Builder * builder, uint64_t value, uint32_t minDigits);
+HbBool HbText_Builder_AppendS64(HbText_Builder * builder, int64_t value, uint32_t minDigits);
+HbForceInline HbBool HbText_Builder_AppendU32(HbText_Builder * builder, uint32_t value) {
+	return HbText_Builder_AppendU64(builder, value, 1);
+}
+HbForceInline HbBool HbText_Builder_AppendS32(HbText_Builder * builder, int32_t value) {
+	return HbText_Builder_AppendS64(builder, value, 1);
+}
+HbBool HbText_Builder_AppendHex(HbText_Builder * builder, uint64_t value, uint32_t minDigits, HbBool upperCase);
+// Fixed notation with up to HbText_Builder_MaxFractionDigits digits after the point, exponential for values of 1e18 and above.
+HbBool HbText_Builder_AppendF64(HbText_Builder * builder, double value, uint32_t fractionDigits);
+
+HbBool HbText_Builder_FormatV(HbText_Builder * builder, HbPrintfFormatString char const * format, va_list arguments);
+HbPrintfFormatAttribute(2, 3)
+HbBool HbText_Builder_Format(HbText_Builder * builder, HbPrintfFormatString char const * format, ...);
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,275 @@
+#include "HbFeedback.h"
+#include "HbHash.h"
+#include "HbText_Intern.h"
+
+HbBool HbText_Intern_Init(HbText_Intern * intern, HbMemory_Tag * tag) {
+	if (!HbParallel_Mutex_Init(&intern->appendMutex)) {
+		return HbFalse;
+	}
+	for (uint32_t shardIndex = 0; shardIndex < HbArrayLength(intern->shards); ++shardIndex) {
+		HbText_Intern_Shard * shard = &intern->shards[shardIndex];
+		if (!HbParallel_RWLock_Init(&shard->lock)) {
+			while (shardIndex-- != 0) {
+				HbParallel_RWLock_Destroy(&intern->shards[shardIndex].lock);
+			}
+			HbParallel_Mutex_Destroy(&intern->appendMutex);
+			return HbFalse;
+		}
+		shard->hashMap = NULL;
+		shard->hashMapIndexBitCount = 0;
+		shard->count = 0;
+	}
+	intern->tag = tag;
+	memset(intern->pieces, 0, sizeof(intern->pieces));
+	intern->count = 0;
+	intern->arenaChunk = NULL;
+	intern->arenaChunkSize = 0;
+	intern->arenaChunkUsed = 0;
+	return HbTrue;
+}
+
+void HbText_Intern_Destroy(HbText_Intern * intern) {
+	uint8_t * chunk = intern->arenaChunk;
+	while (chunk != NULL) {
+		uint8_t * previousChunk = *((uint8_t * *) chunk);
+		HbMemory_Free(chunk);
+		chunk = previousChunk;
+	}
+	for (uint32_t pieceIndex = 0; pieceIndex < HbArrayLength(intern->pieces); ++pieceIndex) {
+		HbMemory_Free(intern->pieces[pieceIndex]);
+	}
+	for (uint32_t shardIndex = 0; shardIndex < HbArrayLength(intern->shards); ++shardIndex) {
+		HbText_Intern_Shard * shard = &intern->shards[shardIndex];
+		HbMemory_Free(shard->hashMap);
+		HbParallel_RWLock_Destroy(&shard->lock);
+	}
+	HbParallel_Mutex_Destroy(&intern->appendMutex);
+}
+
+// Shards are selected by the high bits of the hash, while the low bits are used for the index in the hash map of the shard.
+HbForceInline HbText_Intern_Shard * HbText_Interni_GetShard(HbText_Intern * intern, uint32_t hash) {
+	return &intern->shards[hash >> (32 - HbText_Intern_ShardCountLog2)];
+}
+
+// If lowercase is true, looks up the lowercase version of the text. Must be called with the shard locked.
+static uint32_t HbText_Interni_FindInShard(HbText_Intern const * intern, HbText_Intern_Shard const * shard,
+		HbTextU8 const * text, size_t length, uint32_t hash, HbBool lowercase) {
+	if (shard->hashMap == NULL) {
+		return HbText_Intern_InvalidID;
+	}
+	uint32_t hashMapIndexMask = ((uint32_t) 1 << shard->hashMapIndexBitCount) - 1;
+	uint32_t probeHash = hash;
+	uint32_t hashIndex = probeHash & hashMapIndexMask;
+	uint32_t id;
+	while ((id = shard->hashMap[hashIndex]) != HbText_Intern_InvalidID) {
+		HbText_Intern_Entry const * entry = HbText_Intern_Get(intern, id);
+		if (entry->hash == hash && entry->length == length) {
+			size_t characterIndex;
+			if (lowercase) {
+				for (characterIndex = 0; characterIndex < length; ++characterIndex) {
+					if (entry->text[characterIndex] != HbTextA_CharToLower(text[characterIndex])) {
+						break;
+					}
+				}
+			} else {
+				characterIndex = (memcmp(entry->text, text, length) == 0 ? length : 0);
+			}
+			if (characterIndex == length) {
+				return id;
+			}
+		}
+		HbHash_MapUtil_PerturbateIndex(&probeHash, &hashIndex, hashMapIndexMask);
+	}
+	return HbText_Intern_InvalidID;
+}
+
+// Must be called with the shard locked for writing.
+static HbBool HbText_Interni_ReserveInShard(HbText_Intern const * intern, HbText_Intern_Shard * shard) {
+	uint32_t indexBitCount = HbHash_MapUtil_GetNeededEntriesLog2(shard->count + 1);
+	if (indexBitCount == UINT32_MAX) {
+		return HbFalse;
+	}
+	if (indexBitCount <= shard->hashMapIndexBitCount) {
+		return HbTrue;
+	}
+	uint32_t hashMapIndexMask = ((uint32_t) 1 << indexBitCount) - 1;
+	uint32_t * hashMap = HbMemory_Alloc(intern->tag, ((size_t) hashMapIndexMask + 1) * sizeof(uint32_t), HbFalse);
+	memset(hashMap, 0xFF, ((size_t) hashMapIndexMask + 1) * sizeof(uint32_t));
+	if (shard->hashMap != NULL) {
+		uint32_t oldSlotCount = (uint32_t) 1 << shard->hashMapIndexBitCount;
+		for (uint32_t oldSlotIndex = 0; oldSlotIndex < oldSlotCount; ++oldSlotIndex) {
+			uint32_t id = shard->hashMap[oldSlotIndex];
+			if (id == HbText_Intern_InvalidID) {
+				continue;
+			}
+			uint32_t hash = HbText_Intern_Get(intern, id)->hash;
+			uint32_t hashIndex = hash & hashMapIndexMask;
+			while (hashMap[hashIndex] != HbText_Intern_InvalidID) {
+				HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+			}
+			hashMap[hashIndex] = id;
+		}
+		HbMemory_Free(shard->hashMap);
+	}
+	shard->hashMap = hashMap;
+	shard->hashMapIndexBitCount = indexBitCount;
+	return HbTrue;
+}
+
+// Must be called with the append mutex locked.
+static uint32_t HbText_Interni_Append(HbText_Intern * intern, HbTextU8 const * text, size_t length,
+		uint32_t hash, uint32_t caselessHash, uint32_t caselessID, HbBool lowercase) {
+	if (intern->count >= HbText_Intern_MaxCount) {
+		return HbText_Intern_InvalidID;
+	}
+	uint32_t id = intern->count;
+	uint32_t location = id + ((uint32_t) 1 << HbText_Intern_FirstPieceSizeLog2);
+	uint32_t pieceSizeLog2 = (uint32_t) HbBit_HighestOneU32(location);
+	HbText_Intern_Entry * * piece = &intern->pieces[pieceSizeLog2 - HbText_Intern_FirstPieceSizeLog2];
+	if (*piece == NULL) {
+		*piece = HbMemory_Alloc(intern->tag, ((size_t) 1 << pieceSizeLog2) * sizeof(HbText_Intern_Entry), HbFalse);
+	}
+
+	size_t textSize = length + 1;
+	if (intern->arenaChunk == NULL || intern->arenaChunkSize - intern->arenaChunkUsed < textSize) {
+		// Long strings get their own chunk - the remaining space in the current one is wasted, but it's rare.
+		size_t chunkSize = HbMaxSize(HbText_Intern_ArenaChunkSize, sizeof(uint8_t *) + textSize);
+		uint8_t * chunk = HbMemory_Alloc(intern->tag, chunkSize, HbFalse);
+		*((uint8_t * *) chunk) = intern->arenaChunk;
+		intern->arenaChunk = chunk;
+		intern->arenaChunkSize = chunkSize;
+		intern->arenaChunkUsed = sizeof(uint8_t *);
+	}
+	HbTextU8 * entryText = (HbTextU8 *) (intern->arenaChunk + intern->arenaChunkUsed);
+	intern->arenaChunkUsed += textSize;
+	if (lowercase) {
+		for (size_t characterIndex = 0; characterIndex < length; ++characterIndex) {
+			entryText[characterIndex] = HbTextA_CharToLower(text[characterIndex]);
+		}
+	} else {
+		memcpy(entryText, text, length);
+	}
+	entryText[length] = '\0';
+
+	HbText_Intern_Entry * entry = &(*piece)[location - ((uint32_t) 1 << pieceSizeLog2)];
+	entry->text = entryText;
+	entry->length = (uint32_t) length;
+	entry->hash = hash;
+	entry->caselessHash = caselessHash;
+	entry->caselessID = (caselessID != HbText_Intern_InvalidID ? caselessID : id);
+	++intern->count;
+	return id;
+}
+
+static uint32_t HbText_Interni_Add(HbText_Intern * intern, HbTextU8 const * text, size_t length,
+		uint32_t hash, uint32_t caselessHash, HbBool lowercase) {
+	HbText_Intern_Shard * shard = HbText_Interni_GetShard(intern, hash);
+	HbParallel_RWLock_LockRead(&shard->lock);
+	uint32_t id = HbText_Interni_FindInShard(intern, shard, text, length, hash, lowercase);
+	HbParallel_RWLock_UnlockRead(&shard->lock);
+	if (id != HbText_Intern_InvalidID) {
+		return id;
+	}
+
+	// The lowercase version must exist before the entry referencing it is added, and it may be in a different shard.
+	uint32_t caselessID = HbText_Intern_InvalidID;
+	if (!lowercase) {
+		size_t characterIndex;
+		for (characterIndex = 0; characterIndex < length; ++characterIndex) {
+			if (HbTextA_CharToLower(text[characterIndex]) != text[characterIndex]) {
+				break;
+			}
+		}
+		if (characterIndex < length) {
+			caselessID = HbText_Interni_Add(intern, text, length, caselessHash, caselessHash, HbTrue);
+			if (caselessID == HbText_Intern_InvalidID) {
+				return HbText_Intern_InvalidID;
+			}
+		}
+	}
+
+	HbParallel_RWLock_LockWrite(&shard->lock);
+	// Another thread might have added the string while the shard was unlocked.
+	id = HbText_Interni_FindInShard(intern, shard, text, length, hash, lowercase);
+	if (id == HbText_Intern_InvalidID && HbText_Interni_ReserveInShard(intern, shard)) {
+		HbParallel_Mutex_Lock(&intern->appendMutex);
+		id = HbText_Interni_Append(intern, text, length, hash, caselessHash, caselessID, lowercase);
+		HbParallel_Mutex_Unlock(&intern->appendMutex);
+		if (id != HbText_Intern_InvalidID) {
+			uint32_t hashMapIndexMask = ((uint32_t) 1 << shard->hashMapIndexBitCount) - 1;
+			uint32_t probeHash = hash;
+			uint32_t hashIndex = probeHash & hashMapIndexMask;
+			while (shard->hashMap[hashIndex] != HbText_Intern_InvalidID) {
+				HbHash_MapUtil_PerturbateIndex(&probeHash, &hashIndex, hashMapIndexMask);
+			}
+			shard->hashMap[hashIndex] = id;
+			++shard->count;
+		}
+	}
+	HbParallel_RWLock_UnlockWrite(&shard->lock);
+	return id;
+}
+
+static void HbText_Interni_Hash(HbTextU8 const * text, size_t length, uint32_t * hash, uint32_t * caselessHash) {
+	uint32_t textHash = HbHash_FNV1a_Basis, textCaselessHash = HbHash_FNV1a_Basis;
+	for (size_t characterIndex = 0; characterIndex < length; ++characterIndex) {
+		char character = text[characterIndex];
+		textHash = HbHash_FNV1a_HashByte(textHash, (uint8_t) character);
+		textCaselessHash = HbHash_FNV1a_HashByte(textCaselessHash, (uint8_t) HbTextA_CharToLower(character));
+	}
+	*hash = textHash;
+	*caselessHash = textCaselessHash;
+}
+
+uint32_t HbText_Intern_Add(HbText_Intern * intern, HbTextU8 const * text, size_t length) {
+	if (length >= UINT32_MAX) {
+		return HbText_Intern_InvalidID;
+	}
+	uint32_t hash, caselessHash;
+	HbText_Interni_Hash(text, length, &hash, &caselessHash);
+	return HbText_Interni_Add(intern, text, length, hash, caselessHash, HbFalse);
+}
+
+static uint32_t HbText_Interni_Find(HbText_Intern * intern, HbTextU8 const * text, size_t length, HbBool lowercase) {
+	uint32_t hash, caselessHash;
+	HbText_Interni_Hash(text, length, &hash, &caselessHash);
+	if (lowercase) {
+		hash = caselessHash;
+	}
+	HbText_Intern_Shard * shard = HbText_Interni_GetShard(intern, hash);
+	HbParallel_RWLock_LockRead(&shard->lock);
+	uint32_t id = HbText_Interni_FindInShard(intern, shard, text, length, hash, lowercase);
+	HbParallel_RWLock_UnlockRead(&shard->lock);
+	return id;
+}
+
+uint32_t HbText_Intern_Find(HbText_Intern * intern, HbTextU8 const * text, size_t length) {
+	return HbText_Interni_Find(intern, text, length, HbFalse);
+}
+
+uint32_t HbText_Intern_FindCaseless(HbText_Intern * intern, HbTextU8 const * text, size_t length) {
+	return HbText_Interni_Find(intern, text, length, HbTrue);
+}
+
+/***************
+ * Global table
+ ***************/
+
+HbText_Intern HbText_Intern_Global;
+HbBool HbText_Intern_GlobalInitialized = HbFalse;
+static HbMemory_Tag * HbText_Interni_GlobalTag;
+
+void HbText_Intern_InitGlobal() {
+	// Created before the table is initialized, so the tag name is not interned.
+	HbText_Interni_GlobalTag = HbMemory_Tag_Create("HbText_Intern_Global");
+	if (!HbText_Intern_Init(&HbText_Intern_Global, HbText_Interni_GlobalTag)) {
+		HbFeedback_Crash("HbText_Intern_InitGlobal", "Failed to initialize the global string table.");
+	}
+	HbText_Intern_GlobalInitialized = HbTrue;
+}
+
+void HbText_Intern_ShutdownGlobal() {
+	HbText_Intern_GlobalInitialized = HbFalse;
+	HbText_Intern_Destroy(&HbText_Intern_Global);
+	HbMemory_Tag_Destroy(HbText_Interni_GlobalTag, HbTrue);
+}
@@ -0,0 +1,103 @@
+#ifndef HbInclude_HbText_Intern
+#define HbInclude_HbText_Intern
+#include "HbBit.h"
+#include "HbMemory.h"
+#include "HbParallel.h"
+#include "HbText.h"
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+/*
+ * Table of unique strings identified by 32-bit ids, so strings can be compared as integers.
+ *
+ * Strings are stored in an append-only arena, and nothing is moved or freed until the table is destroyed,
+ * so ids and text pointers stay valid, and getting the string for an id doesn't require locking.
+ * Interning is thread-safe - the hash map is split into shards by the hash, and looking up a string that already exists
+ * only takes a shared lock of one shard. Adding new strings is serialized.
+ *
+ * The ASCII lowercase version of every string is interned too, and entries refer to it via caselessID,
+ * so caseless comparison is also an integer comparison.
+ */
+
+#define HbText_Intern_InvalidID UINT32_MAX
+
+#define HbText_Intern_ShardCountLog2 4
+// Pieces of entries grow 2x, so the piece containing an id is found with a single bit scan.
+#define HbText_Intern_FirstPieceSizeLog2 8
+#define HbText_Intern_PieceCount (32 - HbText_Intern_FirstPieceSizeLog2)
+#define HbText_Intern_MaxCount (UINT32_MAX - ((uint32_t) 1 << HbText_Intern_FirstPieceSizeLog2))
+#define HbText_Intern_ArenaChunkSize ((size_t) 65536)
+
+typedef struct HbText_Intern_Entry {
+	HbTextU8 const * text; // Null-terminated.
+	uint32_t length; // In elements, without the terminator.
+	uint32_t hash; // HbHash_FNV1a_HashTextA.
+	uint32_t caselessHash; // HbHash_FNV1a_HashTextACaseless.
+	uint32_t caselessID; // Id of the lowercase version of the string, which is the id of this string if it's already lowercase.
+} HbText_Intern_Entry;
+
+typedef struct HbText_Intern_Shard {
+	HbParallel_RWLock lock;
+	uint32_t * hashMap; // Ids, or HbText_Intern_InvalidID for free slots.
+	uint32_t hashMapIndexBitCount;
+	uint32_t count;
+} HbText_Intern_Shard;
+
+typedef struct HbText_Intern {
+	HbMemory_Tag * tag;
+	HbText_Intern_Shard shards[1 << HbText_Intern_ShardCountLog2];
+	// Protects everything below.
+	HbParallel_Mutex appendMutex;
+	HbText_Intern_Entry * pieces[HbText_Intern_PieceCount];
+	uint32_t count;
+	// The first pointer in every chunk is the previous chunk.
+	uint8_t * arenaChunk;
+	size_t arenaChunkSize;
+	size_t arenaChunkUsed;
+} HbText_Intern;
+
+HbBool HbText_Intern_Init(HbText_Intern * intern, HbMemory_Tag * tag);
+void HbText_Intern_Destroy(HbText_Intern * intern);
+
+// The text doesn't need to be null-terminated. Returns HbText_Intern_InvalidID if the table is full.
+uint32_t HbText_Intern_Add(HbText_Intern * intern, HbTextU8 const * text, size_t length);
+inline uint32_t HbText_Intern_AddA(HbText_Intern * intern, char const * text) {
+	return HbText_Intern_Add(intern, text, HbTextA_Length(text));
+}
+
+// Returns HbText_Intern_InvalidID if the string hasn't been interned.
+uint32_t HbText_Intern_Find(HbText_Intern * intern, HbTextU8 const * text, size_t length);
+// Returns the caselessID of any string interned with the same lowercase version.
+uint32_t HbText_Intern_FindCaseless(HbText_Intern * intern, HbTextU8 const * text, size_t length);
+inline uint32_t HbText_Intern_FindCaselessA(HbText_Intern * intern, char const * text) {
+	return HbText_Intern_FindCaseless(intern, text, HbTextA_Length(text));
+}
+
+HbForceInline HbText_Intern_Entry const * HbText_Intern_Get(HbText_Intern const * intern, uint32_t id) {
+	uint32_t location = id + ((uint32_t) 1 << HbText_Intern_FirstPieceSizeLog2);
+	uint32_t pieceSizeLog2 = (uint32_t) HbBit_HighestOneU32(location);
+	return &intern->pieces[pieceSizeLog2 - HbText_Intern_FirstPieceSizeLog2][location - ((uint32_t) 1 << pieceSizeLog2)];
+}
+HbForceInline HbTextU8 const * HbText_Intern_GetText(HbText_Intern const * intern, uint32_t id) {
+	return HbText_Intern_Get(intern, id)->text;
+}
+HbForceInline HbBool HbText_Intern_EqualsCaseless(HbText_Intern const * intern, uint32_t id0, uint32_t id1) {
+	return id0 == id1 || HbText_Intern_Get(intern, id0)->caselessID == HbText_Intern_Get(intern, id1)->caselessID;
+}
+
+/*
+ * Engine-wide table for names shared between subsystems, such as memory tag and input binding names,
+ * so they can be stored as ids instead of copies. Initialized by HbCore after HbMemory, and destroyed after all other subsystems.
+ */
+
+extern HbText_Intern HbText_Intern_Global;
+extern HbBool HbText_Intern_GlobalInitialized;
+
+void HbText_Intern_InitGlobal();
+void HbText_Intern_ShutdownGlobal();
+
+#ifdef __cplusplus
+}
+#endif
+#endif
@@ -0,0 +1,179 @@
+// Behavior tests of the DDS head validation and copy layouts in HbFile_DDS.h, which don't depend on the GPU API or on the OS,
+// so they can be built for any OS, for instance:
+// gcc -std=c11 -O2 -msse3 -I.. HbFile_DDS_Test.c ../HbFile_DDS.c ../HbGPU_Image.c -lm -o HbFile_DDS_Test
+// cl /O2 /I.. HbFile_DDS_Test.c ..\HbFile_DDS.c ..\HbGPU_Image.c
+// Returns 0 if all tests pass, printing the failed checks otherwise.
+// Mip chains are written to DDS files in memory and copied to CPU buffers laid out like upload buffers.
+
+#include "HbFile_DDS.h"
+#include <stdio.h>
+
+static uint32_t HbFile_DDS_Test_FailureCount;
+
+#define HbFile_DDS_Test_Check(condition, ...) \
+	{ if (!(condition)) { ++HbFile_DDS_Test_FailureCount; printf("%s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }
+
+// Unused bytes of the copy buffers.
+#define HbFile_DDS_Test_Filler 0xCD
+
+typedef struct HbFile_DDS_Test_Image {
+	char const * name;
+	HbGPU_Image_Info info;
+	uint32_t elementSize; // Bytes per texel or per 4x4 block.
+	uint32_t layerCount; // Including cube sides.
+} HbFile_DDS_Test_Image;
+
+// Slice-aligned memory for the copies, with the allocation stored before the returned pointer.
+static uint8_t * HbFile_DDS_Test_AllocCopyBuffer(size_t size) {
+	uint8_t * allocation = (uint8_t *) malloc(size + HbGPU_Image_Copy_SliceAlignment + sizeof(void *));
+	uint8_t * buffer = (uint8_t *) (((uintptr_t) allocation + sizeof(void *) + (HbGPU_Image_Copy_SliceAlignment - 1)) &
+			~(uintptr_t) (HbGPU_Image_Copy_SliceAlignment - 1));
+	memcpy(buffer - sizeof(void *), &allocation, sizeof(void *));
+	memset(buffer, HbFile_DDS_Test_Filler, size);
+	return buffer;
+}
+
+static void HbFile_DDS_Test_FreeCopyBuffer(uint8_t * buffer) {
+	void * allocation;
+	memcpy(&allocation, buffer - sizeof(void *), sizeof(void *));
+	free(allocation);
+}
+
+static void HbFile_DDS_Test_CopyMipChain(HbFile_DDS_Test_Image const * image) {
+	HbGPU_Image_Info const * info = &image->info;
+	HbBool is4x4 = HbGPU_Image_Format_Is4x4(info->format);
+
+	// Rows and slices counted independently of the DDS code.
+	uint32_t mipRowSizes[1 << HbGPU_Image_MipCountBits], mipRowCounts[1 << HbGPU_Image_MipCountBits];
+	uint32_t mipDepths[1 << HbGPU_Image_MipCountBits];
+	size_t layerSize = 0;
+	for (uint32_t mip = 0; mip < info->mips; ++mip) {
+		uint32_t width = HbMaxU32(info->width >> mip, 1), height = HbMaxU32(info->height >> mip, 1);
+		if (is4x4) {
+			width = (width + 3) >> 2;
+			height = (height + 3) >> 2;
+		}
+		mipRowSizes[mip] = width * image->elementSize;
+		mipRowCounts[mip] = height;
+		mipDepths[mip] = info->dimensions == HbGPU_Image_Dimensions_3D ? HbMaxU32(info->depthOrLayers >> mip, 1) : 1;
+		layerSize += (size_t) mipRowSizes[mip] * mipRowCounts[mip] * mipDepths[mip];
+	}
+	size_t imageDataSize = layerSize * image->layerCount;
+	HbFile_DDS_Test_Check(HbFile_DDS_GetImageDataSize(info) == imageDataSize, "%s: %llu bytes of image data instead of %zu",
+			image->name, (unsigned long long) HbFile_DDS_GetImageDataSize(info), imageDataSize);
+
+	// The file, with every byte of the image data different from its neighbors.
+	uint8_t head[HbFile_DDS_MaxHeadSize];
+	uint32_t headSize = HbFile_DDS_WriteHead(info, head);
+	HbFile_DDS_Test_Check(headSize != 0, "%s: head not written", image->name);
+	if (headSize == 0) {
+		return;
+	}
+	size_t ddsSize = headSize + imageDataSize;
+	uint8_t * dds = (uint8_t *) malloc(ddsSize);
+	memcpy(dds, head, headSize);
+	uint8_t * imageData = dds + headSize;
+	for (size_t byteIndex = 0; byteIndex < imageDataSize; ++byteIndex) {
+		imageData[byteIndex] = (uint8_t) ((byteIndex * 0x9E3779B1u) >> 13);
+	}
+
+	// Head validation.
+	HbGPU_Image_Info readInfo;
+	HbFile_DDS_Test_Check(HbFile_DDS_ValidateAndGetInfo(dds, ddsSize, &readInfo) == imageData, "%s: image data not found", image->name);
+	HbFile_DDS_Test_Check(readInfo.format == info->format && readInfo.dimensions == info->dimensions && readInfo.width == info->width &&
+			readInfo.height == info->height && readInfo.depthOrLayers == info->depthOrLayers && readInfo.mips == info->mips,
+			"%s: different info read", image->name);
+	uint32_t imageDataOffset;
+	HbFile_DDS_Test_Check(!HbFile_DDS_ValidateHeadAndGetInfo(dds, headSize, ddsSize - 1, &readInfo, &imageDataOffset),
+			"%s: truncated file accepted", image->name);
+	HbFile_DDS_Test_Check(!HbFile_DDS_ValidateHeadAndGetInfo(dds, headSize - 1, ddsSize, &readInfo, &imageDataOffset),
+			"%s: truncated head accepted", image->name);
+
+	// All the mips at once.
+	HbFile_DDS_CopyLayout layout;
+	HbFile_DDS_Test_Check(HbFile_DDS_CopyLayout_Init(&layout, dds, ddsSize), "%s: copy layout not initialized", image->name);
+	HbFile_DDS_Test_Check(layout.layerCount == image->layerCount, "%s: %u layers instead of %u",
+			image->name, layout.layerCount, image->layerCount);
+	uint32_t copySize = HbFile_DDS_CopyLayout_GetCopySize(&layout, 0, info->mips);
+	uint8_t * copy = HbFile_DDS_Test_AllocCopyBuffer(copySize + HbGPU_Image_Copy_SliceAlignment);
+	HbFile_DDS_CopyLayout_CopyMips(&layout, 0, info->mips, copy);
+	uint8_t const * source = imageData;
+	size_t copyOffset = 0;
+	for (uint32_t layer = 0; layer < image->layerCount; ++layer) {
+		for (uint32_t mip = 0; mip < info->mips; ++mip) {
+			HbFile_DDS_CopyLayout_Mip const * layoutMip = &layout.mips[mip];
+			uint32_t rowPitch = HbAlignU32(mipRowSizes[mip], HbGPU_Image_Copy_RowAlignment);
+			uint32_t rowCount = mipRowCounts[mip] * mipDepths[mip];
+			uint32_t mipCopySize = HbAlignU32(rowPitch * rowCount, HbGPU_Image_Copy_SliceAlignment);
+			HbFile_DDS_Test_Check(layoutMip->copyRowPitch == rowPitch && layoutMip->copySize == mipCopySize,
+					"%s: mip %u has the row pitch of %u and the size of %u, not %u and %u",
+					image->name, mip, layoutMip->copyRowPitch, layoutMip->copySize, rowPitch, mipCopySize);
+			for (uint32_t rowIndex = 0; rowIndex < rowCount; ++rowIndex) {
+				HbFile_DDS_Test_Check(!memcmp(copy + copyOffset + (size_t) rowIndex * rowPitch, source, mipRowSizes[mip]),
+						"%s: layer %u mip %u row %u copied incorrectly", image->name, layer, mip, rowIndex);
+				source += mipRowSizes[mip];
+			}
+			copyOffset += mipCopySize;
+		}
+	}
+	HbFile_DDS_Test_Check(copyOffset == copySize, "%s: copy size is %u, not %zu", image->name, copySize, copyOffset);
+	HbBool writtenPastEnd = HbFalse;
+	for (uint32_t byteIndex = copySize; byteIndex < copySize + HbGPU_Image_Copy_SliceAlignment; ++byteIndex) {
+		writtenPastEnd |= copy[byteIndex] != HbFile_DDS_Test_Filler;
+	}
+	HbFile_DDS_Test_Check(!writtenPastEnd, "%s: written past the copy size", image->name);
+	HbFile_DDS_Test_FreeCopyBuffer(copy);
+
+	// Streaming - only the head is loaded, and the mips from 1 are read by layer and copied one layer at a time.
+	// Must result in the same data as copying the range at once.
+	HbFile_DDS_CopyLayout headLayout;
+	HbFile_DDS_Test_Check(HbFile_DDS_CopyLayout_InitFromHead(&headLayout, dds, headSize, ddsSize),
+			"%s: copy layout not initialized from the head", image->name);
+	uint32_t mipFirst = HbMinU32(1, info->mips - 1), mipCount = info->mips - mipFirst;
+	uint32_t rangeCopySize = HbFile_DDS_CopyLayout_GetCopySize(&headLayout, mipFirst, mipCount);
+	uint8_t * rangeCopy = HbFile_DDS_Test_AllocCopyBuffer(rangeCopySize);
+	uint8_t * layerCopy = HbFile_DDS_Test_AllocCopyBuffer(rangeCopySize);
+	HbFile_DDS_CopyLayout_CopyMips(&layout, mipFirst, mipCount, rangeCopy);
+	uint32_t layerCopyOffset = 0;
+	for (uint32_t layer = 0; layer < image->layerCount; ++layer) {
+		uint64_t fileOffset, size;
+		HbFile_DDS_CopyLayout_GetLayerSourceRange(&headLayout, layer, mipFirst, mipCount, &fileOffset, &size);
+		// Like reading the range from the file to a buffer of its own.
+		uint8_t * layerSource = (uint8_t *) malloc((size_t) size);
+		memcpy(layerSource, dds + fileOffset, (size_t) size);
+		layerCopyOffset += HbFile_DDS_CopyLayout_CopyLayerMips(&headLayout, mipFirst, mipCount, layerSource, layerCopy + layerCopyOffset);
+		free(layerSource);
+	}
+	HbFile_DDS_Test_Check(layerCopyOffset == rangeCopySize, "%s: %u bytes copied by layer instead of %u",
+			image->name, layerCopyOffset, rangeCopySize);
+	HbFile_DDS_Test_Check(!memcmp(rangeCopy, layerCopy, rangeCopySize), "%s: different data copied by layer", image->name);
+	HbFile_DDS_Test_FreeCopyBuffer(rangeCopy);
+	HbFile_DDS_Test_FreeCopyBuffer(layerCopy);
+
+	free(dds);
+}
+
+int main() {
+	static HbFile_DDS_Test_Image const images[] = {
+		// Rows of blocks narrower than the row alignment, down to 1x1 texel.
+		{ "S3TC 2D array", { .format = HbGPU_Image_Format_S3TC_A1_UNorm, .dimensions = HbGPU_Image_Dimensions_2DArray,
+				.width = 20, .height = 12, .depthOrLayers = 2, .mips = 5 }, 8, 2 },
+		// Rows wider than the row alignment, with ends not multiple of 16 bytes.
+		{ "RGBA8 2D", { .format = HbGPU_Image_Format_8_8_8_8_RGBA_UNorm, .dimensions = HbGPU_Image_Dimensions_2D,
+				.width = 70, .height = 3, .depthOrLayers = 1, .mips = 2 }, 4, 1 },
+		// 3D layers copied as one set of rows.
+		{ "R8 3D", { .format = HbGPU_Image_Format_8_R_UNorm, .dimensions = HbGPU_Image_Dimensions_3D,
+				.width = 5, .height = 4, .depthOrLayers = 3, .mips = 3 }, 1, 1 },
+		{ "BPTC cube", { .format = HbGPU_Image_Format_BPTC_UNorm, .dimensions = HbGPU_Image_Dimensions_Cube,
+				.width = 8, .height = 8, .depthOrLayers = 1, .mips = 4 }, 16, 6 },
+	};
+	for (uint32_t imageIndex = 0; imageIndex < HbArrayLength(images); ++imageIndex) {
+		HbFile_DDS_Test_CopyMipChain(&images[imageIndex]);
+	}
+	if (HbFile_DDS_Test_FailureCount != 0) {
+		printf("%u checks failed.\n", HbFile_DDS_Test_FailureCount);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed.\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,284 @@
+// Behavior tests of HbImage_BCDecode.h, which doesn't depend on the GPU API or on the OS, so they can be built for any OS, for instance:
+// gcc -std=c11 -O2 -msse3 -I.. HbImage_BCDecode_Test.c ../HbImage_BCDecode.c ../HbGPU_Image.c -lm -o HbImage_BCDecode_Test
+// cl /O2 /I.. HbImage_BCDecode_Test.c ..\HbImage_BCDecode.c ..\HbGPU_Image.c
+// Returns 0 if all tests pass, printing the failed checks otherwise.
+// The expected texels are calculated by hand from the format specifications, not by the decoder's own palette code.
+
+#include "HbImage_BCDecode.h"
+#include <stdio.h>
+
+static uint32_t HbImage_Test_FailureCount;
+
+#define HbImage_Test_Check(condition, ...) \
+	{ if (!(condition)) { ++HbImage_Test_FailureCount; printf("%s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }
+
+// Blocks are written from the lowest bit of the first byte.
+typedef struct HbImage_Test_BlockWriter {
+	uint8_t bytes[16];
+	uint32_t position;
+} HbImage_Test_BlockWriter;
+
+static void HbImage_Test_BlockWriter_Write(HbImage_Test_BlockWriter * writer, uint32_t value, uint32_t bitCount) {
+	for (uint32_t bit = 0; bit < bitCount; ++bit) {
+		if ((value >> bit) & 1) {
+			writer->bytes[writer->position >> 3] |= (uint8_t) (1u << (writer->position & 7));
+		}
+		++writer->position;
+	}
+}
+
+static uint32_t HbImage_Test_LoadRGBA8(uint8_t const * texel) {
+	return texel[0] | ((uint32_t) texel[1] << 8) | ((uint32_t) texel[2] << 16) | ((uint32_t) texel[3] << 24);
+}
+
+/*******
+ * S3TC
+ *******/
+
+static void HbImage_Test_S3TC() {
+	HbImage_Test_Check(HbImage_BC_GetDecodedFormat(HbGPU_Image_Format_S3TC_A1_sRGB) == HbGPU_Image_Format_8_8_8_8_RGBA_sRGB,
+			"S3TC sRGB not decoded to sRGB");
+	HbImage_Test_Check(HbImage_BC_GetDecodedFormat(HbGPU_Image_Format_8_8_8_8_RGBA_UNorm) == HbGPU_Image_Format_Invalid,
+			"Uncompressed format has a decoded format");
+
+	uint8_t texels[4 * 4 * 4];
+	// Red and blue in the 4-color mode, every row has indices 0, 1, 2, 3.
+	static uint8_t const opaqueBlock[8] = { 0x00, 0xF8, 0x1F, 0x00, 0xE4, 0xE4, 0xE4, 0xE4 };
+	static uint32_t const opaqueColors[4] = { 0xFF0000FFu, 0xFFFF0000u, 0xFF5500AAu, 0xFFAA0055u };
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_S3TC_A1_UNorm, opaqueBlock, texels, 4 * 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t color = HbImage_Test_LoadRGBA8(&texels[texel * 4]);
+		HbImage_Test_Check(color == opaqueColors[texel & 3], "4-color texel %u is 0x%08X, not 0x%08X", texel, color, opaqueColors[texel & 3]);
+	}
+	// The same endpoints swapped - the 3-color mode with transparent black.
+	static uint8_t const punchThroughBlock[8] = { 0x1F, 0x00, 0x00, 0xF8, 0xE4, 0xE4, 0xE4, 0xE4 };
+	static uint32_t const punchThroughColors[4] = { 0xFFFF0000u, 0xFF0000FFu, 0xFF800080u, 0x00000000u };
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_S3TC_A1_UNorm, punchThroughBlock, texels, 4 * 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t color = HbImage_Test_LoadRGBA8(&texels[texel * 4]);
+		HbImage_Test_Check(color == punchThroughColors[texel & 3], "3-color texel %u is 0x%08X, not 0x%08X",
+				texel, color, punchThroughColors[texel & 3]);
+	}
+
+	// Explicit alpha increasing by 1/15 from texel to texel, with the color block in the 4-color mode even though color0 <= color1.
+	uint8_t explicitAlphaBlock[16] = { 0x10, 0x32, 0x54, 0x76, 0x98, 0xBA, 0xDC, 0xFE, 0x1F, 0x00, 0x00, 0xF8, 0xFF, 0xFF, 0xFF, 0xFF };
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_S3TC_A4_UNorm, explicitAlphaBlock, texels, 4 * 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		// Index 3 - 1/3 of color0 and 2/3 of color1.
+		uint32_t expected = 0x005500AAu | ((texel * 17) << 24);
+		uint32_t color = HbImage_Test_LoadRGBA8(&texels[texel * 4]);
+		HbImage_Test_Check(color == expected, "Explicit alpha texel %u is 0x%08X, not 0x%08X", texel, color, expected);
+	}
+
+	// Interpolated alpha with 8 values (255 to 0) - texel N has index N & 7, with white color.
+	static uint8_t const alphas8[8] = { 255, 0, 219, 182, 146, 109, 73, 36 };
+	uint8_t interpolatedAlphaBlock[16] = { 255, 0, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA, 0xFF, 0xFF, 0xFF, 0xFF, 0, 0, 0, 0 };
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_S3TC_A8_sRGB, interpolatedAlphaBlock, texels, 4 * 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t expected = 0x00FFFFFFu | ((uint32_t) alphas8[texel & 7] << 24);
+		uint32_t color = HbImage_Test_LoadRGBA8(&texels[texel * 4]);
+		HbImage_Test_Check(color == expected, "Interpolated alpha texel %u is 0x%08X, not 0x%08X", texel, color, expected);
+	}
+}
+
+/******
+ * 3Dc
+ ******/
+
+static void HbImage_Test_3Dc() {
+	// Texel N has index N & 7 in all the blocks.
+	uint8_t block[16] = { 0, 0, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA, 0, 0, 0x88, 0xC6, 0xFA, 0x88, 0xC6, 0xFA };
+	uint8_t values[4 * 4 * 2];
+
+	// 6 values with 0 and 255 as the last ones.
+	static uint8_t const unorm6[8] = { 0, 255, 51, 102, 153, 204, 0, 255 };
+	block[0] = 0;
+	block[1] = 255;
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_3Dc_R_UNorm, block, values, 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		HbImage_Test_Check(values[texel] == unorm6[texel & 7], "6-value UNorm texel %u is %u, not %u", texel, values[texel], unorm6[texel & 7]);
+	}
+
+	// 8 values, with -128 treated as -127.
+	static int8_t const snorm8[8] = { 127, -127, 91, 54, 18, -18, -54, -91 };
+	block[0] = 127;
+	block[1] = 0x80;
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_3Dc_R_SNorm, block, values, 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		int8_t value = (int8_t) values[texel];
+		HbImage_Test_Check(value == snorm8[texel & 7], "8-value SNorm texel %u is %d, not %d", texel, value, snorm8[texel & 7]);
+	}
+
+	// Red from the first half and green from the second.
+	static uint8_t const unorm8[8] = { 255, 0, 219, 182, 146, 109, 73, 36 };
+	block[0] = 0;
+	block[1] = 255;
+	block[8] = 255;
+	block[9] = 0;
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_3Dc_RG_UNorm, block, values, 4 * 2);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		HbImage_Test_Check(values[texel * 2] == unorm6[texel & 7] && values[texel * 2 + 1] == unorm8[texel & 7],
+				"RG texel %u is (%u, %u), not (%u, %u)", texel, values[texel * 2], values[texel * 2 + 1], unorm6[texel & 7], unorm8[texel & 7]);
+	}
+}
+
+/*******
+ * BPTC
+ *******/
+
+// Interpolation weights out of 64 for 4-bit indices from the specification.
+static uint32_t const HbImage_Test_BPTCWeights4[16] = { 0, 4, 9, 13, 17, 21, 26, 30, 34, 38, 43, 47, 51, 55, 60, 64 };
+
+static void HbImage_Test_BPTC() {
+	uint8_t texels[4 * 4 * 4];
+
+	// Mode 6 - 7-bit RGBA endpoints with a P-bit each, and 4-bit indices. Texel N has index N.
+	HbImage_Test_BlockWriter mode6 = { 0 };
+	HbImage_Test_BlockWriter_Write(&mode6, 1 << 6, 7);
+	static uint32_t const mode6Endpoints[2][4] = { { 127, 0, 64, 127 }, { 0, 0, 0, 0 } };
+	for (uint32_t channel = 0; channel < 4; ++channel) {
+		HbImage_Test_BlockWriter_Write(&mode6, mode6Endpoints[0][channel], 7);
+		HbImage_Test_BlockWriter_Write(&mode6, mode6Endpoints[1][channel], 7);
+	}
+	HbImage_Test_BlockWriter_Write(&mode6, 1, 1);
+	HbImage_Test_BlockWriter_Write(&mode6, 0, 1);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		// The anchor texel 0 has one bit less.
+		HbImage_Test_BlockWriter_Write(&mode6, texel, texel == 0 ? 3 : 4);
+	}
+	HbImage_Test_Check(mode6.position == 128, "Mode 6 block has %u bits", mode6.position);
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_BPTC_UNorm, mode6.bytes, texels, 4 * 4);
+	// With the P-bit of endpoint 0 set.
+	static uint32_t const mode6Endpoint0[4] = { 255, 1, 129, 255 };
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		for (uint32_t channel = 0; channel < 4; ++channel) {
+			uint32_t expected = ((64 - HbImage_Test_BPTCWeights4[texel]) * mode6Endpoint0[channel] + 32) >> 6;
+			HbImage_Test_Check(texels[texel * 4 + channel] == expected, "Mode 6 texel %u channel %u is %u, not %u",
+					texel, channel, texels[texel * 4 + channel], expected);
+		}
+	}
+
+	// Mode 5 - separate color and alpha indices, with red and alpha swapped by rotation 1. All the indices are 0.
+	HbImage_Test_BlockWriter mode5 = { 0 };
+	HbImage_Test_BlockWriter_Write(&mode5, 1 << 5, 6);
+	HbImage_Test_BlockWriter_Write(&mode5, 1, 2);
+	HbImage_Test_BlockWriter_Write(&mode5, 127, 7); // Red 0.
+	mode5.position = 128;
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_BPTC_UNorm, mode5.bytes, texels, 4 * 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t color = HbImage_Test_LoadRGBA8(&texels[texel * 4]);
+		HbImage_Test_Check(color == 0xFF000000u, "Rotated mode 5 texel %u is 0x%08X, not 0xFF000000", texel, color);
+	}
+
+	// No mode bit set in the first byte - reserved, decoded to zeros.
+	uint8_t reservedBlock[16] = { 0, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF, 0xFF };
+	memset(texels, 0xCD, sizeof(texels));
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_BPTC_sRGB, reservedBlock, texels, 4 * 4);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		uint32_t color = HbImage_Test_LoadRGBA8(&texels[texel * 4]);
+		HbImage_Test_Check(color == 0, "Reserved mode texel %u is 0x%08X, not 0", texel, color);
+	}
+}
+
+static void HbImage_Test_BPTCFloat() {
+	uint16_t texels[4 * 4 * 4];
+
+	// Mode 11 (mode bits 00011) - 10-bit endpoints without transformation, and 4-bit indices. Texel N has index N.
+	HbImage_Test_BlockWriter mode11 = { 0 };
+	HbImage_Test_BlockWriter_Write(&mode11, 3, 5);
+	HbImage_Test_BlockWriter_Write(&mode11, 1023, 10);
+	HbImage_Test_BlockWriter_Write(&mode11, 0, 10);
+	HbImage_Test_BlockWriter_Write(&mode11, 512, 10);
+	HbImage_Test_BlockWriter_Write(&mode11, 0, 30);
+	for (uint32_t texel = 0; texel < 16; ++texel) {
+		HbImage_Test_BlockWriter_Write(&mode11, texel, texel == 0 ? 3 : 4);
+	}
+	HbImage_Test_Check(mode11.position == 128, "Mode 11 block has %u bits", mode11.position);
+
+	// Unsigned - the largest endpoint is the largest finite half, 512 is unquantized to 32800, and scaled by 31/64 to 0x3E0F.
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_BPTC_UFloat, mode11.bytes, texels, 4 * 4 * sizeof(uint16_t));
+	static uint16_t const unsignedFirst[4] = { 0x7BFF, 0x0000, 0x3E0F, 0x3C00 };
+	for (uint32_t channel = 0; channel < 4; ++channel) {
+		HbImage_Test_Check(texels[channel] == unsignedFirst[channel], "Unsigned texel 0 channel %u is 0x%04X, not 0x%04X",
+				channel, texels[channel], unsignedFirst[channel]);
+		uint16_t expectedLast = channel == 3 ? 0x3C00 : 0;
+		HbImage_Test_Check(texels[15 * 4 + channel] == expectedLast, "Unsigned texel 15 channel %u is 0x%04X, not 0x%04X",
+				channel, texels[15 * 4 + channel], expectedLast);
+	}
+
+	// Signed - 1023 is -1, unquantized to -96, and scaled by 31/32 to the magnitude of 93 with the sign bit.
+	// 512 is -512, the lowest value, unquantized to -0x7FFF, which is the lowest finite half.
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_BPTC_SFloat, mode11.bytes, texels, 4 * 4 * sizeof(uint16_t));
+	static uint16_t const signedFirst[4] = { 0x805D, 0x0000, 0xFBFF, 0x3C00 };
+	for (uint32_t channel = 0; channel < 4; ++channel) {
+		HbImage_Test_Check(texels[channel] == signedFirst[channel], "Signed texel 0 channel %u is 0x%04X, not 0x%04X",
+				channel, texels[channel], signedFirst[channel]);
+	}
+
+	// Reserved mode bits 10011 - decoded to zeros, including alpha.
+	HbImage_Test_BlockWriter reserved = { 0 };
+	HbImage_Test_BlockWriter_Write(&reserved, 0x13, 5);
+	HbImage_Test_BlockWriter_Write(&reserved, 0x3FF, 10);
+	memset(texels, 0xCD, sizeof(texels));
+	HbImage_BC_DecodeBlock(HbGPU_Image_Format_BPTC_UFloat, reserved.bytes, texels, 4 * 4 * sizeof(uint16_t));
+	for (uint32_t value = 0; value < HbArrayLength(texels); ++value) {
+		HbImage_Test_Check(texels[value] == 0, "Reserved mode value %u is 0x%04X, not 0", value, texels[value]);
+	}
+}
+
+/**************************
+ * Rows of blocks and mips
+ **************************/
+
+// A 3D mip of solid S3TC blocks with a distinct color each, decoded in two ranges of block rows into a target with padding,
+// which must not be written to.
+static void HbImage_Test_Mip() {
+	enum { width = 6, height = 5, depth = 2, blocksWide = 2, blocksHigh = 2, targetRowPitch = 32, targetSlicePitch = 6 * targetRowPitch };
+	uint8_t blocks[depth][blocksHigh][blocksWide][8];
+	for (uint32_t slice = 0; slice < depth; ++slice) {
+		for (uint32_t blockY = 0; blockY < blocksHigh; ++blockY) {
+			for (uint32_t blockX = 0; blockX < blocksWide; ++blockX) {
+				uint8_t * block = blocks[slice][blockY][blockX];
+				// Red in the upper 5 bits of color0, all the indices are 0.
+				uint32_t color0 = (slice * 4 + blockY * 2 + blockX + 1) << 11;
+				memset(block, 0, 8);
+				block[0] = (uint8_t) color0;
+				block[1] = (uint8_t) (color0 >> 8);
+			}
+		}
+	}
+	uint32_t blockRowCount = HbImage_BC_GetMipBlockRowCount(height, depth);
+	HbImage_Test_Check(blockRowCount == 4, "%u block rows instead of 4", blockRowCount);
+	uint8_t target[depth * targetSlicePitch];
+	memset(target, 0xCD, sizeof(target));
+	HbImage_BC_DecodeMipBlockRows(HbGPU_Image_Format_S3TC_A1_UNorm, blocks, width, height, 0, 3, target, targetRowPitch, targetSlicePitch);
+	HbImage_BC_DecodeMipBlockRows(HbGPU_Image_Format_S3TC_A1_UNorm, blocks, width, height, 3, blockRowCount,
+			target, targetRowPitch, targetSlicePitch);
+	for (uint32_t slice = 0; slice < depth; ++slice) {
+		for (uint32_t y = 0; y < targetSlicePitch / targetRowPitch; ++y) {
+			for (uint32_t x = 0; x < targetRowPitch / 4; ++x) {
+				uint32_t color = HbImage_Test_LoadRGBA8(&target[slice * targetSlicePitch + y * targetRowPitch + x * 4]);
+				uint32_t expected = 0xCDCDCDCDu;
+				if (x < width && y < height) {
+					uint32_t red = slice * 4 + (y >> 2) * 2 + (x >> 2) + 1;
+					expected = 0xFF000000u | ((red << 3) | (red >> 2));
+				}
+				HbImage_Test_Check(color == expected, "Slice %u texel (%u, %u) is 0x%08X, not 0x%08X", slice, x, y, color, expected);
+			}
+		}
+	}
+}
+
+int main() {
+	HbImage_Test_S3TC();
+	HbImage_Test_3Dc();
+	HbImage_Test_BPTC();
+	HbImage_Test_BPTCFloat();
+	HbImage_Test_Mip();
+	if (HbImage_Test_FailureCount != 0) {
+		printf("%u checks failed.\n", HbImage_Test_FailureCount);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed.\n");
+	return EXIT_SUCCESS;
+}
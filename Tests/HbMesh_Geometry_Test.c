@@ -0,0 +1,470 @@
+// Behavior tests of HbMesh_Geometry.h, which doesn't depend on the rest of the engine, so they can be built for any OS, for instance:
+// gcc -std=c11 -O2 -I.. HbMesh_Geometry_Test.c ../HbMesh_Optimize.c ../HbMesh_Meshlet.c -lm -o HbMesh_Geometry_Test
+// cl /O2 /I.. HbMesh_Geometry_Test.c ..\HbMesh_Optimize.c ..\HbMesh_Meshlet.c
+// Returns 0 if all tests pass, printing the failed checks otherwise.
+
+#include "HbMesh_Geometry.h"
+#include <math.h>
+#include <stdio.h>
+
+static uint32_t HbMesh_Test_FailureCount;
+
+#define HbMesh_Test_Check(condition, ...) \
+	{ if (!(condition)) { ++HbMesh_Test_FailureCount; printf("%s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }
+
+static void * HbMesh_Test_AllocScratch(size_t size) {
+	// malloc is aligned enough for the 4-aligned scratch.
+	return malloc(HbMaxSize(size, 1));
+}
+
+/*********
+ * Meshes
+ *********/
+
+typedef struct HbMesh_Test_Mesh {
+	float * positions; // 3 floats per vertex.
+	uint32_t vertexCount;
+	uint32_t * indexes;
+	uint32_t triangleCount;
+} HbMesh_Test_Mesh;
+
+static void HbMesh_Test_Mesh_Destroy(HbMesh_Test_Mesh * mesh) {
+	free(mesh->positions);
+	free(mesh->indexes);
+}
+
+// UV sphere with the triangles facing outside (counterclockwise when viewed from the outside), with the vertexes of the seam duplicated.
+static void HbMesh_Test_Mesh_InitSphere(HbMesh_Test_Mesh * mesh, uint32_t segments, uint32_t rings, float radius, float const center[3]) {
+	mesh->vertexCount = (segments + 1) * (rings + 1);
+	mesh->positions = (float *) malloc((size_t) 3 * mesh->vertexCount * sizeof(float));
+	for (uint32_t ring = 0; ring <= rings; ++ring) {
+		float theta = 3.14159265f * (float) ring / (float) rings;
+		for (uint32_t segment = 0; segment <= segments; ++segment) {
+			float phi = 2.0f * 3.14159265f * (float) segment / (float) segments;
+			float * position = mesh->positions + 3 * (ring * (segments + 1) + segment);
+			position[0] = center[0] + radius * sinf(theta) * cosf(phi);
+			position[1] = center[1] + radius * cosf(theta);
+			position[2] = center[2] + radius * sinf(theta) * sinf(phi);
+		}
+	}
+	mesh->triangleCount = 2 * segments * rings;
+	mesh->indexes = (uint32_t *) malloc((size_t) 3 * mesh->triangleCount * sizeof(uint32_t));
+	uint32_t * index = mesh->indexes;
+	for (uint32_t ring = 0; ring < rings; ++ring) {
+		for (uint32_t segment = 0; segment < segments; ++segment) {
+			uint32_t v00 = ring * (segments + 1) + segment, v01 = v00 + 1, v10 = v00 + segments + 1, v11 = v10 + 1;
+			*(index++) = v00; *(index++) = v01; *(index++) = v10;
+			*(index++) = v01; *(index++) = v11; *(index++) = v10;
+		}
+	}
+}
+
+// Appends the triangles and the vertexes of the second mesh to the first one.
+static void HbMesh_Test_Mesh_Append(HbMesh_Test_Mesh * mesh, HbMesh_Test_Mesh const * other) {
+	mesh->positions = (float *) realloc(mesh->positions, (size_t) 3 * (mesh->vertexCount + other->vertexCount) * sizeof(float));
+	memcpy(mesh->positions + 3 * mesh->vertexCount, other->positions, (size_t) 3 * other->vertexCount * sizeof(float));
+	mesh->indexes = (uint32_t *) realloc(mesh->indexes, (size_t) 3 * (mesh->triangleCount + other->triangleCount) * sizeof(uint32_t));
+	for (uint32_t indexIndex = 0; indexIndex < 3 * other->triangleCount; ++indexIndex) {
+		mesh->indexes[3 * mesh->triangleCount + indexIndex] = mesh->vertexCount + other->indexes[indexIndex];
+	}
+	mesh->vertexCount += other->vertexCount;
+	mesh->triangleCount += other->triangleCount;
+}
+
+static uint32_t HbMesh_Test_Random(uint32_t * state) {
+	*state = *state * 1664525u + 1013904223u;
+	return *state >> 8;
+}
+
+static void HbMesh_Test_ShuffleTriangles(uint32_t * indexes, uint32_t triangleCount, uint32_t seed) {
+	for (uint32_t triangleIndex = triangleCount - 1; triangleIndex > 0; --triangleIndex) {
+		uint32_t otherIndex = HbMesh_Test_Random(&seed) % (triangleIndex + 1);
+		uint32_t triangle[3];
+		memcpy(triangle, indexes + 3 * triangleIndex, sizeof(triangle));
+		memcpy(indexes + 3 * triangleIndex, indexes + 3 * otherIndex, sizeof(triangle));
+		memcpy(indexes + 3 * otherIndex, triangle, sizeof(triangle));
+	}
+}
+
+static int HbMesh_Test_CompareTriangles(void const * triangle1Pointer, void const * triangle2Pointer) {
+	uint32_t const * triangle1 = (uint32_t const *) triangle1Pointer, * triangle2 = (uint32_t const *) triangle2Pointer;
+	for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+		if (triangle1[cornerIndex] != triangle2[cornerIndex]) {
+			return triangle1[cornerIndex] < triangle2[cornerIndex] ? -1 : 1;
+		}
+	}
+	return 0;
+}
+
+// Whether the triangles are the same, with the same corners in the same order, but possibly in a different order of the triangles.
+static HbBool HbMesh_Test_AreSameTriangles(uint32_t const * indexes1, uint32_t const * indexes2, uint32_t triangleCount) {
+	size_t size = (size_t) 3 * triangleCount * sizeof(uint32_t);
+	uint32_t * sorted1 = (uint32_t *) malloc(HbMaxSize(size, 1)), * sorted2 = (uint32_t *) malloc(HbMaxSize(size, 1));
+	memcpy(sorted1, indexes1, size);
+	memcpy(sorted2, indexes2, size);
+	qsort(sorted1, triangleCount, 3 * sizeof(uint32_t), HbMesh_Test_CompareTriangles);
+	qsort(sorted2, triangleCount, 3 * sizeof(uint32_t), HbMesh_Test_CompareTriangles);
+	HbBool same = memcmp(sorted1, sorted2, size) == 0;
+	free(sorted1);
+	free(sorted2);
+	return same;
+}
+
+static HbMesh_VertexCacheStats HbMesh_Test_GetVertexCacheStats(uint32_t const * indexes, uint32_t triangleCount, uint32_t vertexCount,
+		uint32_t cacheSize) {
+	void * scratch = HbMesh_Test_AllocScratch(HbMesh_GetVertexCacheStats_GetScratchSize(vertexCount));
+	HbMesh_VertexCacheStats stats;
+	HbMesh_GetVertexCacheStats(indexes, triangleCount, vertexCount, cacheSize, &stats, scratch);
+	free(scratch);
+	return stats;
+}
+
+/***************
+ * Optimization
+ ***************/
+
+static void HbMesh_Test_VertexCacheStats() {
+	// 2 triangles sharing an edge - 4 transforms with any cache holding 3 vertexes, 6 without reuse.
+	uint32_t const indexes[] = { 0, 1, 2, 2, 1, 3 };
+	HbMesh_VertexCacheStats stats = HbMesh_Test_GetVertexCacheStats(indexes, 2, 4, 16);
+	HbMesh_Test_Check(stats.transformCount == 4 && stats.acmr == 2.0f && stats.atvr == 1.0f,
+			"%u transforms, ACMR %f, ATVR %f", stats.transformCount, stats.acmr, stats.atvr);
+	// With a cache of 1, only the repeated vertex 2 is reused.
+	stats = HbMesh_Test_GetVertexCacheStats(indexes, 2, 4, 1);
+	HbMesh_Test_Check(stats.transformCount == 5, "%u transforms with the cache of 1", stats.transformCount);
+	stats = HbMesh_Test_GetVertexCacheStats(indexes, 0, 4, 16);
+	HbMesh_Test_Check(stats.transformCount == 0 && stats.acmr == 0.0f && stats.atvr == 0.0f, "Stats of an empty mesh");
+}
+
+static void HbMesh_Test_OptimizeVertexCache() {
+	float const center[3] = { 0.0f, 0.0f, 0.0f };
+	HbMesh_Test_Mesh sphere;
+	HbMesh_Test_Mesh_InitSphere(&sphere, 64, 32, 1.0f, center);
+	HbMesh_Test_ShuffleTriangles(sphere.indexes, sphere.triangleCount, 1);
+	HbMesh_VertexCacheStats shuffledStats = HbMesh_Test_GetVertexCacheStats(sphere.indexes, sphere.triangleCount, sphere.vertexCount, 16);
+
+	size_t indexesSize = (size_t) 3 * sphere.triangleCount * sizeof(uint32_t);
+	uint32_t * optimized = (uint32_t *) malloc(indexesSize);
+	void * scratch = HbMesh_Test_AllocScratch(HbMesh_OptimizeVertexCache_GetScratchSize(sphere.triangleCount, sphere.vertexCount));
+	HbMesh_OptimizeVertexCache(sphere.indexes, sphere.triangleCount, sphere.vertexCount, optimized, scratch);
+	HbMesh_Test_Check(HbMesh_Test_AreSameTriangles(sphere.indexes, optimized, sphere.triangleCount), "Triangles changed by the reordering");
+	// The cache is only simulated as LRU of 32, but must work well for smaller FIFOs too.
+	for (uint32_t cacheSize = 12; cacheSize <= 32; cacheSize += 4) {
+		HbMesh_VertexCacheStats stats = HbMesh_Test_GetVertexCacheStats(optimized, sphere.triangleCount, sphere.vertexCount, cacheSize);
+		HbMesh_Test_Check(stats.acmr < 0.8f && stats.atvr < 1.6f, "ACMR %f, ATVR %f with the cache of %u (%f, %f shuffled)",
+				stats.acmr, stats.atvr, cacheSize, shuffledStats.acmr, shuffledStats.atvr);
+	}
+
+	// In place, with the same result.
+	uint32_t * inPlace = (uint32_t *) malloc(indexesSize);
+	memcpy(inPlace, sphere.indexes, indexesSize);
+	HbMesh_OptimizeVertexCache(inPlace, sphere.triangleCount, sphere.vertexCount, inPlace, scratch);
+	HbMesh_Test_Check(memcmp(inPlace, optimized, indexesSize) == 0, "Optimization in place gives a different result");
+
+	free(inPlace);
+	free(scratch);
+	free(optimized);
+	HbMesh_Test_Mesh_Destroy(&sphere);
+}
+
+static void HbMesh_Test_OptimizeOverdraw() {
+	// A small sphere inside a large one, with the inner drawn first - the outer one must be drawn first to occlude the inner one.
+	float const center[3] = { 0.0f, 0.0f, 0.0f };
+	HbMesh_Test_Mesh mesh, outer;
+	HbMesh_Test_Mesh_InitSphere(&mesh, 32, 16, 0.5f, center);
+	HbMesh_Test_Mesh_InitSphere(&outer, 32, 16, 2.0f, center);
+	uint32_t innerVertexCount = mesh.vertexCount, innerTriangleCount = mesh.triangleCount;
+	HbMesh_Test_Mesh_Append(&mesh, &outer);
+	HbMesh_Test_Mesh_Destroy(&outer);
+	void * scratch = HbMesh_Test_AllocScratch(HbMaxSize(HbMesh_OptimizeVertexCache_GetScratchSize(mesh.triangleCount, mesh.vertexCount),
+			HbMesh_OptimizeOverdraw_GetScratchSize(mesh.triangleCount, mesh.vertexCount)));
+	HbMesh_OptimizeVertexCache(mesh.indexes, mesh.triangleCount, mesh.vertexCount, mesh.indexes, scratch);
+	HbMesh_VertexCacheStats cacheOptimizedStats = HbMesh_Test_GetVertexCacheStats(mesh.indexes, mesh.triangleCount, mesh.vertexCount,
+			HbMesh_OptimizeOverdraw_CacheSize);
+
+	size_t indexesSize = (size_t) 3 * mesh.triangleCount * sizeof(uint32_t);
+	uint32_t * optimized = (uint32_t *) malloc(indexesSize);
+	memcpy(optimized, mesh.indexes, indexesSize);
+	float const threshold = 1.05f;
+	HbMesh_OptimizeOverdraw(optimized, mesh.triangleCount, mesh.positions, 3 * sizeof(float), mesh.vertexCount, threshold, scratch);
+	HbMesh_Test_Check(HbMesh_Test_AreSameTriangles(mesh.indexes, optimized, mesh.triangleCount), "Triangles changed by the reordering");
+	for (uint32_t triangleIndex = 0; triangleIndex < mesh.triangleCount - innerTriangleCount; ++triangleIndex) {
+		if (optimized[3 * triangleIndex] < innerVertexCount) {
+			HbMesh_Test_Check(HbFalse, "Triangle %u of the inner sphere drawn before the outer sphere", triangleIndex);
+			break;
+		}
+	}
+	// Clusters are only split where the cache efficiency stays within the threshold, with some loss at the new cluster boundaries.
+	HbMesh_VertexCacheStats stats = HbMesh_Test_GetVertexCacheStats(optimized, mesh.triangleCount, mesh.vertexCount,
+			HbMesh_OptimizeOverdraw_CacheSize);
+	HbMesh_Test_Check(stats.acmr <= cacheOptimizedStats.acmr * (threshold + 0.1f), "ACMR %f, was %f before the overdraw optimization",
+			stats.acmr, cacheOptimizedStats.acmr);
+
+	free(optimized);
+	free(scratch);
+	HbMesh_Test_Mesh_Destroy(&mesh);
+}
+
+static void HbMesh_Test_OptimizeVertexFetch() {
+	// Vertex 1 is unused, and vertexes are first used in the order 3, 0, 2, 4.
+	uint32_t indexes[] = { 3, 0, 2, 2, 0, 4, 4, 3, 2 };
+	uint32_t const originalIndexes[] = { 3, 0, 2, 2, 0, 4, 4, 3, 2 };
+	uint32_t remap[5];
+	uint32_t newVertexCount = HbMesh_OptimizeVertexFetch(indexes, 3, 5, remap);
+	uint32_t const expectedIndexes[] = { 0, 1, 2, 2, 1, 3, 3, 0, 2 };
+	uint32_t const expectedRemap[] = { 1, UINT32_MAX, 2, 0, 3 };
+	HbMesh_Test_Check(newVertexCount == 4, "%u vertexes after the remapping", newVertexCount);
+	HbMesh_Test_Check(memcmp(indexes, expectedIndexes, sizeof(indexes)) == 0, "Unexpected remapped indexes");
+	HbMesh_Test_Check(memcmp(remap, expectedRemap, sizeof(remap)) == 0, "Unexpected remapping");
+
+	// The remapped vertexes referenced by the new indexes must be the same as the old ones.
+	uint32_t const vertexes[] = { 100, 101, 102, 103, 104 };
+	uint32_t newVertexes[4];
+	HbMesh_RemapVertexes(vertexes, 5, sizeof(uint32_t), remap, newVertexes);
+	for (uint32_t indexIndex = 0; indexIndex < HbArrayLength(indexes); ++indexIndex) {
+		HbMesh_Test_Check(newVertexes[indexes[indexIndex]] == vertexes[originalIndexes[indexIndex]], "Wrong vertex at index %u", indexIndex);
+	}
+}
+
+/***********
+ * Meshlets
+ ***********/
+
+typedef struct HbMesh_Test_Meshlets {
+	HbMesh_Meshlet * meshlets;
+	uint32_t * vertexes;
+	uint32_t * triangles;
+	uint32_t count;
+} HbMesh_Test_Meshlets;
+
+static void HbMesh_Test_Meshlets_Build(HbMesh_Test_Meshlets * meshlets, HbMesh_Test_Mesh const * mesh, float coneWeight) {
+	uint32_t maxCount = HbMesh_Meshlet_GetMaxCount(mesh->triangleCount);
+	meshlets->meshlets = (HbMesh_Meshlet *) malloc((size_t) maxCount * sizeof(HbMesh_Meshlet));
+	meshlets->vertexes = (uint32_t *) malloc((size_t) maxCount * HbMesh_Meshlet_MaxVertexes * sizeof(uint32_t));
+	meshlets->triangles = (uint32_t *) malloc((size_t) mesh->triangleCount * sizeof(uint32_t));
+	void * scratch = HbMesh_Test_AllocScratch(HbMesh_Meshlet_Build_GetScratchSize(mesh->triangleCount, mesh->vertexCount));
+	meshlets->count = HbMesh_Meshlet_Build(mesh->indexes, mesh->triangleCount, mesh->positions, 3 * sizeof(float), mesh->vertexCount,
+			coneWeight, meshlets->meshlets, meshlets->vertexes, meshlets->triangles, scratch);
+	free(scratch);
+}
+
+static void HbMesh_Test_Meshlets_Destroy(HbMesh_Test_Meshlets * meshlets) {
+	free(meshlets->meshlets);
+	free(meshlets->vertexes);
+	free(meshlets->triangles);
+}
+
+static void HbMesh_Test_MeshletBuild() {
+	float const center[3] = { 1.0f, 2.0f, 3.0f };
+	HbMesh_Test_Mesh sphere;
+	HbMesh_Test_Mesh_InitSphere(&sphere, 48, 24, 1.5f, center);
+	void * scratch = HbMesh_Test_AllocScratch(HbMesh_OptimizeVertexCache_GetScratchSize(sphere.triangleCount, sphere.vertexCount));
+	HbMesh_OptimizeVertexCache(sphere.indexes, sphere.triangleCount, sphere.vertexCount, sphere.indexes, scratch);
+	free(scratch);
+
+	for (uint32_t coneWeightIndex = 0; coneWeightIndex < 2; ++coneWeightIndex) {
+		HbMesh_Test_Meshlets meshlets;
+		HbMesh_Test_Meshlets_Build(&meshlets, &sphere, coneWeightIndex ? 0.5f : 0.0f);
+		HbMesh_Test_Check(meshlets.count != 0 && meshlets.count <= HbMesh_Meshlet_GetMaxCount(sphere.triangleCount),
+				"%u meshlets, up to %u expected", meshlets.count, HbMesh_Meshlet_GetMaxCount(sphere.triangleCount));
+
+		// The meshlets must be consecutive and within the limits, and contain every triangle once, with the same winding.
+		uint32_t * rebuiltIndexes = (uint32_t *) malloc((size_t) 3 * sphere.triangleCount * sizeof(uint32_t));
+		uint32_t vertexEnd = 0, triangleEnd = 0, cullableCount = 0;
+		for (uint32_t meshletIndex = 0; meshletIndex < meshlets.count; ++meshletIndex) {
+			HbMesh_Meshlet const * meshlet = &meshlets.meshlets[meshletIndex];
+			HbMesh_Test_Check(meshlet->vertexFirst == vertexEnd && meshlet->triangleFirst == triangleEnd,
+					"Meshlet %u not placed after the previous one", meshletIndex);
+			HbMesh_Test_Check(meshlet->vertexCount != 0 && meshlet->vertexCount <= HbMesh_Meshlet_MaxVertexes &&
+					meshlet->triangleCount != 0 && meshlet->triangleCount <= HbMesh_Meshlet_MaxTriangles,
+					"Meshlet %u has %u vertexes and %u triangles", meshletIndex, meshlet->vertexCount, meshlet->triangleCount);
+			vertexEnd += meshlet->vertexCount;
+			triangleEnd += meshlet->triangleCount;
+			if (triangleEnd > sphere.triangleCount) {
+				HbMesh_Test_Check(HbFalse, "More triangles in the meshlets than in the mesh");
+				break;
+			}
+			for (uint32_t triangleIndex = 0; triangleIndex < meshlet->triangleCount; ++triangleIndex) {
+				uint32_t triangle = meshlets.triangles[meshlet->triangleFirst + triangleIndex];
+				for (uint32_t cornerIndex = 0; cornerIndex < 3; ++cornerIndex) {
+					uint32_t localIndex = (triangle >> (8 * cornerIndex)) & 0xFF;
+					HbMesh_Test_Check(localIndex < meshlet->vertexCount, "Meshlet %u references vertex %u", meshletIndex, localIndex);
+					rebuiltIndexes[3 * (meshlet->triangleFirst + triangleIndex) + cornerIndex] =
+							meshlets.vertexes[meshlet->vertexFirst + HbMinU32(localIndex, meshlet->vertexCount - 1)];
+				}
+			}
+
+			// All vertexes must be within the bounding sphere.
+			for (uint32_t vertexIndex = 0; vertexIndex < meshlet->vertexCount; ++vertexIndex) {
+				float const * position = sphere.positions + 3 * meshlets.vertexes[meshlet->vertexFirst + vertexIndex];
+				float difference[3] = { position[0] - meshlet->center[0], position[1] - meshlet->center[1], position[2] - meshlet->center[2] };
+				HbMesh_Test_Check(sqrtf(difference[0] * difference[0] + difference[1] * difference[1] + difference[2] * difference[2]) <=
+						meshlet->radius, "Vertex %u outside the bounding sphere of meshlet %u", vertexIndex, meshletIndex);
+			}
+			cullableCount += (meshlet->coneAxisAndCutoff[3] < INT8_MAX);
+		}
+		if (triangleEnd == sphere.triangleCount) {
+			HbMesh_Test_Check(HbMesh_Test_AreSameTriangles(sphere.indexes, rebuiltIndexes, sphere.triangleCount),
+					"The triangles of the meshlets are not the triangles of the mesh");
+		} else {
+			HbMesh_Test_Check(HbFalse, "%u triangles in the meshlets, %u in the mesh", triangleEnd, sphere.triangleCount);
+		}
+		// Parts of a smooth sphere are small enough to be culled by the normal cones.
+		HbMesh_Test_Check(cullableCount * 2 >= meshlets.count, "Only %u of %u meshlets have normal cones", cullableCount, meshlets.count);
+		free(rebuiltIndexes);
+		HbMesh_Test_Meshlets_Destroy(&meshlets);
+	}
+
+	HbMesh_Test_Mesh_Destroy(&sphere);
+}
+
+// Normal cones must be conservative - if the cone test says the meshlet is back-facing, all its triangles must be.
+static void HbMesh_Test_MeshletCones() {
+	float const center[3] = { 0.0f, 0.0f, 0.0f };
+	HbMesh_Test_Mesh sphere;
+	HbMesh_Test_Mesh_InitSphere(&sphere, 32, 16, 1.0f, center);
+	HbMesh_Test_Meshlets meshlets;
+	HbMesh_Test_Meshlets_Build(&meshlets, &sphere, 1.0f);
+	uint32_t randomState = 1;
+	uint32_t backFacingCount = 0;
+	for (uint32_t eyeIndex = 0; eyeIndex < 256; ++eyeIndex) {
+		float eye[3];
+		for (uint32_t axis = 0; axis < 3; ++axis) {
+			eye[axis] = ((float) (HbMesh_Test_Random(&randomState) & 0xFFFF) * (1.0f / 0xFFFF) - 0.5f) * 10.0f;
+		}
+		for (uint32_t meshletIndex = 0; meshletIndex < meshlets.count; ++meshletIndex) {
+			HbMesh_Meshlet const * meshlet = &meshlets.meshlets[meshletIndex];
+			float axis[3] = { (float) meshlet->coneAxisAndCutoff[0], (float) meshlet->coneAxisAndCutoff[1], (float) meshlet->coneAxisAndCutoff[2] };
+			float eyeToApex[3] = { meshlet->coneApex[0] - eye[0], meshlet->coneApex[1] - eye[1], meshlet->coneApex[2] - eye[2] };
+			float axisLength = sqrtf(axis[0] * axis[0] + axis[1] * axis[1] + axis[2] * axis[2]);
+			float eyeToApexLength = sqrtf(eyeToApex[0] * eyeToApex[0] + eyeToApex[1] * eyeToApex[1] + eyeToApex[2] * eyeToApex[2]);
+			if (axisLength <= 0.0f || (eyeToApex[0] * axis[0] + eyeToApex[1] * axis[1] + eyeToApex[2] * axis[2]) <
+					(float) meshlet->coneAxisAndCutoff[3] * (1.0f / 127.0f) * axisLength * eyeToApexLength) {
+				continue;
+			}
+			++backFacingCount;
+			for (uint32_t triangleIndex = 0; triangleIndex < meshlet->triangleCount; ++triangleIndex) {
+				uint32_t triangle = meshlets.triangles[meshlet->triangleFirst + triangleIndex];
+				float const * p0 = sphere.positions + 3 * meshlets.vertexes[meshlet->vertexFirst + (triangle & 0xFF)];
+				float const * p1 = sphere.positions + 3 * meshlets.vertexes[meshlet->vertexFirst + ((triangle >> 8) & 0xFF)];
+				float const * p2 = sphere.positions + 3 * meshlets.vertexes[meshlet->vertexFirst + ((triangle >> 16) & 0xFF)];
+				float e1[3] = { p1[0] - p0[0], p1[1] - p0[1], p1[2] - p0[2] }, e2[3] = { p2[0] - p0[0], p2[1] - p0[1], p2[2] - p0[2] };
+				float normal[3] = { e1[1] * e2[2] - e1[2] * e2[1], e1[2] * e2[0] - e1[0] * e2[2], e1[0] * e2[1] - e1[1] * e2[0] };
+				float eyeToP0[3] = { p0[0] - eye[0], p0[1] - eye[1], p0[2] - eye[2] };
+				// The normal is on the front side, which the eye must not be on.
+				HbMesh_Test_Check(eyeToP0[0] * normal[0] + eyeToP0[1] * normal[1] + eyeToP0[2] * normal[2] >= -1.0e-5f,
+						"Triangle %u of meshlet %u front-facing, but the meshlet is culled by the cone", triangleIndex, meshletIndex);
+			}
+		}
+	}
+	HbMesh_Test_Check(backFacingCount != 0, "No meshlets culled by the cones");
+	HbMesh_Test_Meshlets_Destroy(&meshlets);
+	HbMesh_Test_Mesh_Destroy(&sphere);
+}
+
+/**********
+ * Culling
+ **********/
+
+// Perspective projection looking along +Z from the origin, with the reversed depth from 1 at the near plane to 0 at infinity.
+static void HbMesh_Test_GetModelToClip(float modelToClip[4][4], float nearZ) {
+	memset(modelToClip, 0, 16 * sizeof(float));
+	modelToClip[0][0] = 1.0f; // 90 degrees horizontally.
+	modelToClip[1][1] = 1.0f;
+	modelToClip[2][3] = nearZ;
+	modelToClip[3][2] = 1.0f;
+}
+
+static HbMesh_Meshlet HbMesh_Test_GetSphereMeshlet(float x, float y, float z, float radius) {
+	HbMesh_Meshlet meshlet;
+	memset(&meshlet, 0, sizeof(meshlet));
+	meshlet.center[0] = x;
+	meshlet.center[1] = y;
+	meshlet.center[2] = z;
+	meshlet.radius = radius;
+	meshlet.coneAxisAndCutoff[3] = INT8_MAX;
+	meshlet.triangleCount = 1;
+	return meshlet;
+}
+
+static void HbMesh_Test_MeshletCuller() {
+	float modelToClip[4][4];
+	HbMesh_Test_GetModelToClip(modelToClip, 0.1f);
+	float const eye[3] = { 0.0f, 0.0f, 0.0f };
+
+	// Frustum culling.
+	HbMesh_Meshlet const meshlets[] = {
+		HbMesh_Test_GetSphereMeshlet(0.0f, 0.0f, 10.0f, 1.0f), // In front.
+		HbMesh_Test_GetSphereMeshlet(0.0f, 0.0f, -10.0f, 1.0f), // Behind.
+		HbMesh_Test_GetSphereMeshlet(-20.0f, 0.0f, 10.0f, 1.0f), // To the left.
+		HbMesh_Test_GetSphereMeshlet(0.0f, 11.5f, 10.0f, 2.0f), // Intersecting the top plane.
+		HbMesh_Test_GetSphereMeshlet(0.0f, 0.0f, 0.05f, 0.01f), // Before the near plane.
+		HbMesh_Test_GetSphereMeshlet(0.0f, 0.0f, 1.0e6f, 1.0f), // Far away, with the far plane at infinity.
+	};
+	HbBool const expectedVisible[] = { HbTrue, HbFalse, HbFalse, HbTrue, HbFalse, HbTrue };
+	HbMesh_Meshlet_Culler culler;
+	HbMesh_Meshlet_Culler_Init(&culler, (float const (*)[4]) modelToClip, eye, NULL, 4, 64, 64);
+	for (uint32_t meshletIndex = 0; meshletIndex < HbArrayLength(meshlets); ++meshletIndex) {
+		HbMesh_Test_Check(HbMesh_Meshlet_Culler_IsVisible(&culler, &meshlets[meshletIndex]) == expectedVisible[meshletIndex],
+				"Meshlet %u is expected to be %s", meshletIndex, expectedVisible[meshletIndex] ? "visible" : "culled");
+	}
+	uint32_t visibleIndexes[HbArrayLength(meshlets)];
+	uint32_t visibleCount = HbMesh_Meshlet_Culler_Cull(&culler, meshlets, HbArrayLength(meshlets), visibleIndexes);
+	HbMesh_Test_Check(visibleCount == 3 && visibleIndexes[0] == 0 && visibleIndexes[1] == 3 && visibleIndexes[2] == 5,
+			"Wrong visible meshlet list, %u visible", visibleCount);
+
+	// Cone culling - a meshlet facing +Z (away from the eye) with a narrow cone is culled, but visible from behind.
+	HbMesh_Meshlet coneMeshlet = HbMesh_Test_GetSphereMeshlet(0.0f, 0.0f, 10.0f, 1.0f);
+	coneMeshlet.coneApex[2] = 9.0f;
+	coneMeshlet.coneAxisAndCutoff[2] = INT8_MAX;
+	coneMeshlet.coneAxisAndCutoff[3] = 20;
+	HbMesh_Test_Check(!HbMesh_Meshlet_Culler_IsVisible(&culler, &coneMeshlet), "Back-facing meshlet not culled");
+	float const eyeBehind[3] = { 0.0f, 0.0f, 20.0f };
+	float modelToClipBehind[4][4];
+	// Looking along -Z from Z = 20.
+	HbMesh_Test_GetModelToClip(modelToClipBehind, 0.1f);
+	modelToClipBehind[0][0] = -1.0f;
+	modelToClipBehind[3][2] = -1.0f;
+	modelToClipBehind[3][3] = 20.0f;
+	HbMesh_Meshlet_Culler cullerBehind;
+	HbMesh_Meshlet_Culler_Init(&cullerBehind, (float const (*)[4]) modelToClipBehind, eyeBehind, NULL, 4, 64, 64);
+	HbMesh_Test_Check(HbMesh_Meshlet_Culler_IsVisible(&cullerBehind, &coneMeshlet), "Front-facing meshlet culled");
+
+	// Occlusion culling with 16x16 tiles of a 64x48 viewport (with the reversed depth, greater is nearer).
+	float tileFarthestDepths[4 * 3];
+	for (uint32_t tileIndex = 0; tileIndex < HbArrayLength(tileFarthestDepths); ++tileIndex) {
+		tileFarthestDepths[tileIndex] = 0.0f;
+	}
+	HbMesh_Meshlet_Culler occlusionCuller;
+	HbMesh_Meshlet_Culler_Init(&occlusionCuller, (float const (*)[4]) modelToClip, eye, tileFarthestDepths, 4, 64, 48);
+	HbMesh_Test_Check(occlusionCuller.widthTiles == 4 && occlusionCuller.heightTiles == 3,
+			"%ux%u tiles", occlusionCuller.widthTiles, occlusionCuller.heightTiles);
+	HbMesh_Meshlet const occludedMeshlet = HbMesh_Test_GetSphereMeshlet(0.0f, 0.0f, 10.0f, 1.0f);
+	HbMesh_Test_Check(HbMesh_Meshlet_Culler_IsVisible(&occlusionCuller, &occludedMeshlet), "Meshlet in front of the far plane culled");
+	// An occluder at Z = 5 (depth 0.02) everywhere.
+	for (uint32_t tileIndex = 0; tileIndex < HbArrayLength(tileFarthestDepths); ++tileIndex) {
+		tileFarthestDepths[tileIndex] = 0.1f / 5.0f;
+	}
+	HbMesh_Test_Check(!HbMesh_Meshlet_Culler_IsVisible(&occlusionCuller, &occludedMeshlet), "Occluded meshlet not culled");
+	HbMesh_Meshlet const occluderMeshlet = HbMesh_Test_GetSphereMeshlet(0.0f, 0.0f, 4.0f, 0.5f);
+	HbMesh_Test_Check(HbMesh_Meshlet_Culler_IsVisible(&occlusionCuller, &occluderMeshlet), "Meshlet in front of the occluder culled");
+	// A hole in the occluder in one tile covered by the meshlet.
+	tileFarthestDepths[1 * 4 + 2] = 0.0f;
+	HbMesh_Test_Check(HbMesh_Meshlet_Culler_IsVisible(&occlusionCuller, &occludedMeshlet), "Meshlet visible through a hole culled");
+}
+
+int main() {
+	HbMesh_Test_VertexCacheStats();
+	HbMesh_Test_OptimizeVertexCache();
+	HbMesh_Test_OptimizeOverdraw();
+	HbMesh_Test_OptimizeVertexFetch();
+	HbMesh_Test_MeshletBuild();
+	HbMesh_Test_MeshletCones();
+	HbMesh_Test_MeshletCuller();
+	if (HbMesh_Test_FailureCount != 0) {
+		printf("%u checks failed.\n", HbMesh_Test_FailureCount);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed.\n");
+	return EXIT_SUCCESS;
+}
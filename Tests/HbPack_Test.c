@@ -0,0 +1,249 @@
+// Behavior tests of version 1 pack lookups in HbPack.h, with and without a hash map, which use the OS only for validation threads,
+// so they can be built for any OS with a platform layer, for instance:
+// gcc -std=gnu11 -O2 -msse3 -I.. HbPack_Test.c ../HbPack.c ../HbHash.c ../HbText.c ../HbText_Intern.c ../HbParallel.c ../HbMemory.c ../HbFeedback.c -lm -lpthread -o HbPack_Test
+// cl /O2 /I.. HbPack_Test.c ..\HbPack.c ..\HbHash.c ..\HbText.c ..\HbText_Intern.c ..\HbParallel.c ..\HbMemory.c ..\HbFeedback.c
+// Returns 0 if all tests pass, printing the failed checks otherwise.
+// Half of the names have non-zero bytes after the terminator, which only name[55] being zero is validated for.
+
+#include "HbHash.h"
+#include "HbPack.h"
+#include <stdio.h>
+
+static uint32_t HbPack_Test_FailureCount;
+
+#define HbPack_Test_Check(condition, ...) \
+	{ if (!(condition)) { ++HbPack_Test_FailureCount; printf("%s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }
+
+#define HbPack_Test_MaxItems 32
+#define HbPack_Test_ItemDataSize 16
+
+typedef struct HbAligned(16) HbPack_Test_Buffer {
+	uint8_t bytes[sizeof(HbPack_Header) + HbPack_Test_MaxItems * (sizeof(HbPack_DirectoryEntry) + 2 * sizeof(uint32_t) + HbPack_Test_ItemDataSize)];
+} HbPack_Test_Buffer;
+
+static HbPack_Test_Buffer HbPack_Test_Pack;
+
+typedef struct HbPack_Test_Item {
+	char const * name;
+	char const * tail; // Written once after the terminator, "" for the repeated default tail, NULL to keep the name zero-padded.
+} HbPack_Test_Item;
+
+// Repeated after the terminator until name[54].
+static char const HbPack_Test_DefaultTail[] = "Stone.DDS/\x80\xFFzZ_";
+
+// 55 characters, the longest name a version 1 entry can hold.
+#define HbPack_Test_LongestName "Textures/Terrain/Long/Long/Long/Long/Long/Long_Name.dds"
+
+// Sorted caselessly, in the C locale (only A-Z are folded).
+static HbPack_Test_Item const HbPack_Test_Items[] = {
+	{ "Materials/Brick.kv", NULL },
+	{ "Materials/brick_wet.kv", "" },
+	{ "Materials/Grass.kv", NULL },
+	{ "Models/Crate.iqm", "" },
+	{ "Models/crate_lod1.iqm", NULL },
+	{ "Models/Tree.iqm", "" },
+	{ "Shaders/Mesh.hlsl", NULL },
+	{ "Shaders/mesh_depth.hlsl", "" },
+	{ "Sounds/Step1.ogg", NULL },
+	{ "Sounds/Step2.ogg", "" },
+	{ "Textures/Brick.dds", NULL },
+	// The tails complete the names of the next items.
+	{ "Textures/Stone", ".dds" },
+	{ "Textures/Stone.dds", NULL },
+	{ "Textures/stone_normal.dds", "" },
+	{ HbPack_Test_LongestName, NULL },
+	{ "Textures/Z", "_" },
+	{ "Textures/z_", NULL },
+	{ "UI/Font.dds", "" },
+	{ "UI/Icons.dds", NULL },
+};
+
+#define HbPack_Test_ItemCount ((uint32_t) HbArrayLength(HbPack_Test_Items))
+
+static uint32_t HbPack_Test_Build(HbBool hashMap) {
+	uint8_t * pack = HbPack_Test_Pack.bytes;
+	memset(pack, 0, sizeof(HbPack_Test_Pack.bytes));
+	HbPack_Header * header = (HbPack_Header *) pack;
+	memcpy(header->id, HbPack_HeaderID, sizeof(header->id));
+	header->itemCount = HbPack_Test_ItemCount;
+	header->hashMapPresent = hashMap;
+	HbPack_DirectoryEntry * directory = (HbPack_DirectoryEntry *) (pack + sizeof(HbPack_Header));
+	uint32_t hashMapOffset = sizeof(HbPack_Header) + HbPack_Test_ItemCount * sizeof(HbPack_DirectoryEntry);
+	uint32_t hashMapIndexMask = 0;
+	uint32_t dataOffset = hashMapOffset;
+	if (hashMap) {
+		hashMapIndexMask = ((uint32_t) 1 << HbHash_MapUtil_GetNeededEntriesLog2(HbPack_Test_ItemCount)) - 1;
+		memset(pack + hashMapOffset, 0xFF, (hashMapIndexMask + 1) * sizeof(uint32_t)); // HbPack_InvalidItemIndex.
+		dataOffset += (hashMapIndexMask + 1) * sizeof(uint32_t);
+	}
+	for (uint32_t itemIndex = 0; itemIndex < HbPack_Test_ItemCount; ++itemIndex) {
+		HbPack_Test_Item const * item = &HbPack_Test_Items[itemIndex];
+		HbPack_DirectoryEntry * directoryEntry = &directory[itemIndex];
+		size_t nameLength = strlen(item->name);
+		memcpy(directoryEntry->name, item->name, nameLength);
+		if (item->tail != NULL && item->tail[0] != '\0') {
+			memcpy(directoryEntry->name + nameLength + 1, item->tail, strlen(item->tail));
+		} else if (item->tail != NULL) {
+			for (size_t characterIndex = nameLength + 1; characterIndex < HbPack_MaxItemNameSize - 1; ++characterIndex) {
+				directoryEntry->name[characterIndex] =
+						HbPack_Test_DefaultTail[(characterIndex - (nameLength + 1)) % (HbArrayLength(HbPack_Test_DefaultTail) - 1)];
+			}
+		}
+		directoryEntry->offset = dataOffset + itemIndex * HbPack_Test_ItemDataSize;
+		directoryEntry->size = 1 + itemIndex % HbPack_Test_ItemDataSize;
+		memset(pack + directoryEntry->offset, (int) itemIndex, HbPack_Test_ItemDataSize);
+		if (hashMap) {
+			uint32_t * hashMapSlots = (uint32_t *) (pack + hashMapOffset);
+			uint32_t hash = HbHash_FNV1a_HashTextACaseless(item->name);
+			uint32_t hashIndex = hash & hashMapIndexMask;
+			while (hashMapSlots[hashIndex] != HbPack_InvalidItemIndex) {
+				HbHash_MapUtil_PerturbateIndex(&hash, &hashIndex, hashMapIndexMask);
+			}
+			hashMapSlots[hashIndex] = itemIndex;
+		}
+	}
+	return dataOffset + HbPack_Test_ItemCount * HbPack_Test_ItemDataSize;
+}
+
+static void HbPack_Test_ToUpper(char * target, char const * source) {
+	do {
+		*target++ = (*source >= 'a' && *source <= 'z') ? (char) (*source - ('a' - 'A')) : *source;
+	} while (*source++ != '\0');
+}
+
+static void HbPack_Test_Lookups(HbBool hashMap) {
+	char const * packName = hashMap ? "with a hash map" : "without a hash map";
+	uint32_t packSize = HbPack_Test_Build(hashMap);
+
+	HbPack_Info info;
+	HbPack_ErrorReport errorReport;
+	for (uint32_t threadCount = 1; threadCount <= 2; ++threadCount) {
+		HbPack_Test_Check(HbPack_GetInfo(HbPack_Test_Pack.bytes, packSize, &info, HbTrue, threadCount, &errorReport),
+				"Pack %s not valid on %u threads (error %u, index %u)", packName, threadCount,
+				(unsigned int) errorReport.error, errorReport.index);
+	}
+	if (!HbPack_GetInfo(HbPack_Test_Pack.bytes, packSize, &info, HbTrue, 1, NULL)) {
+		return;
+	}
+	HbPack_Test_Check(info.version == 1 && info.itemCount == HbPack_Test_ItemCount && (info.hashMapOffset != 0) == hashMap,
+			"Pack %s info is version %u with %u items and hash map offset %u", packName, info.version, info.itemCount, info.hashMapOffset);
+
+	char name[HbPack_MaxNameSize], key[HbPack_MaxNameSize];
+	for (uint32_t itemIndex = 0; itemIndex < HbPack_Test_ItemCount; ++itemIndex) {
+		char const * itemName = HbPack_Test_Items[itemIndex].name;
+		size_t nameLength = HbPack_GetItemName(&info, itemIndex, name);
+		HbPack_Test_Check(nameLength == strlen(itemName) && strcmp(name, itemName) == 0,
+				"Pack %s item %u name is %s (%zu characters) instead of %s", packName, itemIndex, name, nameLength, itemName);
+		HbPack_Test_Check(HbPack_GetItemNameHash(&info, itemIndex) == HbHash_FNV1a_HashTextACaseless(itemName),
+				"Pack %s item %u name hash includes the bytes after the terminator", packName, itemIndex);
+
+		uint32_t foundIndex = HbPack_Find(&info, itemName);
+		HbPack_Test_Check(foundIndex == itemIndex, "Pack %s found %s at %u instead of %u", packName, itemName, foundIndex, itemIndex);
+		HbPack_Test_ToUpper(key, itemName);
+		foundIndex = HbPack_Find(&info, key);
+		HbPack_Test_Check(foundIndex == itemIndex, "Pack %s found %s at %u instead of %u", packName, key, foundIndex, itemIndex);
+		foundIndex = HbPack_FindFirstPrefixed(&info, itemName);
+		HbPack_Test_Check(foundIndex == itemIndex, "Pack %s found the first prefixed %s at %u instead of %u",
+				packName, itemName, foundIndex, itemIndex);
+
+		// The name followed by what is stored after its terminator must only be found if it's a different item.
+		if (HbPack_Test_Items[itemIndex].tail != NULL) {
+			size_t keyLength = HbTextA_Copy(key, HbArrayLength(key), itemName);
+			HbTextA_Copy(key + keyLength, HbArrayLength(key) - keyLength, &HbPack_GetDirectory(&info)[itemIndex].name[keyLength + 1]);
+			uint32_t expectedIndex = HbPack_InvalidItemIndex;
+			for (uint32_t otherIndex = 0; otherIndex < HbPack_Test_ItemCount; ++otherIndex) {
+				if (HbTextA_CompareCaseless(HbPack_Test_Items[otherIndex].name, key) == 0) {
+					expectedIndex = otherIndex;
+				}
+			}
+			foundIndex = HbPack_Find(&info, key);
+			HbPack_Test_Check(foundIndex == expectedIndex, "Pack %s found %s at %u instead of %u", packName, key, foundIndex, expectedIndex);
+		}
+
+		// Prefixes that are not followed by a path separator in any name.
+		HbTextA_Copy(key, HbArrayLength(key), itemName);
+		HbTextA_Copy(key + strlen(key), HbArrayLength(key) - strlen(key), "/");
+		foundIndex = HbPack_FindFirstPrefixed(&info, key);
+		HbPack_Test_Check(foundIndex == HbPack_InvalidItemIndex, "Pack %s found the first prefixed %s at %u", packName, key, foundIndex);
+	}
+
+	static struct {
+		char const * prefix;
+		uint32_t itemIndex;
+	} const prefixes[] = {
+		{ "Materials/", 0 },
+		{ "materials/b", 0 },
+		{ "MATERIALS/BRICK_", 1 },
+		{ "Models/", 3 },
+		{ "Textures/Stone", 11 },
+		{ "Textures/Stone.", 12 },
+		{ "Textures/Stone_", 13 },
+		{ "textures/t", 14 },
+		{ "Textures/z", 15 },
+		{ "Textures/Z_", 16 },
+		{ "UI/", 17 },
+		{ "A", HbPack_InvalidItemIndex },
+		{ "Textures/Stone.dds.", HbPack_InvalidItemIndex },
+		{ "V", HbPack_InvalidItemIndex },
+	};
+	for (uint32_t prefixIndex = 0; prefixIndex < HbArrayLength(prefixes); ++prefixIndex) {
+		uint32_t foundIndex = HbPack_FindFirstPrefixed(&info, prefixes[prefixIndex].prefix);
+		HbPack_Test_Check(foundIndex == prefixes[prefixIndex].itemIndex, "Pack %s found the first prefixed %s at %u instead of %u",
+				packName, prefixes[prefixIndex].prefix, foundIndex, prefixes[prefixIndex].itemIndex);
+	}
+
+	static char const * const missingNames[] = {
+		"", "Materials", "Materials/", "Materials/Brick", "Materials/Brick.kv.bak", "Textures/Ston", "Textures/Stone.dd",
+		"Textures/Stone\x80", "Textures/Y", "Textures/ZZ", "Zzz",
+		// Longer than any version 1 name, and the longest name with one more character.
+		"Textures/Terrain/Long/Long/Long/Long/Long/Long/Long/Long/Long_Name.dds", HbPack_Test_LongestName "s",
+	};
+	for (uint32_t missingIndex = 0; missingIndex < HbArrayLength(missingNames); ++missingIndex) {
+		uint32_t foundIndex = HbPack_Find(&info, missingNames[missingIndex]);
+		HbPack_Test_Check(foundIndex == HbPack_InvalidItemIndex, "Pack %s found the missing %s at %u",
+				packName, missingNames[missingIndex], foundIndex);
+	}
+
+	for (uint32_t itemIndex = 0; itemIndex < HbPack_Test_ItemCount; ++itemIndex) {
+		uint8_t const * data = (uint8_t const *) HbPack_GetItemData(&info, itemIndex);
+		HbPack_Test_Check(HbPack_GetItemSize(&info, itemIndex) == 1 + itemIndex % HbPack_Test_ItemDataSize && data[0] == itemIndex,
+				"Pack %s item %u data is wrong", packName, itemIndex);
+	}
+}
+
+// Names must be zero-terminated by name[55], but the rest of the tail is not validated.
+static void HbPack_Test_Validation() {
+	uint32_t packSize = HbPack_Test_Build(HbFalse);
+	HbPack_DirectoryEntry * directory = (HbPack_DirectoryEntry *) (HbPack_Test_Pack.bytes + sizeof(HbPack_Header));
+	HbPack_ErrorReport errorReport;
+	HbPack_Info info;
+
+	directory[5].name[HbPack_MaxItemNameSize - 2] = 'x';
+	HbPack_Test_Check(HbPack_GetInfo(HbPack_Test_Pack.bytes, packSize, &info, HbTrue, 1, &errorReport),
+			"Pack with a non-zero name[54] after the terminator not valid (error %u, index %u)",
+			(unsigned int) errorReport.error, errorReport.index);
+
+	directory[5].name[HbPack_MaxItemNameSize - 1] = 'x';
+	HbPack_Test_Check(!HbPack_GetInfo(HbPack_Test_Pack.bytes, packSize, &info, HbTrue, 1, &errorReport) &&
+			errorReport.error == HbPack_Error_ItemNameUnterminated && errorReport.index == 5,
+			"Pack with a non-zero name[55] not rejected as unterminated at 5 (error %u, index %u)",
+			(unsigned int) errorReport.error, errorReport.index);
+	directory[5].name[HbPack_MaxItemNameSize - 1] = '\0';
+
+	directory[9].name[0] = '\0';
+	HbPack_Test_Check(!HbPack_GetInfo(HbPack_Test_Pack.bytes, packSize, &info, HbTrue, 1, &errorReport) &&
+			errorReport.error == HbPack_Error_ItemNameEmpty && errorReport.index == 9,
+			"Pack with an empty name not rejected as empty at 9 (error %u, index %u)", (unsigned int) errorReport.error, errorReport.index);
+}
+
+int main() {
+	HbPack_Test_Lookups(HbFalse);
+	HbPack_Test_Lookups(HbTrue);
+	HbPack_Test_Validation();
+	if (HbPack_Test_FailureCount != 0) {
+		printf("%u checks failed.\n", HbPack_Test_FailureCount);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed.\n");
+	return EXIT_SUCCESS;
+}
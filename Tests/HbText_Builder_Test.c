@@ -0,0 +1,239 @@
+// Behavior tests of HbText_Builder.h - formatting compared to the C runtime printf, rounding of floating-point numbers,
+// and truncation of text in fixed buffers at UTF-8 character boundaries. The growable buffer uses a memory tag, for instance:
+// gcc -std=gnu11 -O2 -msse3 -I.. HbText_Builder_Test.c ../HbText_Builder.c ../HbText.c ../HbText_Intern.c ../HbHash.c ../HbMemory.c ../HbParallel.c ../HbFeedback.c -lm -lpthread -o HbText_Builder_Test
+// cl /O2 /I.. HbText_Builder_Test.c ..\HbText_Builder.c ..\HbText.c ..\HbText_Intern.c ..\HbHash.c ..\HbMemory.c ..\HbParallel.c ..\HbFeedback.c
+// Returns 0 if all tests pass, printing the failed checks otherwise.
+
+#include "HbText_Builder.h"
+#include <stdio.h>
+
+static uint32_t HbText_Builder_Test_FailureCount;
+
+#define HbText_Builder_Test_Check(condition, ...) \
+	{ if (!(condition)) { ++HbText_Builder_Test_FailureCount; printf("%s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }
+
+// Formats with both the builder and snprintf, and compares the results.
+#define HbText_Builder_Test_CheckFormat(format, ...) \
+	{ \
+		char expected[256]; \
+		snprintf(expected, sizeof(expected), format, __VA_ARGS__); \
+		HbTextU8 buffer[256]; \
+		HbText_Builder builder; \
+		HbText_Builder_InitFixed(&builder, buffer, sizeof(buffer)); \
+		HbBool fits = HbText_Builder_Format(&builder, format, __VA_ARGS__); \
+		HbText_Builder_Test_Check(fits && !builder.truncated, "Formatting %s with %s didn't fit", format, #__VA_ARGS__); \
+		HbText_Builder_Test_Check(strcmp(HbText_Builder_GetText(&builder), expected) == 0 && builder.length == strlen(expected), \
+				"Formatting %s with %s wrote \"%s\" instead of \"%s\"", format, #__VA_ARGS__, HbText_Builder_GetText(&builder), expected); \
+	}
+
+/*************
+ * Formatting
+ *************/
+
+static void HbText_Builder_Test_Format() {
+	HbText_Builder_Test_CheckFormat("Text without specifiers%s", "");
+	HbText_Builder_Test_CheckFormat("100%% of %c%s", 'a', " character and string");
+	HbText_Builder_Test_CheckFormat("[%s] [%8s] [%-8s]", "Stone", "Stone", "Stone");
+	HbText_Builder_Test_CheckFormat("[%c] [%3c] [%-3c]", 'x', 'y', 'z');
+	HbText_Builder_Test_CheckFormat("%d %i %d %d %d", 0, 1, -1, INT32_MAX, INT32_MIN);
+	HbText_Builder_Test_CheckFormat("[%5d] [%-5d] [%05d] [%05d] [%2d]", 42, 42, 42, -42, -12345);
+	HbText_Builder_Test_CheckFormat("%u %u %5u %05u %-5u|", 0u, UINT32_MAX, 7u, 7u, 7u);
+	HbText_Builder_Test_CheckFormat("%x %X %08x %-8X| %x", 0xDEADBEEFu, 0xDEADBEEFu, 0xBEEFu, 0xBEEFu, 0u);
+	// Sizes, including hh and h that truncate the promoted int.
+	HbText_Builder_Test_CheckFormat("%hhd %hhu %hhx %hd %hu %hx", 300, 300, 0x1FF, 70000, 70000, 0x1FFFF);
+	HbText_Builder_Test_CheckFormat("%hhd %hd", -1, -32768);
+	HbText_Builder_Test_CheckFormat("%ld %lu %lx", -123456789L, 123456789UL, 0xABCDEFUL);
+	HbText_Builder_Test_CheckFormat("%lld %lld %llu %llX", (long long) INT64_MIN, (long long) INT64_MAX,
+			(unsigned long long) UINT64_MAX, (unsigned long long) UINT64_MAX);
+	HbText_Builder_Test_CheckFormat("%zu %zx %zd %zd", (size_t) SIZE_MAX, (size_t) 0x1234, (ptrdiff_t) -5, (ptrdiff_t) 5);
+	HbText_Builder_Test_CheckFormat("%f %.0f %.1f %.3f %.9f", 1.5, 2.0, -0.25, 3.14159, 0.000000001);
+	HbText_Builder_Test_CheckFormat("[%10.2f] [%-10.2f] [%010.2f] [%010.2f]", 3.14159, 3.14159, 3.14159, -3.14159);
+	HbText_Builder_Test_CheckFormat("%f %f %.2f", 0.0, -0.0, 123456789012.345);
+	HbText_Builder_Test_CheckFormat("%s.submissions[%u].fence", "copier", 3u);
+}
+
+static void HbText_Builder_Test_FormatAppends() {
+	// Formatting continues the existing text, and SetLength reuses a common prefix.
+	HbTextU8 buffer[64];
+	HbText_Builder builder;
+	HbText_Builder_InitFixed(&builder, buffer, sizeof(buffer));
+	HbText_Builder_Test_Check(strcmp(HbText_Builder_GetText(&builder), "") == 0, "The fixed builder is not empty initially");
+	HbText_Builder_AppendA(&builder, "items[");
+	size_t prefixLength = builder.length;
+	for (uint32_t itemIndex = 9; itemIndex <= 11; ++itemIndex) {
+		HbText_Builder_SetLength(&builder, prefixLength);
+		HbText_Builder_Format(&builder, "%u].name", itemIndex);
+		char expected[64];
+		snprintf(expected, sizeof(expected), "items[%u].name", itemIndex);
+		HbText_Builder_Test_Check(strcmp(HbText_Builder_GetText(&builder), expected) == 0, "Wrote \"%s\" instead of \"%s\"",
+				HbText_Builder_GetText(&builder), expected);
+	}
+	// The number functions without the format.
+	HbText_Builder_SetLength(&builder, 0);
+	HbText_Builder_AppendU32(&builder, 0);
+	HbText_Builder_AppendChar(&builder, ' ');
+	HbText_Builder_AppendS32(&builder, INT32_MIN);
+	HbText_Builder_AppendChar(&builder, ' ');
+	HbText_Builder_AppendU64(&builder, 42, 4);
+	HbText_Builder_AppendChar(&builder, ' ');
+	HbText_Builder_AppendS64(&builder, -42, 4);
+	HbText_Builder_AppendChar(&builder, ' ');
+	HbText_Builder_AppendS64(&builder, INT64_MIN, 1);
+	HbText_Builder_AppendChar(&builder, ' ');
+	HbText_Builder_AppendHex(&builder, 0xBEEF, 8, HbTrue);
+	char const * expected = "0 -2147483648 0042 -0042 -9223372036854775808 0000BEEF";
+	HbText_Builder_Test_Check(strcmp(HbText_Builder_GetText(&builder), expected) == 0, "Wrote \"%s\" instead of \"%s\"",
+			HbText_Builder_GetText(&builder), expected);
+}
+
+/********************************
+ * Floating-point number rounding
+ ********************************/
+
+static void HbText_Builder_Test_CheckF64(double value, uint32_t fractionDigits, char const * expected) {
+	HbTextU8 buffer[64];
+	HbText_Builder builder;
+	HbText_Builder_InitFixed(&builder, buffer, sizeof(buffer));
+	HbText_Builder_AppendF64(&builder, value, fractionDigits);
+	HbText_Builder_Test_Check(strcmp(HbText_Builder_GetText(&builder), expected) == 0,
+			"%.17g with %u fraction digits written as \"%s\" instead of \"%s\"", value, fractionDigits, HbText_Builder_GetText(&builder), expected);
+}
+
+static void HbText_Builder_Test_F64() {
+	// Exact halves are rounded to even like printf, including when the integer part is the last digit.
+	HbText_Builder_Test_CheckF64(0.5, 0, "0");
+	HbText_Builder_Test_CheckF64(1.5, 0, "2");
+	HbText_Builder_Test_CheckF64(2.5, 0, "2");
+	HbText_Builder_Test_CheckF64(-2.5, 0, "-2");
+	HbText_Builder_Test_CheckF64(0.125, 2, "0.12");
+	HbText_Builder_Test_CheckF64(0.375, 2, "0.38");
+	HbText_Builder_Test_CheckF64(0.0625, 3, "0.062");
+	// Not exact halves in binary, rounded by the actual value.
+	HbText_Builder_Test_CheckF64(2.675, 2, "2.67");
+	HbText_Builder_Test_CheckF64(1.005, 2, "1.00");
+	HbText_Builder_Test_CheckF64(0.1, 9, "0.100000000");
+	// Carrying from the fraction to the integer part.
+	HbText_Builder_Test_CheckF64(0.9999, 3, "1.000");
+	HbText_Builder_Test_CheckF64(9.96, 1, "10.0");
+	HbText_Builder_Test_CheckF64(-99.999999999, 6, "-100.000000");
+	HbText_Builder_Test_CheckF64(0.75, 0, "1");
+	// More than the supported number of digits is clamped.
+	HbText_Builder_Test_CheckF64(1.0 / 3.0, 12, "0.333333333");
+	// The sign of zero is kept like in printf.
+	HbText_Builder_Test_CheckF64(-0.0, 1, "-0.0");
+	HbText_Builder_Test_CheckF64(-0.0001, 2, "-0.00");
+	// Special values and the exponential notation for large numbers, including rounding up to the next power of 10.
+	HbText_Builder_Test_CheckF64(INFINITY, 2, "inf");
+	HbText_Builder_Test_CheckF64(-INFINITY, 2, "-inf");
+	HbText_Builder_Test_CheckF64(NAN, 2, "nan");
+	HbText_Builder_Test_CheckF64(999999999999999872.0, 0, "999999999999999872");
+	HbText_Builder_Test_CheckF64(1e18, 2, "1.00e+18");
+	HbText_Builder_Test_CheckF64(-2.5e20, 1, "-2.5e+20");
+	HbText_Builder_Test_CheckF64(9.999e30, 2, "1.00e+31");
+	HbText_Builder_Test_CheckF64(1e300, 0, "1e+300");
+
+	// Exactly representable values in fractions of 1/256, where printf is exact, against the C runtime for all precisions.
+	for (int32_t numerator = -1024; numerator <= 1024; ++numerator) {
+		double value = numerator / 256.0;
+		for (uint32_t fractionDigits = 0; fractionDigits <= HbText_Builder_MaxFractionDigits; ++fractionDigits) {
+			char expected[64];
+			snprintf(expected, sizeof(expected), "%.*f", (int) fractionDigits, value);
+			HbText_Builder_Test_CheckF64(value, fractionDigits, expected);
+		}
+	}
+}
+
+/**************************************
+ * Truncation in fixed and growing text
+ **************************************/
+
+static void HbText_Builder_Test_Truncation() {
+	// 1, 2, 3 and 4 bytes per character - a, e with an acute accent, the euro sign, and an emoji.
+	static char const text[] = "a\xC3\xA9\xE2\x82\xAC\xF0\x9F\x98\x80" "b";
+	static size_t const boundaries[] = { 0, 1, 3, 6, 10, 11 };
+	size_t const textLength = sizeof(text) - 1;
+	for (size_t bufferSize = 1; bufferSize <= textLength + 1; ++bufferSize) {
+		// Canaries after the buffer to detect writing past its end.
+		HbTextU8 buffer[sizeof(text) + 4];
+		memset(buffer, '#', sizeof(buffer));
+		HbText_Builder builder;
+		HbText_Builder_InitFixed(&builder, buffer, bufferSize);
+		HbBool fits = HbText_Builder_AppendA(&builder, text);
+		size_t expectedLength = 0;
+		for (uint32_t boundaryIndex = 0; boundaryIndex < HbArrayLength(boundaries); ++boundaryIndex) {
+			if (boundaries[boundaryIndex] < bufferSize) {
+				expectedLength = boundaries[boundaryIndex];
+			}
+		}
+		HbBool expectedFits = bufferSize > textLength;
+		HbText_Builder_Test_Check(fits == expectedFits && builder.truncated == !expectedFits,
+				"Appending %zu bytes to a %zu-byte buffer returned %d, truncated is %d", textLength, bufferSize, fits, builder.truncated);
+		HbText_Builder_Test_Check(builder.length == expectedLength && buffer[expectedLength] == '\0' &&
+				memcmp(buffer, text, expectedLength) == 0,
+				"Appending to a %zu-byte buffer left %zu bytes instead of %zu", bufferSize, builder.length, expectedLength);
+		for (size_t offset = bufferSize; offset < sizeof(buffer); ++offset) {
+			HbText_Builder_Test_Check(buffer[offset] == '#', "Appending to a %zu-byte buffer overwrote byte %zu", bufferSize, offset);
+		}
+		// Less than the character that didn't fit is left, so a 4-byte character after the truncation is dropped entirely.
+		if (!expectedFits) {
+			HbText_Builder_Test_Check(!HbText_Builder_AppendA(&builder, "\xF0\x9F\x98\x80"), "Appending after truncation succeeded");
+			HbText_Builder_Test_Check(builder.length == expectedLength, "Appending after truncation left %zu bytes instead of %zu",
+					builder.length, expectedLength);
+		}
+	}
+
+	// Padded numbers are cut too, and the truncated flag stays set.
+	HbTextU8 buffer[8];
+	HbText_Builder builder;
+	HbText_Builder_InitFixed(&builder, buffer, sizeof(buffer));
+	HbBool fits = HbText_Builder_Format(&builder, "%s=%5d", "ab", -123);
+	HbText_Builder_Test_Check(!fits && builder.truncated && strcmp(HbText_Builder_GetText(&builder), "ab= -12") == 0,
+			"Truncated formatting wrote \"%s\"", HbText_Builder_GetText(&builder));
+	HbText_Builder_SetLength(&builder, 0);
+	HbText_Builder_Test_Check(builder.truncated, "Cutting the text has reset the truncated flag");
+}
+
+static void HbText_Builder_Test_Growable(HbMemory_Tag * tag) {
+	// Starting with an external buffer, moving to the tag when it's exceeded, and growing repeatedly.
+	HbTextU8 stackBuffer[8];
+	HbText_Builder builder;
+	HbText_Builder_InitGrowable(&builder, tag, stackBuffer, sizeof(stackBuffer));
+	HbText_Builder_AppendA(&builder, "Stack");
+	HbText_Builder_Test_Check(builder.buffer == stackBuffer && !builder.bufferAllocated, "Short text didn't stay in the external buffer");
+	char expected[1024];
+	size_t expectedLength = strlen("Stack");
+	memcpy(expected, "Stack", expectedLength);
+	for (uint32_t partIndex = 0; partIndex < 100; ++partIndex) {
+		HbBool fits = HbText_Builder_Format(&builder, ",\xE2\x82\xAC%u", partIndex);
+		HbText_Builder_Test_Check(fits, "Growing failed at part %u", partIndex);
+		expectedLength += (size_t) sprintf(expected + expectedLength, ",\xE2\x82\xAC%u", partIndex);
+	}
+	HbText_Builder_Test_Check(builder.bufferAllocated && !builder.truncated && builder.length == expectedLength &&
+			strcmp(HbText_Builder_GetText(&builder), expected) == 0, "Growing text has been written incorrectly");
+	HbText_Builder_Destroy(&builder);
+
+	// Without an initial buffer, the text is empty until the first append.
+	HbText_Builder_InitGrowable(&builder, tag, NULL, 0);
+	HbText_Builder_Test_Check(strcmp(HbText_Builder_GetText(&builder), "") == 0, "The growable builder is not empty initially");
+	HbText_Builder_AppendChar(&builder, 'x');
+	HbText_Builder_Test_Check(strcmp(HbText_Builder_GetText(&builder), "x") == 0, "Appending to an unallocated builder failed");
+	HbText_Builder_Destroy(&builder);
+}
+
+int main() {
+	HbMemory_Init();
+	HbMemory_Tag * tag = HbMemory_Tag_Create("HbText_Builder_Test");
+	HbText_Builder_Test_Format();
+	HbText_Builder_Test_FormatAppends();
+	HbText_Builder_Test_F64();
+	HbText_Builder_Test_Truncation();
+	HbText_Builder_Test_Growable(tag);
+	HbMemory_Tag_Destroy(tag, HbTrue);
+	HbMemory_Shutdown();
+	if (HbText_Builder_Test_FailureCount != 0) {
+		printf("%u checks failed.\n", HbText_Builder_Test_FailureCount);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed.\n");
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,197 @@
+// Behavior tests of the ASCII caseless comparison in HbText.h, which reads 16 characters at once, including past the terminator,
+// but not across page boundaries. The strings are placed at the ends of pages followed by inaccessible ones,
+// which are allocated with the OS memory functions, but the rest doesn't depend on the OS, for instance:
+// gcc -std=gnu11 -O2 -msse3 -I.. HbText_Test.c ../HbText.c -o HbText_Test
+// cl /O2 /I.. HbText_Test.c ..\HbText.c
+// Returns 0 if all tests pass, printing the failed checks otherwise.
+
+#include "HbText.h"
+#include <stdio.h>
+#if HbPlatform_OS_Windows
+#include <Windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+static uint32_t HbText_Test_FailureCount;
+
+#define HbText_Test_Check(condition, ...) \
+	{ if (!(condition)) { ++HbText_Test_FailureCount; printf("%s:%d: ", __func__, __LINE__); printf(__VA_ARGS__); printf("\n"); } }
+
+#define HbText_Test_PageSize HbTextA_SafeReadPageSize
+
+// One accessible page followed by an inaccessible one, so reading past the end of the first crashes.
+typedef struct HbText_Test_GuardedPage {
+	char * page;
+} HbText_Test_GuardedPage;
+
+static HbBool HbText_Test_GuardedPage_Init(HbText_Test_GuardedPage * guardedPage) {
+	#if HbPlatform_OS_Windows
+	guardedPage->page = (char *) VirtualAlloc(NULL, 2 * HbText_Test_PageSize, MEM_RESERVE | MEM_COMMIT, PAGE_READWRITE);
+	if (guardedPage->page == NULL) {
+		return HbFalse;
+	}
+	DWORD oldProtection;
+	if (!VirtualProtect(guardedPage->page + HbText_Test_PageSize, HbText_Test_PageSize, PAGE_NOACCESS, &oldProtection)) {
+		VirtualFree(guardedPage->page, 0, MEM_RELEASE);
+		return HbFalse;
+	}
+	#else
+	void * pages = mmap(NULL, 2 * HbText_Test_PageSize, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+	if (pages == MAP_FAILED) {
+		return HbFalse;
+	}
+	guardedPage->page = (char *) pages;
+	if (mprotect(guardedPage->page + HbText_Test_PageSize, HbText_Test_PageSize, PROT_NONE) != 0) {
+		munmap(guardedPage->page, 2 * HbText_Test_PageSize);
+		return HbFalse;
+	}
+	#endif
+	return HbTrue;
+}
+
+static void HbText_Test_GuardedPage_Destroy(HbText_Test_GuardedPage * guardedPage) {
+	#if HbPlatform_OS_Windows
+	VirtualFree(guardedPage->page, 0, MEM_RELEASE);
+	#else
+	munmap(guardedPage->page, 2 * HbText_Test_PageSize);
+	#endif
+}
+
+// Fills the end of the page with garbage and places the string so garbageAfter bytes follow its terminator before the end of the page.
+#define HbText_Test_GuardedPage_MaxPlacedSize 128
+static char * HbText_Test_GuardedPage_Place(HbText_Test_GuardedPage * guardedPage, char const * text, size_t garbageAfter) {
+	for (size_t offset = HbText_Test_PageSize - HbText_Test_GuardedPage_MaxPlacedSize; offset < HbText_Test_PageSize; ++offset) {
+		guardedPage->page[offset] = (char) ('A' + offset % 26);
+	}
+	size_t size = strlen(text) + 1;
+	char * placed = guardedPage->page + HbText_Test_PageSize - garbageAfter - size;
+	memcpy(placed, text, size);
+	return placed;
+}
+
+// Reference implementation - one character at a time, folding only A-Z.
+static int HbText_Test_ComparePartCaseless(char const * a, char const * b, size_t maxLength) {
+	for (size_t offset = 0; offset < maxLength; ++offset) {
+		uint8_t aLower = (uint8_t) a[offset], bLower = (uint8_t) b[offset];
+		aLower += (aLower >= 'A' && aLower <= 'Z') ? 'a' - 'A' : 0;
+		bLower += (bLower >= 'A' && bLower <= 'Z') ? 'a' - 'A' : 0;
+		if (aLower != bLower || aLower == '\0') {
+			return aLower - bLower;
+		}
+	}
+	return 0;
+}
+
+/*****************************************************
+ * Comparison of strings placed at the ends of pages
+ *****************************************************/
+
+// Pairs of strings to compare both ways - of lengths around multiples of 16, differing in case only, by characters next to the letters
+// (@ [ ` { are right before or after A-Z and a-z), by bytes over 0x7F, and by the length.
+static char const * const HbText_Test_Pairs[][2] = {
+	{ "", "" },
+	{ "", "a" },
+	{ "a", "A" },
+	{ "Textures/Stone", "textures/STONE" },
+	{ "Textures/Stone", "Textures/Stone.dds" },
+	{ "Textures/Stone.", "Textures/Stone_" },
+	{ "Textures/Stone.d", "TEXTURES/STONE.D" },
+	{ "Textures/Stone.dd", "Textures/Stone.dD" },
+	{ "Textures/Stone.dds", "Textures/Stone.dd" },
+	{ "Textures/Stone.dd@", "Textures/Stone.dd`" },
+	{ "Textures/Stone.dd[", "Textures/Stone.dd{" },
+	{ "Textures/Stone.ddZ", "Textures/Stone.dd[" },
+	{ "Textures/Stone.ddz", "Textures/Stone.dd{" },
+	{ "Textures/Stone.dd\x80", "Textures/Stone.dd\x7F" },
+	{ "Textures/Stone.dd\xC0", "Textures/Stone.dd\xE0" },
+	{ "Textures/Terrain/Grass/Diffuse.dds", "TEXTURES/TERRAIN/GRASS/DIFFUSE.DDS" },
+	{ "Textures/Terrain/Grass/Diffuse.dds", "Textures/Terrain/Grass/Diffuse_.dds" },
+	{ "Textures/Terrain/Grass/Diffuse.dds", "Textures/Terrain/Grass/Diffuse.dds2" },
+	{ "Textures/Terrain/Grass/Diffuse_Normal.dds", "Textures/Terrain/Grass/Diffuse_normal.ddS" },
+	{ "Textures/Terrain/Grass/Diffuse_Normal.dds", "Textures/Terrain/Grass/Diffuse_Normal.dd" },
+};
+
+static void HbText_Test_CompareAtPageEnds(HbText_Test_GuardedPage * aPage, HbText_Test_GuardedPage * bPage) {
+	// Away from page ends, but with garbage after the terminators, which must be ignored too.
+	char aMiddle[HbText_Test_GuardedPage_MaxPlacedSize], bMiddle[HbText_Test_GuardedPage_MaxPlacedSize];
+	for (uint32_t pairIndex = 0; pairIndex < HbArrayLength(HbText_Test_Pairs); ++pairIndex) {
+		for (uint32_t order = 0; order < 2; ++order) {
+			char const * a = HbText_Test_Pairs[pairIndex][order], * b = HbText_Test_Pairs[pairIndex][order ^ 1];
+			size_t aSize = strlen(a) + 1, bSize = strlen(b) + 1;
+			memset(aMiddle, 'x', sizeof(aMiddle));
+			memset(bMiddle, 'y', sizeof(bMiddle));
+			memcpy(aMiddle, a, aSize);
+			memcpy(bMiddle, b, bSize);
+			int expected = HbText_Test_ComparePartCaseless(a, b, SIZE_MAX);
+			int result = HbTextA_CompareCaseless(aMiddle, bMiddle);
+			HbText_Test_Check(result == expected, "Comparison of %s and %s with garbage after them is %d instead of %d",
+					a, b, result, expected);
+			// Every position of either string relatively to the end of the page, including with the other string in the middle.
+			for (size_t garbageAfter = 0; garbageAfter <= 32; ++garbageAfter) {
+				char const * aPlaced = HbText_Test_GuardedPage_Place(aPage, a, garbageAfter);
+				for (size_t bGarbageAfter = 0; bGarbageAfter <= 32; ++bGarbageAfter) {
+					char const * bPlaced = HbText_Test_GuardedPage_Place(bPage, b, bGarbageAfter);
+					result = HbTextA_CompareCaseless(aPlaced, bPlaced);
+					HbText_Test_Check(result == expected,
+							"Comparison of %s and %s with %zu and %zu bytes after them in the pages is %d instead of %d",
+							a, b, garbageAfter, bGarbageAfter, result, expected);
+				}
+				result = HbTextA_CompareCaseless(aPlaced, bMiddle);
+				HbText_Test_Check(result == expected, "Comparison of %s with %zu bytes after it in the page and %s is %d instead of %d",
+						a, garbageAfter, b, result, expected);
+				result = HbTextA_CompareCaseless(bMiddle, aPlaced);
+				HbText_Test_Check(result == -expected, "Comparison of %s and %s with %zu bytes after it in the page is %d instead of %d",
+						b, a, garbageAfter, result, -expected);
+			}
+		}
+	}
+}
+
+/*************************************
+ * Comparison of the first characters
+ *************************************/
+
+static void HbText_Test_ComparePart(HbText_Test_GuardedPage * aPage, HbText_Test_GuardedPage * bPage) {
+	for (uint32_t pairIndex = 0; pairIndex < HbArrayLength(HbText_Test_Pairs); ++pairIndex) {
+		char const * a = HbText_Test_Pairs[pairIndex][0], * b = HbText_Test_Pairs[pairIndex][1];
+		size_t maxLengthEnd = HbMaxSize(strlen(a), strlen(b)) + 2;
+		for (size_t garbageAfter = 0; garbageAfter <= 17; garbageAfter += 17) {
+			char const * aPlaced = HbText_Test_GuardedPage_Place(aPage, a, garbageAfter);
+			char const * bPlaced = HbText_Test_GuardedPage_Place(bPage, b, 17 - garbageAfter);
+			for (size_t maxLength = 0; maxLength <= maxLengthEnd; ++maxLength) {
+				int expected = HbText_Test_ComparePartCaseless(a, b, maxLength);
+				int result = HbTextA_ComparePartCaseless(aPlaced, bPlaced, maxLength);
+				HbText_Test_Check(result == expected, "Comparison of the first %zu characters of %s and %s is %d instead of %d",
+						maxLength, a, b, result, expected);
+			}
+		}
+	}
+	// Prefixes of names as used for pack folders, and SIZE_MAX meaning the whole strings.
+	HbText_Test_Check(HbTextA_ComparePartCaseless("Textures/Stone.dds", "TEXTURES/", 9) == 0, "Folder prefix not matched");
+	HbText_Test_Check(HbTextA_ComparePartCaseless("Textures", "TEXTURES/", 9) < 0, "Folder prefix matched a shorter name");
+	HbText_Test_Check(HbTextA_ComparePartCaseless("Textures/Stone", "textures/stone", SIZE_MAX) == 0, "Whole strings not matched");
+}
+
+int main() {
+	HbText_Test_GuardedPage aPage, bPage;
+	if (!HbText_Test_GuardedPage_Init(&aPage)) {
+		printf("Failed to allocate the memory with inaccessible pages.\n");
+		return EXIT_FAILURE;
+	}
+	if (!HbText_Test_GuardedPage_Init(&bPage)) {
+		HbText_Test_GuardedPage_Destroy(&aPage);
+		printf("Failed to allocate the memory with inaccessible pages.\n");
+		return EXIT_FAILURE;
+	}
+	HbText_Test_CompareAtPageEnds(&aPage, &bPage);
+	HbText_Test_ComparePart(&aPage, &bPage);
+	HbText_Test_GuardedPage_Destroy(&bPage);
+	HbText_Test_GuardedPage_Destroy(&aPage);
+	if (HbText_Test_FailureCount != 0) {
+		printf("%u checks failed.\n", HbText_Test_FailureCount);
+		return EXIT_FAILURE;
+	}
+	printf("All checks passed.\n");
+	return EXIT_SUCCESS;
+}